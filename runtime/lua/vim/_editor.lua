@@ -142,6 +142,42 @@ function vim.system(cmd, opts, on_exit)
   return require('vim._system').run(cmd, opts, on_exit)
 end
 
+--- Runs {handler} for each message sent to the returned worker, in a Lua state
+--- of its own on a thread of its own, so that CPU-heavy work neither blocks
+--- the editor nor shares its garbage collector.
+---
+--- {handler} is copied with |string.dump()|, it can't use upvalues. Like for
+--- |vim.uv.new_thread()| only part of `vim` is available in it, see
+--- |lua-loop-threading|. Messages and results are copied with |vim.mpack|, so
+--- the editor state, a buffer for instance, is passed as a snapshot:
+---
+--- ```lua
+--- local worker = vim.worker(function(msg)
+---   local count = 0
+---   for _, line in ipairs(msg.lines) do
+---     count = count + select(2, line:gsub(msg.pattern, ''))
+---   end
+---   return count
+--- end, function(err, count)
+---   print(err or count)
+--- end)
+--- worker:send({ pattern = 'TODO', lines = vim.api.nvim_buf_get_lines(0, 0, -1, true) })
+--- ```
+---
+--- @param handler fun(msg: any): any Called in the worker with each message.
+---   Its result is sent back to {on_message}.
+--- @param on_message (function|nil) `fun(err: string|nil, result: any)`
+---   Called on the main thread for each message handled, outside of
+---   |api-fast| like a |vim.schedule()| callback. Without it errors are
+---   reported.
+---
+--- @return vim.Worker Object with the methods:
+---   - send (fun(msg: any)) Queue a message for {handler}.
+---   - close (fun()) Stop the worker after the messages already sent.
+function vim.worker(handler, on_message)
+  return require('vim._worker').new(handler, on_message)
+end
+
 -- Gets process info from the `ps` command.
 -- Used by nvim_get_proc() as a fallback.
 function vim._os_proc_info(pid)
@@ -346,6 +382,53 @@ function vim.schedule_wrap(fn)
   end
 end
 
+--- Sends a request to {channel} to invoke {method} via |RPC| without waiting
+--- for the response, so that many requests can be in flight at once.
+---
+--- {on_response} is called with `(err, result)` when the response arrives, or
+--- with an error when the channel is closed first. Without {on_response} this
+--- must be called from a coroutine, which is suspended until the response
+--- arrives. Then the result is returned, or the error is raised.
+---
+--- Example:
+---
+--- ```lua
+--- coroutine.wrap(function()
+---   local x = vim.rpcrequest_async(chan, 'nvim_eval', { '1 + 1' })
+---   print(x)
+--- end)()
+--- ```
+---
+---@see |vim.rpcrequest()|
+---@param channel integer
+---@param method string
+---@param args? any[]
+---@param on_response? fun(err: string?, result: any)
+---@return any # Result, when called without {on_response}
+function vim.rpcrequest_async(channel, method, args, on_response)
+  args = args or {}
+  if on_response then
+    vim._rpcrequest_async(channel, method, on_response, unpack(args))
+    return
+  end
+
+  local co, is_main = coroutine.running()
+  if not co or is_main then
+    error('vim.rpcrequest_async: on_response is required outside of a coroutine')
+  end
+  vim._rpcrequest_async(channel, method, function(err, result)
+    local ok, msg = coroutine.resume(co, err, result)
+    if not ok then
+      error(msg, 0)
+    end
+  end, unpack(args))
+  local err, result = coroutine.yield()
+  if err then
+    error(err, 0)
+  end
+  return result
+end
+
 -- vim.fn.{func}(...)
 ---@private
 vim.fn = setmetatable({}, {
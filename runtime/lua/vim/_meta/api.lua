@@ -85,6 +85,17 @@ function vim.api.nvim__inspect_cell(grid, row, col) end
 ---
 function vim.api.nvim__invalidate_glyph_cache() end
 
+--- @private
+--- Gets stats of the RPC requests handled so far.
+---
+--- Times are in microseconds. The "wait" and "time" histograms count the
+--- requests by the time spent waiting in the event queue and executing the
+--- method: item i (zero based) counts the times below 2^i and at least
+--- 2^(i-1) microseconds.
+---
+--- @return table<string,any>
+function vim.api.nvim__rpc_stats() end
+
 --- @private
 --- @return any[]
 function vim.api.nvim__runtime_inspect() end
@@ -199,6 +210,10 @@ function vim.api.nvim_buf_add_highlight(buffer, ns_id, hl_group, line, col_start
 ---                      replaced region, as args to `on_lines`.
 ---                    • preview: also attach to command preview (i.e.
 ---                      'inccommand') events.
+---                    • coalesce: merge adjacent and overlapping changes into
+---                      one `nvim_buf_lines_event`, sent when Nvim gets to
+---                      process events again (e.g. after a macro or |:normal|
+---                      finished). Not for Lua callbacks.
 --- @return boolean
 function vim.api.nvim_buf_attach(buffer, send_buffer, opts) end
 
@@ -593,6 +608,19 @@ function vim.api.nvim_buf_line_count(buffer) end
 --- @return integer
 function vim.api.nvim_buf_set_extmark(buffer, ns_id, line, col, opts) end
 
+--- Creates or updates several `extmarks` at once.
+--- Does the same as calling `nvim_buf_set_extmark()` for each item, but with
+--- one call, and the marks are added in buffer order. Useful for plugins
+--- that place many marks at a time, such as highlighters.
+--- Stops at the first mark that fails, the marks set before it are kept.
+---
+--- @param buffer integer Buffer handle, or 0 for current buffer
+--- @param ns_id integer Namespace id from `nvim_create_namespace()`
+--- @param marks any[] List of `[line, col, opts]` items, where the arguments are
+---              as for `nvim_buf_set_extmark()`. `opts` may be omitted.
+--- @return integer[]
+function vim.api.nvim_buf_set_extmarks(buffer, ns_id, marks) end
+
 --- Sets a buffer-local `mapping` for the given mode.
 ---
 --- @param buffer integer Buffer handle, or 0 for current buffer
@@ -708,6 +736,21 @@ function vim.api.nvim_call_function(fn, args) end
 --- @param data string data to write. 8-bit clean: can contain NUL bytes.
 function vim.api.nvim_chan_send(chan, data) end
 
+--- Sends lines of a buffer to channel `chan`, each followed by a newline.
+--- Like `nvim_chan_send()` with the joined lines, but the lines are copied
+--- from the buffer in chunks as they are written, the whole text is never
+--- built as a single string. Useful to send a large buffer to a formatter.
+--- Indexing is zero-based, end-exclusive. Negative indices are interpreted
+--- as length+1+index: -1 refers to the index past the end. So to send the
+--- whole buffer, pass start=0 and end=-1.
+---
+--- @param chan integer id of the channel
+--- @param buffer integer Buffer handle, or 0 for current buffer
+--- @param start integer First line index
+--- @param end_ integer Last line index, exclusive
+--- @return integer
+function vim.api.nvim_chan_send_buf(chan, buffer, start, end_) end
+
 --- Clears all autocommands selected by {opts}. To delete autocmds see
 --- `nvim_del_autocmd()`.
 ---
@@ -1131,6 +1174,8 @@ function vim.api.nvim_get_all_options_info() end
 ---             • buffer: Buffer number or list of buffer numbers for buffer
 ---               local autocommands `autocmd-buflocal`. Cannot be used with
 ---               {pattern}
+---             • stats (boolean): also return how often and how long each
+---               autocommand was executed.
 --- @return any[]
 function vim.api.nvim_get_autocmds(opts) end
 
@@ -1746,8 +1791,8 @@ function vim.api.nvim_set_current_win(window) end
 --- forbidden, but is likely to have unexpected consequences (such as 100% CPU
 --- consumption). doing `vim.rpcnotify` should be OK, but `vim.rpcrequest` is
 --- quite dubious for the moment.
---- Note: It is not allowed to remove or update extmarks in 'on_line'
---- callbacks.
+--- Note: It is not allowed to remove or update extmarks in 'on_line' and
+--- 'on_range' callbacks.
 ---
 --- @param ns_id integer Namespace id from `nvim_create_namespace()`
 --- @param opts vim.api.keyset.set_decoration_provider Table of callbacks:
@@ -1762,6 +1807,11 @@ function vim.api.nvim_set_current_win(window) end
 ---              • on_line: called for each buffer line being redrawn. (The
 ---                interaction with fold lines is subject to change) ["win",
 ---                winid, bufnr, row]
+---              • on_range: called once per window redraw, after on_win,
+---                with the range of buffer lines that may be redrawn.
+---                Ephemeral extmarks for all of them can be set here instead
+---                of in on_line. Return `false` to skip the on_line calls for
+---                that window. ["range", winid, bufnr, toprow, botrow]
 ---              • on_end: called at the end of a redraw cycle ["end", tick]
 function vim.api.nvim_set_decoration_provider(ns_id, opts) end
 
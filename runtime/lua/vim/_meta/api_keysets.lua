@@ -11,6 +11,7 @@ error('Cannot require a meta file')
 --- @field on_reload? function
 --- @field utf_sizes? boolean
 --- @field preview? boolean
+--- @field coalesce? boolean
 
 --- @class vim.api.keyset.buf_delete
 --- @field force? boolean
@@ -138,6 +139,7 @@ error('Cannot require a meta file')
 --- @field group? any
 --- @field pattern? any
 --- @field buffer? any
+--- @field stats? boolean
 
 --- @class vim.api.keyset.get_commands
 --- @field builtin? boolean
@@ -237,6 +239,7 @@ error('Cannot require a meta file')
 --- @field on_buf? function
 --- @field on_win? function
 --- @field on_line? function
+--- @field on_range? function
 --- @field on_end? function
 --- @field _on_hl_def? function
 --- @field _on_spell_nav? function
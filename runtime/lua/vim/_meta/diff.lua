@@ -68,3 +68,15 @@
 ---@return string|table|nil
 ---     See {opts.result_type}. `nil` if {opts.on_hunk} is given.
 function vim.diff(a, b, opts) end
+
+--- Like |vim.diff()|, but {a} and {b} are copied and diffed on a background
+--- thread, so that diffing large texts does not block the editor.
+---
+--- @param a string First string to compare
+--- @param b string Second string to compare
+--- @param opts table<string,any>? Like for |vim.diff()|, except that
+---     `on_hunk` is not supported.
+--- @param callback fun(err: string?, result: string|table?)
+---     Called from the main loop with the diff, as returned by |vim.diff()|,
+---     or an error message.
+function vim.diff_async(a, b, opts, callback) end
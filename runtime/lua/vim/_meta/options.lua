@@ -1670,6 +1670,11 @@ vim.go.dex = vim.go.diffexpr
 --- 			will enable alignment for a 2 buffer diff with
 --- 			hunks of up to 30 lines each, or a 3 buffer
 --- 			diff with hunks of up to 20 lines each.
+--- 			For a 2 buffer diff a larger hunk is aligned
+--- 			with a faster heuristic that matches lines
+--- 			which appear once in both buffers, and uses
+--- 			the second stage diff on the parts in between
+--- 			that have at most {n} lines.
 ---
 --- 	algorithm:{text} Use the specified diff algorithm with the
 --- 			internal diff engine. Currently supported
@@ -3677,6 +3682,22 @@ vim.o.lz = vim.o.lazyredraw
 vim.go.lazyredraw = vim.o.lazyredraw
 vim.go.lz = vim.go.lazyredraw
 
+--- When this option is set, starting with `-p` only loads the files of
+--- the first tab page.  The file of another tab page is read when that tab
+--- page is entered or code is executed in its window, e.g. with
+--- `win_execute()`, and only then the `BufReadPre`, `BufRead` and
+--- `FileType` autocommands are triggered and the filetype plugin is
+--- sourced.  Until then the buffer is listed but not loaded, like a buffer
+--- in the argument list that was not edited yet.  This makes starting with
+--- many files in tab pages faster.  Must be set in your `config` to have
+--- an effect.
+---
+--- @type boolean
+vim.o.lazytabpages = false
+vim.o.ltp = vim.o.lazytabpages
+vim.go.lazytabpages = vim.o.lazytabpages
+vim.go.ltp = vim.go.lazytabpages
+
 --- If on, Vim will wrap long lines at a character in 'breakat' rather
 --- than at the last character that fits on the screen.  Unlike
 --- 'wrapmargin' and 'textwidth', this does not insert <EOL>s in the file,
@@ -4056,6 +4077,22 @@ vim.o.mmd = vim.o.maxmapdepth
 vim.go.maxmapdepth = vim.o.maxmapdepth
 vim.go.mmd = vim.go.maxmapdepth
 
+--- Maximum amount of memory (in Kbyte) to use for the text of one
+--- buffer.  When this limit is reached, the least recently used blocks
+--- of text are written to the `swap-file` and released, they are read
+--- back when needed.  For buffers without a swapfile the blocks are
+--- compressed in memory instead.
+--- Zero means no limit, Nvim delegates memory management to the OS.
+--- The number of blocks found in memory, read back, released and
+--- compressed is reported by `nvim__stats()`.
+--- Also see 'maxmemtot'.
+---
+--- @type integer
+vim.o.maxmem = 0
+vim.o.mm = vim.o.maxmem
+vim.go.maxmem = vim.o.maxmem
+vim.go.mm = vim.go.maxmem
+
 --- Maximum amount of memory (in Kbyte) to use for pattern matching.
 --- The maximum value is about 2000000.  Use this to work without a limit.
 --- 						*E363*
@@ -4075,6 +4112,29 @@ vim.o.mmp = vim.o.maxmempattern
 vim.go.maxmempattern = vim.o.maxmempattern
 vim.go.mmp = vim.go.maxmempattern
 
+--- Maximum amount of memory (in Kbyte) to use for the text of all
+--- buffers together.  When this limit is reached, blocks of the buffer
+--- being accessed are released like for 'maxmem'.  Zero means no limit.
+---
+--- @type integer
+vim.o.maxmemtot = 0
+vim.o.mmt = vim.o.maxmemtot
+vim.go.maxmemtot = vim.o.maxmemtot
+vim.go.mmt = vim.go.maxmemtot
+
+--- Maximum amount of memory (in Kbyte) to use for the undo text of one
+--- buffer.  When this limit is reached, the text of the oldest undo
+--- blocks is compressed, down to three quarters of the limit.  It is
+--- decompressed again when the change is undone or redone.  The block
+--- being changed is never compressed.  Zero means no limit.
+--- Also see 'undolevels'.
+---
+--- @type integer
+vim.o.maxmemundo = 0
+vim.o.mmu = vim.o.maxmemundo
+vim.go.maxmemundo = vim.o.maxmemundo
+vim.go.mmu = vim.go.maxmemundo
+
 --- Maximum number of items to use in a menu.  Used for menus that are
 --- generated from a list of items, e.g., the Buffers menu.  Changing this
 --- option has no direct effect, the menu must be refreshed first.
@@ -6161,7 +6221,9 @@ vim.bo.spo = vim.bo.spelloptions
 --- timeout:{millisec}   Limit the time searching for suggestions to
 --- 		{millisec} milli seconds.  Applies to the following
 --- 		methods.  When omitted the limit is 5000. When
---- 		negative there is no limit.
+--- 		negative there is no limit.  The time is shared by
+--- 		the languages in 'spelllang', when it runs out the
+--- 		suggestions found so far are given.
 ---
 --- file:{filename} Read file {filename}, which must have two columns,
 --- 		separated by a slash.  The first column contains the
@@ -6657,6 +6719,22 @@ vim.o.smc = vim.o.synmaxcol
 vim.bo.synmaxcol = vim.o.synmaxcol
 vim.bo.smc = vim.bo.synmaxcol
 
+--- Maximum number of syntax states to remember for one buffer.  A state
+--- is saved at the start of displayed lines and every so many lines in
+--- between, syntax highlighting can start from there instead of
+--- synchronizing again.  Lines parsed just before the displayed ones get
+--- more states, so that scrolling back after a jump is fast.  When all
+--- states are used, the ones of the lines that were displayed longest ago
+--- are dropped first.  A larger value makes jumping around in a big file
+--- faster and uses more memory, about 150 bytes for each state.  Values
+--- below 150 are used as 150.
+---
+--- @type integer
+vim.o.synmaxstates = 10000
+vim.o.sst = vim.o.synmaxstates
+vim.go.synmaxstates = vim.o.synmaxstates
+vim.go.sst = vim.go.synmaxstates
+
 --- When this option is set, the syntax with this name is loaded, unless
 --- syntax highlighting has been switched off with ":syntax off".
 --- Otherwise this option does not always reflect the current syntax (the
@@ -6937,6 +7015,18 @@ vim.o.tbidi = vim.o.termbidi
 vim.go.termbidi = vim.o.termbidi
 vim.go.tbidi = vim.go.termbidi
 
+--- Milliseconds to collect the output of a `terminal` job before passing
+--- it to the terminal emulator.  Programs that redraw with many small
+--- writes then cause fewer updates.  Output is passed on right away when
+--- 16 Kbyte was collected.  Zero or a negative value passes on every read
+--- at once.
+---
+--- @type integer
+vim.o.termcoalesce = 2
+vim.o.tco = vim.o.termcoalesce
+vim.go.termcoalesce = vim.o.termcoalesce
+vim.go.tco = vim.go.termcoalesce
+
 --- Enables 24-bit RGB color in the `TUI`.  Uses "gui" `:highlight`
 --- attributes instead of "cterm" attributes. `guifg`
 --- Requires an ISO-8613-3 compatible terminal.
@@ -7663,6 +7753,11 @@ vim.go.wim = vim.go.wildmode
 --- 		expansion. Currently fuzzy matching based completion
 --- 		is not supported for file and directory names and
 --- 		instead wildcard expansion is used.
+---   interrupt	A key typed while the matches are being found
+--- 		stops finding them, like CTRL-C does.  The key is then
+--- 		used as usual, the command line is not changed.  Useful
+--- 		when completing is slow, e.g. for "**" in a big
+--- 		directory tree or a slow "customlist" function.
 ---   pum		Display the completion matches using the popup menu
 --- 		in the same style as the `ins-completion-menu`.
 ---   tagfile	When using CTRL-D to list matching tags, the kind of
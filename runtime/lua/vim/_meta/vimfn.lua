@@ -771,6 +771,11 @@ function vim.fn.changenr() end
 ---   call chansend(id, ["abc", "123\n456", ""])
 --- <will send "abc<NL>123<NUL>456<NL>".
 ---
+--- If {data} is a |Dictionary|, it is sent encoded as JSON, like
+--- |json_encode()|.  It is written in chunks of about 64 KiB
+--- while it is encoded, instead of building the whole string
+--- first.
+---
 --- chansend() writes raw data, not RPC messages.  If the channel
 --- was created with `"rpc":v:true` then the channel expects RPC
 --- messages, use |rpcnotify()| and |rpcrequest()| instead.
@@ -4592,6 +4597,10 @@ function vim.fn.jobsend(...) end
 ---   overlapped: (boolean) Sets FILE_FLAG_OVERLAPPED for the
 ---         stdio passed to the child process. Only on
 ---         MS-Windows; ignored on other platforms.
+---   pool:       (number) Keep an `rpc` job running for this many
+---         milliseconds after |jobstop()|. A jobstart() with
+---         the same {cmd} and options in that time reuses it,
+---         with its own `on_stderr` and `on_exit`.
 ---   pty:        (boolean) Connect the job to a new pseudo
 ---         terminal, and its streams to the master file
 ---         descriptor. `on_stdout` receives all output,
@@ -4603,6 +4612,9 @@ function vim.fn.jobsend(...) end
 ---         before invoking `on_stderr`. |channel-buffered|
 ---   stdout_buffered: (boolean) Collect data until EOF (stream
 ---         closed) before invoking `on_stdout`. |channel-buffered|
+---   stdout_lines: (boolean) Invoke `on_stdout` with complete
+---         lines only. |channel-lines|
+---   stderr_lines: (boolean) Like `stdout_lines` for `on_stderr`.
 ---   stdin:      (string) Either "pipe" (default) to connect the
 ---         job's stdin to a channel or "null" to disconnect
 ---         stdin.
@@ -4626,6 +4638,9 @@ function vim.fn.jobstart(cmd, opts) end
 --- the process does not terminate after a timeout then SIGKILL
 --- will be sent. When the job terminates its |on_exit| handler
 --- (if any) will be invoked.
+--- A job started with the `pool` option is kept running
+--- instead, its |on_exit| is not invoked and {id} must not be
+--- used anymore.
 --- See |job-control|.
 ---
 --- Returns 1 for valid job id, 0 for invalid id, including jobs have
@@ -8608,6 +8623,7 @@ function vim.fn.slice(expr, start, end_) end
 --- {opts} is an optional dictionary with these keys:
 ---   |on_data| : callback invoked when data was read from socket
 ---   data_buffered : read socket data in |channel-buffered| mode.
+---   data_lines : read socket data in |channel-lines| mode.
 ---   rpc     : If set, |msgpack-rpc| will be used to communicate
 ---       over the socket.
 --- Returns:
@@ -8873,6 +8889,7 @@ function vim.fn.state(what) end
 ---        message, with the message (whose type is string)
 ---        as sole argument.
 ---   stdin_buffered : read stdin in |channel-buffered| mode.
+---   stdin_lines : read stdin in |channel-lines| mode.
 ---   rpc      : If set, |msgpack-rpc| will be used to communicate
 ---        over stdio
 --- Returns:
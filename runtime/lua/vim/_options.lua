@@ -125,13 +125,26 @@ local function get_option_metatype(name, info)
   return info.type
 end
 
+-- Option info by option name. Only the fields that cannot change at runtime
+-- (type, flaglist, commalist, allows_duplicates) are used, so vim.opt does not
+-- need to ask for the whole info dictionary on every access.
+local options_info_cache = {}
+
 --- @param name string
 local function get_options_info(name)
-  local info = api.nvim_get_option_info2(name, {})
-  info.metatype = get_option_metatype(name, info)
+  local info = options_info_cache[name]
+  if not info then
+    info = api.nvim_get_option_info2(name, {})
+    info.metatype = get_option_metatype(name, info)
+    options_info_cache[name] = info
+  end
   return info
 end
 
+-- Shared opts tables for the accessors below, the API does not modify them.
+local opts_empty = {}
+local opts_global = { scope = 'global' }
+
 --- Environment variables defined in the editor session.
 --- See |expand-env| and |:let-environment| for the Vimscript behavior.
 --- Invalid or unset key returns `nil`.
@@ -245,10 +258,10 @@ end
 --- ```
 vim.o = setmetatable({}, {
   __index = function(_, k)
-    return api.nvim_get_option_value(k, {})
+    return api.nvim_get_option_value(k, opts_empty)
   end,
   __newindex = function(_, k, v)
-    return api.nvim_set_option_value(k, v, {})
+    return api.nvim_set_option_value(k, v, opts_empty)
   end,
 })
 
@@ -268,10 +281,10 @@ vim.o = setmetatable({}, {
 --- ```
 vim.go = setmetatable({}, {
   __index = function(_, k)
-    return api.nvim_get_option_value(k, { scope = 'global' })
+    return api.nvim_get_option_value(k, opts_global)
   end,
   __newindex = function(_, k, v)
-    return api.nvim_set_option_value(k, v, { scope = 'global' })
+    return api.nvim_set_option_value(k, v, opts_global)
   end,
 })
 
@@ -729,7 +742,7 @@ local function create_option_accessor(scope)
     __index = function(_, k)
       -- vim.opt_global must get global value only
       -- vim.opt_local may fall back to global value like vim.opt
-      local opts = { scope = scope == 'global' and 'global' or nil }
+      local opts = scope == 'global' and opts_global or opts_empty
       return make_option(k, api.nvim_get_option_value(k, opts))
     end,
 
@@ -0,0 +1,60 @@
+-- Lua side of |vim.worker()|, see src/nvim/lua/worker.c. Messages are sent
+-- to the worker as `{ msg }` and back as `{ ok, result_or_error }`, encoded
+-- with msgpack.
+
+local M = {}
+
+--- @class vim.Worker
+--- @field private _handle userdata
+local Worker = {}
+Worker.__index = Worker
+
+--- Sends {msg} to the handler of the worker.
+--- @param msg any Value that can be encoded with |vim.mpack|
+function Worker:send(msg)
+  self._handle:send(vim.mpack.encode({ msg }))
+end
+
+--- Stops the worker once the messages already sent have been handled.
+function Worker:close()
+  self._handle:close()
+end
+
+--- @param handler fun(msg: any): any
+--- @param on_message? fun(err: string?, result: any)
+--- @return vim.Worker
+function M.new(handler, on_message)
+  vim.validate({
+    handler = { handler, 'f' },
+    on_message = { on_message, 'f', true },
+  })
+  local handle = vim._worker_start(string.dump(handler), function(data)
+    local r = vim.mpack.decode(data)
+    if on_message then
+      on_message(not r[1] and r[2] or nil, r[1] and r[2] or nil)
+    elseif not r[1] then
+      error(r[2], 0)
+    end
+  end)
+  return setmetatable({ _handle = handle }, Worker)
+end
+
+--- Loop of the worker thread, until the worker is closed.
+--- @param code string dumped handler
+function M._serve(code)
+  local handler = assert(loadstring(code, '=vim.worker'))
+  while true do
+    local data = vim._worker_recv()
+    if data == nil then
+      return
+    end
+    local ok, result = pcall(handler, vim.mpack.decode(data)[1])
+    local ok_encode, reply = pcall(vim.mpack.encode, { ok, result })
+    if not ok_encode then
+      reply = vim.mpack.encode({ false, reply })
+    end
+    vim._worker_post(reply)
+  end
+end
+
+return M
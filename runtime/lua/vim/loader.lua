@@ -40,6 +40,7 @@ local Loader = {
   ---@type table<string, string[]>
   _topmods = {},
   _loadfile = loadfile,
+  _dofile = dofile,
   ---@type LoaderStats
   _stats = {
     find = { total = 0, time = 0, not_found = 0 },
@@ -218,6 +219,22 @@ function Loader.loadfile(filename, mode, env)
   return Loader.load(normalize(filename), { mode = mode, env = env })
 end
 
+--- `dofile` using the cache
+---@param filename? string
+---@return any ...
+---@private
+function Loader.dofile(filename)
+  if filename == nil then
+    -- stdin is not cached
+    return Loader._dofile()
+  end
+  local chunk, err = Loader.loadfile(filename)
+  if not chunk then
+    error(err, 0)
+  end
+  return chunk()
+end
+
 --- Checks whether two cache hashes are the same based on:
 --- * file size
 --- * mtime in seconds
@@ -385,7 +402,8 @@ function M.reset(path)
 end
 
 --- Enables the experimental Lua module loader:
---- * overrides loadfile
+--- * overrides loadfile and dofile, also used for Lua files sourced with
+---   |:source| and |:runtime|
 --- * adds the Lua loader using the byte-compilation cache
 --- * adds the libs loader
 --- * removes the default Nvim loader
@@ -396,6 +414,7 @@ function M.enable()
   M.enabled = true
   vim.fn.mkdir(vim.fn.fnamemodify(M.path, ':p'), 'p')
   _G.loadfile = Loader.loadfile
+  _G.dofile = Loader.dofile
   -- add Lua loader
   table.insert(loaders, 2, Loader.loader)
   -- add libs loader
@@ -418,6 +437,7 @@ function M.disable()
   end
   M.enabled = false
   _G.loadfile = Loader._loadfile
+  _G.dofile = Loader._dofile
   for l, loader in ipairs(loaders) do
     if loader == Loader.loader or loader == Loader.loader_lib then
       table.remove(loaders, l)
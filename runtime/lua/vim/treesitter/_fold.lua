@@ -231,17 +231,45 @@ local foldinfos = {}
 
 local group = api.nvim_create_augroup('treesitter/fold', {})
 
+---@type table<integer,{[1]: integer, [2]: integer}|true>
+local pending_updates = {}
+
 --- Update the folds in the windows that contain the buffer and use expr foldmethod (assuming that
 --- the user doesn't use different foldexpr for the same buffer).
 ---
 --- Nvim usually automatically updates folds when text changes, but it doesn't work here because
 --- FoldInfo update is scheduled. So we do it manually.
-local function foldupdate(bufnr)
+---
+--- Only the folds from `srow` on are evaluated again, until they match the existing folds. Without
+--- a range all lines are.
+---@param bufnr integer
+---@param srow integer?
+---@param erow integer? 0-indexed, exclusive
+local function foldupdate(bufnr, srow, erow)
+  -- Merge with the update that is waiting for InsertLeave, if any.
+  local pending = pending_updates[bufnr]
+  if pending == true or not srow then
+    pending_updates[bufnr] = true
+  elseif pending then
+    pending_updates[bufnr] = { math.min(pending[1], srow), math.max(pending[2], erow) }
+  else
+    pending_updates[bufnr] = { srow, erow }
+  end
+
   local function do_update()
+    local range = pending_updates[bufnr]
+    pending_updates[bufnr] = nil
+    if not range then
+      return
+    end
     for _, win in ipairs(vim.fn.win_findbuf(bufnr)) do
       api.nvim_win_call(win, function()
         if vim.wo.foldmethod == 'expr' then
-          vim._foldupdate()
+          if range == true then
+            vim._foldupdate()
+          else
+            vim._foldupdate(range[1], range[2])
+          end
         end
       end)
     end
@@ -289,16 +317,21 @@ end
 ---@param tree_changes Range4[]
 local function on_changedtree(bufnr, foldinfo, tree_changes)
   schedule_if_loaded(bufnr, function()
+    local update_srow, update_erow ---@type integer?, integer?
     for _, change in ipairs(tree_changes) do
       local srow, _, erow, ecol = Range.unpack4(change)
       if ecol > 0 then
         erow = erow + 1
       end
       -- Start from `srow - foldminlines`, because this edit may have shrunken the fold below limit.
-      get_folds_levels(bufnr, foldinfo, math.max(srow - vim.wo.foldminlines, 0), erow)
+      srow = math.max(srow - vim.wo.foldminlines, 0)
+      get_folds_levels(bufnr, foldinfo, srow, erow)
+      erow = normalise_erow(bufnr, erow)
+      update_srow = math.min(update_srow or srow, srow)
+      update_erow = math.max(update_erow or erow, erow)
     end
-    if #tree_changes > 0 then
-      foldupdate(bufnr)
+    if update_srow then
+      foldupdate(bufnr, update_srow, update_erow)
     end
   end)
 end
@@ -346,8 +379,9 @@ local function on_bytes(bufnr, foldinfo, start_row, start_col, old_row, old_col,
         return
       end
       -- Start from `srow - foldminlines`, because this edit may have shrunken the fold below limit.
-      get_folds_levels(bufnr, foldinfo, math.max(srow - vim.wo.foldminlines, 0), erow)
-      foldupdate(bufnr)
+      srow = math.max(srow - vim.wo.foldminlines, 0)
+      get_folds_levels(bufnr, foldinfo, srow, erow)
+      foldupdate(bufnr, srow, normalise_erow(bufnr, erow))
     end)
   end
 end
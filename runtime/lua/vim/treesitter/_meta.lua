@@ -49,11 +49,21 @@ function TSNode:_rawquery(query, captures, start, end_, opts) end
 ---@return fun(): string, any
 function TSNode:_rawquery(query, captures, start, end_, opts) end
 
+---@param query userdata
+---@param source integer|string
+---@param start integer
+---@param end_ integer
+---@param lua_patterns? table<integer,true>
+---@return integer[] ranges
+---@return table<integer,table> matches
+function TSNode:_rawquery_captures(query, source, start, end_, lua_patterns) end
+
 ---@alias TSLoggerCallback fun(logtype: 'parse'|'lex', msg: string)
 
 ---@class TSParser
 ---@field parse fun(self: TSParser, tree: TSTree?, source: integer|string, include_bytes: true): TSTree, Range6[]
 ---@field parse fun(self: TSParser, tree: TSTree?, source: integer|string, include_bytes: false|nil): TSTree, Range4[]
+---@field parse_async fun(self: TSParser, tree: TSTree?, source: integer|string, include_bytes: boolean?, callback: fun(err: string?, tree: TSTree?, changes: Range4[]|Range6[]?))
 ---@field reset fun(self: TSParser)
 ---@field included_ranges fun(self: TSParser, include_bytes: boolean?): integer[]
 ---@field set_included_ranges fun(self: TSParser, ranges: (Range6|TSNode)[])
@@ -68,6 +78,22 @@ function TSNode:_rawquery(query, captures, start, end_, opts) end
 ---@field copy fun(self: TSTree): TSTree
 ---@field included_ranges fun(self: TSTree, include_bytes: true): Range6[]
 ---@field included_ranges fun(self: TSTree, include_bytes: false): Range4[]
+---@field root_handle fun(self: TSTree): integer
+---@field to_handle fun(self: TSTree, node: TSNode): integer
+---@field from_handle fun(self: TSTree, handle: integer): TSNode
+---@field handle_type fun(self: TSTree, handle: integer): string
+---@field handle_symbol fun(self: TSTree, handle: integer): integer
+---@field handle_named fun(self: TSTree, handle: integer): boolean
+---@field handle_range fun(self: TSTree, handle: integer): integer, integer, integer, integer
+---@field handle_child_count fun(self: TSTree, handle: integer): integer
+---@field handle_named_child_count fun(self: TSTree, handle: integer): integer
+---@field handle_child fun(self: TSTree, handle: integer, index: integer): integer?
+---@field handle_named_child fun(self: TSTree, handle: integer, index: integer): integer?
+---@field handle_parent fun(self: TSTree, handle: integer): integer?
+---@field handle_next_sibling fun(self: TSTree, handle: integer): integer?
+---@field handle_prev_sibling fun(self: TSTree, handle: integer): integer?
+---@field handle_next_named_sibling fun(self: TSTree, handle: integer): integer?
+---@field handle_prev_named_sibling fun(self: TSTree, handle: integer): integer?
 
 ---@return integer
 vim._ts_get_language_version = function() end
@@ -78,3 +104,8 @@ vim._ts_get_minimum_language_version = function() end
 ---@param lang string
 ---@return TSParser
 vim._create_ts_parser = function(lang) end
+
+---@param source integer|string
+---@param jobs {[1]: TSParser, [2]: TSTree?, [3]: (Range6|TSNode)[]}[]
+---@return ({[1]: TSTree, [2]: Range6[]}|false)[]
+vim._ts_parse_many = function(source, jobs) end
@@ -4,7 +4,7 @@ local Range = require('vim.treesitter._range')
 
 local ns = api.nvim_create_namespace('treesitter/highlighter')
 
----@alias vim.TSHlIter fun(end_line: integer|nil): integer, TSNode, TSMetadata
+---@alias vim.TSHlIter fun(): integer?, Range4, TSMetadata
 
 ---@class vim.TSHighlighterQuery
 ---@field private _query Query?
@@ -55,9 +55,27 @@ end
 ---@class vim.TSHighlightState
 ---@field tstree TSTree
 ---@field next_row integer
+---@field stop_row integer End of the rows being redrawn (end-exclusive)
 ---@field iter vim.TSHlIter?
+---@field iter_stop integer? End of the rows covered by iter (end-exclusive)
 ---@field highlighter_query vim.TSHighlighterQuery
 
+--- Captures of a query in a block of CACHE_ROWS rows, including the ones
+--- starting above the block.
+---@class vim.TSHighlightBlock
+---@field captures integer[]
+---@field ranges Range4[]
+---@field metadata table<integer,TSMetadata> Only for the captures that have some
+---@field first_row integer First row the captures touch
+---@field last_row integer Last row the captures touch
+
+---@alias vim.TSHighlightBlocks table<integer,vim.TSHighlightBlock>
+
+--- Number of rows in a block of cached captures.
+local CACHE_ROWS = 64
+
+local no_metadata = {}
+
 ---@class vim.TSHighlighter
 ---@field active table<integer,vim.TSHighlighter>
 ---@field bufnr integer
@@ -66,6 +84,9 @@ end
 --- This state is kept during rendering across each line update.
 ---@field _highlight_states vim.TSHighlightState[]
 ---@field _queries table<string,vim.TSHighlighterQuery>
+--- Captures found in each tree, by query and block number. Scrolling back
+--- to rows already shown doesn't run the query again.
+---@field private _captures table<TSTree,table<Query,vim.TSHighlightBlocks>>
 ---@field tree LanguageTree
 ---@field redraw_count integer
 local TSHighlighter = {
@@ -118,6 +139,7 @@ function TSHighlighter.new(tree, opts)
   self.redraw_count = 0
   self._highlight_states = {}
   self._queries = {}
+  self._captures = setmetatable({}, { __mode = 'k' })
 
   -- Queries for a specific language can be overridden by a custom
   -- string query... if one is not provided it will be looked up by file.
@@ -196,6 +218,7 @@ function TSHighlighter:prepare_highlight_states(srow, erow)
     table.insert(self._highlight_states, {
       tstree = tstree,
       next_row = 0,
+      stop_row = erow,
       iter = nil,
       highlighter_query = highlighter_query,
     })
@@ -213,7 +236,27 @@ end
 ---@package
 ---@param start_row integer
 ---@param new_end integer
-function TSHighlighter:on_bytes(_, _, start_row, _, _, _, _, _, new_end)
+--- Drops the cached blocks with captures touching rows {first} to {last}.
+---@param by_query table<Query,vim.TSHighlightBlocks>
+---@param first integer
+---@param last number
+local function drop_blocks(by_query, first, last)
+  for _, blocks in pairs(by_query) do
+    for b, block in pairs(blocks) do
+      if block.first_row <= last and block.last_row >= first then
+        blocks[b] = nil
+      end
+    end
+  end
+end
+
+function TSHighlighter:on_bytes(_, _, start_row, _, _, old_row, _, _, new_end)
+  -- The trees are edited in place. When lines are added or removed, all the
+  -- captures below have moved.
+  local last = old_row == new_end and start_row + old_row or math.huge
+  for _, by_query in pairs(self._captures) do
+    drop_blocks(by_query, start_row, last)
+  end
   api.nvim__buf_redraw_range(self.bufnr, start_row, start_row + new_end + 1)
 end
 
@@ -224,12 +267,99 @@ end
 
 ---@package
 ---@param changes Range6[]
-function TSHighlighter:on_changedtree(changes)
+---@param tree? TSTree
+---@param old_tree? TSTree
+function TSHighlighter:on_changedtree(changes, tree, old_tree)
+  -- Keep the captures of the old tree outside of the changes.
+  local by_query = old_tree and self._captures[old_tree]
+  if tree and by_query then
+    self._captures[old_tree] = nil
+    self._captures[tree] = by_query
+  end
+
   for _, ch in ipairs(changes) do
+    if by_query then
+      drop_blocks(by_query, ch[1], ch[4])
+    end
     api.nvim__buf_redraw_range(self.bufnr, ch[1], ch[4] + 1)
   end
 end
 
+--- Returns the captures of {query} in block {b} of {tstree}, found when the
+--- block is first asked for.
+---@param tstree TSTree
+---@param query Query
+---@param b integer
+---@return vim.TSHighlightBlock
+function TSHighlighter:_get_block(tstree, query, b)
+  local by_query = self._captures[tstree]
+  if not by_query then
+    by_query = {}
+    self._captures[tstree] = by_query
+  end
+  local blocks = by_query[query]
+  if not blocks then
+    blocks = {}
+    by_query[query] = blocks
+  end
+
+  local block = blocks[b]
+  if not block then
+    local first, stop = b * CACHE_ROWS, (b + 1) * CACHE_ROWS
+    block = { captures = {}, ranges = {}, metadata = {}, first_row = first, last_row = stop - 1 }
+    local iter = query:_iter_capture_ranges(tstree:root(), self.bufnr, first, stop)
+    for capture, range, metadata in iter do
+      local n = #block.captures + 1
+      block.captures[n] = capture
+      block.ranges[n] = range
+      if next(metadata) then
+        block.metadata[n] = metadata
+      end
+      block.first_row = math.min(block.first_row, range[1])
+      block.last_row = math.max(block.last_row, range[3])
+    end
+    blocks[b] = block
+  end
+  return block
+end
+
+--- Iterates over the captures of {query} touching rows {start} to {stop}
+--- (end-exclusive), in the order of |Query:iter_captures()|.
+---@param tstree TSTree
+---@param query Query
+---@param start integer
+---@param stop integer
+---@return vim.TSHlIter
+function TSHighlighter:_iter_captures(tstree, query, start, stop)
+  local first_b = math.floor(start / CACHE_ROWS)
+  local last_b = math.floor((stop - 1) / CACHE_ROWS)
+  local b = first_b
+  local block = self:_get_block(tstree, query, b)
+  local i = 0
+  return function()
+    while true do
+      i = i + 1
+      local range = block.ranges[i]
+      if not range then
+        if b >= last_b then
+          return nil
+        end
+        b = b + 1
+        block = self:_get_block(tstree, query, b)
+        i = 0
+      elseif
+        -- Captures starting above a block were already given by the one above,
+        -- except for the first block, which gives the ones reaching {start}.
+        b == first_b
+          and (range[1] >= start or range[3] > start or range[3] == start and range[4] > 0)
+        or b > first_b and range[1] >= b * CACHE_ROWS
+      then
+        return block.captures[i], range, block.metadata[i] or no_metadata
+      end
+    end
+  end
+end
+
 --- Gets the query used for @param lang
 --
 ---@package
@@ -257,17 +387,18 @@ local function on_line_impl(self, buf, line, is_spell_nav)
       return
     end
 
-    if state.iter == nil or state.next_row < line then
+    if state.iter == nil or state.next_row < line or line >= state.iter_stop then
+      -- All the captures up to the end of the redrawn rows are found at once.
+      state.iter_stop = math.min(math.max(state.stop_row, line + 1), root_end_row + 1)
       state.iter =
-        state.highlighter_query:query():iter_captures(root_node, self.bufnr, line, root_end_row + 1)
+        self:_iter_captures(state.tstree, state.highlighter_query:query(), line, state.iter_stop)
     end
 
     while line >= state.next_row do
-      local capture, node, metadata = state.iter(line)
+      local capture, range, metadata = state.iter()
 
-      local range = { root_end_row + 1, 0, root_end_row + 1, 0 }
-      if node then
-        range = vim.treesitter.get_range(node, buf, metadata and metadata[capture])
+      if not capture then
+        range = { state.iter_stop, 0, state.iter_stop, 0 }
       end
       local start_row, start_col, end_row, end_col = Range.unpack4(range)
 
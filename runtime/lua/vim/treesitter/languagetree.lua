@@ -87,6 +87,10 @@ local TSCallbackNames = {
 ---@field private _trees table<integer, TSTree> Reference to parsed tree (one for each language).
 ---Each key is the index of region, which is synced with _regions and _valid.
 ---@field private _valid boolean|table<integer,boolean> If the parsed tree is valid
+---@field private _edits? any[][] Edits made while a |LanguageTree:parse_async()| is running
+---@field private _async_parses? integer Number of parses started by |LanguageTree:parse_async()|
+---@field private _generation integer Incremented by invalidate(), a |LanguageTree:parse_async()|
+---started before drops its trees
 ---@field private _logger? fun(logtype: string, msg: string)
 ---@field private _logfile? file*
 local LanguageTree = {}
@@ -133,6 +137,7 @@ function LanguageTree.new(source, lang, opts, parent_lang)
     _has_regions = false,
     _injections_processed = false,
     _valid = false,
+    _generation = 0,
     _parser = vim._create_ts_parser(lang),
     _callbacks = {},
     _callbacks_rec = {},
@@ -231,6 +236,7 @@ end
 ---@param reload boolean|nil
 function LanguageTree:invalidate(reload)
   self._valid = false
+  self._generation = self._generation + 1
 
   -- buffer was reloaded, reparse all trees
   if reload then
@@ -356,7 +362,7 @@ function LanguageTree:_parse_regions(range)
       -- Pass ranges if this is an initial parse
       local cb_changes = self._trees[i] and tree_changes or tree:included_ranges(true)
 
-      self:_do_callback('changedtree', cb_changes, tree)
+      self:_do_callback('changedtree', cb_changes, tree, self._trees[i])
       self._trees[i] = tree
       vim.list_extend(changes, tree_changes)
 
@@ -402,6 +408,50 @@ function LanguageTree:_add_injections()
   return query_time
 end
 
+--- @private
+--- Parses the invalid regions of all the children at once, on several
+--- threads, see vim._ts_parse_many(). Multi-language buffers can have many
+--- injected regions. The children are then left to parse their own children.
+--- @param range boolean|Range?
+function LanguageTree:_parse_children(range)
+  local jobs = {} --- @type table[]
+  local targets = {} --- @type {[1]: LanguageTree, [2]: integer}[]
+  for _, child in pairs(self._children) do
+    if not child:is_valid(true) then
+      if type(child._valid) ~= 'table' then
+        child._valid = {}
+      end
+      for i, ranges in pairs(child:included_regions()) do
+        if not child._valid[i] and intercepts_region(ranges, range) then
+          table.insert(jobs, { child._parser, child._trees[i], ranges })
+          table.insert(targets, { child, i })
+        end
+      end
+    end
+  end
+
+  -- A single region is not worth the threads.
+  if #jobs < 2 then
+    return
+  end
+
+  local parse_time, results = tcall(vim._ts_parse_many, self._source, jobs)
+
+  for j, result in ipairs(results) do
+    local child, i = targets[j][1], targets[j][2]
+    if result then
+      local tree, tree_changes = result[1], result[2]
+      local cb_changes = child._trees[i] and tree_changes or tree:included_ranges(true)
+      child:_do_callback('changedtree', cb_changes, tree, child._trees[i])
+      child._trees[i] = tree
+      child._valid[i] = true
+      child._injections_processed = false
+    end
+  end
+
+  self:_log({ children_regions_parsed = #jobs, children_parse_time = parse_time })
+end
+
 --- Recursively parse all regions in the language tree using |treesitter-parsers|
 --- for the corresponding languages and run injection queries on the parsed trees
 --- to determine whether child trees should be created and parsed.
@@ -449,6 +499,7 @@ function LanguageTree:parse(range)
     range = range,
   })
 
+  self:_parse_children(range)
   for _, child in pairs(self._children) do
     child:parse(range)
   end
@@ -456,6 +507,88 @@ function LanguageTree:parse(range)
   return self._trees
 end
 
+--- Like |LanguageTree:parse()| with no {range}, but the regions are parsed on
+--- a background thread so that the editor stays responsive, e.g. for the
+--- initial parse of a large buffer. The source text is copied when this is
+--- called. Edits made while the parse runs are applied to the new trees with
+--- |TSTree:edit()|, which are then left invalid: the next |LanguageTree:parse()|
+--- only reparses the edited parts.
+---
+--- Injections are not processed, call |LanguageTree:parse()| for that.
+---
+--- @param callback fun(err: string?, trees: table<integer, TSTree>?)
+---     Called once all the regions are parsed.
+function LanguageTree:parse_async(callback)
+  if self:is_valid(true) then
+    callback(nil, self._trees)
+    return
+  end
+
+  if type(self._valid) ~= 'table' then
+    self._valid = {}
+  end
+  self._edits = self._edits or {}
+  self._async_parses = self._async_parses or 0
+
+  local pending = 0
+  local failed --- @type string?
+  local generation = self._generation
+  local function done()
+    pending = pending - 1
+    self._async_parses = self._async_parses - 1
+    if self._async_parses == 0 then
+      self._edits = nil
+    end
+    if pending > 0 then
+      return
+    end
+    if failed then
+      callback(failed)
+    else
+      self._injections_processed = false
+      callback(nil, self._trees)
+    end
+  end
+
+  for i, ranges in pairs(self:included_regions()) do
+    if not self._valid[i] and intercepts_region(ranges) then
+      local base = self._trees[i]
+      local first_edit = #self._edits + 1
+      self._parser:set_included_ranges(ranges)
+      pending = pending + 1
+      self._async_parses = self._async_parses + 1
+      self._parser:parse_async(base, self._source, true, function(err, tree, tree_changes)
+        if err then
+          failed = err
+        elseif
+          self._generation == generation
+          and type(self._valid) == 'table'
+          and self._trees[i] == base
+        then
+          -- Otherwise the tree was invalidated, e.g. the buffer was reloaded,
+          -- or parse() made a newer tree meanwhile, keep that one.
+          local edits = self._edits or {}
+          for e = first_edit, #edits do
+            tree:edit(unpack(edits[e]))
+          end
+          local cb_changes = base and tree_changes or tree:included_ranges(true)
+          self:_do_callback('changedtree', cb_changes, tree, base)
+          self._trees[i] = tree
+          self._valid[i] = first_edit > #edits
+        end
+        done()
+      end)
+    end
+  end
+
+  if pending == 0 then
+    if self._async_parses == 0 then
+      self._edits = nil
+    end
+    callback(nil, self._trees)
+  end
+end
+
 ---@deprecated Misleading name. Use `LanguageTree:children()` (non-recursive) instead,
 ---            add recursion yourself if needed.
 --- Invokes the callback for each |LanguageTree| and its children recursively
@@ -893,6 +1026,20 @@ function LanguageTree:_edit(
   end_row_new,
   end_col_new
 )
+  if self._edits then
+    table.insert(self._edits, {
+      start_byte,
+      end_byte_old,
+      end_byte_new,
+      start_row,
+      start_col,
+      end_row_old,
+      end_col_old,
+      end_row_new,
+      end_col_new,
+    })
+  end
+
   for _, tree in pairs(self._trees) do
     tree:edit(
       start_byte,
@@ -1039,8 +1186,8 @@ end
 ---@param cbs table An |nvim_buf_attach()|-like table argument with the following handlers:
 ---           - `on_bytes` : see |nvim_buf_attach()|, but this will be called _after_ the parsers callback.
 ---           - `on_changedtree` : a callback that will be called every time the tree has syntactical changes.
----              It will be passed two arguments: a table of the ranges (as node ranges) that
----              changed and the changed tree.
+---              It will be passed three arguments: a table of the ranges (as node ranges) that
+---              changed, the changed tree, and the tree it replaces (if any).
 ---           - `on_child_added` : emitted when a child is added to the tree.
 ---           - `on_child_removed` : emitted when a child is removed from the tree.
 ---           - `on_detach` : emitted when the buffer is detached, see |nvim_buf_detach_event|.
@@ -1,10 +1,13 @@
 local api = vim.api
 local language = require('vim.treesitter.language')
+local Range = require('vim.treesitter._range')
 
 ---@class Query
 ---@field captures string[] List of captures used in query
 ---@field info TSQueryInfo Contains used queries, predicates, directives
 ---@field query userdata Parsed query
+---@field private _lua_patterns_cache? table<integer,true>
+---@field private _lua_patterns_tick? integer
 local Query = {}
 Query.__index = Query
 
@@ -407,6 +410,18 @@ local predicate_handlers = {
 -- As we provide lua-match? also expose vim-match?
 predicate_handlers['vim-match?'] = predicate_handlers['match?']
 
+-- Predicates that node:_rawquery_captures() checks in C, as long as they
+-- are not replaced with add_predicate().
+local c_predicates = {
+  ['eq?'] = predicate_handlers['eq?'],
+  ['match?'] = predicate_handlers['match?'],
+  ['vim-match?'] = predicate_handlers['vim-match?'],
+  ['any-of?'] = predicate_handlers['any-of?'],
+}
+
+-- Incremented when a predicate is added, see Query:_lua_patterns().
+local predicates_tick = 0
+
 ---@class TSMetadata
 ---@field range? Range
 ---@field conceal? string
@@ -534,6 +549,7 @@ function M.add_predicate(name, handler, force)
   end
 
   predicate_handlers[name] = handler
+  predicates_tick = predicates_tick + 1
 end
 
 --- Adds a new directive to be used in queries
@@ -642,6 +658,33 @@ function Query:apply_directives(match, pattern, source, metadata)
   end
 end
 
+--- Returns the patterns that have directives or predicates only Lua can
+--- handle: the ones given to Query:match_preds() by
+--- Query:_iter_capture_ranges().
+---@private
+---@return table<integer,true>
+function Query:_lua_patterns()
+  if self._lua_patterns_tick ~= predicates_tick then
+    local patterns = {} ---@type table<integer,true>
+    for pattern, preds in pairs(self.info.patterns) do
+      for _, pred in pairs(preds) do
+        local name = string.gsub(pred[1], '^not%-', '')
+        if
+          is_directive(pred[1])
+          or not c_predicates[name]
+          or predicate_handlers[name] ~= c_predicates[name]
+        then
+          patterns[pattern] = true
+          break
+        end
+      end
+    end
+    self._lua_patterns_cache = patterns
+    self._lua_patterns_tick = predicates_tick
+  end
+  return self._lua_patterns_cache
+end
+
 --- Returns the start and stop value if set else the node's range.
 -- When the node's range is used, the stop is incremented by 1
 -- to make the search inclusive.
@@ -717,6 +760,58 @@ function Query:iter_captures(node, source, start, stop)
   return iter
 end
 
+--- Like |Query:iter_captures()|, but all the captures in the rows {start} to
+--- {stop} are found at once, and the common predicates are checked in C.
+--- The iterator returns the capture id, its range and the metadata; only
+--- the patterns with directives or other predicates go through Lua.
+---
+---@private
+---@param node TSNode under which the search will occur
+---@param source (integer|string) Source buffer or string to extract text from
+---@param start integer Starting line for the search
+---@param stop integer Stopping line for the search (end-exclusive)
+---@return fun(): integer, Range4, TSMetadata
+function Query:_iter_capture_ranges(node, source, start, stop)
+  if type(source) == 'number' and source == 0 then
+    source = api.nvim_get_current_buf()
+  end
+
+  local ranges, matches =
+    node:_rawquery_captures(self.query, source, start, stop, self:_lua_patterns())
+  local no_metadata = {}
+  local i = 0
+  local n = #ranges / 6
+  local function iter()
+    while i < n do
+      i = i + 1
+      local base = (i - 1) * 6
+      local capture = ranges[base + 1]
+      local range = { ranges[base + 2], ranges[base + 3], ranges[base + 4], ranges[base + 5] }
+      local match = matches[i]
+      if not match then
+        return capture, range, no_metadata
+      end
+
+      if match.active == nil then
+        match.active = self:match_preds(match, match.pattern, source)
+        if match.active then
+          match.metadata = {}
+          self:apply_directives(match, match.pattern, source, match.metadata)
+        end
+      end
+      if match.active then
+        local metadata = match.metadata
+        if metadata[capture] and metadata[capture].range then
+          local r = vim.treesitter.get_range(match[capture], source, metadata[capture])
+          range = { Range.unpack4(r) }
+        end
+        return capture, range, metadata
+      end
+    end
+  end
+  return iter
+end
+
 --- Iterates the matches of self on a given range.
 ---
 --- Iterate over all matches within a {node}. The arguments are the same as
@@ -70,6 +70,8 @@ static int64_t next_autocmd_id = 1;
 ///             Cannot be used with {buffer}
 ///             - buffer: Buffer number or list of buffer numbers for buffer local autocommands
 ///             |autocmd-buflocal|. Cannot be used with {pattern}
+///             - stats (boolean): also return how often and how long each
+///             autocommand was executed.
 /// @return Array of autocommands matching the criteria, with each item
 ///         containing the following fields:
 ///             - id (number): the autocommand id (only when defined with the API).
@@ -85,6 +87,10 @@ static int64_t next_autocmd_id = 1;
 ///             If the autocommand is buffer local |autocmd-buffer-local|:
 ///             - buflocal (boolean): true if the autocommand is buffer local.
 ///             - buffer (number): the buffer number.
+///             If {stats} was given:
+///             - calls (integer): number of times the autocommand was executed.
+///             - time (integer): total time spent executing it in nanoseconds,
+///             including the autocommands it triggered.
 Array nvim_get_autocmds(Dict(get_autocmds) *opts, Error *err)
   FUNC_API_SINCE(9)
 {
@@ -311,6 +317,11 @@ Array nvim_get_autocmds(Dict(get_autocmds) *opts, Error *err)
         PUT(autocmd_info, "buflocal", BOOLEAN_OBJ(false));
       }
 
+      if (opts->stats) {
+        PUT(autocmd_info, "calls", INTEGER_OBJ(ac->calls));
+        PUT(autocmd_info, "time", INTEGER_OBJ((Integer)ac->time));
+      }
+
       // TODO(sctx): It would be good to unify script_ctx to actually work with lua
       //  right now it's just super weird, and never really gives you the info that
       //  you would expect from this.
@@ -148,6 +148,10 @@ Integer nvim_buf_line_count(Buffer buffer, Error *err)
 ///               region, as args to `on_lines`.
 ///             - preview: also attach to command preview (i.e. 'inccommand')
 ///               events.
+///             - coalesce: merge adjacent and overlapping changes into one
+///               `nvim_buf_lines_event`, sent when Nvim gets to process
+///               events again (e.g. after a macro or |:normal| finished).
+///               Not for Lua callbacks.
 /// @param[out] err Error details, if any
 /// @return False if attach failed (invalid parameter, or buffer isn't loaded);
 ///         otherwise True. TODO: LUA_API_NO_EVAL
@@ -194,7 +198,7 @@ Boolean nvim_buf_attach(uint64_t channel_id, Buffer buffer, Boolean send_buffer,
     cb.preview = opts->preview;
   }
 
-  return buf_updates_register(buf, channel_id, cb, send_buffer);
+  return buf_updates_register(buf, channel_id, cb, send_buffer, opts->coalesce);
 }
 
 /// Deactivates buffer-update events on the channel.
@@ -361,14 +365,24 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
   size_t old_len = (size_t)(end - start);
   ptrdiff_t extra = 0;  // lines added to text, can be negative
   char **lines = (new_len != 0) ? xcalloc(new_len, sizeof(char *)) : NULL;
+  colnr_T *lens = (new_len != 0) ? xcalloc(new_len, sizeof(colnr_T)) : NULL;
+  // Number of old lines replaced by new ones, the other new lines are appended.
+  size_t to_replace = old_len < new_len ? old_len : new_len;
 
   for (size_t i = 0; i < new_len; i++) {
     const String l = replacement.items[i].data.string;
 
     // Fill lines[i] with l's contents. Convert NULs to newlines as required by
-    // NL-used-for-NUL.
-    lines[i] = xmemdupz(l.data, l.size);
-    memchrsub(lines[i], NUL, NL, l.size);
+    // NL-used-for-NUL.  Appended lines are copied into the memline, thus a
+    // line without a NUL can be used as-is, for a large request this avoids
+    // an allocation for every line.
+    if (i >= to_replace && l.data != NULL && memchr(l.data, NUL, l.size) == NULL) {
+      lines[i] = l.data;
+    } else {
+      lines[i] = xmemdupz(l.data, l.size);
+      memchrsub(lines[i], NUL, NL, l.size);
+    }
+    lens[i] = (colnr_T)l.size + 1;
   }
 
   try_start();
@@ -403,7 +417,6 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
   // For as long as possible, replace the existing old_len with the
   // new old_len. This is a more efficient operation, as it requires
   // less memory allocation and freeing.
-  size_t to_replace = old_len < new_len ? old_len : new_len;
   bcount_t inserted_bytes = 0;
   for (size_t i = 0; i < to_replace; i++) {
     int64_t lnum = start + (int64_t)i;
@@ -417,31 +430,36 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
       goto end;
     }
 
-    inserted_bytes += (bcount_t)strlen(lines[i]) + 1;
+    inserted_bytes += lens[i];
     // Mark lines that haven't been passed to the buffer as they need
     // to be freed later
     lines[i] = NULL;
   }
 
-  // Now we may need to insert the remaining new old_len
-  for (size_t i = to_replace; i < new_len; i++) {
-    int64_t lnum = start + (int64_t)i - 1;
-
-    VALIDATE(lnum < MAXLNUM, "%s", "Index out of bounds", {
+  // Now we may need to insert the remaining new old_len, all of them at once
+  if (to_replace < new_len) {
+    VALIDATE(start + (int64_t)new_len - 2 < MAXLNUM, "%s", "Index out of bounds", {
       goto end;
     });
 
-    if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
+    int to_append = (int)(new_len - to_replace);
+    int appended = ml_append_buf_lines(buf, (linenr_T)(start + (int64_t)to_replace - 1),
+                                       lines + to_replace, lens + to_replace, to_append, false);
+    for (size_t i = to_replace; i < to_replace + (size_t)appended; i++) {
+      inserted_bytes += lens[i];
+
+      // Same as with replacing, but we also need to free lines
+      if (lines[i] != replacement.items[i].data.string.data) {
+        xfree(lines[i]);
+      }
+      lines[i] = NULL;
+    }
+    extra += appended;
+
+    if (appended < to_append) {
       api_set_error(err, kErrorTypeException, "Failed to insert line");
       goto end;
     }
-
-    inserted_bytes += (bcount_t)strlen(lines[i]) + 1;
-
-    // Same as with replacing, but we also need to free lines
-    xfree(lines[i]);
-    lines[i] = NULL;
-    extra++;
   }
 
   // Adjust marks. Invalidate any which lie in the
@@ -464,10 +482,13 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
 
 end:
   for (size_t i = 0; i < new_len; i++) {
-    xfree(lines[i]);
+    if (lines[i] != replacement.items[i].data.string.data) {
+      xfree(lines[i]);
+    }
   }
 
   xfree(lines);
+  xfree(lens);
   try_end(err);
 }
 
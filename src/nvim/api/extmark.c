@@ -828,6 +828,116 @@ error:
   return 0;
 }
 
+typedef struct {
+  Integer line;
+  Integer col;
+  size_t idx;  ///< index in the "marks" argument
+} ExtmarkOrder;
+
+/// Compares the positions of two marks for nvim_buf_set_extmarks().
+static int extmark_order_cmp(const void *a, const void *b)
+{
+  const ExtmarkOrder *ma = a;
+  const ExtmarkOrder *mb = b;
+  if (ma->line != mb->line) {
+    return ma->line < mb->line ? -1 : 1;
+  }
+  if (ma->col != mb->col) {
+    return ma->col < mb->col ? -1 : 1;
+  }
+  // keep the given order of marks at the same position
+  return ma->idx < mb->idx ? -1 : (ma->idx > mb->idx);
+}
+
+/// Creates or updates several |extmarks| at once.
+///
+/// Does the same as calling |nvim_buf_set_extmark()| for each item, but with
+/// one call, and the marks are added in buffer order. Useful for plugins that
+/// place many marks at a time, such as highlighters.
+///
+/// Stops at the first mark that fails, the marks set before it are kept.
+///
+/// @param buffer  Buffer handle, or 0 for current buffer
+/// @param ns_id  Namespace id from |nvim_create_namespace()|
+/// @param marks  List of `[line, col, opts]` items, where the arguments are
+///               as for |nvim_buf_set_extmark()|. `opts` may be omitted.
+/// @param[out]  err   Error details, if any
+/// @return List of ids of the created/updated extmarks, in the order of
+///         `marks`.
+ArrayOf(Integer) nvim_buf_set_extmarks(Buffer buffer, Integer ns_id, Array marks, Arena *arena,
+                                       Error *err)
+  FUNC_API_SINCE(12)
+{
+  Array rv = ARRAY_DICT_INIT;
+
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return rv;
+  }
+
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return rv;
+  });
+
+  for (size_t i = 0; i < marks.size; i++) {
+    VALIDATE_T("mark", kObjectTypeArray, marks.items[i].type, {
+      return rv;
+    });
+    Array item = marks.items[i].data.array;
+    VALIDATE_EXP((item.size == 2 || item.size == 3), "mark", "[line, col, opts]", NULL, {
+      return rv;
+    });
+    VALIDATE_T("line", kObjectTypeInteger, item.items[0].type, {
+      return rv;
+    });
+    VALIDATE_T("col", kObjectTypeInteger, item.items[1].type, {
+      return rv;
+    });
+    if (item.size == 3) {
+      Object opts = item.items[2];
+      // allow empty array as empty dict for lua
+      VALIDATE_EXP((opts.type == kObjectTypeDictionary
+                    || (opts.type == kObjectTypeArray && opts.data.array.size == 0)),
+                   "opts", "Dictionary", api_typename(opts.type), {
+        return rv;
+      });
+    }
+  }
+
+  // Adding the marks in order means each one goes into the tree next to the
+  // one before, which touches far fewer nodes than a random order.
+  ExtmarkOrder *order = xmalloc(marks.size * sizeof(*order));
+  for (size_t i = 0; i < marks.size; i++) {
+    Array item = marks.items[i].data.array;
+    order[i] = (ExtmarkOrder){ item.items[0].data.integer, item.items[1].data.integer, i };
+  }
+  qsort(order, marks.size, sizeof(*order), extmark_order_cmp);
+
+  rv = arena_array(arena, marks.size);
+  for (size_t i = 0; i < marks.size; i++) {
+    ADD_C(rv, INTEGER_OBJ(0));
+  }
+  for (size_t i = 0; i < marks.size; i++) {
+    Array item = marks.items[order[i].idx].data.array;
+
+    Dict(set_extmark) opts[1] = { 0 };
+    if (item.size == 3 && item.items[2].type == kObjectTypeDictionary
+        && !api_dict_to_keydict(opts, KeyDict_set_extmark_get_field,
+                                item.items[2].data.dictionary, err)) {
+      break;
+    }
+
+    Integer id = nvim_buf_set_extmark(buffer, ns_id, order[i].line, order[i].col, opts, err);
+    if (ERROR_SET(err)) {
+      break;
+    }
+    rv.items[order[i].idx] = INTEGER_OBJ(id);
+  }
+
+  xfree(order);
+  return rv;
+}
+
 /// Removes an |extmark|.
 ///
 /// @param buffer Buffer handle, or 0 for current buffer
@@ -998,7 +1108,8 @@ void nvim_buf_clear_namespace(Buffer buffer, Integer ns_id, Integer line_start,
 /// doing `vim.rpcnotify` should be OK, but `vim.rpcrequest` is quite dubious
 /// for the moment.
 ///
-/// Note: It is not allowed to remove or update extmarks in 'on_line' callbacks.
+/// Note: It is not allowed to remove or update extmarks in 'on_line' and
+/// 'on_range' callbacks.
 ///
 /// @param ns_id  Namespace id from |nvim_create_namespace()|
 /// @param opts  Table of callbacks:
@@ -1014,6 +1125,12 @@ void nvim_buf_clear_namespace(Buffer buffer, Integer ns_id, Integer line_start,
 ///             - on_line: called for each buffer line being redrawn.
 ///                 (The interaction with fold lines is subject to change)
 ///                 ["win", winid, bufnr, row]
+///             - on_range: called once per window redraw, after on_win,
+///                 with the range of buffer lines that may be redrawn.
+///                 Ephemeral extmarks for all of them can be set here
+///                 instead of in on_line. Return `false` to skip the on_line
+///                 calls for that window.
+///                 ["range", winid, bufnr, toprow, botrow]
 ///             - on_end: called at the end of a redraw cycle
 ///                 ["end", tick]
 void nvim_set_decoration_provider(Integer ns_id, Dict(set_decoration_provider) *opts, Error *err)
@@ -1035,6 +1152,7 @@ void nvim_set_decoration_provider(Integer ns_id, Dict(set_decoration_provider) *
     { "on_buf", &opts->on_buf, &p->redraw_buf },
     { "on_win", &opts->on_win, &p->redraw_win },
     { "on_line", &opts->on_line, &p->redraw_line },
+    { "on_range", &opts->on_range, &p->redraw_range },
     { "on_end", &opts->on_end, &p->redraw_end },
     { "_on_hl_def", &opts->_on_hl_def, &p->hl_def },
     { "_on_spell_nav", &opts->_on_spell_nav, &p->spell_nav },
@@ -17,6 +17,7 @@ typedef struct {
   LuaRef on_buf;
   LuaRef on_win;
   LuaRef on_line;
+  LuaRef on_range;
   LuaRef on_end;
   LuaRef _on_hl_def;
   LuaRef _on_spell_nav;
@@ -255,6 +256,7 @@ typedef struct {
   Object group;
   Object pattern;
   Object buffer;
+  Boolean stats;
 } Dict(get_autocmds);
 
 typedef struct {
@@ -333,6 +335,7 @@ typedef struct {
   LuaRef on_reload;
   Boolean utf_sizes;
   Boolean preview;
+  Boolean coalesce;
 } Dict(buf_attach);
 
 typedef struct {
@@ -14,8 +14,11 @@
 #include "nvim/api/ui.h"
 #include "nvim/autocmd.h"
 #include "nvim/channel.h"
+#include "nvim/drawscreen.h"
 #include "nvim/eval.h"
 #include "nvim/event/defs.h"
+#include "nvim/event/multiqueue.h"
+#include "nvim/event/time.h"
 #include "nvim/event/wstream.h"
 #include "nvim/globals.h"
 #include "nvim/grid.h"
@@ -28,11 +31,21 @@
 #include "nvim/msgpack_rpc/channel.h"
 #include "nvim/msgpack_rpc/helpers.h"
 #include "nvim/option.h"
+#include "nvim/os/time.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
 
 #define BUF_POS(data) ((size_t)((data)->buf_wptr - (data)->buf))
 
+/// A flushed packing buffer that was written to the client, to be reused as
+/// the next packing buffer of any UI.
+static char *ui_buf_spare = NULL;
+
+/// When more than this many bytes are queued for writing to a UI client it
+/// is behind, until no more than UI_QUEUE_LOW bytes are queued.
+#define UI_QUEUE_HIGH (8 * 1024 * 1024)
+#define UI_QUEUE_LOW (1024 * 1024)
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "api/ui.c.generated.h"
 # include "ui_events_remote.generated.h"  // IWYU pragma: export
@@ -106,11 +119,64 @@ static void mpack_str(char **buf, const char *str)
   *buf += len;
 }
 
+/// Packs the text of screen cell "sc" as a string.
+static void mpack_schar(char **buf, schar_T sc)
+{
+  char c = schar_get_ascii(sc);
+  if (c != NUL) {
+    // Most cells are ASCII, avoid the copy and strlen().
+    mpack_w(buf, 0xa1);
+    mpack_w(buf, c);
+    return;
+  }
+  char sc_buf[MAX_SCHAR_SIZE];
+  schar_get(sc_buf, sc);
+  mpack_str(buf, sc_buf);
+}
+
+static char *ui_buf_alloc(void)
+{
+  char *buf = ui_buf_spare;
+  ui_buf_spare = NULL;
+  return buf ? buf : xmalloc(UI_BUF_SIZE);
+}
+
+static void ui_buf_release(void *buf)
+{
+  if (ui_buf_spare == NULL) {
+    ui_buf_spare = buf;
+  } else {
+    xfree(buf);
+  }
+}
+
+static void remote_ui_pacer_cb(TimeWatcher *watcher, void *data)
+{
+  UI *ui = data;
+  if (ui != NULL) {
+    ui->data->flush_pending = false;
+    ui_flush();
+  }
+}
+
+static void remote_ui_pacer_close_cb(TimeWatcher *watcher, void *data)
+{
+  multiqueue_free(watcher->events);
+  xfree(watcher);
+}
+
 static void remote_ui_destroy(UI *ui)
   FUNC_ATTR_NONNULL_ALL
 {
   UIData *data = ui->data;
   kv_destroy(data->call_buf);
+  xfree(data->buf);
+  if (data->pacer) {
+    time_watcher_stop(data->pacer);
+    // an already queued event must not use "ui"
+    data->pacer->data = NULL;
+    time_watcher_close(data->pacer, remote_ui_pacer_close_cb);
+  }
   XFREE_CLEAR(ui->term_name);
   xfree(ui);
 }
@@ -134,6 +200,7 @@ void remote_ui_free_all_mem(void)
     remote_ui_destroy(ui);
   });
   map_destroy(uint64_t, &connected_uis);
+  XFREE_CLEAR(ui_buf_spare);
 }
 #endif
 
@@ -225,6 +292,9 @@ void nvim_ui_attach(uint64_t channel_id, Integer width, Integer height, Dictiona
   data->ncalls_pos = NULL;
   data->ncalls = 0;
   data->ncells_pending = 0;
+  data->behind = false;
+  data->resync_pending = false;
+  data->buf = ui_buf_alloc();
   data->buf_wptr = data->buf;
   data->temp_buf = NULL;
   data->wildmenu_active = false;
@@ -385,6 +455,18 @@ static void ui_set_option(UI *ui, bool init, String name, Object value, Error *e
     return;
   }
 
+  if (strequal(name.data, "max_fps")) {
+    VALIDATE_T("max_fps", kObjectTypeInteger, value.type, {
+      return;
+    });
+    VALIDATE_INT((value.data.integer >= 0 && value.data.integer <= 1000), "max_fps",
+                 value.data.integer, {
+      return;
+    });
+    ui->data->max_fps = (int)value.data.integer;
+    return;
+  }
+
   if (strequal(name.data, "stdout_tty")) {
     VALIDATE_T("stdout_tty", kObjectTypeBoolean, value.type, {
       return;
@@ -672,6 +754,9 @@ static void push_call(UI *ui, const char *name, Array args)
 void remote_ui_grid_clear(UI *ui, Integer grid)
 {
   UIData *data = ui->data;
+  if (data->behind) {
+    return;
+  }
   Array args = data->call_buf;
   if (ui->ui_ext[kUILinegrid]) {
     ADD_C(args, INTEGER_OBJ(grid));
@@ -699,6 +784,9 @@ void remote_ui_grid_scroll(UI *ui, Integer grid, Integer top, Integer bot, Integ
                            Integer right, Integer rows, Integer cols)
 {
   UIData *data = ui->data;
+  if (data->behind) {
+    return;
+  }
   if (ui->ui_ext[kUILinegrid]) {
     Array args = data->call_buf;
     ADD_C(args, INTEGER_OBJ(grid));
@@ -851,6 +939,9 @@ void remote_ui_raw_line(UI *ui, Integer grid, Integer row, Integer startcol, Int
                         const sattr_T *attrs)
 {
   UIData *data = ui->data;
+  if (data->behind) {
+    return;
+  }
   if (ui->ui_ext[kUILinegrid]) {
     prepare_call(ui, "grid_line");
     data->ncalls++;
@@ -894,9 +985,7 @@ void remote_ui_raw_line(UI *ui, Integer grid, Integer row, Integer startcol, Int
         uint32_t csize = (repeat > 1) ? 3 : ((attrs[i] != last_hl) ? 2 : 1);
         nelem++;
         mpack_array(buf, csize);
-        char sc_buf[MAX_SCHAR_SIZE];
-        schar_get(sc_buf, chunk[i]);
-        mpack_str(buf, sc_buf);
+        mpack_schar(buf, chunk[i]);
         if (csize >= 2) {
           mpack_uint(buf, (uint32_t)attrs[i]);
           if (csize >= 3) {
@@ -971,16 +1060,54 @@ void remote_ui_flush_buf(UI *ui)
   data->nevents = 0;
   data->nevents_pos = NULL;
 
-  // TODO(bfredl): elide copy by a length one free-list like the arena
+  // Hand the packing buffer itself to the stream instead of copying it.  Once
+  // written it becomes the spare buffer, thus a redraw bigger than
+  // UI_BUF_SIZE normally alternates between two buffers.
   size_t size = BUF_POS(data);
-  WBuffer *buf = wstream_new_buffer(xmemdup(data->buf, size), size, 1, xfree);
+  WBuffer *buf = wstream_new_buffer(data->buf, size, 1, ui_buf_release);
   rpc_write_raw(data->channel_id, buf);
+  data->buf = ui_buf_alloc();
   data->buf_wptr = data->buf;
   // we have sent events to the client, but possibly not yet the final "flush"
   // event.
   data->flushed_events = true;
 
   data->ncells_pending = 0;
+
+  // When the client doesn't read fast enough stop sending grid contents,
+  // anything that is drawn meanwhile is sent with one full redraw when it
+  // has caught up.  Window grids are not cleared by a full redraw, thus
+  // this doesn't work with ext_multigrid.
+  if (!data->behind && !ui->ui_ext[kUIMultigrid]
+      && rpc_write_queue_size(data->channel_id) > UI_QUEUE_HIGH) {
+    data->behind = true;
+  }
+}
+
+/// Called when data was written to "channel_id" and "queued" bytes are left.
+void remote_ui_write_done(uint64_t channel_id, size_t queued)
+{
+  UI *ui = pmap_get(uint64_t)(&connected_uis, channel_id);
+  if (!ui) {
+    return;
+  }
+  UIData *data = ui->data;
+  if (data->behind && !data->resync_pending && queued <= UI_QUEUE_LOW) {
+    data->resync_pending = true;
+    multiqueue_put(main_loop.events, remote_ui_resync_event, (void *)(uintptr_t)channel_id);
+  }
+}
+
+static void remote_ui_resync_event(void **argv)
+{
+  UI *ui = pmap_get(uint64_t)(&connected_uis, (uint64_t)(uintptr_t)argv[0]);
+  if (!ui) {
+    return;
+  }
+  UIData *data = ui->data;
+  data->behind = false;
+  data->resync_pending = false;
+  redraw_all_later(UPD_CLEAR);
 }
 
 /// An intentional flush (vsync) when Nvim is finished redrawing the screen
@@ -991,6 +1118,26 @@ void remote_ui_flush(UI *ui)
 {
   UIData *data = ui->data;
   if (data->nevents > 0 || data->flushed_events) {
+    if (data->max_fps > 0) {
+      // Send at most "max_fps" frames per second.  Until the next frame is
+      // due the events are sent without "flush", so the UI doesn't draw them.
+      uint64_t interval = 1000000000 / (uint64_t)data->max_fps;
+      uint64_t now = os_hrtime();
+      if (now - data->last_flush < interval) {
+        if (!data->flush_pending) {
+          if (!data->pacer) {
+            data->pacer = xmalloc(sizeof(TimeWatcher));
+            time_watcher_init(&main_loop, data->pacer, ui);
+            data->pacer->events = multiqueue_new_child(main_loop.events);
+          }
+          uint64_t wait_ms = (interval - (now - data->last_flush)) / 1000000 + 1;
+          time_watcher_start(data->pacer, remote_ui_pacer_cb, wait_ms, 0);
+          data->flush_pending = true;
+        }
+        return;
+      }
+      data->last_flush = now;
+    }
     if (!ui->ui_ext[kUILinegrid]) {
       remote_ui_cursor_goto(ui, data->cursor_row, data->cursor_col);
     }
@@ -1103,4 +1250,5 @@ void remote_ui_inspect(UI *ui, Dictionary *info)
 {
   UIData *data = ui->data;
   PUT(*info, "chan", INTEGER_OBJ((Integer)data->channel_id));
+  PUT(*info, "max_fps", INTEGER_OBJ(data->max_fps));
 }
@@ -42,7 +42,9 @@
 #include "nvim/macros_defs.h"
 #include "nvim/mapping.h"
 #include "nvim/mark.h"
+#include "nvim/marktree.h"
 #include "nvim/mbyte.h"
+#include "nvim/memfile.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -63,6 +65,7 @@
 #include "nvim/state.h"
 #include "nvim/statusline.h"
 #include "nvim/strings.h"
+#include "nvim/syntax.h"
 #include "nvim/terminal.h"
 #include "nvim/ui.h"
 #include "nvim/vim_defs.h"
@@ -1092,6 +1095,51 @@ void nvim_chan_send(Integer chan, String data, Error *err)
   VALIDATE(!error, "%s", error, {});
 }
 
+/// Sends lines of a buffer to channel `chan`, each followed by a newline.
+/// Like |nvim_chan_send()| with the joined lines, but the lines are copied
+/// from the buffer in chunks as they are written, the whole text is never
+/// built as a single string.  Useful to send a large buffer to a formatter.
+///
+/// Indexing is zero-based, end-exclusive. Negative indices are interpreted
+/// as length+1+index: -1 refers to the index past the end. So to send the
+/// whole buffer, pass start=0 and end=-1.
+///
+/// @param chan id of the channel
+/// @param buffer Buffer handle, or 0 for current buffer
+/// @param start First line index
+/// @param end Last line index, exclusive
+/// @param[out] err Error details, if any
+/// @return Number of bytes written
+Integer nvim_chan_send_buf(Integer chan, Buffer buffer, Integer start, Integer end, Error *err)
+  FUNC_API_SINCE(12)
+{
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return 0;
+  }
+  VALIDATE(buf->b_ml.ml_mfp != NULL, "%s", "Buffer is not loaded", {
+    return 0;
+  });
+
+  bool oob = false;
+  start = normalize_index(buf, start, true, &oob);
+  end = normalize_index(buf, end, true, &oob);
+  VALIDATE(!oob, "%s", "Index out of bounds", {
+    return 0;
+  });
+  if (start >= end) {
+    return 0;
+  }
+
+  const char *error = NULL;
+  size_t written = channel_send_buf((uint64_t)chan, buf, (linenr_T)start + 1,
+                                    (linenr_T)end, &error);
+  VALIDATE(!error, "%s", error, {
+    return 0;
+  });
+  return (Integer)written;
+}
+
 /// Gets the current list of tabpage handles.
 ///
 /// @return List of tabpage handles
@@ -1595,6 +1643,7 @@ void nvim_set_client_info(uint64_t channel_id, String name, Dictionary version,
 /// @returns Dictionary describing a channel, with these keys:
 ///    - "id"       Channel id.
 ///    - "argv"     (optional) Job arguments list.
+///    - "spawn_time" (optional) Time it took to start the job, in nanoseconds.
 ///    - "stream"   Stream underlying the channel.
 ///         - "stdio"      stdin and stdout of this Nvim instance
 ///         - "stderr"     stderr of this Nvim instance
@@ -1612,6 +1661,8 @@ void nvim_set_client_info(uint64_t channel_id, String name, Dictionary version,
 ///    -  "client"  (optional) Info about the peer (client on the other end of
 ///                 the RPC channel), if provided by it via
 ///                 |nvim_set_client_info()|.
+///    -  "write_queue" (optional) Number of bytes waiting to be written to
+///                 the RPC channel, if any.
 ///
 Dictionary nvim_get_chan_info(Integer chan, Error *err)
   FUNC_API_SINCE(4)
@@ -1819,6 +1870,68 @@ Float nvim__id_float(Float flt)
   return flt;
 }
 
+/// Gets stats of the RPC requests handled so far.
+///
+/// Times are in microseconds.  The "wait" and "time" histograms count the
+/// requests by the time spent waiting in the event queue and executing the
+/// method: item i (zero based) counts the times below 2^i and at least
+/// 2^(i-1) microseconds.
+///
+/// @return Map of method name to a map with these keys:
+///   - "count"       Number of requests and notifications
+///   - "wait_total"  Total time spent waiting in the event queue
+///   - "time_total"  Total time spent executing the method
+///   - "wait"        Histogram of the waiting times
+///   - "time"        Histogram of the execution times
+Dictionary nvim__rpc_stats(void)
+{
+  return rpc_get_stats();
+}
+
+/// Gets the time from receiving keys to flushing the screen that shows their
+/// effect, by mode.
+///
+/// Times are in microseconds.  When several keys are received before the
+/// flush the time is taken from the oldest one.  The "time" histogram counts
+/// the latencies like the ones of |nvim__rpc_stats()|: item i (zero based)
+/// counts the times below 2^i and at least 2^(i-1) microseconds.  "p50" and
+/// "p99" are the upper bounds of the items holding those percentiles.
+///
+/// @param reset  Clear the stats after getting them
+/// @return Map of mode name, as in 'guicursor', to a map with these keys:
+///   - "count"  Number of flushes after input
+///   - "p50", "p99", "max"  Latencies
+///   - "time"   Histogram of the latencies
+Dictionary nvim__input_latency(Boolean reset)
+{
+  Dictionary rv = input_latency_get();
+  if (reset) {
+    input_latency_reset();
+  }
+  return rv;
+}
+
+/// Gets the time spent redrawing the screen, by phase and by window.
+///
+/// Times are in microseconds and count only the redraws since the last reset.
+/// The phases are nested: "win_update" includes "win_line", "fold" and
+/// "providers", and "screen" includes everything else.
+///
+/// @param reset  Clear the stats after getting them
+/// @return Map with these keys:
+///   - "screen", "win_update", "win_line", "fold", "providers", "status",
+///     "tabline": Map with "count" and "time" of the phase
+///   - "windows": Array of maps with "win", "count" (times the window was
+///     updated), "lines" (lines drawn) and "time" for each redrawn window
+Dictionary nvim__redraw_stats(Boolean reset)
+{
+  Dictionary rv = redraw_get_stats();
+  if (reset) {
+    redraw_stats_reset();
+  }
+  return rv;
+}
+
 /// Gets internal stats.
 ///
 /// @return Map of various internal stats.
@@ -1827,9 +1940,95 @@ Dictionary nvim__stats(void)
   Dictionary rv = ARRAY_DICT_INIT;
   PUT(rv, "fsync", INTEGER_OBJ(g_stats.fsync));
   PUT(rv, "log_skip", INTEGER_OBJ(g_stats.log_skip));
+  PUT(rv, "log_drop", INTEGER_OBJ(log_drop_count()));
   PUT(rv, "lua_refcount", INTEGER_OBJ(nlua_get_global_ref_count()));
   PUT(rv, "redraw", INTEGER_OBJ(g_stats.redraw));
   PUT(rv, "arena_alloc_count", INTEGER_OBJ((Integer)arena_alloc_count));
+  PUT(rv, "arena_reuse_count", INTEGER_OBJ((Integer)arena_reuse_count));
+  PUT(rv, "arena_bytes", INTEGER_OBJ((Integer)arena_bytes));
+  PUT(rv, "arena_peak_bytes", INTEGER_OBJ((Integer)arena_peak_bytes));
+  PUT(rv, "memfile_hit", INTEGER_OBJ(g_stats.memfile_hit));
+  PUT(rv, "memfile_miss", INTEGER_OBJ(g_stats.memfile_miss));
+  PUT(rv, "memfile_evict", INTEGER_OBJ(g_stats.memfile_evict));
+  PUT(rv, "memfile_pack", INTEGER_OBJ(g_stats.memfile_pack));
+  PUT(rv, "undo_pack", INTEGER_OBJ(g_stats.undo_pack));
+  PUT(rv, "memfile_bytes", INTEGER_OBJ((Integer)mf_mem_used()));
+  PUT(rv, "regexp_cache_hit", INTEGER_OBJ(g_stats.regexp_cache_hit));
+  PUT(rv, "regexp_cache_miss", INTEGER_OBJ(g_stats.regexp_cache_miss));
+  PUT(rv, "glyph_cache_hit", INTEGER_OBJ(g_stats.glyph_cache_hit));
+  PUT(rv, "glyph_cache_miss", INTEGER_OBJ(g_stats.glyph_cache_miss));
+  PUT(rv, "glyph_cache_clear", INTEGER_OBJ(g_stats.glyph_cache_clear));
+  PUT(rv, "glyph_cache_bytes", INTEGER_OBJ((Integer)schar_cache_size()));
+  PUT(rv, "syntax_prefill", INTEGER_OBJ(g_stats.syntax_prefill));
+  PUT(rv, "syntax_skip", INTEGER_OBJ(g_stats.syntax_skip));
+  PUT(rv, "spell_cache_hit", INTEGER_OBJ(g_stats.spell_cache_hit));
+  PUT(rv, "hl_attr_entries", INTEGER_OBJ((Integer)hl_attr_table_size()));
+  PUT(rv, "hl_combine_entries", INTEGER_OBJ((Integer)hl_combine_cache_size()));
+  PUT(rv, "hl_blend_entries", INTEGER_OBJ((Integer)hl_blend_cache_size()));
+  PUT(rv, "hl_table_reset", INTEGER_OBJ(g_stats.hl_table_reset));
+  PUT(rv, "hl_blend_clear", INTEGER_OBJ(g_stats.hl_blend_clear));
+  PUT(rv, "interned_strings", INTEGER_OBJ((Integer)str_intern_count()));
+#ifdef SLAB_ALLOC
+  SlabStats slab = slab_stats_get();
+  PUT(rv, "slab_alloc", INTEGER_OBJ(slab.alloc));
+  PUT(rv, "slab_free", INTEGER_OBJ(slab.free));
+  PUT(rv, "slab_remote_free", INTEGER_OBJ(slab.remote_free));
+  PUT(rv, "slab_chunks", INTEGER_OBJ(slab.chunks));
+  PUT(rv, "slab_bytes", INTEGER_OBJ(slab.bytes));
+#endif
+  return rv;
+}
+
+/// Gets an estimate of the memory used by subsystems that can grow without
+/// bound in a long-running instance.
+///
+/// The sizes are computed from the data structures when called, they are
+/// not counted on each allocation. Allocations made by tree-sitter are not
+/// included.
+///
+/// @return Map with the total bytes of "memfile", "undo", "marktree",
+///         "syntax", "terminal", "lua" (Lua heap) and "rpc" (channel
+///         buffers), and "buffers": a list with a map for each loaded buffer,
+///         with "buf" (handle) and the per-buffer sizes of the same kinds.
+Dictionary nvim__memory_stats(void)
+{
+  Dictionary rv = ARRAY_DICT_INIT;
+  Array buffers = ARRAY_DICT_INIT;
+  size_t undo = 0;
+  size_t marktree = 0;
+  size_t syntax = 0;
+  size_t terminal = 0;
+
+  FOR_ALL_BUFFERS(buf) {
+    if (buf->b_ml.ml_mfp == NULL) {
+      continue;
+    }
+    size_t b_marktree = marktree_mem_used(buf->b_marktree);
+    size_t b_syntax = syn_stack_bytes(buf);
+    size_t b_terminal = buf->terminal ? terminal_scrollback_bytes(buf->terminal) : 0;
+    undo += buf->b_u_mem;
+    marktree += b_marktree;
+    syntax += b_syntax;
+    terminal += b_terminal;
+
+    Dictionary b = ARRAY_DICT_INIT;
+    PUT(b, "buf", BUFFER_OBJ(buf->handle));
+    PUT(b, "memfile", INTEGER_OBJ((Integer)buf->b_ml.ml_mfp->mf_mem_used));
+    PUT(b, "undo", INTEGER_OBJ((Integer)buf->b_u_mem));
+    PUT(b, "marktree", INTEGER_OBJ((Integer)b_marktree));
+    PUT(b, "syntax", INTEGER_OBJ((Integer)b_syntax));
+    PUT(b, "terminal", INTEGER_OBJ((Integer)b_terminal));
+    ADD(buffers, DICTIONARY_OBJ(b));
+  }
+
+  PUT(rv, "memfile", INTEGER_OBJ((Integer)mf_mem_used()));
+  PUT(rv, "undo", INTEGER_OBJ((Integer)undo));
+  PUT(rv, "marktree", INTEGER_OBJ((Integer)marktree));
+  PUT(rv, "syntax", INTEGER_OBJ((Integer)syntax));
+  PUT(rv, "terminal", INTEGER_OBJ((Integer)terminal));
+  PUT(rv, "lua", INTEGER_OBJ((Integer)nlua_heap_bytes()));
+  PUT(rv, "rpc", INTEGER_OBJ((Integer)channel_rpc_buffer_bytes()));
+  PUT(rv, "buffers", ARRAY_OBJ(buffers));
   return rv;
 }
 
@@ -1841,6 +2040,7 @@ Dictionary nvim__stats(void)
 ///   - "rgb"     true if the UI uses RGB colors (false implies |cterm-colors|)
 ///   - "ext_..." Requested UI extensions, see |ui-option|
 ///   - "chan"    |channel-id| of remote UI
+///   - "max_fps" Limit of "flush" events per second, zero for none
 Array nvim_list_uis(void)
   FUNC_API_SINCE(4)
 {
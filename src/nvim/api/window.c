@@ -1,8 +1,11 @@
+#include <lauxlib.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "lua.h"
+
 #include "nvim/api/keysets_defs.h"
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/dispatch.h"
@@ -68,6 +71,26 @@ void nvim_win_set_buf(Window window, Buffer buffer, Error *err)
   win_set_buf(win, buf, false, err);
 }
 
+/// Build the (a, b) tuple returned by an API function, or push it on the Lua
+/// stack as a table, without an Array, when called from Lua.
+///
+/// @param lstate  Lua state. When NULL the Array is returned instead.
+static Array integer_pair(Integer a, Integer b, lua_State *lstate)
+{
+  Array rv = ARRAY_DICT_INIT;
+  if (lstate) {
+    lua_createtable(lstate, 2, 0);
+    lua_pushnumber(lstate, (lua_Number)a);
+    lua_rawseti(lstate, -2, 1);
+    lua_pushnumber(lstate, (lua_Number)b);
+    lua_rawseti(lstate, -2, 2);
+  } else {
+    ADD(rv, INTEGER_OBJ(a));
+    ADD(rv, INTEGER_OBJ(b));
+  }
+  return rv;
+}
+
 /// Gets the (1,0)-indexed, buffer-relative cursor position for a given window
 /// (different windows showing the same buffer have independent cursor
 /// positions). |api-indexing|
@@ -77,15 +100,14 @@ void nvim_win_set_buf(Window window, Buffer buffer, Error *err)
 /// @param window   Window handle, or 0 for current window
 /// @param[out] err Error details, if any
 /// @return (row, col) tuple
-ArrayOf(Integer, 2) nvim_win_get_cursor(Window window, Error *err)
+ArrayOf(Integer, 2) nvim_win_get_cursor(Window window, lua_State *lstate, Error *err)
   FUNC_API_SINCE(1)
 {
   Array rv = ARRAY_DICT_INIT;
   win_T *win = find_window_by_handle(window, err);
 
   if (win) {
-    ADD(rv, INTEGER_OBJ(win->w_cursor.lnum));
-    ADD(rv, INTEGER_OBJ(win->w_cursor.col));
+    rv = integer_pair(win->w_cursor.lnum, win->w_cursor.col, lstate);
   }
 
   return rv;
@@ -289,15 +311,14 @@ void nvim_win_del_var(Window window, String name, Error *err)
 /// @param window   Window handle, or 0 for current window
 /// @param[out] err Error details, if any
 /// @return (row, col) tuple with the window position
-ArrayOf(Integer, 2) nvim_win_get_position(Window window, Error *err)
+ArrayOf(Integer, 2) nvim_win_get_position(Window window, lua_State *lstate, Error *err)
   FUNC_API_SINCE(1)
 {
   Array rv = ARRAY_DICT_INIT;
   win_T *win = find_window_by_handle(window, err);
 
   if (win) {
-    ADD(rv, INTEGER_OBJ(win->w_winrow));
-    ADD(rv, INTEGER_OBJ(win->w_wincol));
+    rv = integer_pair(win->w_winrow, win->w_wincol, lstate);
   }
 
   return rv;
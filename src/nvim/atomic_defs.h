@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Atomic operations on variables shared between threads.
+//
+// MSVC has no __atomic builtins, the Interlocked functions are used instead.
+// They are full barriers and work on 64 bit integers, a variable used with
+// ATOMIC_LOAD(), ATOMIC_ADD() etc. must be that wide.
+
+#ifdef _MSC_VER
+// uv.h includes windows.h, after winsock2.h.
+# include <uv.h>
+
+# define ATOMIC_LOAD(p) InterlockedCompareExchange64((LONG64 volatile *)(p), 0, 0)
+# define ATOMIC_LOAD_ACQ(p) ATOMIC_LOAD(p)
+# define ATOMIC_STORE_REL(p, v) InterlockedExchange64((LONG64 volatile *)(p), (LONG64)(v))
+# define ATOMIC_INC(p) InterlockedIncrement64((LONG64 volatile *)(p))
+# define ATOMIC_ADD(p, n) InterlockedExchangeAdd64((LONG64 volatile *)(p), (n))
+# define ATOMIC_EXCHANGE(p, v) InterlockedExchange64((LONG64 volatile *)(p), (LONG64)(v))
+# define ATOMIC_LOAD_BOOL(p) (InterlockedCompareExchange8((char volatile *)(p), 0, 0) != 0)
+# define ATOMIC_STORE_BOOL(p, v) InterlockedExchange8((char volatile *)(p), (char)(v))
+# define ATOMIC_LOAD_PTR(p) InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+# define ATOMIC_XCHG_PTR(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (v))
+# define ATOMIC_CAS_PTR(p, old, new) \
+  (InterlockedCompareExchangePointer((PVOID volatile *)(p), (new), (old)) == (old))
+#else
+/// Load without ordering, for counters and flags.
+# define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+/// Load that sees the writes done before the matching ATOMIC_STORE_REL().
+# define ATOMIC_LOAD_ACQ(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define ATOMIC_STORE_REL(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+# define ATOMIC_INC(p) __atomic_fetch_add((p), 1, __ATOMIC_RELAXED)
+# define ATOMIC_ADD(p, n) __atomic_fetch_add((p), (n), __ATOMIC_RELAXED)
+/// @return  the old value.
+# define ATOMIC_EXCHANGE(p, v) __atomic_exchange_n((p), (v), __ATOMIC_RELAXED)
+# define ATOMIC_LOAD_BOOL(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+# define ATOMIC_STORE_BOOL(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+/// Pointers are published with release and read with acquire ordering.
+# define ATOMIC_LOAD_PTR(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define ATOMIC_XCHG_PTR(p, v) __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+/// @return  true if "*p" was "old" and is now "new".
+# define ATOMIC_CAS_PTR(p, old, new) \
+  __atomic_compare_exchange_n((p), &(__typeof__(*(p))){ (old) }, (new), false, \
+                              __ATOMIC_RELEASE, __ATOMIC_RELAXED)
+#endif
@@ -96,6 +96,20 @@ static int current_augroup = AUGROUP_DEFAULT;
 // While deleting autocmds, they aren't actually remover, just marked.
 static bool au_need_clean = false;
 
+// Incremented when an autocommand is added or deleted, see has_event_buf().
+static uint64_t au_gen = 1;
+
+// Events checked by has_event_buf() for every typed key, the index is the bit
+// used in b_au_known and b_au_has.
+static const event_T buf_events[] = {
+  EVENT_CURSORMOVED,
+  EVENT_CURSORMOVEDI,
+  EVENT_TEXTCHANGED,
+  EVENT_TEXTCHANGEDI,
+  EVENT_TEXTCHANGEDP,
+  EVENT_BUFMODIFIEDSET,
+};
+
 static int autocmd_blocked = 0;  // block all autocmds
 
 static bool autocmd_nested = false;
@@ -299,6 +313,7 @@ static void aucmd_del(AutoCmd *ac)
   XFREE_CLEAR(ac->desc);
 
   au_need_clean = true;
+  au_gen++;
 }
 
 void aucmd_del_for_event_and_group(event_T event, int group)
@@ -1036,6 +1051,7 @@ int autocmd_register(int64_t id, event_T event, const char *pat, int patlen, int
     ap->refcount = 0;
     ap->pat = xmemdupz(pat, (size_t)patlen);
     ap->patlen = patlen;
+    aupat_classify(ap);
 
     // need to initialize last_mode for the first ModeChanged autocmd
     if (event == EVENT_MODECHANGED && !has_event(EVENT_MODECHANGED)) {
@@ -1080,6 +1096,9 @@ int autocmd_register(int64_t id, event_T event, const char *pat, int patlen, int
   ac->once = once;
   ac->nested = nested;
   ac->desc = desc == NULL ? NULL : xstrdup(desc);
+  ac->calls = 0;
+  ac->time = 0;
+  au_gen++;
 
   return OK;
 }
@@ -1528,6 +1547,84 @@ bool has_event(event_T event) FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
   return kv_size(autocmds[(int)event]) != 0;
 }
 
+/// Return true when "event" has an autocommand that applies to buffer "buf",
+/// matching its name or being local to it, like apply_autocmds() would find.
+/// For the events checked for every typed key the result is kept in the
+/// buffer until autocommands are added or deleted or the buffer is renamed.
+bool has_event_buf(event_T event, buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (!has_event(event)) {
+    return false;
+  }
+
+  int bit = 0;
+  while (bit < (int)ARRAY_SIZE(buf_events) && buf_events[bit] != event) {
+    bit++;
+  }
+  if (bit == (int)ARRAY_SIZE(buf_events)) {
+    return true;
+  }
+
+  if (buf->b_au_gen != au_gen || buf->b_au_fic != (bool)p_fic
+      || au_name_changed(buf->b_au_fname, buf->b_ffname)
+      || au_name_changed(buf->b_au_sfname, buf->b_sfname)) {
+    buf->b_au_gen = au_gen;
+    buf->b_au_fic = (bool)p_fic;
+    xfree(buf->b_au_fname);
+    buf->b_au_fname = buf->b_ffname == NULL ? NULL : xstrdup(buf->b_ffname);
+    xfree(buf->b_au_sfname);
+    buf->b_au_sfname = buf->b_sfname == NULL ? NULL : xstrdup(buf->b_sfname);
+    buf->b_au_known = 0;
+    buf->b_au_has = 0;
+  }
+
+  if (!(buf->b_au_known & (1 << bit))) {
+    buf->b_au_known |= 1 << bit;
+    if (buf_has_autocmd(event, buf)) {
+      buf->b_au_has |= 1 << bit;
+    }
+  }
+  return (buf->b_au_has & (1 << bit)) != 0;
+}
+
+static bool au_name_changed(const char *cached, const char *name)
+{
+  return cached == NULL ? name != NULL : name == NULL || strcmp(cached, name) != 0;
+}
+
+/// Check the autocommands for "event" against the name of buffer "buf" the way
+/// apply_autocmds_group() does.
+static bool buf_has_autocmd(event_T event, buf_T *buf)
+{
+  char *fname = xstrdup(buf->b_ffname == NULL ? "" : buf->b_ffname);
+  char *sfname = buf->b_sfname == NULL ? NULL : xstrdup(buf->b_sfname);
+#ifdef BACKSLASH_IN_FILENAME
+  forward_slash(fname);
+  if (sfname != NULL) {
+    forward_slash(sfname);
+  }
+#endif
+  char *tail = path_tail(fname);
+
+  bool retval = false;
+  AutoCmdVec *const acs = &autocmds[(int)event];
+  for (size_t i = 0; i < kv_size(*acs); i++) {
+    AutoPat *const ap = kv_A(*acs, i).pat;
+    if (ap != NULL
+        && (ap->buflocal_nr == 0
+            ? aupat_match(ap, fname, sfname, tail)
+            : ap->buflocal_nr == buf->b_fnum)) {
+      retval = true;
+      break;
+    }
+  }
+
+  xfree(fname);
+  xfree(sfname);
+  return retval;
+}
+
 /// Return true when there is a CursorHold/CursorHoldI autocommand defined for
 /// the current mode.
 bool has_cursorhold(void) FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
@@ -1768,6 +1865,7 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
     .group = group,
     .event = event,
     .arg_bufnr = autocmd_bufnr,
+    .timed_idx = SIZE_MAX,
   };
   aucmd_next(&patcmd);
 
@@ -1804,6 +1902,8 @@ bool apply_autocmds_group(event_T event, char *fname, char *fname_io, bool force
 
     // Execute the autocmd. The `getnextac` callback handles iteration.
     do_cmdline(NULL, getnextac, &patcmd, DOCMD_NOWAIT | DOCMD_VERBOSE | DOCMD_REPEAT);
+    // do_cmdline() may stop before getnextac() returned NULL.
+    aucmd_account(&patcmd);
 
     did_emsg += save_did_emsg;
     set_pressedreturn(save_ex_pressedreturn);
@@ -1924,6 +2024,93 @@ bool is_autocmd_blocked(void)
   return autocmd_blocked != 0;
 }
 
+/// Find out whether "ap" is a plain name with at most a leading or trailing
+/// "*", which can be matched by comparing the literal part with the tail of the
+/// file name instead of running the regexp.  Patterns that match against the
+/// full path, or with other wildcards or special characters, use the regexp.
+static void aupat_classify(AutoPat *ap)
+{
+  ap->kind = kAuPatRegex;
+  ap->lit_off = 0;
+  ap->lit_len = 0;
+  if (ap->buflocal_nr != 0 || ap->allow_dirs) {
+    return;
+  }
+
+  const char *p = ap->pat;
+  const char *e = ap->pat + ap->patlen;
+  bool lead = false;
+  bool trail = false;
+  while (p < e && *p == '*') {
+    p++;
+    lead = true;
+  }
+  while (e > p && e[-1] == '*') {
+    e--;
+    trail = true;
+  }
+  if (p == e) {
+    // Only stars ("*" matches anything), or an empty pattern (matches an
+    // empty name only).
+    if (lead) {
+      ap->kind = kAuPatAny;
+    }
+    return;
+  }
+  if (lead && trail) {
+    return;
+  }
+  for (const char *s = p; s < e; s++) {
+    if (!ASCII_ISALNUM(*s) && vim_strchr("._-+", (uint8_t)(*s)) == NULL) {
+      return;
+    }
+  }
+
+  ap->kind = lead ? kAuPatSuffix : trail ? kAuPatPrefix : kAuPatExact;
+  ap->lit_off = (int)(p - ap->pat);
+  ap->lit_len = (int)(e - p);
+}
+
+/// Check whether a file name matches the pattern of a (not buffer-local)
+/// AutoPat.  Simple patterns compare the literal with "tail", others use
+/// match_file_pat().
+static bool aupat_match(AutoPat *ap, char *fname, char *sfname, char *tail)
+{
+  // With 'fileignorecase' the regexp folds non-ASCII characters, which a
+  // byte compare can't do.
+  if (ap->kind != kAuPatRegex && (!p_fic || !has_non_ascii(tail))) {
+    if (ap->kind == kAuPatAny) {
+      return true;
+    }
+    const char *lit = ap->pat + ap->lit_off;
+    const size_t lit_len = (size_t)ap->lit_len;
+    const size_t len = strlen(tail);
+    if (len < lit_len || (ap->kind == kAuPatExact && len != lit_len)) {
+      return false;
+    }
+    const char *s = ap->kind == kAuPatSuffix ? tail + len - lit_len : tail;
+    return p_fic ? STRNICMP(s, lit, lit_len) == 0 : strncmp(s, lit, lit_len) == 0;
+  }
+  return match_file_pat(NULL, &ap->reg_prog, fname, sfname, tail, ap->allow_dirs);
+}
+
+/// Add the time since the last autocommand returned by getnextac() was
+/// started to its total.  The command itself is run by do_cmdline() after
+/// getnextac() returns, thus this happens when getting the next one.
+/// Deleted autocommands are not removed while autocommands are executing, the
+/// index stays valid.
+static void aucmd_account(AutoPatCmd *apc)
+{
+  if (apc->timed_idx == SIZE_MAX) {
+    return;
+  }
+  AutoCmdVec *const acs = &autocmds[(int)apc->event];
+  if (apc->timed_idx < kv_size(*acs)) {
+    kv_A(*acs, apc->timed_idx).time += os_hrtime() - apc->timed_start;
+  }
+  apc->timed_idx = SIZE_MAX;
+}
+
 /// Find next matching autocommand.
 /// If next autocommand was not found, sets lastpat to NULL and cmdidx to SIZE_MAX on apc.
 static void aucmd_next(AutoPatCmd *apc)
@@ -1948,7 +2135,7 @@ static void aucmd_next(AutoPatCmd *apc)
       }
       // Skip autocommands that don't match the pattern or buffer number.
       if (ap->buflocal_nr == 0
-          ? !match_file_pat(NULL, &ap->reg_prog, apc->fname, apc->sfname, apc->tail, ap->allow_dirs)
+          ? !aupat_match(ap, apc->fname, apc->sfname, apc->tail)
           : ap->buflocal_nr != apc->arg_bufnr) {
         continue;
       }
@@ -2047,6 +2234,7 @@ char *getnextac(int c, void *cookie, int indent, bool do_concat)
   AutoPatCmd *const apc = (AutoPatCmd *)cookie;
   AutoCmdVec *const acs = &autocmds[(int)apc->event];
 
+  aucmd_account(apc);
   aucmd_next(apc);
   if (apc->lastpat == NULL) {
     return NULL;
@@ -2057,6 +2245,10 @@ char *getnextac(int c, void *cookie, int indent, bool do_concat)
   assert(ac->pat != NULL);
   bool oneshot = ac->once;
 
+  ac->calls++;
+  apc->timed_idx = apc->auidx;
+  apc->timed_start = os_hrtime();
+
   if (p_verbose >= 9) {
     verbose_enter_scroll();
     char *exec_to_string = aucmd_exec_to_string(ac, ac->exec);
@@ -2140,7 +2332,7 @@ bool has_autocmd(event_T event, char *sfname, buf_T *buf)
     AutoPat *const ap = kv_A(*acs, i).pat;
     if (ap != NULL
         && (ap->buflocal_nr == 0
-            ? match_file_pat(NULL, &ap->reg_prog, fname, sfname, tail, ap->allow_dirs)
+            ? aupat_match(ap, fname, sfname, tail)
             : buf != NULL && ap->buflocal_nr == buf->b_fnum)) {
       retval = true;
       break;
@@ -31,6 +31,15 @@ typedef struct {
   int save_State;                 ///< saved State
 } aco_save_T;
 
+/// How an AutoPat is matched, see aupat_classify().
+typedef enum {
+  kAuPatRegex = 0,  ///< Run "reg_prog"
+  kAuPatAny,        ///< "*": matches any name
+  kAuPatExact,      ///< "name": tail is the literal
+  kAuPatSuffix,     ///< "*.ext": tail ends with the literal
+  kAuPatPrefix,     ///< "name*": tail starts with the literal
+} AuPatKind;
+
 typedef struct {
   size_t refcount;          ///< Reference count (freed when reaches zero)
   char *pat;                ///< Pattern as typed
@@ -39,6 +48,9 @@ typedef struct {
   int patlen;               ///< strlen() of pat
   int buflocal_nr;          ///< !=0 for buffer-local AutoPat
   char allow_dirs;          ///< Pattern may match whole path
+  AuPatKind kind;           ///< How the pattern is matched
+  int lit_off;              ///< Offset of the literal in "pat"
+  int lit_len;              ///< Length of the literal in "pat"
 } AutoPat;
 
 typedef struct {
@@ -49,6 +61,9 @@ typedef struct {
   sctx_T script_ctx;        ///< Script context where it is defined
   bool once;                ///< "One shot": removed after execution
   bool nested;              ///< If autocommands nest here
+  int64_t calls;            ///< Number of times it was executed
+  uint64_t time;            ///< Time spent executing it in nanoseconds,
+                            ///< including the autocommands it triggered
 } AutoCmd;
 
 /// Struct used to keep status while executing autocommands for an event.
@@ -66,6 +81,8 @@ struct AutoPatCmd_S {
   int arg_bufnr;            ///< Initially equal to <abuf>, set to zero when buf is deleted
   Object *data;             ///< Arbitrary data
   AutoPatCmd *next;         ///< Chain of active apc-s for auto-invalidation
+  size_t timed_idx;         ///< Index of the autocmd being executed or SIZE_MAX
+  uint64_t timed_start;     ///< When the autocmd at "timed_idx" was started
 };
 
 typedef kvec_t(AutoCmd) AutoCmdVec;
@@ -59,6 +59,13 @@ static inline uint32_t htobe32(uint32_t host_32bits)
 }
 #endif
 
+/// @return the length of the Base64 encoding of "src_len" bytes.
+size_t base64_encoded_len(size_t src_len)
+  FUNC_ATTR_CONST
+{
+  return ((src_len + 2) / 3) * 4;
+}
+
 /// Encode a string using Base64.
 ///
 /// @param src String to encode
@@ -66,11 +73,28 @@ static inline uint32_t htobe32(uint32_t host_32bits)
 /// @return Base64 encoded string
 char *base64_encode(const char *src, size_t src_len)
   FUNC_ATTR_NONNULL_ALL
+{
+  const size_t out_len = base64_encoded_len(src_len);
+  char *dest = xmalloc(out_len + 1);
+  base64_encode_to(src, src_len, dest);
+  dest[out_len] = '\0';
+  return dest;
+}
+
+/// Encode a string using Base64 into a buffer.
+///
+/// Encoding the input in pieces whose length is a multiple of 3 gives the
+/// same result as encoding it at once.
+///
+/// @param src String to encode
+/// @param src_len Length of the string
+/// @param[out] dest Buffer for base64_encoded_len() bytes, not NUL-terminated
+void base64_encode_to(const char *src, size_t src_len, char *dest)
+  FUNC_ATTR_NONNULL_ALL
 {
   assert(src != NULL);
 
-  const size_t out_len = ((src_len + 2) / 3) * 4;
-  char *dest = xmalloc(out_len + 1);
+  const size_t out_len = base64_encoded_len(src_len);
 
   size_t src_i = 0;
   size_t out_i = 0;
@@ -124,18 +148,16 @@ char *base64_encode(const char *src, size_t src_len)
   for (; out_i < out_len; out_i++) {
     dest[out_i] = '=';
   }
-
-  dest[out_len] = '\0';
-
-  return dest;
 }
 
 /// Decode a Base64 encoded string.
 ///
 /// @param src Base64 encoded string
 /// @param src_len Length of {src}
-/// @return Decoded string
-char *base64_decode(const char *src, size_t src_len)
+/// @param[out] out_lenp Set to the length of the result, which may contain NUL
+/// @return Decoded string, NUL-terminated, or NULL if {src} is invalid
+char *base64_decode(const char *src, size_t src_len, size_t *out_lenp)
+  FUNC_ATTR_NONNULL_ALL
 {
   assert(src != NULL);
 
@@ -163,6 +185,23 @@ char *base64_decode(const char *src, size_t src_len)
   size_t src_i = 0;
   int leftover_i = -1;
 
+  // Decode whole groups of 4 characters, except the last one that may have
+  // padding.  A group with an invalid character is left to the loop below,
+  // which starts at a group boundary in the same state as after a group.
+  for (; src_i + 4 < src_len; src_i += 4, out_i += 3) {
+    const uint32_t a = char_to_index[s[src_i]];
+    const uint32_t b = char_to_index[s[src_i + 1]];
+    const uint32_t c = char_to_index[s[src_i + 2]];
+    const uint32_t d = char_to_index[s[src_i + 3]];
+    if (a == 0 || b == 0 || c == 0 || d == 0) {
+      break;
+    }
+    const uint32_t bits = ((a - 1) << 18) | ((b - 1) << 12) | ((c - 1) << 6) | (d - 1);
+    dest[out_i + 0] = (char)(bits >> 16);
+    dest[out_i + 1] = (char)(bits >> 8);
+    dest[out_i + 2] = (char)bits;
+  }
+
   for (; src_i < src_len; src_i++) {
     const uint8_t c = s[src_i];
     const uint8_t d = char_to_index[c];
@@ -204,6 +243,7 @@ char *base64_decode(const char *src, size_t src_len)
   }
 
   dest[out_len] = '\0';
+  *out_lenp = out_len;
 
   return dest;
 
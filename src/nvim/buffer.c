@@ -63,6 +63,7 @@
 #include "nvim/help.h"
 #include "nvim/indent.h"
 #include "nvim/indent_c.h"
+#include "nvim/insexpand.h"
 #include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/mapping.h"
@@ -115,6 +116,11 @@ static int buf_free_count = 0;
 
 static int top_file_num = 1;            ///< highest file number
 
+/// Buffer handles by full file name, to quickly find a buffer by its exact
+/// name in buflist_findname_file_id(). Entries may be stale, a found buffer
+/// is checked to still have the name.
+static Map(cstr_t, int) buffer_names = MAP_INIT;
+
 typedef enum {
   kBffClearWinInfo = 1,
   kBffInitChangedtick = 2,
@@ -690,6 +696,7 @@ bool close_buffer(win_T *win, buf_T *buf, int action, bool abort_if_last, bool i
     if (buf->b_nwindows > 0) {
       return false;
     }
+    buf_names_remove(buf);
     if (buf->b_sfname != buf->b_ffname) {
       XFREE_CLEAR(buf->b_sfname);
     } else {
@@ -750,6 +757,7 @@ void buf_clear(void)
   extmark_free_all(curbuf);   // delete any extmarks
   map_destroy(int, curbuf->b_signcols.invalid);
   *curbuf->b_signcols.invalid = (Map(int, SignRange)) MAP_INIT;
+  curbuf->b_signcols.rescan = false;
   while (!(curbuf->b_ml.ml_flags & ML_EMPTY)) {
     ml_delete(1, false);
   }
@@ -840,6 +848,7 @@ void buf_freeall(buf_T *buf, int flags)
     u_clearall(buf);                // reset all undo information
   }
   syntax_clear(&buf->b_s);          // reset syntax info
+  ins_compl_free_index(buf);        // free the keywords for ^N/^P
   buf->b_flags &= ~BF_READERR;      // a read error is no longer relevant
 }
 
@@ -857,6 +866,8 @@ static void free_buffer(buf_T *buf)
   }
   unref_var_dict(buf->b_vars);
   aubuflocal_remove(buf);
+  xfree(buf->b_au_fname);
+  xfree(buf->b_au_sfname);
   tv_dict_unref(buf->additional_data);
   xfree(buf->b_prompt_text);
   callback_free(&buf->b_prompt_callback);
@@ -904,6 +915,7 @@ static void free_buffer_stuff(buf_T *buf, int free_flags)
     clear_wininfo(buf);                 // including window-local options
     free_buf_options(buf, true);
     ga_clear(&buf->b_s.b_langp);
+    spell_cache_free(&buf->b_s);
   }
   {
     // Avoid losing b:changedtick when deleting buffer: clearing variables
@@ -922,9 +934,11 @@ static void free_buffer_stuff(buf_T *buf, int free_flags)
   extmark_free_all(buf);                 // delete any extmarks
   map_destroy(int, buf->b_signcols.invalid);
   *buf->b_signcols.invalid = (Map(int, SignRange)) MAP_INIT;
+  buf->b_signcols.rescan = false;
   map_clear_mode(buf, MAP_ALL_MODES, true, false);  // clear local mappings
   map_clear_mode(buf, MAP_ALL_MODES, true, true);   // clear local abbrevs
   XFREE_CLEAR(buf->b_start_fenc);
+  search_index_clear(buf);
 
   buf_updates_unload(buf, false);
 }
@@ -1622,36 +1636,7 @@ void enter_buffer(buf_T *buf)
     end_visual_mode();
   }
 
-  // Get the buffer in the current window.
-  curwin->w_buffer = buf;
-  curbuf = buf;
-  curbuf->b_nwindows++;
-
-  // Copy buffer and window local option values.  Not for a help buffer.
-  buf_copy_options(buf, BCO_ENTER | BCO_NOHELP);
-  if (!buf->b_help) {
-    get_winopts(buf);
-  } else {
-    // Remove all folds in the window.
-    clearFolding(curwin);
-  }
-  foldUpdateAll(curwin);        // update folds (later).
-
-  if (curwin->w_p_diff) {
-    diff_buf_add(curbuf);
-  }
-
-  curwin->w_s = &(curbuf->b_s);
-
-  // Cursor on first line by default.
-  curwin->w_cursor.lnum = 1;
-  curwin->w_cursor.col = 0;
-  curwin->w_cursor.coladd = 0;
-  curwin->w_set_curswant = true;
-  curwin->w_topline_was_set = false;
-
-  // mark cursor position as being invalid
-  curwin->w_valid = 0;
+  enter_buffer_win(buf);
 
   // Make sure the buffer is loaded.
   if (curbuf->b_ml.ml_mfp == NULL) {    // need to load the file
@@ -1705,6 +1690,106 @@ void enter_buffer(buf_T *buf)
   redraw_later(curwin, UPD_NOT_VALID);
 }
 
+/// Makes "buf" the buffer of the current window and sets up the window for it.
+static void enter_buffer_win(buf_T *buf)
+{
+  // Get the buffer in the current window.
+  curwin->w_buffer = buf;
+  curbuf = buf;
+  curbuf->b_nwindows++;
+
+  // Copy buffer and window local option values.  Not for a help buffer.
+  buf_copy_options(buf, BCO_ENTER | BCO_NOHELP);
+  if (!buf->b_help) {
+    get_winopts(buf);
+  } else {
+    // Remove all folds in the window.
+    clearFolding(curwin);
+  }
+  foldUpdateAll(curwin);        // update folds (later).
+
+  if (curwin->w_p_diff) {
+    diff_buf_add(curbuf);
+  }
+
+  curwin->w_s = &(curbuf->b_s);
+
+  // Cursor on first line by default.
+  curwin->w_cursor.lnum = 1;
+  curwin->w_cursor.col = 0;
+  curwin->w_cursor.coladd = 0;
+  curwin->w_set_curswant = true;
+  curwin->w_topline_was_set = false;
+
+  // mark cursor position as being invalid
+  curwin->w_valid = 0;
+}
+
+/// Makes "buf" the buffer of the current window without loading it, for a
+/// tab page made by "-p" when 'lazytabpages' is set.  The buffer is loaded by
+/// curbuf_load_deferred() when the window becomes the current window.
+///
+/// @return  false when the previous buffer of the window is not shown in
+///          another window, or autocommands changed the current buffer or
+///          deleted "buf".  The caller edits "buf" as usual then.
+bool enter_buffer_deferred(buf_T *buf)
+{
+  buf_T *old_curbuf = curbuf;
+  if (old_curbuf->b_nwindows <= 1) {
+    return false;  // would need BufWinLeave and unloading
+  }
+
+  // Like do_ecmd(): the previous buffer becomes the alternate file and gets
+  // BufLeave.
+  bufref_T newbufref;
+  set_bufref(&newbufref, buf);
+  if ((cmdmod.cmod_flags & CMOD_KEEPALT) == 0) {
+    curwin->w_alt_fnum = curbuf->b_fnum;
+  }
+  buflist_altfpos(curwin);
+  apply_autocmds(EVENT_BUFLEAVE, NULL, NULL, false, curbuf);
+  if (curbuf != old_curbuf || !bufref_valid(&newbufref) || buf->b_ml.ml_mfp != NULL) {
+    return false;
+  }
+
+  curbuf->b_nwindows--;
+  enter_buffer_win(buf);
+  buf->b_flags |= BF_DEFER_LOAD;
+  return true;
+}
+
+/// Loads the buffer of the current window when enter_buffer_deferred() did not
+/// load it.  Triggers the autocommands for reading the file and BufEnter.
+///
+/// @return  true when the buffer was loaded.
+bool curbuf_load_deferred(void)
+{
+  if (!(curbuf->b_flags & BF_DEFER_LOAD)) {
+    return false;
+  }
+  curbuf->b_flags &= ~BF_DEFER_LOAD;
+  if (curbuf->b_ml.ml_mfp != NULL) {
+    return false;  // loaded some other way
+  }
+  if (*curbuf->b_p_ft == NUL) {
+    did_filetype = false;
+  }
+  swap_exists_action = SEA_DIALOG;
+  open_buffer(false, NULL, 0);
+  handle_swap_exists(NULL);
+
+  if (curwin->w_cursor.lnum == 1 && inindent(0)) {
+    buflist_getfpos();
+  }
+  check_arg_idx(curwin);
+  maketitle();
+  if (curwin->w_topline == 1 && !curwin->w_topline_was_set) {
+    scroll_cursor_halfway(false, false);
+  }
+  redraw_later(curwin, UPD_NOT_VALID);
+  return true;
+}
+
 /// Change to the directory of the current buffer.
 /// Don't do this while still starting up.
 void do_autochdir(void)
@@ -1910,6 +1995,9 @@ buf_T *buflist_new(char *ffname_arg, char *sfname_arg, linenr_T lnum, int flags)
   }
   buf->b_u_synced = true;
   buf->b_flags = BF_CHECK_RO | BF_NEVERLOADED;
+  if (!(flags & BLN_DUMMY)) {
+    buf_names_add(buf);
+  }
   if (flags & BLN_DUMMY) {
     buf->b_flags |= BF_DUMMY;
   }
@@ -1919,6 +2007,9 @@ buf_T *buflist_new(char *ffname_arg, char *sfname_arg, linenr_T lnum, int flags)
   buf->b_p_bl = (flags & BLN_LISTED) ? true : false;    // init 'buflisted'
   kv_destroy(buf->update_channels);
   kv_init(buf->update_channels);
+  kv_destroy(buf->update_channels_coalesce);
+  kv_init(buf->update_channels_coalesce);
+  buf->update_pending.active = false;
   kv_destroy(buf->update_callbacks);
   kv_init(buf->update_callbacks);
   if (!(flags & BLN_DUMMY)) {
@@ -2179,6 +2270,15 @@ buf_T *buflist_findname(char *ffname)
 static buf_T *buflist_findname_file_id(char *ffname, FileID *file_id, bool file_id_valid)
   FUNC_ATTR_PURE
 {
+  // A buffer with exactly this name is the match.
+  if (ffname != NULL) {
+    buf_T *buf = handle_get_buffer(map_get(cstr_t, int)(&buffer_names, ffname));
+    if (buf != NULL && (buf->b_flags & BF_DUMMY) == 0
+        && buf->b_ffname != NULL && strcmp(buf->b_ffname, ffname) == 0) {
+      return buf;
+    }
+  }
+
   // Start at the last buffer, expect to find a match sooner.
   FOR_ALL_BUFFERS_BACKWARDS(buf) {
     if ((buf->b_flags & BF_DUMMY) == 0
@@ -2891,6 +2991,7 @@ int setfname(buf_T *buf, char *ffname_arg, char *sfname_arg, bool message)
   FileID file_id;
   bool file_id_valid = false;
 
+  buf_names_remove(buf);
   if (ffname == NULL || *ffname == NUL) {
     // Removing the name.
     if (buf->b_sfname != buf->b_ffname) {
@@ -2933,6 +3034,9 @@ int setfname(buf_T *buf, char *ffname_arg, char *sfname_arg, bool message)
     xfree(buf->b_ffname);
     buf->b_ffname = ffname;
     buf->b_sfname = sfname;
+    if (!(buf->b_flags & BF_DUMMY)) {
+      buf_names_add(buf);
+    }
   }
   buf->b_fname = buf->b_sfname;
   if (!file_id_valid) {
@@ -2955,6 +3059,7 @@ void buf_set_name(int fnum, char *name)
     return;
   }
 
+  buf_names_remove(buf);
   if (buf->b_sfname != buf->b_ffname) {
     xfree(buf->b_sfname);
   }
@@ -2965,8 +3070,47 @@ void buf_set_name(int fnum, char *name)
   // files on Win32.
   fname_expand(buf, &buf->b_ffname, &buf->b_sfname);
   buf->b_fname = buf->b_sfname;
+  buf_names_add(buf);
+}
+
+/// Remember "buf" under its full file name for buflist_findname_file_id().
+void buf_names_add(buf_T *buf)
+{
+  if (buf->b_ffname == NULL) {
+    return;
+  }
+  const char **key_alloc = NULL;
+  bool new_item = false;
+  int *ref = map_put_ref(cstr_t, int)(&buffer_names, buf->b_ffname, &key_alloc, &new_item);
+  if (new_item) {
+    *key_alloc = xstrdup(buf->b_ffname);
+  }
+  *ref = buf->handle;
 }
 
+/// Forget "buf" under its full file name. Call before the name is changed.
+void buf_names_remove(buf_T *buf)
+{
+  if (buf->b_ffname == NULL
+      || map_get(cstr_t, int)(&buffer_names, buf->b_ffname) != buf->handle) {
+    return;
+  }
+  cstr_t key;
+  map_del(cstr_t, int)(&buffer_names, buf->b_ffname, &key);
+  xfree((void *)key);
+}
+
+#ifdef EXITFREE
+void free_buffer_names(void)
+{
+  cstr_t key;
+  map_foreach_key(&buffer_names, key, {
+    xfree((void *)key);
+  });
+  map_destroy(cstr_t, &buffer_names);
+}
+#endif
+
 /// Take care of what needs to be done when the name of buffer "buf" has changed.
 void buf_name_changed(buf_T *buf)
 {
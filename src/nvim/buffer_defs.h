@@ -79,6 +79,8 @@ typedef struct {
 #define BF_READERR      0x40    // got errors while reading the file
 #define BF_DUMMY        0x80    // dummy buffer, only used internally
 #define BF_SYN_SET      0x200   // 'syntax' option was set
+#define BF_DEFER_LOAD   0x400   // shown in a window but not loaded until
+                                // its tab page is entered ('lazytabpages')
 
 // Mask to check for flags that prevent normal writing
 #define BF_WRITE_MASK   (BF_NOTEDITED + BF_NEW + BF_READERR)
@@ -269,6 +271,23 @@ typedef struct {
   int match;                    // nr of times matched
 } syn_time_T;
 
+// Result of one spell_check() call, kept in the spell cache.
+typedef struct {
+  colnr_T sw_col;               // column in the line of the checked text
+  int sw_capcol;                // "capcol" passed to spell_check()
+  int sw_capcol_out;            // "capcol" set by spell_check()
+  int sw_len;                   // length returned by spell_check()
+  hlf_T sw_hlf;                 // highlight of the word, HLF_COUNT if good
+} spellword_T;
+
+// spell_check() results for the text of one line, see spell_check_cached().
+typedef struct {
+  uint64_t sl_hash;             // hash of the line and the start of the next
+  int sl_gen;                   // spell_cache_gen when the results were made
+  size_t sl_next;               // index in sl_words to look at first
+  kvec_t(spellword_T) sl_words;
+} spellline_T;
+
 // These are items normally related to a buffer.  But when using ":ownsyntax"
 // a window may have its own instance.
 typedef struct {
@@ -310,16 +329,20 @@ typedef struct {
   // b_sst_freecount    number of free entries in b_sst_array[]
   // b_sst_check_lnum   entries after this lnum need to be checked for
   //                    validity (MAXLNUM means no check needed)
+  // b_sst_prefill_lnum lines before this were parsed in the background, see
+  //                    syntax_prefill()
   synstate_T *b_sst_array;
   int b_sst_len;
   synstate_T *b_sst_first;
   synstate_T *b_sst_firstfree;
   int b_sst_freecount;
   linenr_T b_sst_check_lnum;
+  linenr_T b_sst_prefill_lnum;
   disptick_T b_sst_lasttick;    // last display tick
 
   // for spell checking
   garray_T b_langp;           // list of pointers to slang_T, see spell.c
+  spellline_T *b_spell_cache; // spell_check() results by line text or NULL
   bool b_spell_ismw[256];     // flags: is midword char
   char *b_spell_ismw_mb;      // multi-byte midword chars
   char *b_p_spc;              // 'spellcapcheck'
@@ -349,6 +372,20 @@ typedef struct {
   bool utf_sizes;
   bool preview;
 } BufUpdateCallbacks;
+/// Channels attached to a buffer with nvim_buf_attach().
+typedef kvec_t(uint64_t) ChannelIds;
+
+/// Lines changed since the last nvim_buf_lines_event sent to the channels that
+/// attached with "coalesce".  Zero-indexed, end exclusive: lines "top" to
+/// "old_end" of the text before the first change were replaced by lines "top"
+/// to "new_end" of the current text.
+typedef struct {
+  bool active;
+  linenr_T top;
+  linenr_T old_end;
+  linenr_T new_end;
+} BufUpdatePending;
+
 #define BUF_UPDATE_CALLBACKS_INIT { LUA_NOREF, LUA_NOREF, LUA_NOREF, \
                                     LUA_NOREF, LUA_NOREF, false, false }
 
@@ -358,6 +395,12 @@ typedef struct {
 // Maximum number of maphash blocks we will have
 #define MAX_MAPHASH 256
 
+// A match of the search pattern in a buffer, see search_index_get().
+typedef struct {
+  lpos_T start;
+  lpos_T end;
+} search_index_match_T;
+
 // buffer: structure that holds information about one file
 //
 // Several windows can share a single Buffer
@@ -412,6 +455,15 @@ struct file_buffer {
   varnumber_T b_last_changedtick_i;     // b:changedtick for TextChangedI
   varnumber_T b_last_changedtick_pum;   // b:changedtick for TextChangedP
 
+  // Cache for has_event_buf(), valid while "b_au_gen" is the autocommand
+  // generation and "b_au_fname" and "b_au_sfname" the buffer names.
+  uint64_t b_au_gen;
+  char *b_au_fname;
+  char *b_au_sfname;
+  bool b_au_fic;                // 'fileignorecase' when computed
+  int b_au_known;               // bits of events that were checked
+  int b_au_has;                 // bits of events with matching autocommands
+
   bool b_saving;                // Set to true if we are in the middle of
                                 // saving the buffer.
 
@@ -484,6 +536,12 @@ struct file_buffer {
   int b_u_seq_cur;             // uh_seq of header below which we are now
   time_t b_u_time_cur;         // uh_time of header below which we are now
   int b_u_save_nr_cur;         // file write nr after which we are now
+  size_t b_u_mem;              // undo text not compressed, in bytes, estimate
+  size_t b_u_mem_limit;        // u_check_mem() compresses above this
+  bool b_u_hash_valid;         // b_u_hash is the hash of the text when
+                               // b:changedtick was b_u_hash_tick
+  varnumber_T b_u_hash_tick;
+  uint8_t b_u_hash[UNDO_HASH_SIZE];  // cached result of u_compute_hash()
 
   // variables for "U" command in undo.c
   char *b_u_line_ptr;           // saved line for "U" command
@@ -491,6 +549,7 @@ struct file_buffer {
   colnr_T b_u_line_colnr;       // optional column number
 
   bool b_scanned;               // ^N/^P have scanned this buffer
+  struct compl_index *b_compl_index;  // keywords for ^N/^P, see insexpand.c
 
   // flags for use of ":lmap" and IM control
   OptInt b_p_iminsert;          // input mode for insert
@@ -697,10 +756,23 @@ struct file_buffer {
                                 // normally points to this, but some windows
                                 // may use a different synblock_T.
 
+  // Matches of the last used search pattern, for the search count.
+  struct {
+    char *pat;                  // pattern of the matches, NULL when not valid
+    int flags;                  // options used with "pat", see search_index_flags()
+    bool incremental;           // can be updated for changed lines
+    linenr_T line_count;        // number of lines when the matches are valid
+    varnumber_T changedtick;    // b:changedtick when the matches are valid
+    linenr_T dirty_top;         // first line to search again, 0 for none
+    linenr_T dirty_bot;         // last line to search again
+    kvec_t(search_index_match_T) matches;
+  } b_search_index;
+
   struct {
     int max;                         // maximum number of signs on a single line
     int max_count;                   // number of lines with max number of signs
     bool resized;                    // whether max changed at start of redraw
+    bool rescan;                     // whether all lines must be counted again
     Map(int, SignRange) invalid[1];  // map of invalid ranges to be checked
   } b_signcols;
 
@@ -719,7 +791,11 @@ struct file_buffer {
 
   // array of channel_id:s which have asked to receive updates for this
   // buffer.
-  kvec_t(uint64_t) update_channels;
+  ChannelIds update_channels;
+  // array of channel_id:s which want adjacent changes merged into one event,
+  // with the changes that were not sent to them yet.
+  ChannelIds update_channels_coalesce;
+  BufUpdatePending update_pending;
   // array of lua callbacks for buffer updates.
   kvec_t(BufUpdateCallbacks) update_callbacks;
 
@@ -765,6 +841,17 @@ struct diffblock_S {
                         // smaller diff hunks?
 };
 
+// What the list of diff blocks of a tab page was made from, and which lines
+// changed since then.  Used to only diff the changed lines on the next update.
+typedef struct {
+  buf_T *ds_buf[DB_COUNT];        // the diff buffers, NULL to diff all again
+  varnumber_T ds_tick[DB_COUNT];  // b:changedtick of the buffers
+  linenr_T ds_top[DB_COUNT];      // first changed line, zero if none
+  linenr_T ds_bot[DB_COUNT];      // last changed line
+  int ds_flags;                   // flags from 'diffopt'
+  int ds_algorithm;               // xdiff algorithm from 'diffopt'
+} diffsnap_T;
+
 #define SNAP_HELP_IDX   0
 #define SNAP_AUCMD_IDX 1
 #define SNAP_COUNT     2
@@ -791,6 +878,7 @@ struct tabpage_S {
   buf_T *(tp_diffbuf[DB_COUNT]);
   int tp_diff_invalid;              ///< list of diffs is outdated
   int tp_diff_update;               ///< update diffs before redrawing
+  diffsnap_T tp_diff_snap;          ///< state of the last diff update
   frame_T *(tp_snapshot[SNAP_COUNT]);    ///< window layout snapshots
   ScopeDictDictItem tp_winvar;      ///< Variable for "t:" Dictionary.
   dict_T *tp_vars;         ///< Internal variables, local to tab page.
@@ -1008,6 +1096,47 @@ typedef struct {
   int lastline;
 } fcs_chars_T;
 
+/// Virtual column at a byte offset of a line, see getvcol().
+typedef struct {
+  colnr_T col;
+  colnr_T vcol;
+} VcolCheckpoint;
+
+/// Checkpoints of one long line of a window, valid while the keys match.
+typedef struct {
+  uint64_t generation;   ///< vcol_cache_generation when filled
+  handle_T buf;
+  linenr_T lnum;
+  int64_t changedtick;
+  bool wrap;
+  int width1;            ///< width of the first screen line of the text
+  int width2;            ///< width of further screen lines
+  kvec_t(VcolCheckpoint) points;
+} VcolCache;
+
+/// Number of line heights a window remembers, see plines_win_nofold().
+#define LINE_HEIGHT_CACHE_SIZE 256
+
+/// Screen heights of recently measured lines of a window, valid while the keys
+/// match. A line is stored at its number modulo LINE_HEIGHT_CACHE_SIZE.
+typedef struct {
+  uint64_t generation;   ///< vcol_cache_generation when filled
+  handle_T buf;
+  int64_t changedtick;
+  int width1;            ///< width of the first screen line of the text
+  int width2;            ///< width of further screen lines
+  linenr_T lnum[LINE_HEIGHT_CACHE_SIZE];  ///< zero for an unused entry
+  int height[LINE_HEIGHT_CACHE_SIZE];
+} LineHeightCache;
+
+/// Attrs of highlight groups in the namespace a window is drawn with, valid
+/// while the keys match. See win_hl_id2attr().
+typedef struct {
+  int ns_id;             ///< namespace the attrs are for
+  uint64_t generation;   ///< ns_hl_generation when filled
+  kvec_t(int) attrs;     ///< attr + 1 for each hl_id, 0 when not looked up yet
+} WinHlCache;
+
 /// Structure which contains all information that belongs to a window.
 ///
 /// All row numbers are relative to the start of the window, except w_winrow.
@@ -1023,6 +1152,7 @@ struct window_S {
   int w_ns_hl_winhl;
   int w_ns_hl_active;
   int *w_ns_hl_attr;
+  WinHlCache w_hl_cache;            ///< syn_id2attr() results for drawing
 
   int w_hl_id_normal;               ///< 'winhighlight' normal id
   int w_hl_attr_normal;             ///< 'winhighlight' normal final attrs
@@ -1205,6 +1335,11 @@ struct window_S {
   bool w_redr_border;               // if true border must be redrawn
   bool w_redr_statuscol;            // if true 'statuscolumn' must be redrawn
 
+  // redraw stats of the window, see nvim__redraw_stats()
+  int64_t w_redraw_count;           // number of times win_update() ran
+  int64_t w_redraw_lines;           // number of lines drawn by win_line()
+  uint64_t w_redraw_time;           // time spent in win_update() in nanoseconds
+
   // remember what is shown in the 'statusline'-format elements
   pos_T w_stl_cursor;                // cursor position when last redrawn
   colnr_T w_stl_virtcol;             // virtcol when last redrawn
@@ -1296,6 +1431,9 @@ struct window_S {
   linenr_T w_statuscol_line_count;      // line count when 'statuscolumn' width was computed.
   int w_nrwidth_width;                  // nr of chars to print line count.
 
+  VcolCache w_vcol_cache;               // checkpoints for getvcol() on a long line
+  LineHeightCache w_height_cache;       // heights for plines_win_nofold()
+
   qf_info_T *w_llist;                 // Location list for this window
   // Location list reference used in the location list window.
   // In a non-location list window, w_llist_ref is NULL.
@@ -2,6 +2,7 @@
 #include <lauxlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "klib/kvec.h"
 #include "nvim/api/buffer.h"
@@ -11,9 +12,12 @@
 #include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/buffer_updates.h"
+#include "nvim/event/multiqueue.h"
 #include "nvim/globals.h"
 #include "nvim/log.h"
 #include "nvim/lua/executor.h"
+#include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/msgpack_rpc/channel.h"
@@ -27,7 +31,12 @@
 // Register a channel. Return True if the channel was added, or already added.
 // Return False if the channel couldn't be added because the buffer is
 // unloaded.
-bool buf_updates_register(buf_T *buf, uint64_t channel_id, BufUpdateCallbacks cb, bool send_buffer)
+//
+// A channel can ask for changes to be coalesced: then adjacent and overlapping
+// changes are merged in "buf->update_pending" and sent as one event when the
+// main loop processes events, or before any other event for the buffer.
+bool buf_updates_register(buf_T *buf, uint64_t channel_id, BufUpdateCallbacks cb, bool send_buffer,
+                          bool coalesce)
 {
   // must fail if the buffer isn't loaded
   if (buf->b_ml.ml_mfp == NULL) {
@@ -50,9 +59,20 @@ bool buf_updates_register(buf_T *buf, uint64_t channel_id, BufUpdateCallbacks cb
       return true;
     }
   }
+  for (size_t i = 0; i < kv_size(buf->update_channels_coalesce); i++) {
+    if (kv_A(buf->update_channels_coalesce, i) == channel_id) {
+      return true;
+    }
+  }
 
   // append the channelid to the list
-  kv_push(buf->update_channels, channel_id);
+  if (coalesce) {
+    // changes made before attaching must not be included
+    buf_updates_flush(buf);
+    kv_push(buf->update_channels_coalesce, channel_id);
+  } else {
+    kv_push(buf->update_channels, channel_id);
+  }
 
   if (send_buffer) {
     Array args = ARRAY_DICT_INIT;
@@ -95,7 +115,8 @@ bool buf_updates_register(buf_T *buf, uint64_t channel_id, BufUpdateCallbacks cb
 bool buf_updates_active(buf_T *buf)
   FUNC_ATTR_PURE
 {
-  return kv_size(buf->update_channels) || kv_size(buf->update_callbacks);
+  return kv_size(buf->update_channels) || kv_size(buf->update_channels_coalesce)
+         || kv_size(buf->update_callbacks);
 }
 
 void buf_updates_send_end(buf_T *buf, uint64_t channelid)
@@ -105,11 +126,14 @@ void buf_updates_send_end(buf_T *buf, uint64_t channelid)
   rpc_send_event(channelid, "nvim_buf_detach_event", args);
 }
 
-void buf_updates_unregister(buf_T *buf, uint64_t channelid)
+/// Removes "channelid" from "channels".
+///
+/// @return  whether it was found
+static bool remove_channel(ChannelIds *channels, uint64_t channelid)
 {
-  size_t size = kv_size(buf->update_channels);
+  size_t size = kv_size(*channels);
   if (!size) {
-    return;
+    return false;
   }
 
   // go through list backwards and remove the channel id each time it appears
@@ -117,12 +141,12 @@ void buf_updates_unregister(buf_T *buf, uint64_t channelid)
   size_t j = 0;
   size_t found = 0;
   for (size_t i = 0; i < size; i++) {
-    if (kv_A(buf->update_channels, i) == channelid) {
+    if (kv_A(*channels, i) == channelid) {
       found++;
     } else {
       // copy item backwards into prior slot if needed
       if (i != j) {
-        kv_A(buf->update_channels, j) = kv_A(buf->update_channels, i);
+        kv_A(*channels, j) = kv_A(*channels, i);
       }
       j++;
     }
@@ -130,14 +154,24 @@ void buf_updates_unregister(buf_T *buf, uint64_t channelid)
 
   if (found) {
     // remove X items from the end of the array
-    buf->update_channels.size -= found;
-
-    // make a new copy of the active array without the channelid in it
-    buf_updates_send_end(buf, channelid);
+    channels->size -= found;
 
     if (found == size) {
-      kv_destroy(buf->update_channels);
-      kv_init(buf->update_channels);
+      kv_destroy(*channels);
+      kv_init(*channels);
+    }
+  }
+  return found > 0;
+}
+
+void buf_updates_unregister(buf_T *buf, uint64_t channelid)
+{
+  if (remove_channel(&buf->update_channels, channelid)) {
+    buf_updates_send_end(buf, channelid);
+  } else if (kv_size(buf->update_channels_coalesce)) {
+    buf_updates_flush(buf);
+    if (remove_channel(&buf->update_channels_coalesce, channelid)) {
+      buf_updates_send_end(buf, channelid);
     }
   }
 }
@@ -145,6 +179,7 @@ void buf_updates_unregister(buf_T *buf, uint64_t channelid)
 void buf_free_callbacks(buf_T *buf)
 {
   kv_destroy(buf->update_channels);
+  kv_destroy(buf->update_channels_coalesce);
   for (size_t i = 0; i < kv_size(buf->update_callbacks); i++) {
     buffer_update_callbacks_free(kv_A(buf->update_callbacks, i));
   }
@@ -161,6 +196,15 @@ void buf_updates_unload(buf_T *buf, bool can_reload)
     kv_destroy(buf->update_channels);
     kv_init(buf->update_channels);
   }
+  size = kv_size(buf->update_channels_coalesce);
+  if (size) {
+    buf_updates_flush(buf);
+    for (size_t i = 0; i < size; i++) {
+      buf_updates_send_end(buf, kv_A(buf->update_channels_coalesce, i));
+    }
+    kv_destroy(buf->update_channels_coalesce);
+    kv_init(buf->update_channels_coalesce);
+  }
 
   size_t j = 0;
   for (size_t i = 0; i < kv_size(buf->update_callbacks); i++) {
@@ -202,6 +246,102 @@ void buf_updates_unload(buf_T *buf, bool can_reload)
   }
 }
 
+/// Sends an nvim_buf_lines_event: lines "first" to "last" (zero-indexed, end
+/// exclusive) were replaced by "num_added" lines starting at "first".
+///
+/// @return  false if the channel is dead
+static bool send_lines_event(buf_T *buf, uint64_t channelid, bool send_tick, int64_t first,
+                             int64_t last, int64_t num_added)
+{
+  Array args = ARRAY_DICT_INIT;
+  args.size = 6;
+  args.items = xcalloc(args.size, sizeof(Object));
+
+  // the first argument is always the buffer handle
+  args.items[0] = BUFFER_OBJ(buf->handle);
+
+  // next argument is b:changedtick
+  args.items[1] = send_tick ? INTEGER_OBJ(buf_get_changedtick(buf)) : NIL;
+
+  // the first line that changed (zero-indexed)
+  args.items[2] = INTEGER_OBJ(first);
+
+  // the last line that was changed
+  args.items[3] = INTEGER_OBJ(last);
+
+  // linedata of lines being swapped in
+  Array linedata = ARRAY_DICT_INIT;
+  if (num_added > 0) {
+    STATIC_ASSERT(SIZE_MAX >= MAXLNUM, "size_t smaller than MAXLNUM");
+    linedata.size = (size_t)num_added;
+    linedata.items = xcalloc((size_t)num_added, sizeof(Object));
+    buf_collect_lines(buf, (size_t)num_added, (linenr_T)first + 1, 0, true, &linedata,
+                      NULL, NULL);
+  }
+  args.items[4] = ARRAY_OBJ(linedata);
+  args.items[5] = BOOLEAN_OBJ(false);
+  bool ok = rpc_send_event(channelid, "nvim_buf_lines_event", args);
+  api_free_array(args);  // TODO(bfredl): no
+  return ok;
+}
+
+/// Adds a change to the pending changes for coalescing channels: "num_removed"
+/// lines at "top" (zero-indexed) were replaced by "num_added" lines.
+static void buf_updates_pending_add(buf_T *buf, linenr_T top, linenr_T num_removed,
+                                    linenr_T num_added)
+{
+  BufUpdatePending *p = &buf->update_pending;
+  if (p->active && (top > p->new_end || top + num_removed < p->top)) {
+    // Not adjacent to the pending changes, send those first.
+    buf_updates_flush(buf);
+  }
+
+  if (!p->active) {
+    *p = (BufUpdatePending){ .active = true, .top = top, .old_end = top + num_removed,
+                             .new_end = top + num_added };
+    multiqueue_put(main_loop.events, buf_updates_flush_event, (void *)(intptr_t)buf->handle);
+    return;
+  }
+
+  // Lines outside of the pending range are the same in the old text.
+  p->top = MIN(p->top, top);
+  if (top + num_removed > p->new_end) {
+    p->old_end += top + num_removed - p->new_end;
+    p->new_end = top + num_removed;
+  }
+  p->new_end += num_added - num_removed;
+}
+
+static void buf_updates_flush_event(void **argv)
+{
+  buf_T *buf = handle_get_buffer((handle_T)(intptr_t)argv[0]);
+  if (buf != NULL) {
+    buf_updates_flush(buf);
+  }
+}
+
+/// Sends the pending changes to the channels that attached with "coalesce".
+void buf_updates_flush(buf_T *buf)
+{
+  BufUpdatePending *p = &buf->update_pending;
+  if (!p->active) {
+    return;
+  }
+  p->active = false;
+
+  uint64_t badchannelid = 0;
+  for (size_t i = 0; i < kv_size(buf->update_channels_coalesce); i++) {
+    uint64_t channelid = kv_A(buf->update_channels_coalesce, i);
+    if (!send_lines_event(buf, channelid, true, p->top, p->old_end, p->new_end - p->top)) {
+      badchannelid = channelid;
+    }
+  }
+  if (badchannelid != 0) {
+    ELOG("Disabling buffer updates for dead channel %" PRIu64, badchannelid);
+    remove_channel(&buf->update_channels_coalesce, badchannelid);
+  }
+}
+
 void buf_updates_send_changes(buf_T *buf, linenr_T firstline, int64_t num_added,
                               int64_t num_removed)
 {
@@ -222,42 +362,17 @@ void buf_updates_send_changes(buf_T *buf, linenr_T firstline, int64_t num_added,
   // notify each of the active channels
   for (size_t i = 0; i < kv_size(buf->update_channels); i++) {
     uint64_t channelid = kv_A(buf->update_channels, i);
-
-    // send through the changes now channel contents now
-    Array args = ARRAY_DICT_INIT;
-    args.size = 6;
-    args.items = xcalloc(args.size, sizeof(Object));
-
-    // the first argument is always the buffer handle
-    args.items[0] = BUFFER_OBJ(buf->handle);
-
-    // next argument is b:changedtick
-    args.items[1] = send_tick ? INTEGER_OBJ(buf_get_changedtick(buf)) : NIL;
-
-    // the first line that changed (zero-indexed)
-    args.items[2] = INTEGER_OBJ(firstline - 1);
-
-    // the last line that was changed
-    args.items[3] = INTEGER_OBJ(firstline - 1 + num_removed);
-
-    // linedata of lines being swapped in
-    Array linedata = ARRAY_DICT_INIT;
-    if (num_added > 0) {
-      STATIC_ASSERT(SIZE_MAX >= MAXLNUM, "size_t smaller than MAXLNUM");
-      linedata.size = (size_t)num_added;
-      linedata.items = xcalloc((size_t)num_added, sizeof(Object));
-      buf_collect_lines(buf, (size_t)num_added, firstline, 0, true, &linedata,
-                        NULL, NULL);
-    }
-    args.items[4] = ARRAY_OBJ(linedata);
-    args.items[5] = BOOLEAN_OBJ(false);
-    if (!rpc_send_event(channelid, "nvim_buf_lines_event", args)) {
+    if (!send_lines_event(buf, channelid, send_tick, firstline - 1, firstline - 1 + num_removed,
+                          num_added)) {
       // We can't unregister the channel while we're iterating over the
       // update_channels array, so we remember its ID to unregister it at
       // the end.
       badchannelid = channelid;
     }
-    api_free_array(args);  // TODO(bfredl): no
+  }
+
+  if (kv_size(buf->update_channels_coalesce)) {
+    buf_updates_pending_add(buf, firstline - 1, (linenr_T)num_removed, (linenr_T)num_added);
   }
 
   // We can only ever remove one dead channel at a time. This is OK because the
@@ -368,6 +483,7 @@ void buf_updates_send_splice(buf_T *buf, int start_row, colnr_T start_col, bcoun
   }
   kv_size(buf->update_callbacks) = j;
 }
+
 void buf_updates_changedtick(buf_T *buf)
 {
   // notify each of the active channels
@@ -375,6 +491,10 @@ void buf_updates_changedtick(buf_T *buf)
     uint64_t channel_id = kv_A(buf->update_channels, i);
     buf_updates_changedtick_single(buf, channel_id);
   }
+  buf_updates_flush(buf);
+  for (size_t i = 0; i < kv_size(buf->update_channels_coalesce); i++) {
+    buf_updates_changedtick_single(buf, kv_A(buf->update_channels_coalesce, i));
+  }
   size_t j = 0;
   for (size_t i = 0; i < kv_size(buf->update_callbacks); i++) {
     BufUpdateCallbacks cb = kv_A(buf->update_callbacks, i);
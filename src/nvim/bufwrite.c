@@ -45,6 +45,10 @@
 #include "nvim/undo.h"
 #include "nvim/vim_defs.h"
 
+#ifdef HAVE_SYS_UIO_H
+# include <sys/uio.h>
+#endif
+
 static const char *err_readonly = "is read-only (cannot override: \"W\" in 'cpoptions')";
 static const char e_patchmode_cant_touch_empty_original_file[]
   = N_("E206: Patchmode: can't touch empty original file");
@@ -67,6 +71,9 @@ typedef struct {
 
 #define SMALLBUFSIZE 256     // size of emergency write buffer
 
+#define BW_IOV_LINES 256     // lines fetched at once by buf_write_lines_iov()
+#define BW_IOV_MAX   1024    // iovecs passed at once to os_writev()
+
 // Structure to pass arguments from buf_write() to buf_write_bytes().
 struct bw_info {
   int bw_fd;                      // file descriptor
@@ -84,6 +91,16 @@ struct bw_info {
   iconv_t bw_iconv_fd;            // descriptor for iconv() or -1
 };
 
+#ifdef HAVE_WRITEV
+// Buffers collected by buf_write_lines_iov().
+typedef struct {
+  struct iovec iov[BW_IOV_MAX];
+  size_t count;  // number of used items in "iov"
+  size_t bytes;  // total length of the used items
+  int nchars;    // number of bytes written so far
+} bw_iov_T;
+#endif
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "bufwrite.c.generated.h"
 #endif
@@ -338,6 +355,112 @@ static int buf_write_bytes(struct bw_info *ip)
   return (wlen < len) ? FAIL : OK;
 }
 
+#ifdef HAVE_WRITEV
+/// Write the buffers collected in "bi" to "ip->bw_fd".
+///
+/// @return  false for a write error.
+static bool bw_iov_flush(struct bw_info *ip, bw_iov_T *bi)
+  FUNC_ATTR_NONNULL_ALL
+{
+  ptrdiff_t wlen = os_writev(ip->bw_fd, bi->iov, bi->count);
+  bool ok = wlen >= 0 && (size_t)wlen == bi->bytes;
+  if (ok) {
+    bi->nchars += (int)bi->bytes;
+  }
+  bi->count = 0;
+  bi->bytes = 0;
+  return ok;
+}
+
+/// Add "len" bytes at "ptr" to "bi", writing the collected buffers when it is
+/// full.
+///
+/// @return  false for a write error.
+static bool bw_iov_add(struct bw_info *ip, bw_iov_T *bi, char *ptr, size_t len)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (bi->count == BW_IOV_MAX && !bw_iov_flush(ip, bi)) {
+    return false;
+  }
+  bi->iov[bi->count].iov_base = ptr;
+  bi->iov[bi->count].iov_len = len;
+  bi->count++;
+  bi->bytes += len;
+  return true;
+}
+
+/// Write lines "start" to "*endp" of "buf" to "ip->bw_fd" without copying the
+/// text into a buffer: the lines are passed to os_writev() as they are in the
+/// memline blocks.  Only for 'fileformat' "unix" without conversion.
+///
+/// Sets "*endp" to zero for a write error or when interrupted, "*no_eolp"
+/// when the last line was written without an end-of-line and adds the number
+/// of bytes written to "*ncharsp".
+///
+/// @param sha_ctx  when not NULL the text is added to the hash for the undo file
+///
+/// @return  the line number after the last line written.
+static linenr_T buf_write_lines_iov(struct bw_info *ip, buf_T *buf, linenr_T start,
+                                    linenr_T *endp, bool write_bin, context_sha256_T *sha_ctx,
+                                    int *ncharsp, bool *no_eolp)
+  FUNC_ATTR_NONNULL_ARG(1, 2, 4, 7, 8)
+{
+  static char nl = NL;
+  static char nul = NUL;  // a NL in the text is a NUL in the file
+  char *lines[BW_IOV_LINES];
+  colnr_T lens[BW_IOV_LINES];
+  bw_iov_T *bi = xmalloc(sizeof(bw_iov_T));
+  bi->count = 0;
+  bi->bytes = 0;
+  bi->nchars = 0;
+  linenr_T end = *endp;
+  linenr_T lnum = start;
+  bool ok = true;
+
+  while (ok && lnum <= end) {
+    // The pointers are only valid until the next memline call, everything
+    // collected must be written before getting more lines.
+    int count = ml_get_buf_lines(buf, lnum, MIN(BW_IOV_LINES, end - lnum + 1), lines, lens);
+    for (int i = 0; ok && i < count; i++, lnum++) {
+      char *ptr = lines[i];
+      size_t len = (size_t)lens[i];
+      if (sha_ctx != NULL) {
+        sha256_update(sha_ctx, (uint8_t *)ptr, (uint32_t)len + 1);
+      }
+      char *p;
+      while (ok && (p = memchr(ptr, NL, len)) != NULL) {
+        ok = bw_iov_add(ip, bi, ptr, (size_t)(p - ptr)) && bw_iov_add(ip, bi, &nul, 1);
+        len -= (size_t)(p - ptr) + 1;
+        ptr = p + 1;
+      }
+      ok = ok && bw_iov_add(ip, bi, ptr, len);
+      // last line has no EOL: stop here
+      if (lnum == end
+          && (write_bin || !buf->b_p_fixeol)
+          && ((write_bin && lnum == buf->b_no_eol_lnum)
+              || (lnum == buf->b_ml.ml_line_count && !buf->b_p_eol))) {
+        *no_eolp = true;
+      } else {
+        ok = ok && bw_iov_add(ip, bi, &nl, 1);
+      }
+    }
+    ok = ok && bw_iov_flush(ip, bi);
+
+    os_breakcheck();
+    if (got_int) {
+      ok = false;  // Interrupted, break loop.
+    }
+  }
+
+  if (!ok) {
+    *endp = 0;
+  }
+  *ncharsp += bi->nchars;
+  xfree(bi);
+  return lnum;
+}
+#endif
+
 /// Check modification time of file, before writing to it.
 /// The size isn't checked, because using a tool like "gzip" takes care of
 /// using the same timestamp but can't set the size.
@@ -1522,7 +1645,15 @@ restore_backup:
     fileformat = get_fileformat_force(buf, eap);
     char *s = buffer;
     int len = 0;
-    for (lnum = start; lnum <= end; lnum++) {
+    lnum = start;
+#ifdef HAVE_WRITEV
+    if (!converted && fileformat == EOL_UNIX && write_info.bw_fd >= 0) {
+      // Fast path: write the text straight from the memline blocks.
+      lnum = buf_write_lines_iov(&write_info, buf, start, &end, write_bin,
+                                 write_undo_file ? &sha_ctx : NULL, &nchars, &no_eol);
+    }
+#endif
+    for (; lnum <= end; lnum++) {
       // The next while loop is done once for each character written.
       // Keep it fast!
       char *ptr = ml_get_buf(buf, lnum) - 1;
@@ -162,11 +162,14 @@ static void changed_common(buf_T *buf, linenr_T lnum, colnr_T col, linenr_T lnum
   // mark the buffer as modified
   changed(buf);
 
+  search_index_changed(buf, lnum, lnume, xtra);
+
   FOR_ALL_WINDOWS_IN_TAB(win, curtab) {
     if (win->w_buffer == buf && win->w_p_diff && diff_internal()) {
       curtab->tp_diff_update = true;
     }
   }
+  diff_lines_changed(buf, lnum, lnume, xtra);
 
   // set the '. mark
   if ((cmdmod.cmod_flags & CMOD_KEEPJUMPS) == 0) {
@@ -535,6 +538,7 @@ void changed_lines(buf_T *buf, linenr_T lnum, colnr_T col, linenr_T lnume, linen
                    bool do_buf_event)
 {
   buf_redraw_changed_lines_later(buf, lnum, lnume, xtra);
+  vcol_cache_invalidate_all();
 
   if (xtra == 0 && curwin->w_p_diff && curwin->w_buffer == buf && !diff_internal()) {
     // When the number of lines doesn't change then mark_adjust() isn't
@@ -579,7 +583,12 @@ void unchanged(buf_T *buf, int ff, bool always_inc_changedtick)
     redraw_buf_status_later(buf);
     redraw_tabline = true;
     need_maketitle = true;  // set window title later
+    // The text didn't change, a valid search index stays valid.
+    const bool index_valid = buf->b_search_index.changedtick == buf_get_changedtick(buf);
     buf_inc_changedtick(buf);
+    if (index_valid) {
+      buf->b_search_index.changedtick = buf_get_changedtick(buf);
+    }
   } else if (always_inc_changedtick) {
     buf_inc_changedtick(buf);
   }
@@ -19,6 +19,7 @@
 #include "nvim/event/rstream.h"
 #include "nvim/event/socket.h"
 #include "nvim/event/stream.h"
+#include "nvim/event/time.h"
 #include "nvim/event/wstream.h"
 #include "nvim/garray.h"
 #include "nvim/gettext.h"
@@ -26,6 +27,7 @@
 #include "nvim/log.h"
 #include "nvim/lua/executor.h"
 #include "nvim/main.h"
+#include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/msgpack_rpc/channel.h"
@@ -33,6 +35,7 @@
 #include "nvim/os/fs.h"
 #include "nvim/os/os_defs.h"
 #include "nvim/os/shell.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/rbuffer.h"
 #include "nvim/terminal.h"
@@ -46,11 +49,20 @@
 
 static bool did_stdio = false;
 
+/// Size of the chunks written by channel_send_buf().
+#define CHANNEL_SEND_CHUNK (64 * 1024)
+
 /// next free id for a job or rpc channel
 /// 1 is reserved for stdio channel
 /// 2 is reserved for stderr channel
 static uint64_t next_chan_id = CHAN_STDERR + 1;
 
+/// Idle jobs started with the "pool" option of jobstart(), waiting to be
+/// reused by a jobstart() with the same command.
+static kvec_t(Channel *) job_pool = KV_INITIAL_VALUE;
+static TimeWatcher job_pool_timer;
+static bool job_pool_timer_init = false;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "channel.c.generated.h"
 #endif
@@ -58,12 +70,38 @@ static uint64_t next_chan_id = CHAN_STDERR + 1;
 /// Teardown the module
 void channel_teardown(void)
 {
+  if (job_pool_timer_init) {
+    time_watcher_stop(&job_pool_timer);
+  }
+  kv_size(job_pool) = 0;
+
   Channel *chan;
   map_foreach_value(&channels, chan, {
     channel_close(chan->id, kChannelPartAll, NULL);
   });
 }
 
+/// @return bytes buffered by the streams of the open RPC channels: the read
+///         buffers and the writes still queued.
+size_t channel_rpc_buffer_bytes(void)
+{
+  size_t size = 0;
+  Channel *chan;
+  map_foreach_value(&channels, chan, {
+    if (!chan->is_rpc || chan->rpc.closed
+        || chan->streamtype == kChannelStreamInternal
+        || chan->streamtype == kChannelStreamStderr) {
+      continue;
+    }
+    Stream *out = channel_outstream(chan);
+    if (out->buffer) {
+      size += sizeof(RBuffer) + rbuffer_capacity(out->buffer);
+    }
+    size += channel_instream(chan)->curmem;
+  });
+  return size;
+}
+
 #ifdef EXITFREE
 void channel_free_all_mem(void)
 {
@@ -72,6 +110,7 @@ void channel_free_all_mem(void)
     channel_destroy(chan);
   });
   map_destroy(uint64_t, &channels);
+  kv_destroy(job_pool);
 
   callback_free(&on_print);
 }
@@ -290,6 +329,7 @@ static void channel_destroy(Channel *chan)
   callback_reader_free(&chan->on_data);
   callback_reader_free(&chan->on_stderr);
   callback_free(&chan->on_exit);
+  xfree(chan->pool_key);
 
   multiqueue_free(chan->events);
   xfree(chan);
@@ -323,6 +363,107 @@ static void close_cb(Stream *stream, void *data)
   channel_decref(data);
 }
 
+/// Puts a job started with the "pool" option of jobstart() into the pool,
+/// instead of stopping it.  Its stderr and exit callbacks are dropped, the
+/// jobstart() that reuses the job brings its own.
+///
+/// @return false if the job cannot be pooled, it should be stopped.
+bool channel_job_pool_put(Channel *chan)
+{
+  if (chan->pool_key == NULL || chan->pool_expire != 0
+      || process_is_stopped(&chan->stream.proc)
+      || !chan->is_rpc || chan->rpc.closed) {
+    return false;
+  }
+
+  callback_reader_free(&chan->on_stderr);
+  chan->on_stderr = CALLBACK_READER_INIT;
+  callback_free(&chan->on_exit);
+  chan->on_exit = CALLBACK_NONE;
+
+  chan->pool_expire = os_hrtime() + (uint64_t)chan->pool_timeout * 1000000;
+  kv_push(job_pool, chan);
+  job_pool_schedule();
+  return true;
+}
+
+/// Takes an idle job from the pool, that was started by a jobstart() with
+/// the same "key".
+///
+/// @return the job, or NULL if there is none.
+Channel *channel_job_pool_take(const char *key, CallbackReader on_stderr, Callback on_exit)
+{
+  for (size_t i = 0; i < kv_size(job_pool); i++) {
+    Channel *chan = kv_A(job_pool, i);
+    if (strcmp(chan->pool_key, key) != 0 || process_is_stopped(&chan->stream.proc)) {
+      continue;
+    }
+    job_pool_remove(chan);
+
+    chan->on_stderr = on_stderr;
+    if (callback_reader_set(on_stderr)) {
+      callback_reader_start(&chan->on_stderr, "stderr");
+    }
+    chan->on_exit = on_exit;
+    return chan;
+  }
+  return NULL;
+}
+
+static void job_pool_remove(Channel *chan)
+{
+  if (chan->pool_expire == 0) {
+    return;
+  }
+  chan->pool_expire = 0;
+  for (size_t i = 0; i < kv_size(job_pool); i++) {
+    if (kv_A(job_pool, i) == chan) {
+      kv_A(job_pool, i) = kv_last(job_pool);
+      kv_size(job_pool)--;
+      break;
+    }
+  }
+}
+
+/// Starts the timer for the idle job that expires first.
+static void job_pool_schedule(void)
+{
+  if (!job_pool_timer_init) {
+    time_watcher_init(&main_loop, &job_pool_timer, NULL);
+    // stopping jobs is not a fast event
+    job_pool_timer.events = main_loop.events;
+    job_pool_timer_init = true;
+  }
+  if (kv_size(job_pool) == 0) {
+    time_watcher_stop(&job_pool_timer);
+    return;
+  }
+  uint64_t expire = UINT64_MAX;
+  for (size_t i = 0; i < kv_size(job_pool); i++) {
+    expire = MIN(expire, kv_A(job_pool, i)->pool_expire);
+  }
+  uint64_t now = os_hrtime();
+  uint64_t timeout = expire > now ? (expire - now) / 1000000 + 1 : 0;
+  time_watcher_start(&job_pool_timer, job_pool_timer_cb, timeout, 0);
+}
+
+/// Stops the idle jobs whose time in the pool is up.
+static void job_pool_timer_cb(TimeWatcher *watcher, void *data)
+{
+  uint64_t now = os_hrtime();
+  for (size_t i = 0; i < kv_size(job_pool);) {
+    Channel *chan = kv_A(job_pool, i);
+    if (chan->pool_expire > now) {
+      i++;
+      continue;
+    }
+    job_pool_remove(chan);
+    channel_close(chan->id, kChannelPartRpc, NULL);
+    process_stop(&chan->stream.proc);
+  }
+  job_pool_schedule();
+}
+
 /// Starts a job and returns the associated channel
 ///
 /// @param[in]  argv  Arguments vector specifying the command to run,
@@ -359,6 +500,10 @@ Channel *channel_job_start(char **argv, const char *exepath, CallbackReader on_s
   chan->on_data = on_stdout;
   chan->on_stderr = on_stderr;
   chan->on_exit = on_exit;
+  // A job can flood the queue with output, don't let it delay other events.
+  if (!rpc) {
+    multiqueue_set_low_priority(chan->events, true);
+  }
 
   if (pty) {
     if (detach) {
@@ -619,6 +764,43 @@ retfree:
   return written;
 }
 
+/// Sends lines "first" to "last" of buffer "buf" to channel "id", each
+/// followed by a NL.  The lines are copied from the memline in chunks that
+/// are written as they are filled, instead of first building a list or one
+/// string of the whole range.
+///
+/// @return number of bytes written
+size_t channel_send_buf(uint64_t id, buf_T *buf, linenr_T first, linenr_T last,
+                        const char **error)
+  FUNC_ATTR_NONNULL_ALL
+{
+  size_t written = 0;
+  linenr_T lnum = first;
+  while (lnum <= last) {
+    garray_T ga;
+    ga_init(&ga, 1, CHANNEL_SEND_CHUNK);
+    while (lnum <= last && ga.ga_len < CHANNEL_SEND_CHUNK) {
+      char *line = ml_get_buf(buf, lnum);
+      size_t len = strlen(line);
+      ga_grow(&ga, (int)len + 1);
+      char *p = (char *)ga.ga_data + ga.ga_len;
+      memcpy(p, line, len);
+      // A NUL in the text is stored as NL.
+      memchrsub(p, NL, NUL, len);
+      p[len] = NL;
+      ga.ga_len += (int)len + 1;
+      lnum++;
+    }
+    size_t len = (size_t)ga.ga_len;
+    size_t n = channel_send(id, ga.ga_data, len, true, error);
+    written += n;
+    if (n < len || *error != NULL) {
+      break;
+    }
+  }
+  return written;
+}
+
 /// Convert binary byte array to a readfile()-style list
 ///
 /// @param[in]  buf  Array to convert.
@@ -662,13 +844,22 @@ static void on_channel_output(Stream *stream, Channel *chan, RBuffer *buf, size_
     reader->eof = true;
   } else {
     if (chan->term) {
-      terminal_receive(chan->term, ptr, count);
+      terminal_receive_output(chan->term, ptr, count);
     }
 
     rbuffer_consumed(buf, count);
 
     if (callback_reader_set(*reader)) {
       ga_concat_len(&reader->buffer, ptr, count);
+      if (reader->lines) {
+        // Remember where the last complete line ends.
+        for (size_t i = count; i > 0; i--) {
+          if (ptr[i - 1] == NL) {
+            reader->lines_len = (size_t)reader->buffer.ga_len - count + i;
+            break;
+          }
+        }
+      }
     }
   }
 
@@ -732,6 +923,19 @@ void channel_reader_callbacks(Channel *chan, CallbackReader *reader)
       }
       reader->eof = false;
     }
+  } else if (reader->lines) {
+    bool is_eof = reader->eof;
+    if (reader->lines_len > 0) {
+      channel_callback_call(chan, reader);
+    }
+    // At eof pass the unfinished line, if any, then an empty list.
+    if (is_eof) {
+      if (reader->buffer.ga_len > 0) {
+        channel_callback_call(chan, reader);
+      }
+      channel_callback_call(chan, reader);
+      reader->eof = false;
+    }
   } else {
     bool is_eof = reader->eof;
     if (reader->buffer.ga_len > 0) {
@@ -745,9 +949,32 @@ void channel_reader_callbacks(Channel *chan, CallbackReader *reader)
   }
 }
 
+/// Take the data for a callback of a reader in "lines" mode: the complete
+/// lines, or else the unfinished line, or else nothing (an empty list).
+static list_T *reader_take_lines(CallbackReader *reader)
+{
+  char *data = reader->buffer.ga_data;
+  size_t len = reader->lines_len;
+  if (len > 0) {
+    // Without the last NL, it doesn't start another line.
+    list_T *l = buffer_to_tv_list(data, len - 1);
+    reader->buffer.ga_len -= (int)len;
+    memmove(data, data + len, (size_t)reader->buffer.ga_len);
+    reader->lines_len = 0;
+    return l;
+  }
+  if (reader->buffer.ga_len > 0) {
+    list_T *l = buffer_to_tv_list(data, (size_t)reader->buffer.ga_len);
+    ga_clear(&reader->buffer);
+    return l;
+  }
+  return tv_list_alloc(0);
+}
+
 static void channel_process_exit_cb(Process *proc, int status, void *data)
 {
   Channel *chan = data;
+  job_pool_remove(chan);
   if (chan->term) {
     terminal_close(&chan->term, status);
   }
@@ -774,10 +1001,14 @@ static void channel_callback_call(Channel *chan, CallbackReader *reader)
   if (reader) {
     argv[1].v_type = VAR_LIST;
     argv[1].v_lock = VAR_UNLOCKED;
-    argv[1].vval.v_list = buffer_to_tv_list(reader->buffer.ga_data,
-                                            (size_t)reader->buffer.ga_len);
+    if (reader->lines && !reader->buffered) {
+      argv[1].vval.v_list = reader_take_lines(reader);
+    } else {
+      argv[1].vval.v_list = buffer_to_tv_list(reader->buffer.ga_data,
+                                              (size_t)reader->buffer.ga_len);
+      ga_clear(&reader->buffer);
+    }
     tv_list_ref(argv[1].vval.v_list);
-    ga_clear(&reader->buffer);
     cb = &reader->cb;
     argv[2].vval.v_string = (char *)reader->type;
   } else {
@@ -922,6 +1153,7 @@ Dictionary channel_info(uint64_t id)
       }
     }
     PUT(info, "argv", ARRAY_OBJ(argv));
+    PUT(info, "spawn_time", INTEGER_OBJ((Integer)chan->stream.proc.spawn_time));
     break;
   }
 
@@ -946,6 +1178,10 @@ Dictionary channel_info(uint64_t id)
   if (chan->is_rpc) {
     mode_desc = "rpc";
     PUT(info, "client", DICTIONARY_OBJ(rpc_client_info(chan)));
+    size_t queued = rpc_write_queue_size(chan->id);
+    if (queued > 0) {
+      PUT(info, "write_queue", INTEGER_OBJ((Integer)queued));
+    }
   } else if (chan->term) {
     mode_desc = "terminal";
     PUT(info, "buffer", BUFFER_OBJ(terminal_buf(chan->term)));
@@ -51,6 +51,10 @@ struct Channel {
 
   bool callback_busy;
   bool callback_scheduled;
+
+  char *pool_key;  ///< jobstart() "pool": command, cwd and env of the job
+  int pool_timeout;  ///< ms to keep the job in the pool after jobstop()
+  uint64_t pool_expire;  ///< os_hrtime() when the idle job is stopped, or 0
 };
 
 EXTERN PMap(uint64_t) channels INIT( = MAP_INIT);
@@ -55,6 +55,8 @@ typedef struct {
   garray_T buffer;
   bool eof;
   bool buffered;
+  bool lines;        // only pass complete lines to the callback
+  size_t lines_len;  // bytes of complete lines in "buffer", when "lines" is set
   bool fwd_err;
   const char *type;
 } CallbackReader;
@@ -63,5 +65,7 @@ typedef struct {
                                                 .self = NULL, \
                                                 .buffer = GA_EMPTY_INIT_VALUE, \
                                                 .buffered = false, \
+                                                .lines = false, \
+                                                .lines_len = 0, \
                                                 .fwd_err = false, \
                                                 .type = NULL })
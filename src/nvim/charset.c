@@ -749,12 +749,18 @@ int vim_strsize(const char *s)
 int vim_strnsize(const char *s, int len)
 {
   assert(s != NULL);
+  const char *const end = s + strnlen(s, (size_t)MAX(len, 0));
   int size = 0;
-  while (*s != NUL && --len >= 0) {
-    int l = utfc_ptr2len(s);
+  while (s < end) {
+    // Quickly skip over printable ASCII, each character is one cell.
+    size_t n = utf_ascii_cells_len(s, (size_t)(end - s));
+    if (n > 0) {
+      size += (int)n;
+      s += n;
+      continue;
+    }
     size += ptr2cells(s);
-    s += l;
-    len -= l - 1;
+    s += utfc_ptr2len(s);
   }
   return size;
 }
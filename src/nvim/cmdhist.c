@@ -23,6 +23,7 @@
 #include "nvim/option_vars.h"
 #include "nvim/os/time.h"
 #include "nvim/regexp.h"
+#include "nvim/shada.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
 #include "nvim/vim_defs.h"
@@ -46,6 +47,7 @@ int get_hislen(void)
 /// Return a pointer to a specified history table
 histentry_T *get_histentry(int hist_type)
 {
+  shada_load_history();
   return history[hist_type];
 }
 
@@ -56,11 +58,13 @@ void set_histentry(int hist_type, histentry_T *entry)
 
 int *get_hisidx(int hist_type)
 {
+  shada_load_history();
   return &hisidx[hist_type];
 }
 
 int *get_hisnum(int hist_type)
 {
+  shada_load_history();
   return &hisnum[hist_type];
 }
 
@@ -350,6 +354,7 @@ void add_to_history(int histype, const char *new_entry, int in_map, int sep)
 /// @param histype  may be one of the HIST_ values.
 static int get_history_idx(int histype)
 {
+  shada_load_history();
   if (hislen == 0 || histype < 0 || histype >= HIST_COUNT
       || hisidx[histype] < 0) {
     return -1;
@@ -367,6 +372,7 @@ static int calc_hist_idx(int histype, int num)
 {
   int i;
 
+  shada_load_history();
   if (hislen == 0 || histype < 0 || histype >= HIST_COUNT
       || (i = hisidx[histype]) < 0 || num == 0) {
     return -1;
@@ -420,6 +426,7 @@ static char *get_history_entry(int histype, int idx)
 ///         values, FAIL otherwise.
 int clr_history(const int histype)
 {
+  shada_load_history();
   if (hislen != 0 && histype >= 0 && histype < HIST_COUNT) {
     histentry_T *hisptr = history[histype];
     for (int i = hislen; i--; hisptr++) {
@@ -437,6 +444,7 @@ int clr_history(const int histype)
 /// @param histype  may be one of the HIST_ values.
 static int del_history_entry(int histype, char *str)
 {
+  shada_load_history();
   if (hislen == 0 || histype < 0 || histype >= HIST_COUNT || *str == NUL
       || hisidx[histype] < 0) {
     return false;
@@ -609,6 +617,7 @@ void ex_history(exarg_T *eap)
     msg(_("'history' option is zero"), 0);
     return;
   }
+  shada_load_history();
 
   if (!(ascii_isdigit(*arg) || *arg == '-' || *arg == ',')) {
     end = arg;
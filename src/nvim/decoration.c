@@ -25,6 +25,9 @@
 # include "decoration.c.generated.h"
 #endif
 
+/// Number of invalid sign column ranges above which all lines are counted again.
+enum { SIGNCOLS_MAX_INVALID = 64, };
+
 // TODO(bfredl): These should maybe be per-buffer, so that all resources
 // associated with a buffer can be freed when the buffer is unloaded.
 kvec_t(DecorSignHighlight) decor_items = KV_INITIAL_VALUE;
@@ -554,7 +557,8 @@ void decor_range_add_sh(DecorState *state, int start_row, int start_col, int end
 
   if (sh->hl_id || (sh->flags & (kSHConceal | kSHSpellOn | kSHSpellOff))) {
     if (sh->hl_id) {
-      range.attr_id = syn_id2attr(sh->hl_id);
+      range.attr_id = state->win ? win_hl_id2attr(state->win, sh->hl_id)
+                                 : syn_id2attr(sh->hl_id);
     }
     decor_range_insert(state, range);
   }
@@ -858,22 +862,28 @@ static void buf_signcols_validate_range(buf_T *buf, int row1, int row2, int add)
 
 int buf_signcols_validate(win_T *wp, buf_T *buf, bool stc_check)
 {
-  if (!map_size(buf->b_signcols.invalid)) {
-    return buf->b_signcols.max;
+  if (buf->b_signcols.rescan) {
+    // Too many ranges were invalid, count all lines once instead.
+    buf->b_signcols.rescan = false;
+    buf->b_signcols.max_count = 0;
+  } else {
+    if (!map_size(buf->b_signcols.invalid)) {
+      return buf->b_signcols.max;
+    }
+
+    int start;
+    SignRange range;
+    map_foreach(buf->b_signcols.invalid, start, range, {
+      // Leave rest of the ranges invalid if max is already at configured
+      // maximum or resize is detected for a 'statuscolumn' rebuild.
+      if ((stc_check && buf->b_signcols.resized)
+          || (!stc_check && range.add > 0 && buf->b_signcols.max >= wp->w_maxscwidth)) {
+        return wp->w_maxscwidth;
+      }
+      buf_signcols_validate_range(buf, start, range.end, range.add);
+    });
   }
 
-  int start;
-  SignRange range;
-  map_foreach(buf->b_signcols.invalid, start, range, {
-    // Leave rest of the ranges invalid if max is already at configured
-    // maximum or resize is detected for a 'statuscolumn' rebuild.
-    if ((stc_check && buf->b_signcols.resized)
-        || (!stc_check && range.add > 0 && buf->b_signcols.max >= wp->w_maxscwidth)) {
-      return wp->w_maxscwidth;
-    }
-    buf_signcols_validate_range(buf, start, range.end, range.add);
-  });
-
   // Check if we need to scan the entire buffer.
   if (buf->b_signcols.max_count == 0) {
     buf->b_signcols.max = 0;
@@ -890,6 +900,20 @@ static void buf_signcols_invalidate_range(buf_T *buf, int row1, int row2, int ad
   if (!buf->b_signs_with_text) {
     buf->b_signcols.max = buf->b_signcols.max_count = 0;
     buf->b_signcols.resized = true;
+    buf->b_signcols.rescan = false;
+    map_clear(int, buf->b_signcols.invalid);
+    return;
+  }
+
+  if (buf->b_signcols.rescan) {
+    return;  // all lines will be counted anyway
+  }
+
+  // Merging a range below is linear in the number of ranges, and so is
+  // counting each one of them.  When signs are placed on many lines at once,
+  // counting all lines once in buf_signcols_validate() is cheaper.
+  if (map_size(buf->b_signcols.invalid) >= SIGNCOLS_MAX_INVALID) {
+    buf->b_signcols.rescan = true;
     map_clear(int, buf->b_signcols.invalid);
     return;
   }
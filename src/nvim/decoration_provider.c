@@ -28,7 +28,7 @@ static kvec_t(DecorProvider) decor_providers = KV_INITIAL_VALUE;
 
 #define DECORATION_PROVIDER_INIT(ns_id) (DecorProvider) \
   { ns_id, false, LUA_NOREF, LUA_NOREF, \
-    LUA_NOREF, LUA_NOREF, LUA_NOREF, \
+    LUA_NOREF, LUA_NOREF, LUA_NOREF, LUA_NOREF, \
     LUA_NOREF, -1, false, false, 0 }
 
 static void decor_provider_error(DecorProvider *provider, const char *name, const char *msg)
@@ -119,8 +119,8 @@ void decor_providers_start(DecorProviders *providers)
   }
 }
 
-/// For each provider run 'win'. If result is not false, then collect the
-/// 'on_line' callback to call inside win_line
+/// For each provider run 'win' and then 'range'. If results are not false,
+/// then collect the 'on_line' callback to call inside win_line
 ///
 /// @param      wp             Window
 /// @param      providers      Decoration providers
@@ -141,16 +141,36 @@ void decor_providers_invoke_win(win_T *wp, DecorProviders *providers,
 
   for (size_t k = 0; k < kv_size(*providers); k++) {
     DecorProvider *p = kv_A(*providers, k);
-    if (p && p->redraw_win != LUA_NOREF) {
+    if (p == NULL || (p->redraw_win == LUA_NOREF && p->redraw_range == LUA_NOREF)) {
+      continue;
+    }
+
+    bool active = true;
+    if (p->redraw_win != LUA_NOREF) {
       MAXSIZE_TEMP_ARRAY(args, 4);
       ADD_C(args, WINDOW_OBJ(wp->handle));
       ADD_C(args, BUFFER_OBJ(wp->w_buffer->handle));
       // TODO(bfredl): we are not using this, but should be first drawn line?
       ADD_C(args, INTEGER_OBJ(wp->w_topline - 1));
       ADD_C(args, INTEGER_OBJ(knownmax - 1));
-      if (decor_provider_invoke(p, "win", p->redraw_win, args, true)) {
-        kvi_push(*line_providers, p);
-      }
+      active = decor_provider_invoke(p, "win", p->redraw_win, args, true);
+    }
+
+    // One call for all the lines instead of one 'line' call per line.
+    if (active && p->redraw_range != LUA_NOREF) {
+      MAXSIZE_TEMP_ARRAY(args, 4);
+      ADD_C(args, WINDOW_OBJ(wp->handle));
+      ADD_C(args, BUFFER_OBJ(wp->w_buffer->handle));
+      ADD_C(args, INTEGER_OBJ(wp->w_topline - 1));
+      ADD_C(args, INTEGER_OBJ(knownmax - 1));
+      decor_state.running_decor_provider = true;
+      active = decor_provider_invoke(p, "range", p->redraw_range, args, true);
+      decor_state.running_decor_provider = false;
+      hl_check_ns();
+    }
+
+    if (active) {
+      kvi_push(*line_providers, p);
     }
   }
 }
@@ -282,6 +302,7 @@ void decor_provider_clear(DecorProvider *p)
   NLUA_CLEAR_REF(p->redraw_buf);
   NLUA_CLEAR_REF(p->redraw_win);
   NLUA_CLEAR_REF(p->redraw_line);
+  NLUA_CLEAR_REF(p->redraw_range);
   NLUA_CLEAR_REF(p->redraw_end);
   NLUA_CLEAR_REF(p->spell_nav);
   p->active = false;
@@ -59,6 +59,10 @@
 #include "nvim/window.h"
 #include "xdiff/xdiff.h"
 
+// Number of lines around the changed lines that diff_update_local() also
+// diffs, so that it finds about the same diff as diffing whole buffers.
+#define DIFF_LOCAL_CONTEXT 100
+
 static bool diff_busy = false;         // using diff structs, don't change them
 static bool diff_need_update = false;  // ex_diffupdate needs to be called
 
@@ -256,6 +260,7 @@ void diff_invalidate(buf_T *buf)
     int i = diff_buf_idx_tp(buf, tp);
     if (i != DB_COUNT) {
       tp->tp_diff_invalid = true;
+      tp->tp_diff_snap.ds_buf[i] = NULL;
       if (tp == curtab) {
         diff_redraw(true);
       }
@@ -941,6 +946,12 @@ void ex_diffupdate(exarg_T *eap)
     return;
   }
 
+  // After editing only diff the lines that changed, unless ":diffupdate" was
+  // used.
+  if (eap == NULL && diff_update_local()) {
+    return;
+  }
+
   int had_diffs = curtab->tp_first_diff != NULL;
 
   // Delete all diffblocks.
@@ -987,6 +998,8 @@ void ex_diffupdate(exarg_T *eap)
   curwin->w_valid_cursor.lnum = 0;
 
 theend:
+  diff_snap_save(curtab);
+
   // A redraw is needed if there were diffs and they were cleared, or there
   // are diffs now, which means they got updated.
   if (had_diffs || curtab->tp_first_diff != NULL) {
@@ -995,6 +1008,205 @@ theend:
   }
 }
 
+/// Remember what the diff blocks of tab page "tp" were made from.
+static void diff_snap_save(tabpage_T *tp)
+{
+  diffsnap_T *ds = &tp->tp_diff_snap;
+  for (int i = 0; i < DB_COUNT; i++) {
+    buf_T *buf = tp->tp_diffbuf[i];
+    ds->ds_buf[i] = buf;
+    ds->ds_tick[i] = buf != NULL ? buf_get_changedtick(buf) : 0;
+    ds->ds_top[i] = 0;
+    ds->ds_bot[i] = 0;
+  }
+  ds->ds_flags = diff_flags;
+  ds->ds_algorithm = diff_algorithm;
+}
+
+/// Called by changed_lines(): lines "lnum" up to "lnume" of "buf" changed and
+/// "xtra" lines were added.  Remember them for diff_update_local().
+void diff_lines_changed(buf_T *buf, linenr_T lnum, linenr_T lnume, linenr_T xtra)
+{
+  FOR_ALL_TABS(tp) {
+    int idx = diff_buf_idx_tp(buf, tp);
+    if (idx == DB_COUNT) {
+      continue;
+    }
+    diffsnap_T *ds = &tp->tp_diff_snap;
+    linenr_T bot = MAX(lnume + xtra - 1, lnum);
+    if (ds->ds_top[idx] == 0) {
+      ds->ds_top[idx] = lnum;
+      ds->ds_bot[idx] = bot;
+    } else {
+      if (ds->ds_bot[idx] >= lnume) {
+        ds->ds_bot[idx] += xtra;
+      }
+      ds->ds_top[idx] = MIN(ds->ds_top[idx], lnum);
+      ds->ds_bot[idx] = MAX(ds->ds_bot[idx], bot);
+    }
+  }
+}
+
+/// Update the diff of two buffers, when only one of them changed since the
+/// last update, by diffing only the lines around the changed lines.  The
+/// diff blocks before and after them were kept up to date by
+/// diff_mark_adjust().
+///
+/// @return  true when done, false when the whole buffers need to be diffed.
+static bool diff_update_local(void)
+{
+  diffsnap_T *ds = &curtab->tp_diff_snap;
+  if (!diff_internal() || diff_internal_failed()
+      || ds->ds_flags != diff_flags || ds->ds_algorithm != diff_algorithm) {
+    return false;
+  }
+
+  // Need exactly two loaded buffers, of which one changed.
+  int idx[2];
+  int n = 0;
+  int d = DB_COUNT;  // index of the changed buffer
+  for (int i = 0; i < DB_COUNT; i++) {
+    buf_T *buf = curtab->tp_diffbuf[i];
+    if (buf != ds->ds_buf[i]) {
+      return false;
+    }
+    if (buf == NULL) {
+      continue;
+    }
+    if (n == 2 || buf->b_ml.ml_mfp == NULL) {
+      return false;
+    }
+    idx[n++] = i;
+    bool changed = buf_get_changedtick(buf) != ds->ds_tick[i];
+    if (changed != (ds->ds_top[i] != 0)) {
+      return false;  // changed without changed_lines()
+    }
+    if (changed) {
+      if (d != DB_COUNT) {
+        return false;
+      }
+      d = i;
+    }
+  }
+  if (n != 2 || d == DB_COUNT) {
+    return false;
+  }
+  const int o = d == idx[0] ? idx[1] : idx[0];
+  buf_T *const dbuf = curtab->tp_diffbuf[d];
+  buf_T *const obuf = curtab->tp_diffbuf[o];
+
+  const linenr_T line_count = dbuf->b_ml.ml_line_count;
+  linenr_T s = MIN(MAX(ds->ds_top[d] - DIFF_LOCAL_CONTEXT, 1), line_count);
+  linenr_T e = MIN(ds->ds_bot[d] + DIFF_LOCAL_CONTEXT, line_count);
+
+  // Also diff the lines of the diff blocks that touch these lines.
+  for (bool extended = true; extended;) {
+    extended = false;
+    for (diff_T *dp = curtab->tp_first_diff; dp != NULL; dp = dp->df_next) {
+      linenr_T lnum = dp->df_lnum[d];
+      linenr_T count = dp->df_count[d];
+      if (count < 0 || dp->df_count[o] < 0) {
+        return false;
+      }
+      if (lnum <= e + 1 && lnum + count >= s && (lnum < s || lnum + count - 1 > e)) {
+        s = MIN(s, lnum);
+        e = MAX(e, lnum + count - 1);
+        extended = true;
+      }
+    }
+  }
+  // Not worth it when most of the buffer changed.
+  if (e - s + 1 > line_count / 2) {
+    return false;
+  }
+
+  // Find the blocks before, in and after the lines.  The lines just before
+  // and after are equal in both buffers, which gives the lines to diff in
+  // the other buffer.
+  diff_T *dprev = NULL;
+  diff_T *dfirst = NULL;
+  diff_T *dlast = NULL;
+  for (diff_T *dp = curtab->tp_first_diff; dp != NULL; dp = dp->df_next) {
+    if (dp->df_lnum[d] + dp->df_count[d] < s) {
+      dprev = dp;
+    } else if (dp->df_lnum[d] <= e + 1) {
+      if (dfirst == NULL) {
+        dfirst = dp;
+      }
+      dlast = dp;
+    } else {
+      break;
+    }
+  }
+  diff_T *dend = dlast != NULL ? dlast : dprev;
+  linenr_T off_before = dprev == NULL ? 0
+                        : (dprev->df_lnum[o] + dprev->df_count[o])
+                        - (dprev->df_lnum[d] + dprev->df_count[d]);
+  linenr_T off_after = dend == NULL ? 0
+                       : (dend->df_lnum[o] + dend->df_count[o])
+                       - (dend->df_lnum[d] + dend->df_count[d]);
+  linenr_T first[DB_COUNT];
+  linenr_T last[DB_COUNT];
+  first[d] = s;
+  last[d] = e;
+  first[o] = s + off_before;
+  last[o] = e + off_after;
+  if (first[o] < 1 || last[o] > obuf->b_ml.ml_line_count || last[o] < first[o] - 1) {
+    return false;
+  }
+
+  // Diff the lines, the first buffer is the original like in
+  // diff_try_update().
+  const int idx_orig = idx[0];
+  const int idx_new = idx[1];
+  diffio_T dio;
+  CLEAR_FIELD(dio);
+  dio.dio_internal = true;
+  ga_init(&dio.dio_diff.dout_ga, sizeof(diffhunk_T), 100);
+  bool ok = diff_write_buffer(curtab->tp_diffbuf[idx_orig], &dio.dio_orig.din_mmfile,
+                              first[idx_orig], last[idx_orig]) == OK
+            && diff_write_buffer(curtab->tp_diffbuf[idx_new], &dio.dio_new.din_mmfile,
+                                 first[idx_new], last[idx_new]) == OK
+            && diff_file_internal(&dio) == OK;
+  clear_diffin(&dio.dio_orig);
+  clear_diffin(&dio.dio_new);
+  if (!ok) {
+    clear_diffout(&dio.dio_diff);
+    return false;
+  }
+
+  // Replace the blocks in the lines with the new ones.
+  diff_T *dnext = dlast != NULL ? dlast->df_next
+                  : dprev != NULL ? dprev->df_next : curtab->tp_first_diff;
+  for (diff_T *dp = dfirst; dp != NULL && dp != dnext;) {
+    diff_T *next = dp->df_next;
+    xfree(dp);
+    dp = next;
+  }
+  if (dprev == NULL) {
+    curtab->tp_first_diff = dnext;
+  } else {
+    dprev->df_next = dnext;
+  }
+  diff_T *dp = dprev;
+  for (int i = 0; i < dio.dio_diff.dout_ga.ga_len; i++) {
+    diffhunk_T *hunk = &((diffhunk_T *)dio.dio_diff.dout_ga.ga_data)[i];
+    dp = diff_alloc_new(curtab, dp, dnext);
+    dp->df_lnum[idx_orig] = hunk->lnum_orig + first[idx_orig] - 1;
+    dp->df_count[idx_orig] = (linenr_T)hunk->count_orig;
+    dp->df_lnum[idx_new] = hunk->lnum_new + first[idx_new] - 1;
+    dp->df_count[idx_new] = (linenr_T)hunk->count_new;
+  }
+  clear_diffout(&dio.dio_diff);
+
+  curtab->tp_diff_invalid = false;
+  diff_snap_save(curtab);
+  curwin->w_valid_cursor.lnum = 0;
+  diff_redraw(true);
+  apply_autocmds(EVENT_DIFFUPDATED, NULL, NULL, false, curbuf);
+  return true;
+}
+
 ///
 /// Do a quick test if "diff" really works.  Otherwise it looks like there
 /// are no differences.  Can't use the return value, it's non-zero when
@@ -1812,8 +2024,10 @@ bool diff_linematch(diff_T *dp)
   }
   // are there more than three diff buffers?
   int tsize = 0;
+  int nbufs = 0;
   for (int i = 0; i < DB_COUNT; i++) {
     if (curtab->tp_diffbuf[i] != NULL) {
+      nbufs++;
       // for the rare case (bug?) that the count of a diff block is negative, do
       // not run the algorithm because this will try to allocate a negative
       // amount of space and crash
@@ -1823,8 +2037,9 @@ bool diff_linematch(diff_T *dp)
       tsize += dp->df_count[i];
     }
   }
-  // avoid allocating a huge array because it will lag
-  return tsize <= linematch_lines;
+  // avoid allocating a huge array because it will lag, a hunk between two
+  // buffers can use linematch_heuristic() instead
+  return tsize <= linematch_lines || nbufs == 2;
 }
 
 static int get_max_diff_length(const diff_T *dp)
@@ -2054,6 +2269,7 @@ static void run_linematch_algorithm(diff_T *dp)
   const char *diffbufs[DB_COUNT];
   int diff_length[DB_COUNT];
   size_t ndiffs = 0;
+  int tsize = 0;
   for (int i = 0; i < DB_COUNT; i++) {
     if (curtab->tp_diffbuf[i] != NULL) {
       // write the contents of the entire buffer to
@@ -2068,6 +2284,7 @@ static void run_linematch_algorithm(diff_T *dp)
       // keep track of the length of this diff block to pass it to the linematch
       // algorithm
       diff_length[ndiffs] = dp->df_count[i];
+      tsize += dp->df_count[i];
 
       // increment the amount of diff buffers we are passing to the algorithm
       ndiffs++;
@@ -2078,7 +2295,10 @@ static void run_linematch_algorithm(diff_T *dp)
   // of integers (*decisions) and the length of that array (decisions_length)
   int *decisions = NULL;
   const bool iwhite = (diff_flags & (DIFF_IWHITEALL | DIFF_IWHITE)) > 0;
-  size_t decisions_length = linematch_nbuffers(diffbufs, diff_length, ndiffs, &decisions, iwhite);
+  size_t decisions_length = tsize <= linematch_lines
+                            ? linematch_nbuffers(diffbufs, diff_length, ndiffs, &decisions, iwhite)
+                            : linematch_heuristic(diffbufs, diff_length, &decisions, iwhite,
+                                                  linematch_lines);
 
   for (size_t i = 0; i < ndiffs; i++) {
     XFREE_CLEAR(diffbufs_mm[i].ptr);
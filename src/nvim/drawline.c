@@ -5,6 +5,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -484,7 +485,7 @@ static void get_sign_display_info(bool nrcol, win_T *wp, winlinevars_T *wlv, int
     wlv->p_extra = wlv->extra;
     wlv->c_extra = NUL;
     wlv->char_attr = (use_cursor_line_highlight(wp, wlv->lnum) && sign_cul_attr)
-                     ? sign_cul_attr : sattr.hl_id ? syn_id2attr(sattr.hl_id) : 0;
+                     ? sign_cul_attr : sattr.hl_id ? win_hl_id2attr(wp, sattr.hl_id) : 0;
   } else {
     wlv->c_extra = ' ';
     wlv->n_extra = nrcol ? number_width(wp) + 1 : SIGN_WIDTH;
@@ -1032,6 +1033,7 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, bool number_onl
   int nextlinecol = 0;                  // column where nextline[] starts
   int nextline_idx = 0;                 // index in nextline[] where next line
                                         // starts
+  uint64_t spell_hash = 0;              // spell_line_hash() of the line
   int spell_attr = 0;                   // attributes desired by spelling
   int word_end = 0;                     // last byte with same spell_attr
   int cur_checked_col = 0;              // checked column for current line
@@ -1290,17 +1292,17 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, bool number_onl
     statuscol.width = win_col_off(wp) - (cmdwin_type != 0 && wp == curwin);
     statuscol.use_cul = use_cursor_line_highlight(wp, lnum);
     statuscol.sign_cul_id = statuscol.use_cul ? sign_cul_attr : 0;
-    statuscol.num_attr = sign_num_attr > 0 ? syn_id2attr(sign_num_attr) : 0;
+    statuscol.num_attr = sign_num_attr > 0 ? win_hl_id2attr(wp, sign_num_attr) : 0;
   } else {
     if (sign_cul_attr > 0) {
-      sign_cul_attr = syn_id2attr(sign_cul_attr);
+      sign_cul_attr = win_hl_id2attr(wp, sign_cul_attr);
     }
     if (sign_num_attr > 0) {
-      sign_num_attr = syn_id2attr(sign_num_attr);
+      sign_num_attr = win_hl_id2attr(wp, sign_num_attr);
     }
   }
   if (line_attr > 0) {
-    wlv.line_attr = syn_id2attr(line_attr);
+    wlv.line_attr = win_hl_id2attr(wp, line_attr);
   }
 
   // Highlight the current line in the quickfix window.
@@ -1377,6 +1379,7 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, bool number_onl
         nextline_idx = SPWORDLEN + 1;
       }
     }
+    spell_hash = spell_line_hash(line, nextlinecol == MAXCOL ? NULL : nextline + nextline_idx - 1);
   }
 
   line = end_fill ? "" : ml_get_buf(wp->w_buffer, lnum);
@@ -2109,7 +2112,9 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, bool number_onl
               p = prev_ptr;
             }
             spv->spv_cap_col -= (int)(prev_ptr - line);
-            size_t tmplen = spell_check(wp, p, &spell_hlf, &spv->spv_cap_col, spv->spv_unchanged);
+            size_t tmplen = spell_check_cached(wp, spell_hash, (colnr_T)(prev_ptr - line), p,
+                                               &spell_hlf, &spv->spv_cap_col,
+                                               spv->spv_unchanged);
             assert(tmplen <= INT_MAX);
             int len = (int)tmplen;
             word_end = (int)v + len;
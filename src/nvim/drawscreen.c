@@ -61,6 +61,7 @@
 
 #include "klib/kvec.h"
 #include "nvim/api/private/defs.h"
+#include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/buffer.h"
@@ -83,6 +84,7 @@
 #include "nvim/highlight.h"
 #include "nvim/highlight_group.h"
 #include "nvim/insexpand.h"
+#include "nvim/log.h"
 #include "nvim/match.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
@@ -92,6 +94,7 @@
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/os_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/plines.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
@@ -443,6 +446,7 @@ int update_screen(void)
   must_redraw = 0;
 
   updating_screen = 1;
+  uint64_t screen_start = os_hrtime();
 
   display_tick++;  // let syntax code know we're in a next round of
                    // display updating
@@ -582,7 +586,9 @@ int update_screen(void)
         update_window_hl(tp->tp_curwin, type >= UPD_NOT_VALID);
       }
     }
+    uint64_t start = os_hrtime();
     draw_tabline();
+    redraw_stats_add(kRedrawTabline, start);
   }
 
   FOR_ALL_WINDOWS_IN_TAB(wp, curtab) {
@@ -606,6 +612,10 @@ int update_screen(void)
   }
 
   // Go from top to bottom through the windows, redrawing the ones that need it.
+  // This is done one window at a time: win_update() and win_line() switch
+  // curwin/curbuf for 'statuscolumn' and 'foldtext', share decor_state, the
+  // syntax and search highlight state and the memline line cache of the
+  // buffer, and call decoration providers and autocommands in between.
   bool did_one = false;
   screen_search_hl.rm.regprog = NULL;
 
@@ -629,13 +639,21 @@ int update_screen(void)
         did_one = true;
         start_search_hl();
       }
+      uint64_t start = os_hrtime();
+      NVIM_PROBE(win_update_begin, 2, wp->handle, wp->w_redr_type);
       win_update(wp, &providers);
+      uint64_t elapsed = redraw_stats_add(kRedrawWindow, start);
+      NVIM_PROBE(win_update_end, 2, wp->handle, elapsed);
+      wp->w_redraw_count++;
+      wp->w_redraw_time += elapsed;
     }
 
     // redraw status line and window bar after the window to minimize cursor movement
     if (wp->w_redr_status) {
+      uint64_t start = os_hrtime();
       win_redr_winbar(wp);
       win_redr_status(wp);
+      redraw_stats_add(kRedrawStatus, start);
     }
   }
 
@@ -658,6 +676,9 @@ int update_screen(void)
 
   updating_screen = 0;
 
+  // Parse ahead of the displayed lines while waiting for input.
+  syntax_prefill_schedule();
+
   // Clear or redraw the command line.  Done last, because scrolling may
   // mess up the command line.
   if (clear_cmdline || redraw_cmdline || redraw_mode) {
@@ -675,6 +696,7 @@ int update_screen(void)
 
   // either cmdline is cleared, not drawn or mode is last drawn
   cmdline_was_last_drawn = false;
+  redraw_stats_add(kRedrawScreen, screen_start);
   return OK;
 }
 
@@ -845,26 +867,33 @@ void show_cursor_info_later(bool force)
 
   // Only draw when something changed.
   validate_virtcol_win(curwin);
-  if (force
-      || curwin->w_cursor.lnum != curwin->w_stl_cursor.lnum
-      || curwin->w_cursor.col != curwin->w_stl_cursor.col
-      || curwin->w_virtcol != curwin->w_stl_virtcol
-      || curwin->w_cursor.coladd != curwin->w_stl_cursor.coladd
-      || curwin->w_topline != curwin->w_stl_topline
-      || curwin->w_buffer->b_ml.ml_line_count != curwin->w_stl_line_count
-      || curwin->w_topfill != curwin->w_stl_topfill
-      || empty_line != curwin->w_stl_empty
-      || reg_recording != curwin->w_stl_recording
-      || state != curwin->w_stl_state
-      || (VIsual_active && VIsual_mode != curwin->w_stl_visual_mode)) {
+  bool moved = curwin->w_cursor.lnum != curwin->w_stl_cursor.lnum
+               || curwin->w_cursor.col != curwin->w_stl_cursor.col
+               || curwin->w_virtcol != curwin->w_stl_virtcol
+               || curwin->w_cursor.coladd != curwin->w_stl_cursor.coladd
+               || curwin->w_topline != curwin->w_stl_topline
+               || curwin->w_buffer->b_ml.ml_line_count != curwin->w_stl_line_count
+               || curwin->w_topfill != curwin->w_stl_topfill
+               || empty_line != curwin->w_stl_empty;
+  bool changed = force
+                 || reg_recording != curwin->w_stl_recording
+                 || state != curwin->w_stl_state
+                 || (VIsual_active && VIsual_mode != curwin->w_stl_visual_mode);
+  if (moved || changed) {
+    // When only the cursor moved, a status line or window bar that does not
+    // show anything about the cursor does not need to be rebuilt.
     if (curwin->w_status_height || global_stl_height()) {
-      curwin->w_redr_status = true;
+      if (changed || stl_uses_cursor(*curwin->w_p_stl != NUL ? curwin->w_p_stl : p_stl)) {
+        curwin->w_redr_status = true;
+      }
     } else {
       redraw_cmdline = true;
     }
 
     if (*p_wbr != NUL || *curwin->w_p_wbr != NUL) {
-      curwin->w_redr_status = true;
+      if (changed || stl_uses_cursor(*curwin->w_p_wbr != NUL ? curwin->w_p_wbr : p_wbr)) {
+        curwin->w_redr_status = true;
+      }
     }
 
     if ((p_icon && (stl_syntax & STL_IN_ICON))
@@ -1401,6 +1430,148 @@ static void draw_sep_connectors_win(win_T *wp)
   }
 }
 
+/// Adds the time since "start" to the stats of "phase".
+///
+/// @return  the time since "start" in nanoseconds
+static uint64_t redraw_stats_add(RedrawPhase phase, uint64_t start)
+{
+  uint64_t elapsed = os_hrtime() - start;
+  redraw_stats[phase].count++;
+  redraw_stats[phase].time += elapsed;
+  return elapsed;
+}
+
+/// Names of the redraw phases, as used by nvim__redraw_stats().
+static const char *redraw_phase_names[kRedrawPhaseCount] = {
+  [kRedrawScreen] = "screen",
+  [kRedrawWindow] = "win_update",
+  [kRedrawLine] = "win_line",
+  [kRedrawFold] = "fold",
+  [kRedrawProviders] = "providers",
+  [kRedrawStatus] = "status",
+  [kRedrawTabline] = "tabline",
+};
+
+/// Clears the redraw stats of all phases and windows.
+void redraw_stats_reset(void)
+{
+  memset(redraw_stats, 0, sizeof(redraw_stats));
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    wp->w_redraw_count = 0;
+    wp->w_redraw_lines = 0;
+    wp->w_redraw_time = 0;
+  }
+}
+
+/// Gets the redraw stats of all phases and windows. Times are in microseconds.
+///
+/// @see nvim__redraw_stats
+Dictionary redraw_get_stats(void)
+{
+  Dictionary rv = ARRAY_DICT_INIT;
+  for (int i = 0; i < kRedrawPhaseCount; i++) {
+    Dictionary info = ARRAY_DICT_INIT;
+    PUT(info, "count", INTEGER_OBJ((Integer)redraw_stats[i].count));
+    PUT(info, "time", INTEGER_OBJ((Integer)(redraw_stats[i].time / 1000)));
+    PUT(rv, redraw_phase_names[i], DICTIONARY_OBJ(info));
+  }
+
+  Array windows = ARRAY_DICT_INIT;
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    if (wp->w_redraw_count == 0) {
+      continue;
+    }
+    Dictionary info = ARRAY_DICT_INIT;
+    PUT(info, "win", WINDOW_OBJ(wp->handle));
+    PUT(info, "count", INTEGER_OBJ((Integer)wp->w_redraw_count));
+    PUT(info, "lines", INTEGER_OBJ((Integer)wp->w_redraw_lines));
+    PUT(info, "time", INTEGER_OBJ((Integer)(wp->w_redraw_time / 1000)));
+    ADD(windows, DICTIONARY_OBJ(info));
+  }
+  PUT(rv, "windows", ARRAY_OBJ(windows));
+  return rv;
+}
+
+/// Lists the redraw stats for ":profile redraw".
+void redraw_stats_report(void)
+{
+  msg_puts_title(_("  TOTAL      COUNT     AVERAGE   PHASE"));
+  msg_puts("\n");
+  for (int i = 0; i < kRedrawPhaseCount && !got_int; i++) {
+    RedrawTiming *timing = &redraw_stats[i];
+    msg_puts(profile_msg(timing->time));
+    msg_puts(" ");
+    msg_advance(13);
+    msg_outnum((int)timing->count);
+    msg_puts(" ");
+    msg_advance(20);
+    msg_puts(profile_msg(timing->count > 0
+                         ? profile_divide(timing->time, (int)timing->count)
+                         : profile_zero()));
+    msg_puts(" ");
+    msg_advance(32);
+    msg_puts(redraw_phase_names[i]);
+    msg_puts("\n");
+  }
+
+  if (got_int) {
+    return;
+  }
+  msg_puts("\n");
+  msg_puts_title(_("  TOTAL      COUNT  LINES     WINDOW"));
+  msg_puts("\n");
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    if (got_int) {
+      return;
+    }
+    if (wp->w_redraw_count == 0) {
+      continue;
+    }
+    msg_puts(profile_msg(wp->w_redraw_time));
+    msg_puts(" ");
+    msg_advance(13);
+    msg_outnum((int)wp->w_redraw_count);
+    msg_puts(" ");
+    msg_advance(20);
+    msg_outnum((int)wp->w_redraw_lines);
+    msg_puts(" ");
+    msg_advance(30);
+    msg_outnum(wp->handle);
+    msg_puts(" ");
+    msg_outtrans(wp->w_buffer->b_fname != NULL ? wp->w_buffer->b_fname : _("[No Name]"), 0);
+    msg_puts("\n");
+  }
+}
+
+/// decor_providers_invoke_win() with timing for nvim__redraw_stats().
+static void win_invoke_providers(win_T *wp, DecorProviders *providers,
+                                 DecorProviders *line_providers)
+{
+  uint64_t start = os_hrtime();
+  decor_providers_invoke_win(wp, providers, line_providers);
+  redraw_stats_add(kRedrawProviders, start);
+}
+
+/// fold_info() with timing for nvim__redraw_stats().
+static foldinfo_T win_fold_info(win_T *wp, linenr_T lnum)
+{
+  uint64_t start = os_hrtime();
+  foldinfo_T info = fold_info(wp, lnum);
+  redraw_stats_add(kRedrawFold, start);
+  return info;
+}
+
+/// win_line() with timing for nvim__redraw_stats().
+static int win_draw_line(win_T *wp, linenr_T lnum, int startrow, int endrow, bool number_only,
+                         spellvars_T *spv, foldinfo_T foldinfo, DecorProviders *providers)
+{
+  uint64_t start = os_hrtime();
+  int row = win_line(wp, lnum, startrow, endrow, number_only, spv, foldinfo, providers);
+  redraw_stats_add(kRedrawLine, start);
+  wp->w_redraw_lines++;
+  return row;
+}
+
 /// Update a single window.
 ///
 /// This may cause the windows below it also to be redrawn (when clearing the
@@ -1494,7 +1665,7 @@ static void win_update(win_T *wp, DecorProviders *providers)
   decor_redraw_reset(wp, &decor_state);
 
   DecorProviders line_providers;
-  decor_providers_invoke_win(wp, providers, &line_providers);
+  win_invoke_providers(wp, providers, &line_providers);
 
   if (win_redraw_signcols(wp)) {
     wp->w_lines_valid = 0;
@@ -2034,7 +2205,7 @@ static void win_update(win_T *wp, DecorProviders *providers)
   wp->w_cursorline = win_cursorline_standout(wp) ? wp->w_cursor.lnum : 0;
   if (wp->w_p_cul) {
     // Make sure that the cursorline on a closed fold is redrawn
-    cursorline_fi = fold_info(wp, wp->w_cursor.lnum);
+    cursorline_fi = win_fold_info(wp, wp->w_cursor.lnum);
     if (cursorline_fi.fi_level != 0 && cursorline_fi.fi_lines > 0) {
       wp->w_cursorline = cursorline_fi.fi_lnum;
     }
@@ -2075,6 +2246,13 @@ static void win_update(win_T *wp, DecorProviders *providers)
     // with.  It is used further down when the line doesn't fit.
     srow = row;
 
+    // With 'cursorlineopt' set to "number" only the columns before the text
+    // change on the old and new cursor line, when it is a single screen line.
+    bool cul_nr_only = (lnum == wp->w_cursorline || lnum == wp->w_last_cursorline)
+                       && wp->w_p_culopt_flags == CULOPT_NBR && wp->w_p_cole == 0
+                       && idx < wp->w_lines_valid && wp->w_lines[idx].wl_valid
+                       && wp->w_lines[idx].wl_lnum == lnum && wp->w_lines[idx].wl_size == 1;
+
     // Update a line when it is in an area that needs updating, when it
     // has changes or w_lines[idx] is invalid.
     // "bot_start" may be halfway a wrapped line after using
@@ -2101,8 +2279,8 @@ static void win_update(win_T *wp, DecorProviders *providers)
                         // if lines were inserted or deleted
                         || (wp->w_match_head != NULL
                             && buf->b_mod_xlines != 0)))))
-        || lnum == wp->w_cursorline
-        || lnum == wp->w_last_cursorline) {
+        || ((lnum == wp->w_cursorline
+             || lnum == wp->w_last_cursorline) && !cul_nr_only)) {
       if (lnum == mod_top) {
         top_to_mod = false;
       }
@@ -2258,7 +2436,7 @@ static void win_update(win_T *wp, DecorProviders *providers)
       // Otherwise, display normally (can be several display lines when
       // 'wrap' is on).
       foldinfo_T foldinfo = wp->w_p_cul && lnum == wp->w_cursor.lnum
-                            ? cursorline_fi : fold_info(wp, lnum);
+                            ? cursorline_fi : win_fold_info(wp, lnum);
 
       if (foldinfo.fi_lines == 0
           && idx < wp->w_lines_valid
@@ -2281,9 +2459,9 @@ static void win_update(win_T *wp, DecorProviders *providers)
 
         // Display one line
         spellvars_T zero_spv = { 0 };
-        row = win_line(wp, lnum, srow, wp->w_grid.rows, false,
-                       foldinfo.fi_lines > 0 ? &zero_spv : &spv,
-                       foldinfo, &line_providers);
+        row = win_draw_line(wp, lnum, srow, wp->w_grid.rows, false,
+                            foldinfo.fi_lines > 0 ? &zero_spv : &spv,
+                            foldinfo, &line_providers);
 
         if (foldinfo.fi_lines == 0) {
           wp->w_lines[idx].wl_folded = false;
@@ -2316,12 +2494,13 @@ static void win_update(win_T *wp, DecorProviders *providers)
       idx++;
       lnum += foldinfo.fi_lines + 1;
     } else {
-      if (wp->w_p_rnu && wp->w_last_cursor_lnum_rnu != wp->w_cursor.lnum) {
-        // 'relativenumber' set and cursor moved vertically: The
-        // text doesn't need to be drawn, but the number column does.
+      if ((wp->w_p_rnu && wp->w_last_cursor_lnum_rnu != wp->w_cursor.lnum) || cul_nr_only) {
+        // 'relativenumber' set and cursor moved vertically, or the
+        // cursorline only highlights the number: The text doesn't need to
+        // be drawn, but the number column does.
         foldinfo_T info = wp->w_p_cul && lnum == wp->w_cursor.lnum
-                          ? cursorline_fi : fold_info(wp, lnum);
-        (void)win_line(wp, lnum, srow, wp->w_grid.rows, true, &spv, info, &line_providers);
+                          ? cursorline_fi : win_fold_info(wp, lnum);
+        (void)win_draw_line(wp, lnum, srow, wp->w_grid.rows, true, &spv, info, &line_providers);
       }
 
       // This line does not need to be drawn, advance to the next one.
@@ -2343,7 +2522,7 @@ static void win_update(win_T *wp, DecorProviders *providers)
       wp->w_lines_valid = 0;
       wp->w_valid &= ~VALID_WCOL;
       decor_redraw_reset(wp, &decor_state);
-      decor_providers_invoke_win(wp, providers, &line_providers);
+      win_invoke_providers(wp, providers, &line_providers);
       continue;
     }
 
@@ -2417,8 +2596,8 @@ static void win_update(win_T *wp, DecorProviders *providers)
         // for ml_line_count+1 and only draw filler lines
         spellvars_T zero_spv = { 0 };
         foldinfo_T zero_foldinfo = { 0 };
-        row = win_line(wp, wp->w_botline, row, wp->w_grid.rows, false, &zero_spv,
-                       zero_foldinfo, &line_providers);
+        row = win_draw_line(wp, wp->w_botline, row, wp->w_grid.rows, false, &zero_spv,
+                            zero_foldinfo, &line_providers);
       }
     } else if (dollar_vcol == -1) {
       wp->w_botline = lnum;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "nvim/buffer_defs.h"
 #include "nvim/macros_defs.h"
@@ -17,6 +18,26 @@ enum {
   UPD_CLEAR        = 50,  ///< screen messed up, clear it
 };
 
+/// Phases of a redraw that are timed for nvim__redraw_stats() and ":profile redraw".
+typedef enum {
+  kRedrawScreen = 0,  ///< update_screen()
+  kRedrawWindow,      ///< win_update(), including the phases below
+  kRedrawLine,        ///< win_line(), with syntax, spell and extmark highlighting
+  kRedrawFold,        ///< fold_info() for the lines in win_update()
+  kRedrawProviders,   ///< on_win and on_range decoration provider callbacks
+  kRedrawStatus,      ///< status lines and window bars
+  kRedrawTabline,     ///< draw_tabline()
+} RedrawPhase;
+
+enum { kRedrawPhaseCount = kRedrawTabline + 1, };
+
+typedef struct {
+  int64_t count;  ///< number of times the phase ran
+  uint64_t time;  ///< total time in nanoseconds
+} RedrawTiming;
+
+EXTERN RedrawTiming redraw_stats[kRedrawPhaseCount] INIT( = { 0 });
+
 /// While redrawing the screen this flag is set.  It means the screen size
 /// ('lines' and 'rows') must not be changed.
 EXTERN bool updating_screen INIT( = 0);
@@ -1303,17 +1303,19 @@ void ins_redraw(bool ready)
       && (last_cursormoved_win != curwin
           || !equalpos(last_cursormoved, curwin->w_cursor))
       && !pum_visible()) {
-    // Need to update the screen first, to make sure syntax
-    // highlighting is correct after making a change (e.g., inserting
-    // a "(".  The autocommand may also require a redraw, so it's done
-    // again below, unfortunately.
-    if (syntax_present(curwin) && must_redraw) {
-      update_screen();
-    }
-    // Make sure curswant is correct, an autocommand may call
-    // getcurpos()
-    update_curswant();
-    ins_apply_autocmds(EVENT_CURSORMOVEDI);
+    if (has_event_buf(EVENT_CURSORMOVEDI, curbuf)) {
+      // Need to update the screen first, to make sure syntax
+      // highlighting is correct after making a change (e.g., inserting
+      // a "(".  The autocommand may also require a redraw, so it's done
+      // again below, unfortunately.
+      if (syntax_present(curwin) && must_redraw) {
+        update_screen();
+      }
+      // Make sure curswant is correct, an autocommand may call
+      // getcurpos()
+      update_curswant();
+      ins_apply_autocmds(EVENT_CURSORMOVEDI);
+    }
     last_cursormoved_win = curwin;
     last_cursormoved = curwin->w_cursor;
   }
@@ -1322,18 +1324,20 @@ void ins_redraw(bool ready)
   if (ready && has_event(EVENT_TEXTCHANGEDI)
       && curbuf->b_last_changedtick_i != buf_get_changedtick(curbuf)
       && !pum_visible()) {
-    aco_save_T aco;
-    varnumber_T tick = buf_get_changedtick(curbuf);
-
-    // save and restore curwin and curbuf, in case the autocmd changes them
-    aucmd_prepbuf(&aco, curbuf);
-    apply_autocmds(EVENT_TEXTCHANGEDI, NULL, NULL, false, curbuf);
-    aucmd_restbuf(&aco);
-    curbuf->b_last_changedtick_i = buf_get_changedtick(curbuf);
-    if (tick != buf_get_changedtick(curbuf)) {  // see ins_apply_autocmds()
-      u_save(curwin->w_cursor.lnum,
-             (linenr_T)(curwin->w_cursor.lnum + 1));
+    if (has_event_buf(EVENT_TEXTCHANGEDI, curbuf)) {
+      aco_save_T aco;
+      varnumber_T tick = buf_get_changedtick(curbuf);
+
+      // save and restore curwin and curbuf, in case the autocmd changes them
+      aucmd_prepbuf(&aco, curbuf);
+      apply_autocmds(EVENT_TEXTCHANGEDI, NULL, NULL, false, curbuf);
+      aucmd_restbuf(&aco);
+      if (tick != buf_get_changedtick(curbuf)) {  // see ins_apply_autocmds()
+        u_save(curwin->w_cursor.lnum,
+               (linenr_T)(curwin->w_cursor.lnum + 1));
+      }
     }
+    curbuf->b_last_changedtick_i = buf_get_changedtick(curbuf);
   }
 
   // Trigger TextChangedP if changedtick_pum differs. When the popupmenu
@@ -1342,18 +1346,20 @@ void ins_redraw(bool ready)
   if (ready && has_event(EVENT_TEXTCHANGEDP)
       && curbuf->b_last_changedtick_pum != buf_get_changedtick(curbuf)
       && pum_visible()) {
-    aco_save_T aco;
-    varnumber_T tick = buf_get_changedtick(curbuf);
-
-    // save and restore curwin and curbuf, in case the autocmd changes them
-    aucmd_prepbuf(&aco, curbuf);
-    apply_autocmds(EVENT_TEXTCHANGEDP, NULL, NULL, false, curbuf);
-    aucmd_restbuf(&aco);
-    curbuf->b_last_changedtick_pum = buf_get_changedtick(curbuf);
-    if (tick != buf_get_changedtick(curbuf)) {  // see ins_apply_autocmds()
-      u_save(curwin->w_cursor.lnum,
-             (linenr_T)(curwin->w_cursor.lnum + 1));
+    if (has_event_buf(EVENT_TEXTCHANGEDP, curbuf)) {
+      aco_save_T aco;
+      varnumber_T tick = buf_get_changedtick(curbuf);
+
+      // save and restore curwin and curbuf, in case the autocmd changes them
+      aucmd_prepbuf(&aco, curbuf);
+      apply_autocmds(EVENT_TEXTCHANGEDP, NULL, NULL, false, curbuf);
+      aucmd_restbuf(&aco);
+      if (tick != buf_get_changedtick(curbuf)) {  // see ins_apply_autocmds()
+        u_save(curwin->w_cursor.lnum,
+               (linenr_T)(curwin->w_cursor.lnum + 1));
+      }
     }
+    curbuf->b_last_changedtick_pum = buf_get_changedtick(curbuf);
   }
 
   if (ready) {
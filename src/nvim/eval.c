@@ -47,6 +47,7 @@
 #include "nvim/insexpand.h"
 #include "nvim/keycodes.h"
 #include "nvim/lib/queue.h"
+#include "nvim/log.h"
 #include "nvim/lua/executor.h"
 #include "nvim/macros_defs.h"
 #include "nvim/main.h"
@@ -90,6 +91,7 @@
 #define DICT_MAXNEST 100        // maximum nesting of lists and dicts
 
 #define MAX_CALLBACK_DEPTH 20
+#define GC_IDLE_RATIO 8  // collect when idle after allocating 1/8 of the old values
 
 static const char *e_missbrac = N_("E111: Missing ']'");
 static const char *e_list_end = N_("E697: Missing end of List ']': %s");
@@ -1012,7 +1014,14 @@ char *eval_to_string_safe(char *arg, const bool use_sandbox)
     sandbox++;
   }
   textlock++;
-  retval = eval_to_string(arg, false);
+  typval_T tv;
+  int r = may_call_simple_func(arg, &tv);
+  if (r == NOTDONE) {
+    retval = eval_to_string(arg, false);
+  } else {
+    retval = r == OK ? typval2string(&tv, false) : NULL;
+    tv_clear(&tv);
+  }
   if (use_sandbox) {
     sandbox--;
   }
@@ -1021,11 +1030,40 @@ char *eval_to_string_safe(char *arg, const bool use_sandbox)
   return retval;
 }
 
+/// Evaluates "arg" when it is a simple function call, "FuncName()" without
+/// arguments, by calling the function directly.  This is the usual form of
+/// 'foldexpr', 'indentexpr' and similar options, and skips parsing the
+/// expression each time.
+///
+/// @return  NOTDONE when "arg" is not a simple call of a user function, then
+///          it must be evaluated as usual.
+int may_call_simple_func(const char *arg, typval_T *rettv)
+  FUNC_ATTR_NONNULL_ALL
+{
+  arg = skipwhite(arg);
+  const char *parens = strstr(arg, "()");
+  if (parens == NULL || *skipwhite(parens + 2) != NUL) {
+    return NOTDONE;
+  }
+  // Skip "<SID>", "<SNR>" or "s:", a name after "<SNR>" starts with digits.
+  int off = eval_fname_script(arg);
+  const char *p = arg + off;
+  if (p == parens || (off == 0 && !eval_isnamec1(*p))
+      || find_name_end(p, NULL, NULL, 0) != parens
+      || memchr(p, '{', (size_t)(parens - p)) != NULL) {
+    return NOTDONE;
+  }
+  return call_simple_func(arg, (size_t)(parens - arg), rettv);
+}
+
 /// Top level evaluation function, returning a number.
 /// Evaluates "expr" silently.
 ///
+/// @param use_simple_function  call "expr" directly when it is "FuncName()",
+///                             see may_call_simple_func()
+///
 /// @return  -1 for an error.
-varnumber_T eval_to_number(char *expr)
+varnumber_T eval_to_number(char *expr, bool use_simple_function)
 {
   typval_T rettv;
   varnumber_T retval;
@@ -1033,7 +1071,11 @@ varnumber_T eval_to_number(char *expr)
 
   emsg_off++;
 
-  if (eval1(&p, &rettv, &EVALARG_EVALUATE) == FAIL) {
+  int r = use_simple_function ? may_call_simple_func(p, &rettv) : NOTDONE;
+  if (r == NOTDONE) {
+    r = eval1(&p, &rettv, &EVALARG_EVALUATE);
+  }
+  if (r == FAIL) {
     retval = -1;
   } else {
     retval = tv_get_number_chk(&rettv, NULL);
@@ -1292,7 +1334,11 @@ int eval_foldexpr(win_T *wp, int *cp)
 
   typval_T tv;
   varnumber_T retval;
-  if (eval0(arg, &tv, NULL, &EVALARG_EVALUATE) == FAIL) {
+  int r = may_call_simple_func(arg, &tv);
+  if (r == NOTDONE) {
+    r = eval0(arg, &tv, NULL, &EVALARG_EVALUATE);
+  }
+  if (r == FAIL) {
     retval = 0;
   } else {
     // If the result is a number, just return the number.
@@ -2289,6 +2335,10 @@ static int eval_func(char **const arg, evalarg_T *const evalarg, char *const nam
   funcexe.fe_partial = partial;
   funcexe.fe_basetv = basetv;
   funcexe.fe_found_var = found_var;
+  if (evaluate && partial == NULL) {
+    // Look up a builtin function only once, not again when calling it.
+    funcexe.fe_builtin = find_builtin_func(s, len);
+  }
   int ret = get_func_tv(s, len, rettv, arg, evalarg, &funcexe);
 
   xfree(s);
@@ -2849,10 +2899,19 @@ static int eval5(char **arg, typval_T *rettv, evalarg_T *const evalarg)
           tv_clear(&var2);
           return FAIL;
         }
-        char *p = concat_str(s1, s2);
-        tv_clear(rettv);
-        rettv->v_type = VAR_STRING;
-        rettv->vval.v_string = p;
+        if (rettv->v_type == VAR_STRING && rettv->vval.v_string != NULL) {
+          // The left side is a temporary string owned by "rettv": append to
+          // it instead of copying it for each ".." in a chain.
+          const size_t len1 = strlen(s1);
+          const size_t len2 = strlen(s2);
+          rettv->vval.v_string = xrealloc(rettv->vval.v_string, len1 + len2 + 1);
+          memcpy(rettv->vval.v_string + len1, s2, len2 + 1);
+        } else {
+          char *p = concat_str(s1, s2);
+          tv_clear(rettv);
+          rettv->v_type = VAR_STRING;
+          rettv->vval.v_string = p;
+        }
       } else if (op == '+' && rettv->v_type == VAR_BLOB && var2.v_type == VAR_BLOB) {
         eval_addblob(rettv, &var2);
       } else if (op == '+' && rettv->v_type == VAR_LIST && var2.v_type == VAR_LIST) {
@@ -3734,7 +3793,16 @@ static int eval_index_inner(typval_T *rettv, bool is_range, typval_T *var1, typv
       }
     }
 
-    dictitem_T *const item = tv_dict_find(rettv->vval.v_dict, key, keylen);
+    dictitem_T *item;
+    if (keylen >= 0 && rettv->vval.v_dict != NULL) {
+      // "dict.key": the key is in the expression text, which is evaluated
+      // again for every call of a function.
+      hashitem_T *const hi = hash_find_cached(&rettv->vval.v_dict->dv_hashtab, key,
+                                              (size_t)keylen);
+      item = HASHITEM_EMPTY(hi) ? NULL : TV_DICT_HI2DI(hi);
+    } else {
+      item = tv_dict_find(rettv->vval.v_dict, key, keylen);
+    }
 
     if (item == NULL && verbose) {
       if (keylen > 0) {
@@ -4417,6 +4485,7 @@ bool garbage_collect(bool testing)
   // We advance by two (COPYID_INC) because we add one for items referenced
   // through previous_funccal.
   const int copyID = get_copyID();
+  NVIM_PROBE(gc_mark_begin, 1, copyID);
 
   // 1. Go through all accessible variables and mark all lists and dicts
   // with copyID.
@@ -4579,6 +4648,7 @@ bool garbage_collect(bool testing)
   ABORTING(set_ref_in_quickfix)(copyID);
 
   bool did_free = false;
+  NVIM_PROBE(gc_free_begin, 2, copyID, abort);
   if (!abort) {
     // 2. Free lists and dictionaries that are not referenced.
     did_free = free_unref_items(copyID);
@@ -4590,9 +4660,25 @@ bool garbage_collect(bool testing)
     verb_msg(_("Not enough memory to set references, garbage collection aborted!"));
   }
 #undef ABORTING
+  gc_young_count = 0;
+  gc_old_count = gc_container_count;
+  NVIM_PROBE(gc_end, 2, copyID, did_free);
   return did_free;
 }
 
+/// Check if garbage collection is worth it when waiting for a character.
+///
+/// Lists and dicts are freed by reference counting, garbage collection only
+/// finds reference cycles.  These are mostly made from lists, dicts and
+/// closures created since the last collection, so it is skipped until the
+/// number of them is a part of what was left after the last collection.
+/// That keeps the time spent in the mark phase in proportion to the
+/// allocations, instead of walking a big heap of old values every time.
+bool garbage_collect_when_idle(void)
+{
+  return gc_young_count > 0 && gc_young_count * GC_IDLE_RATIO >= gc_old_count;
+}
+
 /// Free lists and dictionaries that are no longer referenced.
 ///
 /// @note  This function may only be called from garbage_collect().
@@ -5883,14 +5969,22 @@ void get_xdg_var_list(const XDGVarType xdg, typval_T *rettv)
   xfree(dirs);
 }
 
-static list_T *string_to_list(const char *str, size_t len, const bool keepempty)
+/// Output of systemlist(), lines are added to "list" as they are received.
+typedef struct {
+  list_T *list;
+  size_t len;  ///< Number of bytes received
+  char last;   ///< Last byte received
+} SystemListOutput;
+
+/// ShellOutputCb for systemlist().
+static int system_list_write(void *data, const char *buf, size_t len)
 {
-  if (!keepempty && str[len - 1] == NL) {
-    len--;
+  SystemListOutput *out = data;
+  if (len > 0) {
+    out->len += len;
+    out->last = buf[len - 1];
   }
-  list_T *const list = tv_list_alloc(kListLenMayKnow);
-  encode_list_write(list, str, len);
-  return list;
+  return encode_list_write(out->list, buf, len);
 }
 
 /// os_system wrapper. Handles 'verbose', :profile, and v:shell_error.
@@ -5938,10 +6032,17 @@ void get_system_output_as_rettv(typval_T *argvars, typval_T *rettv, bool retlist
     prof_child_enter(&wait_time);
   }
 
-  // execute the command
+  // execute the command, systemlist() gets the lines as they are received
   size_t nread = 0;
   char *res = NULL;
-  int status = os_system(argv, input, (size_t)input_len, &res, &nread);
+  SystemListOutput out = { .list = NULL };
+  int status;
+  if (retlist) {
+    out.list = tv_list_alloc(kListLenUnknown);
+    status = os_system_stream(argv, input, (size_t)input_len, system_list_write, &out);
+  } else {
+    status = os_system(argv, input, (size_t)input_len, &res, &nread);
+  }
 
   if (profiling) {
     prof_child_exit(&wait_time);
@@ -5951,26 +6052,27 @@ void get_system_output_as_rettv(typval_T *argvars, typval_T *rettv, bool retlist
 
   set_vim_var_nr(VV_SHELL_ERROR, status);
 
-  if (res == NULL) {
-    if (retlist) {
-      // return an empty list when there's no output
-      tv_list_alloc_ret(rettv, 0);
-    } else {
-      rettv->vval.v_string = xstrdup("");
-    }
-    return;
-  }
-
   if (retlist) {
     int keepempty = 0;
     if (argvars[1].v_type != VAR_UNKNOWN && argvars[2].v_type != VAR_UNKNOWN) {
       keepempty = (int)tv_get_number(&argvars[2]);
     }
-    rettv->vval.v_list = string_to_list(res, nread, (bool)keepempty);
+    // Without "keepempty" a trailing NL doesn't start another line, and
+    // output that is only a NL gives an empty list.
+    if (!keepempty && out.len > 0 && out.last == NL) {
+      tv_list_item_remove(out.list, tv_list_last(out.list));
+      if (out.len == 1) {
+        tv_list_item_remove(out.list, tv_list_last(out.list));
+      }
+    }
+    rettv->vval.v_list = out.list;
     tv_list_ref(rettv->vval.v_list);
     rettv->v_type = VAR_LIST;
+    return;
+  }
 
-    xfree(res);
+  if (res == NULL) {
+    rettv->vval.v_string = xstrdup("");
   } else {
     // res may contain several NULs before the final terminating one.
     // Replace them with SOH (1) like in get_cmd_output() to avoid truncation.
@@ -7712,7 +7814,7 @@ dictitem_T *find_var_in_ht(hashtab_T *const ht, int htname, const char *const va
     return NULL;
   }
 
-  hashitem_T *hi = hash_find_len(ht, varname, varname_len);
+  hashitem_T *hi = hash_find_cached(ht, varname, varname_len);
   if (HASHITEM_EMPTY(hi)) {
     // For global variables we may try auto-loading the script.  If it
     // worked find the variable again.  Don't auto-load a script if it was
@@ -8722,6 +8824,8 @@ bool common_job_callbacks(dict_T *vopts, CallbackReader *on_stdout, CallbackRead
       && tv_dict_get_callback(vopts, S_LEN("on_exit"), on_exit)) {
     on_stdout->buffered = tv_dict_get_number(vopts, "stdout_buffered");
     on_stderr->buffered = tv_dict_get_number(vopts, "stderr_buffered");
+    on_stdout->lines = tv_dict_get_number(vopts, "stdout_lines");
+    on_stderr->lines = tv_dict_get_number(vopts, "stderr_lines");
     if (on_stdout->buffered && on_stdout->cb.type == kCallbackNone) {
       on_stdout->self = vopts;
     }
@@ -295,6 +295,24 @@ typval_T decode_string(const char *const s, const size_t len, const TriState has
   };
 }
 
+/// Check if the eight bytes at "p" may contain a character that needs a closer
+/// look inside a JSON string: a control character, '"', '\\' or a non-ASCII
+/// byte.  Can't give false negatives, so when it returns false all eight bytes
+/// are plain ASCII.
+static inline bool json_word_has_special(const char *const p)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE FUNC_ATTR_ALWAYS_INLINE
+{
+  const uint64_t ones = UINT64_C(0x0101010101010101);
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  // A byte is below 0x20, or is zero after the xor, when subtracting from it
+  // borrows into its high bit while the byte itself had that bit clear.
+  const uint64_t special = (v - ones * 0x20)
+                           | ((v ^ (ones * '"')) - ones)
+                           | ((v ^ (ones * '\\')) - ones);
+  return ((special & ~v) | v) & (ones * 0x80);
+}
+
 /// Parse JSON double-quoted string
 ///
 /// @param[in]  buf  Buffer being converted.
@@ -324,9 +342,19 @@ static inline int parse_json_string(const char *const buf, const size_t buf_len,
   const char *p = *pp;
   size_t len = 0;
   const char *const s = ++p;
+  const char *first_escape = NULL;
   int ret = OK;
   while (p < e && *p != '"') {
+    // Skip plain ASCII characters eight at a time.
+    if (e - p >= 8 && !json_word_has_special(p)) {
+      len += 8;
+      p += 8;
+      continue;
+    }
     if (*p == '\\') {
+      if (first_escape == NULL) {
+        first_escape = p;
+      }
       p++;
       if (p == e) {
         semsg(_("E474: Unfinished escape sequence: %.*s"),
@@ -374,6 +402,10 @@ static inline int parse_json_string(const char *const buf, const size_t buf_len,
         semsg(_("E474: ASCII control characters cannot be present "
                 "inside string: %.*s"), LENP(p, e));
         goto parse_json_string_fail;
+      } else if (p_byte < 0x80) {
+        len++;
+        p++;
+        continue;
       }
       const int ch = utf_ptr2char(p);
       // All characters above U+007F are encoded using two or more bytes
@@ -403,7 +435,10 @@ static inline int parse_json_string(const char *const buf, const size_t buf_len,
   }
   char *str = xmalloc(len + 1);
   int fst_in_pair = 0;
-  char *str_end = str;
+  // Copy the text before the first escape sequence as it is.
+  const char *const plain_end = first_escape != NULL ? first_escape : p;
+  memcpy(str, s, (size_t)(plain_end - s));
+  char *str_end = str + (plain_end - s);
   bool hasnul = false;
 #define PUT_FST_IN_PAIR(fst_in_pair, str_end) \
   do { \
@@ -412,7 +447,7 @@ static inline int parse_json_string(const char *const buf, const size_t buf_len,
       (fst_in_pair) = 0; \
     } \
   } while (0)
-  for (const char *t = s; t < p; t++) {
+  for (const char *t = plain_end; t < p; t++) {
     if (t[0] != '\\' || t[1] != 'u') {
       PUT_FST_IN_PAIR(fst_in_pair, str_end);
     }
@@ -574,6 +574,32 @@ int encode_read_from_list(ListReaderState *const state, char *const buf, const s
     } \
   } while (0)
 
+/// Size of the chunks encode_json_write() hands to its writer.
+enum { JSON_STREAM_CHUNK = 64 * 1024, };
+
+/// State of encode_json_write(), NULL when encoding into a string.
+typedef struct {
+  EncodeWriter write;  ///< Callback receiving the encoded text.
+  void *data;  ///< First argument to write().
+  int ret;  ///< FAIL once write() has failed.
+} JSONStream;
+
+static JSONStream *json_stream = NULL;
+
+/// Pass the text encoded so far to the writer of encode_json_write() once it
+/// fills a chunk, so that the whole value is never held in memory.
+static inline void json_stream_flush(garray_T *const gap)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_ALWAYS_INLINE
+{
+  if (json_stream == NULL || gap->ga_len < JSON_STREAM_CHUNK) {
+    return;
+  }
+  if (json_stream->ret == OK) {
+    json_stream->ret = json_stream->write(json_stream->data, gap->ga_data, (size_t)gap->ga_len);
+  }
+  gap->ga_len = 0;
+}
+
 /// Escape sequences used in JSON
 static const char escapes[][3] = {
   [BS] = "\\b",
@@ -652,8 +678,12 @@ static inline int convert_to_json_string(garray_T *const gap, const char *const
       }
     }
     ga_append(gap, '"');
-    ga_grow(gap, (int)str_len);
+    if (json_stream == NULL) {
+      ga_grow(gap, (int)str_len);
+    }
     for (size_t i = 0; i < utf_len;) {
+      // A long string is written in chunks too.
+      json_stream_flush(gap);
       const int ch = utf_ptr2char(utf_buf + i);
       const size_t shift = (ch == 0 ? 1 : ((size_t)utf_char2len(ch)));
       assert(shift > 0);
@@ -735,6 +765,7 @@ static inline int convert_to_json_string(garray_T *const gap, const char *const
       char numbuf[NUMBUFLEN]; \
       for (int i_ = 0; i_ < len_; i_++) { \
         if (i_ > 0) { \
+          json_stream_flush(gap); \
           ga_concat(gap, ", "); \
         } \
         vim_snprintf((char *)numbuf, ARRAY_SIZE(numbuf), "%d", \
@@ -788,6 +819,14 @@ bool encode_check_json_key(const typval_T *const tv)
   return true;
 }
 
+// Also used between list items, see TYPVAL_ENCODE_CONV_LIST_BETWEEN_ITEMS.
+#undef TYPVAL_ENCODE_CONV_DICT_BETWEEN_ITEMS
+#define TYPVAL_ENCODE_CONV_DICT_BETWEEN_ITEMS(tv, dict) \
+  do { \
+    json_stream_flush(gap); \
+    ga_concat(gap, ", "); \
+  } while (0)
+
 #undef TYPVAL_ENCODE_SPECIAL_DICT_KEY_CHECK
 #define TYPVAL_ENCODE_SPECIAL_DICT_KEY_CHECK(label, key) \
   do { \
@@ -912,6 +951,36 @@ char *encode_tv2json(typval_T *tv, size_t *len)
   return (char *)ga.ga_data;
 }
 
+/// Write the JSON representation of a variable in chunks
+///
+/// Like encode_tv2json(), but the text is handed to `write` a chunk at a time
+/// instead of being collected into one string. Chunks already written are not
+/// taken back when encoding fails later.
+///
+/// @param[in]  tv  typval_T to convert.
+/// @param[in]  write  Callback receiving the text, returns OK or FAIL.
+/// @param[in]  data  First argument to write().
+/// @param[in]  objname  Object name, used for error message.
+///
+/// @return OK in case of success, FAIL otherwise.
+int encode_json_write(typval_T *tv, EncodeWriter write, void *data, const char *objname)
+  FUNC_ATTR_NONNULL_ARG(1, 2, 4)
+{
+  garray_T ga;
+  ga_init(&ga, (int)sizeof(char), JSON_STREAM_CHUNK);
+  JSONStream stream = { .write = write, .data = data, .ret = OK };
+  JSONStream *const save_stream = json_stream;
+  json_stream = &stream;
+  int ret = encode_vim_to_json(&ga, tv, objname);
+  json_stream = save_stream;
+  did_echo_string_emsg = false;
+  if (ret == OK && stream.ret == OK && ga.ga_len > 0) {
+    stream.ret = write(data, ga.ga_data, (size_t)ga.ga_len);
+  }
+  ga_clear(&ga);
+  return ret == OK ? stream.ret : FAIL;
+}
+
 #define TYPVAL_ENCODE_CONV_STRING(tv, buf, len) \
   do { \
     if ((buf) == NULL) { \
@@ -18,6 +18,11 @@
 /// @return OK in case of success, FAIL otherwise.
 int encode_vim_to_msgpack(msgpack_packer *packer, typval_T *tv, const char *objname);
 
+/// Callback receiving encoded text, see encode_json_write()
+///
+/// @return OK in case of success, FAIL otherwise.
+typedef int (*EncodeWriter)(void *data, const char *buf, size_t len);
+
 /// Convert Vimscript value to :echo output
 ///
 /// @param[out]  packer  Packer to save results in.
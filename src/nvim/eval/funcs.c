@@ -225,7 +225,13 @@ char *get_expr_name(expand_T *xp, int idx)
 const EvalFuncDef *find_internal_func(const char *const name)
   FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_PURE FUNC_ATTR_NONNULL_ALL
 {
-  size_t len = strlen(name);
+  return find_internal_func_len(name, strlen(name));
+}
+
+/// Like find_internal_func(), but name is not NUL-terminated
+const EvalFuncDef *find_internal_func_len(const char *const name, const size_t len)
+  FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_PURE FUNC_ATTR_NONNULL_ALL
+{
   int index = find_internal_func_hash(name, len);
   return index >= 0 ? &functions[index] : NULL;
 }
@@ -255,11 +261,11 @@ int check_internal_func(const EvalFuncDef *const fdef, const int argcount)
   return -1;
 }
 
-int call_internal_func(const char *const fname, const int argcount, typval_T *const argvars,
+/// Invoke builtin function "fdef", which is NULL for an unknown function.
+int call_internal_func(const EvalFuncDef *const fdef, const int argcount, typval_T *const argvars,
                        typval_T *const rettv)
-  FUNC_ATTR_NONNULL_ALL
+  FUNC_ATTR_NONNULL_ARG(3, 4)
 {
-  const EvalFuncDef *const fdef = find_internal_func(fname);
   if (fdef == NULL) {
     return FCERR_UNKNOWN;
   } else if (argcount < fdef->min_argc) {
@@ -273,11 +279,10 @@ int call_internal_func(const char *const fname, const int argcount, typval_T *co
 }
 
 /// Invoke a method for base->method().
-int call_internal_method(const char *const fname, const int argcount, typval_T *const argvars,
-                         typval_T *const rettv, typval_T *const basetv)
-  FUNC_ATTR_NONNULL_ALL
+int call_internal_method(const EvalFuncDef *const fdef, const int argcount,
+                         typval_T *const argvars, typval_T *const rettv, typval_T *const basetv)
+  FUNC_ATTR_NONNULL_ARG(3, 4, 5)
 {
-  const EvalFuncDef *const fdef = find_internal_func(fname);
   if (fdef == NULL) {
     return FCERR_UNKNOWN;
   } else if (fdef->base_arg == BASE_NONE) {
@@ -624,6 +629,22 @@ static void f_chanclose(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   }
 }
 
+/// State of chansend() writing a Dictionary as JSON.
+typedef struct {
+  uint64_t id;  ///< Channel written to.
+  size_t written;  ///< Number of bytes written so far.
+  const char *error;  ///< Error message of the failed write.
+} ChanSendJSON;
+
+/// Writer for encode_json_write() sending each chunk to the channel.
+static int chansend_json_write(void *data, const char *buf, size_t len)
+{
+  ChanSendJSON *const state = data;
+  size_t written = channel_send(state->id, (char *)buf, len, false, &state->error);
+  state->written += written;
+  return state->error == NULL ? OK : FAIL;
+}
+
 /// "chansend(id, data)" function
 static void f_chansend(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
 {
@@ -650,7 +671,18 @@ static void f_chansend(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   bool crlf = (chan != NULL && chan->term) ? true : false;
 #endif
 
-  if (argvars[1].v_type == VAR_BLOB) {
+  if (argvars[1].v_type == VAR_DICT) {
+    // Encode straight into the channel, without building the whole string.
+    ChanSendJSON state = { .id = id, .written = 0, .error = NULL };
+    if (encode_json_write(&argvars[1], chansend_json_write, &state,
+                          N_("chansend() argument")) == OK) {
+      rettv->vval.v_number = (varnumber_T)state.written;
+    }
+    if (state.error) {
+      emsg(state.error);
+    }
+    return;
+  } else if (argvars[1].v_type == VAR_BLOB) {
     const blob_T *const b = argvars[1].vval.v_blob;
     input_len = tv_blob_len(b);
     if (input_len > 0) {
@@ -4052,6 +4084,7 @@ static void f_jobstart(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   bool pty = false;
   bool clear_env = false;
   bool overlapped = false;
+  int pool = 0;
   ChannelStdinMode stdin_mode = kChannelStdinPipe;
   CallbackReader on_stdout = CALLBACK_READER_INIT;
   CallbackReader on_stderr = CALLBACK_READER_INIT;
@@ -4066,6 +4099,7 @@ static void f_jobstart(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
     pty = tv_dict_get_number(job_opts, "pty") != 0;
     clear_env = tv_dict_get_number(job_opts, "clear_env") != 0;
     overlapped = tv_dict_get_number(job_opts, "overlapped") != 0;
+    pool = (int)tv_dict_get_number(job_opts, "pool");
 
     char *s = tv_dict_get_string(job_opts, "stdin", false);
     if (s) {
@@ -4084,6 +4118,12 @@ static void f_jobstart(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
       return;
     }
 
+    if (pool > 0 && !rpc) {
+      semsg(_(e_invarg2), "job can only have the 'pool' option with 'rpc'");
+      shell_free_argv(argv);
+      return;
+    }
+
 #ifdef MSWIN
     if (pty && overlapped) {
       semsg(_(e_invarg2),
@@ -4132,14 +4172,60 @@ static void f_jobstart(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
     }
   }
 
+  char *pool_key = NULL;
+  if (pool > 0) {
+    pool_key = job_pool_key(argv, cwd, job_env, clear_env, detach,
+                            callback_reader_set(on_stderr));
+    Channel *chan = channel_job_pool_take(pool_key, on_stderr, on_exit);
+    if (chan) {
+      xfree(pool_key);
+      shell_free_argv(argv);
+      rettv->vval.v_number = (varnumber_T)chan->id;
+      return;
+    }
+  }
+
   env = create_environment(job_env, clear_env, pty, term_name);
 
   Channel *chan = channel_job_start(argv, NULL, on_stdout, on_stderr, on_exit, pty,
                                     rpc, overlapped, detach, stdin_mode, cwd,
                                     width, height, env, &rettv->vval.v_number);
   if (chan) {
+    chan->pool_key = pool_key;
+    chan->pool_timeout = pool;
     channel_create_event(chan, NULL);
+  } else {
+    xfree(pool_key);
+  }
+}
+
+/// Key of a jobstart() with the "pool" option: a pooled job is only reused
+/// by a jobstart() that would start the same process.
+static char *job_pool_key(char **argv, const char *cwd, dictitem_T *job_env, bool clear_env,
+                          bool detach, bool has_err)
+{
+  garray_T ga;
+  ga_init(&ga, 1, 80);
+  for (char **p = argv; *p != NULL; p++) {
+    ga_concat(&ga, *p);
+    ga_append(&ga, NL);
+  }
+  if (cwd == NULL && os_dirname(NameBuff, MAXPATHL) == OK) {
+    cwd = NameBuff;
+  }
+  ga_concat(&ga, cwd != NULL ? cwd : "");
+  ga_append(&ga, NL);
+  if (job_env != NULL) {
+    char *s = encode_tv2string(&job_env->di_tv, NULL);
+    ga_concat(&ga, s);
+    xfree(s);
   }
+  ga_append(&ga, NL);
+  ga_append(&ga, clear_env ? 'c' : '-');
+  ga_append(&ga, detach ? 'd' : '-');
+  ga_append(&ga, has_err ? 'e' : '-');
+  ga_append(&ga, NUL);
+  return ga.ga_data;
 }
 
 /// "jobstop()" function
@@ -4163,6 +4249,12 @@ static void f_jobstop(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
     return;
   }
 
+  if (channel_job_pool_put(data)) {
+    // Keep the job running, it is reused by a later jobstart().
+    rettv->vval.v_number = 1;
+    return;
+  }
+
   const char *error = NULL;
   if (data->is_rpc) {
     // Ignore return code, but show error later.
@@ -7790,6 +7882,7 @@ static void f_sockconnect(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
       return;
     }
     on_data.buffered = tv_dict_get_number(opts, "data_buffered");
+    on_data.lines = tv_dict_get_number(opts, "data_lines");
     if (on_data.buffered && on_data.cb.type == kCallbackNone) {
       on_data.self = opts;
     }
@@ -7826,6 +7919,7 @@ static void f_stdioopen(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   }
 
   on_stdin.buffered = tv_dict_get_number(opts, "stdin_buffered");
+  on_stdin.lines = tv_dict_get_number(opts, "stdin_lines");
   if (on_stdin.buffered && on_stdin.cb.type == kCallbackNone) {
     on_stdin.self = opts;
   }
@@ -102,6 +102,10 @@ bool tv_in_free_unref_items = false;
 
 #define DICT_MAXNEST 100
 
+/// Minimal number of items tv_list_find() walks over before it indexes the
+/// items of the list.
+enum { TV_LIST_INDEX_MIN_DIST = 32, };
+
 const char *const tv_empty_string = "";
 
 //{{{1 Lists
@@ -203,6 +207,8 @@ list_T *tv_list_alloc(const ptrdiff_t len)
   FUNC_ATTR_NONNULL_RET
 {
   list_T *const list = xcalloc(1, sizeof(list_T));
+  gc_container_count++;
+  gc_young_count++;
 
   // Prepend the list to the list of lists for garbage collection.
   if (gc_first_list != NULL) {
@@ -268,6 +274,7 @@ void tv_list_free_contents(list_T *const l)
   }
   l->lv_len = 0;
   l->lv_idx_item = NULL;
+  l->lv_items_len = 0;
   l->lv_last = NULL;
   assert(l->lv_watch == NULL);
 }
@@ -291,7 +298,9 @@ void tv_list_free_list(list_T *const l)
   }
 
   NLUA_CLEAR_REF(l->lua_table_ref);
+  xfree(l->lv_items);
   xfree(l);
+  gc_container_count--;
 }
 
 /// Free a list, including all items it points to
@@ -352,6 +361,7 @@ void tv_list_drop_items(list_T *const l, listitem_T *const item, listitem_T *con
     item->li_prev->li_next = item2->li_next;
   }
   l->lv_idx_item = NULL;
+  l->lv_items_len = 0;
 }
 
 /// Like tv_list_drop_items, but also frees all removed items
@@ -418,6 +428,7 @@ void tv_list_insert(list_T *const l, listitem_T *const ni, listitem_T *const ite
     }
     item->li_prev = ni;
     l->lv_len++;
+    l->lv_items_len = 0;
   }
 }
 
@@ -890,7 +901,8 @@ int tv_list_slice_or_index(list_T *list, bool range, varnumber_T n1_arg, varnumb
 }
 
 typedef struct {
-  char *s;
+  const char *s;
+  size_t len;
   char *tofree;
 } Join;
 
@@ -900,31 +912,47 @@ typedef struct {
 /// @param[in]  l  List to join.
 /// @param[in]  sep  Used separator.
 /// @param[in]  join_gap  Garray to keep each list item string.
+/// @param[in]  arena  Arena for the text of Number items.
 ///
 /// @return OK in case of success, FAIL otherwise.
 static int list_join_inner(garray_T *const gap, list_T *const l, const char *const sep,
-                           garray_T *const join_gap)
+                           garray_T *const join_gap, Arena *const arena)
   FUNC_ATTR_NONNULL_ALL
 {
   size_t sumlen = 0;
   bool first = true;
 
-  // Stringify each item in the list.
+  // Stringify each item in the list.  Strings are used as they are and
+  // Numbers go to the arena, only other items get their own allocation.
   TV_LIST_ITER(l, item, {
     if (got_int) {
       break;
     }
-    char *s;
+    const typval_T *const tv = TV_LIST_ITEM_TV(item);
+    const char *s;
     size_t len;
-    s = encode_tv2echo(TV_LIST_ITEM_TV(item), &len);
-    if (s == NULL) {
-      return FAIL;
+    char *tofree = NULL;
+    if (tv->v_type == VAR_STRING) {
+      s = tv->vval.v_string != NULL ? tv->vval.v_string : "";
+      len = strlen(s);
+    } else if (tv->v_type == VAR_NUMBER) {
+      char *const buf = arena_alloc(arena, NUMBUFLEN, false);
+      len = (size_t)vim_snprintf(buf, NUMBUFLEN, "%" PRIdVARNUMBER, tv->vval.v_number);
+      s = buf;
+    } else {
+      tofree = encode_tv2echo((typval_T *)tv, &len);
+      if (tofree == NULL) {
+        return FAIL;
+      }
+      s = tofree;
     }
 
     sumlen += len;
 
     Join *const p = GA_APPEND_VIA_PTR(Join, join_gap);
-    p->tofree = p->s = s;
+    p->s = s;
+    p->len = len;
+    p->tofree = tofree;
 
     line_breakcheck();
   });
@@ -944,9 +972,7 @@ static int list_join_inner(garray_T *const gap, list_T *const l, const char *con
     }
     const Join *const p = ((const Join *)join_gap->ga_data) + i;
 
-    if (p->s != NULL) {
-      ga_concat(gap, p->s);
-    }
+    ga_concat_len(gap, p->s, p->len);
     line_breakcheck();
   }
 
@@ -969,13 +995,15 @@ int tv_list_join(garray_T *const gap, list_T *const l, const char *const sep)
 
   garray_T join_ga;
   int retval;
+  Arena arena = ARENA_EMPTY;
 
   ga_init(&join_ga, (int)sizeof(Join), tv_list_len(l));
-  retval = list_join_inner(gap, l, sep, &join_ga);
+  retval = list_join_inner(gap, l, sep, &join_ga, &arena);
 
 #define FREE_JOIN_TOFREE(join) xfree((join)->tofree)
   GA_DEEP_CLEAR(&join_ga, Join, FREE_JOIN_TOFREE);
 #undef FREE_JOIN_TOFREE
+  arena_mem_free(arena_finish(&arena));
 
   return retval;
 }
@@ -1288,6 +1316,7 @@ static void do_sort(list_T *l, sortinfo_T *info)
     l->lv_first = NULL;
     l->lv_last = NULL;
     l->lv_idx_item = NULL;
+    l->lv_items_len = 0;
     l->lv_len = 0;
     for (i = 0; i < len; i++) {
       tv_list_append(l, ptrs[i].item);
@@ -1514,10 +1543,30 @@ void tv_list_reverse(list_T *const l)
 #undef SWAP
 
   l->lv_idx = l->lv_len - l->lv_idx - 1;
+  l->lv_items_len = 0;
 }
 
 //{{{2 Indexing/searching
 
+/// Add the items after the first "lv_items_len" ones to "lv_items".
+///
+/// Appending items keeps "lv_items" valid, any other change of the list
+/// structure sets "lv_items_len" to zero.
+static void tv_list_index_items(list_T *const l)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (l->lv_items_size < l->lv_len) {
+    l->lv_items_size = MAX(l->lv_len, l->lv_items_size * 2);
+    l->lv_items = xrealloc(l->lv_items, (size_t)l->lv_items_size * sizeof(*l->lv_items));
+  }
+  int idx = l->lv_items_len;
+  for (listitem_T *item = idx == 0 ? l->lv_first : l->lv_items[idx - 1]->li_next;
+       item != NULL; item = item->li_next) {
+    l->lv_items[idx++] = item;
+  }
+  l->lv_items_len = idx;
+}
+
 /// Locate item with a given index in a list and return it
 ///
 /// @param[in]  l  List to index.
@@ -1526,7 +1575,7 @@ void tv_list_reverse(list_T *const l)
 ///
 /// @return Item at the given index or NULL if `n` is out of range.
 listitem_T *tv_list_find(list_T *const l, int n)
-  FUNC_ATTR_PURE FUNC_ATTR_WARN_UNUSED_RESULT
+  FUNC_ATTR_WARN_UNUSED_RESULT
 {
   STATIC_ASSERT(sizeof(n) == sizeof(l->lv_idx),
                 "n and lv_idx sizes do not match");
@@ -1539,6 +1588,10 @@ listitem_T *tv_list_find(list_T *const l, int n)
     return NULL;
   }
 
+  if (n < l->lv_items_len) {
+    return l->lv_items[n];
+  }
+
   int idx;
   listitem_T *item;
 
@@ -1569,6 +1622,16 @@ listitem_T *tv_list_find(list_T *const l, int n)
     }
   }
 
+  // For random access in a long list remember the item at each index, when
+  // that costs not much more than walking to "n".  Lists that are not
+  // allocated are not freed with tv_list_free_list(), they are skipped.
+  int dist = abs(n - idx);
+  if (dist >= TV_LIST_INDEX_MIN_DIST && dist * 4 >= l->lv_len - l->lv_items_len
+      && l->lv_refcount < DO_NOT_FREE_CNT) {
+    tv_list_index_items(l);
+    return l->lv_items[n];
+  }
+
   while (n > idx) {
     // Search forward.
     item = item->li_next;
@@ -2049,6 +2112,8 @@ dict_T *tv_dict_alloc(void)
   FUNC_ATTR_NONNULL_RET FUNC_ATTR_WARN_UNUSED_RESULT
 {
   dict_T *const d = xcalloc(1, sizeof(dict_T));
+  gc_container_count++;
+  gc_young_count++;
 
   // Add the dict to the list of dicts for garbage collection.
   if (gc_first_dict != NULL) {
@@ -2119,6 +2184,7 @@ void tv_dict_free_dict(dict_T *const d)
 
   NLUA_CLEAR_REF(d->lua_table_ref);
   xfree(d);
+  gc_container_count--;
 }
 
 /// Free a dictionary, including all items it contains
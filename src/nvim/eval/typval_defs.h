@@ -184,12 +184,15 @@ struct listvar_S {
   listitem_T *lv_last;  ///< Last item, NULL if none.
   listwatch_T *lv_watch;  ///< First watcher, NULL if none.
   listitem_T *lv_idx_item;  ///< When not NULL item at index "lv_idx".
+  listitem_T **lv_items;  ///< Items at the first "lv_items_len" indexes, or NULL.
   list_T *lv_copylist;  ///< Copied list used by deepcopy().
   list_T *lv_used_next;  ///< next list in used lists list.
   list_T *lv_used_prev;  ///< Previous list in used lists list.
   int lv_refcount;  ///< Reference count.
   int lv_len;  ///< Number of items.
   int lv_idx;  ///< Index of a cached item, used for optimising repeated l[idx].
+  int lv_items_len;  ///< Number of valid items in "lv_items".
+  int lv_items_size;  ///< Allocated size of "lv_items".
   int lv_copyID;  ///< ID used by deepcopy().
   VarLockStatus lv_lock;  ///< Zero, VAR_LOCKED, VAR_FIXED.
 
@@ -333,6 +336,8 @@ struct ufunc {
   garray_T uf_args;          ///< arguments
   garray_T uf_def_args;      ///< default argument expressions
   garray_T uf_lines;         ///< function lines
+  bool *uf_comment_lines;    ///< true for each comment line in "uf_lines",
+                             ///< NULL when there are none
   int uf_profiling;     ///< true when func is being profiled
   int uf_prof_initialized;
   LuaRef uf_luaref;      ///< lua callback, used if (uf_flags & FC_LUAREF)
@@ -770,6 +770,7 @@ static void cleanup_function_call(funccall_T *fc)
     // Link "fc" in the list for garbage collection later.
     fc->fc_caller = previous_funccal;
     previous_funccal = fc;
+    gc_young_count++;
 
     if (want_garbage_collect) {
       // If garbage collector is ready, clear count.
@@ -832,6 +833,7 @@ static void func_clear_items(ufunc_T *fp)
   ga_clear_strings(&(fp->uf_args));
   ga_clear_strings(&(fp->uf_def_args));
   ga_clear_strings(&(fp->uf_lines));
+  XFREE_CLEAR(fp->uf_comment_lines);
   XFREE_CLEAR(fp->uf_name_exp);
 
   if (fp->uf_flags & FC_LUAREF) {
@@ -1466,6 +1468,20 @@ static bool builtin_function(const char *name, int len)
   return p == NULL;
 }
 
+/// Find the builtin function an expression calls by name.
+///
+/// @param  len  length of "name" or -1 for NUL-terminated.
+///
+/// @return  NULL if "name" is not the name of a builtin function.
+const EvalFuncDef *find_builtin_func(const char *name, int len)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  if (!builtin_function(name, len)) {
+    return NULL;
+  }
+  return find_internal_func_len(name, len < 0 ? strlen(name) : (size_t)len);
+}
+
 int func_call(char *name, typval_T *args, partial_T *partial, dict_T *selfdict, typval_T *rettv)
 {
   typval_T argv[MAX_FUNC_ARGS + 1];
@@ -1517,6 +1533,50 @@ varnumber_T callback_call_retnr(Callback *callback, int argcount, typval_T *argv
   return retval;
 }
 
+/// Call the user function "funcname" of "len" bytes without arguments.
+/// Used by may_call_simple_func() to skip the expression parser.
+///
+/// @return  NOTDONE when "funcname" is not a defined user function, then the
+///          caller must evaluate the expression as usual.
+int call_simple_func(const char *funcname, size_t len, typval_T *rettv)
+  FUNC_ATTR_NONNULL_ALL
+{
+  int ret = NOTDONE;
+  int error = FCERR_NONE;
+  char fname_buf[FLEN_FIXED + 1];
+  char *tofree = NULL;
+
+  rettv->v_type = VAR_NUMBER;  // default rettv is number zero
+  rettv->vval.v_number = 0;
+
+  // Make a copy of the name, an option can be changed in the function.
+  char *name = xmemdupz(funcname, len);
+  char *fname = fname_trans_sid(name, fname_buf, &tofree, &error);
+  // Ignore "g:" before a function name.
+  char *rfname = fname[0] == 'g' && fname[1] == ':' ? fname + 2 : fname;
+  ufunc_T *fp = error == FCERR_NONE ? find_func(rfname) : NULL;
+  if (fp != NULL) {
+    if (fp->uf_flags & FC_DELETED) {
+      error = FCERR_DELETED;
+    } else {
+      funcexe_T funcexe = FUNCEXE_INIT;
+      funcexe.fe_firstline = curwin->w_cursor.lnum;
+      funcexe.fe_lastline = curwin->w_cursor.lnum;
+      funcexe.fe_evaluate = true;
+      error = call_user_func_check(fp, 0, NULL, rettv, &funcexe, NULL);
+      update_force_abort();
+      if (error != FCERR_NONE) {
+        user_func_error(error, name, &funcexe);
+      }
+    }
+    ret = error == FCERR_NONE ? OK : FAIL;
+  }
+
+  xfree(tofree);
+  xfree(name);
+  return ret;
+}
+
 /// Give an error message for the result of a function.
 /// Nothing if "error" is FCERR_NONE.
 static void user_func_error(int error, const char *name, funcexe_T *funcexe)
@@ -1609,7 +1669,11 @@ int call_func(const char *funcname, int len, typval_T *rettv, int argcount_in, t
   if (partial != NULL) {
     fp = partial->pt_func;
   }
-  if (fp == NULL) {
+  if (fp == NULL && funcexe->fe_builtin != NULL) {
+    // The caller owns the name of a builtin function, it needs no
+    // translation.
+    fname = (char *)funcname;
+  } else if (fp == NULL) {
     // Make a copy of the name, if it comes from a funcref variable it could
     // be changed or deleted in the called function.
     name = xmemdupz(funcname, (size_t)len);
@@ -1665,7 +1729,8 @@ int call_func(const char *funcname, int len, typval_T *rettv, int argcount_in, t
         XFREE_CLEAR(name);
         funcname = "v:lua";
       }
-    } else if (fp != NULL || !builtin_function(rfname, -1)) {
+    } else if (fp != NULL
+               || (funcexe->fe_builtin == NULL && !builtin_function(rfname, -1))) {
       // User defined function.
       if (fp == NULL) {
         fp = find_func(rfname);
@@ -1696,14 +1761,19 @@ int call_func(const char *funcname, int len, typval_T *rettv, int argcount_in, t
 
         error = call_user_func_check(fp, argcount, argvars, rettv, funcexe, selfdict);
       }
-    } else if (funcexe->fe_basetv != NULL) {
-      // expr->method(): Find the method name in the table, call its
-      // implementation with the base as one of the arguments.
-      error = call_internal_method(fname, argcount, argvars, rettv,
-                                   funcexe->fe_basetv);
     } else {
-      // Find the function name in the table, call its implementation.
-      error = call_internal_func(fname, argcount, argvars, rettv);
+      // Find the function name in the table, unless the caller already did.
+      const EvalFuncDef *const fdef = (funcexe->fe_builtin != NULL
+                                       ? funcexe->fe_builtin
+                                       : find_internal_func(fname));
+      if (funcexe->fe_basetv != NULL) {
+        // expr->method(): call its implementation with the base as one of
+        // the arguments.
+        error = call_internal_method(fdef, argcount, argvars, rettv,
+                                     funcexe->fe_basetv);
+      } else {
+        error = call_internal_func(fdef, argcount, argvars, rettv);
+      }
     }
     // The function call (or "FuncUndefined" autocommand sequence) might
     // have been aborted by an error, an interrupt, or an explicitly thrown
@@ -2127,6 +2197,8 @@ void ex_function(exarg_T *eap)
   garray_T newargs;
   garray_T default_args;
   garray_T newlines;
+  garray_T newcomments;
+  bool has_comments = false;
   int varargs = false;
   int flags = 0;
   ufunc_T *fp;
@@ -2281,6 +2353,7 @@ void ex_function(exarg_T *eap)
 
   ga_init(&newargs, (int)sizeof(char *), 3);
   ga_init(&newlines, (int)sizeof(char *), 3);
+  ga_init(&newcomments, (int)sizeof(bool), 3);
 
   if (!eap->skip) {
     // Check the name of the function.  Unless it's a dictionary function
@@ -2426,6 +2499,7 @@ void ex_function(exarg_T *eap)
       sourcing_lnum_off = 0;
     }
 
+    bool is_comment = false;
     if (skip_until != NULL) {
       // Don't check for ":endfunc" between
       // * ":append" and "."
@@ -2453,6 +2527,9 @@ void ex_function(exarg_T *eap)
     } else {
       // skip ':' and blanks
       for (p = theline; ascii_iswhite(*p) || *p == ':'; p++) {}
+      // Lines of a nested function are read again by its ":function" when
+      // this function runs, skipping them would change its line numbers.
+      is_comment = nesting == 0 && *p == '"';
 
       // Check for "endfunction".
       if (checkforcmd(&p, "endfunction", 4) && nesting-- == 0) {
@@ -2597,11 +2674,14 @@ void ex_function(exarg_T *eap)
     // is an extra alloc/free.
     p = xstrdup(theline);
     ((char **)(newlines.ga_data))[newlines.ga_len++] = p;
+    GA_APPEND(bool, &newcomments, is_comment);
+    has_comments |= is_comment;
 
     // Add NULL lines for continuation lines, so that the line count is
     // equal to the index in the growarray.
     while (sourcing_lnum_off-- > 0) {
       ((char **)(newlines.ga_data))[newlines.ga_len++] = NULL;
+      GA_APPEND(bool, &newcomments, false);
     }
 
     // Check for end of eap->arg.
@@ -2738,6 +2818,11 @@ void ex_function(exarg_T *eap)
   fp->uf_args = newargs;
   fp->uf_def_args = default_args;
   fp->uf_lines = newlines;
+  if (has_comments) {
+    fp->uf_comment_lines = newcomments.ga_data;
+  } else {
+    ga_clear(&newcomments);
+  }
   if ((flags & FC_CLOSURE) != 0) {
     register_closure(fp);
   } else {
@@ -2763,6 +2848,7 @@ erret:
   ga_clear_strings(&default_args);
 errret_2:
   ga_clear_strings(&newlines);
+  ga_clear(&newcomments);
 ret_free:
   xfree(skip_until);
   xfree(heredoc_trimmed);
@@ -3508,9 +3594,11 @@ char *get_func_line(int c, void *cookie, int indent, bool do_concat)
       || fcp->fc_returned) {
     retval = NULL;
   } else {
-    // Skip NULL lines (continuation lines).
+    // Skip NULL lines (continuation lines) and comment lines, which do
+    // nothing when executed.
     while (fcp->fc_linenr < gap->ga_len
-           && ((char **)(gap->ga_data))[fcp->fc_linenr] == NULL) {
+           && (((char **)(gap->ga_data))[fcp->fc_linenr] == NULL
+               || (fp->uf_comment_lines != NULL && fp->uf_comment_lines[fcp->fc_linenr]))) {
       fcp->fc_linenr++;
     }
     if (fcp->fc_linenr >= gap->ga_len) {
@@ -5,6 +5,7 @@
 
 #include "nvim/cmdexpand_defs.h"  // IWYU pragma: keep
 #include "nvim/eval.h"
+#include "nvim/eval/funcs.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/ex_cmds_defs.h"  // IWYU pragma: keep
 #include "nvim/hashtab_defs.h"  // IWYU pragma: keep
@@ -75,6 +76,8 @@ typedef struct {
   typval_T *fe_basetv;    ///< base for base->method()
   bool fe_found_var;      ///< if the function is not found then give an
                           ///< error that a variable is not callable.
+  const EvalFuncDef *fe_builtin;  ///< builtin function already looked up by
+                                  ///< the caller, name is not translated
 } funcexe_T;
 
 #define FUNCEXE_INIT (funcexe_T) { \
@@ -87,6 +90,7 @@ typedef struct {
   .fe_selfdict = NULL, \
   .fe_basetv = NULL, \
   .fe_found_var = false, \
+  .fe_builtin = NULL, \
 }
 
 #define FUNCARG(fp, j)  ((char **)(fp->uf_args.ga_data))[j]
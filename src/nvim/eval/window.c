@@ -894,8 +894,6 @@ void f_winrestview(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   }
 
   check_cursor();
-  win_new_height(curwin, curwin->w_height);
-  win_new_width(curwin, curwin->w_width);
   changed_window_setting();
 
   if (curwin->w_topline <= 0) {
@@ -980,6 +978,12 @@ int switch_win_noblock(switchwin_T *switchwin, win_T *win, tabpage_T *tp, bool n
   }
   curwin = win;
   curbuf = curwin->w_buffer;
+  // Code executed in a window of a tab page that was not entered yet needs
+  // the text of its buffer ('lazytabpages').  With autocommands blocked only
+  // variables and options are used, the buffer is loaded when entered then.
+  if (!is_autocmd_blocked() && curbuf_load_deferred() && (curwin != win || !win_valid(win))) {
+    return FAIL;
+  }
   return OK;
 }
 
@@ -148,6 +148,10 @@ struct stream {
   size_t maxmem;
   size_t pending_reqs;
   size_t num_bytes;
+  size_t num_reads;  ///< number of reads into "buffer"
+  size_t num_stalls;  ///< times reading stopped because "buffer" was full
+  size_t buffer_min, buffer_max;  ///< size limits of "buffer", 0 if fixed
+  int small_reads;  ///< successive reads that used little of "buffer"
   MultiQueue *events;
 };
 
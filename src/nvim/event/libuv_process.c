@@ -3,6 +3,20 @@
 #include <stdint.h>
 #include <uv.h>
 
+#include "auto/config.h"
+
+#ifdef HAVE_POSIX_SPAWN
+# include <fcntl.h>
+# include <signal.h>
+# include <spawn.h>
+# include <string.h>
+# include <sys/wait.h>
+# include <unistd.h>
+# ifdef __APPLE__
+#  include <crt_externs.h>
+# endif
+#endif
+
 #include "nvim/eval/typval.h"
 #include "nvim/event/defs.h"
 #include "nvim/event/libuv_process.h"
@@ -20,6 +34,12 @@ int libuv_process_spawn(LibuvProcess *uvproc)
   FUNC_ATTR_NONNULL_ALL
 {
   Process *proc = (Process *)uvproc;
+#ifdef HAVE_POSIX_SPAWN
+  if (posix_process_spawn(uvproc)) {
+    return 0;
+  }
+#endif
+
   uvproc->uvopts.file = process_get_exepath(proc);
   uvproc->uvopts.args = proc->argv;
   uvproc->uvopts.flags = UV_PROCESS_WINDOWS_HIDE;
@@ -98,9 +118,131 @@ int libuv_process_spawn(LibuvProcess *uvproc)
   return status;
 }
 
+#ifdef HAVE_POSIX_SPAWN
+/// Starts a process with posix_spawn(). Unlike the fork() done by uv_spawn(),
+/// this does not copy the page tables of Nvim, which is slow when Nvim uses a
+/// lot of memory: glibc and the BSDs implement it with vfork() or
+/// clone(CLONE_VM).
+///
+/// Its exit is noticed by process_chld_handler() instead of libuv.
+///
+/// @returns false if the process was not started, the caller should fall
+///          back to uv_spawn(), which also reports the error.
+static bool posix_process_spawn(LibuvProcess *uvproc)
+  FUNC_ATTR_NONNULL_ALL
+{
+# if defined(HAVE__NSGETENVIRON)
+#  define environ (*_NSGetEnviron())
+# else
+  extern char **environ;
+# endif
+  Process *proc = (Process *)uvproc;
+  const char *file = process_get_exepath(proc);
+  if (ui_client_forward_stdin
+      // posix_spawnp() searches the $PATH of Nvim, not the one in "env".
+      || (proc->env != NULL && strchr(file, '/') == NULL)) {
+    return false;
+  }
+
+  Stream *streams[3] = { &proc->in, &proc->out, &proc->err };
+  // For each stdio stream: the end used by the child, then the one kept here.
+  int fds[3][2] = { { -1, -1 }, { -1, -1 }, { -1, -1 } };
+  bool ok = true;
+  for (int i = 0; i < 3 && ok; i++) {
+    if (streams[i]->closed) {
+      continue;
+    }
+    ok = uv_socketpair(SOCK_STREAM, 0, fds[i], 0, UV_NONBLOCK_PIPE) == 0
+         // dup2() to the same descriptor would not clear FD_CLOEXEC.
+         && fds[i][0] > STDERR_FILENO;
+  }
+
+  pid_t pid = 0;
+  if (ok) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    for (int i = 0; i < 3; i++) {
+      if (fds[i][0] >= 0) {
+        posix_spawn_file_actions_adddup2(&actions, fds[i][0], i);
+      } else if (i != STDERR_FILENO || !proc->fwd_err) {
+        posix_spawn_file_actions_addopen(&actions, i, "/dev/null",
+                                         i == STDIN_FILENO ? O_RDONLY : O_RDWR, 0);
+      }
+    }
+    if (proc->cwd != NULL) {
+      posix_spawn_file_actions_addchdir_np(&actions, proc->cwd);
+    }
+
+    // Like uv_spawn(): always setsid() (#8107), reset signal handlers and
+    // unblock all signals.
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t sigs;
+    sigfillset(&sigs);
+    sigdelset(&sigs, SIGKILL);
+    sigdelset(&sigs, SIGSTOP);
+    posix_spawnattr_setsigdefault(&attr, &sigs);
+    sigemptyset(&sigs);
+    posix_spawnattr_setsigmask(&attr, &sigs);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID | POSIX_SPAWN_SETSIGDEF
+                             | POSIX_SPAWN_SETSIGMASK);
+
+    char **env = proc->env ? tv_dict_to_env(proc->env) : environ;
+    // Start watching before the child can exit.
+    uv_signal_start(&proc->loop->children_watcher, process_chld_handler, SIGCHLD);
+    int err = strchr(file, '/') != NULL
+              ? posix_spawn(&pid, file, &actions, &attr, proc->argv, env)
+              : posix_spawnp(&pid, file, &actions, &attr, proc->argv, env);
+    if (err != 0) {
+      DLOG("posix_spawn(%s) failed: %s", file, strerror(err));
+      ok = false;
+    }
+    if (proc->env) {
+      os_free_fullenv(env);
+    }
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    if (fds[i][0] >= 0) {
+      close(fds[i][0]);
+    }
+    if (fds[i][1] < 0) {
+      continue;
+    }
+    if (ok && uv_pipe_open(&streams[i]->uv.pipe, fds[i][1]) == 0) {
+      continue;
+    }
+    close(fds[i][1]);
+    if (ok) {
+      // The child already runs, it is started again by uv_spawn().
+      ok = false;
+      kill(pid, SIGKILL);
+      waitpid(pid, NULL, 0);
+    }
+  }
+
+  if (!ok) {
+    return false;
+  }
+  uvproc->posix_spawned = true;
+  uvproc->uvopts.env = NULL;
+  proc->pid = pid;
+  return true;
+}
+#endif
+
 void libuv_process_close(LibuvProcess *uvproc)
   FUNC_ATTR_NONNULL_ARG(1)
 {
+  if (uvproc->posix_spawned) {
+    Process *proc = (Process *)uvproc;
+    if (proc->internal_close_cb) {
+      proc->internal_close_cb(proc);
+    }
+    return;
+  }
   uv_close((uv_handle_t *)&uvproc->uv, close_cb);
 }
 
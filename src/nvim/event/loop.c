@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <uv.h>
 
+#include "nvim/atomic_defs.h"
 #include "nvim/event/defs.h"
 #include "nvim/event/loop.h"
 #include "nvim/event/multiqueue.h"
@@ -10,6 +11,11 @@
 #include "nvim/memory.h"
 #include "nvim/os/time.h"
 
+struct thread_event {
+  ThreadEvent *next;
+  Event event;
+};
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "event/loop.c.generated.h"
 #endif
@@ -23,8 +29,8 @@ void loop_init(Loop *loop, void *data)
   loop->children = kl_init(WatcherPtr);
   loop->events = multiqueue_new_parent(loop_on_put, loop);
   loop->fast_events = multiqueue_new_child(loop->events);
-  loop->thread_events = multiqueue_new_parent(NULL, NULL);
-  uv_mutex_init(&loop->mutex);
+  loop->thread_events = NULL;
+  loop->thread_events_count = 0;
   uv_async_init(&loop->uv, &loop->async, async_cb);
   uv_signal_init(&loop->uv, &loop->children_watcher);
   uv_timer_init(&loop->uv, &loop->children_kill_timer);
@@ -98,10 +104,20 @@ bool loop_poll_events(Loop *loop, int64_t ms)
 /// @see loop_schedule_deferred
 void loop_schedule_fast(Loop *loop, Event event)
 {
-  uv_mutex_lock(&loop->mutex);
-  multiqueue_put_event(loop->thread_events, event);
-  uv_async_send(&loop->async);
-  uv_mutex_unlock(&loop->mutex);
+  ThreadEvent *node = xmalloc(sizeof(*node));
+  node->event = event;
+  // Count first, so that the count is never less than the number of events.
+  ATOMIC_ADD(&loop->thread_events_count, 1);
+  ThreadEvent *head;
+  do {
+    head = ATOMIC_LOAD_PTR(&loop->thread_events);
+    node->next = head;
+  } while (!ATOMIC_CAS_PTR(&loop->thread_events, head, node));
+  // Only the event that makes the list non-empty needs to wake up the loop,
+  // async_cb() takes all the events pushed until it runs.
+  if (head == NULL) {
+    uv_async_send(&loop->async);
+  }
 }
 
 /// Schedules an event from another thread. Unlike loop_schedule_fast(), the
@@ -152,7 +168,6 @@ bool loop_close(Loop *loop, bool wait)
 {
   bool rv = true;
   loop->closing = true;
-  uv_mutex_destroy(&loop->mutex);
   uv_close((uv_handle_t *)&loop->children_watcher, NULL);
   uv_close((uv_handle_t *)&loop->children_kill_timer, NULL);
   uv_close((uv_handle_t *)&loop->poll_timer, timer_close_cb);
@@ -188,8 +203,8 @@ bool loop_close(Loop *loop, bool wait)
     }
 #endif
   }
+  loop_purge(loop);
   multiqueue_free(loop->fast_events);
-  multiqueue_free(loop->thread_events);
   multiqueue_free(loop->events);
   kl_destroy(WatcherPtr, loop->children);
   return rv;
@@ -197,30 +212,48 @@ bool loop_close(Loop *loop, bool wait)
 
 void loop_purge(Loop *loop)
 {
-  uv_mutex_lock(&loop->mutex);
-  multiqueue_purge_events(loop->thread_events);
+  ThreadEvent *node = thread_events_take(loop);
+  while (node != NULL) {
+    ThreadEvent *next = node->next;
+    xfree(node);
+    node = next;
+  }
   multiqueue_purge_events(loop->fast_events);
-  uv_mutex_unlock(&loop->mutex);
 }
 
 size_t loop_size(Loop *loop)
 {
-  uv_mutex_lock(&loop->mutex);
-  size_t rv = multiqueue_size(loop->thread_events);
-  uv_mutex_unlock(&loop->mutex);
-  return rv;
+  return (size_t)ATOMIC_LOAD(&loop->thread_events_count);
+}
+
+/// Take all events scheduled by other threads, oldest first.
+static ThreadEvent *thread_events_take(Loop *loop)
+{
+  ThreadEvent *node = ATOMIC_XCHG_PTR(&loop->thread_events, NULL);
+  ThreadEvent *list = NULL;
+  int64_t count = 0;
+  while (node != NULL) {
+    ThreadEvent *next = node->next;
+    node->next = list;
+    list = node;
+    node = next;
+    count++;
+  }
+  ATOMIC_ADD(&loop->thread_events_count, -count);
+  return list;
 }
 
 static void async_cb(uv_async_t *handle)
 {
   Loop *l = handle->loop->data;
-  uv_mutex_lock(&l->mutex);
   // Flush thread_events to fast_events for processing on main loop.
-  while (!multiqueue_empty(l->thread_events)) {
-    Event ev = multiqueue_get(l->thread_events);
-    multiqueue_put_event(l->fast_events, ev);
+  ThreadEvent *node = thread_events_take(l);
+  while (node != NULL) {
+    ThreadEvent *next = node->next;
+    multiqueue_put_event(l->fast_events, node->event);
+    xfree(node);
+    node = next;
   }
-  uv_mutex_unlock(&l->mutex);
 }
 
 static void timer_cb(uv_timer_t *handle)
@@ -9,6 +9,7 @@
 #include "nvim/os/time.h"
 
 typedef void *WatcherPtr;
+typedef struct thread_event ThreadEvent;
 
 #define _NOOP(x)
 KLIST_INIT(WatcherPtr, WatcherPtr, _NOOP)
@@ -16,7 +17,10 @@ KLIST_INIT(WatcherPtr, WatcherPtr, _NOOP)
 typedef struct loop {
   uv_loop_t uv;
   MultiQueue *events;
-  MultiQueue *thread_events;
+  // Events scheduled by other threads, newest first.  Pushed without a lock
+  // and moved to fast_events in one batch by the "async" callback.
+  ThreadEvent *thread_events;
+  int64_t thread_events_count;
   // Immediate events:
   //    "Processed after exiting uv_run() (to avoid recursion), but before
   //    returning from loop_poll_events()." 502aee690c98
@@ -39,7 +43,6 @@ typedef struct loop {
   uv_timer_t exit_delay_timer;
 
   uv_async_t async;
-  uv_mutex_t mutex;
   int recursive;
   bool closing;  ///< Set to true if loop_close() has been called
 } Loop;
@@ -41,6 +41,11 @@
 // the event loop queue and poll job1 queue instead. Same with channels, when
 // calling `rpcrequest` we want to temporarily stop processing events from
 // other sources and focus on a specific channel.
+//
+// A child queue can be marked as low priority, e.g. for the output of a job
+// that might produce a flood of events.  Its link nodes go to a second list of
+// the parent queue, which is only processed when there are no other events, or
+// after MULTIQUEUE_LOW_PRIORITY_STREAK other events, so that it can't starve.
 
 #include <assert.h>
 #include <stdbool.h>
@@ -67,11 +72,18 @@ struct multiqueue_item {
 struct multiqueue {
   MultiQueue *parent;
   QUEUE headtail;  // circularly-linked
+  QUEUE headtail_low;  // link nodes of low priority children (parent only)
   PutCallback put_cb;
   void *data;
   size_t size;
+  bool low_priority;  // child queue: put link nodes in "headtail_low"
+  int streak;  // parent queue: events removed while "headtail_low" waited
 };
 
+/// Number of events taken from a parent queue before a waiting low priority
+/// event is taken.
+#define MULTIQUEUE_LOW_PRIORITY_STREAK 8
+
 typedef struct {
   Event event;
   bool fired;
@@ -101,7 +113,10 @@ static MultiQueue *multiqueue_new(MultiQueue *parent, PutCallback put_cb, void *
 {
   MultiQueue *rv = xmalloc(sizeof(MultiQueue));
   QUEUE_INIT(&rv->headtail);
+  QUEUE_INIT(&rv->headtail_low);
   rv->size = 0;
+  rv->low_priority = false;
+  rv->streak = 0;
   rv->parent = parent;
   rv->put_cb = put_cb;
   rv->data = data;
@@ -121,6 +136,10 @@ void multiqueue_free(MultiQueue *self)
     QUEUE_REMOVE(q);
     xfree(item);
   })
+  QUEUE_FOREACH(q, &self->headtail_low, {
+    QUEUE_REMOVE(q);
+    xfree(multiqueue_node_data(q));
+  })
 
   xfree(self);
 }
@@ -163,7 +182,15 @@ void multiqueue_purge_events(MultiQueue *self)
 bool multiqueue_empty(MultiQueue *self)
 {
   assert(self);
-  return QUEUE_EMPTY(&self->headtail);
+  return QUEUE_EMPTY(&self->headtail) && QUEUE_EMPTY(&self->headtail_low);
+}
+
+/// Sets whether events of child queue "self" are taken from the parent queue
+/// after the events of other queues.
+void multiqueue_set_low_priority(MultiQueue *self, bool low_priority)
+{
+  assert(self->parent);
+  self->low_priority = low_priority;
 }
 
 void multiqueue_replace_parent(MultiQueue *self, MultiQueue *new_parent)
@@ -212,7 +239,16 @@ static Event multiqueueitem_get_event(MultiQueueItem *item, bool remove)
 static Event multiqueue_remove(MultiQueue *self)
 {
   assert(!multiqueue_empty(self));
-  QUEUE *h = QUEUE_HEAD(&self->headtail);
+  QUEUE *lane = &self->headtail;
+  if (!QUEUE_EMPTY(&self->headtail_low)) {
+    if (QUEUE_EMPTY(lane) || self->streak >= MULTIQUEUE_LOW_PRIORITY_STREAK) {
+      lane = &self->headtail_low;
+      self->streak = 0;
+    } else {
+      self->streak++;
+    }
+  }
+  QUEUE *h = QUEUE_HEAD(lane);
   QUEUE_REMOVE(h);
   MultiQueueItem *item = multiqueue_node_data(h);
   assert(!item->link || !self->parent);  // Only a parent queue has link-nodes
@@ -234,7 +270,7 @@ static void multiqueue_push(MultiQueue *self, Event event)
     item->data.item.parent_item = xmalloc(sizeof(MultiQueueItem));
     item->data.item.parent_item->link = true;
     item->data.item.parent_item->data.queue = self;
-    QUEUE_INSERT_TAIL(&self->parent->headtail,
+    QUEUE_INSERT_TAIL(self->low_priority ? &self->parent->headtail_low : &self->parent->headtail,
                       &item->data.item.parent_item->node);
   }
   self->size++;
@@ -3,6 +3,11 @@
 #include <signal.h>
 #include <uv.h>
 
+#ifndef MSWIN
+# include <errno.h>
+# include <sys/wait.h>
+#endif
+
 #include "klib/klist.h"
 #include "nvim/event/libuv_process.h"
 #include "nvim/event/loop.h"
@@ -68,6 +73,7 @@ int process_spawn(Process *proc, bool in, bool out, bool err)
 #endif
 
   int status;
+  uint64_t spawn_start = os_hrtime();
   switch (proc->type) {
   case kProcessTypeUv:
     status = libuv_process_spawn((LibuvProcess *)proc);
@@ -76,6 +82,7 @@ int process_spawn(Process *proc, bool in, bool out, bool err)
     status = pty_process_spawn((PtyProcess *)proc);
     break;
   }
+  proc->spawn_time = os_hrtime() - spawn_start;
 
   if (status) {
     if (in) {
@@ -146,6 +153,39 @@ void process_teardown(Loop *loop) FUNC_ATTR_NONNULL_ALL
   pty_process_teardown(loop);
 }
 
+#ifndef MSWIN
+/// SIGCHLD handler for the children that libuv does not reap itself: pty
+/// processes and processes started with posix_spawn().
+void process_chld_handler(uv_signal_t *handle, int signum)
+{
+  int stat = 0;
+  int pid;
+
+  Loop *loop = handle->loop->data;
+
+  kl_iter(WatcherPtr, loop->children, current) {
+    Process *proc = (*current)->data;
+    if (proc->type == kProcessTypeUv && !((LibuvProcess *)proc)->posix_spawned) {
+      continue;
+    }
+    do {
+      pid = waitpid(proc->pid, &stat, WNOHANG);
+    } while (pid < 0 && errno == EINTR);
+
+    if (pid <= 0) {
+      continue;
+    }
+
+    if (WIFEXITED(stat)) {
+      proc->status = WEXITSTATUS(stat);
+    } else if (WIFSIGNALED(stat)) {
+      proc->status = 128 + WTERMSIG(stat);
+    }
+    proc->internal_exit_cb(proc);
+  }
+}
+#endif
+
 void process_close_streams(Process *proc) FUNC_ATTR_NONNULL_ALL
 {
   stream_may_close(&proc->in);
@@ -318,7 +358,7 @@ static void process_close(Process *proc)
   proc->closed = true;
 
   if (proc->detach) {
-    if (proc->type == kProcessTypeUv) {
+    if (proc->type == kProcessTypeUv && !((LibuvProcess *)proc)->posix_spawned) {
       uv_unref((uv_handle_t *)&(((LibuvProcess *)proc)->uv));
     }
   }
@@ -29,6 +29,7 @@ struct process {
   int pid, status, refcount;
   uint8_t exit_signal;  // Signal used when killing (on Windows).
   uint64_t stopped_time;  // process_stop() timestamp
+  uint64_t spawn_time;  // Time taken to start the process, in nanoseconds.
   const char *cwd;
   char **argv;
   const char *exepath;
@@ -52,6 +53,7 @@ static inline Process process_init(Loop *loop, ProcessType type, void *data)
     .status = -1,
     .refcount = 0,
     .stopped_time = 0,
+    .spawn_time = 0,
     .cwd = NULL,
     .argv = NULL,
     .exepath = NULL,
@@ -15,6 +15,14 @@
 #include "nvim/os/os_defs.h"
 #include "nvim/rbuffer.h"
 
+// Streams initialized with the default size start with a small buffer. It
+// grows when it gets full instead of stopping to read, up to
+// RSTREAM_MAX_SIZE, and shrinks again after RSTREAM_SHRINK_READS reads in a
+// row that used at most an eighth of it.
+#define RSTREAM_MIN_SIZE 0x4000
+#define RSTREAM_MAX_SIZE 0x100000
+#define RSTREAM_SHRINK_READS 32
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "event/rstream.c.generated.h"
 #endif
@@ -33,9 +41,16 @@ void rstream_init_stream(Stream *stream, uv_stream_t *uvstream, size_t bufsize)
   rstream_init(stream, bufsize);
 }
 
+/// @param bufsize  Size of the read buffer, or 0 for a buffer that adapts to
+///                 the amount of data that is read.
 void rstream_init(Stream *stream, size_t bufsize)
   FUNC_ATTR_NONNULL_ARG(1)
 {
+  if (bufsize == 0) {
+    bufsize = RSTREAM_MIN_SIZE;
+    stream->buffer_min = RSTREAM_MIN_SIZE;
+    stream->buffer_max = RSTREAM_MAX_SIZE;
+  }
   stream->buffer = rbuffer_new(bufsize);
   stream->buffer->data = stream;
   stream->buffer->full_cb = on_rbuffer_full;
@@ -72,7 +87,35 @@ void rstream_stop(Stream *stream)
 
 static void on_rbuffer_full(RBuffer *buf, void *data)
 {
-  rstream_stop(data);
+  Stream *stream = data;
+  size_t capacity = rbuffer_capacity(buf);
+  if (capacity < stream->buffer_max) {
+    // Sustained throughput: grow instead of stopping.
+    stream->buffer = rbuffer_resize(buf, MIN(capacity * 2, stream->buffer_max));
+    stream->small_reads = 0;
+    return;
+  }
+  stream->num_stalls++;
+  rstream_stop(stream);
+}
+
+/// Shrinks the buffer of an adaptive stream when reads keep using only a
+/// small part of it. Called when the read data was passed on.
+static void rstream_adapt(Stream *stream, size_t count)
+{
+  if (stream->buffer_max == 0) {
+    return;
+  }
+  size_t capacity = rbuffer_capacity(stream->buffer);
+  if (capacity <= stream->buffer_min || count > capacity / 8) {
+    stream->small_reads = 0;
+    return;
+  }
+  if (++stream->small_reads >= RSTREAM_SHRINK_READS
+      && rbuffer_size(stream->buffer) <= capacity / 4) {
+    stream->buffer = rbuffer_resize(stream->buffer, MAX(capacity / 2, stream->buffer_min));
+    stream->small_reads = 0;
+  }
 }
 
 static void on_rbuffer_nonfull(RBuffer *buf, void *data)
@@ -127,6 +170,7 @@ static void read_cb(uv_stream_t *uvstream, ssize_t cnt, const uv_buf_t *buf)
   // at this point we're sure that cnt is positive, no error occurred
   size_t nread = (size_t)cnt;
   stream->num_bytes += nread;
+  stream->num_reads++;
   // Data was already written, so all we need is to update 'wpos' to reflect
   // the space actually used in the buffer.
   rbuffer_produced(stream->buffer, nread);
@@ -177,6 +221,7 @@ static void fread_idle_cb(uv_idle_t *handle)
   // no errors (req.result (ssize_t) is positive), it's safe to cast.
   size_t nread = (size_t)req.result;
   rbuffer_produced(stream->buffer, nread);
+  stream->num_reads++;
   stream->fpos += nread;
   invoke_read_cb(stream, nread, false);
 }
@@ -189,6 +234,9 @@ static void read_event(void **argv)
     bool eof = (uintptr_t)argv[2];
     stream->did_eof = eof;
     stream->read_cb(stream, stream->buffer, count, stream->cb_data, eof);
+    if (!eof && !stream->closed) {
+      rstream_adapt(stream, count);
+    }
   }
   stream->pending_reqs--;
   if (stream->closed && !stream->pending_reqs) {
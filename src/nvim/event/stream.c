@@ -96,13 +96,19 @@ void stream_init(Loop *loop, Stream *stream, int fd, uv_stream_t *uvstream)
   stream->buffer = NULL;
   stream->events = NULL;
   stream->num_bytes = 0;
+  stream->num_reads = 0;
+  stream->num_stalls = 0;
+  stream->buffer_min = 0;
+  stream->buffer_max = 0;
+  stream->small_reads = 0;
 }
 
 void stream_close(Stream *stream, stream_close_cb on_stream_close, void *data)
   FUNC_ATTR_NONNULL_ARG(1)
 {
   assert(!stream->closed);
-  DLOG("closing Stream: %p", (void *)stream);
+  DLOG("closing Stream: %p (read %zu bytes in %zu reads, %zu stalls)",
+       (void *)stream, stream->num_bytes, stream->num_reads, stream->num_stalls);
   stream->closed = true;
   stream->close_cb = on_stream_close;
   stream->close_cb_data = data;
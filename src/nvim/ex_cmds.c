@@ -34,6 +34,7 @@
 #include "nvim/edit.h"
 #include "nvim/eval.h"
 #include "nvim/eval/typval.h"
+#include "nvim/eval/vars.h"
 #include "nvim/ex_cmds.h"
 #include "nvim/ex_cmds2.h"
 #include "nvim/ex_cmds_defs.h"
@@ -43,6 +44,7 @@
 #include "nvim/extmark.h"
 #include "nvim/fileio.h"
 #include "nvim/fold.h"
+#include "nvim/garray.h"
 #include "nvim/getchar.h"
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
@@ -128,6 +130,9 @@ typedef struct {
 static const char e_non_numeric_argument_to_z[]
   = N_("E144: Non-numeric argument to :z");
 
+/// Bytes of a file read ahead for ":badd" while loading a session.
+enum { SESSION_PREFETCH_MAX = 1024 * 1024, };
+
 /// ":ascii" and "ga" implementation
 void do_ascii(exarg_T *eap)
 {
@@ -336,10 +341,12 @@ static int linelen(int *has_tab)
   return len;
 }
 
-// Buffer for two lines used during sorting.  They are allocated to
-// contain the longest line being sorted.
+// Buffer for a line used for "unique".  It is allocated to contain the
+// longest line being sorted.
 static char *sortbuf1;
-static char *sortbuf2;
+
+// The keys of all lines when sorting on strings, each one ending in a NUL.
+static garray_T sort_keys = GA_EMPTY_INIT_VALUE;
 
 static int sort_lc;       ///< sort using locale
 static int sort_ic;       ///< ignore case
@@ -353,10 +360,7 @@ static int sort_abort;    ///< flag to indicate if sorting has been interrupted
 typedef struct {
   linenr_T lnum;          ///< line number
   union {
-    struct {
-      varnumber_T start_col_nr;  ///< starting column number
-      varnumber_T end_col_nr;    ///< ending column number
-    } line;
+    size_t key_off;              ///< offset of the key in "sort_keys"
     struct {
       varnumber_T value;         ///< value if sorting by integer
       bool is_number;            ///< true when line contains a number
@@ -407,17 +411,8 @@ static int sort_compare(const void *s1, const void *s2)
              ? 0 : l1.st_u.value_flt > l2.st_u.value_flt
              ? 1 : -1;
   } else {
-    // We need to copy one line into "sortbuf1", because there is no
-    // guarantee that the first pointer becomes invalid when obtaining the
-    // second one.
-    memcpy(sortbuf1, ml_get(l1.lnum) + l1.st_u.line.start_col_nr,
-           (size_t)(l1.st_u.line.end_col_nr - l1.st_u.line.start_col_nr + 1));
-    sortbuf1[l1.st_u.line.end_col_nr - l1.st_u.line.start_col_nr] = NUL;
-    memcpy(sortbuf2, ml_get(l2.lnum) + l2.st_u.line.start_col_nr,
-           (size_t)(l2.st_u.line.end_col_nr - l2.st_u.line.start_col_nr + 1));
-    sortbuf2[l2.st_u.line.end_col_nr - l2.st_u.line.start_col_nr] = NUL;
-
-    result = string_compare(sortbuf1, sortbuf2);
+    result = string_compare((char *)sort_keys.ga_data + l1.st_u.key_off,
+                            (char *)sort_keys.ga_data + l2.st_u.key_off);
   }
 
   // If two lines have the same value, preserve the original line order.
@@ -427,6 +422,96 @@ static int sort_compare(const void *s1, const void *s2)
   return result;
 }
 
+/// Get the number key of "s" for sort_radix() as an unsigned number that
+/// sorts in the same order.
+static uint64_t sort_radix_key(const sorti_T *s)
+{
+  if (sort_flt) {
+    // -0.0 is equal to 0.0
+    float_T f = s->st_u.value_flt == 0 ? 0 : s->st_u.value_flt;
+    uint64_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return (bits & ((uint64_t)1 << 63)) ? ~bits : bits | ((uint64_t)1 << 63);
+  }
+  return (uint64_t)s->st_u.num.value ^ ((uint64_t)1 << 63);
+}
+
+/// Sort "nrs" on numbers with a radix sort instead of qsort() with
+/// sort_compare(), with the same result: the sort is stable, thus equal
+/// numbers keep their line order, and lines without a number come first.
+static void sort_radix(sorti_T *nrs, size_t count)
+{
+  sorti_T *tmp = xmalloc(count * sizeof(sorti_T));
+  size_t first = 0;
+  if (sort_nr) {
+    // Lines without a number all sort the same, put them in front.
+    for (size_t i = 0; i < count; i++) {
+      if (!nrs[i].st_u.num.is_number) {
+        tmp[first++] = nrs[i];
+      }
+    }
+    if (first > 0) {
+      size_t n = first;
+      for (size_t i = 0; i < count; i++) {
+        if (nrs[i].st_u.num.is_number) {
+          tmp[n++] = nrs[i];
+        }
+      }
+      memcpy(nrs, tmp, count * sizeof(sorti_T));
+    }
+  }
+
+  const size_t n = count - first;
+  sorti_T *src = nrs + first;
+  sorti_T *dst = tmp;
+  uint64_t *keys = xmalloc(n * sizeof(uint64_t));
+  uint64_t *keys2 = xmalloc(n * sizeof(uint64_t));
+  for (size_t i = 0; i < n; i++) {
+    keys[i] = sort_radix_key(&src[i]);
+  }
+
+  // One pass per byte, from the least significant one.
+  for (int shift = 0; shift < 64 && n > 0; shift += 8) {
+    size_t pos[256] = { 0 };
+    for (size_t i = 0; i < n; i++) {
+      pos[(keys[i] >> shift) & 0xff]++;
+    }
+    if (pos[(keys[0] >> shift) & 0xff] == n) {
+      continue;  // all the same byte
+    }
+    size_t total = 0;
+    for (int b = 0; b < 256; b++) {
+      size_t c = pos[b];
+      pos[b] = total;
+      total += c;
+    }
+    for (size_t i = 0; i < n; i++) {
+      size_t j = pos[(keys[i] >> shift) & 0xff]++;
+      dst[j] = src[i];
+      keys2[j] = keys[i];
+    }
+    sorti_T *t = src;
+    src = dst;
+    dst = t;
+    uint64_t *k = keys;
+    keys = keys2;
+    keys2 = k;
+
+    fast_breakcheck();
+    if (got_int) {
+      sort_abort = true;
+      break;
+    }
+  }
+  if (src != nrs + first) {
+    memcpy(nrs + first, src, n * sizeof(sorti_T));
+  }
+
+  xfree(keys);
+  xfree(keys2);
+  xfree(tmp);
+}
+
 /// ":sort".
 void ex_sort(exarg_T *eap)
 {
@@ -446,7 +531,7 @@ void ex_sort(exarg_T *eap)
     return;
   }
   sortbuf1 = NULL;
-  sortbuf2 = NULL;
+  ga_init(&sort_keys, 1, 4096);
   regmatch.regprog = NULL;
   sorti_T *nrs = xmalloc(count * sizeof(sorti_T));
 
@@ -523,11 +608,11 @@ void ex_sort(exarg_T *eap)
   // sorting.
   sort_nr += sort_what;
 
-  // Make an array with all line numbers.  This avoids having to copy all
-  // the lines into allocated memory.
-  // When sorting on strings "start_col_nr" is the offset in the line, for
-  // numbers sorting it's the number to sort on.  This means the pattern
-  // matching and number conversion only has to be done once per line.
+  // Make an array with all line numbers.
+  // When sorting on strings the part of the line to sort on is copied to
+  // "sort_keys", for numbers sorting the number to sort on is stored.  This
+  // means the pattern matching and number conversion only has to be done
+  // once per line, and lines don't have to be fetched while sorting.
   // Also get the longest line length for allocating "sortbuf".
   for (linenr_T lnum = eap->line1; lnum <= eap->line2; lnum++) {
     char *s = ml_get(lnum);
@@ -592,9 +677,10 @@ void ex_sort(exarg_T *eap)
       }
       *s2 = c;
     } else {
-      // Store the column to sort at.
-      nrs[lnum - eap->line1].st_u.line.start_col_nr = start_col;
-      nrs[lnum - eap->line1].st_u.line.end_col_nr = end_col;
+      // Store the text to sort on.
+      nrs[lnum - eap->line1].st_u.key_off = (size_t)sort_keys.ga_len;
+      ga_concat_len(&sort_keys, s + start_col, (size_t)MAX(end_col - start_col, 0));
+      ga_append(&sort_keys, NUL);
     }
 
     nrs[lnum - eap->line1].lnum = lnum;
@@ -609,10 +695,14 @@ void ex_sort(exarg_T *eap)
 
   // Allocate a buffer that can hold the longest line.
   sortbuf1 = xmalloc((size_t)maxlen + 1);
-  sortbuf2 = xmalloc((size_t)maxlen + 1);
 
-  // Sort the array of line numbers.  Note: can't be interrupted!
-  qsort((void *)nrs, count, sizeof(sorti_T), sort_compare);
+  // Sort the array of line numbers.  When interrupted "sort_abort" is set.
+  if (sort_nr || sort_flt) {
+    sort_radix(nrs, count);
+  } else {
+    qsort((void *)nrs, count, sizeof(sorti_T), sort_compare);
+  }
+  ga_clear(&sort_keys);
 
   if (sort_abort) {
     goto sortend;
@@ -682,7 +772,7 @@ void ex_sort(exarg_T *eap)
 sortend:
   xfree(nrs);
   xfree(sortbuf1);
-  xfree(sortbuf2);
+  ga_clear(&sort_keys);
   vim_regfree(regmatch.regprog);
   if (got_int) {
     emsg(_(e_interr));
@@ -1514,11 +1604,13 @@ int rename_buffer(char *new_fname)
   char *fname = curbuf->b_ffname;
   char *sfname = curbuf->b_sfname;
   char *xfname = curbuf->b_fname;
+  buf_names_remove(curbuf);
   curbuf->b_ffname = NULL;
   curbuf->b_sfname = NULL;
   if (setfname(curbuf, new_fname, NULL, true) == FAIL) {
     curbuf->b_ffname = fname;
     curbuf->b_sfname = sfname;
+    buf_names_add(curbuf);
     return FAIL;
   }
   curbuf->b_flags |= BF_NOTEDITED;
@@ -1699,6 +1791,8 @@ int do_write(exarg_T *eap)
       // under the new name.  Must be done before buf_write(), because
       // if there is no file name and 'cpo' contains 'F', it will set
       // the file name.
+      buf_names_remove(alt_buf);
+      buf_names_remove(curbuf);
       fname = alt_buf->b_fname;
       alt_buf->b_fname = curbuf->b_fname;
       curbuf->b_fname = fname;
@@ -1708,6 +1802,8 @@ int do_write(exarg_T *eap)
       fname = alt_buf->b_sfname;
       alt_buf->b_sfname = curbuf->b_sfname;
       curbuf->b_sfname = fname;
+      buf_names_add(alt_buf);
+      buf_names_add(curbuf);
       buf_name_changed(curbuf);
       apply_autocmds(EVENT_BUFFILEPOST, NULL, NULL, false, curbuf);
       apply_autocmds(EVENT_BUFFILEPOST, NULL, NULL, false, alt_buf);
@@ -2246,6 +2342,12 @@ int do_ecmd(int fnum, char *ffname, char *sfname, exarg_T *eap, linenr_T newlnum
         if (newbuf != NULL && (flags & ECMD_ALTBUF)) {
           curwin->w_alt_fnum = newbuf->b_fnum;
         }
+        // While loading a session, read the file ahead in parallel with
+        // the files of other ":badd" lines, for when it is edited.
+        if (newbuf != NULL && newbuf->b_ml.ml_mfp == NULL && newbuf->b_ffname != NULL
+            && (flags & ECMD_ADDBUF) && get_var_value("g:SessionLoad") != NULL) {
+          os_prefetch_file(newbuf->b_ffname, SESSION_PREFETCH_MAX);
+        }
         goto theend;
       }
       buf = buflist_new(ffname, sfname, 0,
@@ -34,6 +34,7 @@
 #include "nvim/move.h"
 #include "nvim/normal.h"
 #include "nvim/option_vars.h"
+#include "nvim/os/fs.h"
 #include "nvim/os/os_defs.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
@@ -51,6 +52,12 @@
 static const char e_compiler_not_supported_str[]
   = N_("E666: Compiler not supported: %s");
 
+/// Number of files ":argdo" and ":bufdo" read ahead, and how much of each.
+enum {
+  LISTDO_PREFETCH = 8,
+  LISTDO_PREFETCH_MAX = 4 * 1024 * 1024,
+};
+
 void ex_ruby(exarg_T *eap)
 {
   script_host_execute("ruby", eap);
@@ -437,6 +444,44 @@ int buf_write_all(buf_T *buf, int forceit)
   return retval;
 }
 
+/// Read ahead the file of "buf" when it is not loaded yet.
+static void listdo_prefetch_buf(buf_T *buf)
+{
+  if (buf != NULL && buf->b_ml.ml_mfp == NULL && buf->b_ffname != NULL) {
+    os_prefetch_file(buf->b_ffname, LISTDO_PREFETCH_MAX);
+  }
+}
+
+/// For ":argdo" and ":bufdo": read ahead the files of the next few arguments
+/// or buffers in the libuv threadpool, while the command is executed for the
+/// current one, so that loading them doesn't have to wait for the disk.
+///
+/// @param next  the first argument index or buffer number that was not
+///              read ahead yet, updated
+static void listdo_prefetch(exarg_T *eap, int *next)
+{
+  if (eap->cmdidx == CMD_argdo) {
+    int last = MIN(curwin->w_arg_idx + LISTDO_PREFETCH, MIN(ARGCOUNT, (int)eap->line2) - 1);
+    for (int idx = MAX(*next, curwin->w_arg_idx + 1); idx <= last; idx++) {
+      listdo_prefetch_buf(buflist_findnr(ARGLIST[idx].ae_fnum));
+      *next = idx + 1;
+    }
+  } else if (eap->cmdidx == CMD_bufdo) {
+    int count = 0;
+    for (buf_T *bp = curbuf->b_next;
+         bp != NULL && bp->b_fnum <= eap->line2 && count < LISTDO_PREFETCH;
+         bp = bp->b_next) {
+      if (bp->b_p_bl) {
+        count++;
+        if (bp->b_fnum >= *next) {
+          listdo_prefetch_buf(bp);
+          *next = bp->b_fnum + 1;
+        }
+      }
+    }
+  }
+}
+
 /// ":argdo", ":windo", ":bufdo", ":tabdo", ":cdo", ":ldo", ":cfdo" and ":lfdo"
 void ex_listdo(exarg_T *eap)
 {
@@ -487,6 +532,7 @@ void ex_listdo(exarg_T *eap)
 
     buf_T *buf = curbuf;
     size_t qf_size = 0;
+    int prefetch_next = 0;
 
     // set pcmark now
     if (eap->cmdidx == CMD_bufdo) {
@@ -578,6 +624,7 @@ void ex_listdo(exarg_T *eap)
       i++;
       // execute the command
       if (execute) {
+        listdo_prefetch(eap, &prefetch_next);
         do_cmdline(eap->arg, eap->getline, eap->cookie, DOCMD_VERBOSE + DOCMD_NOWAIT);
       }
 
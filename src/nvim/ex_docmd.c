@@ -14,6 +14,7 @@
 #include "auto/config.h"
 #include "nvim/arglist.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/atomic_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
@@ -588,6 +589,10 @@ int do_cmdline(char *cmdline, LineGetter fgetline, void *cookie, int flags)
       msg_verbose_cmd(SOURCING_LNUM, cmdline_copy);
     }
 
+    if (ATOMIC_LOAD_BOOL(&profile_sample_due)) {
+      profile_sample_take();
+    }
+
     // 2. Execute one '|' separated command.
     //    do_one_cmd() will return NULL if there is no trailing '|'.
     //    "cmdline_copy" can change, e.g. for '%' and '#' expansion.
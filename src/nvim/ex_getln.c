@@ -28,6 +28,7 @@
 #include "nvim/eval.h"
 #include "nvim/eval/typval.h"
 #include "nvim/eval/vars.h"
+#include "nvim/event/defs.h"
 #include "nvim/ex_cmds.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/ex_docmd.h"
@@ -42,6 +43,7 @@
 #include "nvim/highlight_group.h"
 #include "nvim/keycodes.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/mapping.h"
 #include "nvim/mark.h"
@@ -101,6 +103,9 @@ typedef struct {
   bool did_incsearch;
   bool incsearch_postponed;
   optmagic_T magic_overruled_save;
+  char *resume_pat;       // pattern of a search that stopped for the time limit
+  linenr_T resume_lnum;   // where to continue that search
+  int resume_loop;
 } incsearch_state_T;
 
 typedef struct command_line_state {
@@ -231,12 +236,20 @@ static void restore_viewstate(win_T *wp, viewstate_T *vs)
   wp->w_empty_rows = vs->vs_empty_rows;
 }
 
+/// Wakes up the main loop to continue an incremental search, see
+/// may_do_incsearch_highlighting().
+static void incsearch_resume_event(void **argv)
+{
+}
+
 static void init_incsearch_state(incsearch_state_T *s)
 {
   s->match_start = curwin->w_cursor;
   s->did_incsearch = false;
   s->incsearch_postponed = false;
   s->magic_overruled_save = magic_overruled;
+  s->resume_pat = NULL;
+  s->resume_lnum = 0;
   clearpos(&s->match_end);
   s->save_cursor = curwin->w_cursor;  // may be restored later
   s->search_start = curwin->w_cursor;
@@ -454,9 +467,24 @@ static void may_do_incsearch_highlighting(int firstc, int count, incsearch_state
     searchit_arg_T sia = {
       .sa_tm = &tm,
     };
+    if (s->resume_lnum != 0 && strcmp(s->resume_pat, ccline.cmdbuff + skiplen) == 0) {
+      // Continue where the previous search for this pattern stopped.
+      sia.sa_resume_lnum = s->resume_lnum;
+      sia.sa_resume_loop = s->resume_loop;
+    }
+    XFREE_CLEAR(s->resume_pat);
+    s->resume_lnum = 0;
     found = do_search(NULL, firstc == ':' ? '/' : firstc, search_delim,
                       ccline.cmdbuff + skiplen, count,
                       search_flags, &sia);
+    if (found == 0 && sia.sa_stopped_lnum != 0 && !got_int) {
+      // Searching stopped for the time limit, continue after handling
+      // typeahead and events.
+      s->resume_pat = xstrdup(ccline.cmdbuff + skiplen);
+      s->resume_lnum = sia.sa_stopped_lnum;
+      s->resume_loop = sia.sa_stopped_loop;
+      multiqueue_put(main_loop.events, incsearch_resume_event, NULL);
+    }
     ccline.cmdbuff[skiplen + patlen] = next_char;
     emsg_off--;
     if (curwin->w_cursor.lnum < search_first_line
@@ -587,6 +615,9 @@ static int may_add_char_to_search(int firstc, int *c, incsearch_state_T *s)
 static void finish_incsearch_highlighting(bool gotesc, incsearch_state_T *s,
                                           bool call_update_screen)
 {
+  XFREE_CLEAR(s->resume_pat);
+  s->resume_lnum = 0;
+
   if (!s->did_incsearch) {
     return;
   }
@@ -1069,6 +1100,10 @@ static int command_line_wildchar_complete(CommandLineState *s)
     s->wim_index = 0;
     int j = ccline.cmdpos;
 
+    // With "interrupt" in 'wildoptions' a key typed while finding the
+    // matches stops it, like CTRL-C.
+    input_set_typed_key_interrupts(wop_flags & WOP_INTERRUPT);
+
     // if 'wildmode' first contains "longest", get longest
     // common part
     if (wim_flags[0] & WIM_LONGEST) {
@@ -1076,10 +1111,15 @@ static int command_line_wildchar_complete(CommandLineState *s)
     } else {
       res = nextwild(&s->xpc, WILD_EXPAND_KEEP, options, s->firstc != '@');
     }
+    input_set_typed_key_interrupts(false);
 
     // if interrupted while completing, behave like it failed
     if (got_int) {
-      (void)vpeekc();               // remove <C-C> from input stream
+      // Peeking with got_int set flushes the input.  That is wanted for
+      // CTRL-C, not for a key typed with "interrupt" in 'wildoptions'.
+      if (!input_typed_key_interrupted()) {
+        (void)vpeekc();             // remove <C-C> from input stream
+      }
       got_int = false;              // don't abandon the command line
       (void)ExpandOne(&s->xpc, NULL, NULL, 0, WILD_FREE);
       s->xpc.xp_context = EXPAND_NOTHING;
@@ -1161,6 +1201,9 @@ static int command_line_execute(VimState *state, int key)
   if (s->c == K_EVENT || s->c == K_COMMAND || s->c == K_LUA) {
     if (s->c == K_EVENT) {
       state_handle_k_event();
+      if (s->is_state.resume_lnum != 0 && !char_avail()) {
+        may_do_incsearch_highlighting(s->firstc, s->count, &s->is_state);
+      }
     } else if (s->c == K_COMMAND) {
       do_cmdline(NULL, getcmdkeycmd, NULL, DOCMD_NOWAIT);
     } else {
@@ -48,16 +48,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/eval.h"
 #include "nvim/eval/typval.h"
 #include "nvim/file_search.h"
+#include "nvim/garray.h"
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -66,6 +70,7 @@
 #include "nvim/os/fs.h"
 #include "nvim/os/input.h"
 #include "nvim/os/os.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/strings.h"
 #include "nvim/vim_defs.h"
@@ -87,6 +92,7 @@ typedef struct ff_stack {
   char **ffs_filearray;
   int ffs_filearray_size;
   int ffs_filearray_cur;                  // needed for partly handled dirs
+  bool ffs_filearray_dirs;                // all files are known directories
 
   // to store status of partly handled directories
   // 0: we work on this directory for the first time
@@ -173,6 +179,31 @@ typedef struct ff_search_ctx_T {
   int ffsc_tagfile;
 } ff_search_ctx_T;
 
+// The subdirectories of a directory, listed for "**" and "*" in
+// vim_findfile() and kept for the next search.  The listing is used again as
+// long as the mtime of the directory is the same, since adding, removing or
+// renaming an entry changes it.  Symbolic links are kept apart and checked
+// each time, the target can become a directory without the mtime changing.
+typedef struct {
+  int64_t mtime;
+  int64_t mtime_ns;
+  bool racy;                    // mtime was too recent to trust
+  kvec_t(char *) subdirs;
+  kvec_t(char *) links;
+} ff_dir_T;
+
+static PMap(cstr_t) ff_dir_cache = MAP_INIT;
+
+// Clear the cache when it has more directories than this.
+#define FF_DIR_CACHE_MAX 20000
+
+// Characters that make expand_wildcards() do more than list a directory.
+#ifdef BACKSLASH_IN_FILENAME
+# define FF_DIR_SPECIAL "*?[~$`%"
+#else
+# define FF_DIR_SPECIAL "*?[{~$`\\"
+#endif
+
 // locally needed functions
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
@@ -731,6 +762,9 @@ char *vim_findfile(void *search_ctx_arg)
           stackp->ffs_filearray = xmalloc(sizeof(char *));
           stackp->ffs_filearray[0] = xstrdup(dirptrs[0]);
           stackp->ffs_filearray_size = 1;
+        } else if (ff_expand_dir_cached(dirptrs, &stackp->ffs_filearray_size,
+                                        &stackp->ffs_filearray)) {
+          stackp->ffs_filearray_dirs = true;
         } else {
           // Add EW_NOTWILD because the expanded path may contain
           // wildcard characters that are to be taken literally.
@@ -754,6 +788,7 @@ char *vim_findfile(void *search_ctx_arg)
           // check for the final file now.
           for (int i = stackp->ffs_filearray_cur; i < stackp->ffs_filearray_size; i++) {
             if (!path_with_url(stackp->ffs_filearray[i])
+                && !stackp->ffs_filearray_dirs
                 && !os_isdir(stackp->ffs_filearray[i])) {
               continue;                 // not a directory
             }
@@ -839,7 +874,7 @@ char *vim_findfile(void *search_ctx_arg)
         } else {
           // still wildcards left, push the directories for further search
           for (int i = stackp->ffs_filearray_cur; i < stackp->ffs_filearray_size; i++) {
-            if (!os_isdir(stackp->ffs_filearray[i])) {
+            if (!stackp->ffs_filearray_dirs && !os_isdir(stackp->ffs_filearray[i])) {
               continue;                 // not a directory
             }
             ff_push(search_ctx,
@@ -861,7 +896,7 @@ char *vim_findfile(void *search_ctx_arg)
                             stackp->ffs_fix_path) == 0) {
             continue;             // don't repush same directory
           }
-          if (!os_isdir(stackp->ffs_filearray[i])) {
+          if (!stackp->ffs_filearray_dirs && !os_isdir(stackp->ffs_filearray[i])) {
             continue;               // not a directory
           }
           ff_push(search_ctx,
@@ -1121,6 +1156,7 @@ static ff_stack_T *ff_create_stack_element(char *fix_part, char *wc_part, int le
   stack->ffs_filearray = NULL;
   stack->ffs_filearray_size = 0;
   stack->ffs_filearray_cur = 0;
+  stack->ffs_filearray_dirs = false;
   stack->ffs_stage = 0;
   stack->ffs_level = level;
   stack->ffs_star_star_empty = star_star_empty;
@@ -1294,10 +1330,193 @@ char *find_file_in_path(char *ptr, size_t len, int options, int first, char *rel
                                   file_to_find, search_ctx);
 }
 
+/// Get the subdirectories of directory "path" from the cache, listing them
+/// again if the directory was modified.
+///
+/// @return NULL if "path" is not a directory.
+static ff_dir_T *ff_dir_cache_get(const char *path)
+{
+  FileInfo file_info;
+  if (!os_fileinfo(path, &file_info) || !S_ISDIR(file_info.stat.st_mode)) {
+    return NULL;
+  }
+  int64_t mtime = file_info.stat.st_mtim.tv_sec;
+  int64_t mtime_ns = file_info.stat.st_mtim.tv_nsec;
+
+  ff_dir_T *dc = pmap_get(cstr_t)(&ff_dir_cache, path);
+  if (dc != NULL && !dc->racy && dc->mtime == mtime && dc->mtime_ns == mtime_ns) {
+    return dc;
+  }
+
+  uv_fs_t req;
+  if (uv_fs_scandir(NULL, &req, path, 0, NULL) < 0) {
+    uv_fs_req_cleanup(&req);
+    return NULL;
+  }
+  if (dc == NULL) {
+    if (map_size(&ff_dir_cache) >= FF_DIR_CACHE_MAX) {
+      ff_dir_cache_clear();
+    }
+    const char **key_alloc;
+    ptr_t *ref = pmap_put_ref(cstr_t)(&ff_dir_cache, path, &key_alloc, NULL);
+    *key_alloc = xstrdup(path);
+    dc = *ref = xcalloc(1, sizeof(ff_dir_T));
+  } else {
+    ff_dir_free_names(dc);
+  }
+
+  char *fname = xmalloc(MAXPATHL);
+  uv_dirent_t ent;
+  while (uv_fs_scandir_next(&req, &ent) != UV_EOF) {
+    // Like expand_wildcards() for "*", don't include hidden directories.
+    if (ent.name[0] == '.') {
+      continue;
+    }
+#ifdef FNAME_ILLEGAL
+    if (strpbrk(ent.name, FNAME_ILLEGAL) != NULL) {
+      continue;
+    }
+#endif
+    if (ent.type == UV_DIRENT_DIR) {
+      kv_push(dc->subdirs, xstrdup(ent.name));
+    } else if (ent.type == UV_DIRENT_LINK) {
+      kv_push(dc->links, xstrdup(ent.name));
+    } else if (ent.type == UV_DIRENT_UNKNOWN
+               && strlen(path) + strlen(ent.name) < MAXPATHL) {
+      // The file system doesn't say, stat it now.  The type of an entry
+      // can only change by replacing it, which changes the mtime.
+      STRCPY(fname, path);
+      STRCAT(fname, ent.name);
+      FileInfo info;
+      if (os_fileinfo_link(fname, &info)) {
+        if (S_ISLNK(info.stat.st_mode)) {
+          kv_push(dc->links, xstrdup(ent.name));
+        } else if (S_ISDIR(info.stat.st_mode)) {
+          kv_push(dc->subdirs, xstrdup(ent.name));
+        }
+      }
+    }
+  }
+  xfree(fname);
+  uv_fs_req_cleanup(&req);
+
+  dc->mtime = mtime;
+  dc->mtime_ns = mtime_ns;
+  // An entry added later in the same tick of the file system clock would not
+  // change the mtime.
+  dc->racy = mtime >= (int64_t)os_time() - 1;
+  return dc;
+}
+
+static void ff_dir_free_names(ff_dir_T *dc)
+{
+  for (size_t i = 0; i < kv_size(dc->subdirs); i++) {
+    xfree(kv_A(dc->subdirs, i));
+  }
+  for (size_t i = 0; i < kv_size(dc->links); i++) {
+    xfree(kv_A(dc->links, i));
+  }
+  kv_size(dc->subdirs) = 0;
+  kv_size(dc->links) = 0;
+}
+
+static void ff_dir_cache_clear(void)
+{
+  const char *path;
+  ff_dir_T *dc;
+  map_foreach(&ff_dir_cache, path, dc, {
+    ff_dir_free_names(dc);
+    kv_destroy(dc->subdirs);
+    kv_destroy(dc->links);
+    xfree(dc);
+    xfree((char *)path);
+  });
+  map_destroy(cstr_t, &ff_dir_cache);
+}
+
+static int ff_pathcmp(const void *a, const void *b)
+{
+  return pathcmp(*(char **)a, *(char **)b, -1);
+}
+
+/// Expand "dirptrs" for vim_findfile() like expand_wildcards() with EW_DIR,
+/// using the cache of directory listings.  Only done when dirptrs[0] is an
+/// absolute directory name followed by "*", which is what "**" and "*" in
+/// 'path' come down to.  Saves reading the directory and a stat() for every
+/// entry when the same tree is searched again, e.g. by "gf" or ":find".
+///
+/// @return false if the cache can't be used, nothing was expanded then.
+static bool ff_expand_dir_cached(char **dirptrs, int *num_files, char ***files)
+{
+  char *pat = dirptrs[0];
+  size_t len = strlen(pat);
+  if (len < 2 || pat[len - 1] != '*' || !vim_ispathsep(pat[len - 2])
+      || !vim_isAbsName(pat)) {
+    return false;
+  }
+  for (size_t i = 0; i < len - 1; i++) {
+    if (vim_strchr(FF_DIR_SPECIAL, (uint8_t)pat[i]) != NULL) {
+      return false;
+    }
+  }
+
+  pat[len - 1] = NUL;
+  ff_dir_T *dc = ff_dir_cache_get(pat);
+
+  garray_T ga;
+  ga_init(&ga, (int)sizeof(char *), 30);
+  if (dc != NULL) {
+    for (size_t i = 0; i < kv_size(dc->subdirs) + kv_size(dc->links); i++) {
+      bool link = i >= kv_size(dc->subdirs);
+      const char *name = link ? kv_A(dc->links, i - kv_size(dc->subdirs)) : kv_A(dc->subdirs, i);
+      if (len + strlen(name) + 1 >= MAXPATHL) {
+        continue;
+      }
+      char *p = xmalloc(len + strlen(name) + 2);
+      STRCPY(p, pat);
+      STRCAT(p, name);
+      if (link && !os_isdir(p)) {
+        xfree(p);
+        continue;
+      }
+#ifdef BACKSLASH_IN_FILENAME
+      slash_adjust(p);
+#endif
+      add_pathsep(p);
+      GA_APPEND(char *, &ga, p);
+    }
+    if (ga.ga_len > 1) {
+      qsort(ga.ga_data, (size_t)ga.ga_len, sizeof(char *), ff_pathcmp);
+    }
+  }
+  pat[len - 1] = '*';
+
+  // The directory itself, for "**" expanding to nothing.
+  if (dirptrs[1] != NULL) {
+    int num_fix;
+    char **fix;
+    if (gen_expand_wildcards(1, &dirptrs[1], &num_fix, &fix,
+                             EW_DIR|EW_ADDSLASH|EW_SILENT|EW_NOTWILD) == OK) {
+      for (int i = 0; i < num_fix; i++) {
+        GA_APPEND(char *, &ga, fix[i]);
+      }
+      xfree(fix);
+    }
+  }
+
+  *num_files = ga.ga_len;
+  *files = ga.ga_data;
+  if (*num_files > 0) {
+    expand_wildcards_filter(num_files, files);
+  }
+  return true;
+}
+
 #if defined(EXITFREE)
 void free_findfile(void)
 {
   XFREE_CLEAR(ff_expand_buffer);
+  ff_dir_cache_clear();
 }
 #endif
 
@@ -170,6 +170,7 @@ int readfile(char *fname, char *sfname, linenr_T from, linenr_T lines_to_skip,
   linenr_T lnum = from;
   char *ptr = NULL;              // pointer into read buffer
   char *buffer = NULL;           // read buffer
+  size_t buffer_size = 0;        // allocated size of "buffer"
   char *new_buffer = NULL;       // init to shut up gcc
   char *line_start = NULL;       // init to shut up gcc
   int wasempty;                         // buffer was empty before reading
@@ -866,6 +867,15 @@ retry:
                       && !read_fifo
                       && !read_stdin
                       && !read_buffer);
+    if (read_undo_file) {
+      // Only hash the text when there is an undo file to check it against,
+      // computing the hash of a huge file is a considerable part of reading it.
+      char *undo_fname = u_get_undo_file_name(curbuf->b_ffname, true);
+      if (undo_fname == NULL) {
+        read_undo_file = false;
+      }
+      xfree(undo_fname);
+    }
     if (read_undo_file) {
       sha256_start(&sha_ctx);
     }
@@ -893,21 +903,30 @@ retry:
         *ptr = NL;  // split line by inserting a NL
         size = 1;
       } else if (!skip_read) {
-        for (; size >= 10; size /= 2) {
-          new_buffer = verbose_try_malloc((size_t)size + (size_t)linerest + 1);
-          if (new_buffer) {
+        if (buffer != NULL && (size_t)size + (size_t)linerest + 1 <= buffer_size) {
+          // The previous buffer is big enough: only move the partial line
+          // to the start, avoids an allocation for every chunk of a big file.
+          if (linerest) {
+            memmove(buffer, ptr - linerest, (size_t)linerest);
+          }
+        } else {
+          for (; size >= 10; size /= 2) {
+            new_buffer = verbose_try_malloc((size_t)size + (size_t)linerest + 1);
+            if (new_buffer) {
+              break;
+            }
+          }
+          if (new_buffer == NULL) {
+            error = true;
             break;
           }
+          if (linerest) {       // copy characters from the previous buffer
+            memmove(new_buffer, ptr - linerest, (size_t)linerest);
+          }
+          xfree(buffer);
+          buffer = new_buffer;
+          buffer_size = (size_t)size + (size_t)linerest + 1;
         }
-        if (new_buffer == NULL) {
-          error = true;
-          break;
-        }
-        if (linerest) {         // copy characters from the previous buffer
-          memmove(new_buffer, ptr - linerest, (size_t)linerest);
-        }
-        xfree(buffer);
-        buffer = new_buffer;
         ptr = buffer + linerest;
         line_start = buffer;
 
@@ -1331,7 +1350,10 @@ retry:
           if (todo <= 0) {
             break;
           }
-          if (*p >= 0x80) {
+          if (*p < 0x80) {
+            // Skip over ASCII text, most of a file usually is.
+            p += utf_ascii_len((char *)p, (size_t)todo) - 1;
+          } else {
             // A length of 1 means it's an illegal byte.  Accept
             // an incomplete character at the end though, the next
             // read() will get the next bytes, we'll check it
@@ -1507,60 +1529,67 @@ rewind_retry:
         }
       }
     } else {
-      ptr--;
-      while (++ptr, --size >= 0) {
-        if ((c = *ptr) != NUL && c != NL) {        // catch most common case
-          continue;
+      while (size > 0) {
+        // Find the end of the line with memchr(), which is much faster than
+        // looking at every byte for long lines.
+        char *eol = memchr(ptr, NL, (size_t)size);
+        char *end = eol != NULL ? eol : ptr + size;
+        for (char *nul = memchr(ptr, NUL, (size_t)(end - ptr)); nul != NULL;
+             nul = memchr(nul + 1, NUL, (size_t)(end - nul - 1))) {
+          *nul = NL;            // NULs are replaced by newlines!
         }
-        if (c == NUL) {
-          *ptr = NL;            // NULs are replaced by newlines!
-        } else {
-          if (skip_count == 0) {
-            *ptr = NUL;                         // end of line
-            len = (colnr_T)(ptr - line_start + 1);
-            if (fileformat == EOL_DOS) {
-              if (ptr > line_start && ptr[-1] == CAR) {
-                // remove CR before NL
-                ptr[-1] = NUL;
-                len--;
-              } else if (ff_error != EOL_DOS) {
-                // Reading in Dos format, but no CR-LF found!
-                // When 'fileformats' includes "unix", delete all
-                // the lines read so far and start all over again.
-                // Otherwise give an error message later.
-                if (try_unix
-                    && !read_stdin
-                    && (read_buffer
-                        || vim_lseek(fd, 0, SEEK_SET) == 0)) {
-                  fileformat = EOL_UNIX;
-                  if (set_options) {
-                    set_fileformat(EOL_UNIX, OPT_LOCAL);
-                  }
-                  file_rewind = true;
-                  keep_fileformat = true;
-                  goto retry;
+        size -= end - ptr;
+        ptr = end;
+        if (eol == NULL) {
+          break;
+        }
+        if (skip_count == 0) {
+          *ptr = NUL;                         // end of line
+          len = (colnr_T)(ptr - line_start + 1);
+          if (fileformat == EOL_DOS) {
+            if (ptr > line_start && ptr[-1] == CAR) {
+              // remove CR before NL
+              ptr[-1] = NUL;
+              len--;
+            } else if (ff_error != EOL_DOS) {
+              // Reading in Dos format, but no CR-LF found!
+              // When 'fileformats' includes "unix", delete all
+              // the lines read so far and start all over again.
+              // Otherwise give an error message later.
+              if (try_unix
+                  && !read_stdin
+                  && (read_buffer
+                      || vim_lseek(fd, 0, SEEK_SET) == 0)) {
+                fileformat = EOL_UNIX;
+                if (set_options) {
+                  set_fileformat(EOL_UNIX, OPT_LOCAL);
                 }
-                ff_error = EOL_DOS;
+                file_rewind = true;
+                keep_fileformat = true;
+                goto retry;
               }
+              ff_error = EOL_DOS;
             }
-            if (ml_append(lnum, line_start, len, newfile) == FAIL) {
-              error = true;
-              break;
-            }
-            if (read_undo_file) {
-              sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
-            }
-            lnum++;
-            if (--read_count == 0) {
-              error = true;                         // break loop
-              line_start = ptr;                 // nothing left to write
-              break;
-            }
-          } else {
-            skip_count--;
           }
-          line_start = ptr + 1;
+          if (ml_append(lnum, line_start, len, newfile) == FAIL) {
+            error = true;
+            break;
+          }
+          if (read_undo_file) {
+            sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
+          }
+          lnum++;
+          if (--read_count == 0) {
+            error = true;                         // break loop
+            line_start = ptr;                 // nothing left to write
+            break;
+          }
+        } else {
+          skip_count--;
         }
+        line_start = ptr + 1;
+        ptr++;
+        size--;
       }
     }
     linerest = (ptr - line_start);
@@ -1816,6 +1845,9 @@ failed:
   // for ":autocmd FileReadPost *.gz set bin|'[,']!gunzip" to work.
   curbuf->b_no_eol_lnum = read_no_eol_lnum;
 
+  // The text was changed without changing b:changedtick.
+  curbuf->b_u_hash_valid = false;
+
   // When reloading a buffer put the cursor at the first line that is
   // different.
   if (flags & READ_KEEP_UNDO) {
@@ -1872,6 +1904,7 @@ failed:
   }
 
 theend:
+  curbuf->b_u_hash_valid = false;
   if (curbuf->b_ml.ml_mfp != NULL
       && curbuf->b_ml.ml_mfp->mf_dirty == MF_DIRTY_YES_NOSYNC) {
     // OK to sync the swap file now
@@ -2816,6 +2849,8 @@ int check_timestamps(int focus)
   return didit;
 }
 
+#define MOVE_LINES_COUNT 256  // lines copied at once by move_lines()
+
 /// Move all the lines from buffer "frombuf" to buffer "tobuf".
 ///
 /// @return  OK or FAIL.
@@ -2825,16 +2860,23 @@ static int move_lines(buf_T *frombuf, buf_T *tobuf)
   buf_T *tbuf = curbuf;
   int retval = OK;
 
-  // Copy the lines in "frombuf" to "tobuf".
+  // Copy the lines in "frombuf" to "tobuf", a data block at a time.  The text
+  // in the block of "frombuf" stays valid while appending to "tobuf".
   curbuf = tobuf;
-  for (linenr_T lnum = 1; lnum <= frombuf->b_ml.ml_line_count; lnum++) {
-    char *p = xstrdup(ml_get_buf(frombuf, lnum));
-    if (ml_append(lnum - 1, p, 0, false) == FAIL) {
-      xfree(p);
+  char *lines[MOVE_LINES_COUNT];
+  colnr_T lens[MOVE_LINES_COUNT];
+  for (linenr_T lnum = 1; lnum <= frombuf->b_ml.ml_line_count;) {
+    int count = ml_get_buf_lines(frombuf, lnum,
+                                 MIN(MOVE_LINES_COUNT, frombuf->b_ml.ml_line_count - lnum + 1),
+                                 lines, lens);
+    for (int i = 0; i < count; i++) {
+      lens[i]++;  // include the NUL
+    }
+    if (ml_append_buf_lines(tobuf, lnum - 1, lines, lens, count, false) != count) {
       retval = FAIL;
       break;
     }
-    xfree(p);
+    lnum += count;
   }
 
   // Delete all the lines in "frombuf".
@@ -3361,6 +3403,7 @@ int readdir_core(garray_T *gap, const char *path, void *context, CheckItem check
     smsg(0, _(e_notopen), path);
     return FAIL;
   }
+  ga_reserve(gap, (int)MIN(os_scandir_count(&dir), INT_MAX));
 
   while (true) {
     const char *p = os_scandir_next(&dir);
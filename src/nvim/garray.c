@@ -89,8 +89,27 @@ void ga_grow(garray_T *gap, int n)
     n = gap->ga_len / 2;
   }
 
-  int new_maxlen = gap->ga_len + n;
+  ga_realloc(gap, gap->ga_len + n);
+}
 
+/// Make room in growing array "gap" for "n" more items, when the caller knows
+/// how many items it is going to add. Unlike ga_grow() this allocates exactly
+/// what is asked for, so a loop that calls ga_grow() afterwards does not need
+/// to reallocate until it adds more than "n" items.
+///
+/// @param gap
+/// @param n
+void ga_reserve(garray_T *gap, int n)
+{
+  if (gap->ga_maxlen - gap->ga_len >= n) {
+    return;
+  }
+  ga_realloc(gap, gap->ga_len + n);
+}
+
+/// Reallocate the items of "gap" to "new_maxlen" and clear the new memory.
+static void ga_realloc(garray_T *gap, int new_maxlen)
+{
   size_t new_size = (size_t)gap->ga_itemsize * (size_t)new_maxlen;
   size_t old_size = (size_t)gap->ga_itemsize * (size_t)gap->ga_maxlen;
 
@@ -688,6 +688,7 @@ local function process_function(fn)
   {
     Error err = ERROR_INIT;
     char *err_param = 0;
+    Arena args_arena = ARENA_EMPTY;
     if (lua_gettop(lstate) != %i) {
       api_set_error(&err, kErrorTypeValidation, "Expected %i argument%s");
       goto exit_0;
@@ -751,6 +752,19 @@ local function process_function(fn)
     if param[1] == 'Object' or param[1] == 'DictionaryOf(LuaRef)' then
       extra = 'true, '
     end
+    -- Arguments without LuaRefs are allocated in an arena that is freed after
+    -- the call. Functions that can be called remotely already get their
+    -- arguments from an arena, but Lua-only ones may keep them.
+    local in_arena = false
+    if
+      param_type == 'String'
+      or param_type == 'Array'
+      or param_type == 'Dictionary'
+      or param_type == 'Object'
+    then
+      in_arena = extra ~= 'true, ' and not fn.lua_only
+      extra = extra .. (in_arena and '&args_arena, ' or 'NULL, ')
+    end
     local errshift = 0
     local seterr = ''
     if string.match(param_type, '^KeyDict_') then
@@ -793,7 +807,11 @@ local function process_function(fn)
 
     ]], #fn.parameters - j + errshift)
     )
-    free_code[#free_code + 1] = ('api_free_%s(%s);'):format(lc_param_type, cparam)
+    if in_arena then
+      free_code[#free_code + 1] = ';'
+    else
+      free_code[#free_code + 1] = ('api_free_%s(%s);'):format(lc_param_type, cparam)
+    end
     cparams = cparam .. ', ' .. cparams
   end
   if fn.receives_channel_id then
@@ -831,6 +849,7 @@ local function process_function(fn)
   local err_throw_code = [[
 
   exit_0:
+    arena_mem_free(arena_finish(&args_arena));
     if (ERROR_SET(&err)) {
       luaL_where(lstate, 1);
       if (err_param) {
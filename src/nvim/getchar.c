@@ -14,6 +14,7 @@
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/atomic_defs.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/charset.h"
 #include "nvim/cursor.h"
@@ -1375,8 +1376,10 @@ int using_script(void)
 /// waiting 'updatetime' for a character to arrive.
 void before_blocking(void)
 {
+  // Waiting for a key is not worth a sample.
+  ATOMIC_STORE_BOOL(&profile_sample_due, false);
   updatescript(0);
-  if (may_garbage_collect) {
+  if (may_garbage_collect && garbage_collect_when_idle()) {
     garbage_collect(false);
   }
 }
@@ -1396,7 +1399,8 @@ static void updatescript(int c)
   bool idle = (c == 0);
   if (idle || (p_uc > 0 && ++count >= p_uc)) {
     ml_sync_all(idle, true,
-                (!!p_fs || idle));  // Always fsync at idle (CursorHold).
+                (!!p_fs || idle),  // Always fsync at idle (CursorHold).
+                true);
     count = 0;
   }
 }
@@ -2007,37 +2011,46 @@ static int handle_mapping(int *keylenp, const bool *timedout, int *mapdepth)
     // and "aaa" can both be mapped.
     mp_match = NULL;
     mp_match_len = 0;
+    // The typeahead as it is compared with the LHS of a mapping, with
+    // 'langmap' applied. It does not depend on the mapping, so it is computed
+    // once, as far as the mappings need it.
+    int tb_keys[MAXMAPLEN + 1] = { tb_c1 };
+    int tb_keys_len = 1;
+    int tb_nomap = nolmaplen;
+    int tb_modifiers = 0;
     for (; mp != NULL; mp->m_next == NULL ? (mp = mp2, mp2 = NULL) : (mp = mp->m_next)) {
       // Only consider an entry if the first character matches and it is
       // for the current state.
       // Skip ":lmap" mappings if keys were mapped.
       if ((uint8_t)mp->m_keys[0] == tb_c1 && (mp->m_mode & local_State)
           && ((mp->m_mode & MODE_LANGMAP) == 0 || typebuf.tb_maplen == 0)) {
-        int nomap = nolmaplen;
-        int modifiers = 0;
-        // find the match length of this mapping
-        for (mlen = 1; mlen < typebuf.tb_len; mlen++) {
-          int c2 = typebuf.tb_buf[typebuf.tb_off + mlen];
-          if (nomap > 0) {
-            if (nomap == 2 && c2 == KS_MODIFIER) {
-              modifiers = 1;
-            } else if (nomap == 1 && modifiers == 1) {
-              modifiers = c2;
-            }
-            nomap--;
-          } else {
-            if (c2 == K_SPECIAL) {
-              nomap = 2;
-            } else if (merge_modifiers(c2, &modifiers) == c2) {
-              // Only apply 'langmap' if merging modifiers into
-              // the key will not result in another character,
-              // so that 'langmap' behaves consistently in
-              // different terminals and GUIs.
-              LANGMAP_ADJUST(c2, true);
+        // find the match length of this mapping, the NUL after its LHS
+        // stops this at "m_keylen" (at most MAXMAPLEN)
+        for (mlen = 1; mlen < typebuf.tb_len && mlen <= MAXMAPLEN; mlen++) {
+          if (mlen == tb_keys_len) {
+            int c2 = typebuf.tb_buf[typebuf.tb_off + mlen];
+            if (tb_nomap > 0) {
+              if (tb_nomap == 2 && c2 == KS_MODIFIER) {
+                tb_modifiers = 1;
+              } else if (tb_nomap == 1 && tb_modifiers == 1) {
+                tb_modifiers = c2;
+              }
+              tb_nomap--;
+            } else {
+              if (c2 == K_SPECIAL) {
+                tb_nomap = 2;
+              } else if (merge_modifiers(c2, &tb_modifiers) == c2) {
+                // Only apply 'langmap' if merging modifiers into
+                // the key will not result in another character,
+                // so that 'langmap' behaves consistently in
+                // different terminals and GUIs.
+                LANGMAP_ADJUST(c2, true);
+              }
+              tb_modifiers = 0;
             }
-            modifiers = 0;
+            tb_keys[tb_keys_len++] = c2;
           }
-          if ((uint8_t)mp->m_keys[mlen] != c2) {
+          if ((uint8_t)mp->m_keys[mlen] != tb_keys[mlen]) {
             break;
           }
         }
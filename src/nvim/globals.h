@@ -86,7 +86,22 @@ EXTERN struct nvim_stats_s {
   int64_t fsync;
   int64_t redraw;
   int16_t log_skip;  // How many logs were tried and skipped before log_init.
-} g_stats INIT( = { 0, 0, 0 });
+  int64_t memfile_hit;    // memfile blocks found in memory
+  int64_t memfile_miss;   // memfile blocks read from the swapfile
+  int64_t memfile_evict;  // memfile blocks released for 'maxmem' and 'maxmemtot'
+  int64_t memfile_pack;   // memfile blocks compressed for 'maxmem' and 'maxmemtot'
+  int64_t undo_pack;      // undo entries compressed for 'maxmemundo'
+  int64_t regexp_cache_hit;   // compiled patterns found in the cache
+  int64_t regexp_cache_miss;  // compiled patterns not found in the cache
+  int64_t glyph_cache_hit;    // glyphs already interned in the glyph cache
+  int64_t glyph_cache_miss;   // glyphs added to the glyph cache
+  int64_t glyph_cache_clear;  // times the glyph cache was cleared
+  int64_t syntax_prefill;     // lines parsed ahead of the display
+  int64_t syntax_skip;        // syntax patterns not tried on a line without their text
+  int64_t spell_cache_hit;    // words of a redrawn line not spell checked again
+  int64_t hl_table_reset;     // times the highlight attr table was full and cleared
+  int64_t hl_blend_clear;     // times blends using the Normal colors were cleared
+} g_stats INIT( = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 });
 
 // Values for "starting".
 #define NO_SCREEN       2       // no screen updating yet
@@ -222,6 +237,9 @@ EXTERN int debug_backtrace_level INIT( = 0);     // breakpoint backtrace level
 #define PROF_YES        1       ///< profiling busy
 #define PROF_PAUSED     2       ///< profiling paused
 EXTERN int do_profiling INIT( = PROF_NONE);      ///< PROF_ values
+/// Set by the ":profile sample" thread when it is time to take a sample.
+/// Only use it with ATOMIC_LOAD_BOOL() and ATOMIC_STORE_BOOL().
+EXTERN bool profile_sample_due INIT( = false);
 
 /// Exception currently being thrown.  Used to pass an exception to a different
 /// cstack.  Also used for discarding an exception before it is caught or made
@@ -286,6 +304,14 @@ EXTERN bool may_garbage_collect INIT( = false);
 EXTERN bool want_garbage_collect INIT( = false);
 EXTERN bool garbage_collect_at_exit INIT( = false);
 
+/// Number of lists and dicts that are allocated, the number of them that were
+/// allocated since the last garbage collection, and the number that was left
+/// after it.  Used to skip garbage collection in before_blocking() while
+/// there is little new to collect.
+EXTERN size_t gc_container_count INIT( = 0);
+EXTERN size_t gc_young_count INIT( = 0);
+EXTERN size_t gc_old_count INIT( = 0);
+
 // Special values for current_SID.
 #define SID_MODELINE    (-1)      // when using a modeline
 #define SID_CMDARG      (-2)      // for "--cmd" argument
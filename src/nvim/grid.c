@@ -91,6 +91,11 @@ schar_T schar_from_buf(const char *buf, size_t len)
     MHPutStatus status;
     uint32_t idx = set_put_idx(glyph, &glyph_cache, str, &status);
     assert(idx < 0xFFFFFF);
+    if (status == kMHExisting) {
+      g_stats.glyph_cache_hit++;
+    } else {
+      g_stats.glyph_cache_miss++;
+    }
 #ifdef ORDER_BIG_ENDIAN
     return idx + ((uint32_t)0xFF << 24);
 #else
@@ -120,6 +125,13 @@ void schar_cache_clear(void)
 {
   decor_check_invalid_glyphs();
   set_clear(glyph, &glyph_cache);
+  g_stats.glyph_cache_clear++;
+}
+
+/// @return number of bytes used by the interned glyphs
+size_t schar_cache_size(void)
+{
+  return glyph_cache.h.n_keys;
 }
 
 bool schar_high(schar_T sc)
@@ -635,6 +647,48 @@ static int grid_char_needs_redraw(ScreenGrid *grid, int col, size_t off_to, int
               || rdb_flags & RDB_NODELTA));
 }
 
+/// Number of cells compared at once by linebuf_first_diff() and
+/// linebuf_last_diff(), with memcmp() doing the wide comparison.
+#define LINEBUF_DIFF_BLOCK 16
+
+static bool linebuf_cells_equal(const schar_T *chars, const sattr_T *attrs, int col, int n)
+{
+  return memcmp(linebuf_char + col, chars + col, (size_t)n * sizeof(*chars)) == 0
+         && memcmp(linebuf_attr + col, attrs + col, (size_t)n * sizeof(*attrs)) == 0;
+}
+
+/// @return first column in [col, endcol) where linebuf_char[] or linebuf_attr[]
+///         differ from the grid line starting at `off_to`, or endcol.
+static int linebuf_first_diff(ScreenGrid *grid, size_t off_to, int col, int endcol)
+{
+  const schar_T *chars = grid->chars + off_to;
+  const sattr_T *attrs = grid->attrs + off_to;
+  while (col + LINEBUF_DIFF_BLOCK <= endcol
+         && linebuf_cells_equal(chars, attrs, col, LINEBUF_DIFF_BLOCK)) {
+    col += LINEBUF_DIFF_BLOCK;
+  }
+  while (col < endcol && linebuf_cells_equal(chars, attrs, col, 1)) {
+    col++;
+  }
+  return col;
+}
+
+/// @return column after the last one in [col, endcol) where linebuf_char[] or
+///         linebuf_attr[] differ from the grid line starting at `off_to`, or col.
+static int linebuf_last_diff(ScreenGrid *grid, size_t off_to, int col, int endcol)
+{
+  const schar_T *chars = grid->chars + off_to;
+  const sattr_T *attrs = grid->attrs + off_to;
+  while (endcol - LINEBUF_DIFF_BLOCK >= col
+         && linebuf_cells_equal(chars, attrs, endcol - LINEBUF_DIFF_BLOCK, LINEBUF_DIFF_BLOCK)) {
+    endcol -= LINEBUF_DIFF_BLOCK;
+  }
+  while (endcol > col && linebuf_cells_equal(chars, attrs, endcol - 1, 1)) {
+    endcol--;
+  }
+  return endcol;
+}
+
 /// Move one buffered line to the window grid, but only the characters that
 /// have actually changed.  Handle insert/delete character.
 /// "coloff" gives the first column on the grid for this line.
@@ -700,12 +754,32 @@ void grid_put_linebuf(ScreenGrid *grid, int row, int coloff, int col, int endcol
     }
   }
 
+  if (endcol > col) {
+    memcpy(grid->vcols + off_to + col, linebuf_vcol + col,
+           (size_t)(endcol - col) * sizeof(*linebuf_vcol));
+  }
+
+  // Skip the cells at both ends which are the same as in the grid, without
+  // splitting a double-width character.
+  int scan_end = endcol;
+  if (!exmode_active && !(rdb_flags & RDB_NODELTA)) {
+    int first = linebuf_first_diff(grid, off_to, col, endcol);
+    if (first > col && first < endcol && linebuf_char[first] == 0) {
+      first--;
+    }
+    col = first;
+    scan_end = linebuf_last_diff(grid, off_to, col, endcol);
+    if (scan_end < endcol && linebuf_char[scan_end] == 0) {
+      scan_end++;
+    }
+  }
+
   redraw_next = grid_char_needs_redraw(grid, col, (size_t)col + off_to, endcol - col);
 
   int start_dirty = -1;
   int end_dirty = 0;
 
-  while (col < endcol) {
+  while (col < scan_end) {
     int char_cells = 1;  // 1: normal char
                          // 2: occupies two display cells
     if (col + 1 < endcol && linebuf_char[col + 1] == 0) {
@@ -745,13 +819,9 @@ void grid_put_linebuf(ScreenGrid *grid, int row, int coloff, int col, int endcol
       }
     }
 
-    grid->vcols[off] = linebuf_vcol[col];
-    if (char_cells == 2) {
-      grid->vcols[off + 1] = linebuf_vcol[col + 1];
-    }
-
     col += char_cells;
   }
+  col = MAX(col, endcol);
 
   if (clear_next) {
     // Clear the second half of a double-wide character of which the left
@@ -21,6 +21,7 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "nvim/ascii_defs.h"
@@ -105,6 +106,51 @@ hashitem_T *hash_find_len(const hashtab_T *const ht, const char *const key, cons
   return hash_lookup(ht, key, len, hash_hash_len(key, len));
 }
 
+/// Entry in the cache of hash_find_cached().
+typedef struct {
+  const char *key;  ///< Key pointer the lookup was done with.
+  const hashtab_T *ht;  ///< Hashtab the item was found in.
+  int changed;  ///< ht_changed of "ht" at the time.
+  hashitem_T *hi;  ///< Found item.
+} HashCacheEntry;
+
+enum { HASH_CACHE_SIZE = 256, };
+
+static HashCacheEntry hash_cache[HASH_CACHE_SIZE];
+
+/// Like hash_find_len(), but remember where the key was found
+///
+/// Meant for keys that point into text which is evaluated many times, like
+/// the expression lines of a function: the next lookup with the same key
+/// pointer does not hash the key and probe the table again. Hashtabs can be
+/// freed and their memory reused, thus a cached item is only used when it is
+/// still in the array of "ht" and has the same key.
+///
+/// @param[in]  ht  Hashtab to look in.
+/// @param[in]  key  Key of the looked-for item. Must not be NULL.
+/// @param[in]  len  Key length.
+///
+/// @return Pointer to the hash item corresponding to the given key, or the
+///         empty item that would be used for it, like hash_find_len().
+hashitem_T *hash_find_cached(const hashtab_T *const ht, const char *const key, const size_t len)
+{
+  HashCacheEntry *const entry = &hash_cache[((uintptr_t)key >> 2) % HASH_CACHE_SIZE];
+  if (entry->key == key && entry->ht == ht && entry->changed == ht->ht_changed) {
+    hashitem_T *const hi = entry->hi;
+    if (hi >= ht->ht_array && hi <= ht->ht_array + ht->ht_mask
+        && !HASHITEM_EMPTY(hi)
+        && strncmp(hi->hi_key, key, len) == 0 && hi->hi_key[len] == NUL) {
+      return hi;
+    }
+  }
+
+  hashitem_T *const hi = hash_find_len(ht, key, len);
+  if (!HASHITEM_EMPTY(hi)) {
+    *entry = (HashCacheEntry){ .key = key, .ht = ht, .changed = ht->ht_changed, .hi = hi };
+  }
+  return hi;
+}
+
 /// Like hash_find(), but caller computes "hash".
 ///
 /// @param[in]  key  The key of the looked-for item. Must not be NULL.
@@ -397,28 +443,32 @@ static void hash_may_resize(hashtab_T *ht, size_t minitems)
 #define HASH_CYCLE_BODY(hash, p) \
   hash = hash * 101 + *p++
 
+// Powers of the multiplier, to do four steps of HASH_CYCLE_BODY() at once:
+// the four products do not depend on each other, which is a lot faster than
+// a chain of four multiplications.  The result is exactly the same, also when
+// it wraps around, thus the order of items in a table does not change.
+#define HASH_MUL2 ((hash_T)101 * 101)
+#define HASH_MUL3 ((hash_T)101 * 101 * 101)
+#define HASH_MUL4 ((hash_T)101 * 101 * 101 * 101)
+
+#define HASH_CYCLE_BODY4(hash, p) \
+  do { \
+    hash = hash * HASH_MUL4 + (hash_T)p[0] * HASH_MUL3 + (hash_T)p[1] * HASH_MUL2 \
+           + (hash_T)p[2] * 101 + p[3]; \
+    p += 4; \
+  } while (0)
+
 /// Get the hash number for a key.
 ///
 /// If you think you know a better hash function: Compile with HT_DEBUG set and
 /// run a script that uses hashtables a lot. Vim will then print statistics
 /// when exiting. Try that with the current hash algorithm and yours. The
 /// lower the percentage the better.
+/// Note that the order of the items in a dictionary depends on the hash
+/// function, and it shows in keys(), items() and string().
 hash_T hash_hash(const char *key)
 {
-  hash_T hash = (uint8_t)(*key);
-
-  if (hash == 0) {
-    return 0;
-  }
-
-  // A simplistic algorithm that appears to do very well.
-  // Suggested by George Reilly.
-  const uint8_t *p = (uint8_t *)key + 1;
-  while (*p != NUL) {
-    HASH_CYCLE_BODY(hash, p);
-  }
-
-  return hash;
+  return hash_hash_len(key, strlen(key));
 }
 
 /// Get the hash number for a key that is not a NUL-terminated string
@@ -437,10 +487,15 @@ hash_T hash_hash_len(const char *key, const size_t len)
     return 0;
   }
 
+  // A simplistic algorithm that appears to do very well.
+  // Suggested by George Reilly.
   hash_T hash = *(uint8_t *)key;
   const uint8_t *end = (uint8_t *)key + len;
 
   const uint8_t *p = (const uint8_t *)key + 1;
+  while (end - p >= 4) {
+    HASH_CYCLE_BODY4(hash, p);
+  }
   while (p < end) {
     HASH_CYCLE_BODY(hash, p);
   }
@@ -449,6 +504,10 @@ hash_T hash_hash_len(const char *key, const size_t len)
 }
 
 #undef HASH_CYCLE_BODY
+#undef HASH_CYCLE_BODY4
+#undef HASH_MUL2
+#undef HASH_MUL3
+#undef HASH_MUL4
 
 /// Function to get HI_KEY_REMOVED value
 ///
@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "nvim/ascii_defs.h"
 #include "nvim/buffer.h"
@@ -30,6 +31,7 @@
 #include "nvim/option_vars.h"
 #include "nvim/optionstr.h"
 #include "nvim/os/fs.h"
+#include "nvim/os/fs_defs.h"
 #include "nvim/os/input.h"
 #include "nvim/os/os.h"
 #include "nvim/path.h"
@@ -813,6 +815,249 @@ void ex_viusage(exarg_T *eap)
   do_cmdline_cmd("help normal-index");
 }
 
+/// Help file read in the threadpool by helptags_scan_files().
+typedef struct {
+  uv_work_t req;
+  const char *path;   ///< file to read
+  const char *fname;  ///< "path" relative to the doc directory
+  garray_T tags;      ///< "{tag}\t{fname}" for each tag, sorted
+  TriState utf8;      ///< whether the first line is UTF-8, kNone when empty
+  bool open_failed;
+} HelptagsJob;
+
+/// Extract the tags of one help file.  Runs in the threadpool, it uses no
+/// global state and gives no messages.
+static void helptags_scan_work(uv_work_t *req)
+{
+  HelptagsJob *job = req->data;
+  char line[IOSIZE];
+  char *s;
+
+  FILE *const fd = os_fopen(job->path, "r");
+  if (fd == NULL) {
+    job->open_failed = true;
+    return;
+  }
+
+  bool in_example = false;
+  bool firstline = true;
+  while (!vim_fgets(line, IOSIZE, fd)) {
+    if (firstline) {
+      // Detect utf-8 file by a non-ASCII char in the first line.
+      job->utf8 = kFalse;
+      for (s = line; *s != NUL; s++) {
+        if ((uint8_t)(*s) >= 0x80) {
+          job->utf8 = kTrue;
+          const int l = utf_ptr2len(s);
+          if (l == 1) {
+            // Illegal UTF-8 byte sequence.
+            job->utf8 = kFalse;
+            break;
+          }
+          s += l - 1;
+        }
+      }
+      firstline = false;
+    }
+    if (in_example) {
+      // skip over example; a non-white in the first column ends it
+      if (vim_strchr(" \t\n\r", (uint8_t)line[0])) {
+        continue;
+      }
+      in_example = false;
+    }
+    char *p1 = vim_strchr(line, '*');       // find first '*'
+    while (p1 != NULL) {
+      char *p2 = strchr(p1 + 1, '*');  // Find second '*'.
+      if (p2 != NULL && p2 > p1 + 1) {         // Skip "*" and "**".
+        for (s = p1 + 1; s < p2; s++) {
+          if (*s == ' ' || *s == '\t' || *s == '|') {
+            break;
+          }
+        }
+
+        // Only accept a *tag* when it consists of valid
+        // characters, there is white space before it and is
+        // followed by a white character or end-of-line.
+        if (s == p2
+            && (p1 == line || p1[-1] == ' ' || p1[-1] == '\t')
+            && (vim_strchr(" \t\n\r", (uint8_t)s[1]) != NULL
+                || s[1] == '\0')) {
+          *p2 = '\0';
+          p1++;
+          size_t s_len = (size_t)(p2 - p1) + strlen(job->fname) + 2;
+          s = xmalloc(s_len);
+          GA_APPEND(char *, &job->tags, s);
+          snprintf(s, s_len, "%s\t%s", p1, job->fname);
+
+          // find next '*'
+          p2 = vim_strchr(p2 + 1, '*');
+        }
+      }
+      p1 = p2;
+    }
+    size_t len = strlen(line);
+    if ((len == 2 && strcmp(&line[len - 2], ">\n") == 0)
+        || (len >= 3 && strcmp(&line[len - 3], " >\n") == 0)) {
+      in_example = true;
+    }
+  }
+
+  fclose(fd);
+
+  // Sorting here sorts the files in parallel, helptags_merge() only merges.
+  sort_strings(job->tags.ga_data, job->tags.ga_len);
+}
+
+static void helptags_scan_done(uv_work_t *req, int status)
+{
+}
+
+/// Read the help files of "jobs" in the libuv threadpool, and wait for them.
+/// Checks for CTRL-C as they finish, the files not started yet are skipped
+/// when it was typed.
+static void helptags_scan_files(HelptagsJob *jobs, int njobs)
+{
+  uv_loop_t loop;
+  bool use_pool = njobs > 1 && uv_loop_init(&loop) == 0;
+  for (int i = 0; i < njobs; i++) {
+    jobs[i].req.data = &jobs[i];
+    if (use_pool
+        && uv_queue_work(&loop, &jobs[i].req, helptags_scan_work, helptags_scan_done) == 0) {
+      continue;
+    }
+    if (!got_int) {
+      helptags_scan_work(&jobs[i].req);
+      line_breakcheck();
+    }
+  }
+  if (use_pool) {
+    bool cancelled = false;
+    while (uv_run(&loop, UV_RUN_ONCE) != 0) {
+      os_breakcheck();
+      if (got_int && !cancelled) {
+        for (int i = 0; i < njobs; i++) {
+          // Fails for a file that is being read or was read, which is fine.
+          uv_cancel((uv_req_t *)&jobs[i].req);
+        }
+        cancelled = true;
+      }
+    }
+    uv_loop_close(&loop);
+  }
+}
+
+/// Merge sorted tag arrays "a" and "b" into "out", which takes over the
+/// strings.  Clears "a" and "b".
+static void helptags_merge_two(garray_T *a, garray_T *b, garray_T *out)
+{
+  ga_init(out, (int)sizeof(char *), 100);
+  if (a->ga_len + b->ga_len > 0) {
+    ga_grow(out, a->ga_len + b->ga_len);
+  }
+  char **pa = a->ga_data;
+  char **pb = b->ga_data;
+  char **po = out->ga_data;
+  int i = 0;
+  int j = 0;
+  while (i < a->ga_len && j < b->ga_len) {
+    po[out->ga_len++] = strcmp(pa[i], pb[j]) <= 0 ? pa[i++] : pb[j++];
+  }
+  while (i < a->ga_len) {
+    po[out->ga_len++] = pa[i++];
+  }
+  while (j < b->ga_len) {
+    po[out->ga_len++] = pb[j++];
+  }
+  ga_clear(a);
+  ga_clear(b);
+}
+
+/// Merge the sorted tag arrays "runs" pairwise until one is left, which is
+/// moved to "out".  The result is sorted like sort_strings() sorts.
+static void helptags_merge(garray_T *runs, int nruns, garray_T *out)
+{
+  while (nruns > 1) {
+    for (int i = 0; i < nruns / 2; i++) {
+      garray_T merged;
+      helptags_merge_two(&runs[2 * i], &runs[2 * i + 1], &merged);
+      runs[i] = merged;
+    }
+    if (nruns % 2) {
+      runs[nruns / 2] = runs[nruns - 1];
+    }
+    nruns = (nruns + 1) / 2;
+  }
+  *out = runs[0];
+}
+
+/// @return  true if "info" is older than "tags_time".  A file changed in the
+///          same tick as the tags file was written may be newer, only an
+///          older time counts.
+static bool helptags_older(const FileInfo *info, uv_timespec_t tags_time)
+  FUNC_ATTR_NONNULL_ALL
+{
+  return info->stat.st_mtim.tv_sec < tags_time.tv_sec
+         || (info->stat.st_mtim.tv_sec == tags_time.tv_sec
+             && info->stat.st_mtim.tv_nsec < tags_time.tv_nsec);
+}
+
+/// Check whether directory "dir" and the directories below it, as far as "**"
+/// goes, are older than "tags_time".
+static bool helptags_dirs_older(const char *dir, uv_timespec_t tags_time, int depth)
+  FUNC_ATTR_NONNULL_ALL
+{
+  FileInfo info;
+  if (!os_fileinfo(dir, &info) || !helptags_older(&info, tags_time)) {
+    return false;
+  }
+  if (depth == 0) {
+    return true;
+  }
+
+  bool older = true;
+  Directory scan;
+  if (os_scandir(&scan, dir)) {
+    const char *name;
+    while (older && (name = os_scandir_next(&scan)) != NULL) {
+      if (scan.ent.type == UV_DIRENT_FILE) {
+        continue;
+      }
+      char *path = concat_fnames(dir, name, true);
+      if (os_isdir(path)) {
+        older = helptags_dirs_older(path, tags_time, depth - 1);
+      }
+      xfree(path);
+    }
+    os_closedir(&scan);
+  }
+  return older;
+}
+
+/// Check whether tags file "tagfname" is newer than directory "dir" and the
+/// help files in it.  Adding or removing a file changes the time of the
+/// directory it is in, thus all directories that "**" searches are checked.
+static bool helptags_uptodate(const char *tagfname, const char *dir, char **files, int filecount)
+  FUNC_ATTR_NONNULL_ALL
+{
+  FileInfo tags_info;
+  if (!os_fileinfo(tagfname, &tags_info)) {
+    return false;
+  }
+  const uv_timespec_t tags_time = tags_info.stat.st_mtim;
+  // Like "stardepth" in do_path_expand().
+  if (!helptags_dirs_older(dir, tags_time, 100)) {
+    return false;
+  }
+  for (int i = 0; i < filecount; i++) {
+    FileInfo info;
+    if (!os_fileinfo(files[i], &info) || !helptags_older(&info, tags_time)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /// Generate tags in one help directory
 ///
 /// @param dir  Path to the doc directory
@@ -821,8 +1066,10 @@ void ex_viusage(exarg_T *eap)
 ///                 French)
 /// @param add_help_tags  Whether to add the "help-tags" tag
 /// @param ignore_writeerr  ignore write error
+/// @param only_outdated  Do nothing when the tags file is newer than the
+///                       help files
 static void helptags_one(char *dir, const char *ext, const char *tagfname, bool add_help_tags,
-                         bool ignore_writeerr)
+                         bool ignore_writeerr, bool only_outdated)
   FUNC_ATTR_NONNULL_ALL
 {
   garray_T ga;
@@ -856,8 +1103,6 @@ static void helptags_one(char *dir, const char *ext, const char *tagfname, bool
     return;
   }
 
-  // Open the tags file for writing.
-  // Do this before scanning through all the files.
   memcpy(NameBuff, dir, dirlen + 1);
   if (!add_pathsep(NameBuff)
       || xstrlcat(NameBuff, tagfname, sizeof(NameBuff)) >= MAXPATHL) {
@@ -865,6 +1110,13 @@ static void helptags_one(char *dir, const char *ext, const char *tagfname, bool
     return;
   }
 
+  if (only_outdated && helptags_uptodate(NameBuff, dir, files, filecount)) {
+    FreeWild(filecount, files);
+    return;
+  }
+
+  // Open the tags file for writing.
+  // Do this before scanning through all the files.
   FILE *const fd_tags = os_fopen(NameBuff, "w");
   if (fd_tags == NULL) {
     if (!ignore_writeerr) {
@@ -874,111 +1126,58 @@ static void helptags_one(char *dir, const char *ext, const char *tagfname, bool
     return;
   }
 
+  // Go over all the files and extract the tags, the last run is for the
+  // "help-tags" tag.
+  HelptagsJob *jobs = xcalloc((size_t)filecount, sizeof(HelptagsJob));
+  garray_T *runs = xmalloc(((size_t)filecount + 1) * sizeof(garray_T));
+  for (int fi = 0; fi < filecount; fi++) {
+    jobs[fi].path = files[fi];
+    jobs[fi].fname = files[fi] + dirlen + 1;
+    jobs[fi].utf8 = kNone;
+    ga_init(&jobs[fi].tags, (int)sizeof(char *), 100);
+  }
+  helptags_scan_files(jobs, filecount);
+
   // If using the "++t" argument or generating tags for "$VIMRUNTIME/doc"
   // add the "help-tags" tag.
-  ga_init(&ga, (int)sizeof(char *), 100);
+  ga_init(&runs[filecount], (int)sizeof(char *), 1);
   if (add_help_tags
       || path_full_compare("$VIMRUNTIME/doc", dir, false, true) == kEqualFiles) {
     size_t s_len = 18 + strlen(tagfname);
     s = xmalloc(s_len);
     snprintf(s, s_len, "help-tags\t%s\t1\n", tagfname);
-    GA_APPEND(char *, &ga, s);
+    GA_APPEND(char *, &runs[filecount], s);
   }
 
-  // Go over all the files and extract the tags.
+  // Report the files in order, as when they were read one after the other.
   for (int fi = 0; fi < filecount && !got_int; fi++) {
-    FILE *const fd = os_fopen(files[fi], "r");
-    if (fd == NULL) {
+    if (jobs[fi].open_failed) {
       semsg(_("E153: Unable to open %s for reading"), files[fi]);
       continue;
     }
-    const char *const fname = files[fi] + dirlen + 1;
-
-    bool in_example = false;
-    bool firstline = true;
-    while (!vim_fgets(IObuff, IOSIZE, fd) && !got_int) {
-      if (firstline) {
-        // Detect utf-8 file by a non-ASCII char in the first line.
-        TriState this_utf8 = kNone;
-        for (s = IObuff; *s != NUL; s++) {
-          if ((uint8_t)(*s) >= 0x80) {
-            this_utf8 = kTrue;
-            const int l = utf_ptr2len(s);
-            if (l == 1) {
-              // Illegal UTF-8 byte sequence.
-              this_utf8 = kFalse;
-              break;
-            }
-            s += l - 1;
-          }
-        }
-        if (this_utf8 == kNone) {           // only ASCII characters found
-          this_utf8 = kFalse;
-        }
-        if (utf8 == kNone) {                // first file
-          utf8 = this_utf8;
-        } else if (utf8 != this_utf8) {
-          semsg(_("E670: Mix of help file encodings within a language: %s"),
-                files[fi]);
-          mix = !got_int;
-          got_int = true;
-        }
-        firstline = false;
-      }
-      if (in_example) {
-        // skip over example; a non-white in the first column ends it
-        if (vim_strchr(" \t\n\r", (uint8_t)IObuff[0])) {
-          continue;
-        }
-        in_example = false;
-      }
-      char *p1 = vim_strchr(IObuff, '*');       // find first '*'
-      while (p1 != NULL) {
-        char *p2 = strchr(p1 + 1, '*');  // Find second '*'.
-        if (p2 != NULL && p2 > p1 + 1) {         // Skip "*" and "**".
-          for (s = p1 + 1; s < p2; s++) {
-            if (*s == ' ' || *s == '\t' || *s == '|') {
-              break;
-            }
-          }
-
-          // Only accept a *tag* when it consists of valid
-          // characters, there is white space before it and is
-          // followed by a white character or end-of-line.
-          if (s == p2
-              && (p1 == IObuff || p1[-1] == ' ' || p1[-1] == '\t')
-              && (vim_strchr(" \t\n\r", (uint8_t)s[1]) != NULL
-                  || s[1] == '\0')) {
-            *p2 = '\0';
-            p1++;
-            size_t s_len = (size_t)(p2 - p1) + strlen(fname) + 2;
-            s = xmalloc(s_len);
-            GA_APPEND(char *, &ga, s);
-            snprintf(s, s_len, "%s\t%s", p1, fname);
-
-            // find next '*'
-            p2 = vim_strchr(p2 + 1, '*');
-          }
-        }
-        p1 = p2;
-      }
-      size_t len = strlen(IObuff);
-      if ((len == 2 && strcmp(&IObuff[len - 2], ">\n") == 0)
-          || (len >= 3 && strcmp(&IObuff[len - 3], " >\n") == 0)) {
-        in_example = true;
-      }
-      line_breakcheck();
+    if (jobs[fi].utf8 == kNone) {
+      continue;
     }
+    if (utf8 == kNone) {                // first file
+      utf8 = jobs[fi].utf8;
+    } else if (utf8 != jobs[fi].utf8) {
+      semsg(_("E670: Mix of help file encodings within a language: %s"),
+            files[fi]);
+      mix = !got_int;
+      got_int = true;
+    }
+  }
 
-    fclose(fd);
+  for (int fi = 0; fi < filecount; fi++) {
+    runs[fi] = jobs[fi].tags;
   }
+  helptags_merge(runs, filecount + 1, &ga);
+  xfree(runs);
+  xfree(jobs);
 
   FreeWild(filecount, files);
 
   if (!got_int && ga.ga_data != NULL) {
-    // Sort the tags.
-    sort_strings(ga.ga_data, ga.ga_len);
-
     // Check for duplicates.
     for (int i = 1; i < ga.ga_len; i++) {
       char *p1 = ((char **)ga.ga_data)[i - 1];
@@ -1030,7 +1229,8 @@ static void helptags_one(char *dir, const char *ext, const char *tagfname, bool
 }
 
 /// Generate tags in one help directory, taking care of translations.
-static void do_helptags(char *dirname, bool add_help_tags, bool ignore_writeerr)
+static void do_helptags(char *dirname, bool add_help_tags, bool ignore_writeerr,
+                        bool only_outdated)
   FUNC_ATTR_NONNULL_ALL
 {
   garray_T ga;
@@ -1112,7 +1312,7 @@ static void do_helptags(char *dirname, bool add_help_tags, bool ignore_writeerr)
       ext[1] = fname[5];
       ext[2] = fname[6];
     }
-    helptags_one(dirname, ext, fname, add_help_tags, ignore_writeerr);
+    helptags_one(dirname, ext, fname, add_help_tags, ignore_writeerr, only_outdated);
   }
 
   ga_clear(&ga);
@@ -1123,7 +1323,11 @@ static bool helptags_cb(int num_fnames, char **fnames, bool all, void *cookie)
   FUNC_ATTR_NONNULL_ALL
 {
   for (int i = 0; i < num_fnames; i++) {
-    do_helptags(fnames[i], *(bool *)cookie, true);
+    // Plugin managers run ":helptags ALL" after every update, don't write the
+    // tags files that are still valid.  Not with "++t", the existing file
+    // may lack the "help-tags" tag.
+    const bool add_help_tags = *(bool *)cookie;
+    do_helptags(fnames[i], add_help_tags, true, !add_help_tags);
     if (!all) {
       return true;
     }
@@ -1154,7 +1358,7 @@ void ex_helptags(exarg_T *eap)
     if (dirname == NULL || !os_isdir(dirname)) {
       semsg(_("E150: Not a directory: %s"), eap->arg);
     } else {
-      do_helptags(dirname, add_help_tags, false);
+      do_helptags(dirname, add_help_tags, false, false);
     }
     xfree(dirname);
   }
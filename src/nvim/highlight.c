@@ -41,6 +41,14 @@ static Set(HlEntry) attr_entries = SET_INIT;
 static Map(int, int) combine_attr_entries = MAP_INIT;
 static Map(int, int) blend_attr_entries = MAP_INIT;
 static Map(int, int) blendthrough_attr_entries = MAP_INIT;
+/// Like blend_attr_entries and blendthrough_attr_entries, for blends where
+/// one of the two groups has an unset color, which get_colors_force() takes
+/// from Normal. Only these are cleared when the Normal colors change.
+static Map(int, int) blend_normal_attr_entries = MAP_INIT;
+static Map(int, int) blendthrough_normal_attr_entries = MAP_INIT;
+/// Normal colors (fg, bg, sp) and 'background' used by the entries of
+/// blend_normal_attr_entries and blendthrough_normal_attr_entries.
+static RgbValue blend_normal_colors[4] = { -1, -1, -1, -1 };
 
 #define attr_entry(i) attr_entries.keys[i]
 
@@ -48,6 +56,9 @@ static Map(int, int) blendthrough_attr_entries = MAP_INIT;
 static Map(ColorKey, ColorItem) ns_hls;
 typedef int NSHlAttr[HLF_COUNT + 1];
 static PMap(int) ns_hl_attr;
+/// Bumped when update_ns_hl() recomputes a namespace: all w_hl_cache are
+/// invalid then.
+static uint64_t ns_hl_generation = 1;
 
 void highlight_init(void)
 {
@@ -101,6 +112,7 @@ retry: {}
     recursive = true;
 
     clear_hl_tables(true);
+    g_stats.hl_table_reset++;
 
     recursive = false;
     if (entry.kind == kHlCombine) {
@@ -443,6 +455,44 @@ void update_ns_hl(int ns_id)
   // hl_get_ui_attr might have invalidated the decor provider
   p = get_decor_provider(ns_id, true);
   p->hl_cached = true;
+  ns_hl_generation++;
+}
+
+/// Like syn_id2attr(), for drawing window "wp".
+///
+/// When a highlight namespace is active, looking up a group means following
+/// its links through the namespace map for every use. The results are kept in
+/// a table of the window indexed by "hl_id" until the namespace changes.
+int win_hl_id2attr(win_T *wp, int hl_id)
+{
+  int ns_id = ns_hl_active;
+  if (ns_id <= 0 || need_highlight_changed || hl_id <= 0) {
+    return syn_id2attr(hl_id);
+  }
+  DecorProvider *p = get_decor_provider(ns_id, true);
+  if (p->hl_def != LUA_NOREF) {
+    // hl_def may return a definition that is only valid once
+    return syn_id2attr(hl_id);
+  }
+  update_ns_hl(ns_id);
+
+  WinHlCache *hc = &wp->w_hl_cache;
+  if (hc->ns_id != ns_id || hc->generation != ns_hl_generation) {
+    hc->ns_id = ns_id;
+    hc->generation = ns_hl_generation;
+    kv_size(hc->attrs) = 0;
+  }
+  size_t idx = (size_t)hl_id;
+  if (idx >= kv_size(hc->attrs)) {
+    size_t add = idx + 1 - kv_size(hc->attrs);
+    kv_ensure_space(hc->attrs, add);
+    memset(hc->attrs.items + kv_size(hc->attrs), 0, add * sizeof(*hc->attrs.items));
+    kv_size(hc->attrs) = idx + 1;
+  }
+  if (kv_A(hc->attrs, idx) == 0) {
+    kv_A(hc->attrs, idx) = syn_id2attr(hl_id) + 1;
+  }
+  return kv_A(hc->attrs, idx) - 1;
 }
 
 int win_bg_attr(win_T *wp)
@@ -497,6 +547,8 @@ void clear_hl_tables(bool reinit)
     map_clear(int, &combine_attr_entries);
     map_clear(int, &blend_attr_entries);
     map_clear(int, &blendthrough_attr_entries);
+    map_clear(int, &blend_normal_attr_entries);
+    map_clear(int, &blendthrough_normal_attr_entries);
     memset(highlight_attr_last, -1, sizeof(highlight_attr_last));
     highlight_attr_set_all();
     highlight_changed();
@@ -506,6 +558,8 @@ void clear_hl_tables(bool reinit)
     map_destroy(int, &combine_attr_entries);
     map_destroy(int, &blend_attr_entries);
     map_destroy(int, &blendthrough_attr_entries);
+    map_destroy(int, &blend_normal_attr_entries);
+    map_destroy(int, &blendthrough_normal_attr_entries);
     map_destroy(ColorKey, &ns_hls);
   }
 }
@@ -514,6 +568,8 @@ void hl_invalidate_blends(void)
 {
   map_clear(int, &blend_attr_entries);
   map_clear(int, &blendthrough_attr_entries);
+  map_clear(int, &blend_normal_attr_entries);
+  map_clear(int, &blendthrough_normal_attr_entries);
   highlight_changed();
   update_window_hl(curwin, true);
 }
@@ -611,9 +667,14 @@ int hl_combine_attr(int char_attr, int prim_attr)
 ///
 /// If colors are unset, use builtin default colors. Never returns -1
 /// Cterm colors are unchanged.
-static HlAttrs get_colors_force(int attr)
+///
+/// @param[out] normal  set to true when a color was taken from Normal
+static HlAttrs get_colors_force(int attr, bool *normal)
 {
   HlAttrs attrs = syn_attr2entry(attr);
+  if (attrs.rgb_bg_color == -1 || attrs.rgb_fg_color == -1 || attrs.rgb_sp_color == -1) {
+    *normal = true;
+  }
   if (attrs.rgb_bg_color == -1) {
     attrs.rgb_bg_color = normal_bg;
   }
@@ -648,23 +709,32 @@ int hl_blend_attrs(int back_attr, int front_attr, bool *through)
     return -1;
   }
 
-  HlAttrs fattrs = get_colors_force(front_attr);
+  bool normal = false;
+  HlAttrs fattrs = get_colors_force(front_attr, &normal);
   int ratio = fattrs.hl_blend;
   if (ratio <= 0) {
     *through = false;
     return front_attr;
   }
 
+  hl_check_blend_normal();
   int combine_tag = (back_attr << 16) + front_attr;
   Map(int, int) *map = (*through
                         ? &blendthrough_attr_entries
                         : &blend_attr_entries);
+  Map(int, int) *normal_map = (*through
+                               ? &blendthrough_normal_attr_entries
+                               : &blend_normal_attr_entries);
   int id = map_get(int, int)(map, combine_tag);
   if (id > 0) {
     return id;
   }
+  id = map_get(int, int)(normal_map, combine_tag);
+  if (id > 0) {
+    return id;
+  }
 
-  HlAttrs battrs = get_colors_force(back_attr);
+  HlAttrs battrs = get_colors_force(back_attr, &normal);
   HlAttrs cattrs;
 
   if (*through) {
@@ -707,11 +777,52 @@ int hl_blend_attrs(int back_attr, int front_attr, bool *through)
   id = get_attr_entry((HlEntry){ .attr = cattrs, .kind = kind,
                                  .id1 = back_attr, .id2 = front_attr });
   if (id > 0) {
-    map_put(int, int)(map, combine_tag, id);
+    map_put(int, int)(normal ? normal_map : map, combine_tag, id);
   }
   return id;
 }
 
+/// Clear the blends that used the Normal colors if these changed since.
+///
+/// The attr ids of the other entries don't change when a group is redefined,
+/// they are kept.
+static void hl_check_blend_normal(void)
+{
+  RgbValue dark = *p_bg == 'd';
+  if (blend_normal_colors[0] == normal_fg && blend_normal_colors[1] == normal_bg
+      && blend_normal_colors[2] == normal_sp && blend_normal_colors[3] == dark) {
+    return;
+  }
+  if (map_size(&blend_normal_attr_entries) || map_size(&blendthrough_normal_attr_entries)) {
+    map_clear(int, &blend_normal_attr_entries);
+    map_clear(int, &blendthrough_normal_attr_entries);
+    g_stats.hl_blend_clear++;
+  }
+  blend_normal_colors[0] = normal_fg;
+  blend_normal_colors[1] = normal_bg;
+  blend_normal_colors[2] = normal_sp;
+  blend_normal_colors[3] = dark;
+}
+
+/// @return number of attr ids in use, see nvim__stats()
+size_t hl_attr_table_size(void)
+{
+  return set_size(&attr_entries);
+}
+
+/// @return number of cached combined attributes, see nvim__stats()
+size_t hl_combine_cache_size(void)
+{
+  return map_size(&combine_attr_entries);
+}
+
+/// @return number of cached blended attributes, see nvim__stats()
+size_t hl_blend_cache_size(void)
+{
+  return map_size(&blend_attr_entries) + map_size(&blendthrough_attr_entries)
+         + map_size(&blend_normal_attr_entries) + map_size(&blendthrough_normal_attr_entries);
+}
+
 static int rgb_blend(int ratio, int rgb1, int rgb2)
 {
   int a = ratio;
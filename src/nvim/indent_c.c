@@ -32,6 +32,16 @@ typedef struct {
   lpos_T lpos;
 } cpp_baseclass_cache_T;
 
+// Result cache for find_start_brace() while re-indenting a range of lines,
+// see cin_brace_cache_start().
+static struct {
+  bool active;
+  linenr_T top;    ///< line being re-indented, lines above it are final
+  linenr_T lnum;   ///< line of the last query, zero when not valid
+  bool found;      ///< whether the last query found a brace
+  pos_T pos;       ///< the brace found by the last query
+} brace_cache;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "indent_c.c.generated.h"
 #endif
@@ -1412,6 +1422,18 @@ static pos_T *find_start_brace(void)  // XXX
   pos_T *trypos;
   pos_T *pos;
   static pos_T pos_copy;
+  linenr_T lnum = curwin->w_cursor.lnum;
+
+  if (brace_cache.lnum > 0 && lnum >= brace_cache.lnum
+      && brace_cache_lines_plain(brace_cache.lnum, lnum)) {
+    // Nothing between the previous query and this one can change the result.
+    brace_cache.lnum = lnum;
+    if (!brace_cache.found) {
+      return NULL;
+    }
+    pos_copy = brace_cache.pos;
+    return &pos_copy;
+  }
 
   cursor_save = curwin->w_cursor;
   while ((trypos = findmatchlimit(NULL, '{', FM_BLOCKSTOP, 0)) != NULL) {
@@ -1429,9 +1451,55 @@ static pos_T *find_start_brace(void)  // XXX
     }
   }
   curwin->w_cursor = cursor_save;
+
+  // Remember the result for the following lines. A brace in a line that is
+  // still to be re-indented is not remembered, its column will change.
+  if (brace_cache.active && lnum >= brace_cache.lnum
+      && (trypos == NULL || trypos->lnum < brace_cache.top)) {
+    brace_cache.lnum = lnum;
+    brace_cache.found = trypos != NULL;
+    if (trypos != NULL) {
+      brace_cache.pos = *trypos;
+    }
+  }
   return trypos;
 }
 
+/// Check that lines "from" to "to" contain no brace and no quote, so that a
+/// backwards search for an unmatched '{' passes through them unchanged.
+static bool brace_cache_lines_plain(linenr_T from, linenr_T to)
+{
+  for (linenr_T lnum = from; lnum <= to; lnum++) {
+    if (strpbrk(ml_get(lnum), "{}\"'") != NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Start caching the result of find_start_brace() from one line to the next.
+/// Only valid while the buffer is changed by re-indenting lines from top to
+/// bottom, like op_reindent() does. Call cin_brace_cache_line() before each
+/// line and stop with cin_brace_cache_stop().
+void cin_brace_cache_start(void)
+{
+  brace_cache.active = true;
+  brace_cache.top = 0;
+  brace_cache.lnum = 0;
+}
+
+/// Tell the cache that line "lnum" is about to be re-indented.
+void cin_brace_cache_line(linenr_T lnum)
+{
+  brace_cache.top = lnum;
+}
+
+void cin_brace_cache_stop(void)
+{
+  brace_cache.active = false;
+  brace_cache.lnum = 0;
+}
+
 /// Find the matching '(', ignoring it if it is in a comment.
 /// @returns NULL or the found match.
 static pos_T *find_match_paren(int ind_maxparen)
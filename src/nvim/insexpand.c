@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "klib/kvec.h"
+#include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/buffer.h"
@@ -36,6 +37,7 @@
 #include "nvim/insexpand.h"
 #include "nvim/keycodes.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mark.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
@@ -173,8 +175,20 @@ typedef struct {
   bool found_all;         ///< found all matches of a certain type.
   char *dict;             ///< dictionary file to search
   int dict_f;             ///< "dict" is an exact file name or not
+  bool index_done;        ///< matches from the keyword index of "ins_buf" added
 } ins_compl_next_state_T;
 
+/// Keywords of a buffer for ^N/^P.  Built when a buffer other than the current
+/// one is scanned, and kept until the buffer changes, so that the next
+/// completion does not have to search the buffer again.
+struct compl_index {
+  varnumber_T changedtick;  ///< b:changedtick when the index was built
+  uint64_t chartab[4];      ///< 'iskeyword' of the current buffer then
+  Map(String, int) ids;     ///< index of each word in "words"
+  kvec_t(String) words;     ///< words in order of their first occurrence
+  kvec_t(uint32_t) last;    ///< occurrence number of the last occurrence
+};
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "insexpand.c.generated.h"
 #endif
@@ -204,6 +218,10 @@ static compl_T *compl_curr_match = NULL;
 static compl_T *compl_shown_match = NULL;
 static compl_T *compl_old_match = NULL;
 
+/// Text of the matches, other than the original text, to quickly find out if a
+/// match is already present.
+static Set(String) compl_match_set = SET_INIT;
+
 /// After using a cursor key <Enter> selects a match in the popup menu,
 /// otherwise it inserts a line break.
 static bool compl_enter_selects = false;
@@ -806,19 +824,12 @@ static int ins_compl_add(char *const str, int len, char *const fname, char *cons
   }
 
   // If the same match is already present, don't add it.
-  if (compl_first_match != NULL && !adup) {
-    match = compl_first_match;
-    do {
-      if (!match_at_original_text(match)
-          && strncmp(match->cp_str, str, (size_t)len) == 0
-          && ((int)strlen(match->cp_str) <= len || match->cp_str[len] == NUL)) {
-        if (cptext_allocated) {
-          free_cptext(cptext);
-        }
-        return NOTDONE;
-      }
-      match = match->cp_next;
-    } while (match != NULL && !is_first_match(match));
+  if (compl_first_match != NULL && !adup
+      && set_has(String, &compl_match_set, cbuf_as_string(str, (size_t)len))) {
+    if (cptext_allocated) {
+      free_cptext(cptext);
+    }
+    return NOTDONE;
   }
 
   // Remove any popup menu before changing the list of matches.
@@ -832,6 +843,9 @@ static int ins_compl_add(char *const str, int len, char *const fname, char *cons
     match->cp_number = 0;
   }
   match->cp_str = xstrnsave(str, (size_t)len);
+  if (!(flags & CP_ORIGINAL_TEXT)) {
+    set_put(String, &compl_match_set, cstr_as_string(match->cp_str));
+  }
 
   // match-fname is:
   // - compl_curr_match->cp_fname if it is a string equal to fname.
@@ -1588,6 +1602,7 @@ static void ins_compl_free(void)
   compl_first_match = compl_curr_match = NULL;
   compl_shown_match = NULL;
   compl_old_match = NULL;
+  set_clear(String, &compl_match_set);
 }
 
 /// Reset/clear the completion state.
@@ -2904,6 +2919,7 @@ static int process_next_cpt_value(ins_compl_next_state_T *st, int *compl_type_ar
   int status = INS_COMPL_CPT_OK;
 
   st->found_all = false;
+  st->index_done = false;
 
   while (*st->e_cpt == ',' || *st->e_cpt == ' ') {
     st->e_cpt++;
@@ -3220,6 +3236,16 @@ static int get_next_default_completion(ins_compl_next_state_T *st, pos_T *start_
   }
   bool looped_around = false;
   int found_new_match = FAIL;
+  if (st->ins_buf != curbuf && ins_compl_use_index()) {
+    // All matches of the buffer are added at once.
+    if (!st->index_done) {
+      st->index_done = true;
+      found_new_match = ins_compl_add_from_index(st->ins_buf);
+    }
+    p_scs = save_p_scs;
+    p_ws = save_p_ws;
+    return found_new_match;
+  }
   while (true) {
     bool cont_s_ipos = false;
 
@@ -3293,6 +3319,132 @@ static int get_next_default_completion(ins_compl_next_state_T *st, pos_T *start_
   return found_new_match;
 }
 
+/// Whether the matches in a buffer other than the current one can be taken
+/// from its keyword index: only for ^N and ^P when starting to complete a
+/// keyword, thus when "compl_pattern" matches the start of a word.
+static bool ins_compl_use_index(void)
+{
+  return ctrl_x_mode_normal() && !compl_status_adding()
+         && !(compl_cont_status & CONT_SOL)
+         && strncmp(compl_pattern, "\\<", 2) == 0;
+}
+
+/// Returns the keyword index of "buf", (re)building it when the buffer or the
+/// 'iskeyword' of the current buffer changed since it was built.
+/// Words are split like ins_compl_get_next_word_or_line() does.
+/// Returns NULL when interrupted.
+static struct compl_index *ins_compl_get_index(buf_T *buf)
+{
+  struct compl_index *idx = buf->b_compl_index;
+  if (idx != NULL && idx->changedtick == buf_get_changedtick(buf)
+      && memcmp(idx->chartab, curbuf->b_chartab, sizeof(idx->chartab)) == 0) {
+    return idx;
+  }
+
+  ins_compl_free_index(buf);
+  idx = buf->b_compl_index = xcalloc(1, sizeof(*idx));
+  idx->changedtick = buf_get_changedtick(buf);
+  memcpy(idx->chartab, curbuf->b_chartab, sizeof(idx->chartab));
+
+  uint32_t count = 0;
+  for (linenr_T lnum = 1; lnum <= buf->b_ml.ml_line_count; lnum++) {
+    char *p = ml_get_buf(buf, lnum);
+    while (*(p = find_word_start(p)) != NUL) {
+      char *end = find_word_end(p);
+      String *key_alloc = NULL;
+      bool new_item = false;
+      int *id = map_put_ref(String, int)(&idx->ids, cbuf_as_string(p, (size_t)(end - p)),
+                                         &key_alloc, &new_item);
+      if (new_item) {
+        *key_alloc = cbuf_to_string(p, (size_t)(end - p));
+        *id = (int)kv_size(idx->words);
+        kv_push(idx->words, *key_alloc);
+        kv_push(idx->last, count);
+      } else {
+        kv_A(idx->last, *id) = count;
+      }
+      count++;
+      p = end;
+    }
+    fast_breakcheck();
+    if (got_int) {
+      ins_compl_free_index(buf);
+      return NULL;
+    }
+  }
+  return idx;
+}
+
+/// Free the ^N/^P keyword index of "buf".
+void ins_compl_free_index(buf_T *buf)
+{
+  struct compl_index *idx = buf->b_compl_index;
+  if (idx == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < kv_size(idx->words); i++) {
+    api_free_string(kv_A(idx->words, i));
+  }
+  kv_destroy(idx->words);
+  kv_destroy(idx->last);
+  map_destroy(String, &idx->ids);
+  XFREE_CLEAR(buf->b_compl_index);
+}
+
+static uint32_t *compl_index_last;
+
+static int compl_index_compare(const void *a, const void *b)
+{
+  uint32_t la = compl_index_last[*(const int *)a];
+  uint32_t lb = compl_index_last[*(const int *)b];
+  return la == lb ? 0 : la > lb ? -1 : 1;
+}
+
+/// Add the words of buffer "buf" that match "compl_pattern", in the order that
+/// searching the buffer in "compl_direction" would find them: forward by the
+/// first occurrence, backward by the last one.
+///
+/// @return  OK if a new match was added, otherwise FAIL.
+static int ins_compl_add_from_index(buf_T *buf)
+{
+  struct compl_index *idx = ins_compl_get_index(buf);
+  if (idx == NULL) {
+    return FAIL;
+  }
+
+  regmatch_T regmatch;
+  regmatch.regprog = vim_regcomp(compl_pattern, magic_isset() ? RE_MAGIC : 0);
+  if (regmatch.regprog == NULL) {
+    return FAIL;
+  }
+  regmatch.rm_ic = ignorecase(compl_pattern);
+
+  kvec_t(int) found = KV_INITIAL_VALUE;
+  for (size_t i = 0; i < kv_size(idx->words); i++) {
+    char *word = kv_A(idx->words, i).data;
+    if (vim_regexec(&regmatch, word, 0) && regmatch.startp[0] == word) {
+      kv_push(found, (int)i);
+    }
+  }
+  vim_regfree(regmatch.regprog);
+
+  if (!compl_dir_forward() && kv_size(found) > 1) {
+    compl_index_last = idx->last.items;
+    qsort(found.items, kv_size(found), sizeof(int), compl_index_compare);
+  }
+
+  int status = FAIL;
+  for (size_t i = 0; i < kv_size(found) && !got_int; i++) {
+    String word = kv_A(idx->words, kv_A(found, i));
+    if (ins_compl_add_infercase(word.data, (int)word.size, p_ic, buf->b_sfname, 0,
+                                false) == OK) {
+      status = OK;
+    }
+  }
+  kv_destroy(found);
+  return status;
+}
+
 /// get the next set of completion matches for "type".
 /// @return  true if a new match is found, otherwise false.
 static bool get_next_completion_match(int type, ins_compl_next_state_T *st, pos_T *ini)
@@ -4567,6 +4719,7 @@ void free_insexpand_stuff(void)
 {
   XFREE_CLEAR(compl_orig_text);
   kv_destroy(compl_orig_extmarks);
+  set_destroy(String, &compl_match_set);
   callback_free(&cfu_cb);
   callback_free(&ofu_cb);
   callback_free(&tsrfu_cb);
@@ -3,8 +3,10 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "klib/kvec.h"
 #include "nvim/linematch.h"
 #include "nvim/macros_defs.h"
 #include "nvim/memory.h"
@@ -401,3 +403,231 @@ static size_t test_charmatch_paths(diffcmppath_T *node, int lastdecision)
   }
   return (size_t)node->df_choice_mem[lastdecision];
 }
+
+// Number of leading non-white characters used as the coarse key of a line.
+#define LM_PREFIX_LEN 16
+// Shorter lines have no coarse key, they are too common to be anchors.
+#define LM_PREFIX_MIN 4
+// Maximum recursion depth of the heuristic, deeper gaps are paired in order.
+#define LM_MAX_DEPTH 64
+
+typedef struct {
+  uint64_t hash;
+  int side;
+  int idx;
+} lmkey_T;
+
+typedef struct {
+  int a;
+  int b;
+} lmanchor_T;
+
+typedef struct {
+  const char **line[2];      // start of every line of the two blocks
+  uint64_t *key[2][2];       // [level][side]: exact key and coarse key, 0 for none
+  bool iwhite;
+  int max_lines;
+  kvec_t(int) out;
+} lmctx_T;
+
+/// Hash a line for the heuristic.  With "prefix" only the first
+/// LM_PREFIX_LEN non-white characters are used and white space is always
+/// skipped.  Returns 0 when the line has no key.
+static uint64_t lm_hash(const char *s, bool iwhite, bool prefix)
+{
+  uint64_t h = 14695981039346656037ULL;
+  size_t n = 0;
+  for (; *s != NUL && *s != '\n'; s++) {
+    if ((iwhite || prefix) && (*s == ' ' || *s == '\t')) {
+      continue;
+    }
+    if (prefix && n == LM_PREFIX_LEN) {
+      break;
+    }
+    h = (h ^ (uint8_t)(*s)) * 1099511628211ULL;
+    n++;
+  }
+  if (prefix && n < LM_PREFIX_MIN) {
+    return 0;
+  }
+  return h == 0 ? 1 : h;
+}
+
+static int lm_key_cmp(const void *p1, const void *p2)
+{
+  const lmkey_T *k1 = p1;
+  const lmkey_T *k2 = p2;
+  if (k1->hash != k2->hash) {
+    return k1->hash < k2->hash ? -1 : 1;
+  }
+  if (k1->side != k2->side) {
+    return k1->side - k2->side;
+  }
+  return k1->idx - k2->idx;
+}
+
+static int lm_anchor_cmp(const void *p1, const void *p2)
+{
+  return ((const lmanchor_T *)p1)->a - ((const lmanchor_T *)p2)->a;
+}
+
+/// Find lines that occur exactly once in both a0..a1 and b0..b1 (exclusive
+/// ends) and keep the longest sequence of them that is in the same order in
+/// both blocks.
+///
+/// @return  number of anchors stored in "*anchors", ordered by line
+static size_t lm_find_anchors(lmctx_T *ctx, int level, int a0, int a1, int b0, int b1,
+                              lmanchor_T **anchors)
+{
+  lmkey_T *keys = xmalloc(sizeof(lmkey_T) * (size_t)(a1 - a0 + b1 - b0));
+  size_t nkeys = 0;
+  for (int side = 0; side < 2; side++) {
+    const int from = side == 0 ? a0 : b0;
+    const int to = side == 0 ? a1 : b1;
+    for (int i = from; i < to; i++) {
+      if (ctx->key[level][side][i] != 0) {
+        keys[nkeys++] = (lmkey_T){ ctx->key[level][side][i], side, i };
+      }
+    }
+  }
+  qsort(keys, nkeys, sizeof(lmkey_T), lm_key_cmp);
+
+  // a group of equal keys is an anchor when it is one line of each block
+  lmanchor_T *cand = xmalloc(sizeof(lmanchor_T) * (nkeys / 2 + 1));
+  size_t ncand = 0;
+  for (size_t i = 0; i < nkeys;) {
+    size_t j = i + 1;
+    while (j < nkeys && keys[j].hash == keys[i].hash) {
+      j++;
+    }
+    if (j - i == 2 && keys[i].side == 0 && keys[i + 1].side == 1) {
+      cand[ncand++] = (lmanchor_T){ keys[i].idx, keys[i + 1].idx };
+    }
+    i = j;
+  }
+  xfree(keys);
+  qsort(cand, ncand, sizeof(lmanchor_T), lm_anchor_cmp);
+
+  // longest increasing subsequence of the second block's line numbers
+  size_t *tails = xmalloc(sizeof(size_t) * (ncand + 1));
+  size_t *prev = xmalloc(sizeof(size_t) * (ncand + 1));
+  size_t len = 0;
+  for (size_t i = 0; i < ncand; i++) {
+    size_t lo = 0;
+    size_t hi = len;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (cand[tails[mid]].b < cand[i].b) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    prev[i] = lo > 0 ? tails[lo - 1] : SIZE_MAX;
+    tails[lo] = i;
+    if (lo == len) {
+      len++;
+    }
+  }
+  *anchors = xmalloc(sizeof(lmanchor_T) * (len + 1));
+  for (size_t i = len, k = len > 0 ? tails[len - 1] : SIZE_MAX; i > 0; i--) {
+    (*anchors)[i - 1] = cand[k];
+    k = prev[k];
+  }
+  xfree(tails);
+  xfree(prev);
+  xfree(cand);
+  return len;
+}
+
+static void lm_align(lmctx_T *ctx, int level, int depth, int a0, int a1, int b0, int b1)
+{
+  const int na = a1 - a0;
+  const int nb = b1 - b0;
+  if (na == 0 || nb == 0) {
+    for (int i = 0; i < na + nb; i++) {
+      kv_push(ctx->out, na > 0 ? 1 : 2);
+    }
+    return;
+  }
+
+  if (na + nb > ctx->max_lines && level < 2 && depth < LM_MAX_DEPTH) {
+    lmanchor_T *anchors;
+    size_t nanchors = lm_find_anchors(ctx, level, a0, a1, b0, b1, &anchors);
+    if (nanchors == 0) {
+      xfree(anchors);
+      lm_align(ctx, level + 1, depth, a0, a1, b0, b1);
+      return;
+    }
+    for (size_t i = 0; i < nanchors; i++) {
+      lm_align(ctx, level, depth + 1, a0, anchors[i].a, b0, anchors[i].b);
+      kv_push(ctx->out, 3);
+      a0 = anchors[i].a + 1;
+      b0 = anchors[i].b + 1;
+    }
+    xfree(anchors);
+    lm_align(ctx, level, depth + 1, a0, a1, b0, b1);
+    return;
+  }
+
+  if (na + nb <= ctx->max_lines) {
+    // small enough for the optimal algorithm
+    const char *blk[2] = { ctx->line[0][a0], ctx->line[1][b0] };
+    const int len[2] = { na, nb };
+    int *decisions = NULL;
+    size_t n = linematch_nbuffers(blk, len, 2, &decisions, ctx->iwhite);
+    kv_concat_len(ctx->out, decisions, n);
+    xfree(decisions);
+    return;
+  }
+
+  // no anchors left: compare the lines in order
+  for (int i = 0; i < MAX(na, nb); i++) {
+    kv_push(ctx->out, i >= na ? 2 : i >= nb ? 1 : 3);
+  }
+}
+
+/// Align the lines of two diff blocks that are too big for
+/// linematch_nbuffers().  Lines that are unique in both blocks are used as
+/// anchors, like the patience diff, first by their full text and then by
+/// their first few characters.  The gaps between the anchors are aligned
+/// recursively, and with linematch_nbuffers() once they have at most
+/// "max_lines" lines.  This is O(n log n) in the number of lines.
+///
+/// @param diff_blk  array of two blocks of lines separated by '\n'
+/// @param diff_len  number of lines in each block
+/// @param [out] decisions  same format as for linematch_nbuffers()
+/// @param max_lines  size up to which linematch_nbuffers() is used
+/// @return  the length of decisions
+size_t linematch_heuristic(const char **diff_blk, const int *diff_len, int **decisions,
+                           bool iwhite, int max_lines)
+{
+  lmctx_T ctx = { .iwhite = iwhite, .max_lines = max_lines };
+  kv_init(ctx.out);
+  for (int side = 0; side < 2; side++) {
+    const size_t n = (size_t)diff_len[side];
+    ctx.line[side] = xmalloc(sizeof(char *) * (n + 1));
+    ctx.key[0][side] = xmalloc(sizeof(uint64_t) * (n + 1));
+    ctx.key[1][side] = xmalloc(sizeof(uint64_t) * (n + 1));
+    const char *s = diff_blk[side];
+    for (size_t i = 0; i < n; i++) {
+      ctx.line[side][i] = s;
+      ctx.key[0][side][i] = lm_hash(s, iwhite, false);
+      ctx.key[1][side][i] = lm_hash(s, iwhite, true);
+      s += line_len(s);
+      if (*s == '\n') {
+        s++;
+      }
+    }
+  }
+
+  lm_align(&ctx, 0, 0, 0, diff_len[0], 0, diff_len[1]);
+
+  for (int side = 0; side < 2; side++) {
+    xfree(ctx.line[side]);
+    xfree(ctx.key[0][side]);
+    xfree(ctx.key[1][side]);
+  }
+  *decisions = ctx.out.items;
+  return kv_size(ctx.out);
+}
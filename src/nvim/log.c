@@ -18,6 +18,7 @@
 
 #include "auto/config.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/atomic_defs.h"
 #include "nvim/eval.h"
 #include "nvim/globals.h"
 #include "nvim/log.h"
@@ -35,6 +36,37 @@ static char log_file_path[MAXPATHL + 1] = { 0 };
 static bool did_log_init = false;
 static uv_mutex_t mutex;
 
+// Asynchronous logging, enabled with $NVIM_LOG_ASYNC.
+//
+// The main thread formats a record and puts it in "log_ring", a ring buffer
+// with a single producer and a single consumer, without taking a lock.  The
+// log thread writes the records to the log file.  When the ring is full the
+// record is dropped and counted.  Other threads log synchronously as usual,
+// and so does code that writes to the file from open_log_file(): they first
+// write out the records in the ring, to keep the order.
+
+enum {
+  LOG_RING_SIZE = 256 * 1024,  ///< must be a power of two
+  LOG_RECORD_MAX = 4096,       ///< longer records are truncated
+};
+
+static bool log_async = false;
+static uv_thread_t log_main_thread;
+static uv_thread_t log_thread;
+static uv_sem_t log_sem;
+static uv_mutex_t log_drain_mutex;  ///< held while taking records out of the ring
+static bool log_thread_stop = false;
+
+static char log_ring[LOG_RING_SIZE];
+static uint64_t log_ring_head = 0;  ///< only written by the main thread
+static uint64_t log_ring_tail = 0;  ///< only written with "log_drain_mutex"
+static uint64_t log_drop = 0;       ///< records dropped since the last write
+static uint64_t log_drop_total = 0;
+
+/// Name of the Nvim instance that produced the log, see log_name_init().
+static char log_name[32];
+static uv_once_t log_name_once = UV_ONCE_INIT;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "log.c.generated.h"
 #endif
@@ -104,9 +136,138 @@ void log_init(void)
   uv_mutex_init_recursive(&mutex);
   // AFTER init_homedir ("~", XDG) and set_init_1 (env vars). 22b52dd462e5 #11501
   log_path_init();
+  if (os_env_exists(ENV_LOGASYNC)) {
+    log_async_start();
+  }
   did_log_init = true;
 }
 
+static void log_async_start(void)
+{
+  uv_mutex_init(&log_drain_mutex);
+  if (uv_sem_init(&log_sem, 0) != 0) {
+    return;
+  }
+  log_main_thread = uv_thread_self();
+  if (uv_thread_create(&log_thread, log_thread_main, NULL) != 0) {
+    uv_sem_destroy(&log_sem);
+    return;
+  }
+  log_async = true;
+}
+
+/// Stops the log thread, after it wrote all records.  Logging continues
+/// synchronously.
+void log_async_stop(void)
+{
+  if (!log_async) {
+    return;
+  }
+  log_async = false;
+  log_thread_stop = true;
+  uv_sem_post(&log_sem);
+  uv_thread_join(&log_thread);
+  uv_sem_destroy(&log_sem);
+}
+
+/// @return  the number of log records dropped because the ring was full.
+int64_t log_drop_count(void)
+{
+  return (int64_t)ATOMIC_LOAD_ACQ(&log_drop_total);
+}
+
+static void log_thread_main(void *arg)
+{
+  while (true) {
+    uv_sem_wait(&log_sem);
+    log_ring_drain();
+    if (log_thread_stop) {
+      break;
+    }
+  }
+}
+
+static void log_ring_copy(char *dst, uint64_t pos, size_t len)
+{
+  size_t off = (size_t)(pos & (LOG_RING_SIZE - 1));
+  size_t n = MIN(len, LOG_RING_SIZE - off);
+  memcpy(dst, log_ring + off, n);
+  memcpy(dst + n, log_ring, len - n);
+}
+
+static void log_ring_put(uint64_t pos, const char *src, size_t len)
+{
+  size_t off = (size_t)(pos & (LOG_RING_SIZE - 1));
+  size_t n = MIN(len, LOG_RING_SIZE - off);
+  memcpy(log_ring + off, src, n);
+  memcpy(log_ring, src + n, len - n);
+}
+
+/// Writes the records in the ring to the log file.
+static void log_ring_drain(void)
+{
+  uv_mutex_lock(&log_drain_mutex);
+  uint64_t tail = log_ring_tail;
+  uint64_t head = ATOMIC_LOAD_ACQ(&log_ring_head);
+  uint64_t dropped = ATOMIC_EXCHANGE(&log_drop, 0);
+  if (tail != head || dropped > 0) {
+    FILE *log_file = log_file_open();
+    char buf[LOG_RECORD_MAX];
+    while (tail != head) {
+      uint32_t len;
+      log_ring_copy((char *)&len, tail, sizeof(len));
+      log_ring_copy(buf, tail + sizeof(len), len);
+      fwrite(buf, 1, len, log_file);
+      tail += sizeof(len) + len;
+    }
+    ATOMIC_STORE_REL(&log_ring_tail, tail);
+    if (dropped > 0) {
+      fprintf(log_file, "WRN log: dropped %" PRIu64 " messages, the log ring was full\n", dropped);
+    }
+    fflush(log_file);
+    if (log_file != stderr && log_file != stdout) {
+      fclose(log_file);
+    }
+  }
+  uv_mutex_unlock(&log_drain_mutex);
+}
+
+/// Formats a record and puts it in the ring, for the log thread to write.
+/// Never blocks.
+static bool log_ring_push(int log_level, const char *context, const char *func_name,
+                          int line_num, bool eol, const char *fmt, va_list args)
+  FUNC_ATTR_PRINTF(6, 0)
+{
+  char buf[LOG_RECORD_MAX];
+  int prefix = log_format_prefix(buf, sizeof(buf), log_level, context, func_name, line_num);
+  if (prefix < 0) {
+    return false;
+  }
+  size_t len = MIN((size_t)prefix, sizeof(buf) - 1);
+  int n = vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
+  if (n < 0) {
+    return false;
+  }
+  len = MIN(len + (size_t)n, sizeof(buf) - 2);
+  if (eol) {
+    buf[len++] = '\n';
+  }
+
+  uint32_t len32 = (uint32_t)len;
+  uint64_t head = log_ring_head;
+  uint64_t tail = ATOMIC_LOAD_ACQ(&log_ring_tail);
+  if (LOG_RING_SIZE - (head - tail) < sizeof(len32) + len) {
+    ATOMIC_INC(&log_drop);
+    ATOMIC_INC(&log_drop_total);
+    return false;
+  }
+  log_ring_put(head, (char *)&len32, sizeof(len32));
+  log_ring_put(head + sizeof(len32), buf, len);
+  ATOMIC_STORE_REL(&log_ring_head, head + sizeof(len32) + len);
+  uv_sem_post(&log_sem);
+  return true;
+}
+
 void log_lock(void)
 {
   uv_mutex_lock(&mutex);
@@ -163,6 +324,17 @@ bool logmsg(int log_level, const char *context, const char *func_name, int line_
   }
 #endif
 
+  if (log_async) {
+    uv_thread_t self = uv_thread_self();
+    if (uv_thread_equal(&log_main_thread, &self)) {
+      va_list args;
+      va_start(args, fmt);
+      bool ret = log_ring_push(log_level, context, func_name, line_num, eol, fmt, args);
+      va_end(args);
+      return ret;
+    }
+  }
+
   log_lock();
   if (recursive) {
     if (!did_msg) {
@@ -208,9 +380,18 @@ void log_uv_handles(void *loop)
 }
 
 /// Open the log file for appending.
+/// With asynchronous logging, first writes the records that are waiting.
 ///
 /// @return Log file, or stderr on failure
 FILE *open_log_file(void)
+{
+  if (log_async) {
+    log_ring_drain();
+  }
+  return log_file_open();
+}
+
+static FILE *log_file_open(void)
 {
   errno = 0;
   if (log_file_path[0]) {
@@ -294,9 +475,49 @@ static bool v_do_log_to_file(FILE *log_file, int log_level, const char *context,
                              va_list args)
   FUNC_ATTR_PRINTF(7, 0)
 {
-  // Name of the Nvim instance that produced the log.
-  static char name[32] = { 0 };
+  char prefix[MAXPATHL + 128];
+  int rv = log_format_prefix(prefix, sizeof(prefix), log_level, context, func_name, line_num);
+  if (rv < 0 || fputs(prefix, log_file) < 0) {
+    return false;
+  }
+  if (vfprintf(log_file, fmt, args) < 0) {
+    return false;
+  }
+  if (eol) {
+    fputc('\n', log_file);
+  }
+  if (fflush(log_file) == EOF) {
+    return false;
+  }
 
+  return true;
+}
+
+/// Gets a name for this Nvim instance, when the first record is logged.
+/// TODO(justinmk): expose this as v:name ?
+static void log_name_init(void)
+{
+  // Parent servername.
+  const char *parent = path_tail(os_getenv(ENV_NVIM));
+  // Servername. Empty until starting=false.
+  const char *serv = path_tail(get_vim_var_str(VV_SEND_SERVER));
+  if (parent[0] != NUL) {
+    snprintf(log_name, sizeof(log_name), "%s/c", parent);  // "/c" indicates child.
+  } else if (serv[0] != NUL) {
+    snprintf(log_name, sizeof(log_name), "%s", serv);
+  } else {
+    int64_t pid = os_get_pid();
+    snprintf(log_name, sizeof(log_name), "?.%-5" PRId64, pid);
+  }
+}
+
+/// Formats the start of a log record: level, time, instance name and source
+/// location.
+///
+/// @return  the length of the prefix, negative on failure.
+static int log_format_prefix(char *buf, size_t size, int log_level, const char *context,
+                             const char *func_name, int line_num)
+{
   static const char *log_levels[] = {
     [LOGLVL_DBG] = "DBG",
     [LOGLVL_INF] = "INF",
@@ -308,11 +529,11 @@ static bool v_do_log_to_file(FILE *log_file, int log_level, const char *context,
   // Format the timestamp.
   struct tm local_time;
   if (os_localtime(&local_time) == NULL) {
-    return false;
+    return -1;
   }
   char date_time[20];
   if (strftime(date_time, sizeof(date_time), "%Y-%m-%dT%H:%M:%S", &local_time) == 0) {
-    return false;
+    return -1;
   }
 
   int millis = 0;
@@ -321,49 +542,22 @@ static bool v_do_log_to_file(FILE *log_file, int log_level, const char *context,
     millis = (int)curtime.tv_usec / 1000;
   }
 
-  // Get a name for this Nvim instance.
-  // TODO(justinmk): expose this as v:name ?
-  if (name[0] == '\0') {
-    // Parent servername.
-    const char *parent = path_tail(os_getenv(ENV_NVIM));
-    // Servername. Empty until starting=false.
-    const char *serv = path_tail(get_vim_var_str(VV_SEND_SERVER));
-    if (parent[0] != NUL) {
-      snprintf(name, sizeof(name), "%s/c", parent);  // "/c" indicates child.
-    } else if (serv[0] != NUL) {
-      snprintf(name, sizeof(name), "%s", serv);
-    } else {
-      int64_t pid = os_get_pid();
-      snprintf(name, sizeof(name), "?.%-5" PRId64, pid);
-    }
-  }
+  // The main thread fills the log ring without taking the log mutex, the
+  // name must be set only once.
+  uv_once(&log_name_once, log_name_init);
+  const char *const name = log_name;
 
-  // Print the log message.
   int rv = (line_num == -1 || func_name == NULL)
-           ? fprintf(log_file, "%s %s.%03d %-10s %s",
-                     log_levels[log_level], date_time, millis, name,
-                     (context == NULL ? "?:" : context))
-           : fprintf(log_file, "%s %s.%03d %-10s %s%s:%d: ",
-                     log_levels[log_level], date_time, millis, name,
-                     (context == NULL ? "" : context),
-                     func_name, line_num);
+           ? snprintf(buf, size, "%s %s.%03d %-10s %s",
+                      log_levels[log_level], date_time, millis, name,
+                      (context == NULL ? "?:" : context))
+           : snprintf(buf, size, "%s %s.%03d %-10s %s%s:%d: ",
+                      log_levels[log_level], date_time, millis, name,
+                      (context == NULL ? "" : context),
+                      func_name, line_num);
   if (name[0] == '?') {
     // No v:servername yet. Clear `name` so that the next log can try again.
     name[0] = '\0';
   }
-
-  if (rv < 0) {
-    return false;
-  }
-  if (vfprintf(log_file, fmt, args) < 0) {
-    return false;
-  }
-  if (eol) {
-    fputc('\n', log_file);
-  }
-  if (fflush(log_file) == EOF) {
-    return false;
-  }
-
-  return true;
+  return rv;
 }
@@ -5,6 +5,7 @@
 
 #include "nvim/base64.h"
 #include "nvim/lua/base64.h"
+#include "nvim/macros_defs.h"
 #include "nvim/memory.h"
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
@@ -24,10 +25,18 @@ static int nlua_base64_encode(lua_State *L)
   size_t src_len = 0;
   const char *src = lua_tolstring(L, 1, &src_len);
 
-  const char *ret = base64_encode(src, src_len);
-  assert(ret != NULL);
-  lua_pushstring(L, ret);
-  xfree((void *)ret);
+  // Encode in pieces straight into the Lua buffer, instead of encoding all of
+  // it into a temporary string first.
+  const size_t piece = (LUAL_BUFFERSIZE / 4) * 3;
+  luaL_Buffer buf;
+  luaL_buffinit(L, &buf);
+  for (size_t i = 0; i < src_len; i += piece) {
+    const size_t len = MIN(piece, src_len - i);
+    char *dest = luaL_prepbuffer(&buf);
+    base64_encode_to(src + i, len, dest);
+    luaL_addsize(&buf, base64_encoded_len(len));
+  }
+  luaL_pushresult(&buf);
 
   return 1;
 }
@@ -45,12 +54,13 @@ static int nlua_base64_decode(lua_State *L)
   size_t src_len = 0;
   const char *src = lua_tolstring(L, 1, &src_len);
 
-  const char *ret = base64_decode(src, src_len);
+  size_t ret_len = 0;
+  const char *ret = base64_decode(src, src_len, &ret_len);
   if (ret == NULL) {
     return luaL_error(L, "Invalid input");
   }
 
-  lua_pushstring(L, ret);
+  lua_pushlstring(L, ret, ret_len);
   xfree((void *)ret);
 
   return 1;
@@ -791,11 +791,24 @@ void nlua_push_Object(lua_State *lstate, const Object obj, bool special)
   }
 }
 
+/// Allocate "n" zeroed items of "size" bytes, in "arena" unless it is NULL.
+static void *nlua_calloc(Arena *arena, size_t n, size_t size)
+{
+  if (arena == NULL) {
+    return xcalloc(n, size);
+  }
+  void *mem = arena_alloc(arena, n * size, true);
+  memset(mem, 0, n * size);
+  return mem;
+}
+
 /// Convert lua value to string
 ///
 /// Always pops one value from the stack.
-String nlua_pop_String(lua_State *lstate, Error *err)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+///
+/// @param  arena  Arena to allocate the string in, NULL to use the heap.
+String nlua_pop_String(lua_State *lstate, Arena *arena, Error *err)
+  FUNC_ATTR_NONNULL_ARG(1, 3) FUNC_ATTR_WARN_UNUSED_RESULT
 {
   if (lua_type(lstate, -1) != LUA_TSTRING) {
     lua_pop(lstate, 1);
@@ -806,7 +819,7 @@ String nlua_pop_String(lua_State *lstate, Error *err)
 
   ret.data = (char *)lua_tolstring(lstate, -1, &(ret.size));
   assert(ret.data != NULL);
-  ret.data = xmemdupz(ret.data, ret.size);
+  ret.data = arena_memdupz(arena, ret.data, ret.size);
   lua_pop(lstate, 1);
 
   return ret;
@@ -936,9 +949,10 @@ Float nlua_pop_Float(lua_State *lstate, Error *err)
 ///
 /// @param  lstate  Lua state.
 /// @param[in]  table_props  nlua_traverse_table() output.
+/// @param  arena  Arena to allocate the array in, NULL to use the heap.
 /// @param[out]  err  Location where error will be saved.
 static Array nlua_pop_Array_unchecked(lua_State *const lstate, const LuaTableProps table_props,
-                                      Error *const err)
+                                      Arena *arena, Error *const err)
 {
   Array ret = { .size = table_props.maxidx, .items = NULL };
 
@@ -947,17 +961,19 @@ static Array nlua_pop_Array_unchecked(lua_State *const lstate, const LuaTablePro
     return ret;
   }
 
-  ret.items = xcalloc(ret.size, sizeof(*ret.items));
+  ret.items = nlua_calloc(arena, ret.size, sizeof(*ret.items));
   for (size_t i = 1; i <= ret.size; i++) {
     Object val;
 
     lua_rawgeti(lstate, -1, (int)i);
 
-    val = nlua_pop_Object(lstate, false, err);
+    val = nlua_pop_Object(lstate, false, arena, err);
     if (ERROR_SET(err)) {
       ret.size = i - 1;
       lua_pop(lstate, 1);
-      api_free_array(ret);
+      if (arena == NULL) {
+        api_free_array(ret);
+      }
       return (Array) { .size = 0, .items = NULL };
     }
     ret.items[i - 1] = val;
@@ -970,15 +986,17 @@ static Array nlua_pop_Array_unchecked(lua_State *const lstate, const LuaTablePro
 /// Convert lua table to array
 ///
 /// Always pops one value from the stack.
-Array nlua_pop_Array(lua_State *lstate, Error *err)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+///
+/// @param  arena  Arena to allocate the array in, NULL to use the heap.
+Array nlua_pop_Array(lua_State *lstate, Arena *arena, Error *err)
+  FUNC_ATTR_NONNULL_ARG(1, 3) FUNC_ATTR_WARN_UNUSED_RESULT
 {
   const LuaTableProps table_props = nlua_check_type(lstate, err,
                                                     kObjectTypeArray);
   if (table_props.type != kObjectTypeArray) {
     return (Array) { .size = 0, .items = NULL };
   }
-  return nlua_pop_Array_unchecked(lstate, table_props, err);
+  return nlua_pop_Array_unchecked(lstate, table_props, arena, err);
 }
 
 /// Convert lua table to dictionary
@@ -988,10 +1006,11 @@ Array nlua_pop_Array(lua_State *lstate, Error *err)
 ///
 /// @param  lstate  Lua interpreter state.
 /// @param[in]  table_props  nlua_traverse_table() output.
+/// @param  arena  Arena to allocate the dictionary in, NULL to use the heap.
 /// @param[out]  err  Location where error will be saved.
 static Dictionary nlua_pop_Dictionary_unchecked(lua_State *lstate, const LuaTableProps table_props,
-                                                bool ref, Error *err)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+                                                bool ref, Arena *arena, Error *err)
+  FUNC_ATTR_NONNULL_ARG(1, 5) FUNC_ATTR_WARN_UNUSED_RESULT
 {
   Dictionary ret = { .size = table_props.string_keys_num, .items = NULL };
 
@@ -999,7 +1018,7 @@ static Dictionary nlua_pop_Dictionary_unchecked(lua_State *lstate, const LuaTabl
     lua_pop(lstate, 1);
     return ret;
   }
-  ret.items = xcalloc(ret.size, sizeof(*ret.items));
+  ret.items = nlua_calloc(arena, ret.size, sizeof(*ret.items));
 
   lua_pushnil(lstate);
   for (size_t i = 0; lua_next(lstate, -2) && i < ret.size;) {
@@ -1009,11 +1028,11 @@ static Dictionary nlua_pop_Dictionary_unchecked(lua_State *lstate, const LuaTabl
       lua_pushvalue(lstate, -2);
       // stack: dict, key, value, key
 
-      ret.items[i].key = nlua_pop_String(lstate, err);
+      ret.items[i].key = nlua_pop_String(lstate, arena, err);
       // stack: dict, key, value
 
       if (!ERROR_SET(err)) {
-        ret.items[i].value = nlua_pop_Object(lstate, ref, err);
+        ret.items[i].value = nlua_pop_Object(lstate, ref, arena, err);
         // stack: dict, key
       } else {
         lua_pop(lstate, 1);
@@ -1022,7 +1041,9 @@ static Dictionary nlua_pop_Dictionary_unchecked(lua_State *lstate, const LuaTabl
 
       if (ERROR_SET(err)) {
         ret.size = i;
-        api_free_dictionary(ret);
+        if (arena == NULL) {
+          api_free_dictionary(ret);
+        }
         lua_pop(lstate, 2);
         // stack:
         return (Dictionary) { .size = 0, .items = NULL };
@@ -1041,8 +1062,11 @@ static Dictionary nlua_pop_Dictionary_unchecked(lua_State *lstate, const LuaTabl
 /// Convert lua table to dictionary
 ///
 /// Always pops one value from the stack.
-Dictionary nlua_pop_Dictionary(lua_State *lstate, bool ref, Error *err)
-  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+///
+/// @param  arena  Arena to allocate the dictionary in, NULL to use the heap.
+///                Must be NULL when "ref" is true.
+Dictionary nlua_pop_Dictionary(lua_State *lstate, bool ref, Arena *arena, Error *err)
+  FUNC_ATTR_NONNULL_ARG(1, 4) FUNC_ATTR_WARN_UNUSED_RESULT
 {
   const LuaTableProps table_props = nlua_check_type(lstate, err,
                                                     kObjectTypeDictionary);
@@ -1051,7 +1075,7 @@ Dictionary nlua_pop_Dictionary(lua_State *lstate, bool ref, Error *err)
     return (Dictionary) { .size = 0, .items = NULL };
   }
 
-  return nlua_pop_Dictionary_unchecked(lstate, table_props, ref, err);
+  return nlua_pop_Dictionary_unchecked(lstate, table_props, ref, arena, err);
 }
 
 /// Helper structure for nlua_pop_Object
@@ -1063,8 +1087,13 @@ typedef struct {
 /// Convert lua table to object
 ///
 /// Always pops one value from the stack.
-Object nlua_pop_Object(lua_State *const lstate, bool ref, Error *const err)
+///
+/// @param  arena  Arena to allocate the object in, NULL to use the heap.
+///                Must be NULL when "ref" is true, as the LuaRef items would
+///                not be released with the arena.
+Object nlua_pop_Object(lua_State *const lstate, bool ref, Arena *arena, Error *const err)
 {
+  assert(!ref || arena == NULL);
   Object ret = NIL;
   const int initial_size = lua_gettop(lstate);
   kvec_withinit_t(ObjPopStackItem, 2) stack = KV_INITIAL_VALUE;
@@ -1099,7 +1128,7 @@ Object nlua_pop_Object(lua_State *const lstate, bool ref, Error *const err)
           const char *s = lua_tolstring(lstate, -2, &len);
           const size_t idx = cur.obj->data.dictionary.size++;
           cur.obj->data.dictionary.items[idx].key = (String) {
-            .data = xmemdupz(s, len),
+            .data = arena_memdupz(arena, s, len),
             .size = len,
           };
           kvi_push(stack, cur);
@@ -1132,7 +1161,7 @@ Object nlua_pop_Object(lua_State *const lstate, bool ref, Error *const err)
     case LUA_TSTRING: {
       size_t len;
       const char *s = lua_tolstring(lstate, -1, &len);
-      *cur.obj = STRING_OBJ(((String) { .data = xmemdupz(s, len), .size = len }));
+      *cur.obj = STRING_OBJ(((String) { .data = arena_memdupz(arena, s, len), .size = len }));
       break;
     }
     case LUA_TNUMBER: {
@@ -1153,8 +1182,8 @@ Object nlua_pop_Object(lua_State *const lstate, bool ref, Error *const err)
         *cur.obj = ARRAY_OBJ(((Array) { .items = NULL, .size = 0, .capacity = 0 }));
         if (table_props.maxidx != 0) {
           cur.obj->data.array.items =
-            xcalloc(table_props.maxidx,
-                    sizeof(cur.obj->data.array.items[0]));
+            nlua_calloc(arena, table_props.maxidx,
+                        sizeof(cur.obj->data.array.items[0]));
           cur.obj->data.array.capacity = table_props.maxidx;
           cur.container = true;
           kvi_push(stack, cur);
@@ -1164,8 +1193,8 @@ Object nlua_pop_Object(lua_State *const lstate, bool ref, Error *const err)
         *cur.obj = DICTIONARY_OBJ(((Dictionary) { .items = NULL, .size = 0, .capacity = 0 }));
         if (table_props.string_keys_num != 0) {
           cur.obj->data.dictionary.items =
-            xcalloc(table_props.string_keys_num,
-                    sizeof(cur.obj->data.dictionary.items[0]));
+            nlua_calloc(arena, table_props.string_keys_num,
+                        sizeof(cur.obj->data.dictionary.items[0]));
           cur.obj->data.dictionary.capacity = table_props.string_keys_num;
           cur.container = true;
           kvi_push(stack, cur);
@@ -1218,7 +1247,9 @@ type_error:
   }
   kvi_destroy(stack);
   if (ERROR_SET(err)) {
-    api_free_object(ret);
+    if (arena == NULL) {
+      api_free_object(ret);
+    }
     ret = NIL;
     lua_pop(lstate, lua_gettop(lstate) - initial_size + 1);
   }
@@ -1322,22 +1353,22 @@ void nlua_pop_keydict(lua_State *L, void *retval, FieldHashfn hashy, char **err_
     char *mem = ((char *)retval + field->ptr_off);
 
     if (field->type == kObjectTypeNil) {
-      *(Object *)mem = nlua_pop_Object(L, true, err);
+      *(Object *)mem = nlua_pop_Object(L, true, NULL, err);
     } else if (field->type == kObjectTypeInteger) {
       *(Integer *)mem = nlua_pop_Integer(L, err);
     } else if (field->type == kObjectTypeBoolean) {
       *(Boolean *)mem = nlua_pop_Boolean_strict(L, err);
     } else if (field->type == kObjectTypeString) {
-      *(String *)mem = nlua_pop_String(L, err);
+      *(String *)mem = nlua_pop_String(L, NULL, err);
     } else if (field->type == kObjectTypeFloat) {
       *(Float *)mem = nlua_pop_Float(L, err);
     } else if (field->type == kObjectTypeBuffer || field->type == kObjectTypeWindow
                || field->type == kObjectTypeTabpage) {
       *(handle_T *)mem = nlua_pop_handle(L, err);
     } else if (field->type == kObjectTypeArray) {
-      *(Array *)mem = nlua_pop_Array(L, err);
+      *(Array *)mem = nlua_pop_Array(L, NULL, err);
     } else if (field->type == kObjectTypeDictionary) {
-      *(Dictionary *)mem = nlua_pop_Dictionary(L, false, err);
+      *(Dictionary *)mem = nlua_pop_Dictionary(L, false, NULL, err);
     } else if (field->type == kObjectTypeLuaRef) {
       *(LuaRef *)mem = nlua_pop_LuaRef(L, err);
     } else {
@@ -16,6 +16,7 @@
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/atomic_defs.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/change.h"
 #include "nvim/cmdexpand_defs.h"
@@ -41,6 +42,7 @@
 #include "nvim/lua/executor.h"
 #include "nvim/lua/stdlib.h"
 #include "nvim/lua/treesitter.h"
+#include "nvim/lua/worker.h"
 #include "nvim/macros_defs.h"
 #include "nvim/main.h"
 #include "nvim/memline.h"
@@ -302,7 +304,7 @@ static int nlua_thr_api_nvim__get_runtime(lua_State *lstate)
   lua_pop(lstate, 1);
 
   Error err = ERROR_INIT;
-  const Array pat = nlua_pop_Array(lstate, &err);
+  const Array pat = nlua_pop_Array(lstate, NULL, &err);
   if (ERROR_SET(&err)) {
     luaL_where(lstate, 1);
     lua_pushstring(lstate, err.msg);
@@ -543,6 +545,17 @@ int nlua_get_global_ref_count(void)
   return nlua_global_refs->ref_count;
 }
 
+/// @return bytes in use by the heap of the main Lua state.
+size_t nlua_heap_bytes(void)
+{
+  lua_State *const lstate = global_lstate;
+  if (lstate == NULL) {
+    return 0;
+  }
+  return (size_t)lua_gc(lstate, LUA_GCCOUNT, 0) * 1024
+         + (size_t)lua_gc(lstate, LUA_GCCOUNTB, 0);
+}
+
 static void nlua_common_vim_init(lua_State *lstate, bool is_thread, bool is_standalone)
   FUNC_ATTR_NONNULL_ARG(1)
 {
@@ -751,6 +764,10 @@ static bool nlua_state_init(lua_State *const lstate) FUNC_ATTR_NONNULL_ALL
   lua_pushcfunction(lstate, &nlua_schedule);
   lua_setfield(lstate, -2, "schedule");
 
+  // _worker_start
+  lua_pushcfunction(lstate, &nlua_worker_start);
+  lua_setfield(lstate, -2, "_worker_start");
+
   // in_fast_event
   lua_pushcfunction(lstate, &nlua_in_fast_event);
   lua_setfield(lstate, -2, "in_fast_event");
@@ -767,6 +784,10 @@ static bool nlua_state_init(lua_State *const lstate) FUNC_ATTR_NONNULL_ALL
   lua_pushcfunction(lstate, &nlua_rpcnotify);
   lua_setfield(lstate, -2, "rpcnotify");
 
+  // _rpcrequest_async
+  lua_pushcfunction(lstate, &nlua_rpcrequest_async);
+  lua_setfield(lstate, -2, "_rpcrequest_async");
+
   // wait
   lua_pushcfunction(lstate, &nlua_wait);
   lua_setfield(lstate, -2, "wait");
@@ -840,6 +861,20 @@ static lua_State *nlua_thread_acquire_vm(void)
   return nlua_init_state(true);
 }
 
+/// Create a Lua state for a thread other than the main one, with the same
+/// subset of `vim` as for vim.uv.new_thread().
+lua_State *nlua_thread_state_new(void)
+{
+  return nlua_init_state(true);
+}
+
+/// Free a state created with nlua_thread_state_new().
+void nlua_thread_state_free(lua_State *lstate)
+  FUNC_ATTR_NONNULL_ALL
+{
+  nlua_common_free_all_mem(lstate);
+}
+
 void nlua_run_script(char **argv, int argc, int lua_arg0)
   FUNC_ATTR_NORETURN
 {
@@ -1238,7 +1273,7 @@ static int nlua_rpc(lua_State *lstate, bool request)
 
   for (int i = 0; i < nargs; i++) {
     lua_pushvalue(lstate, i + 3);
-    ADD(args, nlua_pop_Object(lstate, false, &err));
+    ADD(args, nlua_pop_Object(lstate, false, NULL, &err));
     if (ERROR_SET(&err)) {
       api_free_array(args);
       goto check_err;
@@ -1270,6 +1305,60 @@ check_err:
   return request ? 1 : 0;
 }
 
+static void nlua_rpc_response(Object result, Error *err, void *data)
+{
+  LuaRef cb = (LuaRef)(ptrdiff_t)data;
+  lua_State *const lstate = global_lstate;
+  nlua_pushref(lstate, cb);
+  nlua_unref_global(lstate, cb);
+  if (ERROR_SET(err)) {
+    lua_pushstring(lstate, err->msg);
+    lua_pushnil(lstate);
+  } else {
+    lua_pushnil(lstate);
+    nlua_push_Object(lstate, result, false);
+  }
+  if (nlua_pcall(lstate, 2, 0)) {
+    nlua_error(lstate, _("Error executing vim.rpcrequest_async callback: %.*s"));
+  }
+}
+
+/// vim._rpcrequest_async({channel}, {method}, {callback}, {...}): sends a
+/// request without waiting for the response.  {callback} is invoked with
+/// (err, result) from the main loop.
+static int nlua_rpcrequest_async(lua_State *lstate)
+{
+  uint64_t chan_id = (uint64_t)luaL_checkinteger(lstate, 1);
+  const char *name = luaL_checkstring(lstate, 2);
+  luaL_checktype(lstate, 3, LUA_TFUNCTION);
+  int nargs = lua_gettop(lstate) - 3;
+  Error err = ERROR_INIT;
+  Array args = ARRAY_DICT_INIT;
+
+  for (int i = 0; i < nargs; i++) {
+    lua_pushvalue(lstate, i + 4);
+    ADD(args, nlua_pop_Object(lstate, false, NULL, &err));
+    if (ERROR_SET(&err)) {
+      api_free_array(args);
+      goto check_err;
+    }
+  }
+
+  LuaRef cb = nlua_ref_global(lstate, 3);
+  if (!rpc_send_call_async(chan_id, name, args, nlua_rpc_response, (void *)(ptrdiff_t)cb)) {
+    nlua_unref_global(lstate, cb);
+    api_set_error(&err, kErrorTypeValidation, "Invalid channel: %" PRIu64, chan_id);
+  }
+
+check_err:
+  if (ERROR_SET(&err)) {
+    lua_pushstring(lstate, err.msg);
+    api_clear_error(&err);
+    return lua_error(lstate);
+  }
+  return 0;
+}
+
 static int nlua_nil_tostring(lua_State *lstate)
 {
   lua_pushstring(lstate, "vim.NIL");
@@ -1560,7 +1649,7 @@ Object nlua_exec(const String str, const Array args, Error *err)
     return NIL;
   }
 
-  return nlua_pop_Object(lstate, false, err);
+  return nlua_pop_Object(lstate, false, NULL, err);
 }
 
 bool nlua_ref_is_function(LuaRef ref)
@@ -1617,7 +1706,7 @@ Object nlua_call_ref(LuaRef ref, const char *name, Array args, bool retval, Erro
     if (err == NULL) {
       err = &dummy;
     }
-    return nlua_pop_Object(lstate, false, err);
+    return nlua_pop_Object(lstate, false, NULL, err);
   } else {
     bool value = lua_toboolean(lstate, -1);
     lua_pop(lstate, 1);
@@ -1865,6 +1954,9 @@ static void nlua_add_treesitter(lua_State *const lstate) FUNC_ATTR_NONNULL_ALL
   lua_pushcfunction(lstate, tslua_parse_query);
   lua_setfield(lstate, -2, "_ts_parse_query");
 
+  lua_pushcfunction(lstate, tslua_parse_many);
+  lua_setfield(lstate, -2, "_ts_parse_many");
+
   lua_pushcfunction(lstate, tslua_get_language_version);
   lua_setfield(lstate, -2, "_ts_get_language_version");
 
@@ -1904,7 +1996,7 @@ int nlua_expand_pat(expand_T *xp, char *pat, int *num_results, char ***results)
     goto cleanup;
   }
 
-  Array completions = nlua_pop_Array(lstate, &err);
+  Array completions = nlua_pop_Array(lstate, NULL, &err);
   if (ERROR_SET(&err)) {
     ret = FAIL;
     goto cleanup_array;
@@ -2039,6 +2131,66 @@ void nlua_execute_on_key(int c)
 #endif
 }
 
+/// Lua state the ":profile sample" hook was called for, NULL if not in it.
+static lua_State *sample_lstate = NULL;
+
+/// Number of Lua instructions between two checks for a due sample.
+enum { NLUA_SAMPLE_COUNT = 1000, };
+
+static void nlua_sample_hook(lua_State *lstate, lua_Debug *ar)
+{
+  if (ATOMIC_LOAD_BOOL(&profile_sample_due)) {
+    sample_lstate = lstate;
+    profile_sample_take();
+    sample_lstate = NULL;
+  }
+}
+
+/// Check for due samples of ":profile sample" while Lua code runs.
+///
+/// Replaces a hook set with debug.sethook() until nlua_sample_stop().
+void nlua_sample_start(void)
+{
+  lua_sethook(global_lstate, nlua_sample_hook, LUA_MASKCOUNT, NLUA_SAMPLE_COUNT);
+}
+
+void nlua_sample_stop(void)
+{
+  lua_sethook(global_lstate, NULL, 0, 0);
+}
+
+/// Add the frames of the Lua call stack to ":profile sample" stack "gap",
+/// outermost first.
+void nlua_sample_stack(garray_T *gap)
+{
+  lua_State *const lstate = sample_lstate != NULL ? sample_lstate : global_lstate;
+  if (lstate == NULL) {
+    return;
+  }
+  lua_Debug ar;
+  int depth = 0;
+  while (lua_getstack(lstate, depth, &ar)) {
+    depth++;
+  }
+  for (int level = depth - 1; level >= 0; level--) {
+    if (!lua_getstack(lstate, level, &ar) || !lua_getinfo(lstate, "Sn", &ar)
+        || ar.what[0] == 'C') {
+      continue;
+    }
+    if (gap->ga_len > 0) {
+      ga_append(gap, ';');
+    }
+    if (ar.name != NULL) {
+      ga_concat(gap, ar.name);
+      ga_append(gap, ' ');
+    }
+    char buf[NUMBUFLEN];
+    snprintf(buf, sizeof(buf), ":%d", ar.linedefined);
+    ga_concat(gap, ar.short_src);
+    ga_concat(gap, buf);
+  }
+}
+
 // Sets the editor "script context" during Lua execution. Used by :verbose.
 // @param[out] current
 void nlua_set_sctx(sctx_T *current)
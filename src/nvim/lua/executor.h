@@ -11,6 +11,7 @@
 #include "nvim/eval/typval_defs.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/func_attr.h"
+#include "nvim/garray_defs.h"  // IWYU pragma: keep
 #include "nvim/lua/converter.h"
 #include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
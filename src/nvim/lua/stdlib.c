@@ -17,6 +17,7 @@
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/eval/typval.h"
 #include "nvim/eval/vars.h"
@@ -28,6 +29,7 @@
 #include "nvim/lua/spell.h"
 #include "nvim/lua/stdlib.h"
 #include "nvim/lua/xdiff.h"
+#include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
@@ -538,11 +540,21 @@ static int nlua_iconv(lua_State *lstate)
   return 1;
 }
 
-// Update foldlevels (e.g., by evaluating 'foldexpr') for all lines in the current window without
-// invoking other side effects. Unlike `zx`, it does not close manually opened folds and does not
-// open folds under the cursor.
+// Update foldlevels (e.g., by evaluating 'foldexpr') in the current window without invoking other
+// side effects. Unlike `zx`, it does not close manually opened folds and does not open folds under
+// the cursor.
+//
+// With no arguments all lines are updated. With a 0-indexed, end-exclusive line range only the
+// folds from that range on are evaluated again, until they match the existing folds.
 static int nlua_foldupdate(lua_State *lstate)
 {
+  if (lua_gettop(lstate) >= 2) {
+    linenr_T top = (linenr_T)luaL_checkinteger(lstate, 1) + 1;
+    linenr_T bot = (linenr_T)luaL_checkinteger(lstate, 2);
+    foldUpdate(curwin, MAX(top, 1), MAX(bot, top));
+    return 0;
+  }
+
   curwin->w_foldinvalid = true;  // recompute folds
   foldUpdate(curwin, 1, (linenr_T)MAXLNUM);
   curwin->w_foldinvalid = false;
@@ -613,6 +625,10 @@ void nlua_state_add_stdlib(lua_State *const lstate, bool is_thread)
     luaopen_base64(lstate);
     lua_setfield(lstate, -2, "base64");
 
+    // vim.diff_async
+    lua_pushcfunction(lstate, &nlua_xdl_diff_async);
+    lua_setfield(lstate, -2, "diff_async");
+
     nlua_state_add_internal(lstate);
   }
 
@@ -668,3 +684,72 @@ void nlua_push_errstr(lua_State *L, const char *fmt, ...)
   va_end(argp);
   lua_concat(L, 2);
 }
+
+// Read-only buffer accessors for LuaJIT FFI, see |lua-ffi-buffer|. Their
+// signatures are part of the documented interface: only plain C types, so
+// that they can be declared with ffi.cdef() without any nvim header.
+
+/// @return  loaded buffer "bufnr" (0 for the current buffer), or NULL.
+static buf_T *ffi_find_buf(int bufnr)
+{
+  buf_T *buf = bufnr == 0 ? curbuf : handle_get_buffer(bufnr);
+  if (buf == NULL || buf->b_ml.ml_mfp == NULL) {
+    return NULL;
+  }
+  return buf;
+}
+
+/// @return  b:changedtick of buffer "bufnr", or -1 if it is not loaded.
+int64_t nlua_buf_changedtick(int bufnr)
+{
+  buf_T *buf = ffi_find_buf(bufnr);
+  return buf ? (int64_t)buf_get_changedtick(buf) : -1;
+}
+
+/// @return  number of lines in buffer "bufnr", or -1 if it is not loaded.
+int64_t nlua_buf_line_count(int bufnr)
+{
+  buf_T *buf = ffi_find_buf(bufnr);
+  return buf ? (int64_t)buf->b_ml.ml_line_count : -1;
+}
+
+/// Get the text of line "lnum" (1-based) of buffer "bufnr" without copying it.
+///
+/// The text is NUL terminated and must not be modified. Like for ml_get() it
+/// is only valid until the next call that reads or changes any buffer,
+/// including a call back into the API.
+///
+/// @param[out] len  length of the line, excluding the NUL
+///
+/// @return  the line, or NULL if the buffer is not loaded or "lnum" is out of
+///          range.
+const char *nlua_buf_get_line(int bufnr, int64_t lnum, size_t *len)
+  FUNC_ATTR_NONNULL_ALL
+{
+  buf_T *buf = ffi_find_buf(bufnr);
+  if (buf == NULL || lnum < 1 || lnum > buf->b_ml.ml_line_count) {
+    return NULL;
+  }
+  char *line = ml_get_buf(buf, (linenr_T)lnum);
+  *len = strlen(line);
+  return line;
+}
+
+/// Get lines "lnum" (1-based) and following of buffer "bufnr" without copying
+/// them, as many as are stored in the same memline block (at most "maxcount").
+/// The text is valid for as long as for nlua_buf_get_line().
+///
+/// @param[out] lines  pointers to the text of the lines
+/// @param[out] lens  length of each line, excluding the NUL
+///
+/// @return  number of lines stored in "lines" and "lens", or 0 if the buffer
+///          is not loaded or "lnum" is out of range.
+int nlua_buf_get_lines(int bufnr, int64_t lnum, int maxcount, const char **lines, int *lens)
+  FUNC_ATTR_NONNULL_ALL
+{
+  buf_T *buf = ffi_find_buf(bufnr);
+  if (buf == NULL || maxcount < 1 || lnum < 1 || lnum > buf->b_ml.ml_line_count) {
+    return 0;
+  }
+  return ml_get_buf_lines(buf, (linenr_T)lnum, maxcount, (char **)lines, lens);
+}
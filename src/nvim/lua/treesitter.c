@@ -17,14 +17,22 @@
 
 #include "klib/kvec.h"
 #include "nvim/api/private/helpers.h"
+#include "nvim/ascii_defs.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/event/multiqueue.h"
+#include "nvim/garray.h"
+#include "nvim/gettext.h"
 #include "nvim/globals.h"
+#include "nvim/log.h"
+#include "nvim/lua/executor.h"
 #include "nvim/lua/treesitter.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/pos_defs.h"
+#include "nvim/regexp.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
 
@@ -50,8 +58,22 @@ typedef struct {
 
 typedef struct {
   TSTree *tree;
+  kvec_t(TSNode) handles;  ///< Nodes handed out as handles, see push_handle()
+  Map(uint64_t, uint64_t) handle_ids;  ///< Index in `handles` by node id
+  uint32_t generation;  ///< Of the handles, changed by tree:edit()
 } TSLuaTree;
 
+typedef struct {
+  TSParser *parser;
+  TSTree *old_tree;
+  TSTree *new_tree;
+  char *text;
+  size_t len;
+  bool include_bytes;
+  LuaRef cb;
+  uv_work_t req;
+} TSLuaParseJob;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "lua/treesitter.c.generated.h"
 #endif
@@ -60,6 +82,7 @@ static struct luaL_Reg parser_meta[] = {
   { "__gc", parser_gc },
   { "__tostring", parser_tostring },
   { "parse", parser_parse },
+  { "parse_async", parser_parse_async },
   { "reset", parser_reset },
   { "set_included_ranges", parser_set_ranges },
   { "included_ranges", parser_get_ranges },
@@ -77,6 +100,22 @@ static struct luaL_Reg tree_meta[] = {
   { "edit", tree_edit },
   { "included_ranges", tree_get_ranges },
   { "copy", tree_copy },
+  { "root_handle", tree_root_handle },
+  { "to_handle", tree_to_handle },
+  { "from_handle", tree_from_handle },
+  { "handle_type", handle_type },
+  { "handle_symbol", handle_symbol },
+  { "handle_named", handle_named },
+  { "handle_range", handle_range },
+  { "handle_child_count", handle_child_count },
+  { "handle_named_child_count", handle_named_child_count },
+  { "handle_child", handle_child },
+  { "handle_named_child", handle_named_child },
+  { "handle_parent", handle_parent },
+  { "handle_next_sibling", handle_next_sibling },
+  { "handle_prev_sibling", handle_prev_sibling },
+  { "handle_next_named_sibling", handle_next_named_sibling },
+  { "handle_prev_named_sibling", handle_prev_named_sibling },
   { NULL, NULL }
 };
 
@@ -106,6 +145,7 @@ static struct luaL_Reg node_meta[] = {
   { "parent", node_parent },
   { "iter_children", node_iter_children },
   { "_rawquery", node_rawquery },
+  { "_rawquery_captures", node_rawquery_captures },
   { "next_sibling", node_next_sibling },
   { "prev_sibling", node_prev_sibling },
   { "next_named_sibling", node_next_named_sibling },
@@ -355,37 +395,44 @@ static int parser_tostring(lua_State *L)
   return 1;
 }
 
+/// Size of the chunks of buffer text handed to tree-sitter. A chunk holds as
+/// many lines as fit, a longer line is split over several chunks.
+enum { TS_INPUT_CHUNK = 16 * 1024, };
+
 static const char *input_cb(void *payload, uint32_t byte_index, TSPoint position,
                             uint32_t *bytes_read)
 {
   buf_T *bp = payload;
-#define BUFSIZE 256
-  static char buf[BUFSIZE];
-
-  if ((linenr_T)position.row >= bp->b_ml.ml_line_count) {
-    *bytes_read = 0;
-    return "";
-  }
-  char *line = ml_get_buf(bp, (linenr_T)position.row + 1);
-  size_t len = strlen(line);
-  if (position.column > len) {
-    *bytes_read = 0;
-    return "";
-  }
-  size_t tocopy = MIN(len - position.column, BUFSIZE);
-
-  memcpy(buf, line + position.column, tocopy);
-  // Translate embedded \n to NUL
-  memchrsub(buf, '\n', '\0', tocopy);
-  *bytes_read = (uint32_t)tocopy;
-  if (tocopy < BUFSIZE) {
-    // now add the final \n. If it didn't fit, input_cb will be called again
-    // on the same line with advanced column.
-    buf[tocopy] = '\n';
-    (*bytes_read)++;
-  }
-  return buf;
-#undef BUFSIZE
+  static char buf[TS_INPUT_CHUNK];
+
+  linenr_T lnum = (linenr_T)position.row + 1;
+  size_t col = position.column;
+  size_t filled = 0;
+
+  while (filled < TS_INPUT_CHUNK && lnum <= bp->b_ml.ml_line_count) {
+    char *line = ml_get_buf(bp, lnum);
+    size_t len = strlen(line);
+    if (col > len) {
+      break;
+    }
+    size_t tocopy = MIN(len - col, TS_INPUT_CHUNK - filled);
+
+    memcpy(buf + filled, line + col, tocopy);
+    // Translate embedded \n to NUL
+    memchrsub(buf + filled, '\n', '\0', tocopy);
+    filled += tocopy;
+    if (filled == TS_INPUT_CHUNK) {
+      // The final \n didn't fit, input_cb will be called again on the same
+      // line with advanced column.
+      break;
+    }
+    buf[filled++] = '\n';
+    lnum++;
+    col = 0;
+  }
+
+  *bytes_read = (uint32_t)filled;
+  return filled ? buf : "";
 }
 
 static void push_ranges(lua_State *L, const TSRange *ranges, const size_t length,
@@ -436,6 +483,7 @@ static int parser_parse(lua_State *L)
   buf_T *buf;
   TSInput input;
 
+  NVIM_PROBE(ts_parse_begin, 1, old_tree != NULL);
   // This switch is necessary because of the behavior of lua_isstring, that
   // consider numbers as strings...
   switch (lua_type(L, 3)) {
@@ -465,6 +513,7 @@ static int parser_parse(lua_State *L)
     return luaL_argerror(L, 3, "expected either string or buffer handle");
   }
 
+  NVIM_PROBE(ts_parse_end, 1, new_tree != NULL);
   bool include_bytes = (lua_gettop(L) >= 4) && lua_toboolean(L, 4);
 
   // Sometimes parsing fails (timeout, or wrong parser ABI)
@@ -486,6 +535,382 @@ static int parser_parse(lua_State *L)
   return 2;
 }
 
+/// Copies the text of buffer `buf` into one string, the way input_cb() reads
+/// it: every line ends in "\n" and embedded "\n" are turned back into NUL.
+static char *buf_snapshot(buf_T *buf, size_t *len)
+{
+  size_t size = 0;
+  for (linenr_T lnum = 1; lnum <= buf->b_ml.ml_line_count; lnum++) {
+    size += strlen(ml_get_buf(buf, lnum)) + 1;
+  }
+
+  char *text = xmalloc(size + 1);
+  char *p = text;
+  for (linenr_T lnum = 1; lnum <= buf->b_ml.ml_line_count; lnum++) {
+    char *line = ml_get_buf(buf, lnum);
+    size_t linelen = strlen(line);
+    memcpy(p, line, linelen);
+    memchrsub(p, '\n', '\0', linelen);
+    p += linelen;
+    *p++ = '\n';
+  }
+  *p = '\0';
+  *len = size;
+  return text;
+}
+
+/// Runs on a libuv worker thread: only touches the job.
+static void parse_async_work(uv_work_t *req)
+{
+  TSLuaParseJob *job = req->data;
+  job->new_tree = ts_parser_parse_string(job->parser, job->old_tree, job->text,
+                                         (uint32_t)job->len);
+}
+
+static void parse_async_free(TSLuaParseJob *job)
+{
+  ts_parser_delete(job->parser);
+  ts_tree_delete(job->old_tree);
+  ts_tree_delete(job->new_tree);
+  xfree(job->text);
+  xfree(job);
+}
+
+/// Back on the main thread. The callback may do anything, so it is deferred
+/// to `main_loop.events` instead of being called from inside uv_run().
+static void parse_async_done(uv_work_t *req, int status)
+{
+  TSLuaParseJob *job = req->data;
+  if (main_loop.closing) {
+    parse_async_free(job);
+    return;
+  }
+  multiqueue_put(main_loop.events, parse_async_event, job);
+}
+
+static void parse_async_event(void **argv)
+{
+  TSLuaParseJob *job = argv[0];
+  lua_State *const L = get_global_lstate();
+
+  nlua_pushref(L, job->cb);
+  nlua_unref_global(L, job->cb);
+  int nargs;
+  if (job->new_tree) {
+    uint32_t n_ranges = 0;
+    TSRange *changed = job->old_tree
+                       ? ts_tree_get_changed_ranges(job->old_tree, job->new_tree, &n_ranges)
+                       : NULL;
+    lua_pushnil(L);  // [cb, nil]
+    push_tree(L, job->new_tree);  // [cb, nil, tree]
+    push_ranges(L, changed, n_ranges, job->include_bytes);  // [cb, nil, tree, ranges]
+    xfree(changed);
+    job->new_tree = NULL;  // now owned by the Lua GC
+    nargs = 3;
+  } else {
+    lua_pushstring(L, "An error occurred when parsing.");
+    nargs = 1;
+  }
+  parse_async_free(job);
+
+  if (nlua_pcall(L, nargs, 0)) {
+    nlua_error(L, _("Error executing treesitter parse callback: %.*s"));
+  }
+}
+
+/// parser:parse_async(old_tree, source, include_bytes, callback)
+///
+/// Like parser:parse(), but the text is parsed on a worker thread by a copy
+/// of the parser. The source and `old_tree` are copied before returning, so
+/// they can be changed while the parse runs. `callback(err, tree, ranges)`
+/// is called from the main loop once the tree is ready.
+static int parser_parse_async(lua_State *L)
+{
+  TSParser **p = parser_check(L, 1);
+  if (!p || !(*p)) {
+    return 0;
+  }
+
+  TSTree *old_tree = NULL;
+  if (!lua_isnil(L, 2)) {
+    TSLuaTree *ud = tree_check(L, 2);
+    old_tree = ud ? ud->tree : NULL;
+  }
+
+  if (!lua_isfunction(L, 5)) {
+    return luaL_argerror(L, 5, "function expected");
+  }
+
+  char *text;
+  size_t len;
+  handle_T bufnr;
+  buf_T *buf;
+
+  switch (lua_type(L, 3)) {
+  case LUA_TSTRING: {
+    const char *str = lua_tolstring(L, 3, &len);
+    text = xmemdupz(str, len);
+    break;
+  }
+
+  case LUA_TNUMBER:
+    bufnr = (handle_T)lua_tointeger(L, 3);
+    buf = handle_get_buffer(bufnr);
+
+    if (!buf) {
+#define BUFSIZE 256
+      char ebuf[BUFSIZE] = { 0 };
+      vim_snprintf(ebuf, BUFSIZE, "invalid buffer handle: %d", bufnr);
+      return luaL_argerror(L, 3, ebuf);
+#undef BUFSIZE
+    }
+
+    text = buf_snapshot(buf, &len);
+    break;
+
+  default:
+    return luaL_argerror(L, 3, "expected either string or buffer handle");
+  }
+
+  TSParser *parser = ts_parser_new();
+  if (!ts_parser_set_language(parser, ts_parser_language(*p))) {
+    ts_parser_delete(parser);
+    xfree(text);
+    return luaL_error(L, "Failed to copy the parser language");
+  }
+  uint32_t n_ranges;
+  const TSRange *ranges = ts_parser_included_ranges(*p, &n_ranges);
+  ts_parser_set_included_ranges(parser, ranges, n_ranges);
+  ts_parser_set_timeout_micros(parser, ts_parser_timeout_micros(*p));
+
+  TSLuaParseJob *job = xmalloc(sizeof(*job));
+  *job = (TSLuaParseJob){
+    .parser = parser,
+    .old_tree = old_tree ? ts_tree_copy(old_tree) : NULL,
+    .text = text,
+    .len = len,
+    .include_bytes = lua_toboolean(L, 4),
+    .cb = nlua_ref_global(L, 5),
+  };
+  job->req.data = job;
+
+  if (uv_queue_work(&main_loop.uv, &job->req, parse_async_work, parse_async_done) != 0) {
+    nlua_unref_global(L, job->cb);
+    parse_async_free(job);
+    return luaL_error(L, "Failed to start the parse");
+  }
+  return 0;
+}
+
+/// Number of threads parsing the jobs of vim._ts_parse_many(), counting the
+/// main thread.
+enum { TS_PARSE_THREADS = 4, };
+
+typedef struct {
+  TSParser *parser;
+  TSTree *old_tree;
+  TSRange *ranges;
+  uint32_t n_ranges;
+  TSTree *new_tree;
+  int next;  ///< Next job with the same parser, or -1.
+} TSLuaBatchJob;
+
+/// Jobs of vim._ts_parse_many(). The jobs of a parser form a group, parsed
+/// in order by one thread.
+typedef struct {
+  const char *text;
+  size_t len;
+  TSLuaBatchJob *jobs;
+  int n_jobs;
+  int *groups;  ///< First job of each group.
+  int n_groups;
+  int next_group;
+  uv_mutex_t mutex;
+} TSLuaBatch;
+
+static void batch_parse_group(TSLuaBatch *batch, int group)
+{
+  for (int j = batch->groups[group]; j >= 0; j = batch->jobs[j].next) {
+    TSLuaBatchJob *job = &batch->jobs[j];
+    ts_parser_set_included_ranges(job->parser, job->ranges, job->n_ranges);
+    job->new_tree = ts_parser_parse_string(job->parser, job->old_tree, batch->text,
+                                           (uint32_t)batch->len);
+  }
+}
+
+/// Takes groups until there are none left. Parsers with a logger call back
+/// into Lua, so these are left to the main thread.
+static void batch_parse_thread(void *arg)
+{
+  TSLuaBatch *batch = arg;
+  while (true) {
+    uv_mutex_lock(&batch->mutex);
+    int group = batch->next_group < batch->n_groups ? batch->next_group++ : -1;
+    uv_mutex_unlock(&batch->mutex);
+    if (group < 0) {
+      return;
+    }
+    if (!ts_parser_logger(batch->jobs[batch->groups[group]].parser).log) {
+      batch_parse_group(batch, group);
+    }
+  }
+}
+
+/// Reads the jobs of vim._ts_parse_many() into "batch". Called with
+/// lua_pcall(), so that the caller can free the jobs read so far when one is
+/// invalid.
+static int batch_read_jobs(lua_State *L)
+{
+  // [jobs, batch]
+  TSLuaBatch *batch = lua_touserdata(L, 2);
+  for (int j = 0; j < batch->n_jobs; j++) {
+    TSLuaBatchJob *job = &batch->jobs[j];
+    lua_rawgeti(L, 1, j + 1);  // [job]
+    luaL_checktype(L, -1, LUA_TTABLE);
+
+    lua_rawgeti(L, -1, 1);  // [job, parser]
+    TSParser **p = parser_check(L, -1);
+    job->parser = *p;
+    lua_pop(L, 1);
+
+    lua_rawgeti(L, -1, 2);  // [job, old_tree]
+    if (!lua_isnil(L, -1)) {
+      job->old_tree = tree_check(L, -1)->tree;
+    }
+    lua_pop(L, 1);
+
+    lua_rawgeti(L, -1, 3);  // [job, ranges]
+    if (lua_istable(L, -1)) {
+      job->n_ranges = (uint32_t)lua_objlen(L, -1);
+      job->ranges = xmalloc(sizeof(TSRange) * MAX(job->n_ranges, 1));
+      for (uint32_t i = 0; i < job->n_ranges; i++) {
+        lua_rawgeti(L, -1, (int)i + 1);  // [job, ranges, range]
+        range_from_lua(L, job->ranges + i);
+        lua_pop(L, 1);
+      }
+    }
+    lua_pop(L, 2);  // []
+
+    job->next = -1;
+    int g;
+    for (g = 0; g < batch->n_groups; g++) {
+      if (batch->jobs[batch->groups[g]].parser == job->parser) {
+        break;
+      }
+    }
+    if (g == batch->n_groups) {
+      batch->groups[batch->n_groups++] = j;
+    } else {
+      int last = batch->groups[g];
+      while (batch->jobs[last].next >= 0) {
+        last = batch->jobs[last].next;
+      }
+      batch->jobs[last].next = j;
+    }
+  }
+  return 0;
+}
+
+static void batch_free(TSLuaBatch *batch)
+{
+  for (int j = 0; j < batch->n_jobs; j++) {
+    xfree(batch->jobs[j].ranges);
+  }
+  xfree(batch->jobs);
+  xfree(batch->groups);
+}
+
+/// vim._ts_parse_many(source, jobs)
+///
+/// Parses several regions at once, on up to TS_PARSE_THREADS threads. Each
+/// job is a table { parser, old_tree, ranges }, where `ranges` are set as the
+/// included ranges of the parser, as parser:set_included_ranges() does. A
+/// parser can be in several jobs, these are parsed in order.
+///
+/// Returns a list with { tree, changed_ranges } for each job, or false if the
+/// parse failed. The changed ranges include bytes.
+int tslua_parse_many(lua_State *L)
+{
+  luaL_checktype(L, 2, LUA_TTABLE);
+  TSLuaBatch batch = { 0 };
+  char *snapshot = NULL;
+  switch (lua_type(L, 1)) {
+  case LUA_TSTRING:
+    batch.text = lua_tolstring(L, 1, &batch.len);
+    break;
+
+  case LUA_TNUMBER: {
+    handle_T bufnr = (handle_T)lua_tointeger(L, 1);
+    buf_T *buf = handle_get_buffer(bufnr);
+    if (!buf) {
+      return luaL_argerror(L, 1, "invalid buffer handle");
+    }
+    snapshot = buf_snapshot(buf, &batch.len);
+    batch.text = snapshot;
+    break;
+  }
+
+  default:
+    return luaL_argerror(L, 1, "expected either string or buffer handle");
+  }
+
+  batch.n_jobs = (int)lua_objlen(L, 2);
+  batch.jobs = xcalloc((size_t)MAX(batch.n_jobs, 1), sizeof(TSLuaBatchJob));
+  batch.groups = xmalloc((size_t)MAX(batch.n_jobs, 1) * sizeof(int));
+  lua_pushcfunction(L, batch_read_jobs);
+  lua_pushvalue(L, 2);
+  lua_pushlightuserdata(L, &batch);
+  if (lua_pcall(L, 2, 0, 0) != 0) {
+    batch_free(&batch);
+    xfree(snapshot);
+    return lua_error(L);
+  }
+
+  uv_mutex_init(&batch.mutex);
+  uv_thread_t threads[TS_PARSE_THREADS - 1];
+  int n_threads = 0;
+  for (int i = 0; i < MIN(TS_PARSE_THREADS, batch.n_groups) - 1; i++) {
+    if (uv_thread_create(&threads[n_threads], batch_parse_thread, &batch) == 0) {
+      n_threads++;
+    }
+  }
+  batch_parse_thread(&batch);
+  for (int i = 0; i < n_threads; i++) {
+    uv_thread_join(&threads[i]);
+  }
+  uv_mutex_destroy(&batch.mutex);
+
+  for (int g = 0; g < batch.n_groups; g++) {
+    if (ts_parser_logger(batch.jobs[batch.groups[g]].parser).log) {
+      batch_parse_group(&batch, g);
+    }
+  }
+
+  lua_createtable(L, batch.n_jobs, 0);  // [results]
+  for (int j = 0; j < batch.n_jobs; j++) {
+    TSLuaBatchJob *job = &batch.jobs[j];
+    if (job->new_tree) {
+      uint32_t n_changed = 0;
+      TSRange *changed = job->old_tree
+                         ? ts_tree_get_changed_ranges(job->old_tree, job->new_tree, &n_changed)
+                         : NULL;
+      lua_createtable(L, 2, 0);  // [results, result]
+      push_tree(L, job->new_tree);  // [results, result, tree]
+      lua_rawseti(L, -2, 1);
+      push_ranges(L, changed, n_changed, true);  // [results, result, ranges]
+      lua_rawseti(L, -2, 2);
+      xfree(changed);
+    } else {
+      lua_pushboolean(L, false);  // [results, false]
+    }
+    lua_rawseti(L, -2, j + 1);  // [results]
+  }
+
+  batch_free(&batch);
+  xfree(snapshot);
+  return 1;
+}
+
 static int parser_reset(lua_State *L)
 {
   TSParser **p = parser_check(L, 1);
@@ -532,6 +957,7 @@ static int tree_edit(lua_State *L)
                        start_point, old_end_point, new_end_point };
 
   ts_tree_edit(ud->tree, &edit);
+  handles_clear(ud);
 
   return 0;
 }
@@ -785,7 +1211,7 @@ static void push_tree(lua_State *L, TSTree *tree)
 
   TSLuaTree *ud = lua_newuserdata(L, sizeof(TSLuaTree));  // [udata]
 
-  ud->tree = tree;
+  *ud = (TSLuaTree){ .tree = tree, .handle_ids = MAP_INIT };
 
   lua_getfield(L, LUA_REGISTRYINDEX, TS_META_TREE);  // [udata, meta]
   lua_setmetatable(L, -2);  // [udata]
@@ -811,6 +1237,8 @@ static int tree_gc(lua_State *L)
   TSLuaTree *ud = tree_check(L, 1);
   if (ud) {
     ts_tree_delete(ud->tree);
+    kv_destroy(ud->handles);
+    map_destroy(uint64_t, &ud->handle_ids);
   }
   return 0;
 }
@@ -832,6 +1260,196 @@ static int tree_root(lua_State *L)
   return 1;
 }
 
+// Node handles
+//
+// A handle is an integer naming a node of a tree, so that walking a tree
+// from Lua with the tree:handle_*() methods doesn't make a userdata for each
+// node. The tree keeps the nodes it handed out, a node gets the same handle
+// every time. tree:edit() invalidates all the handles of the tree.
+
+/// The generation is in the upper bits of a handle, kept small enough that
+/// handles are exact as Lua numbers.
+enum {
+  HANDLE_INDEX_BITS = 32,
+  HANDLE_GENERATION_MASK = 0xfffff,
+};
+
+static void push_handle(lua_State *L, TSLuaTree *ud, TSNode node)
+{
+  if (ts_node_is_null(node)) {
+    lua_pushnil(L);
+    return;
+  }
+  bool new_item = false;
+  uint64_t *index = map_put_ref(uint64_t, uint64_t)(&ud->handle_ids,
+                                                     (uint64_t)(uintptr_t)node.id, NULL,
+                                                     &new_item);
+  if (new_item) {
+    *index = kv_size(ud->handles);
+    kv_push(ud->handles, node);
+  }
+  lua_pushnumber(L, (lua_Number)(((uint64_t)ud->generation << HANDLE_INDEX_BITS) | *index));
+}
+
+/// Gets the node of the handle at index 2, the tree being at index 1.
+static TSLuaTree *handle_check(lua_State *L, TSNode *node)
+{
+  TSLuaTree *ud = tree_check(L, 1);
+  uint64_t handle = (uint64_t)luaL_checknumber(L, 2);
+  uint64_t index = handle & ((UINT64_C(1) << HANDLE_INDEX_BITS) - 1);
+  if ((handle >> HANDLE_INDEX_BITS) != ud->generation || index >= kv_size(ud->handles)) {
+    luaL_argerror(L, 2, "invalid node handle");
+  }
+  *node = kv_A(ud->handles, index);
+  return ud;
+}
+
+static void handles_clear(TSLuaTree *ud)
+{
+  kv_size(ud->handles) = 0;
+  map_clear(uint64_t, &ud->handle_ids);
+  ud->generation = (ud->generation + 1) & HANDLE_GENERATION_MASK;
+}
+
+static int tree_root_handle(lua_State *L)
+{
+  TSLuaTree *ud = tree_check(L, 1);
+  push_handle(L, ud, ts_tree_root_node(ud->tree));
+  return 1;
+}
+
+static int tree_to_handle(lua_State *L)
+{
+  TSLuaTree *ud = tree_check(L, 1);
+  TSNode node;
+  node_check(L, 2, &node);
+  if (node.tree != ud->tree) {
+    return luaL_argerror(L, 2, "node of another tree");
+  }
+  push_handle(L, ud, node);
+  return 1;
+}
+
+static int tree_from_handle(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  push_node(L, node, 1);
+  return 1;
+}
+
+static int handle_type(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  lua_pushstring(L, ts_node_type(node));
+  return 1;
+}
+
+static int handle_symbol(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  lua_pushinteger(L, ts_node_symbol(node));
+  return 1;
+}
+
+static int handle_named(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  lua_pushboolean(L, ts_node_is_named(node));
+  return 1;
+}
+
+/// tree:handle_range(handle): same as TSNode:range()
+static int handle_range(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  TSPoint start = ts_node_start_point(node);
+  TSPoint end = ts_node_end_point(node);
+  lua_pushinteger(L, start.row);
+  lua_pushinteger(L, start.column);
+  lua_pushinteger(L, end.row);
+  lua_pushinteger(L, end.column);
+  return 4;
+}
+
+static int handle_child_count(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  lua_pushinteger(L, ts_node_child_count(node));
+  return 1;
+}
+
+static int handle_named_child_count(lua_State *L)
+{
+  TSNode node;
+  handle_check(L, &node);
+  lua_pushinteger(L, ts_node_named_child_count(node));
+  return 1;
+}
+
+static int handle_child(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  uint32_t num = (uint32_t)luaL_checkinteger(L, 3);
+  push_handle(L, ud, ts_node_child(node, num));
+  return 1;
+}
+
+static int handle_named_child(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  uint32_t num = (uint32_t)luaL_checkinteger(L, 3);
+  push_handle(L, ud, ts_node_named_child(node, num));
+  return 1;
+}
+
+static int handle_parent(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  push_handle(L, ud, ts_node_parent(node));
+  return 1;
+}
+
+static int handle_next_sibling(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  push_handle(L, ud, ts_node_next_sibling(node));
+  return 1;
+}
+
+static int handle_prev_sibling(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  push_handle(L, ud, ts_node_prev_sibling(node));
+  return 1;
+}
+
+static int handle_next_named_sibling(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  push_handle(L, ud, ts_node_next_named_sibling(node));
+  return 1;
+}
+
+static int handle_prev_named_sibling(lua_State *L)
+{
+  TSNode node;
+  TSLuaTree *ud = handle_check(L, &node);
+  push_handle(L, ud, ts_node_prev_named_sibling(node));
+  return 1;
+}
+
 // Node methods
 
 /// Push node interface on to the Lua stack
@@ -1510,6 +2128,278 @@ static int node_rawquery(lua_State *L)
   return 1;
 }
 
+/// Text a predicate of node:_rawquery_captures() is checked against.
+typedef struct {
+  buf_T *buf;  ///< The buffer, or NULL for a string.
+  const char *str;
+  size_t len;
+} TSLuaSource;
+
+/// Compiled "match?" patterns, never freed, like the cache in query.lua.
+static PMap(cstr_t) match_regexes = MAP_INIT;
+
+/// Puts the text of `node` in `ga`, as get_node_text() returns it.
+static void node_text(const TSLuaSource *src, TSNode node, garray_T *ga)
+{
+  ga->ga_len = 0;
+  if (!src->buf) {
+    size_t start = MIN(ts_node_start_byte(node), src->len);
+    size_t end = MIN(ts_node_end_byte(node), src->len);
+    ga_concat_len(ga, src->str + start, end - start);
+  } else {
+    TSPoint start = ts_node_start_point(node);
+    TSPoint end = ts_node_end_point(node);
+    bool to_eol = false;
+    if (end.column == 0 && end.row > start.row) {
+      // The final newline is not part of the text.
+      end.row--;
+      to_eol = true;
+    }
+    for (uint32_t row = start.row; row <= end.row; row++) {
+      if ((linenr_T)row >= src->buf->b_ml.ml_line_count) {
+        break;
+      }
+      char *line = ml_get_buf(src->buf, (linenr_T)row + 1);
+      size_t len = strlen(line);
+      size_t from = MIN(row == start.row ? start.column : 0, len);
+      size_t to = row == end.row && !to_eol ? MIN(end.column, len) : len;
+      if (row > start.row) {
+        ga_append(ga, '\n');
+      }
+      if (to > from) {
+        ga_concat_len(ga, line + from, to - from);
+      }
+    }
+  }
+  ga_append(ga, NUL);
+  ga->ga_len--;
+}
+
+/// The node of capture `id` in `match`, like match[id] in Lua: the last one
+/// for a quantified capture.
+static const TSNode *match_capture(const TSQueryMatch *match, uint32_t id)
+{
+  const TSNode *node = NULL;
+  for (uint16_t i = 0; i < match->capture_count; i++) {
+    if (match->captures[i].index == id) {
+      node = &match->captures[i].node;
+    }
+  }
+  return node;
+}
+
+static bool text_equal(const garray_T *ga, const char *str, size_t len)
+{
+  return (size_t)ga->ga_len == len && memcmp(ga->ga_data, str, len) == 0;
+}
+
+/// @param pat  NUL-terminated, as all strings of a TSQuery are.
+static bool text_regex_match(const garray_T *ga, const char *pat, size_t len)
+{
+  const char **key_alloc = NULL;
+  bool new_item = false;
+  void **ref = pmap_put_ref(cstr_t)(&match_regexes, pat, &key_alloc, &new_item);
+  if (new_item) {
+    *key_alloc = xstrdup(pat);
+    // Same as check_magic() in query.lua
+    bool magic = len >= 2 && pat[0] == '\\' && strchr("vmMV", pat[1]) != NULL;
+    char *re = magic || len < 2 ? xstrdup(pat) : concat_str("\\v", pat);
+    *ref = vim_regcomp(re, RE_AUTO | RE_MAGIC | RE_STRICT);
+    xfree(re);
+  }
+  if (*ref == NULL) {
+    return false;
+  }
+
+  regmatch_T rm = { .regprog = *ref, .rm_ic = false };
+  bool matched = vim_regexec(&rm, ga->ga_data != NULL ? ga->ga_data : "", 0);
+  *ref = rm.regprog;
+  return matched;
+}
+
+/// Checks one predicate, steps[0] being its name. Only the predicates listed
+/// in query.lua as evaluated in C reach this.
+static bool match_predicate(TSQuery *query, const TSQueryMatch *match,
+                            const TSQueryPredicateStep *steps, uint32_t n_steps,
+                            const TSLuaSource *src, garray_T *text, garray_T *other)
+{
+  uint32_t len;
+  const char *name = ts_query_string_value_for_id(query, steps[0].value_id, &len);
+  bool is_not = len > 4 && strncmp(name, "not-", 4) == 0;
+  if (is_not) {
+    name += 4;
+  }
+
+  if (n_steps < 2 || steps[1].type != TSQueryPredicateStepTypeCapture) {
+    return !is_not;
+  }
+  const TSNode *node = match_capture(match, steps[1].value_id);
+  if (node == NULL) {
+    return !is_not;
+  }
+  node_text(src, *node, text);
+
+  bool matched = false;
+  if (strequal(name, "eq?")) {
+    if (n_steps >= 3 && steps[2].type == TSQueryPredicateStepTypeString) {
+      const char *str = ts_query_string_value_for_id(query, steps[2].value_id, &len);
+      matched = text_equal(text, str, len);
+    } else if (n_steps >= 3) {
+      const TSNode *node2 = match_capture(match, steps[2].value_id);
+      if (node2 != NULL) {
+        node_text(src, *node2, other);
+        matched = text_equal(text, other->ga_data, (size_t)other->ga_len);
+      }
+    }
+  } else if (strequal(name, "match?") || strequal(name, "vim-match?")) {
+    if (n_steps >= 3 && steps[2].type == TSQueryPredicateStepTypeString) {
+      const char *pat = ts_query_string_value_for_id(query, steps[2].value_id, &len);
+      matched = text_regex_match(text, pat, len);
+    }
+  } else if (strequal(name, "any-of?")) {
+    for (uint32_t i = 2; i < n_steps && !matched; i++) {
+      const char *str = ts_query_string_value_for_id(query, steps[i].value_id, &len);
+      matched = text_equal(text, str, len);
+    }
+  } else {
+    matched = true;
+  }
+  return matched != is_not;
+}
+
+static bool match_predicates(TSQuery *query, const TSQueryMatch *match, const TSLuaSource *src,
+                             garray_T *text, garray_T *other)
+{
+  uint32_t n_steps;
+  const TSQueryPredicateStep *steps
+    = ts_query_predicates_for_pattern(query, match->pattern_index, &n_steps);
+  uint32_t start = 0;
+  for (uint32_t i = 0; i < n_steps; i++) {
+    if (steps[i].type == TSQueryPredicateStepTypeDone) {
+      if (!match_predicate(query, match, steps + start, i - start, src, text, other)) {
+        return false;
+      }
+      start = i + 1;
+    }
+  }
+  return true;
+}
+
+/// node:_rawquery_captures(query, source, start, stop, lua_patterns)
+///
+/// Runs `query` on the rows `start` to `stop` (end-exclusive) at once. Returns
+/// a flat list with six integers for each capture:
+///   capture id, start row, start col, end row, end col, pattern id
+/// (ids are 1-based), and a table of the matches left to Lua.
+///
+/// The predicates of patterns not in `lua_patterns` are checked here, these
+/// captures come with their range only. For a pattern in `lua_patterns` the
+/// second table maps the position of each capture in the list to a match
+/// table, as query_next_match() makes, shared by the captures of a match.
+static int node_rawquery_captures(lua_State *L)
+{
+  TSNode node;
+  if (!node_check(L, 1, &node)) {
+    return 0;
+  }
+  TSQuery *query = query_check(L, 2);
+
+  TSLuaSource src = { 0 };
+  if (lua_type(L, 3) == LUA_TSTRING) {
+    src.str = lua_tolstring(L, 3, &src.len);
+  } else {
+    handle_T bufnr = (handle_T)luaL_checkinteger(L, 3);
+    src.buf = handle_get_buffer(bufnr);
+    if (!src.buf) {
+      return luaL_argerror(L, 3, "invalid buffer handle");
+    }
+  }
+  uint32_t start = (uint32_t)luaL_checkinteger(L, 4);
+  uint32_t end = (uint32_t)luaL_checkinteger(L, 5);
+  bool lua_patterns = lua_istable(L, 6);
+
+  TSQueryCursor *cursor;
+  if (kv_size(cursors) > 0) {
+    cursor = kv_pop(cursors);
+  } else {
+    cursor = ts_query_cursor_new();
+  }
+#ifdef NVIM_TS_HAS_SET_MAX_START_DEPTH
+  ts_query_cursor_set_max_start_depth(cursor, UINT32_MAX);
+#endif
+  ts_query_cursor_set_match_limit(cursor, 256);
+  ts_query_cursor_exec(cursor, query, node);
+  ts_query_cursor_set_point_range(cursor, (TSPoint){ start, 0 }, (TSPoint){ end, 0 });
+
+  lua_newtable(L);  // [ranges]
+  int ranges = lua_gettop(L);
+  lua_newtable(L);  // [ranges, matches]
+  lua_newtable(L);  // [ranges, matches, seen]
+  // seen[match id] is true for a match that passed its predicates, or the
+  // match table of a pattern left to Lua.
+  int seen = ranges + 2;
+
+  garray_T text = GA_INIT(1, 80);
+  garray_T other = GA_INIT(1, 80);
+  int n = 0;
+  int k = 0;
+  TSQueryMatch match;
+  uint32_t capture_index;
+  while (ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+    bool in_lua = false;
+    if (lua_patterns) {
+      lua_rawgeti(L, 6, (int)match.pattern_index + 1);
+      in_lua = lua_toboolean(L, -1);
+      lua_pop(L, 1);
+    }
+
+    uint32_t n_pred = 0;
+    ts_query_predicates_for_pattern(query, match.pattern_index, &n_pred);
+    if (n_pred > 0 || in_lua) {
+      lua_rawgeti(L, seen, (int)match.id);  // [..., seen_match]
+      if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        if (in_lua) {
+          lua_createtable(L, (int)ts_query_capture_count(query), 1);  // [..., match]
+          set_match(L, &match, 1);
+          lua_pushinteger(L, match.pattern_index + 1);
+          lua_setfield(L, -2, "pattern");
+        } else if (match_predicates(query, &match, &src, &text, &other)) {
+          lua_pushboolean(L, true);  // [..., true]
+        } else {
+          ts_query_cursor_remove_match(cursor, match.id);
+          continue;
+        }
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, seen, (int)match.id);
+      }
+    }
+
+    TSQueryCapture capture = match.captures[capture_index];
+    TSPoint s = ts_node_start_point(capture.node);
+    TSPoint e = ts_node_end_point(capture.node);
+    k++;
+    lua_Integer values[] = { capture.index + 1, s.row, s.column, e.row, e.column,
+                             match.pattern_index + 1 };
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+      lua_pushinteger(L, values[i]);
+      lua_rawseti(L, ranges, ++n);
+    }
+
+    if (in_lua) {
+      lua_rawseti(L, ranges + 1, k);  // [ranges, matches, seen]
+    } else if (n_pred > 0) {
+      lua_pop(L, 1);
+    }
+  }
+
+  ga_clear(&text);
+  ga_clear(&other);
+  kv_push(cursors, cursor);
+  lua_pop(L, 1);  // [ranges, matches]
+  return 2;
+}
+
 static int querycursor_gc(lua_State *L)
 {
   TSLua_cursor *ud = luaL_checkudata(L, 1, TS_META_QUERYCURSOR);
@@ -0,0 +1,252 @@
+// Long-lived Lua states running on threads of their own, see |vim.worker()|.
+//
+// A worker has a queue of messages from the main thread. Its thread takes
+// them one at a time, and sends the results back as events on the main loop.
+// Messages are plain strings here, runtime/lua/vim/_worker.lua encodes them
+// with msgpack on both sides.
+
+#include <lauxlib.h>
+#include <lua.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <uv.h>
+
+#include "klib/kvec.h"
+#include "nvim/api/private/helpers.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/loop.h"
+#include "nvim/gettext.h"
+#include "nvim/lua/executor.h"
+#include "nvim/lua/worker.h"
+#include "nvim/main.h"
+#include "nvim/memory.h"
+#include "nvim/message.h"
+
+typedef struct {
+  uv_thread_t thread;
+  uv_mutex_t mutex;
+  uv_cond_t cond;
+  kvec_t(String) inbox;  ///< messages not yet taken by the thread
+  size_t inbox_head;     ///< index of the oldest message in "inbox"
+  bool closing;          ///< no more messages, stop when "inbox" is empty
+  String code;           ///< dumped handler function
+  LuaRef on_message;     ///< main thread callback, LUA_NOREF after the thread exited
+  int refcount;          ///< userdata and thread, only used on the main thread
+} Worker;
+
+#define WORKER_META "nvim_worker"
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "lua/worker.c.generated.h"
+#endif
+
+static void worker_unref(Worker *w)
+{
+  if (--w->refcount > 0) {
+    return;
+  }
+  for (size_t i = w->inbox_head; i < kv_size(w->inbox); i++) {
+    api_free_string(kv_A(w->inbox, i));
+  }
+  kv_destroy(w->inbox);
+  api_free_string(w->code);
+  uv_cond_destroy(&w->cond);
+  uv_mutex_destroy(&w->mutex);
+  xfree(w);
+}
+
+/// Stop taking messages. Those already sent are still handled, and their
+/// results passed to "on_message" until worker_exit_event().
+static void worker_close(Worker *w)
+{
+  uv_mutex_lock(&w->mutex);
+  w->closing = true;
+  uv_cond_signal(&w->cond);
+  uv_mutex_unlock(&w->mutex);
+}
+
+// Main thread side
+
+/// Event with a message from the worker thread.
+static void worker_message_event(void **argv)
+{
+  Worker *w = argv[0];
+  char *data = argv[1];
+  size_t len = (size_t)(intptr_t)argv[2];
+  if (w->on_message != LUA_NOREF) {
+    lua_State *const lstate = get_global_lstate();
+    nlua_pushref(lstate, w->on_message);
+    lua_pushlstring(lstate, data, len);
+    if (nlua_pcall(lstate, 1, 0)) {
+      nlua_error(lstate, _("Error executing vim.worker callback: %.*s"));
+    }
+  }
+  xfree(data);
+}
+
+/// Event sent last by the worker thread, after its state has been closed.
+static void worker_exit_event(void **argv)
+{
+  Worker *w = argv[0];
+  uv_thread_join(&w->thread);
+  // The messages of the thread were queued before this event.
+  NLUA_CLEAR_REF(w->on_message);
+  worker_unref(w);
+}
+
+/// vim._worker_start(code, on_message): start a worker running the dumped
+/// function "code" for each message, "on_message" gets what it sends back.
+int nlua_worker_start(lua_State *lstate)
+{
+  size_t len;
+  const char *code = luaL_checklstring(lstate, 1, &len);
+  luaL_checktype(lstate, 2, LUA_TFUNCTION);
+
+  Worker *w = xcalloc(1, sizeof(*w));
+  w->code = cbuf_to_string(code, len);
+  w->on_message = nlua_ref_global(lstate, 2);
+  w->refcount = 2;
+  uv_mutex_init(&w->mutex);
+  uv_cond_init(&w->cond);
+  if (uv_thread_create(&w->thread, worker_thread, w) != 0) {
+    NLUA_CLEAR_REF(w->on_message);
+    w->refcount = 1;
+    worker_unref(w);
+    return luaL_error(lstate, "vim.worker: failed to create thread");
+  }
+
+  Worker **ud = lua_newuserdata(lstate, sizeof(*ud));
+  *ud = w;
+  if (luaL_newmetatable(lstate, WORKER_META)) {
+    lua_pushcfunction(lstate, worker_gc);
+    lua_setfield(lstate, -2, "__gc");
+    lua_newtable(lstate);
+    lua_pushcfunction(lstate, worker_send);
+    lua_setfield(lstate, -2, "send");
+    lua_pushcfunction(lstate, worker_lua_close);
+    lua_setfield(lstate, -2, "close");
+    lua_setfield(lstate, -2, "__index");
+  }
+  lua_setmetatable(lstate, -2);
+  return 1;
+}
+
+static Worker *worker_check(lua_State *lstate)
+{
+  Worker **ud = luaL_checkudata(lstate, 1, WORKER_META);
+  return *ud;
+}
+
+static int worker_send(lua_State *lstate)
+{
+  Worker *w = worker_check(lstate);
+  size_t len;
+  const char *data = luaL_checklstring(lstate, 2, &len);
+  uv_mutex_lock(&w->mutex);
+  bool closing = w->closing;
+  if (!closing) {
+    kv_push(w->inbox, cbuf_to_string(data, len));
+    uv_cond_signal(&w->cond);
+  }
+  uv_mutex_unlock(&w->mutex);
+  if (closing) {
+    return luaL_error(lstate, "vim.worker: worker is closed");
+  }
+  return 0;
+}
+
+static int worker_lua_close(lua_State *lstate)
+{
+  worker_close(worker_check(lstate));
+  return 0;
+}
+
+static int worker_gc(lua_State *lstate)
+{
+  Worker *w = worker_check(lstate);
+  worker_close(w);
+  worker_unref(w);
+  return 0;
+}
+
+// Worker thread side
+
+/// vim._worker_recv(): wait for the next message, nil when the worker is
+/// closed.
+static int worker_recv(lua_State *lstate)
+{
+  Worker *w = lua_touserdata(lstate, lua_upvalueindex(1));
+  uv_mutex_lock(&w->mutex);
+  while (w->inbox_head == kv_size(w->inbox) && !w->closing) {
+    uv_cond_wait(&w->cond, &w->mutex);
+  }
+  if (w->inbox_head == kv_size(w->inbox)) {
+    uv_mutex_unlock(&w->mutex);
+    return 0;
+  }
+  String msg = kv_A(w->inbox, w->inbox_head);
+  if (++w->inbox_head == kv_size(w->inbox)) {
+    kv_size(w->inbox) = 0;
+    w->inbox_head = 0;
+  }
+  uv_mutex_unlock(&w->mutex);
+
+  lua_pushlstring(lstate, msg.data, msg.size);
+  api_free_string(msg);
+  return 1;
+}
+
+/// vim._worker_post(data): send a message to the main thread.
+static int worker_post(lua_State *lstate)
+{
+  Worker *w = lua_touserdata(lstate, lua_upvalueindex(1));
+  size_t len;
+  const char *data = luaL_checklstring(lstate, 1, &len);
+  loop_schedule_deferred(&main_loop, event_create(worker_message_event, w,
+                                                  xmemdupz(data, len), (void *)(intptr_t)len));
+  return 0;
+}
+
+static void worker_thread(void *arg)
+{
+  Worker *w = arg;
+  lua_State *lstate = nlua_thread_state_new();
+
+  lua_getglobal(lstate, "vim");
+  lua_pushlightuserdata(lstate, w);
+  lua_pushcclosure(lstate, worker_recv, 1);
+  lua_setfield(lstate, -2, "_worker_recv");
+  lua_pushlightuserdata(lstate, w);
+  lua_pushcclosure(lstate, worker_post, 1);
+  lua_setfield(lstate, -2, "_worker_post");
+  lua_pop(lstate, 1);
+
+  // require('vim._worker')._serve(code)
+  lua_getglobal(lstate, "require");
+  lua_pushliteral(lstate, "vim._worker");
+  int status = lua_pcall(lstate, 1, 1, 0);
+  if (status == 0) {
+    lua_getfield(lstate, -1, "_serve");
+    lua_pushlstring(lstate, w->code.data, w->code.size);
+    status = lua_pcall(lstate, 1, 0, 0);
+  }
+  if (status) {
+    // Only when the handler could not be started, errors of the handler
+    // itself are sent back as messages.
+    const char *err = lua_tostring(lstate, -1);
+    loop_schedule_deferred(&main_loop,
+                           event_create(worker_error_event, xstrdup(err ? err : "(error object)")));
+  }
+
+  nlua_thread_state_free(lstate);
+  loop_schedule_deferred(&main_loop, event_create(worker_exit_event, w));
+}
+
+static void worker_error_event(void **argv)
+{
+  char *err = argv[0];
+  msg_ext_set_kind("lua_error");
+  semsg_multiline("Error in vim.worker:\n%s", err);
+  xfree(err);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <lua.h>  // IWYU pragma: keep
+
+#ifdef INCLUDE_GENERATED_DECLARATIONS
+# include "lua/worker.h.generated.h"
+#endif
@@ -3,15 +3,22 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <uv.h>
 
+#include "klib/kvec.h"
 #include "luaconf.h"
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
+#include "nvim/event/multiqueue.h"
+#include "nvim/garray.h"
+#include "nvim/gettext.h"
 #include "nvim/linematch.h"
 #include "nvim/lua/converter.h"
 #include "nvim/lua/executor.h"
 #include "nvim/lua/xdiff.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
+#include "nvim/map_defs.h"
 #include "nvim/memory.h"
 #include "nvim/pos_defs.h"
 #include "xdiff/xdiff.h"
@@ -26,7 +33,14 @@ typedef enum {
 } NluaXdiffMode;
 
 typedef struct {
-  lua_State *lstate;
+  long start_a, count_a, start_b, count_b;
+} DiffHunk;
+
+typedef kvec_t(DiffHunk) DiffHunks;
+
+typedef struct {
+  lua_State *lstate;  ///< NULL when the hunks go to "hunks"
+  DiffHunks *hunks;
   Error *err;
   mmfile_t *ma;
   mmfile_t *mb;
@@ -34,6 +48,23 @@ typedef struct {
   bool iwhite;
 } hunkpriv_t;
 
+/// A diff run by vim.diff_async() on a libuv worker thread.
+typedef struct {
+  mmfile_t ma, mb;  ///< Copies of the inputs
+  xpparam_t params;
+  xdemitconf_t cfg;
+  int64_t linematch;
+  NluaXdiffMode mode;
+  garray_T unified;  ///< Output for kNluaXdiffModeUnified
+  DiffHunks hunks;  ///< Output for kNluaXdiffModeLocations
+  bool failed;
+  LuaRef cb;
+  uv_work_t req;
+} XdiffAsyncJob;
+
+/// Jobs that are done and wait in `main_loop.events` for the callback.
+static Set(ptr_t) xdiff_async_queued = SET_INIT;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "lua/xdiff.c.generated.h"
 #endif
@@ -61,7 +92,18 @@ static void lua_pushhunk(lua_State *lstate, long start_a, long count_a, long sta
   lua_rawseti(lstate, -2, (signed)lua_objlen(lstate, -2) + 1);
 }
 
-static void get_linematch_results(lua_State *lstate, mmfile_t *ma, mmfile_t *mb, int start_a,
+/// Adds a hunk to the Lua table on top of the stack of "priv->lstate", or to
+/// "priv->hunks" when there is no Lua state (on a worker thread).
+static void emit_hunk(hunkpriv_t *priv, long start_a, long count_a, long start_b, long count_b)
+{
+  if (priv->lstate != NULL) {
+    lua_pushhunk(priv->lstate, start_a, count_a, start_b, count_b);
+  } else {
+    kv_push(*priv->hunks, ((DiffHunk){ start_a, count_a, start_b, count_b }));
+  }
+}
+
+static void get_linematch_results(hunkpriv_t *priv, mmfile_t *ma, mmfile_t *mb, int start_a,
                                   int count_a, int start_b, int count_b, bool iwhite)
 {
   // get the pointer to char of the start of the diff to pass it to linematch algorithm
@@ -83,7 +125,7 @@ static void get_linematch_results(lua_State *lstate, mmfile_t *ma, mmfile_t *mb,
   int hunkcountb = 0;
   for (size_t i = 0; i < decisions_length; i++) {
     if (i && (decisions[i - 1] != decisions[i])) {
-      lua_pushhunk(lstate, hunkstarta, hunkcounta, hunkstartb, hunkcountb);
+      emit_hunk(priv, hunkstarta, hunkcounta, hunkstartb, hunkcountb);
 
       hunkstarta = lnuma;
       hunkstartb = lnumb;
@@ -100,7 +142,7 @@ static void get_linematch_results(lua_State *lstate, mmfile_t *ma, mmfile_t *mb,
       hunkcountb++;
     }
   }
-  lua_pushhunk(lstate, hunkstarta, hunkcounta, hunkstartb, hunkcountb);
+  emit_hunk(priv, hunkstarta, hunkcounta, hunkstartb, hunkcountb);
   xfree(decisions);
 }
 
@@ -122,16 +164,24 @@ static int write_string(void *priv, mmbuffer_t *mb, int nbuf)
   return 0;
 }
 
+static int write_garray(void *priv, mmbuffer_t *mb, int nbuf)
+{
+  garray_T *ga = (garray_T *)priv;
+  for (int i = 0; i < nbuf; i++) {
+    ga_concat_len(ga, mb[i].ptr, (size_t)mb[i].size);
+  }
+  return 0;
+}
+
 // hunk_func callback used when opts.hunk_lines = true
 static int hunk_locations_cb(int start_a, int count_a, int start_b, int count_b, void *cb_data)
 {
   hunkpriv_t *priv = (hunkpriv_t *)cb_data;
-  lua_State *lstate = priv->lstate;
   if (priv->linematch > 0 && count_a + count_b <= priv->linematch) {
-    get_linematch_results(lstate, priv->ma, priv->mb, start_a, count_a, start_b, count_b,
+    get_linematch_results(priv, priv->ma, priv->mb, start_a, count_a, start_b, count_b,
                           priv->iwhite);
   } else {
-    lua_pushhunk(lstate, start_a, count_a, start_b, count_b);
+    emit_hunk(priv, start_a, count_a, start_b, count_b);
   }
 
   return 0;
@@ -209,7 +259,7 @@ static bool check_xdiff_opt(ObjectType actType, ObjectType expType, const char *
 static NluaXdiffMode process_xdl_diff_opts(lua_State *lstate, xdemitconf_t *cfg, xpparam_t *params,
                                            int64_t *linematch, Error *err)
 {
-  const DictionaryOf(LuaRef) opts = nlua_pop_Dictionary(lstate, true, err);
+  const DictionaryOf(LuaRef) opts = nlua_pop_Dictionary(lstate, true, NULL, err);
 
   NluaXdiffMode mode = kNluaXdiffModeUnified;
 
@@ -405,3 +455,150 @@ exit_0:
   }
   return 0;
 }
+
+/// Runs on a libuv worker thread: only touches the job.
+static void xdiff_async_work(uv_work_t *req)
+{
+  XdiffAsyncJob *job = req->data;
+  xdemitcb_t ecb;
+  CLEAR_FIELD(ecb);
+  hunkpriv_t priv;
+  if (job->mode == kNluaXdiffModeUnified) {
+    ecb.priv = &job->unified;
+    ecb.out_line = write_garray;
+  } else {
+    job->cfg.hunk_func = hunk_locations_cb;
+    priv = (hunkpriv_t) {
+      .hunks = &job->hunks,
+      .ma = &job->ma,
+      .mb = &job->mb,
+      .linematch = job->linematch,
+      .iwhite = (job->params.flags & XDF_IGNORE_WHITESPACE) > 0
+    };
+    ecb.priv = &priv;
+  }
+  job->failed = xdl_diff(&job->ma, &job->mb, &job->params, &job->cfg, &ecb) == -1;
+}
+
+static void xdiff_async_free(XdiffAsyncJob *job)
+{
+  xfree(job->ma.ptr);
+  xfree(job->mb.ptr);
+  ga_clear(&job->unified);
+  kv_destroy(job->hunks);
+  xfree(job);
+}
+
+/// Back on the main thread. Like parser:parse_async(), the callback is
+/// deferred to `main_loop.events` instead of being called from uv_run().
+static void xdiff_async_done(uv_work_t *req, int status)
+{
+  XdiffAsyncJob *job = req->data;
+  if (main_loop.closing) {
+    nlua_unref_global(get_global_lstate(), job->cb);
+    xdiff_async_free(job);
+    return;
+  }
+  set_put(ptr_t, &xdiff_async_queued, job);
+  multiqueue_put(main_loop.events, xdiff_async_event, job);
+}
+
+static void xdiff_async_event(void **argv)
+{
+  XdiffAsyncJob *job = argv[0];
+  set_del(ptr_t, &xdiff_async_queued, job);
+  lua_State *const lstate = get_global_lstate();
+
+  nlua_pushref(lstate, job->cb);
+  nlua_unref_global(lstate, job->cb);
+  int nargs = 1;
+  if (job->failed) {
+    lua_pushstring(lstate, "Error while performing diff operation");
+  } else {
+    lua_pushnil(lstate);
+    if (job->mode == kNluaXdiffModeUnified) {
+      lua_pushlstring(lstate, job->unified.ga_data ? job->unified.ga_data : "",
+                      (size_t)job->unified.ga_len);
+    } else {
+      lua_createtable(lstate, (int)kv_size(job->hunks), 0);
+      for (size_t i = 0; i < kv_size(job->hunks); i++) {
+        DiffHunk h = kv_A(job->hunks, i);
+        lua_pushhunk(lstate, h.start_a, h.count_a, h.start_b, h.count_b);
+      }
+    }
+    nargs = 2;
+  }
+  xdiff_async_free(job);
+
+  if (nlua_pcall(lstate, nargs, 0)) {
+    nlua_error(lstate, _("Error executing vim.diff_async callback: %.*s"));
+  }
+}
+
+/// vim.diff_async(a, b, opts, callback)
+///
+/// Like vim.diff(), but the inputs are copied and diffed on a worker thread.
+/// `callback(err, result)` is called from the main loop. "on_hunk" is not
+/// supported.
+int nlua_xdl_diff_async(lua_State *lstate)
+{
+  if (lua_gettop(lstate) != 4) {
+    return luaL_error(lstate, "Expected 4 arguments");
+  }
+  mmfile_t ma = get_string_arg(lstate, 1);
+  mmfile_t mb = get_string_arg(lstate, 2);
+  if (!lua_isfunction(lstate, 4)) {
+    return luaL_argerror(lstate, 4, "function expected");
+  }
+
+  XdiffAsyncJob *job = xcalloc(1, sizeof(*job));
+  ga_init(&job->unified, 1, 4096);
+  job->mode = kNluaXdiffModeUnified;
+
+  if (!lua_isnil(lstate, 3)) {
+    if (lua_type(lstate, 3) != LUA_TTABLE) {
+      xfree(job);
+      return luaL_argerror(lstate, 3, "expected table");
+    }
+    Error err = ERROR_INIT;
+    lua_pushvalue(lstate, 3);
+    job->mode = process_xdl_diff_opts(lstate, &job->cfg, &job->params, &job->linematch, &err);
+    if (!ERROR_SET(&err) && job->mode == kNluaXdiffModeOnHunkCB) {
+      api_set_error(&err, kErrorTypeValidation, "on_hunk is not supported");
+    }
+    if (ERROR_SET(&err)) {
+      xfree(job);
+      luaL_where(lstate, 1);
+      lua_pushstring(lstate, err.msg);
+      api_clear_error(&err);
+      lua_concat(lstate, 2);
+      return lua_error(lstate);
+    }
+  }
+
+  job->ma = (mmfile_t){ .ptr = xmemdup(ma.ptr, (size_t)ma.size), .size = ma.size };
+  job->mb = (mmfile_t){ .ptr = xmemdup(mb.ptr, (size_t)mb.size), .size = mb.size };
+  job->cb = nlua_ref_global(lstate, 4);
+  job->req.data = job;
+
+  if (uv_queue_work(&main_loop.uv, &job->req, xdiff_async_work, xdiff_async_done) != 0) {
+    nlua_unref_global(lstate, job->cb);
+    xdiff_async_free(job);
+    return luaL_error(lstate, "Failed to start the diff");
+  }
+  return 0;
+}
+
+#ifdef EXITFREE
+/// Free the jobs whose callback was not called, because the main loop was
+/// closed with them still in `main_loop.events`.
+void nlua_xdiff_free_all_mem(void)
+{
+  ptr_t job;
+  set_foreach(&xdiff_async_queued, job, {
+    nlua_unref_global(get_global_lstate(), ((XdiffAsyncJob *)job)->cb);
+    xdiff_async_free(job);
+  });
+  set_destroy(ptr_t, &xdiff_async_queued);
+}
+#endif
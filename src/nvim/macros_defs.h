@@ -210,3 +210,10 @@
 #endif
 
 #define EMPTY_POS(a) ((a).lnum == 0 && (a).col == 0 && (a).coladd == 0)
+
+/// Storage class for a variable that each thread has its own copy of.
+#ifdef _MSC_VER
+# define THREAD_LOCAL __declspec(thread)
+#else
+# define THREAD_LOCAL __thread
+#endif
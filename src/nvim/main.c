@@ -94,6 +94,7 @@
 #include "nvim/ui.h"
 #include "nvim/ui_client.h"
 #include "nvim/ui_compositor.h"
+#include "nvim/undo.h"
 #include "nvim/version.h"
 #include "nvim/vim_defs.h"
 #include "nvim/window.h"
@@ -146,6 +147,7 @@ void event_init(void)
   // finish mspgack-rpc initialization
   channel_init();
   terminal_init();
+  syntax_init();
   ui_init();
   TIME_MSG("event init");
 }
@@ -167,6 +169,7 @@ bool event_teardown(void)
   server_teardown();
   signal_teardown();
   terminal_teardown();
+  syntax_teardown();
 
   return loop_close(&main_loop, true);
 }
@@ -235,6 +238,10 @@ int wmain(int argc, wchar_t **argv_w)  // multibyte args on Windows. #7060
 int main(int argc, char **argv)
 #endif
 {
+#ifdef SLAB_ALLOC
+  slab_init();
+#endif
+
 #if defined(MSWIN) && !defined(MAKE_LIB)
   char **argv = xmalloc((size_t)argc * sizeof(char *));
   for (int i = 0; i < argc; i++) {
@@ -420,6 +427,10 @@ int main(int argc, char **argv)
 
   bool vimrc_none = strequal(params.use_vimrc, "NONE");
 
+  if (!vimrc_none && !params.clean) {
+    runtime_index_read();
+  }
+
   // Reset 'loadplugins' for "-u NONE" before "--cmd" arguments.
   // Allows for setting 'loadplugins' there.
   // For --clean we still want to load plugins.
@@ -478,7 +489,7 @@ int main(int argc, char **argv)
   // Read in registers, history etc, from the ShaDa file.
   // This is where v:oldfiles gets filled.
   if (*p_shada != NUL) {
-    shada_read_everything(NULL, false, true);
+    shada_read_startup();
     TIME_MSG("reading ShaDa");
   }
   // It's better to make v:oldfiles an empty list than NULL.
@@ -667,6 +678,7 @@ void os_exit(int r)
   }
 
   ILOG("Nvim exit: %d", r);
+  log_async_stop();
 
 #ifdef EXITFREE
   free_all_mem();
@@ -755,6 +767,14 @@ void getout(int exitval)
     shada_write_file(NULL, false);
   }
 
+  // Finish writing undo files in the background.
+  u_write_undo_wait();
+
+  runtime_index_write();
+
+  // Exiting before the first screen update (e.g. "--headless +q").
+  time_finish();
+
   if (v_dying <= 1) {
     int unblock = 0;
 
@@ -770,6 +790,7 @@ void getout(int exitval)
   }
 
   profile_dump();
+  profile_sample_stop();
 
   if (did_emsg) {
     // give the user a chance to read the (error) message
@@ -838,7 +859,7 @@ void preserve_exit(const char *errmsg)
       if (errmsg != NULL) {
         os_errmsg("Vim: preserving files...\r\n");
       }
-      ml_sync_all(false, false, true);  // preserve all swap files
+      ml_sync_all(false, false, true, false);  // preserve all swap files
       break;
     }
   }
@@ -1489,8 +1510,12 @@ static void init_startuptime(mparm_T *paramp)
 {
   for (int i = 1; i < paramp->argc - 1; i++) {
     if (STRICMP(paramp->argv[i], "--startuptime") == 0) {
-      time_fd = fopen(paramp->argv[i + 1], "a");
-      time_start("--- NVIM STARTING ---");
+      // A "*.json" file gets a Chrome trace instead of the text log.
+      const char *fname = paramp->argv[i + 1];
+      size_t len = strlen(fname);
+      bool trace = len > 5 && STRICMP(fname + len - 5, ".json") == 0;
+      time_fd = fopen(fname, trace ? "w" : "a");
+      time_start("--- NVIM STARTING ---", trace);
       break;
     }
   }
@@ -1809,22 +1834,30 @@ static void edit_buffers(mparm_T *parmp, char *cwd)
     // happen when vimrc contains ":sall").
     if (curbuf == firstwin->w_buffer || curbuf->b_ffname == NULL) {
       curwin->w_arg_idx = arg_idx;
+      buf_T *lazybuf = NULL;
+      if (p_ltp && parmp->window_layout == WIN_TABS && arg_idx < GARGCOUNT) {
+        lazybuf = buflist_findnr(GARGLIST[arg_idx].ae_fnum);
+      }
       // Edit file from arg list, if there is one.  When "Quit" selected
       // at the ATTENTION prompt close the window.
       swap_exists_did_quit = false;
-      (void)do_ecmd(0, arg_idx < GARGCOUNT
-                    ? alist_name(&GARGLIST[arg_idx])
-                    : NULL, NULL, NULL, ECMD_LASTL, ECMD_HIDE, curwin);
-      if (swap_exists_did_quit) {
-        // abort or quit selected
-        if (got_int || only_one_window()) {
-          // abort selected and only one window
-          did_emsg = false;             // avoid hit-enter prompt
-          ui_call_error_exit(1);
-          getout(1);
+      // 'lazytabpages': read the file when the tab page is entered.
+      if (lazybuf == NULL || lazybuf == curbuf || lazybuf->b_ml.ml_mfp != NULL
+          || !enter_buffer_deferred(lazybuf)) {
+        (void)do_ecmd(0, arg_idx < GARGCOUNT
+                      ? alist_name(&GARGLIST[arg_idx])
+                      : NULL, NULL, NULL, ECMD_LASTL, ECMD_HIDE, curwin);
+        if (swap_exists_did_quit) {
+          // abort or quit selected
+          if (got_int || only_one_window()) {
+            // abort selected and only one window
+            did_emsg = false;             // avoid hit-enter prompt
+            ui_call_error_exit(1);
+            getout(1);
+          }
+          win_close(curwin, true, false);
+          advance = false;
         }
-        win_close(curwin, true, false);
-        advance = false;
       }
       if (arg_idx == GARGCOUNT - 1) {
         arg_had_last = true;
@@ -95,9 +95,9 @@ void mh_clear(MapHash *h)
 {
   if (h->hash) {
     memset(h->hash, 0, h->n_buckets * sizeof(*h->hash));
-    h->size = h->n_occupied = 0;
-    h->n_keys = 0;
   }
+  h->size = h->n_occupied = 0;
+  h->n_keys = 0;
 }
 
 #define KEY_NAME(x) x##int
@@ -62,6 +62,10 @@ typedef struct {
   uint32_t *hash;
 } MapHash;
 
+// A set with at most this many keys has no hash table, its keys[] are searched
+// linearly.  Most maps that belong to a buffer or window are that small.
+#define MH_SMALL_MAX 8
+
 #define MAPHASH_INIT { 0, 0, 0, 0, 0, 0, NULL }
 #define SET_INIT { MAPHASH_INIT, NULL }
 #define MAP_INIT { SET_INIT, NULL }
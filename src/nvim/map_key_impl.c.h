@@ -46,11 +46,24 @@ uint32_t KEY_NAME(mh_find_bucket_)(SET_TYPE *set, KEY_TYPE key, bool put)
   return site;
 }
 
+/// Find "key" in a small set, that has no hash table yet.
+///
+/// @return index into set->keys if found, MH_TOMBSTONE otherwise
+static inline uint32_t KEY_NAME(mh_find_small_)(SET_TYPE *set, KEY_TYPE key)
+{
+  for (uint32_t k = 0; k < set->h.n_keys; k++) {
+    if (KEY_NAME(equal_)(set->keys[k], key)) {
+      return k;
+    }
+  }
+  return MH_TOMBSTONE;
+}
+
 /// @return index into set->keys if found, MH_TOMBSTONE otherwise
 uint32_t KEY_NAME(mh_get_)(SET_TYPE *set, KEY_TYPE key)
 {
   if (set->h.n_buckets == 0) {
-    return MH_TOMBSTONE;
+    return KEY_NAME(mh_find_small_)(set, key);
   }
   uint32_t idx = KEY_NAME(mh_find_bucket_)(set, key, false);
   return (idx != MH_TOMBSTONE) ? set->h.hash[idx] - 1 : MH_TOMBSTONE;
@@ -83,6 +96,31 @@ void KEY_NAME(mh_rehash_)(SET_TYPE *set)
 uint32_t KEY_NAME(mh_put_)(SET_TYPE *set, KEY_TYPE key, MHPutStatus *new)
 {
   MapHash *h = &set->h;
+  if (h->n_buckets == 0) {
+    // A small set only has keys[], which is searched linearly.
+    uint32_t pos = KEY_NAME(mh_find_small_)(set, key);
+    if (pos != MH_TOMBSTONE) {
+      *new = kMHExisting;
+      return pos;
+    }
+    if (h->n_keys < MH_SMALL_MAX) {
+      pos = h->n_keys++;
+      if (pos >= h->keys_capacity) {
+        h->keys_capacity = MAX(h->keys_capacity * 2, 4);
+        set->keys = xrealloc(set->keys, h->keys_capacity * sizeof(KEY_TYPE));
+        *new = kMHNewKeyRealloc;
+      } else {
+        *new = kMHNewKeyDidFit;
+      }
+      set->keys[pos] = key;
+      h->size = h->n_keys;
+      return pos;
+    }
+    // Too many keys: build the hash table.
+    mh_realloc(h, 2 * MH_SMALL_MAX);
+    KEY_NAME(mh_rehash_)(set);
+  }
+
   // Might rehash ahead of time if "key" already existed. But it was
   // going to happen soon anyway.
   if (h->n_occupied >= h->upper_bound) {
@@ -137,6 +175,16 @@ uint32_t KEY_NAME(mh_delete_)(SET_TYPE *set, KEY_TYPE *key)
   if (set->h.size == 0) {
     return MH_TOMBSTONE;
   }
+  if (set->h.n_buckets == 0) {
+    uint32_t k = KEY_NAME(mh_find_small_)(set, *key);
+    if (k != MH_TOMBSTONE) {
+      uint32_t last = --set->h.n_keys;
+      *key = set->keys[k];
+      set->h.size--;
+      set->keys[k] = set->keys[last];
+    }
+    return k;
+  }
   uint32_t idx = KEY_NAME(mh_find_bucket_)(set, *key, false);
   if (idx != MH_TOMBSTONE) {
     uint32_t k = set->h.hash[idx] - 1;
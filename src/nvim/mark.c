@@ -70,7 +70,7 @@ void free_fmark(fmark_T fm)
 /// Free xfmark_T item
 void free_xfmark(xfmark_T fm)
 {
-  xfree(fm.fname);
+  str_unintern(fm.fname);
   free_fmark(fm.fmark);
 }
 
@@ -707,7 +707,8 @@ static void fmarks_check_one(xfmark_T *fm, char *name, buf_T *buf)
       && fm->fname != NULL
       && path_fnamecmp(name, fm->fname) == 0) {
     fm->fmark.fnum = buf->b_fnum;
-    XFREE_CLEAR(fm->fname);
+    str_unintern(fm->fname);
+    fm->fname = NULL;
   }
 }
 
@@ -962,7 +963,8 @@ void ex_delmarks(exarg_T *eap)
             namedfm[n].fmark.mark.lnum = 0;
             namedfm[n].fmark.fnum = 0;
             namedfm[n].fmark.timestamp = timestamp;
-            XFREE_CLEAR(namedfm[n].fname);
+            str_unintern(namedfm[n].fname);
+            namedfm[n].fname = NULL;
           }
         }
       } else {
@@ -1423,7 +1425,7 @@ void cleanup_jumplist(win_T *wp, bool loadfiles)
     }
 
     if (mustfree) {
-      xfree(wp->w_jumplist[from].fname);
+      str_unintern(wp->w_jumplist[from].fname);
     } else {
       if (to != from) {
         // Not using wp->w_jumplist[to++] = wp->w_jumplist[from] because
@@ -1446,7 +1448,7 @@ void cleanup_jumplist(win_T *wp, bool loadfiles)
     const xfmark_T *fm_last = &wp->w_jumplist[wp->w_jumplistlen - 1];
     if (fm_last->fmark.fnum == curbuf->b_fnum
         && fm_last->fmark.mark.lnum == wp->w_cursor.lnum) {
-      xfree(fm_last->fname);
+      str_unintern(fm_last->fname);
       wp->w_jumplistlen--;
       wp->w_jumplistidx--;
     }
@@ -1458,9 +1460,7 @@ void copy_jumplist(win_T *from, win_T *to)
 {
   for (int i = 0; i < from->w_jumplistlen; i++) {
     to->w_jumplist[i] = from->w_jumplist[i];
-    if (from->w_jumplist[i].fname != NULL) {
-      to->w_jumplist[i].fname = xstrdup(from->w_jumplist[i].fname);
-    }
+    str_intern_ref(to->w_jumplist[i].fname);
   }
   to->w_jumplistlen = from->w_jumplistlen;
   to->w_jumplistidx = from->w_jumplistidx;
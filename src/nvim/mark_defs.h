@@ -80,7 +80,7 @@ typedef struct filemark {
 /// Structure defining extended mark (mark with file name attached)
 typedef struct xfilemark {
   fmark_T fmark;       ///< Actual mark.
-  char *fname;  ///< File name, used when fnum == 0.
+  char *fname;  ///< File name, used when fnum == 0. Interned, see str_intern().
 } xfmark_T;
 
 #define INIT_XFMARK { INIT_FMARK, NULL }
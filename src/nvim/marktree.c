@@ -5,7 +5,9 @@
 // to text changes.
 //
 // Marks are inserted using marktree_put. Text changes are processed using
-// marktree_splice. All read and delete operations use the iterator.
+// marktree_splice. Consecutive inserts within a line, like typed text, are
+// collected and only applied when the tree is accessed next.
+// All read and delete operations use the iterator.
 // use marktree_itr_get to put an iterator at a given position or
 // marktree_lookup to lookup a mark by its id (iterator optional in this case).
 // Use marktree_itr_current and marktree_itr_next/prev to read marks in a loop.
@@ -44,6 +46,7 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -122,6 +125,10 @@ typedef kvec_withinit_t(Damage, 8) DamageList;
 #endif
 
 #define mt_generic_cmp(a, b) (((b) < (a)) - ((a) < (b)))
+
+// TODO(bfredl): MT_FLAG_REAL could go away if we fix marktree_getp_aux for real
+#define MT_CMP_MASK (MT_FLAG_RIGHT_GRAVITY | MT_FLAG_END | MT_FLAG_REAL | MT_FLAG_LAST)
+
 static int key_cmp(MTKey a, MTKey b)
 {
   int cmp = mt_generic_cmp(a.pos.row, b.pos.row);
@@ -133,9 +140,14 @@ static int key_cmp(MTKey a, MTKey b)
     return cmp;
   }
 
-  // TODO(bfredl): MT_FLAG_REAL could go away if we fix marktree_getp_aux for real
-  const uint16_t cmp_mask = MT_FLAG_RIGHT_GRAVITY | MT_FLAG_END | MT_FLAG_REAL | MT_FLAG_LAST;
-  return mt_generic_cmp(a.flags & cmp_mask, b.flags & cmp_mask);
+  return mt_generic_cmp(a.flags & MT_CMP_MASK, b.flags & MT_CMP_MASK);
+}
+
+/// Pack a position into one integer which compares like the position.
+/// Flipping the sign bits keeps the order of negative rows and columns.
+static inline uint64_t pos_packed(MTPos pos)
+{
+  return ((uint64_t)((uint32_t)pos.row ^ 0x80000000U) << 32) | ((uint32_t)pos.col ^ 0x80000000U);
 }
 
 /// @return position of k if it exists in the node, otherwise the position
@@ -152,9 +164,16 @@ static inline int marktree_getp_aux(const MTNode *x, MTKey k, bool *match)
     *m = false;
     return -1;
   }
+
+  // This is the innermost loop of every tree descent: compare one packed
+  // integer per key, and only look at the flags when the positions are equal.
+  const uint64_t k_pos = pos_packed(k.pos);
+  const uint16_t k_flags = (uint16_t)(k.flags & MT_CMP_MASK);
   while (begin < end) {
     int mid = (begin + end) >> 1;
-    if (key_cmp(x->key[mid], k) < 0) {
+    const MTKey *mid_key = &x->key[mid];
+    const uint64_t mid_pos = pos_packed(mid_key->pos);
+    if (mid_pos < k_pos || (mid_pos == k_pos && (mid_key->flags & MT_CMP_MASK) < k_flags)) {
       begin = mid + 1;
     } else {
       end = mid;
@@ -164,7 +183,8 @@ static inline int marktree_getp_aux(const MTNode *x, MTKey k, bool *match)
     *m = false;
     return x->n - 1;
   }
-  if (!(*m = (key_cmp(k, x->key[begin]) == 0))) {
+  if (!(*m = (pos_packed(x->key[begin].pos) == k_pos
+              && (x->key[begin].flags & MT_CMP_MASK) == k_flags))) {
     begin--;
   }
   return begin;
@@ -290,6 +310,7 @@ static inline void marktree_putp_aux(MarkTree *b, MTNode *x, MTKey k)
 
 void marktree_put(MarkTree *b, MTKey key, int end_row, int end_col, bool end_right)
 {
+  marktree_splice_flush(b);
   assert(!(key.flags & ~(MT_FLAG_EXTERNAL_MASK | MT_FLAG_RIGHT_GRAVITY)));
   if (end_row >= 0) {
     key.flags |= MT_FLAG_PAIRED;
@@ -430,6 +451,7 @@ static MTNode *marktree_alloc_node(MarkTree *b, bool internal)
 
 void marktree_put_key(MarkTree *b, MTKey k)
 {
+  marktree_splice_flush(b);
   k.flags |= MT_FLAG_REAL;  // let's be real.
   if (!b->root) {
     b->root = marktree_alloc_node(b, true);
@@ -1124,6 +1146,7 @@ static void pivot_left(MarkTree *b, MTPos p_pos, MTNode *p, int i)
 /// frees all mem, resets tree to valid empty state
 void marktree_clear(MarkTree *b)
 {
+  b->pending_cols = 0;
   if (b->root) {
     marktree_free_subtree(b, b->root);
     b->root = NULL;
@@ -1143,6 +1166,26 @@ void marktree_free_subtree(MarkTree *b, MTNode *x)
   marktree_free_node(b, x);
 }
 
+static size_t marktree_subtree_mem(MTNode *x)
+{
+  size_t size = x->level ? ILEN : sizeof(MTNode);
+  if (x->intersect.items != x->intersect.init_array) {
+    size += kv_max(x->intersect) * sizeof(uint64_t);
+  }
+  if (x->level) {
+    for (int i = 0; i < x->n + 1; i++) {
+      size += marktree_subtree_mem(x->ptr[i]);
+    }
+  }
+  return size;
+}
+
+/// @return bytes allocated for the nodes of "b", not counting the id map.
+size_t marktree_mem_used(MarkTree *b)
+{
+  return b->root ? marktree_subtree_mem(b->root) : 0;
+}
+
 static void marktree_free_node(MarkTree *b, MTNode *x)
 {
   kvi_destroy(x->intersect);
@@ -1211,6 +1254,7 @@ void marktree_move(MarkTree *b, MarkTreeIter *itr, int row, int col)
 
 void marktree_restore_pair(MarkTree *b, MTKey key)
 {
+  marktree_splice_flush(b);
   MarkTreeIter itr[1];
   MarkTreeIter end_itr[1];
   marktree_lookup(b, mt_lookup_key_side(key, false), itr);
@@ -1236,6 +1280,7 @@ bool marktree_itr_get(MarkTree *b, int32_t row, int col, MarkTreeIter *itr)
 bool marktree_itr_get_ext(MarkTree *b, MTPos p, MarkTreeIter *itr, bool last, bool gravity,
                           MTPos *oldbase)
 {
+  marktree_splice_flush(b);
   if (b->n_keys == 0) {
     itr->x = NULL;
     return false;
@@ -1282,6 +1327,7 @@ bool marktree_itr_get_ext(MarkTree *b, MTPos p, MarkTreeIter *itr, bool last, bo
 
 bool marktree_itr_first(MarkTree *b, MarkTreeIter *itr)
 {
+  marktree_splice_flush(b);
   if (b->n_keys == 0) {
     itr->x = NULL;
     return false;
@@ -1303,6 +1349,7 @@ bool marktree_itr_first(MarkTree *b, MarkTreeIter *itr)
 // gives the first key that is greater or equal to p
 int marktree_itr_last(MarkTree *b, MarkTreeIter *itr)
 {
+  marktree_splice_flush(b);
   if (b->n_keys == 0) {
     itr->x = NULL;
     return false;
@@ -1481,6 +1528,7 @@ static bool itr_eq(MarkTreeIter *itr1, MarkTreeIter *itr2)
 ///               could return false
 bool marktree_itr_get_overlap(MarkTree *b, int row, int col, MarkTreeIter *itr)
 {
+  marktree_splice_flush(b);
   if (b->n_keys == 0) {
     itr->x = NULL;
     return false;
@@ -1621,8 +1669,49 @@ static int damage_cmp(const void *s1, const void *s2)
   return d1->id > d2->id ? 1 : -1;
 }
 
-bool marktree_splice(MarkTree *b, int32_t start_line, int start_col, int old_extent_line,
+/// Apply the insert collected by marktree_splice(), if there is one.
+static void marktree_splice_flush(MarkTree *b)
+{
+  if (b->pending_cols == 0) {
+    return;
+  }
+  int cols = b->pending_cols;
+  b->pending_cols = 0;
+  marktree_splice_now(b, b->pending_start.row, b->pending_start.col, 0, 0, 0, cols);
+}
+
+/// Move marks for a text change.
+///
+/// An insert within a line that directly follows the previous one is only
+/// added to the pending insert, which is applied to the marks before the tree
+/// is used next. So typing doesn't walk the tree for every character.
+/// Moving marks for inserts at "c" and at "c + n1" is the same as for one
+/// insert of "n1 + n2" at "c", also for marks with left or right gravity.
+void marktree_splice(MarkTree *b, int32_t start_line, int start_col, int old_extent_line,
                      int old_extent_col, int new_extent_line, int new_extent_col)
+{
+  if (old_extent_line == 0 && old_extent_col == 0 && new_extent_line == 0 && new_extent_col > 0
+      && b->n_keys > 0) {
+    if (b->pending_cols > 0 && b->pending_start.row == start_line
+        && b->pending_start.col + b->pending_cols == start_col
+        && b->pending_cols <= INT_MAX - new_extent_col) {
+      b->pending_cols += new_extent_col;
+      return;
+    }
+    marktree_splice_flush(b);
+    b->pending_start = MTPos(start_line, start_col);
+    b->pending_cols = new_extent_col;
+    return;
+  }
+
+  marktree_splice_flush(b);
+  marktree_splice_now(b, start_line, start_col, old_extent_line, old_extent_col, new_extent_line,
+                      new_extent_col);
+}
+
+static bool marktree_splice_now(MarkTree *b, int32_t start_line, int start_col,
+                                int old_extent_line, int old_extent_col, int new_extent_line,
+                                int new_extent_col)
 {
   MTPos start = { start_line, start_col };
   MTPos old_extent = { old_extent_line, old_extent_col };
@@ -1922,6 +2011,7 @@ static uint64_t pseudo_index_for_id(MarkTree *b, uint64_t id, bool sloppy)
 /// @param itr OPTIONAL. set itr to pos.
 MTKey marktree_lookup(MarkTree *b, uint64_t id, MarkTreeIter *itr)
 {
+  marktree_splice_flush(b);
   MTNode *n = id2node(b, id);
   if (n == NULL) {
     if (itr) {
@@ -2025,6 +2115,7 @@ void marktree_del_pair_test(MarkTree *b, uint32_t ns, uint32_t id)
 
 void marktree_check(MarkTree *b)
 {
+  marktree_splice_flush(b);
 #ifndef NDEBUG
   if (b->root == NULL) {
     assert(b->n_keys == 0);
@@ -2091,6 +2182,7 @@ size_t marktree_check_node(MarkTree *b, MTNode *x, MTPos *last, bool *last_right
 
 bool marktree_check_intersections(MarkTree *b)
 {
+  marktree_splice_flush(b);
   if (!b->root) {
     return true;
   }
@@ -2200,6 +2292,7 @@ bool mt_recurse_nodes_compare(MTNode *x, PMap(ptr_t) *checked)
 
 String mt_inspect(MarkTree *b, bool keys, bool dot)
 {
+  marktree_splice_flush(b);
   garray_T ga[1];
   ga_init(ga, (int)sizeof(char), 80);
   MTPos p = { 0, 0 };
@@ -80,4 +80,7 @@ typedef struct {
   MTNode *root;
   size_t n_keys, n_nodes;
   PMap(uint64_t) id2node[1];
+  // insert of "pending_cols" columns at "pending_start" not yet applied to the marks
+  MTPos pending_start;
+  int pending_cols;
 } MarkTree;
@@ -29,6 +29,7 @@
 #include <locale.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -61,6 +62,7 @@
 #include "nvim/option_vars.h"
 #include "nvim/optionstr.h"
 #include "nvim/os/os.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
@@ -1899,12 +1901,67 @@ theend:
   convert_setup(&vimconv, NULL, NULL);
 }
 
+/// @return  the number of ASCII bytes at the start of the "len" bytes at "s".
+size_t utf_ascii_len(const char *s, size_t len)
+  FUNC_ATTR_PURE FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t i = 0;
+
+  // Check eight bytes at a time, the memcpy() is turned into a plain load.
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, s + i, sizeof(word));
+    if (word & 0x8080808080808080ULL) {
+      break;
+    }
+  }
+  while (i < len && (uint8_t)s[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+/// Like utf_ascii_len(), but only count printable ASCII characters, from
+/// space to '~'.  Each of them is one character that takes one cell.
+/// A character followed by a composing character is not counted.
+///
+/// @return  the number of printable ASCII bytes at the start of the "len"
+///          bytes at "s".
+size_t utf_ascii_cells_len(const char *s, size_t len)
+  FUNC_ATTR_PURE FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t i = 0;
+
+  // Check eight bytes at a time: stop at a word that has a byte below 0x20
+  // or above 0x7e.
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, s + i, sizeof(word));
+    uint64_t below = (word - 0x2020202020202020ULL) & ~word;
+    uint64_t above = (word + 0x0101010101010101ULL) | word;
+    if ((below | above) & 0x8080808080808080ULL) {
+      break;
+    }
+  }
+  while (i < len && (uint8_t)s[i] >= ' ' && (uint8_t)s[i] <= '~') {
+    i++;
+  }
+  // The last character may be the base of a composing character.
+  if (i > 0 && i < len && (uint8_t)s[i] >= 0x80) {
+    i--;
+  }
+  return i;
+}
+
 /// @return  true if string "s" is a valid utf-8 string.
 /// When "end" is NULL stop at the first NUL.  Otherwise stop at "end".
 bool utf_valid_string(const char *s, const char *end)
 {
   const uint8_t *p = (uint8_t *)s;
 
+  if (end != NULL) {
+    p += utf_ascii_len(s, (size_t)(end - s));
+  }
   while (end == NULL ? *p != NUL : p < (uint8_t *)end) {
     int l = utf8len_tab_zero[*p];
     if (l == 0) {
@@ -2669,6 +2726,7 @@ void f_setcellwidths(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
     xfree(cw_table);
     cw_table = NULL;
     cw_table_size = 0;
+    vcol_cache_invalidate_all();
     return;
   }
 
@@ -2766,6 +2824,7 @@ void f_setcellwidths(typval_T *argvars, typval_T *rettv, EvalFuncData fptr)
   }
 
   xfree(cw_table_save);
+  vcol_cache_invalidate_all();
   redraw_all_later(UPD_NOT_VALID);
 }
 
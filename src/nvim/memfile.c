@@ -32,6 +32,7 @@
 /// mf_free()         remove a block
 /// mf_sync()         sync changed parts of memfile to disk
 /// mf_release_all()  release as much memory as possible
+/// mf_mem_used()     total memory used for blocks of all memfiles
 /// mf_trans_del()    may translate negative to positive block number
 /// mf_fullname()     make file name full path (use before first :cd)
 
@@ -40,6 +41,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -49,6 +51,7 @@
 #include "nvim/fileio.h"
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
+#include "nvim/log.h"
 #include "nvim/map_defs.h"
 #include "nvim/memfile.h"
 #include "nvim/memfile_defs.h"
@@ -57,6 +60,7 @@
 #include "nvim/message.h"
 #include "nvim/os/fs.h"
 #include "nvim/os/input.h"
+#include "nvim/option_vars.h"
 #include "nvim/os/os.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
@@ -71,6 +75,9 @@
 
 static const char e_block_was_not_locked[] = N_("E293: Block was not locked");
 
+/// Bytes of block memory used by all memfiles, checked against 'maxmemtot'.
+static size_t mf_total_mem_used = 0;
+
 /// Open a new or existing memory block file.
 ///
 /// @param fname  Name of file to use.
@@ -104,6 +111,8 @@ memfile_T *mf_open(char *fname, int flags)
   mfp->mf_hash = (PMap(int64_t)) MAP_INIT;
   mfp->mf_trans = (Map(int64_t, int64_t)) MAP_INIT;
   mfp->mf_page_size = MEMFILE_PAGE_SIZE;
+  mfp->mf_mem_used = 0;
+  mfp->mf_clock_hand = 0;
 
   // Try to set the page size equal to device's block size. Speeds up I/O a lot.
   FileInfo file_info;
@@ -181,7 +190,7 @@ void mf_close(memfile_T *mfp, bool del_file)
   // free entries in used list
   bhdr_T *hp;
   map_foreach_value(&mfp->mf_hash, hp, {
-    mf_free_bhdr(hp);
+    mf_free_bhdr(mfp, hp);
   })
   while (mfp->mf_free_first != NULL) {  // free entries in free list
     xfree(mf_rem_free(mfp));
@@ -224,6 +233,14 @@ void mf_close_file(buf_T *buf, bool getlines)
 /// and the size it indicates differs from what was guessed.
 void mf_new_page_size(memfile_T *mfp, unsigned new_size)
 {
+  // Account the blocks in memory with the new size, they are freed with it.
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    if (!(hp->bh_flags & BH_PACKED)) {
+      mf_mem_sub(mfp, (size_t)mfp->mf_page_size * hp->bh_page_count);
+      mf_mem_add(mfp, (size_t)new_size * hp->bh_page_count);
+    }
+  })
   mfp->mf_page_size = new_size;
 }
 
@@ -252,6 +269,7 @@ bhdr_T *mf_new(memfile_T *mfp, bool negative, unsigned page_count)
       // If the number of pages matches use the bhdr_T from the free list and
       // allocate the data.
       void *p = xmalloc((size_t)mfp->mf_page_size * page_count);
+      mf_mem_add(mfp, (size_t)mfp->mf_page_size * page_count);
       hp = mf_rem_free(mfp);
       hp->bh_data = p;
     }
@@ -265,7 +283,7 @@ bhdr_T *mf_new(memfile_T *mfp, bool negative, unsigned page_count)
       mfp->mf_blocknr_max += page_count;
     }
   }
-  hp->bh_flags = BH_LOCKED | BH_DIRTY;    // new block is always dirty
+  hp->bh_flags = BH_LOCKED | BH_DIRTY | BH_REFERENCED;    // new block is always dirty
   mfp->mf_dirty = MF_DIRTY_YES;
   hp->bh_page_count = page_count;
   pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);
@@ -274,6 +292,7 @@ bhdr_T *mf_new(memfile_T *mfp, bool negative, unsigned page_count)
   // This also avoids that the passwd file ends up in the swap file!
   (void)memset(hp->bh_data, 0, (size_t)mfp->mf_page_size * page_count);
 
+  mf_trim(mfp);
   return hp;
 }
 
@@ -308,17 +327,24 @@ bhdr_T *mf_get(memfile_T *mfp, blocknr_T nr, unsigned page_count)
     hp->bh_bnum = nr;
     hp->bh_flags = 0;
     hp->bh_page_count = page_count;
+    NVIM_PROBE(mf_get_read, 2, nr, page_count);
     if (mf_read(mfp, hp) == FAIL) {             // cannot read the block
-      mf_free_bhdr(hp);
+      mf_free_bhdr(mfp, hp);
       return NULL;
     }
+    g_stats.memfile_miss++;
   } else {
     pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
+    mf_unpack(mfp, hp);
+    g_stats.memfile_hit++;
   }
 
-  hp->bh_flags |= BH_LOCKED;
+  // The block may be changed, it could be compressed better later.
+  hp->bh_flags &= ~BH_NOPACK;
+  hp->bh_flags |= BH_LOCKED | BH_REFERENCED;
   pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);  // put in front of hash table
 
+  mf_trim(mfp);
   return hp;
 }
 
@@ -349,6 +375,7 @@ void mf_put(memfile_T *mfp, bhdr_T *hp, bool dirty, bool infile)
 /// Signal block as no longer used (may put it in the free list).
 void mf_free(memfile_T *mfp, bhdr_T *hp)
 {
+  mf_mem_sub(mfp, mf_block_mem(mfp, hp));
   xfree(hp->bh_data);           // free data
   pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);  // get *hp out of the hash table
   if (hp->bh_bnum < 0) {
@@ -368,6 +395,8 @@ void mf_free(memfile_T *mfp, bhdr_T *hp)
 ///               MFS_FLUSH  Make sure buffers are flushed to disk, so they will
 ///                          survive a system crash.
 ///               MFS_ZERO   Only write block 0.
+///               MFS_ASYNC  With MFS_FLUSH: don't wait for the flush to
+///                          finish, errors are only logged.
 ///
 /// @return FAIL  If failure. Possible causes:
 ///               - No file (nothing to do).
@@ -427,7 +456,7 @@ int mf_sync(memfile_T *mfp, int flags)
   }
 
   if (flags & MFS_FLUSH) {
-    if (os_fsync(mfp->mf_fd)) {
+    if ((flags & MFS_ASYNC) ? os_fsync_async(mfp->mf_fd) : os_fsync(mfp->mf_fd)) {
       status = FAIL;
     }
   }
@@ -474,7 +503,7 @@ bool mf_release_all(void)
               && (!(hp->bh_flags & BH_DIRTY)
                   || mf_write(mfp, hp) != FAIL)) {
             pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
-            mf_free_bhdr(hp);
+            mf_free_bhdr(mfp, hp);
             retval = true;
             // Rerun with the same value of i. another item will have taken
             // its place (or it was the last)
@@ -488,18 +517,276 @@ bool mf_release_all(void)
   return retval;
 }
 
+/// Release blocks that are not locked until the memory used by "mfp" is
+/// within 'maxmem' and the memory used by all memfiles is within 'maxmemtot'.
+///
+/// Blocks are picked with the CLOCK algorithm: a block used since the
+/// previous pass only loses its BH_REFERENCED flag, so that recently used
+/// blocks are released last.  Dirty blocks are written first.  Without a
+/// swapfile blocks can't be released, they are compressed instead.
+static void mf_trim(memfile_T *mfp)
+{
+  if (!mf_over_budget(mfp)) {
+    return;
+  }
+
+  // Stop after a full round that changed nothing, e.g. when all blocks are
+  // locked or can't be compressed.  Clearing BH_REFERENCED counts, the next
+  // round can release that block.
+  size_t idle = 0;
+  while (idle < map_size(&mfp->mf_hash) && mf_over_budget(mfp)) {
+    if (mfp->mf_clock_hand >= map_size(&mfp->mf_hash)) {
+      mfp->mf_clock_hand = 0;
+    }
+    bhdr_T *hp = mfp->mf_hash.values[mfp->mf_clock_hand];
+    if (hp->bh_flags & BH_LOCKED) {
+      mfp->mf_clock_hand++;
+      idle++;
+      continue;
+    }
+    if (hp->bh_flags & BH_REFERENCED) {
+      hp->bh_flags &= ~BH_REFERENCED;
+      mfp->mf_clock_hand++;
+      idle = 0;
+      continue;
+    }
+    if (mfp->mf_fd < 0) {
+      idle = mf_pack(mfp, hp) ? 0 : idle + 1;
+      mfp->mf_clock_hand++;
+      continue;
+    }
+    if ((hp->bh_flags & BH_DIRTY) && mf_write(mfp, hp) == FAIL) {
+      return;  // probably the disk is full, don't try other blocks
+    }
+    // Another block takes the place of this one in the hash table, look at
+    // the same index again.
+    pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
+    mf_free_bhdr(mfp, hp);
+    g_stats.memfile_evict++;
+    idle = 0;
+  }
+}
+
+/// Compress the data of block "hp", if that saves a useful amount of memory.
+///
+/// @return  true if the block was compressed now.
+static bool mf_pack(memfile_T *mfp, bhdr_T *hp)
+{
+  if (hp->bh_flags & (BH_PACKED | BH_NOPACK)) {
+    return false;
+  }
+
+  size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+  // Require saving at least an eighth, decompressing has a cost too.
+  size_t max_size = size - size / 8;
+  uint8_t *packed = xmalloc(max_size);
+  size_t packed_size = mf_lz_compress(hp->bh_data, size, packed, max_size);
+  if (packed_size == 0) {
+    xfree(packed);
+    hp->bh_flags |= BH_NOPACK;
+    return false;
+  }
+
+  xfree(hp->bh_data);
+  hp->bh_data = xrealloc(packed, packed_size);
+  hp->bh_packed_size = (unsigned)packed_size;
+  hp->bh_flags |= BH_PACKED;
+  mf_mem_sub(mfp, size);
+  mf_mem_add(mfp, packed_size);
+  g_stats.memfile_pack++;
+  return true;
+}
+
+/// Decompress the data of block "hp" if it was compressed by mf_pack().
+static void mf_unpack(memfile_T *mfp, bhdr_T *hp)
+{
+  if (!(hp->bh_flags & BH_PACKED)) {
+    return;
+  }
+
+  size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+  void *data = xmalloc(size);
+  if (!mf_lz_decompress(hp->bh_data, hp->bh_packed_size, data, size)) {
+    siemsg("Corrupted compressed memfile block %" PRId64, (int64_t)hp->bh_bnum);
+  }
+  mf_mem_sub(mfp, hp->bh_packed_size);
+  mf_mem_add(mfp, size);
+  xfree(hp->bh_data);
+  hp->bh_data = data;
+  hp->bh_flags &= ~BH_PACKED;
+}
+
+// Parameters of the compression for cold blocks, see mf_lz_compress().
+enum {
+  MF_LZ_HASH_BITS = 12,
+  MF_LZ_MAX_OFF = 1 << 13,   ///< maximum distance of a back reference
+  MF_LZ_MAX_LIT = 1 << 5,    ///< maximum number of bytes in a literal run
+  MF_LZ_MAX_REF = 264,       ///< maximum length of a back reference
+};
+
+/// Append literal runs for "n" bytes at "lit" to "out" at offset "op".
+///
+/// @return  new offset in "out", SIZE_MAX when "out_len" is exceeded.
+static size_t mf_lz_literals(const uint8_t *lit, size_t n, uint8_t *out, size_t op,
+                             size_t out_len)
+{
+  while (n > 0) {
+    size_t run = MIN(n, (size_t)MF_LZ_MAX_LIT);
+    if (op + 1 + run > out_len) {
+      return SIZE_MAX;
+    }
+    out[op++] = (uint8_t)(run - 1);
+    memcpy(out + op, lit, run);
+    op += run;
+    lit += run;
+    n -= run;
+  }
+  return op;
+}
+
+/// Compress "in_len" bytes at "in" into "out" with a small LZ77 variant: a
+/// control byte below MF_LZ_MAX_LIT is followed by that many bytes plus one,
+/// otherwise its top 3 bits (extended with the next byte when all set) are
+/// the length minus two and the remaining 5 bits with the next byte the
+/// distance minus one of a back reference.  Also used for the undo text of
+/// 'maxmemundo'.
+///
+/// @return  compressed size, zero when it does not fit in "out_len".
+size_t mf_lz_compress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_len)
+{
+  // Positions of recently seen three byte sequences.  Stale entries left over
+  // from a previous block are harmless, a match is always verified.
+  static uint32_t table[1 << MF_LZ_HASH_BITS];
+  size_t ip = 0;
+  size_t op = 0;
+  size_t lit = 0;
+
+  while (ip + 2 < in_len) {
+    uint32_t h = ((uint32_t)in[ip] << 16 | (uint32_t)in[ip + 1] << 8 | in[ip + 2])
+                 * 2654435761U;
+    h >>= 32 - MF_LZ_HASH_BITS;
+    size_t ref = table[h];
+    table[h] = (uint32_t)ip;
+    if (ref >= ip || ip - ref > MF_LZ_MAX_OFF || memcmp(in + ref, in + ip, 3) != 0) {
+      ip++;
+      continue;
+    }
+    if ((op = mf_lz_literals(in + lit, ip - lit, out, op, out_len)) == SIZE_MAX
+        || op + 3 > out_len) {
+      return 0;
+    }
+    size_t len = 3;
+    size_t max_len = MIN(in_len - ip, (size_t)MF_LZ_MAX_REF);
+    while (len < max_len && in[ref + len] == in[ip + len]) {
+      len++;
+    }
+    size_t off = ip - ref - 1;
+    size_t code = len - 2;
+    if (code < 7) {
+      out[op++] = (uint8_t)((code << 5) | (off >> 8));
+    } else {
+      out[op++] = (uint8_t)((7 << 5) | (off >> 8));
+      out[op++] = (uint8_t)(code - 7);
+    }
+    out[op++] = (uint8_t)(off & 0xff);
+    ip += len;
+    lit = ip;
+  }
+  op = mf_lz_literals(in + lit, in_len - lit, out, op, out_len);
+  return op == SIZE_MAX ? 0 : op;
+}
+
+/// Decompress "in_len" bytes at "in" produced by mf_lz_compress() into
+/// exactly "out_len" bytes at "out".
+///
+/// @return  false when the data is corrupt.
+bool mf_lz_decompress(const uint8_t *in, size_t in_len, uint8_t *out, size_t out_len)
+{
+  size_t ip = 0;
+  size_t op = 0;
+
+  while (ip < in_len) {
+    size_t ctrl = in[ip++];
+    if (ctrl < MF_LZ_MAX_LIT) {
+      size_t run = ctrl + 1;
+      if (ip + run > in_len || op + run > out_len) {
+        return false;
+      }
+      memcpy(out + op, in + ip, run);
+      ip += run;
+      op += run;
+      continue;
+    }
+    size_t len = ctrl >> 5;
+    if (len == 7) {
+      if (ip >= in_len) {
+        return false;
+      }
+      len += in[ip++];
+    }
+    if (ip >= in_len) {
+      return false;
+    }
+    size_t off = ((ctrl & 0x1f) << 8) + in[ip++] + 1;
+    len += 2;
+    if (off > op || op + len > out_len) {
+      return false;
+    }
+    for (size_t i = 0; i < len; i++, op++) {
+      out[op] = out[op - off];
+    }
+  }
+  return op == out_len;
+}
+
+/// @return  bytes of memory used for the data of block "hp".
+static size_t mf_block_mem(const memfile_T *mfp, const bhdr_T *hp)
+{
+  return (hp->bh_flags & BH_PACKED) ? hp->bh_packed_size
+                                    : (size_t)mfp->mf_page_size * hp->bh_page_count;
+}
+
+/// @return  whether "mfp" or all memfiles use more memory than allowed by
+///          'maxmem' or 'maxmemtot'.
+static bool mf_over_budget(const memfile_T *mfp)
+{
+  return (p_mm > 0 && mfp->mf_mem_used > (size_t)p_mm * 1024)
+         || (p_mmt > 0 && mf_total_mem_used > (size_t)p_mmt * 1024);
+}
+
+/// @return  bytes of block memory used by all memfiles.
+size_t mf_mem_used(void)
+{
+  return mf_total_mem_used;
+}
+
+static void mf_mem_add(memfile_T *mfp, size_t size)
+{
+  mfp->mf_mem_used += size;
+  mf_total_mem_used += size;
+}
+
+static void mf_mem_sub(memfile_T *mfp, size_t size)
+{
+  assert(mfp->mf_mem_used >= size && mf_total_mem_used >= size);
+  mfp->mf_mem_used -= size;
+  mf_total_mem_used -= size;
+}
+
 /// Allocate a block header and a block of memory for it.
 static bhdr_T *mf_alloc_bhdr(memfile_T *mfp, unsigned page_count)
 {
   bhdr_T *hp = xmalloc(sizeof(bhdr_T));
   hp->bh_data = xmalloc((size_t)mfp->mf_page_size * page_count);
   hp->bh_page_count = page_count;
+  mf_mem_add(mfp, (size_t)mfp->mf_page_size * page_count);
   return hp;
 }
 
 /// Free a block header and its block memory.
-static void mf_free_bhdr(bhdr_T *hp)
+static void mf_free_bhdr(memfile_T *mfp, bhdr_T *hp)
 {
+  mf_mem_sub(mfp, mf_block_mem(mfp, hp));
   xfree(hp->bh_data);
   xfree(hp);
 }
@@ -573,6 +860,7 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
       return FAIL;
     }
   }
+  mf_unpack(mfp, hp);
 
   unsigned page_size = mfp->mf_page_size;  // number of bytes in a page
 
@@ -599,6 +887,7 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
       page_count = 1;
     } else {
       page_count = hp2->bh_page_count;
+      mf_unpack(mfp, hp2);
     }
     unsigned size = page_size * page_count;  // number of bytes written
     void *data = (hp2 == NULL) ? hp->bh_data : hp2->bh_data;
@@ -32,9 +32,13 @@ typedef struct bhdr {
   void *bh_data;                     ///< pointer to memory (for used block)
   unsigned bh_page_count;            ///< number of pages in this block
 
-#define BH_DIRTY    1U
-#define BH_LOCKED   2U
-  unsigned bh_flags;                 ///< BH_DIRTY or BH_LOCKED
+#define BH_DIRTY      1U
+#define BH_LOCKED     2U
+#define BH_REFERENCED 4U             ///< used since the last mf_trim() pass
+#define BH_PACKED     8U             ///< bh_data is compressed
+#define BH_NOPACK    16U             ///< compressing did not save memory
+  unsigned bh_flags;                 ///< BH_DIRTY, BH_LOCKED, etc.
+  unsigned bh_packed_size;           ///< size of bh_data when BH_PACKED
 } bhdr_T;
 
 typedef enum {
@@ -65,4 +69,7 @@ typedef struct memfile {
   blocknr_T mf_infile_count;         ///< number of pages in the file
   unsigned mf_page_size;             ///< number of bytes in a page
   mfdirty_T mf_dirty;
+
+  size_t mf_mem_used;                ///< bytes of block memory in mf_hash
+  size_t mf_clock_hand;              ///< next index in mf_hash for mf_trim()
 } memfile_T;
@@ -60,6 +60,7 @@
 #include "nvim/globals.h"
 #include "nvim/highlight.h"
 #include "nvim/input.h"
+#include "nvim/log.h"
 #include "nvim/macros_defs.h"
 #include "nvim/main.h"
 #include "nvim/map_defs.h"
@@ -286,6 +287,10 @@ int ml_open(buf_T *buf)
   buf->b_ml.ml_line_offset = 0;
   buf->b_ml.ml_chunksize = NULL;
   buf->b_ml.ml_usedchunks = 0;
+  buf->b_ml.ml_chunktree = NULL;
+  buf->b_ml.ml_chunktree_len = 0;
+  buf->b_ml.ml_chunktree_valid = false;
+  buf->b_u_hash_valid = false;
 
   if (cmdmod.cmod_flags & CMOD_NOSWAPFILE) {
     buf->b_p_swf = false;
@@ -568,6 +573,9 @@ void ml_close(buf_T *buf, int del_file)
   }
   xfree(buf->b_ml.ml_stack);
   XFREE_CLEAR(buf->b_ml.ml_chunksize);
+  XFREE_CLEAR(buf->b_ml.ml_chunktree);
+  buf->b_ml.ml_chunktree_len = 0;
+  buf->b_ml.ml_chunktree_valid = false;
   buf->b_ml.ml_mfp = NULL;
 
   // Reset the "recovered" flag, give the ATTENTION prompt the next time
@@ -1681,7 +1689,10 @@ static int recov_file_names(char **names, char *path, int prepend_dot)
 /// @param check_char  if true, stop syncing when character becomes available, but
 ///
 /// always sync at least one block.
-void ml_sync_all(int check_file, int check_char, bool do_fsync)
+/// @param do_fsync  flush the swapfiles to disk
+/// @param async  with "do_fsync": don't wait for the flush, so that a slow
+///               file system (e.g. NFS) does not make typing hang
+void ml_sync_all(int check_file, int check_char, bool do_fsync, bool async)
 {
   FOR_ALL_BUFFERS(buf) {
     if (buf->b_ml.ml_mfp == NULL || buf->b_ml.ml_mfp->mf_fname == NULL) {
@@ -1706,7 +1717,8 @@ void ml_sync_all(int check_file, int check_char, bool do_fsync)
     }
     if (buf->b_ml.ml_mfp->mf_dirty == MF_DIRTY_YES) {
       (void)mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP : 0)
-                    | (do_fsync && bufIsChanged(buf) ? MFS_FLUSH : 0));
+                    | (do_fsync && bufIsChanged(buf) ? MFS_FLUSH : 0)
+                    | (async ? MFS_ASYNC : 0));
       if (check_char && os_char_avail()) {      // character available now
         break;
       }
@@ -1820,6 +1832,43 @@ char *ml_get_buf_mut(buf_T *buf, linenr_T lnum)
   return ml_get_buf_impl(buf, lnum, true);
 }
 
+/// Get lines "lnum" and following of "buf" without copying them: pointers are
+/// returned to the text in the data block holding "lnum", so that callers can
+/// process a whole block per call.  The text is NUL terminated, but like for
+/// ml_get() it is only valid until the next memline call.
+///
+/// @param maxcount  maximum number of lines to return
+/// @param[out] lines  pointers to the text of the lines
+/// @param[out] lens  length of each line, excluding the NUL
+///
+/// @return  number of lines stored in "lines" and "lens", at least one.
+int ml_get_buf_lines(buf_T *buf, linenr_T lnum, int maxcount, char **lines, colnr_T *lens)
+  FUNC_ATTR_NONNULL_ALL
+{
+  lines[0] = ml_get_buf(buf, lnum);
+  lens[0] = (colnr_T)strlen(lines[0]);
+
+  bhdr_T *hp = buf->b_ml.ml_locked;
+  if (hp == NULL || (buf->b_ml.ml_flags & (ML_LINE_DIRTY | ML_ALLOCATED))
+      || lnum < buf->b_ml.ml_locked_low || lnum > buf->b_ml.ml_locked_high) {
+    return 1;  // the line is not in a locked data block
+  }
+  DataBlock *dp = hp->bh_data;
+  if (lines[0] < (char *)dp || lines[0] >= (char *)dp + dp->db_txt_end) {
+    return 1;
+  }
+
+  int count = MIN(maxcount, buf->b_ml.ml_locked_high - lnum + 1);
+  int idx = lnum - buf->b_ml.ml_locked_low;
+  for (int i = 1; i < count; i++) {
+    unsigned start = dp->db_index[idx + i] & DB_INDEX_MASK;
+    unsigned end = dp->db_index[idx + i - 1] & DB_INDEX_MASK;
+    lines[i] = (char *)dp + start;
+    lens[i] = (colnr_T)(end - start - 1);
+  }
+  return count;
+}
+
 /// @return  pointer to position "pos".
 char *ml_get_pos(const pos_T *pos)
   FUNC_ATTR_NONNULL_ALL
@@ -1982,6 +2031,41 @@ int ml_append_buf(buf_T *buf, linenr_T lnum, char *line, colnr_T len, bool newfi
   return ml_append_int(buf, lnum, line, len, newfile, false);
 }
 
+/// Append "count" lines after line "lnum" of buffer "buf".  The buffer must
+/// already have a memline.
+///
+/// Like calling ml_append_buf() for every line, but the cached line is only
+/// flushed once and the lengths can be passed in, so that consecutive lines
+/// are added to the locked data block without looking them up again.
+///
+/// @param lnum  append after this line (can be 0)
+/// @param lines  text of the new lines
+/// @param lens  length of each line, including NUL, or NULL to compute them
+/// @param count  number of lines in "lines"
+/// @param newfile  flag, see ml_append()
+///
+/// @return  number of lines appended, less than "count" on failure
+int ml_append_buf_lines(buf_T *buf, linenr_T lnum, char **lines, const colnr_T *lens, int count,
+                        bool newfile)
+  FUNC_ATTR_NONNULL_ARG(1)
+{
+  if (buf->b_ml.ml_mfp == NULL) {
+    return 0;
+  }
+
+  if (buf->b_ml.ml_line_lnum != 0) {
+    ml_flush_line(buf);
+  }
+  int i;
+  for (i = 0; i < count; i++) {
+    if (ml_append_int(buf, lnum + i, lines[i], lens == NULL ? 0 : lens[i],
+                      newfile, false) == FAIL) {
+      break;
+    }
+  }
+  return i;
+}
+
 /// @param lnum  append after this line (can be 0)
 /// @param line  text of the new line
 /// @param len  length of line, including NUL, or 0
@@ -2884,6 +2968,8 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
     return NULL;
   }
 
+  NVIM_PROBE(ml_find_line_miss, 3, buf->handle, lnum, action);
+
   blocknr_T bnum = 1;                         // start at the root of the tree
   blocknr_T bnum2;
   int page_count = 1;
@@ -3683,6 +3769,92 @@ enum {
   MLCS_MINL = 400,  // should be half of MLCS_MAXL
 };
 
+/// Rebuild the Fenwick tree over the chunks of "buf" in O(n).
+static void ml_chunktree_build(buf_T *buf)
+{
+  memline_T *ml = &buf->b_ml;
+  int n = ml->ml_usedchunks;
+
+  if (ml->ml_chunktree_len < n + 1) {
+    ml->ml_chunktree_len = MAX(ml->ml_numchunks, n) + 1;
+    ml->ml_chunktree = xrealloc(ml->ml_chunktree,
+                                sizeof(chunksize_T) * (size_t)ml->ml_chunktree_len);
+  }
+  chunksize_T *tree = ml->ml_chunktree;
+  memcpy(tree + 1, ml->ml_chunksize, sizeof(chunksize_T) * (size_t)n);
+  for (int i = 1; i <= n; i++) {
+    int parent = i + (i & -i);
+    if (parent <= n) {
+      tree[parent].mlcs_numlines += tree[i].mlcs_numlines;
+      tree[parent].mlcs_totalsize += tree[i].mlcs_totalsize;
+    }
+  }
+  ml->ml_chunktree_valid = true;
+}
+
+/// Add "lines" and "size" to chunk "idx" in the Fenwick tree, if it is valid.
+static void ml_chunktree_add(buf_T *buf, int idx, int lines, int size)
+{
+  memline_T *ml = &buf->b_ml;
+
+  if (!ml->ml_chunktree_valid) {
+    return;
+  }
+  for (int i = idx + 1; i <= ml->ml_usedchunks; i += i & -i) {
+    ml->ml_chunktree[i].mlcs_numlines += lines;
+    ml->ml_chunktree[i].mlcs_totalsize += size;
+  }
+}
+
+/// Find the chunk containing line "lnum" (when not zero) or byte "offset"
+/// (when not zero).  The last chunk is returned when the position is beyond
+/// it.
+///
+/// @param ffdos  count one extra byte per line for "offset"
+/// @param[out] curlinep  first line of the found chunk
+/// @param[out] sizep  number of bytes before the found chunk, without the
+///                    extra bytes for "ffdos"
+///
+/// @return  index of the chunk
+static int ml_chunk_find(buf_T *buf, linenr_T lnum, int offset, int ffdos, linenr_T *curlinep,
+                         int *sizep)
+{
+  memline_T *ml = &buf->b_ml;
+
+  if (!ml->ml_chunktree_valid) {
+    ml_chunktree_build(buf);
+  }
+
+  // Descend the tree, skipping blocks of chunks that end before the
+  // position.  Like the last chunk, never skip past it.
+  int n = ml->ml_usedchunks - 1;
+  int pos = 0;
+  int lines = 0;
+  int size = 0;
+  int step = 1;
+  while (step * 2 <= n) {
+    step *= 2;
+  }
+  for (; step > 0; step /= 2) {
+    int next = pos + step;
+    if (next > n) {
+      continue;
+    }
+    int next_lines = lines + ml->ml_chunktree[next].mlcs_numlines;
+    int next_size = size + ml->ml_chunktree[next].mlcs_totalsize;
+    if ((lnum != 0 && lnum >= next_lines + 1)
+        || (offset != 0 && offset > next_size + ffdos * next_lines)) {
+      pos = next;
+      lines = next_lines;
+      size = next_size;
+    }
+  }
+
+  *curlinep = lines + 1;
+  *sizep = size;
+  return pos;
+}
+
 /// Keep information for finding byte offset of a line
 ///
 /// @param updtype  may be one of:
@@ -3710,6 +3882,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+    buf->b_ml.ml_chunktree_valid = false;
   }
 
   if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1) {
@@ -3717,6 +3890,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = (int)strlen(buf->b_ml.ml_line_ptr) + 1;
+    buf->b_ml.ml_chunktree_valid = false;
     return;
   }
 
@@ -3724,13 +3898,8 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
   // chunk.
   if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
       || updtype != ML_CHNK_ADDLINE) {
-    for (curline = 1, curix = 0;
-         curix < buf->b_ml.ml_usedchunks - 1
-         && line >= curline +
-         buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-         curix++) {
-      curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
+    int size_before;
+    curix = ml_chunk_find(buf, line, 0, 0, &curline, &size_before);
   } else if (curix < buf->b_ml.ml_usedchunks - 1
              && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines) {
     // Adjust cached curix & curline
@@ -3743,10 +3912,12 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     len = -len;
   }
   curchnk->mlcs_totalsize += len;
+  ml_chunktree_add(buf, curix, 0, len);
   if (updtype == ML_CHNK_ADDLINE) {
     int rest;
     DataBlock *dp;
     curchnk->mlcs_numlines++;
+    ml_chunktree_add(buf, curix, 1, 0);
 
     // May resize here so we don't have to do it in both cases below
     if (buf->b_ml.ml_usedchunks + 1 >= buf->b_ml.ml_numchunks) {
@@ -3796,6 +3967,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       buf->b_ml.ml_chunksize[curix].mlcs_totalsize = size;
       buf->b_ml.ml_chunksize[curix + 1].mlcs_totalsize -= size;
       buf->b_ml.ml_usedchunks++;
+      buf->b_ml.ml_chunktree_valid = false;
       ml_upd_lastbuf = NULL;         // Force recalc of curix & curline
       return;
     } else if (buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MINL
@@ -3805,6 +3977,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       // after this. Do it now to avoid the loop above later on
       curchnk = buf->b_ml.ml_chunksize + curix + 1;
       buf->b_ml.ml_usedchunks++;
+      buf->b_ml.ml_chunktree_valid = false;
       if (line == buf->b_ml.ml_line_count) {
         curchnk->mlcs_numlines = 0;
         curchnk->mlcs_totalsize = 0;
@@ -3831,6 +4004,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     }
   } else if (updtype == ML_CHNK_DELLINE) {
     curchnk->mlcs_numlines--;
+    ml_chunktree_add(buf, curix, -1, 0);
     ml_upd_lastbuf = NULL;       // Force recalc of curix & curline
     if (curix < (buf->b_ml.ml_usedchunks - 1)
         && (curchnk->mlcs_numlines + curchnk[1].mlcs_numlines)
@@ -3841,6 +4015,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       buf->b_ml.ml_usedchunks--;
       memmove(buf->b_ml.ml_chunksize, buf->b_ml.ml_chunksize + 1,
               (size_t)buf->b_ml.ml_usedchunks * sizeof(chunksize_T));
+      buf->b_ml.ml_chunktree_valid = false;
       return;
     } else if (curix == 0 || (curchnk->mlcs_numlines > 10
                               && (curchnk->mlcs_numlines +
@@ -3853,6 +4028,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     curchnk[-1].mlcs_numlines += curchnk->mlcs_numlines;
     curchnk[-1].mlcs_totalsize += curchnk->mlcs_totalsize;
     buf->b_ml.ml_usedchunks--;
+    buf->b_ml.ml_chunktree_valid = false;
     if (curix < buf->b_ml.ml_usedchunks) {
       memmove(buf->b_ml.ml_chunksize + curix,
               buf->b_ml.ml_chunksize + curix + 1,
@@ -3920,24 +4096,13 @@ int ml_find_line_or_offset(buf_T *buf, linenr_T lnum, int *offp, bool no_ff)
   if (lnum == 0 && offset <= 0) {
     return 1;       // Not a "find offset" and offset 0 _must_ be in line 1
   }
-  // Find the last chunk before the one containing our line. Last chunk is
-  // special because it will never qualify
-  linenr_T curline = 1;
-  int curix = 0;
-  int size = 0;
-  while (curix < buf->b_ml.ml_usedchunks - 1
-         && ((lnum != 0
-              && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
-             || (offset != 0
-                 && offset > size +
-                 buf->b_ml.ml_chunksize[curix].mlcs_totalsize
-                 + ffdos * buf->b_ml.ml_chunksize[curix].mlcs_numlines))) {
-    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    size += buf->b_ml.ml_chunksize[curix].mlcs_totalsize;
-    if (offset && ffdos) {
-      size += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
-    curix++;
+  // Find the chunk containing our line. Last chunk is special because it
+  // will never qualify
+  linenr_T curline;
+  int size;
+  ml_chunk_find(buf, lnum, offset, ffdos, &curline, &size);
+  if (offset && ffdos) {
+    size += curline - 1;
   }
 
   while ((lnum != 0 && curline < lnum) || (offset != 0 && size < offset)) {
@@ -67,4 +67,10 @@ typedef struct memline {
   chunksize_T *ml_chunksize;
   int ml_numchunks;
   int ml_usedchunks;
+
+  // Fenwick tree over ml_chunksize, for finding the chunk of a line or byte
+  // offset in O(log n).  Rebuilt lazily when chunks are split or merged.
+  chunksize_T *ml_chunktree;    // 1-based, ml_chunktree_len entries
+  int ml_chunktree_len;
+  bool ml_chunktree_valid;
 } memline_T;
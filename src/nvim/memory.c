@@ -7,12 +7,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#ifdef SLAB_ALLOC
+# include <uv.h>
+#endif
 
 #include "nvim/api/extmark.h"
 #include "nvim/api/private/helpers.h"
 #include "nvim/api/ui.h"
 #include "nvim/arglist.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/atomic_defs.h"
 #include "nvim/buffer_updates.h"
 #include "nvim/channel.h"
 #include "nvim/context.h"
@@ -33,6 +37,7 @@
 #include "nvim/message.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/input.h"
+#include "nvim/os/os_defs.h"
 #include "nvim/sign.h"
 #include "nvim/state_defs.h"
 #include "nvim/statusline.h"
@@ -58,6 +63,269 @@ MemRealloc mem_realloc = &realloc;
 # include "memory.c.generated.h"
 #endif
 
+/// Number of allocations made while counting is enabled, see alloc_count_enable().
+/// Worker threads allocate too, hence the atomic updates.
+static int64_t alloc_count = 0;
+static bool alloc_count_enabled = false;
+
+/// Starts or stops counting allocations. Only used for --startuptime, so that
+/// the normal allocation path pays for a single relaxed load.
+void alloc_count_enable(bool enable)
+{
+  ATOMIC_STORE_BOOL(&alloc_count_enabled, enable);
+}
+
+/// @return the number of allocations counted so far
+int64_t alloc_count_get(void)
+{
+  return ATOMIC_LOAD(&alloc_count);
+}
+
+static inline void alloc_count_inc(void)
+{
+  if (ATOMIC_LOAD_BOOL(&alloc_count_enabled)) {
+    ATOMIC_INC(&alloc_count);
+  }
+}
+
+#ifdef SLAB_ALLOC
+// Small-object allocator, enabled with the ENABLE_SLAB_ALLOC build option so
+// that it can be compared with the system allocator.
+//
+// Allocations of the main thread up to SLAB_MAX_SIZE bytes are taken from
+// chunks that are each split into objects of one size class.  A free object
+// holds the pointer to the next free object of its class.  Other threads use
+// the system allocator.  When another thread frees a slab object, it is put
+// in a locked list that the main thread takes over on its next allocation.
+//
+// xfree() finds out whether a pointer is a slab object by looking up the
+// chunk it is in, thus memory from elsewhere can still be passed to it.
+
+enum {
+  SLAB_ALIGN = 16,                             ///< object sizes are a multiple of this
+  SLAB_MAX_SIZE = 256,                         ///< largest object size
+  SLAB_NCLASSES = SLAB_MAX_SIZE / SLAB_ALIGN,  ///< number of size classes
+  SLAB_CHUNK_SIZE = 64 * 1024,                 ///< size of a chunk
+};
+
+typedef struct {
+  char *base;     ///< start of the chunk
+  uint8_t class;  ///< size class of the objects in the chunk
+} SlabChunk;
+
+typedef struct {
+  void *free;      ///< list of free objects
+  char *bump;      ///< next never used object in the newest chunk
+  char *bump_end;  ///< end of the newest chunk
+} SlabClass;
+
+static bool slab_enabled = false;
+static uv_thread_t slab_thread;  ///< the thread that uses the slabs
+static SlabClass slab_classes[SLAB_NCLASSES];
+
+/// Chunks sorted on their address.  Only changed by the main thread while
+/// holding "slab_mutex", other threads hold it when looking up a pointer.
+static SlabChunk *slab_chunks = NULL;
+static size_t slab_nchunks = 0;
+static size_t slab_chunks_cap = 0;
+static char *slab_lo = NULL;  ///< lowest chunk address
+static char *slab_hi = NULL;  ///< end of the highest chunk
+
+/// Objects freed by other threads, protected by "slab_mutex".
+static uv_mutex_t slab_mutex;
+static void *slab_remote = NULL;
+static bool slab_remote_pending = false;
+
+static SlabStats slab_stats = { 0, 0, 0, 0, 0 };
+
+/// Enables the slab allocator for the calling thread.  Must be called before
+/// other threads are started.
+void slab_init(void)
+{
+  uv_mutex_init(&slab_mutex);
+  slab_thread = uv_thread_self();
+  slab_enabled = true;
+}
+
+static inline bool slab_is_main_thread(void)
+{
+  uv_thread_t self = uv_thread_self();
+  return slab_enabled && uv_thread_equal(&slab_thread, &self);
+}
+
+/// @return  the chunk "ptr" is in, or NULL when it is not a slab object.
+static SlabChunk *slab_find_chunk(const void *ptr)
+{
+  const char *p = ptr;
+  if (p < slab_lo || p >= slab_hi) {
+    return NULL;
+  }
+  size_t lo = 0;
+  size_t hi = slab_nchunks;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (slab_chunks[mid].base <= p) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0 || p >= slab_chunks[lo - 1].base + SLAB_CHUNK_SIZE) {
+    return NULL;
+  }
+  return &slab_chunks[lo - 1];
+}
+
+/// Adds a new chunk for size class "class".
+///
+/// @return  false when out of memory.
+static bool slab_add_chunk(int class)
+{
+  char *base = malloc(SLAB_CHUNK_SIZE);
+  if (base == NULL) {
+    return false;
+  }
+  uv_mutex_lock(&slab_mutex);
+  if (slab_nchunks == slab_chunks_cap) {
+    size_t cap = slab_chunks_cap == 0 ? 64 : slab_chunks_cap * 2;
+    SlabChunk *chunks = realloc(slab_chunks, cap * sizeof(*chunks));
+    if (chunks == NULL) {
+      uv_mutex_unlock(&slab_mutex);
+      free(base);
+      return false;
+    }
+    slab_chunks = chunks;
+    slab_chunks_cap = cap;
+  }
+  size_t i = slab_nchunks;
+  while (i > 0 && slab_chunks[i - 1].base > base) {
+    i--;
+  }
+  memmove(slab_chunks + i + 1, slab_chunks + i, (slab_nchunks - i) * sizeof(*slab_chunks));
+  slab_chunks[i] = (SlabChunk){ .base = base, .class = (uint8_t)class };
+  slab_nchunks++;
+  if (slab_lo == NULL || base < slab_lo) {
+    slab_lo = base;
+  }
+  if (slab_hi == NULL || base + SLAB_CHUNK_SIZE > slab_hi) {
+    slab_hi = base + SLAB_CHUNK_SIZE;
+  }
+  uv_mutex_unlock(&slab_mutex);
+
+  slab_classes[class].bump = base;
+  slab_classes[class].bump_end = base + SLAB_CHUNK_SIZE;
+  return true;
+}
+
+/// Puts the objects freed by other threads back in their free lists.
+static void slab_take_remote(void)
+{
+  uv_mutex_lock(&slab_mutex);
+  void *obj = slab_remote;
+  slab_remote = NULL;
+  ATOMIC_STORE_BOOL(&slab_remote_pending, false);
+  uv_mutex_unlock(&slab_mutex);
+
+  while (obj != NULL) {
+    void *next = *(void **)obj;
+    SlabClass *sc = &slab_classes[slab_find_chunk(obj)->class];
+    *(void **)obj = sc->free;
+    sc->free = obj;
+    obj = next;
+  }
+}
+
+/// Allocates "size" bytes from the slabs.
+///
+/// @return  NULL when "size" is too big, when not called from the main thread
+///          or when out of memory.
+static void *slab_alloc(size_t size)
+{
+  if (size > SLAB_MAX_SIZE || !slab_is_main_thread()) {
+    return NULL;
+  }
+  if (ATOMIC_LOAD_BOOL(&slab_remote_pending)) {
+    slab_take_remote();
+  }
+  int class = (int)((size + SLAB_ALIGN - 1) / SLAB_ALIGN) - 1;
+  SlabClass *sc = &slab_classes[class];
+  void *ret = sc->free;
+  if (ret != NULL) {
+    sc->free = *(void **)ret;
+  } else {
+    size_t objsize = (size_t)(class + 1) * SLAB_ALIGN;
+    if ((size_t)(sc->bump_end - sc->bump) < objsize && !slab_add_chunk(class)) {
+      return NULL;
+    }
+    ret = sc->bump;
+    sc->bump += objsize;
+  }
+  slab_stats.alloc++;
+  return ret;
+}
+
+/// @return  the size of the slab object "ptr", zero when it is not one.
+static size_t slab_size(const void *ptr)
+{
+  if (!slab_enabled) {
+    return 0;
+  }
+  bool main_thread = slab_is_main_thread();
+  if (!main_thread) {
+    uv_mutex_lock(&slab_mutex);
+  }
+  SlabChunk *chunk = slab_find_chunk(ptr);
+  size_t size = chunk == NULL ? 0 : (size_t)(chunk->class + 1) * SLAB_ALIGN;
+  if (!main_thread) {
+    uv_mutex_unlock(&slab_mutex);
+  }
+  return size;
+}
+
+/// Frees "ptr" when it is a slab object.
+///
+/// @return  false when "ptr" is not a slab object.
+static bool slab_free(void *ptr)
+{
+  if (!slab_enabled || ptr == NULL) {
+    return false;
+  }
+  if (slab_is_main_thread()) {
+    SlabChunk *chunk = slab_find_chunk(ptr);
+    if (chunk == NULL) {
+      return false;
+    }
+    SlabClass *sc = &slab_classes[chunk->class];
+    *(void **)ptr = sc->free;
+    sc->free = ptr;
+    slab_stats.free++;
+    return true;
+  }
+
+  uv_mutex_lock(&slab_mutex);
+  bool found = slab_find_chunk(ptr) != NULL;
+  if (found) {
+    *(void **)ptr = slab_remote;
+    slab_remote = ptr;
+    slab_stats.remote_free++;
+    ATOMIC_STORE_BOOL(&slab_remote_pending, true);
+  }
+  uv_mutex_unlock(&slab_mutex);
+  return found;
+}
+
+/// @return  statistics of the slab allocator, for nvim__stats().
+SlabStats slab_stats_get(void)
+{
+  uv_mutex_lock(&slab_mutex);
+  SlabStats stats = slab_stats;
+  uv_mutex_unlock(&slab_mutex);
+  stats.chunks = (int64_t)slab_nchunks;
+  stats.bytes = (int64_t)(slab_nchunks * SLAB_CHUNK_SIZE);
+  return stats;
+}
+#endif
+
 #ifdef EXITFREE
 bool entered_free_all_mem = false;
 #endif
@@ -94,6 +362,13 @@ void try_to_free_memory(void)
 void *try_malloc(size_t size) FUNC_ATTR_MALLOC FUNC_ATTR_ALLOC_SIZE(1)
 {
   size_t allocated_size = size ? size : 1;
+  alloc_count_inc();
+#ifdef SLAB_ALLOC
+  void *slab = slab_alloc(allocated_size);
+  if (slab != NULL) {
+    return slab;
+  }
+#endif
   void *ret = malloc(allocated_size);
   if (!ret) {
     try_to_free_memory();
@@ -140,6 +415,11 @@ void *xmalloc(size_t size)
 /// @note Use XFREE_CLEAR() instead, if possible.
 void xfree(void *ptr)
 {
+#ifdef SLAB_ALLOC
+  if (slab_free(ptr)) {
+    return;
+  }
+#endif
   free(ptr);
 }
 
@@ -154,6 +434,15 @@ void *xcalloc(size_t count, size_t size)
 {
   size_t allocated_count = count && size ? count : 1;
   size_t allocated_size = count && size ? size : 1;
+  alloc_count_inc();
+#ifdef SLAB_ALLOC
+  if (allocated_size <= SLAB_MAX_SIZE / allocated_count) {
+    void *slab = slab_alloc(allocated_count * allocated_size);
+    if (slab != NULL) {
+      return memset(slab, 0, allocated_count * allocated_size);
+    }
+  }
+#endif
   void *ret = calloc(allocated_count, allocated_size);
   if (!ret) {
     try_to_free_memory();
@@ -174,6 +463,21 @@ void *xrealloc(void *ptr, size_t size)
   FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_ALLOC_SIZE(2) FUNC_ATTR_NONNULL_RET
 {
   size_t allocated_size = size ? size : 1;
+#ifdef SLAB_ALLOC
+  // A slab object keeps its place while the size class fits, otherwise it is
+  // moved.  The system allocator does not know about slab objects.
+  size_t slab_old = ptr != NULL ? slab_size(ptr) : 0;
+  if (slab_old != 0) {
+    if (allocated_size <= slab_old && allocated_size > slab_old - SLAB_ALIGN) {
+      return ptr;
+    }
+    void *moved = xmalloc(allocated_size);
+    memcpy(moved, ptr, MIN(slab_old, allocated_size));
+    xfree(ptr);
+    return moved;
+  }
+#endif
+  alloc_count_inc();
   void *ret = realloc(ptr, allocated_size);
   if (!ret) {
     try_to_free_memory();
@@ -556,16 +860,50 @@ void time_to_bytes(time_t time_, uint8_t buf[8])
 #define ARENA_BLOCK_SIZE 4096
 #define REUSE_MAX 4
 
-static struct consumed_blk *arena_reuse_blk;
-static size_t arena_reuse_blk_count = 0;
+// An arena that needed this many blocks is probably building a bulk payload,
+// such as a large RPC message: further blocks are ARENA_BULK_BLOCK_SIZE.
+#define ARENA_BULK_AFTER 4
+#define ARENA_BULK_BLOCK_SIZE (64 * 1024)
+#define REUSE_BULK_MAX 2
+
+/// Freed blocks kept for reuse, for each block size.
+static struct {
+  size_t size;
+  size_t max;
+  struct consumed_blk *blk;
+  size_t count;
+} arena_reuse[] = {
+  { ARENA_BLOCK_SIZE, REUSE_MAX, NULL, 0 },
+  { ARENA_BULK_BLOCK_SIZE, REUSE_BULK_MAX, NULL, 0 },
+};
 
 static void arena_free_reuse_blks(void)
 {
-  while (arena_reuse_blk_count > 0) {
-    struct consumed_blk *blk = arena_reuse_blk;
-    arena_reuse_blk = arena_reuse_blk->prev;
-    xfree(blk);
-    arena_reuse_blk_count--;
+  for (size_t i = 0; i < ARRAY_SIZE(arena_reuse); i++) {
+    while (arena_reuse[i].count > 0) {
+      struct consumed_blk *blk = arena_reuse[i].blk;
+      arena_reuse[i].blk = blk->prev;
+      xfree(blk);
+      arena_reuse[i].count--;
+    }
+  }
+}
+
+static void arena_bytes_add(size_t size)
+{
+  arena_bytes += size;
+  if (arena_bytes > arena_peak_bytes) {
+    arena_peak_bytes = arena_bytes;
+  }
+}
+
+/// Tell "arena" that about "size" more bytes will be allocated from it.
+/// When that is a lot, use large blocks right away, instead of many small
+/// ones.
+void arena_size_hint(Arena *arena, size_t size)
+{
+  if (size > ARENA_BLOCK_SIZE) {
+    arena->blk_size = ARENA_BULK_BLOCK_SIZE;
   }
 }
 
@@ -585,18 +923,32 @@ ArenaMem arena_finish(Arena *arena)
 void alloc_block(Arena *arena)
 {
   struct consumed_blk *prev_blk = (struct consumed_blk *)arena->cur_blk;
-  if (arena_reuse_blk_count > 0) {
-    arena->cur_blk = (char *)arena_reuse_blk;
-    arena_reuse_blk = arena_reuse_blk->prev;
-    arena_reuse_blk_count--;
-  } else {
+  if (arena->nblocks >= ARENA_BULK_AFTER) {
+    arena->blk_size = ARENA_BULK_BLOCK_SIZE;
+  }
+  size_t size = arena->blk_size ? arena->blk_size : ARENA_BLOCK_SIZE;
+  struct consumed_blk *blk = NULL;
+  for (size_t i = 0; i < ARRAY_SIZE(arena_reuse); i++) {
+    if (arena_reuse[i].size == size && arena_reuse[i].count > 0) {
+      blk = arena_reuse[i].blk;
+      arena_reuse[i].blk = blk->prev;
+      arena_reuse[i].count--;
+      arena_reuse_count++;
+      break;
+    }
+  }
+  if (blk == NULL) {
     arena_alloc_count++;
-    arena->cur_blk = xmalloc(ARENA_BLOCK_SIZE);
+    blk = xmalloc(size);
   }
+  arena_bytes_add(size);
+  arena->nblocks++;
+  arena->cur_blk = (char *)blk;
   arena->pos = 0;
-  arena->size = ARENA_BLOCK_SIZE;
-  struct consumed_blk *blk = arena_alloc(arena, sizeof(struct consumed_blk), true);
+  arena->size = size;
+  (void)arena_alloc(arena, sizeof(struct consumed_blk), true);
   blk->prev = prev_blk;
+  blk->size = size;
 }
 
 static size_t arena_align_offset(uint64_t off)
@@ -618,7 +970,7 @@ void *arena_alloc(Arena *arena, size_t size, bool align)
   }
   size_t alloc_pos = align ? arena_align_offset(arena->pos) : arena->pos;
   if (alloc_pos + size > arena->size) {
-    if (size > (ARENA_BLOCK_SIZE - sizeof(struct consumed_blk)) >> 1) {
+    if (size > (arena->size - sizeof(struct consumed_blk)) >> 1) {
       // if allocation is too big, allocate a large block with the requested
       // size, but still with block pointer head. We do this even for
       // arena->size / 2, as there likely is space left for the next
@@ -627,12 +979,14 @@ void *arena_alloc(Arena *arena, size_t size, bool align)
       size_t hdr_size = sizeof(struct consumed_blk);
       size_t aligned_hdr_size = (align ? arena_align_offset(hdr_size) : hdr_size);
       char *alloc = xmalloc(size + aligned_hdr_size);
+      arena_bytes_add(size + aligned_hdr_size);
 
       // to simplify free-list management, arena->cur_blk must
-      // always be a normal, ARENA_BLOCK_SIZE sized, block
+      // always be a normal block, of one of the sizes that is reused
       struct consumed_blk *cur_blk = (struct consumed_blk *)arena->cur_blk;
       struct consumed_blk *fix_blk = (struct consumed_blk *)alloc;
       fix_blk->prev = cur_blk->prev;
+      fix_blk->size = size + aligned_hdr_size;
       cur_blk->prev = fix_blk;
       return alloc + aligned_hdr_size;
     } else {
@@ -649,19 +1003,22 @@ void *arena_alloc(Arena *arena, size_t size, bool align)
 void arena_mem_free(ArenaMem mem)
 {
   struct consumed_blk *b = mem;
-  // peel of the first block, as it is guaranteed to be ARENA_BLOCK_SIZE,
-  // not a custom fix_blk
-  if (arena_reuse_blk_count < REUSE_MAX && b != NULL) {
-    struct consumed_blk *reuse_blk = b;
-    b = b->prev;
-    reuse_blk->prev = arena_reuse_blk;
-    arena_reuse_blk = reuse_blk;
-    arena_reuse_blk_count++;
-  }
-
+  // Keep blocks of the normal sizes for reuse, as long as there is room.
   while (b) {
     struct consumed_blk *prev = b->prev;
-    xfree(b);
+    arena_bytes -= b->size;
+    size_t i = 0;
+    while (i < ARRAY_SIZE(arena_reuse)
+           && (arena_reuse[i].size != b->size || arena_reuse[i].count >= arena_reuse[i].max)) {
+      i++;
+    }
+    if (i < ARRAY_SIZE(arena_reuse)) {
+      b->prev = arena_reuse[i].blk;
+      arena_reuse[i].blk = b;
+      arena_reuse[i].count++;
+    } else {
+      xfree(b);
+    }
     b = prev;
   }
 }
@@ -686,6 +1043,7 @@ char *arena_memdupz(Arena *arena, const char *buf, size_t size)
 # include "nvim/file_search.h"
 # include "nvim/getchar.h"
 # include "nvim/grid.h"
+# include "nvim/lua/xdiff.h"
 # include "nvim/mark.h"
 # include "nvim/msgpack_rpc/channel.h"
 # include "nvim/msgpack_rpc/helpers.h"
@@ -696,6 +1054,7 @@ char *arena_memdupz(Arena *arena, const char *buf, size_t size)
 # include "nvim/regexp.h"
 # include "nvim/search.h"
 # include "nvim/spell.h"
+# include "nvim/strings.h"
 # include "nvim/tag.h"
 # include "nvim/window.h"
 
@@ -837,8 +1196,10 @@ void free_all_mem(void)
   ctx_free_all();
 
   map_destroy(int, &buffer_handles);
+  free_buffer_names();
   map_destroy(int, &window_handles);
   map_destroy(int, &tabpage_handles);
+  free_interned_strings();
 
   // free screenlines (can't display anything now!)
   grid_free_all_mem();
@@ -860,6 +1221,7 @@ void free_all_mem(void)
   remote_ui_free_all_mem();
   ui_free_all_mem();
   ui_comp_free_all_mem();
+  nlua_xdiff_free_all_mem();
   nlua_free_all_mem();
   rpc_free_all_mem();
   msgpack_rpc_helpers_free_all_mem();
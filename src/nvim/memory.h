@@ -35,12 +35,26 @@ extern MemCalloc mem_calloc;
 extern MemRealloc mem_realloc;
 #endif
 
+#ifdef SLAB_ALLOC
+/// Statistics of the slab allocator, see slab_stats_get().
+typedef struct {
+  int64_t alloc;        ///< objects allocated
+  int64_t free;         ///< objects freed by the main thread
+  int64_t remote_free;  ///< objects freed by other threads
+  int64_t chunks;       ///< number of chunks
+  int64_t bytes;        ///< bytes in all chunks
+} SlabStats;
+#endif
+
 #ifdef EXITFREE
 /// Indicates that free_all_mem function was or is running
 extern bool entered_free_all_mem;
 #endif
 
-EXTERN size_t arena_alloc_count INIT( = 0);
+EXTERN size_t arena_alloc_count INIT( = 0);  ///< arena blocks allocated
+EXTERN size_t arena_reuse_count INIT( = 0);  ///< arena blocks taken from the reuse lists
+EXTERN size_t arena_bytes INIT( = 0);        ///< bytes in blocks of live arenas
+EXTERN size_t arena_peak_bytes INIT( = 0);   ///< highest value of "arena_bytes"
 
 #define kv_fixsize_arena(a, v, s) \
   ((v).capacity = (s), \
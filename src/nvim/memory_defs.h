@@ -4,12 +4,15 @@
 
 typedef struct consumed_blk {
   struct consumed_blk *prev;
+  size_t size;  ///< size of the block, including this header
 } *ArenaMem;
 
 typedef struct {
   char *cur_blk;
   size_t pos, size;
+  size_t nblocks;   ///< number of blocks allocated for the arena
+  size_t blk_size;  ///< size of the next block, zero for the default
 } Arena;
 
 // inits an empty arena.
-#define ARENA_EMPTY { .cur_blk = NULL, .pos = 0, .size = 0 }
+#define ARENA_EMPTY { .cur_blk = NULL, .pos = 0, .size = 0, .nblocks = 0, .blk_size = 0 }
@@ -2579,6 +2579,15 @@ void msg_sb_eol(void)
   }
 }
 
+/// @return  the start of the line after the line starting at "mp" (can be NULL).
+static msgchunk_T *msg_sb_next_line(msgchunk_T *mp)
+{
+  while (!mp->sb_eol && mp->sb_next != NULL) {
+    mp = mp->sb_next;
+  }
+  return mp->sb_next;
+}
+
 /// Display a screen line from previously displayed text at row "row".
 ///
 /// @return  a pointer to the text for the next line (can be NULL).
@@ -2851,6 +2860,19 @@ static bool do_more_prompt(int typed_char)
           msg_scroll_up(true, false);
           msg_scrolled++;
         }
+        if (toscroll > Rows - 1) {
+          // Lines that would scroll off the screen again before the end of
+          // the scroll are skipped, so that "G" is quick after many lines.
+          msgchunk_T *ahead = mp_last;
+          for (int i = 0; i < Rows - 1 && ahead != NULL; i++) {
+            ahead = msg_sb_next_line(ahead);
+          }
+          while (toscroll > Rows - 1 && ahead != NULL) {
+            mp_last = msg_sb_next_line(mp_last);
+            ahead = msg_sb_next_line(ahead);
+            toscroll--;
+          }
+        }
         while (toscroll > 0 && mp_last != NULL) {
           if (msg_do_throttle() && !msg_grid.throttled) {
             // Tricky: we redraw at one line higher than usual. Therefore
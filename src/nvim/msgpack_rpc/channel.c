@@ -30,6 +30,7 @@
 #include "nvim/msgpack_rpc/helpers.h"
 #include "nvim/msgpack_rpc/unpacker.h"
 #include "nvim/os/input.h"
+#include "nvim/os/time.h"
 #include "nvim/rbuffer.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
@@ -106,9 +107,27 @@ static void log_client_msg(uint64_t channel_id, bool is_request, const char *nam
 # define log_server_msg(...)
 #endif
 
+/// Messages at least this big are passed on without copying "out_buffer".
+#define SBUFFER_PASS_SIZE (64 * 1024)
+
 static Set(cstr_t) event_strings = SET_INIT;
 static msgpack_sbuffer out_buffer;
 
+/// Number of histogram buckets in RpcMethodStats.  Bucket i counts durations
+/// below 2^i microseconds (and at least 2^(i-1)), the last one everything
+/// longer.
+#define RPC_STATS_BUCKETS 28
+
+typedef struct {
+  uint64_t count;
+  uint64_t wait_total, time_total;  ///< in nanoseconds
+  uint64_t wait[RPC_STATS_BUCKETS];  ///< time spent in the event queue
+  uint64_t time[RPC_STATS_BUCKETS];  ///< time spent executing the method
+} RpcMethodStats;
+
+/// Stats of the requests handled so far, by method name.
+static PMap(cstr_t) rpc_stats = MAP_INIT;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "msgpack_rpc/channel.c.generated.h"
 #endif
@@ -130,6 +149,7 @@ void rpc_start(Channel *channel)
   rpc->next_request_id = 1;
   rpc->info = (Dictionary)ARRAY_DICT_INIT;
   kv_init(rpc->call_stack);
+  kv_init(rpc->async_calls);
 
   if (channel->streamtype != kChannelStreamInternal) {
     Stream *out = channel_outstream(channel);
@@ -140,9 +160,27 @@ void rpc_start(Channel *channel)
 #endif
 
     rstream_start(out, receive_msgpack, channel);
+    // The stream is part of the channel, it can't outlive it.
+    wstream_set_write_cb(channel_instream(channel), rpc_write_cb, channel);
   }
 }
 
+static void rpc_write_cb(Stream *stream, void *data, int status)
+{
+  Channel *channel = data;
+  remote_ui_write_done(channel->id, stream->curmem);
+}
+
+/// Number of bytes queued for writing to RPC channel "id".
+size_t rpc_write_queue_size(uint64_t id)
+{
+  Channel *channel = find_rpc_channel(id);
+  if (!channel || channel->streamtype == kChannelStreamInternal) {
+    return 0;
+  }
+  return channel_instream(channel)->curmem;
+}
+
 static Channel *find_rpc_channel(uint64_t id)
 {
   Channel *chan = find_channel(id);
@@ -213,35 +251,104 @@ Object rpc_send_call(uint64_t id, const char *method_name, Array args, ArenaMem
   }
 
   if (frame.errored) {
-    if (frame.result.type == kObjectTypeString) {
-      api_set_error(err, kErrorTypeException, "%s",
-                    frame.result.data.string.data);
-    } else if (frame.result.type == kObjectTypeArray) {
-      // Should be an error in the form [type, message]
-      Array array = frame.result.data.array;
-      if (array.size == 2 && array.items[0].type == kObjectTypeInteger
-          && (array.items[0].data.integer == kErrorTypeException
-              || array.items[0].data.integer == kErrorTypeValidation)
-          && array.items[1].type == kObjectTypeString) {
-        api_set_error(err, (ErrorType)array.items[0].data.integer, "%s",
-                      array.items[1].data.string.data);
-      } else {
-        api_set_error(err, kErrorTypeException, "%s", "unknown error");
-      }
+    call_frame_error(&frame, err);
+  }
+
+  channel_decref(channel);
+
+  *result_mem = frame.result_mem;
+
+  return frame.errored ? NIL : frame.result;
+}
+
+/// Sets "err" from the error response of "frame" and frees the response.
+static void call_frame_error(ChannelCallFrame *frame, Error *err)
+{
+  if (frame->result.type == kObjectTypeString) {
+    api_set_error(err, kErrorTypeException, "%s",
+                  frame->result.data.string.data);
+  } else if (frame->result.type == kObjectTypeArray) {
+    // Should be an error in the form [type, message]
+    Array array = frame->result.data.array;
+    if (array.size == 2 && array.items[0].type == kObjectTypeInteger
+        && (array.items[0].data.integer == kErrorTypeException
+            || array.items[0].data.integer == kErrorTypeValidation)
+        && array.items[1].type == kObjectTypeString) {
+      api_set_error(err, (ErrorType)array.items[0].data.integer, "%s",
+                    array.items[1].data.string.data);
     } else {
       api_set_error(err, kErrorTypeException, "%s", "unknown error");
     }
+  } else {
+    api_set_error(err, kErrorTypeException, "%s", "unknown error");
+  }
 
-    // frame.result was allocated in an arena
-    arena_mem_free(frame.result_mem);
-    frame.result_mem = NULL;
+  // frame->result was allocated in an arena
+  arena_mem_free(frame->result_mem);
+  frame->result_mem = NULL;
+}
+
+/// Sends a request like rpc_send_call(), but doesn't wait for the response.
+/// Instead "cb" is invoked from the channel's event queue when it arrives,
+/// or when the channel is closed first.
+///
+/// @param id The channel id
+/// @param method_name The method name, an arbitrary string
+/// @param args Array with method arguments, freed by this function
+/// @param cb Callback invoked with the result or the error
+/// @param data Passed to "cb"
+/// @return false if the channel is invalid, then "cb" is not invoked
+bool rpc_send_call_async(uint64_t id, const char *method_name, Array args, rpc_response_cb cb,
+                         void *data)
+{
+  Channel *channel = find_rpc_channel(id);
+  if (!channel) {
+    api_free_array(args);
+    return false;
   }
 
-  channel_decref(channel);
+  channel_incref(channel);
+  RpcState *rpc = &channel->rpc;
+  ChannelCallFrame *frame = xcalloc(1, sizeof(ChannelCallFrame));
+  frame->request_id = rpc->next_request_id++;
+  frame->result = NIL;
+  frame->cb = cb;
+  frame->cb_data = data;
+  kv_push(rpc->async_calls, frame);
+  send_request(channel, frame->request_id, method_name, args);
+  api_free_array(args);
+  return true;
+}
 
-  *result_mem = frame.result_mem;
+/// Takes the asynchronous request "request_id" off the pending list.
+static ChannelCallFrame *take_async_call(RpcState *rpc, uint32_t request_id)
+{
+  for (size_t i = 0; i < kv_size(rpc->async_calls); i++) {
+    ChannelCallFrame *frame = kv_A(rpc->async_calls, i);
+    if (frame->request_id == request_id) {
+      kv_A(rpc->async_calls, i) = kv_last(rpc->async_calls);
+      (void)kv_pop(rpc->async_calls);
+      return frame;
+    }
+  }
+  return NULL;
+}
 
-  return frame.errored ? NIL : frame.result;
+static void async_call_event(void **argv)
+{
+  Channel *channel = argv[0];
+  ChannelCallFrame *frame = argv[1];
+  Error err = ERROR_INIT;
+  if (!frame->returned) {
+    api_set_error(&err, kErrorTypeException, "Invalid channel: %" PRIu64, channel->id);
+  } else if (frame->errored) {
+    call_frame_error(frame, &err);
+  }
+  frame->cb(ERROR_SET(&err) ? NIL : frame->result, &err, frame->cb_data);
+  arena_mem_free(frame->result_mem);
+  api_clear_error(&err);
+  channel_decref(channel);
+  xfree(frame);
 }
 
 /// Subscribes to event broadcasts
@@ -334,6 +441,15 @@ static void parse_msgpack(Channel *channel)
       }
       arena_mem_free(arena_finish(&p->arena));
     } else if (p->type == kMessageTypeResponse) {
+      ChannelCallFrame *async = take_async_call(&channel->rpc, p->request_id);
+      if (async) {
+        async->returned = true;
+        async->errored = (p->error.type != kObjectTypeNil);
+        async->result = async->errored ? p->error : p->result;
+        async->result_mem = arena_finish(&p->arena);
+        multiqueue_put(channel->events, async_call_event, channel, async);
+        continue;
+      }
       ChannelCallFrame *frame = channel->rpc.client_type == kClientTypeMsgpackRpc
                                 ? find_call_frame(&channel->rpc, p->request_id)
                                 : kv_last(channel->rpc.call_stack);
@@ -397,6 +513,7 @@ static void handle_request(Channel *channel, Unpacker *p, Array args)
   evdata->used_mem = p->arena;
   p->arena = (Arena)ARENA_EMPTY;
   evdata->request_id = p->request_id;
+  evdata->queued_at = os_hrtime();
   channel_incref(channel);
   if (p->handler.fast) {
     bool is_get_mode = p->handler.fn == handle_nvim_get_mode;
@@ -435,7 +552,12 @@ static void request_event(void **argv)
     goto free_ret;
   }
 
+  uint64_t start = os_hrtime();
+  NVIM_PROBE(rpc_request_begin, 2, channel->id, handler.name);
   Object result = handler.fn(channel->id, e->args, &e->used_mem, &error);
+  uint64_t time = os_hrtime() - start;
+  NVIM_PROBE(rpc_request_end, 3, channel->id, handler.name, time);
+  rpc_stats_add(handler.name, start - e->queued_at, time);
   if (e->type == kMessageTypeRequest || ERROR_SET(&error)) {
     // Send the response.
     msgpack_packer response;
@@ -460,6 +582,66 @@ free_ret:
   api_clear_error(&error);
 }
 
+static int rpc_stats_bucket(uint64_t ns)
+{
+  uint64_t us = ns / 1000;
+  int i = 0;
+  while (us > 0 && i < RPC_STATS_BUCKETS - 1) {
+    us >>= 1;
+    i++;
+  }
+  return i;
+}
+
+static void rpc_stats_add(const char *name, uint64_t wait, uint64_t time)
+{
+  ptr_t *ref = pmap_put_ref(cstr_t)(&rpc_stats, name, NULL, NULL);
+  if (*ref == NULL) {
+    *ref = xcalloc(1, sizeof(RpcMethodStats));
+  }
+  RpcMethodStats *stats = *ref;
+  stats->count++;
+  stats->wait_total += wait;
+  stats->time_total += time;
+  stats->wait[rpc_stats_bucket(wait)]++;
+  stats->time[rpc_stats_bucket(time)]++;
+  DLOG("RPC: %s waited %" PRIu64 " us, took %" PRIu64 " us", name, wait / 1000, time / 1000);
+}
+
+static Array rpc_stats_histogram(const uint64_t *buckets)
+{
+  size_t len = RPC_STATS_BUCKETS;
+  while (len > 0 && buckets[len - 1] == 0) {
+    len--;
+  }
+  Array rv = ARRAY_DICT_INIT;
+  for (size_t i = 0; i < len; i++) {
+    ADD(rv, INTEGER_OBJ((Integer)buckets[i]));
+  }
+  return rv;
+}
+
+/// Gets the stats of the RPC requests handled so far.
+///
+/// @see nvim__rpc_stats
+Dictionary rpc_get_stats(void)
+{
+  Dictionary rv = ARRAY_DICT_INIT;
+  const char *name;
+  ptr_t value;
+  map_foreach(&rpc_stats, name, value, {
+    RpcMethodStats *stats = value;
+    Dictionary info = ARRAY_DICT_INIT;
+    PUT(info, "count", INTEGER_OBJ((Integer)stats->count));
+    PUT(info, "wait_total", INTEGER_OBJ((Integer)(stats->wait_total / 1000)));
+    PUT(info, "time_total", INTEGER_OBJ((Integer)(stats->time_total / 1000)));
+    PUT(info, "wait", ARRAY_OBJ(rpc_stats_histogram(stats->wait)));
+    PUT(info, "time", ARRAY_OBJ(rpc_stats_histogram(stats->time)));
+    PUT(rv, name, DICTIONARY_OBJ(info));
+  });
+  return rv;
+}
+
 bool rpc_write_raw(uint64_t id, WBuffer *buffer)
 {
   Channel *channel = find_rpc_channel(id);
@@ -613,6 +795,11 @@ void rpc_close(Channel *channel)
   }
 
   channel->rpc.closed = true;
+  // Fail the pending asynchronous requests.
+  for (size_t i = 0; i < kv_size(channel->rpc.async_calls); i++) {
+    multiqueue_put(channel->events, async_call_event, channel, kv_A(channel->rpc.async_calls, i));
+  }
+  kv_size(channel->rpc.async_calls) = 0;
   channel_decref(channel);
 
   if (channel->streamtype == kChannelStreamStdio
@@ -633,6 +820,7 @@ void rpc_free(Channel *channel)
 
   set_destroy(cstr_t, channel->rpc.subscribed_events);
   kv_destroy(channel->rpc.call_stack);
+  kv_destroy(channel->rpc.async_calls);
   api_free_dictionary(channel->rpc.info);
 }
 
@@ -656,12 +844,7 @@ static WBuffer *serialize_request(uint64_t channel_id, uint32_t request_id, cons
   msgpack_packer_init(&pac, sbuffer, msgpack_sbuffer_write);
   msgpack_rpc_serialize_request(request_id, method, args, &pac);
   log_server_msg(channel_id, sbuffer);
-  WBuffer *rv = wstream_new_buffer(xmemdup(sbuffer->data, sbuffer->size),
-                                   sbuffer->size,
-                                   refcount,
-                                   xfree);
-  msgpack_sbuffer_clear(sbuffer);
-  return rv;
+  return sbuffer_to_wbuffer(sbuffer, refcount);
 }
 
 static WBuffer *serialize_response(uint64_t channel_id, MsgpackRpcRequestHandler handler,
@@ -689,12 +872,26 @@ static WBuffer *serialize_response(uint64_t channel_id, MsgpackRpcRequestHandler
     msgpack_rpc_serialize_response(response_id, err, arg, &pac);
   }
   log_server_msg(channel_id, sbuffer);
-  WBuffer *rv = wstream_new_buffer(xmemdup(sbuffer->data, sbuffer->size),
-                                   sbuffer->size,
-                                   1,  // responses only go though 1 channel
-                                   xfree);
-  msgpack_sbuffer_clear(sbuffer);
-  return rv;
+  return sbuffer_to_wbuffer(sbuffer, 1);  // responses only go though 1 channel
+}
+
+/// Create a WBuffer with the contents of "sbuffer" and clear it.
+///
+/// A small message is copied, so that "sbuffer" keeps its allocation for the
+/// next message.  The memory of a large message is passed on to the WBuffer
+/// instead, to avoid another copy of a large response, e.g. the results of
+/// nvim_call_atomic() or nvim_buf_get_lines() for many lines.
+static WBuffer *sbuffer_to_wbuffer(msgpack_sbuffer *sbuffer, size_t refcount)
+{
+  size_t size = sbuffer->size;
+  char *data;
+  if (size >= SBUFFER_PASS_SIZE) {
+    data = msgpack_sbuffer_release(sbuffer);
+  } else {
+    data = xmemdup(sbuffer->data, size);
+    msgpack_sbuffer_clear(sbuffer);
+  }
+  return wstream_new_buffer(data, size, refcount, xfree);
 }
 
 void rpc_set_client_info(uint64_t id, Dictionary info)
@@ -759,6 +956,12 @@ void rpc_free_all_mem(void)
   });
   set_destroy(cstr_t, &event_strings);
 
+  ptr_t stats;
+  map_foreach_value(&rpc_stats, stats, {
+    xfree(stats);
+  });
+  map_destroy(cstr_t, &rpc_stats);
+
   msgpack_sbuffer_destroy(&out_buffer);
   multiqueue_free(ch_before_blocking_events);
 }
@@ -24,11 +24,17 @@ typedef enum {
   kClientTypePlugin = 4,
 } ClientType;
 
+/// Called with the response to a request sent by rpc_send_call_async().
+/// "result" is only valid during the call.
+typedef void (*rpc_response_cb)(Object result, Error *err, void *data);
+
 typedef struct {
   uint32_t request_id;
   bool returned, errored;
   Object result;
   ArenaMem result_mem;
+  rpc_response_cb cb;  ///< callback of an asynchronous request
+  void *cb_data;
 } ChannelCallFrame;
 
 typedef struct {
@@ -38,6 +44,7 @@ typedef struct {
   Array args;
   uint32_t request_id;
   Arena used_mem;
+  uint64_t queued_at;  ///< os_hrtime() when the request was received
 } RequestEvent;
 
 typedef struct {
@@ -46,6 +53,7 @@ typedef struct {
   Unpacker *unpacker;
   uint32_t next_request_id;
   kvec_t(ChannelCallFrame *) call_stack;
+  kvec_t(ChannelCallFrame *) async_calls;  ///< requests without a waiting caller
   Dictionary info;
   ClientType client_type;
 } RpcState;
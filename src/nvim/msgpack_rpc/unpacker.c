@@ -156,6 +156,8 @@ static void api_parse_enter(mpack_parser_t *parser, mpack_node_t *node)
 
   case MPACK_TOKEN_ARRAY: {
     Array arr = KV_INITIAL_VALUE;
+    // A long array is a bulk payload, like the lines of nvim_buf_set_lines().
+    arena_size_hint(&p->arena, node->tok.length * sizeof(Object));
     kv_fixsize_arena(&p->arena, arr, node->tok.length);
     kv_size(arr) = node->tok.length;
     *result = ARRAY_OBJ(arr);
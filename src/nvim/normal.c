@@ -1279,7 +1279,9 @@ static void normal_check_cursor_moved(NormalState *s)
   if (!finish_op && has_event(EVENT_CURSORMOVED)
       && (last_cursormoved_win != curwin
           || !equalpos(last_cursormoved, curwin->w_cursor))) {
-    apply_autocmds(EVENT_CURSORMOVED, NULL, NULL, false, curbuf);
+    if (has_event_buf(EVENT_CURSORMOVED, curbuf)) {
+      apply_autocmds(EVENT_CURSORMOVED, NULL, NULL, false, curbuf);
+    }
     last_cursormoved_win = curwin;
     last_cursormoved = curwin->w_cursor;
   }
@@ -1290,7 +1292,9 @@ static void normal_check_text_changed(NormalState *s)
   // Trigger TextChanged if changedtick differs.
   if (!finish_op && has_event(EVENT_TEXTCHANGED)
       && curbuf->b_last_changedtick != buf_get_changedtick(curbuf)) {
-    apply_autocmds(EVENT_TEXTCHANGED, NULL, NULL, false, curbuf);
+    if (has_event_buf(EVENT_TEXTCHANGED, curbuf)) {
+      apply_autocmds(EVENT_TEXTCHANGED, NULL, NULL, false, curbuf);
+    }
     curbuf->b_last_changedtick = buf_get_changedtick(curbuf);
   }
 }
@@ -1300,7 +1304,9 @@ static void normal_check_buffer_modified(NormalState *s)
   // Trigger BufModified if b_modified changed
   if (!finish_op && has_event(EVENT_BUFMODIFIEDSET)
       && curbuf->b_changed_invalid == true) {
-    apply_autocmds(EVENT_BUFMODIFIEDSET, NULL, NULL, false, curbuf);
+    if (has_event_buf(EVENT_BUFMODIFIEDSET, curbuf)) {
+      apply_autocmds(EVENT_BUFMODIFIEDSET, NULL, NULL, false, curbuf);
+    }
     curbuf->b_changed_invalid = false;
   }
 }
@@ -1448,8 +1454,7 @@ static int normal_check(VimState *state)
     if (time_fd != NULL) {
       TIME_MSG("first screen update");
       TIME_MSG("--- NVIM STARTED ---");
-      fclose(time_fd);
-      time_fd = NULL;
+      time_finish();
     }
     // After the first screen update may start triggering WinScrolled
     // autocmd events.  Store all the scroll positions and sizes now.
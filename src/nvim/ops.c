@@ -53,6 +53,7 @@
 #include "nvim/os/time.h"
 #include "nvim/plines.h"
 #include "nvim/search.h"
+#include "nvim/shada.h"
 #include "nvim/state.h"
 #include "nvim/strings.h"
 #include "nvim/terminal.h"
@@ -508,9 +509,8 @@ static void shift_block(oparg_T *oap, int amount)
     // Note that STRMOVE() copies the trailing NUL.
     STRMOVE(newp + verbatim_diff + fill, non_white);
   }
-  // replace the line
+  // replace the line, op_shift() calls changed_lines() for all of them
   ml_replace(curwin->w_cursor.lnum, newp, false);
-  changed_bytes(curwin->w_cursor.lnum, bd.textcol);
   extmark_splice_cols(curbuf, (int)curwin->w_cursor.lnum - 1, startcol,
                       oldlen, newlen,
                       kExtmarkUndo);
@@ -648,6 +648,10 @@ void op_reindent(oparg_T *oap, Indenter how)
   if (u_savecommon(curbuf, start_lnum - 1, start_lnum + oap->line_count,
                    start_lnum + oap->line_count, false) == OK) {
     int amount;
+    if (how == get_c_indent) {
+      // Lines are indented top to bottom and only their indent changes.
+      cin_brace_cache_start();
+    }
     for (i = oap->line_count - 1; i >= 0 && !got_int; i--) {
       // it's a slow thing to do, so give feedback so there's no worry
       // that the computer's just hung.
@@ -666,6 +670,7 @@ void op_reindent(oparg_T *oap, Indenter how)
         if (*l == NUL) {                      // empty or blank line
           amount = 0;
         } else {
+          cin_brace_cache_line(curwin->w_cursor.lnum);
           amount = how();                     // get the indent for this line
         }
         if (amount >= 0 && set_indent(amount, 0)) {
@@ -679,6 +684,7 @@ void op_reindent(oparg_T *oap, Indenter how)
       curwin->w_cursor.lnum++;
       curwin->w_cursor.col = 0;      // make sure it's valid
     }
+    cin_brace_cache_stop();
   }
 
   // put cursor on first non-blank of indented line
@@ -816,6 +822,8 @@ yankreg_T *get_yank_register(int regname, int mode)
 {
   yankreg_T *reg;
 
+  shada_load_registers();
+
   if (mode == YREG_PASTE && get_clipboard(regname, &reg, false)) {
     // reg is set to clipboard contents.
     return reg;
@@ -856,6 +864,16 @@ yankreg_T *copy_register(int name)
   *copy = *reg;
   if (copy->y_size == 0) {
     copy->y_array = NULL;
+    copy->y_arena = NULL;
+  } else if (reg->y_arena != NULL) {
+    // Copy the text in one block and move the line pointers along.
+    char *last = reg->y_array[reg->y_size - 1];
+    size_t arena_size = (size_t)(last - reg->y_arena) + strlen(last) + 1;
+    copy->y_arena = xmemdup(reg->y_arena, arena_size);
+    copy->y_array = xmalloc(copy->y_size * sizeof(char *));
+    for (size_t i = 0; i < copy->y_size; i++) {
+      copy->y_array[i] = copy->y_arena + (reg->y_array[i] - reg->y_arena);
+    }
   } else {
     copy->y_array = xcalloc(copy->y_size, sizeof(char *));
     for (size_t i = 0; i < copy->y_size; i++) {
@@ -974,6 +992,7 @@ static int stuff_yank(int regname, char *p)
   }
   yankreg_T *reg = get_yank_register(regname, YREG_YANK);
   if (is_append_register(regname) && reg->y_array != NULL) {
+    yank_own_lines(reg);
     char **pp = &(reg->y_array[reg->y_size - 1]);
     const size_t ppl = strlen(*pp);
     const size_t pl = strlen(p);
@@ -1125,38 +1144,61 @@ int do_execreg(int regname, int colon, int addcr, int silent)
     // Disallow remapping for ":@r".
     int remap = colon ? REMAP_NONE : REMAP_YES;
 
-    // Insert lines into typeahead buffer, from last one to first one.
     put_reedit_in_typebuf(silent);
-    for (size_t i = reg->y_size; i-- > 0;) {  // from y_size - 1 to 0 included
-      // insert NL between lines and after last line if type is kMTLineWise
-      if (reg->y_type == kMTLineWise || i < reg->y_size - 1 || addcr) {
-        if (ins_typebuf("\n", remap, 0, true, silent) == FAIL) {
-          return FAIL;
-        }
-      }
 
-      // Handle line-continuation for :@<register>
-      char *str = reg->y_array[i];
-      bool free_str = false;
-      if (colon && i > 0) {
-        char *p = skipwhite(str);
-        if (*p == '\\' || (p[0] == '"' && p[1] == '\\' && p[2] == ' ')) {
-          str = execreg_line_continuation(reg->y_array, &i);
-          free_str = true;
+    if (!colon) {
+      // Insert all lines into the typeahead buffer at once, inserting them one
+      // by one in front of each other moves the typeahead for every line.
+      garray_T ga;
+      ga_init(&ga, 1, 1024);
+      for (size_t i = 0; i < reg->y_size; i++) {
+        char *escaped = vim_strsave_escape_ks(reg->y_array[i]);
+        ga_concat(&ga, escaped);
+        xfree(escaped);
+        // insert NL between lines and after last line if type is kMTLineWise
+        if (reg->y_type == kMTLineWise || i < reg->y_size - 1 || addcr) {
+          ga_append(&ga, '\n');
         }
       }
-      char *escaped = vim_strsave_escape_ks(str);
-      if (free_str) {
-        xfree(str);
-      }
-      retval = ins_typebuf(escaped, remap, 0, true, silent);
-      xfree(escaped);
+      ga_append(&ga, NUL);
+      retval = ins_typebuf(ga.ga_data, remap, 0, true, silent);
+      ga_clear(&ga);
       if (retval == FAIL) {
         return FAIL;
       }
-      if (colon
-          && ins_typebuf(":", remap, 0, true, silent) == FAIL) {
-        return FAIL;
+    } else {
+      // Insert lines into typeahead buffer, from last one to first one.
+      for (size_t i = reg->y_size; i-- > 0;) {  // from y_size - 1 to 0 included
+        // insert NL between lines and after last line if type is kMTLineWise
+        if (reg->y_type == kMTLineWise || i < reg->y_size - 1 || addcr) {
+          if (ins_typebuf("\n", remap, 0, true, silent) == FAIL) {
+            return FAIL;
+          }
+        }
+
+        // Handle line-continuation for :@<register>
+        char *str = reg->y_array[i];
+        bool free_str = false;
+        if (colon && i > 0) {
+          char *p = skipwhite(str);
+          if (*p == '\\' || (p[0] == '"' && p[1] == '\\' && p[2] == ' ')) {
+            str = execreg_line_continuation(reg->y_array, &i);
+            free_str = true;
+          }
+        }
+        char *escaped = vim_strsave_escape_ks(str);
+        if (free_str) {
+          xfree(str);
+        }
+        retval = ins_typebuf(escaped, remap, 0, true, silent);
+        xfree(escaped);
+        if (retval == FAIL) {
+          return FAIL;
+        }
+        if (colon
+            && ins_typebuf(":", remap, 0, true, silent) == FAIL) {
+          return FAIL;
+        }
       }
     }
     reg_executing = regname == 0 ? '"' : regname;  // disable the 'q' command
@@ -1415,6 +1457,7 @@ bool cmdline_paste_reg(int regname, bool literally_arg, bool remcr)
 /// Shift the delete registers: "9 is cleared, "8 becomes "9, etc.
 static void shift_delete_registers(bool y_append)
 {
+  shada_load_registers();
   free_register(&y_regs[9]);  // free register "9
   for (int n = 9; n > 1; n--) {
     y_regs[n] = y_regs[n - 1];
@@ -1423,6 +1466,7 @@ static void shift_delete_registers(bool y_append)
     y_previous = &y_regs[1];
   }
   y_regs[1].y_array = NULL;  // set register "1 to empty
+  y_regs[1].y_arena = NULL;
 }
 
 /// Handle a delete operation.
@@ -2543,12 +2587,52 @@ void free_register(yankreg_T *reg)
     return;
   }
 
-  for (size_t i = reg->y_size; i-- > 0;) {  // from y_size - 1 to 0 included
-    xfree(reg->y_array[i]);
+  if (reg->y_arena != NULL) {
+    XFREE_CLEAR(reg->y_arena);
+  } else {
+    for (size_t i = reg->y_size; i-- > 0;) {  // from y_size - 1 to 0 included
+      xfree(reg->y_array[i]);
+    }
   }
   XFREE_CLEAR(reg->y_array);
 }
 
+/// Give each line of yankreg "reg" an allocation of its own, so that single
+/// lines can be freed or replaced.
+static void yank_own_lines(yankreg_T *reg)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (reg->y_arena == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < reg->y_size; i++) {
+    reg->y_array[i] = xstrdup(reg->y_array[i]);
+  }
+  XFREE_CLEAR(reg->y_arena);
+}
+
+/// Yank lines "start" to "end" of the current buffer into "reg", which was
+/// set up by op_yank_reg(). The text is copied in one block, pointed to by
+/// "reg->y_arena", instead of allocating each line.
+static void yank_lines_arena(yankreg_T *reg, linenr_T start, linenr_T end)
+  FUNC_ATTR_NONNULL_ALL
+{
+  size_t arena_size = 0;
+  for (linenr_T lnum = start; lnum <= end; lnum++) {
+    arena_size += strlen(ml_get(lnum)) + 1;
+  }
+  reg->y_arena = xmalloc(MAX(arena_size, 1));
+  char *p = reg->y_arena;
+  size_t y_idx = 0;
+  for (linenr_T lnum = start; lnum <= end; lnum++, y_idx++) {
+    char *line = ml_get(lnum);
+    size_t len = strlen(line) + 1;
+    memcpy(p, line, len);
+    reg->y_array[y_idx] = p;
+    p += len;
+  }
+}
+
 /// Yanks the text between "oap->start" and "oap->end" into a yank register.
 /// If we are to append (uppercase register), we first yank into a new yank
 /// register and then concatenate the old and the new one.
@@ -2588,6 +2672,7 @@ static void op_yank_reg(oparg_T *oap, bool message, yankreg_T *reg, bool append)
   yankreg_T *curr = reg;  // copy of current register
   // append to existing contents
   if (append && reg->y_array != NULL) {
+    yank_own_lines(curr);
     reg = &newreg;
   } else {
     free_register(reg);  // free previously yanked lines
@@ -2610,12 +2695,20 @@ static void op_yank_reg(oparg_T *oap, bool message, yankreg_T *reg, bool append)
   reg->y_type = yank_type;  // set the yank register type
   reg->y_width = 0;
   reg->y_array = xcalloc(yanklines, sizeof(char *));
+  reg->y_arena = NULL;
   reg->additional_data = NULL;
   reg->timestamp = os_time();
 
   size_t y_idx = 0;  // index in y_array[]
   linenr_T lnum = oap->start.lnum;  // current line number
 
+  // When not appending, the lines of a linewise yank are kept in one block.
+  if (yank_type == kMTLineWise && reg == curr) {
+    yank_lines_arena(reg, lnum, yankendlnum);
+    lnum = yankendlnum + 1;
+    y_idx = yanklines;
+  }
+
   if (yank_type == kMTBlockWise) {
     // Visual block mode
     reg->y_width = oap->end_vcol - oap->start_vcol;
@@ -3507,6 +3600,20 @@ void do_put(int regname, yankreg_T *reg, int dir, int count, int flags)
           i = 1;
         }
 
+        if (y_type == kMTLineWise && !(flags & PUT_FIXINDENT)) {
+          // Append all the lines at once, the memline is only looked up for
+          // the first one.
+          assert(y_size <= INT_MAX);
+          int appended = ml_append_buf_lines(curbuf, lnum, y_array, NULL, (int)y_size, false);
+          new_lnum += appended;
+          lnum += appended;
+          nr_lines += appended;
+          if ((size_t)appended < y_size) {
+            goto error;
+          }
+          i = y_size;
+        }
+
         for (; i < y_size; i++) {
           if ((y_type != kMTCharWise || i < y_size - 1)) {
             if (ml_append(lnum, y_array[i], 0, false) == FAIL) {
@@ -3725,6 +3832,7 @@ int get_register_name(int num)
 /// @return the index of the register "" points to.
 int get_unname_register(void)
 {
+  shada_load_registers();
   return y_previous == NULL ? -1 : (int)(y_previous - &y_regs[0]);
 }
 
@@ -3736,6 +3844,7 @@ void ex_display(exarg_T *eap)
   char *arg = eap->arg;
   int type;
 
+  shada_load_registers();
   if (arg != NULL && *arg == NUL) {
     arg = NULL;
   }
@@ -4945,6 +5054,7 @@ static yankreg_T *init_write_reg(int name, yankreg_T **old_y_previous, bool must
     return NULL;
   }
 
+  shada_load_registers();
   // Don't want to change the current (unnamed) register.
   *old_y_previous = y_previous;
 
@@ -5108,6 +5218,7 @@ static void str_to_reg(yankreg_T *y_ptr, MotionType yank_type, const char *str,
   if (y_ptr->y_array == NULL) {  // NULL means empty register
     y_ptr->y_size = 0;
   }
+  yank_own_lines(y_ptr);
 
   if (yank_type == kMTUnknown) {
     yank_type = ((str_list
@@ -6481,6 +6592,7 @@ bool prepare_yankreg_from_object(yankreg_T *reg, String regtype, size_t lines)
   }
 
   reg->y_array = xcalloc(lines, sizeof(uint8_t *));
+  reg->y_arena = NULL;
   reg->y_size = lines;
   reg->additional_data = NULL;
   reg->timestamp = 0;
@@ -88,6 +88,7 @@ enum GRegFlags {
 /// Definition of one register
 typedef struct yankreg {
   char **y_array;           ///< Pointer to an array of line pointers.
+  char *y_arena;            ///< When not NULL, the lines of y_array point into it.
   size_t y_size;            ///< Number of lines in y_array.
   MotionType y_type;        ///< Register type
   colnr_T y_width;          ///< Register width (only valid for y_type == kBlockWise).
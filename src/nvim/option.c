@@ -80,6 +80,7 @@
 #include "nvim/os/lang.h"
 #include "nvim/os/os.h"
 #include "nvim/path.h"
+#include "nvim/plines.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
 #include "nvim/regexp.h"
@@ -3525,6 +3526,9 @@ static const char *did_set_option(OptIndex opt_idx, void *varp, OptVal old_value
   // In case 'columns' or 'ls' changed.
   comp_col();
 
+  // Character widths may have changed.
+  vcol_cache_invalidate_all();
+
   if (varp == &p_mouse) {
     setmouse();  // in case 'mouse' changed
   } else if ((varp == &p_flp || varp == &(curbuf->b_p_flp)) && curwin->w_briopt_list) {
@@ -320,6 +320,12 @@ enum {
     STL_TRUNCMARK, STL_USER_HL, STL_HIGHLIGHT, STL_TABPAGENR, STL_TABCLOSENR, \
     STL_CLICK_FUNC, STL_TABPAGENR, STL_TABCLOSENR, STL_CLICK_FUNC, \
     0, })
+/// C string containing the 'statusline' items that change with the cursor
+#define STL_CURSOR ((char[]) { \
+    STL_COLUMN, STL_VIRTCOL, STL_VIRTCOL_ALT, STL_LINE, STL_NUMLINES, \
+    STL_OFFSET, STL_OFFSET_X, STL_BYTEVAL, STL_BYTEVAL_X, STL_PERCENTAGE, \
+    STL_ALTPERCENT, STL_SHOWCMD, STL_VIM_EXPR, \
+    0, })
 
 // flags used for parsed 'wildmode'
 #define WIM_FULL        0x01
@@ -541,6 +547,7 @@ EXTERN OptInt p_stal;           ///< 'showtabline'
 EXTERN char *p_lcs;             ///< 'listchars'
 
 EXTERN int p_lz;                ///< 'lazyredraw'
+EXTERN int p_ltp;               ///< 'lazytabpages'
 EXTERN int p_lpl;               ///< 'loadplugins'
 EXTERN int p_magic;             ///< 'magic'
 EXTERN char *p_menc;            ///< 'makeencoding'
@@ -552,7 +559,10 @@ EXTERN OptInt p_mco;            ///< 'maxcombine'
 #define MAX_MCO  6  // fixed value for 'maxcombine'
 EXTERN OptInt p_mfd;            ///< 'maxfuncdepth'
 EXTERN OptInt p_mmd;            ///< 'maxmapdepth'
+EXTERN OptInt p_mm;             ///< 'maxmem'
 EXTERN OptInt p_mmp;            ///< 'maxmempattern'
+EXTERN OptInt p_mmt;            ///< 'maxmemtot'
+EXTERN OptInt p_mmu;            ///< 'maxmemundo'
 EXTERN OptInt p_mis;            ///< 'menuitems'
 EXTERN char *p_msm;             ///< 'mkspellmem'
 EXTERN int p_ml;                ///< 'modeline'
@@ -665,6 +675,7 @@ EXTERN int p_sb;                ///< 'splitbelow'
 EXTERN char *p_sua;             ///< 'suffixesadd'
 EXTERN int p_swf;               ///< 'swapfile'
 EXTERN OptInt p_smc;            ///< 'synmaxcol'
+EXTERN OptInt p_sst;            ///< 'synmaxstates'
 EXTERN OptInt p_tpm;            ///< 'tabpagemax'
 EXTERN char *p_tal;             ///< 'tabline'
 EXTERN char *p_tpf;             ///< 'termpastefilter'
@@ -711,6 +722,7 @@ EXTERN int p_tr;                ///< 'tagrelative'
 EXTERN char *p_tags;            ///< 'tags'
 EXTERN int p_tgst;              ///< 'tagstack'
 EXTERN int p_tbidi;             ///< 'termbidi'
+EXTERN OptInt p_tco;            ///< 'termcoalesce'
 EXTERN OptInt p_tw;             ///< 'textwidth'
 EXTERN int p_to;                ///< 'tildeop'
 EXTERN int p_timeout;           ///< 'timeout'
@@ -758,6 +770,7 @@ EXTERN unsigned wop_flags;
 #define WOP_FUZZY               0x01
 #define WOP_TAGFILE             0x02
 #define WOP_PUM                 0x04
+#define WOP_INTERRUPT           0x08
 EXTERN OptInt p_window;         ///< 'window'
 EXTERN char *p_wak;             ///< 'winaltkeys'
 EXTERN char *p_wig;             ///< 'wildignore'
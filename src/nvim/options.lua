@@ -2149,6 +2149,11 @@ return {
         			will enable alignment for a 2 buffer diff with
         			hunks of up to 30 lines each, or a 3 buffer
         			diff with hunks of up to 20 lines each.
+        			For a 2 buffer diff a larger hunk is aligned
+        			with a faster heuristic that matches lines
+        			which appear once in both buffers, and uses
+        			the second stage diff on the parts in between
+        			that have at most {n} lines.
 
         	algorithm:{text} Use the specified diff algorithm with the
         			internal diff engine. Currently supported
@@ -4723,6 +4728,26 @@ return {
       type = 'boolean',
       varname = 'p_lz',
     },
+    {
+      abbreviation = 'ltp',
+      defaults = { if_true = false },
+      desc = [=[
+        When this option is set, starting with |-p| only loads the files of
+        the first tab page.  The file of another tab page is read when that tab
+        page is entered or code is executed in its window, e.g. with
+        |win_execute()|, and only then the |BufReadPre|, |BufRead| and
+        |FileType| autocommands are triggered and the filetype plugin is
+        sourced.  Until then the buffer is listed but not loaded, like a buffer
+        in the argument list that was not edited yet.  This makes starting with
+        many files in tab pages faster.  Must be set in your |config| to have
+        an effect.
+      ]=],
+      full_name = 'lazytabpages',
+      scope = { 'global' },
+      short_desc = N_('only load the file of the first tab page for -p'),
+      type = 'boolean',
+      varname = 'p_ltp',
+    },
     {
       abbreviation = 'lbr',
       defaults = { if_true = false },
@@ -5182,6 +5207,26 @@ return {
       type = 'number',
       varname = 'p_mmd',
     },
+    {
+      abbreviation = 'mm',
+      defaults = { if_true = 0 },
+      desc = [=[
+        Maximum amount of memory (in Kbyte) to use for the text of one
+        buffer.  When this limit is reached, the least recently used blocks
+        of text are written to the |swap-file| and released, they are read
+        back when needed.  For buffers without a swapfile the blocks are
+        compressed in memory instead.
+        Zero means no limit, Nvim delegates memory management to the OS.
+        The number of blocks found in memory, read back, released and
+        compressed is reported by |nvim__stats()|.
+        Also see 'maxmemtot'.
+      ]=],
+      full_name = 'maxmem',
+      scope = { 'global' },
+      short_desc = N_('maximum memory (in Kbyte) used for one buffer'),
+      type = 'number',
+      varname = 'p_mm',
+    },
     {
       abbreviation = 'mmp',
       defaults = { if_true = 1000 },
@@ -5205,6 +5250,37 @@ return {
       type = 'number',
       varname = 'p_mmp',
     },
+    {
+      abbreviation = 'mmt',
+      defaults = { if_true = 0 },
+      desc = [=[
+        Maximum amount of memory (in Kbyte) to use for the text of all
+        buffers together.  When this limit is reached, blocks of the buffer
+        being accessed are released like for 'maxmem'.  Zero means no limit.
+      ]=],
+      full_name = 'maxmemtot',
+      scope = { 'global' },
+      short_desc = N_('maximum memory (in Kbyte) used for all buffers'),
+      type = 'number',
+      varname = 'p_mmt',
+    },
+    {
+      abbreviation = 'mmu',
+      defaults = { if_true = 0 },
+      desc = [=[
+        Maximum amount of memory (in Kbyte) to use for the undo text of one
+        buffer.  When this limit is reached, the text of the oldest undo
+        blocks is compressed, down to three quarters of the limit.  It is
+        decompressed again when the change is undone or redone.  The block
+        being changed is never compressed.  Zero means no limit.
+        Also see 'undolevels'.
+      ]=],
+      full_name = 'maxmemundo',
+      scope = { 'global' },
+      short_desc = N_('maximum memory (in Kbyte) used for undo of one buffer'),
+      type = 'number',
+      varname = 'p_mmu',
+    },
     {
       abbreviation = 'mis',
       defaults = { if_true = 25 },
@@ -6873,6 +6949,16 @@ return {
         						*shada-@*
         @	Maximum number of items in the input-line history to be
         	saved.  When not included, the value of 'history' is used.
+        						*shada-a*
+        a	When included, the items changed since the shada file was
+        	last read or written are appended to it, instead of merging
+        	them with the file and writing it again.  This makes
+        	writing it on exit faster when it is large, or when several
+        	Nvim instances write it.  The number is the size of the file
+        	in KiB above which it is merged and written again as usual,
+        	which drops the items that were replaced since.  Until then
+        	the buffer lists (|shada-%|) of all the appends are
+        	restored.
         						*shada-c*
         c	Dummy option, kept for compatibility reasons.  Has no actual
         	effect: ShaDa always uses UTF-8 and 'encoding' value is fixed
@@ -6886,6 +6972,11 @@ return {
         h	Disable the effect of 'hlsearch' when loading the shada
         	file.  When not included, it depends on whether ":nohlsearch"
         	has been used since the last search command.
+        						*shada-l*
+        l	When included, history and registers are not read from the
+        	shada file at startup, but when they are first used, e.g.
+        	with |:history|, |q:| or when pasting.  This makes startup
+        	faster when the file is large.
         						*shada-n*
         n	Name of the shada file.  The name must immediately follow
         	the 'n'.  Must be at the end of the option!  If the
@@ -7882,7 +7973,9 @@ return {
         timeout:{millisec}   Limit the time searching for suggestions to
         		{millisec} milli seconds.  Applies to the following
         		methods.  When omitted the limit is 5000. When
-        		negative there is no limit.
+        		negative there is no limit.  The time is shared by
+        		the languages in 'spelllang', when it runs out the
+        		suggestions found so far are given.
 
         file:{filename} Read file {filename}, which must have two columns,
         		separated by a slash.  The first column contains the
@@ -8421,6 +8514,26 @@ return {
       type = 'number',
       varname = 'p_smc',
     },
+    {
+      abbreviation = 'sst',
+      defaults = { if_true = 10000 },
+      desc = [=[
+        Maximum number of syntax states to remember for one buffer.  A state
+        is saved at the start of displayed lines and every so many lines in
+        between, syntax highlighting can start from there instead of
+        synchronizing again.  Lines parsed just before the displayed ones get
+        more states, so that scrolling back after a jump is fast.  When all
+        states are used, the ones of the lines that were displayed longest ago
+        are dropped first.  A larger value makes jumping around in a big file
+        faster and uses more memory, about 150 bytes for each state.  Values
+        below 150 are used as 150.
+      ]=],
+      full_name = 'synmaxstates',
+      scope = { 'global' },
+      short_desc = N_('maximum number of saved syntax states'),
+      type = 'number',
+      varname = 'p_sst',
+    },
     {
       abbreviation = 'syn',
       alloced = true,
@@ -8753,6 +8866,22 @@ return {
       type = 'boolean',
       varname = 'p_tbidi',
     },
+    {
+      abbreviation = 'tco',
+      defaults = { if_true = 2 },
+      desc = [=[
+        Milliseconds to collect the output of a |terminal| job before passing
+        it to the terminal emulator.  Programs that redraw with many small
+        writes then cause fewer updates.  Output is passed on right away when
+        16 Kbyte was collected.  Zero or a negative value passes on every read
+        at once.
+      ]=],
+      full_name = 'termcoalesce',
+      scope = { 'global' },
+      short_desc = N_('time to collect terminal output before using it'),
+      type = 'number',
+      varname = 'p_tco',
+    },
     {
       abbreviation = 'tenc',
       defaults = { if_true = '' },
@@ -9691,6 +9820,11 @@ return {
         		expansion. Currently fuzzy matching based completion
         		is not supported for file and directory names and
         		instead wildcard expansion is used.
+          interrupt	A key typed while the matches are being found
+        		stops finding them, like CTRL-C does.  The key is then
+        		used as usual, the command line is not changed.  Useful
+        		when completing is slow, e.g. for "**" in a big
+        		directory tree or a slow "customlist" function.
           pum		Display the completion matches using the popup menu
         		in the same style as the |ins-completion-menu|.
           tagfile	When using CTRL-D to list matching tags, the kind of
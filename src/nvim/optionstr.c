@@ -99,7 +99,7 @@ static char *(p_tc_values[]) = { "followic", "ignore", "match", "followscs", "sm
 static char *(p_ve_values[]) = { "block", "insert", "all", "onemore", "none", "NONE", NULL };
 // Note: Keep this in sync with check_opt_wim()
 static char *(p_wim_values[]) = { "full", "longest", "list", "lastused", NULL };
-static char *(p_wop_values[]) = { "fuzzy", "tagfile", "pum", NULL };
+static char *(p_wop_values[]) = { "fuzzy", "tagfile", "pum", "interrupt", NULL };
 static char *(p_wak_values[]) = { "yes", "menu", "no", NULL };
 static char *(p_mousem_values[]) = { "extend", "popup", "popup_setpos", "mac", NULL };
 static char *(p_sel_values[]) = { "inclusive", "exclusive", "old", NULL };
@@ -1995,7 +1995,7 @@ const char *did_set_shada(optset_T *args)
 
   for (char *s = p_shada; *s;) {
     // Check it's a valid character
-    if (vim_strchr("!\"%'/:<@cfhnrs", (uint8_t)(*s)) == NULL) {
+    if (vim_strchr("!\"%'/:<@acfhlnrs", (uint8_t)(*s)) == NULL) {
       return illegal_char(errbuf, errbuflen, (uint8_t)(*s));
     }
     if (*s == 'n') {          // name is always last one
@@ -2005,7 +2005,7 @@ const char *did_set_shada(optset_T *args)
     } else if (*s == '%') {
       // optional number
       while (ascii_isdigit(*++s)) {}
-    } else if (*s == '!' || *s == 'h' || *s == 'c') {
+    } else if (*s == '!' || *s == 'h' || *s == 'c' || *s == 'l') {
       s++;                    // no extra chars
     } else {                    // must have a number
       while (ascii_isdigit(*++s)) {}
@@ -2148,6 +2148,7 @@ const char *did_set_spelloptions(optset_T *args)
                         true) != OK) {
     return e_invarg;
   }
+  spell_cache_invalidate();
   return NULL;
 }
 
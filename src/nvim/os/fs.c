@@ -37,6 +37,7 @@
 #include "nvim/globals.h"
 #include "nvim/log.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/option_vars.h"
@@ -684,6 +685,58 @@ ptrdiff_t os_write(const int fd, const char *const buf, const size_t size, const
   return (ptrdiff_t)written_bytes;
 }
 
+#ifdef HAVE_WRITEV
+/// Write multiple buffers to a file at once
+///
+/// Wrapper for writev().
+///
+/// @param[in]  fd  File descriptor to write to.
+/// @param[in,out]  iov  Description of buffers to write. Note: this description
+///                      may change, it is incorrect to use it after
+///                      os_writev().
+/// @param[in]  iov_size  Number of buffers in iov, at most IOV_MAX.
+///
+/// @return Number of bytes written or libuv error code (< 0).
+ptrdiff_t os_writev(const int fd, struct iovec *iov, size_t iov_size)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t written_bytes = 0;
+  while (iov_size > 0) {
+    if (iov->iov_len == 0) {
+      iov_size--;
+      iov++;
+      continue;
+    }
+    const ptrdiff_t cur_written_bytes = writev(fd, iov, (int)iov_size);
+    if (cur_written_bytes < 0) {
+      const int error = os_translate_sys_error(errno);
+      errno = 0;
+      if (error == UV_EINTR || error == UV_EAGAIN) {
+        continue;
+      }
+      return error;
+    }
+    if (cur_written_bytes == 0) {
+      return UV_UNKNOWN;
+    }
+    written_bytes += (size_t)cur_written_bytes;
+    size_t done = (size_t)cur_written_bytes;
+    while (iov_size && done) {
+      if (done < iov->iov_len) {
+        iov->iov_len -= done;
+        iov->iov_base = (char *)iov->iov_base + done;
+        done = 0;
+      } else {
+        done -= iov->iov_len;
+        iov_size--;
+        iov++;
+      }
+    }
+  }
+  return (ptrdiff_t)written_bytes;
+}
+#endif  // HAVE_WRITEV
+
 /// Copies a file from `path` to `new_path`.
 ///
 /// @see http://docs.libuv.org/en/v1.x/fs.html#c.uv_fs_copyfile
@@ -712,6 +765,44 @@ int os_fsync(int fd)
   return r;
 }
 
+/// Flushes file modifications to disk in the libuv threadpool, without
+/// waiting for it.
+///
+/// The flush is done on a duplicate of `fd`, so that `fd` may be closed
+/// before the flush has finished.  Falls back to os_fsync() when the request
+/// can't be queued.
+///
+/// @param fd the file descriptor of the file to be flushed.
+///
+/// @return 0 on success (queued), or libuv error code on failure.
+int os_fsync_async(int fd)
+{
+  int dup_fd = os_dup(fd);
+  if (dup_fd < 0) {
+    return os_fsync(fd);
+  }
+  uv_fs_t *req = xmalloc(sizeof(uv_fs_t));
+  req->data = (void *)(intptr_t)dup_fd;
+  int r = uv_fs_fsync(&main_loop.uv, req, dup_fd, os_fsync_async_cb);
+  if (r < 0) {
+    xfree(req);
+    close(dup_fd);
+    return os_fsync(fd);
+  }
+  return 0;
+}
+
+static void os_fsync_async_cb(uv_fs_t *req)
+{
+  if (req->result < 0) {
+    ELOG("fsync failed: %s", uv_strerror((int)req->result));
+  }
+  g_stats.fsync++;
+  close((int)(intptr_t)req->data);
+  uv_fs_req_cleanup(req);
+  xfree(req);
+}
+
 /// Get stat information for a file.
 ///
 /// @return libuv return code, or -errno
@@ -954,6 +1045,63 @@ int os_file_is_writable(const char *name)
   return 0;
 }
 
+/// Read ahead of a file in the libuv threadpool, see os_prefetch_file().
+typedef struct {
+  uv_work_t req;
+  char *fname;
+  size_t max_bytes;
+  char *buf;
+} PrefetchJob;
+
+enum { PREFETCH_BUF_SIZE = 64 * 1024, };
+
+/// Read file "fname" in the libuv threadpool, without waiting for it, so that
+/// reading it later finds it in the file cache of the OS.  At most about
+/// "max_bytes" are read.  Errors are ignored.
+void os_prefetch_file(const char *fname, size_t max_bytes)
+  FUNC_ATTR_NONNULL_ALL
+{
+  PrefetchJob *job = xmalloc(sizeof(*job));
+  job->fname = xstrdup(fname);
+  job->max_bytes = max_bytes;
+  job->buf = xmalloc(PREFETCH_BUF_SIZE);
+  job->req.data = job;
+  if (uv_queue_work(&main_loop.uv, &job->req, os_prefetch_work, os_prefetch_done) != 0) {
+    os_prefetch_done(&job->req, 0);
+  }
+}
+
+static void os_prefetch_work(uv_work_t *req)
+{
+  PrefetchJob *job = req->data;
+  int fd = os_open(job->fname, O_RDONLY, 0);
+  if (fd < 0) {
+    return;
+  }
+  size_t done = 0;
+  while (done < job->max_bytes) {
+    uv_fs_t fs_req;
+    uv_buf_t buf = uv_buf_init(job->buf, PREFETCH_BUF_SIZE);
+    int r = uv_fs_read(NULL, &fs_req, fd, &buf, 1, -1, NULL);
+    uv_fs_req_cleanup(&fs_req);
+    if (r <= 0) {
+      break;
+    }
+    done += (size_t)r;
+  }
+  uv_fs_t fs_req;
+  uv_fs_close(NULL, &fs_req, fd, NULL);
+  uv_fs_req_cleanup(&fs_req);
+}
+
+static void os_prefetch_done(uv_work_t *req, int status)
+{
+  PrefetchJob *job = req->data;
+  xfree(job->buf);
+  xfree(job->fname);
+  xfree(job);
+}
+
 /// Rename a file or directory.
 ///
 /// @return `OK` for success, `FAIL` for failure.
@@ -1110,6 +1258,15 @@ bool os_scandir(Directory *dir, const char *path)
   return r >= 0;
 }
 
+/// Number of entries in a directory opened with `os_scandir()`.
+/// @param dir  The Directory object.
+/// @returns the entry count, not counting "." and "..".
+size_t os_scandir_count(Directory *dir)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  return dir->request.result > 0 ? (size_t)dir->request.result : 0;
+}
+
 /// Increments the directory pointer.
 /// @param dir  The Directory object.
 /// @returns a pointer to the next path in `dir` or `NULL`.
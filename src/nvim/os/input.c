@@ -45,6 +45,11 @@ static bool input_eof = false;
 static bool blocking = false;
 static int cursorhold_time = 0;  ///< time waiting for CursorHold event
 static int cursorhold_tb_change_cnt = 0;  ///< tb_change_cnt when waiting started
+static bool typed_key_interrupts = false;  ///< any typed key sets got_int
+static bool typed_key_interrupted = false;  ///< got_int was set by a typed key
+/// When the oldest key whose effect was not flushed to the UI yet was
+/// received, zero when there is none.
+static uint64_t input_key_time = 0;
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "os/input.c.generated.h"
@@ -294,10 +299,40 @@ size_t input_enqueue(String keys)
   }
 
   size_t rv = (size_t)(ptr - keys.data);
+  if (rv > 0) {
+    input_mark_key_time();
+  }
+  bool was_int = got_int;
   process_ctrl_c();
+  if (got_int && !was_int) {
+    // CTRL-C, which is removed from the input as usual.
+    typed_key_interrupted = false;
+  } else if (typed_key_interrupts && rv > 0 && !got_int) {
+    // The key is not consumed, it is used after the interrupted work.
+    got_int = true;
+    typed_key_interrupted = true;
+  }
   return rv;
 }
 
+/// Makes any key that is typed from now on interrupt, like CTRL-C, until
+/// called again with false.  Keys typed before are not affected.
+void input_set_typed_key_interrupts(bool on)
+{
+  typed_key_interrupts = on;
+  if (on) {
+    typed_key_interrupted = false;
+  }
+}
+
+/// @return  true if got_int was set by a key typed while
+///          input_set_typed_key_interrupts() was on, not by CTRL-C.  The
+///          key is still in the input buffer then.
+bool input_typed_key_interrupted(void)
+{
+  return typed_key_interrupted;
+}
+
 static uint8_t check_multiclick(int code, int grid, int row, int col)
 {
   static int orig_num_clicks = 0;
@@ -435,9 +470,33 @@ size_t input_enqueue_mouse(int code, uint8_t modifier, int grid, int row, int co
 
   size_t written = 3 + (size_t)(p - buf);
   rbuffer_write(input_buffer, (char *)buf, written);
+  input_mark_key_time();
   return written;
 }
 
+static void input_mark_key_time(void)
+{
+  if (input_key_time == 0) {
+    input_key_time = os_hrtime();
+  }
+}
+
+/// Gets the time the oldest key not shown yet was received, once all the
+/// received keys have been read.  Called when flushing the UI, the time is
+/// only returned once.
+///
+/// @return the time from os_hrtime(), or zero when there are no such keys or
+///         some are still unread.
+uint64_t input_take_key_time(void)
+{
+  if (input_key_time == 0 || rbuffer_size(input_buffer) != 0) {
+    return 0;
+  }
+  uint64_t rv = input_key_time;
+  input_key_time = 0;
+  return rv;
+}
+
 /// @return true if the main loop is blocked and waiting for input.
 bool input_blocking(void)
 {
@@ -488,6 +547,9 @@ static void input_read_cb(Stream *stream, RBuffer *buf, size_t c, void *data, bo
   }
 
   assert(rbuffer_space(input_buffer) >= rbuffer_size(buf));
+  if (rbuffer_size(buf) > 0) {
+    input_mark_key_time();
+  }
   RBUFFER_UNTIL_EMPTY(buf, ptr, len) {
     (void)rbuffer_write(input_buffer, ptr, len);
     rbuffer_consumed(buf, len);
@@ -30,4 +30,5 @@ extern char *default_lib_dir;
 #endif
 
 #define ENV_LOGFILE "NVIM_LOG_FILE"
+#define ENV_LOGASYNC "NVIM_LOG_ASYNC"
 #define ENV_NVIM "NVIM"
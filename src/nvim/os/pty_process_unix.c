@@ -30,7 +30,6 @@
 #endif
 
 #include "auto/config.h"
-#include "klib/klist.h"
 #include "nvim/eval/typval.h"
 #include "nvim/event/defs.h"
 #include "nvim/event/loop.h"
@@ -169,7 +168,7 @@ int pty_process_spawn(PtyProcess *ptyproc)
   int status = 0;  // zero or negative error code (libuv convention)
   Process *proc = (Process *)ptyproc;
   assert(proc->err.closed);
-  uv_signal_start(&proc->loop->children_watcher, chld_handler, SIGCHLD);
+  uv_signal_start(&proc->loop->children_watcher, process_chld_handler, SIGCHLD);
   ptyproc->winsize = (struct winsize){ ptyproc->height, ptyproc->width, 0, 0 };
   uv_disable_stdio_inheritance();
   int master;
@@ -378,29 +377,3 @@ error:
   close(fd_dup);
   return status;
 }
-
-static void chld_handler(uv_signal_t *handle, int signum)
-{
-  int stat = 0;
-  int pid;
-
-  Loop *loop = handle->loop->data;
-
-  kl_iter(WatcherPtr, loop->children, current) {
-    Process *proc = (*current)->data;
-    do {
-      pid = waitpid(proc->pid, &stat, WNOHANG);
-    } while (pid < 0 && errno == EINTR);
-
-    if (pid <= 0) {
-      continue;
-    }
-
-    if (WIFEXITED(stat)) {
-      proc->status = WEXITSTATUS(stat);
-    } else if (WIFSIGNALED(stat)) {
-      proc->status = 128 + WTERMSIG(stat);
-    }
-    proc->internal_exit_cb(proc);
-  }
-}
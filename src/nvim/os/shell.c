@@ -58,6 +58,12 @@ typedef struct {
   size_t cap, len;
 } DynamicBuffer;
 
+/// Data of the stream_data_cb() callback.
+typedef struct {
+  ShellOutputCb cb;
+  void *data;
+} ShellStream;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "os/shell.c.generated.h"
 #endif
@@ -672,8 +678,7 @@ char *shell_argv_to_str(char **const argv)
 int os_call_shell(char *cmd, ShellOpts opts, char *extra_args)
 {
   DynamicBuffer input = DYNAMIC_BUFFER_INIT;
-  char *output = NULL;
-  char **output_ptr = NULL;
+  bool read_output = false;
   int current_state = State;
   bool forward_output = true;
 
@@ -690,7 +695,7 @@ int os_call_shell(char *cmd, ShellOpts opts, char *extra_args)
     }
 
     if (opts & kShellOptRead) {
-      output_ptr = &output;
+      read_output = true;
       forward_output = false;
     } else if (opts & kShellOptDoOut) {
       // Caller has already redirected output
@@ -698,15 +703,20 @@ int os_call_shell(char *cmd, ShellOpts opts, char *extra_args)
     }
   }
 
-  size_t nread;
+  // Lines read from the command are put in the buffer as they arrive, only
+  // an incomplete line is kept in "output".
+  DynamicBuffer output = DYNAMIC_BUFFER_INIT;
+  ShellStream stream = { .cb = read_output_cb, .data = &output };
   int exitcode = do_os_system(shell_build_argv(cmd, extra_args),
-                              input.data, input.len, output_ptr, &nread,
-                              emsg_silent, forward_output);
+                              input.data, input.len, NULL, NULL,
+                              emsg_silent, forward_output,
+                              read_output ? &stream : NULL);
   xfree(input.data);
 
-  if (output) {
-    (void)write_output(output, nread, true);
-    xfree(output);
+  if (read_output && output.data != NULL) {
+    output.data[output.len] = NUL;
+    (void)write_output(output.data, output.len, true);
+    xfree(output.data);
   }
 
   if (!emsg_silent && exitcode != 0 && !(opts & kShellOptSilent)) {
@@ -855,11 +865,28 @@ done:
 int os_system(char **argv, const char *input, size_t len, char **output,
               size_t *nread) FUNC_ATTR_NONNULL_ARG(1)
 {
-  return do_os_system(argv, input, len, output, nread, true, false);
+  return do_os_system(argv, input, len, output, nread, true, false, NULL);
+}
+
+/// Like os_system(), but passes the output to "cb" as it is received instead
+/// of collecting all of it in memory.
+///
+/// @param argv The commandline arguments, will be consumed.
+/// @param input The input to the shell or NULL.
+/// @param len The length of the input buffer.
+/// @param cb Called with each chunk of output.
+/// @param data Passed to "cb".
+/// @return the return code of the process, -1 if the process couldn't be
+///         started properly
+int os_system_stream(char **argv, const char *input, size_t len, ShellOutputCb cb, void *data)
+  FUNC_ATTR_NONNULL_ARG(1, 4)
+{
+  ShellStream stream = { .cb = cb, .data = data };
+  return do_os_system(argv, input, len, NULL, NULL, true, false, &stream);
 }
 
 static int do_os_system(char **argv, const char *input, size_t len, char **output, size_t *nread,
-                        bool silent, bool forward_output)
+                        bool silent, bool forward_output, ShellStream *stream)
 {
   out_data_decide_throttle(0);  // Initialize throttle decider.
   out_data_ring(NULL, 0);       // Initialize output ring-buffer.
@@ -868,12 +895,16 @@ static int do_os_system(char **argv, const char *input, size_t len, char **outpu
   // the output buffer
   DynamicBuffer buf = DYNAMIC_BUFFER_INIT;
   stream_read_cb data_cb = system_data_cb;
+  void *cb_data = &buf;
   if (nread) {
     *nread = 0;
   }
 
   if (forward_output) {
     data_cb = out_data_cb;
+  } else if (stream) {
+    data_cb = stream_data_cb;
+    cb_data = stream;
   } else if (!output) {
     data_cb = NULL;
   }
@@ -910,9 +941,9 @@ static int do_os_system(char **argv, const char *input, size_t len, char **outpu
     wstream_init(&proc->in, 0);
   }
   rstream_init(&proc->out, 0);
-  rstream_start(&proc->out, data_cb, &buf);
+  rstream_start(&proc->out, data_cb, cb_data);
   rstream_init(&proc->err, 0);
-  rstream_start(&proc->err, data_cb, &buf);
+  rstream_start(&proc->err, data_cb, cb_data);
 
   // write the input, if any
   if (has_input) {
@@ -1000,6 +1031,35 @@ static void system_data_cb(Stream *stream, RBuffer *buf, size_t count, void *dat
   dbuf->len += nread;
 }
 
+static void stream_data_cb(Stream *stream, RBuffer *buf, size_t count, void *data, bool eof)
+{
+  ShellStream *sstream = data;
+
+  RBUFFER_UNTIL_EMPTY(buf, ptr, len) {
+    sstream->cb(sstream->data, ptr, len);
+    rbuffer_consumed(buf, len);
+  }
+}
+
+/// ShellOutputCb for ":read !cmd": appends the complete lines to the buffer and
+/// keeps the rest in the DynamicBuffer "data".
+static int read_output_cb(void *data, const char *buf, size_t len)
+{
+  DynamicBuffer *dbuf = data;
+
+  dynamic_buffer_ensure(dbuf, dbuf->len + len + 1);
+  memcpy(dbuf->data + dbuf->len, buf, len);
+  dbuf->len += len;
+  if (memchr(buf, NL, len) == NULL) {
+    return 0;  // Still no complete line.
+  }
+
+  size_t written = write_output(dbuf->data, dbuf->len, false);
+  dbuf->len -= written;
+  memmove(dbuf->data, dbuf->data + written, dbuf->len);
+  return 0;
+}
+
 /// Tracks output received for the current executing shell command, and displays
 /// a pulsing "..." when output should be skipped. Tracking depends on the
 /// synchronous/blocking nature of ":!".
@@ -1292,7 +1352,9 @@ static size_t write_output(char *output, size_t remaining, bool eof)
   size_t off = 0;
   while (off < remaining) {
     if (output[off] == NL) {
-      // Insert the line
+      // Insert the line, translating NUL to NL.  This is only done for
+      // complete lines, the rest may be passed again with more data.
+      memchrsub(output, NUL, NL, off);
       output[off] = NUL;
       ml_append(curwin->w_cursor.lnum++, output, (int)off + 1,
                 false);
@@ -1302,16 +1364,12 @@ static size_t write_output(char *output, size_t remaining, bool eof)
       off = 0;
       continue;
     }
-
-    if (output[off] == NUL) {
-      // Translate NUL to NL
-      output[off] = NL;
-    }
     off++;
   }
 
   if (eof) {
     if (remaining) {
+      memchrsub(output, NUL, NL, remaining);
       // append unfinished line
       ml_append(curwin->w_cursor.lnum++, output, 0, false);
       // remember that the NL was missing
@@ -13,6 +13,13 @@ typedef enum {
   kShellOptHideMess = 64,  ///< previously a global variable from os_unix.c
 } ShellOpts;
 
+/// Receives the output of a command run with os_system_stream() as it arrives.
+///
+/// @param data  Pointer given to os_system_stream()
+/// @param buf   Output, not NUL-terminated
+/// @param len   Number of bytes in "buf"
+typedef int (*ShellOutputCb)(void *data, const char *buf, size_t len);
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "os/shell.h.generated.h"
 #endif
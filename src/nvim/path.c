@@ -5,8 +5,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
 #include "auto/config.h"
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/charset.h"
@@ -20,6 +22,7 @@
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -44,6 +47,31 @@ enum {
 # undef gen_expand_wildcards
 #endif
 
+typedef struct {
+  char *name;
+  bool is_dir;
+} PathDirEntry;
+
+/// Directory read ahead in the threadpool for expanding "**".
+typedef struct {
+  uv_work_t req;
+  char *path;   ///< as do_path_expand() builds it: "" or ending in a separator
+  int depth;
+  bool ok;      ///< the directory could be read
+  kvec_t(PathDirEntry) entries;
+} PathScanJob;
+
+/// The directories read ahead by path_prefetch_tree(), by path.
+static PMap(cstr_t) path_prefetch = MAP_INIT;
+static uv_loop_t *path_prefetch_loop = NULL;
+static bool path_prefetching = false;
+/// Jobs queued by path_scan_queue() that are not done yet.
+static Set(ptr_t) path_prefetch_pending = SET_INIT;
+
+// Stop reading ahead after this many directories, the rest are read when
+// they are expanded.
+#define PATH_PREFETCH_MAX 20000
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "path.c.generated.h"
 #endif
@@ -588,19 +616,150 @@ static size_t path_expand(garray_T *gap, const char *path, int flags)
   return do_path_expand(gap, path, 0, flags, false);
 }
 
-static const char *scandir_next_with_dots(Directory *dir)
+/// Get the next entry of a directory, "." and ".." first.
+///
+/// @param pre  listing read ahead, or NULL to use "dir"
+/// @param[in,out] idx  index of the entry, start at zero
+/// @param[out] is_dir  false if the entry is known not to be a directory
+static const char *path_dir_next(PathScanJob *pre, Directory *dir, size_t *idx, bool *is_dir)
 {
-  static int count = 0;
-  if (dir == NULL) {  // initialize
-    count = 0;
+  size_t i = (*idx)++;
+  *is_dir = true;
+  if (i < 2) {
+    return i == 0 ? "." : "..";
+  }
+  if (pre == NULL) {
+    return os_scandir_next(dir);
+  }
+  if (i - 2 >= kv_size(pre->entries)) {
     return NULL;
   }
+  *is_dir = kv_A(pre->entries, i - 2).is_dir;
+  return kv_A(pre->entries, i - 2).name;
+}
+
+static void path_scan_work(uv_work_t *req)
+{
+  PathScanJob *job = req->data;
+  uv_fs_t scan_req;
+  char *fname = xmalloc(MAXPATHL);
+  job->ok = uv_fs_scandir(NULL, &scan_req, *job->path == NUL ? "." : job->path, 0, NULL) >= 0;
+  if (job->ok) {
+    uv_dirent_t ent;
+    while (uv_fs_scandir_next(&scan_req, &ent) != UV_EOF) {
+      bool is_dir = ent.type == UV_DIRENT_DIR;
+      if ((ent.type == UV_DIRENT_LINK || ent.type == UV_DIRENT_UNKNOWN)
+          && strlen(job->path) + strlen(ent.name) < MAXPATHL) {
+        snprintf(fname, MAXPATHL, "%s%s", job->path, ent.name);
+        uv_fs_t stat_req;
+        is_dir = uv_fs_stat(NULL, &stat_req, fname, NULL) == 0
+                 && S_ISDIR(stat_req.statbuf.st_mode);
+        uv_fs_req_cleanup(&stat_req);
+      }
+      kv_push(job->entries, ((PathDirEntry){ .name = xstrdup(ent.name), .is_dir = is_dir }));
+    }
+  }
+  uv_fs_req_cleanup(&scan_req);
+  xfree(fname);
+}
+
+/// Called in the main thread when a directory was read, queues reading its
+/// subdirectories.
+static void path_scan_done(uv_work_t *req, int status)
+{
+  PathScanJob *job = req->data;
+  set_del(ptr_t, &path_prefetch_pending, job);
+  if (status == UV_ECANCELED || !job->ok) {
+    for (size_t i = 0; i < kv_size(job->entries); i++) {
+      xfree(kv_A(job->entries, i).name);
+    }
+    kv_destroy(job->entries);
+    xfree(job->path);
+    xfree(job);
+    return;
+  }
+  pmap_put(cstr_t)(&path_prefetch, job->path, job);
+  // Like "stardepth" in do_path_expand().  Nothing more is read after CTRL-C.
+  if (job->depth >= 100 || got_int) {
+    return;
+  }
+  for (size_t i = 0; i < kv_size(job->entries); i++) {
+    PathDirEntry *ent = &kv_A(job->entries, i);
+    // "**" doesn't match hidden names.
+    if (!ent->is_dir || ent->name[0] == '.'
+        || strlen(job->path) + strlen(ent->name) + 2 >= MAXPATHL) {
+      continue;
+    }
+    if (map_size(&path_prefetch) >= PATH_PREFETCH_MAX) {
+      return;
+    }
+    size_t len = strlen(job->path) + strlen(ent->name) + 2;
+    char *path = xmalloc(len);
+    snprintf(path, len, "%s%s/", job->path, ent->name);
+    path_scan_queue(path, job->depth + 1);
+  }
+}
 
-  count += 1;
-  if (count == 1 || count == 2) {
-    return (count == 1) ? "." : "..";
+static void path_scan_queue(char *path, int depth)
+{
+  PathScanJob *job = xcalloc(1, sizeof(PathScanJob));
+  job->path = path;
+  job->depth = depth;
+  job->req.data = job;
+  if (uv_queue_work(path_prefetch_loop, &job->req, path_scan_work, path_scan_done) == 0) {
+    set_put(ptr_t, &path_prefetch_pending, job);
+  } else {
+    path_scan_work(&job->req);
+    path_scan_done(&job->req, 0);
   }
-  return os_scandir_next(dir);
+}
+
+/// Read directory "path" and its subdirectories in the libuv threadpool, for
+/// expanding "**" in it.  do_path_expand() uses these listings instead of
+/// reading each directory when it gets there, which is slow for a big tree and
+/// more so on a network file system.
+///
+/// @return false if the tree could not be read ahead.
+static bool path_prefetch_tree(const char *path)
+{
+  uv_loop_t loop;
+  if (uv_loop_init(&loop) != 0) {
+    return false;
+  }
+  path_prefetch_loop = &loop;
+  path_scan_queue(xstrdup(path), 0);
+  // Check for CTRL-C as directories are read.  The ones queued but not
+  // started are cancelled then, and do_path_expand() stops at got_int.
+  bool cancelled = false;
+  while (uv_run(&loop, UV_RUN_ONCE) != 0) {
+    os_breakcheck();
+    if (got_int && !cancelled) {
+      ptr_t job;
+      set_foreach(&path_prefetch_pending, job, {
+        // Fails for a directory that is being read, which is fine.
+        uv_cancel((uv_req_t *)&((PathScanJob *)job)->req);
+      });
+      cancelled = true;
+    }
+  }
+  set_destroy(ptr_t, &path_prefetch_pending);
+  uv_loop_close(&loop);
+  path_prefetch_loop = NULL;
+  return true;
+}
+
+static void path_prefetch_clear(void)
+{
+  PathScanJob *job;
+  map_foreach_value(&path_prefetch, job, {
+    for (size_t i = 0; i < kv_size(job->entries); i++) {
+      xfree(kv_A(job->entries, i).name);
+    }
+    kv_destroy(job->entries);
+    xfree(job->path);
+    xfree(job);
+  });
+  map_destroy(cstr_t, &path_prefetch);
 }
 
 /// Implementation of path_expand().
@@ -711,6 +870,16 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
     return 0;
   }
 
+  // Read the tree below this directory ahead, for this "**" and the ones
+  // it expands to.
+  bool prefetch_owner = false;
+  if (starstar && !path_prefetching) {
+    char c = *s;
+    *s = NUL;
+    prefetch_owner = path_prefetching = path_prefetch_tree(buf);
+    *s = c;
+  }
+
   // If "**" is by itself, this is the first time we encounter it and more
   // is following then find matches without any directory.
   if (!didstar && stardepth < 100 && starstar && e - s == 2
@@ -722,13 +891,15 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
   }
   *s = NUL;
 
+  PathScanJob *pre = path_prefetching ? pmap_get(cstr_t)(&path_prefetch, buf) : NULL;
   Directory dir;
   char *dirpath = (*buf == NUL ? "." : buf);
-  if (os_file_is_readable(dirpath) && os_scandir(&dir, dirpath)) {
+  if (pre != NULL || (os_file_is_readable(dirpath) && os_scandir(&dir, dirpath))) {
     // Find all matching entries.
     const char *name;
-    scandir_next_with_dots(NULL);  // initialize
-    while (!got_int && (name = scandir_next_with_dots(&dir)) != NULL) {
+    size_t idx = 0;
+    bool is_dir;
+    while (!got_int && (name = path_dir_next(pre, &dir, &idx, &is_dir)) != NULL) {
       if ((name[0] != '.'
            || starts_with_dot
            || ((flags & EW_DODOT)
@@ -740,7 +911,7 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
         STRCPY(s, name);
         len = strlen(buf);
 
-        if (starstar && stardepth < 100) {
+        if (starstar && stardepth < 100 && is_dir) {
           // For "**" in the pattern first go deeper in the tree to
           // find matches.
           STRCPY(buf + len, "/**");  // NOLINT
@@ -754,7 +925,9 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
         if (path_has_exp_wildcard(path_end)) {      // handle more wildcards
           // need to expand another component of the path
           // remove backslashes for the remaining components only
-          (void)do_path_expand(gap, buf, len + 1, flags, false);
+          if (is_dir) {
+            (void)do_path_expand(gap, buf, len + 1, flags, false);
+          }
         } else {
           FileInfo file_info;
 
@@ -772,7 +945,14 @@ static size_t do_path_expand(garray_T *gap, const char *path, size_t wildoff, in
         }
       }
     }
-    os_closedir(&dir);
+    if (pre == NULL) {
+      os_closedir(&dir);
+    }
+  }
+
+  if (prefetch_owner) {
+    path_prefetch_clear();
+    path_prefetching = false;
   }
 
   xfree(buf);
@@ -2187,6 +2367,15 @@ int expand_wildcards(int num_pat, char **pat, int *num_files, char ***files, int
     return retval;
   }
 
+  return expand_wildcards_filter(num_files, files);
+}
+
+/// Removes the names in "files" that match 'wildignore' and moves the ones
+/// that match 'suffixes' to the end, as expand_wildcards() does.
+///
+/// @return FAIL when no names are left, "files" is freed then.
+int expand_wildcards_filter(int *num_files, char ***files)
+{
   // Remove names that match 'wildignore'.
   if (*p_wig) {
     // check all files in (*files)[]
@@ -2231,7 +2420,7 @@ int expand_wildcards(int num_pat, char **pat, int *num_files, char ***files, int
     return FAIL;
   }
 
-  return retval;
+  return OK;
 }
 
 /// @return  true if "fname" matches with an entry in 'suffixes'.
@@ -5,7 +5,9 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/charset.h"
 #include "nvim/decoration.h"
@@ -32,6 +34,63 @@
 
 /// Functions calculating horizontal size of text, when displayed in a window.
 
+/// getvcol() remembers the virtual column every this many bytes of a line.
+#define VCOL_CACHE_STEP 1024
+
+/// Bumped when text or an option changes, which may change the virtual
+/// columns of any line: all w_vcol_cache and w_height_cache are invalid then.
+static uint64_t vcol_cache_generation = 1;
+
+/// Invalidate the getvcol() checkpoints of all windows.
+void vcol_cache_invalidate_all(void)
+{
+  vcol_cache_generation++;
+}
+
+/// Find the checkpoint of line "lnum" in "wp" closest before byte "col" and
+/// clear the cache when it was for another line or the keys changed.
+///
+/// @param[out] vcolp  virtual column at the returned byte offset
+///
+/// @return byte offset to start counting from, 0 when there is none.
+static colnr_T vcol_cache_find(win_T *wp, linenr_T lnum, colnr_T col, colnr_T *vcolp)
+{
+  VcolCache *vc = &wp->w_vcol_cache;
+  buf_T *buf = wp->w_buffer;
+  int width1 = wp->w_width_inner - win_col_off(wp);
+  int width2 = width1 + win_col_off2(wp);
+  if (vc->generation != vcol_cache_generation || vc->buf != buf->handle || vc->lnum != lnum
+      || vc->changedtick != buf_get_changedtick(buf) || vc->wrap != wp->w_p_wrap
+      || vc->width1 != width1 || vc->width2 != width2) {
+    vc->generation = vcol_cache_generation;
+    vc->buf = buf->handle;
+    vc->lnum = lnum;
+    vc->changedtick = buf_get_changedtick(buf);
+    vc->wrap = wp->w_p_wrap;
+    vc->width1 = width1;
+    vc->width2 = width2;
+    kv_size(vc->points) = 0;
+  }
+
+  // binary search for the last checkpoint at or before "col"
+  size_t lo = 0;
+  size_t hi = kv_size(vc->points);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (kv_A(vc->points, mid).col <= col) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) {
+    *vcolp = 0;
+    return 0;
+  }
+  *vcolp = kv_A(vc->points, lo - 1).vcol;
+  return kv_A(vc->points, lo - 1).col;
+}
+
 /// Return the number of characters 'c' will take on the screen, taking
 /// into account the size of a tab.
 /// Also see getvcol()
@@ -70,7 +129,11 @@ int linetabsize_col(int startcol, char *s)
 {
   chartabsize_T cts;
   init_chartabsize_arg(&cts, curwin, 0, startcol, s, s);
+  char *end = cts_no_lbr(&cts) ? s + strlen(s) : NULL;
   while (*cts.cts_ptr != NUL) {
+    if (end != NULL && cts_ascii_run(&cts, end)) {
+      continue;
+    }
     cts.cts_vcol += lbr_chartabsize_adv(&cts);
   }
   clear_chartabsize_arg(&cts);
@@ -102,9 +165,19 @@ int linetabsize(win_T *wp, linenr_T lnum)
 
 void win_linetabsize_cts(chartabsize_T *cts, colnr_T len)
 {
-  for (; *cts->cts_ptr != NUL && (len == MAXCOL || cts->cts_ptr < cts->cts_line + len);
-       MB_PTR_ADV(cts->cts_ptr)) {
+  char *end = NULL;
+  if (cts_no_lbr(cts)) {
+    end = cts->cts_ptr + strlen(cts->cts_ptr);
+    if (len != MAXCOL && cts->cts_line + len < end) {
+      end = cts->cts_line + len;
+    }
+  }
+  while (*cts->cts_ptr != NUL && (len == MAXCOL || cts->cts_ptr < cts->cts_line + len)) {
+    if (end != NULL && cts_ascii_run(cts, end)) {
+      continue;
+    }
     cts->cts_vcol += win_lbr_chartabsize(cts, NULL);
+    MB_PTR_ADV(cts->cts_ptr);
   }
   // check for inline virtual text after the end of the line
   if (len == MAXCOL && cts->cts_has_virt_text && *cts->cts_ptr == NUL) {
@@ -113,6 +186,30 @@ void win_linetabsize_cts(chartabsize_T *cts, colnr_T len)
   }
 }
 
+/// Whether each character in "cts" takes just its own size: no 'linebreak',
+/// 'showbreak', 'breakindent' or inline virtual text.
+static bool cts_no_lbr(chartabsize_T *cts)
+{
+  win_T *wp = cts->cts_win;
+  return !wp->w_p_lbr && !wp->w_p_bri && *get_showbreak_value(wp) == NUL
+         && !cts->cts_has_virt_text;
+}
+
+/// Skip over printable ASCII characters before "end", one cell each.
+/// Only to be used when cts_no_lbr() is true.
+///
+/// @return  true when at least one character was skipped.
+static bool cts_ascii_run(chartabsize_T *cts, const char *end)
+{
+  size_t n = utf_ascii_cells_len(cts->cts_ptr, (size_t)(end - cts->cts_ptr));
+  if (n == 0) {
+    return false;
+  }
+  cts->cts_ptr += n;
+  cts->cts_vcol += (colnr_T)n;
+  return true;
+}
+
 /// Prepare the structure passed to chartabsize functions.
 ///
 /// "line" is the start of the line, "ptr" is the first relevant character.
@@ -519,10 +616,25 @@ void getvcol(win_T *wp, pos_T *pos, colnr_T *start, colnr_T *cursor, colnr_T *en
       && *get_showbreak_value(wp) == NUL
       && !wp->w_p_bri
       && !cts.cts_has_virt_text) {
+    // For a long line continue from the remembered virtual column closest
+    // before "pos", and remember more of them past the known part.
+    VcolCache *vc = &wp->w_vcol_cache;
+    colnr_T next_point = INT_MAX;
+    if (posptr == NULL || posptr - line >= VCOL_CACHE_STEP) {
+      ptr += vcol_cache_find(wp, pos->lnum, posptr == NULL ? MAXCOL : (colnr_T)(posptr - line),
+                             &vcol);
+      next_point = kv_size(vc->points) ? kv_last(vc->points).col + VCOL_CACHE_STEP
+                                       : VCOL_CACHE_STEP;
+    }
     while (true) {
       head = 0;
       int c = (uint8_t)(*ptr);
 
+      if (ptr - line >= next_point) {
+        kv_push(vc->points, ((VcolCheckpoint){ .col = (colnr_T)(ptr - line), .vcol = vcol }));
+        next_point = (colnr_T)(ptr - line) + VCOL_CACHE_STEP;
+      }
+
       // make sure we don't go past the end of the line
       if (c == NUL) {
         // NUL at end of line only takes one column
@@ -794,6 +906,37 @@ int plines_win_nofill(win_T *wp, linenr_T lnum, bool limit_winheight)
 /// Get number of window lines physical line "lnum" will occupy in window "wp".
 /// Does not care about folding, 'wrap' or filler lines.
 int plines_win_nofold(win_T *wp, linenr_T lnum)
+{
+  // Inline virtual text can change without a change of the text, don't
+  // remember heights then.
+  if (wp->w_buffer->b_virt_text_inline > 0) {
+    return plines_win_nofold_count(wp, lnum);
+  }
+
+  LineHeightCache *hc = &wp->w_height_cache;
+  buf_T *buf = wp->w_buffer;
+  int width1 = wp->w_width_inner - win_col_off(wp);
+  int width2 = width1 + win_col_off2(wp);
+  if (hc->generation != vcol_cache_generation || hc->buf != buf->handle
+      || hc->changedtick != buf_get_changedtick(buf)
+      || hc->width1 != width1 || hc->width2 != width2) {
+    hc->generation = vcol_cache_generation;
+    hc->buf = buf->handle;
+    hc->changedtick = buf_get_changedtick(buf);
+    hc->width1 = width1;
+    hc->width2 = width2;
+    memset(hc->lnum, 0, sizeof(hc->lnum));
+  }
+
+  size_t idx = (size_t)lnum % LINE_HEIGHT_CACHE_SIZE;
+  if (hc->lnum[idx] != lnum) {
+    hc->lnum[idx] = lnum;
+    hc->height[idx] = plines_win_nofold_count(wp, lnum);
+  }
+  return hc->height[idx];
+}
+
+static int plines_win_nofold_count(win_T *wp, linenr_T lnum)
 {
   char *s = ml_get_buf(wp->w_buffer, lnum);
   chartabsize_T cts;
@@ -1,15 +1,20 @@
 #include <assert.h>
+#include <inttypes.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <uv.h>
 
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
+#include "nvim/atomic_defs.h"
 #include "nvim/charset.h"
 #include "nvim/cmdexpand_defs.h"
 #include "nvim/debugger.h"
+#include "nvim/drawscreen.h"
 #include "nvim/eval.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/eval/userfunc.h"
@@ -20,6 +25,8 @@
 #include "nvim/globals.h"
 #include "nvim/hashtab.h"
 #include "nvim/keycodes.h"
+#include "nvim/lua/executor.h"
+#include "nvim/map_defs.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/os/fs.h"
@@ -297,6 +304,22 @@ void ex_profile(exarg_T *eap)
     do_profiling = PROF_YES;
     profile_set_wait(profile_zero());
     set_vim_var_nr(VV_PROFILING, 1);
+  } else if (len == 6 && strncmp(eap->arg, "redraw", 6) == 0) {
+    if (*e == NUL) {
+      redraw_stats_report();
+    } else if (strcmp(e, "clear") == 0) {
+      redraw_stats_reset();
+    } else {
+      semsg(_(e_invarg2), e);
+    }
+  } else if (len == 6 && strncmp(eap->arg, "sample", 6) == 0) {
+    if (strcmp(e, "stop") == 0) {
+      profile_sample_stop();
+    } else if (*e != NUL) {
+      profile_sample_start(e);
+    } else {
+      emsg(_(e_argreq));
+    }
   } else if (do_profiling == PROF_NONE) {
     emsg(_("E750: First use \":profile start {fname}\""));
   } else if (strcmp(eap->arg, "stop") == 0) {
@@ -323,6 +346,146 @@ void ex_profile(exarg_T *eap)
   }
 }
 
+/// Interval between two samples of ":profile sample", in msec.
+enum { PROF_SAMPLE_INTERVAL = 1, };
+
+/// File ":profile sample" writes to, NULL when not sampling.
+static char *sample_fname = NULL;
+/// Number of samples taken for each folded stack.
+static Map(cstr_t, int) sample_stacks = MAP_INIT;
+
+static uv_thread_t sample_thread;
+static uv_mutex_t sample_mutex;
+static uv_cond_t sample_cond;
+static bool sample_thread_stop;
+
+/// Sets "profile_sample_due" every PROF_SAMPLE_INTERVAL msec until stopped.
+static void sample_thread_main(void *arg)
+{
+  uv_mutex_lock(&sample_mutex);
+  while (!sample_thread_stop) {
+    uv_cond_timedwait(&sample_cond, &sample_mutex, PROF_SAMPLE_INTERVAL * 1000000);
+    ATOMIC_STORE_BOOL(&profile_sample_due, true);
+  }
+  uv_mutex_unlock(&sample_mutex);
+}
+
+/// Start ":profile sample", the folded stacks are written to "fname".
+static void profile_sample_start(const char *fname)
+{
+  if (sample_fname != NULL) {
+    profile_sample_stop();
+  }
+  uv_mutex_init(&sample_mutex);
+  uv_cond_init(&sample_cond);
+  sample_thread_stop = false;
+  if (uv_thread_create(&sample_thread, sample_thread_main, NULL) != 0) {
+    uv_cond_destroy(&sample_cond);
+    uv_mutex_destroy(&sample_mutex);
+    emsg(_("E5610: Cannot start the sampling thread"));
+    return;
+  }
+  sample_fname = expand_env_save_opt((char *)fname, true);
+  nlua_sample_start();
+}
+
+/// Add the frames of the Vimscript execution stack to "gap", outermost first.
+static void sample_ex_stack(garray_T *const gap)
+{
+  for (int idx = 0; idx < exestack.ga_len; idx++) {
+    const estack_T *const entry = ((estack_T *)exestack.ga_data) + idx;
+    if (entry->es_name == NULL) {
+      continue;
+    }
+    if (gap->ga_len > 0) {
+      ga_append(gap, ';');
+    }
+    ga_concat(gap, entry->es_type == ETYPE_UFUNC ? "function " : "");
+    ga_concat(gap, entry->es_name);
+  }
+}
+
+/// Record the current Vimscript and Lua stack, called when
+/// "profile_sample_due" is set.
+void profile_sample_take(void)
+{
+  ATOMIC_STORE_BOOL(&profile_sample_due, false);
+  if (sample_fname == NULL) {
+    return;
+  }
+  garray_T ga;
+  ga_init(&ga, (int)sizeof(char), 200);
+  sample_ex_stack(&ga);
+  nlua_sample_stack(&ga);
+  if (ga.ga_len == 0) {
+    ga_concat(&ga, "[main]");
+  }
+  // A ';' separates frames, a newline ends the stack.
+  for (int i = 0; i < ga.ga_len; i++) {
+    if (((char *)ga.ga_data)[i] == NL) {
+      ((char *)ga.ga_data)[i] = ' ';
+    }
+  }
+  ga_append(&ga, NUL);
+
+  cstr_t *key_alloc = NULL;
+  bool new_item = false;
+  int *count = map_put_ref(cstr_t, int)(&sample_stacks, ga.ga_data, &key_alloc, &new_item);
+  if (new_item) {
+    *key_alloc = ga.ga_data;
+  } else {
+    ga_clear(&ga);
+  }
+  (*count)++;
+}
+
+static int sample_compare(const void *s1, const void *s2)
+{
+  return strcmp(*(const char **)s1, *(const char **)s2);
+}
+
+/// Stop ":profile sample" and write the samples as folded stacks, one
+/// "frame;frame;frame count" line for each stack, as used by flamegraph tools.
+void profile_sample_stop(void)
+{
+  if (sample_fname == NULL) {
+    return;
+  }
+  uv_mutex_lock(&sample_mutex);
+  sample_thread_stop = true;
+  uv_cond_signal(&sample_cond);
+  uv_mutex_unlock(&sample_mutex);
+  uv_thread_join(&sample_thread);
+  uv_cond_destroy(&sample_cond);
+  uv_mutex_destroy(&sample_mutex);
+  nlua_sample_stop();
+  ATOMIC_STORE_BOOL(&profile_sample_due, false);
+
+  const char **stacks = xmalloc(map_size(&sample_stacks) * sizeof(*stacks));
+  size_t n = 0;
+  map_foreach_key(&sample_stacks, stack, {
+    stacks[n++] = stack;
+  });
+  qsort(stacks, n, sizeof(*stacks), sample_compare);
+
+  FILE *fd = os_fopen(sample_fname, "w");
+  if (fd == NULL) {
+    semsg(_(e_notopen), sample_fname);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      fprintf(fd, "%s %d\n", stacks[i], map_get(cstr_t, int)(&sample_stacks, stacks[i]));
+    }
+    fclose(fd);
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    xfree((char *)stacks[i]);
+  }
+  xfree(stacks);
+  map_destroy(cstr_t, &sample_stacks);
+  XFREE_CLEAR(sample_fname);
+}
+
 /// Command line expansion for :profile.
 static enum {
   PEXP_SUBCMD,          ///< expand :profile sub-commands
@@ -335,6 +498,8 @@ static char *pexpand_cmds[] = {
   "file",
   "func",
   "pause",
+  "redraw",
+  "sample",
   "start",
   "stop",
   NULL
@@ -367,6 +532,7 @@ void set_context_in_profile_cmd(expand_T *xp, const char *arg)
   }
 
   if ((end_subcmd - arg == 5 && strncmp(arg, "start", 5) == 0)
+      || (end_subcmd - arg == 6 && strncmp(arg, "sample", 6) == 0)
       || (end_subcmd - arg == 4 && strncmp(arg, "file", 4) == 0)) {
     xp->xp_context = EXPAND_FILES;
     xp->xp_pattern = skipwhite(end_subcmd);
@@ -853,6 +1019,22 @@ void script_line_end(void)
 static proftime_T g_start_time;
 static proftime_T g_prev_time;
 
+/// When true, --startuptime writes Chrome trace events instead of text.
+static bool time_trace = false;
+/// Separator to write before the next trace event.
+static const char *time_trace_sep = "";
+/// Start of the current unnested span and allocation count at that time.
+static proftime_T trace_prev_time;
+static int64_t trace_prev_allocs;
+
+/// Saved by time_push() for a nested span, restored by time_pop().
+typedef struct {
+  proftime_T prev_time;
+  int64_t prev_allocs;
+  int64_t start_allocs;
+} TraceFrame;
+static kvec_t(TraceFrame) trace_stack = KV_INITIAL_VALUE;
+
 /// Saves the previous time before doing something that could nest.
 ///
 /// After calling this function, the static global `g_prev_time` will
@@ -870,6 +1052,13 @@ void time_push(proftime_T *rel, proftime_T *start)
 
   // reset global `g_prev_time` for the next call
   g_prev_time = now;
+
+  if (time_trace) {
+    int64_t allocs = alloc_count_get();
+    kv_push(trace_stack, ((TraceFrame){ trace_prev_time, trace_prev_allocs, allocs }));
+    trace_prev_time = now;
+    trace_prev_allocs = allocs;
+  }
 }
 
 /// Computes the prev time after doing something that could nest.
@@ -880,6 +1069,12 @@ void time_push(proftime_T *rel, proftime_T *start)
 void time_pop(proftime_T tp)
 {
   g_prev_time -= tp;
+
+  if (time_trace && kv_size(trace_stack) > 0) {
+    TraceFrame frame = kv_pop(trace_stack);
+    trace_prev_time = frame.prev_time;
+    trace_prev_allocs = frame.prev_allocs;
+  }
 }
 
 /// Prints the difference between `then` and `now`.
@@ -891,13 +1086,36 @@ static void time_diff(proftime_T then, proftime_T now)
   fprintf(time_fd, "%07.3lf", (double)diff / 1.0E6);
 }
 
+/// Writes a complete ("X") trace event for the span from `then` to `now`.
+///
+/// Timestamps are in microseconds since time_start().
+static void time_trace_event(const char *name, proftime_T then, proftime_T now, int64_t allocs)
+{
+  fprintf(time_fd, "%s{\"name\":\"", time_trace_sep);
+  for (const char *p = name; *p != NUL; p++) {
+    if (*p == '"' || *p == '\\') {
+      fprintf(time_fd, "\\%c", *p);
+    } else if ((uint8_t)(*p) < 0x20) {
+      fprintf(time_fd, "\\u%04x", (unsigned)(*p));
+    } else {
+      fputc(*p, time_fd);
+    }
+  }
+  fprintf(time_fd, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%" PRId64
+          ",\"tid\":0,\"args\":{\"allocs\":%" PRId64 "}}",
+          (double)profile_sub(then, g_start_time) / 1.0E3,
+          (double)profile_sub(now, then) / 1.0E3, os_get_pid(), allocs);
+  time_trace_sep = ",\n";
+}
+
 /// Initializes the startuptime code.
 ///
 /// Must be called once before calling other startuptime code (such as
 /// time_{push,pop,msg,...}).
 ///
 /// @param message the message that will be displayed
-void time_start(const char *message)
+/// @param trace write Chrome trace events (JSON) instead of text
+void time_start(const char *message, bool trace)
 {
   if (time_fd == NULL) {
     return;
@@ -906,6 +1124,15 @@ void time_start(const char *message)
   // initialize the global variables
   g_prev_time = g_start_time = profile_start();
 
+  time_trace = trace;
+  if (trace) {
+    alloc_count_enable(true);
+    trace_prev_time = g_start_time;
+    trace_prev_allocs = alloc_count_get();
+    fprintf(time_fd, "[\n");
+    return;
+  }
+
   fprintf(time_fd, "\n\ntimes in msec\n");
   fprintf(time_fd, " clock   self+sourced   self:  sourced script\n");
   fprintf(time_fd, " clock   elapsed:              other lines\n\n");
@@ -913,6 +1140,27 @@ void time_start(const char *message)
   time_msg(message, NULL);
 }
 
+/// Closes the startuptime file.
+///
+/// In trace mode a span covering the whole startup is added, and the JSON
+/// array is terminated.
+void time_finish(void)
+{
+  if (time_fd == NULL) {
+    return;
+  }
+
+  if (time_trace) {
+    time_trace_event("startup", g_start_time, profile_start(), alloc_count_get());
+    fprintf(time_fd, "\n]\n");
+    alloc_count_enable(false);
+    time_trace = false;
+    kv_destroy(trace_stack);
+  }
+  fclose(time_fd);
+  time_fd = NULL;
+}
+
 /// Prints out timing info.
 ///
 /// @warning don't forget to call `time_start()` once before calling this.
@@ -925,8 +1173,21 @@ void time_msg(const char *mesg, const proftime_T *start)
     return;
   }
 
-  // print out the difference between `start` (init earlier) and `now`
   proftime_T now = profile_start();
+
+  if (time_trace) {
+    int64_t allocs = alloc_count_get();
+    if (start != NULL && kv_size(trace_stack) > 0) {
+      time_trace_event(mesg, *start, now, allocs - kv_last(trace_stack).start_allocs);
+    } else {
+      time_trace_event(mesg, trace_prev_time, now, allocs - trace_prev_allocs);
+    }
+    g_prev_time = trace_prev_time = now;
+    trace_prev_allocs = allocs;
+    return;
+  }
+
+  // print out the difference between `start` (init earlier) and `now`
   time_diff(g_start_time, now);
 
   // if `start` was supplied, print the diff between `start` and `now`
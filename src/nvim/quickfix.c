@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
 #include <stdbool.h>
@@ -9,7 +10,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <uv.h>
 
+#include "klib/kvec.h"
 #include "nvim/arglist.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
@@ -41,6 +44,7 @@
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
+#include "nvim/memory_defs.h"
 #include "nvim/message.h"
 #include "nvim/move.h"
 #include "nvim/normal.h"
@@ -113,6 +117,8 @@ typedef struct qf_list_S {
   qfline_T *qf_start;     ///< pointer to the first error
   qfline_T *qf_last;      ///< pointer to the last error
   qfline_T *qf_ptr;       ///< pointer to the current error
+  kvec_t(qfline_T *) qf_entries;  ///< all errors, error N is at index N - 1
+  Arena qf_arena;         ///< memory for the errors and their strings
   int qf_count;           ///< number of errors (0 means empty list)
   int qf_index;           ///< current index in the error list
   bool qf_nonevalid;      ///< true if not a single valid entry found
@@ -127,6 +133,8 @@ typedef struct qf_list_S {
   struct dir_stack_T *qf_file_stack;
   char *qf_currfile;
   bool qf_multiline;
+  StringBuilder qf_multitext;  ///< text of the last error while continuation
+                               ///< lines are added to it
   bool qf_multiignore;
   bool qf_multiscan;
   int qf_changedtick;
@@ -176,6 +184,14 @@ struct efm_S {
                               // '-' do not include this line
                               // '+' include whole line in message
   int conthere;                 // %> used
+  char fast;                  // EFM_FAST_ value: matched without "prog"
+};
+
+// Formats that qf_parse_get_fields() matches with efm_fast_match().
+enum {
+  EFM_FAST_NONE = 0,
+  EFM_FAST_FLM,   // "%f:%l:%m"
+  EFM_FAST_FLCM,  // "%f:%l:%c:%m"
 };
 
 /// List of location lists to be deleted.
@@ -596,6 +612,18 @@ static void free_efm_list(efm_T **efm_first)
   fmt_start = NULL;
 }
 
+/// Return the EFM_FAST_ value for a 'errorformat' part of "len" bytes.
+static char efm_fast_kind(const char *efm, int len)
+{
+  if (len == 11 && strncmp(efm, "%f:%l:%c:%m", 11) == 0) {
+    return EFM_FAST_FLCM;
+  }
+  if (len == 8 && strncmp(efm, "%f:%l:%m", 8) == 0) {
+    return EFM_FAST_FLM;
+  }
+  return EFM_FAST_NONE;
+}
+
 /// Compute the size of the buffer used to convert a 'errorformat' pattern into
 /// a regular expression pattern.
 static size_t efm_regpat_bufsz(char *efm)
@@ -658,6 +686,7 @@ static efm_T *parse_efm_option(char *efm)
     if ((fmt_ptr->prog = vim_regcomp(fmtstr, RE_MAGIC + RE_STRING)) == NULL) {
       goto parse_efm_error;
     }
+    fmt_ptr->fast = efm_fast_kind(efm, len);
     // Advance to next part
     efm = skip_to_option_part(efm + len);       // skip comma and spaces
   }
@@ -1183,6 +1212,7 @@ static int qf_init_ext(qf_info_T *qi, int qf_idx, const char *restrict efile, bu
 
     line_breakcheck();
   }
+  qf_multitext_done(qfl);
   if (state.fd == NULL || !ferror(state.fd)) {
     if (qfl->qf_index == 0) {
       // no valid entry found
@@ -1572,6 +1602,55 @@ static int qf_parse_match(char *linebuf, size_t linelen, efm_T *fmt_ptr, regmatc
   return QF_OK;
 }
 
+/// Find a "%f:%l:%m" (nnum is 1) or "%f:%l:%c:%m" (nnum is 2) match in "line"
+/// with the file name starting at "name".  Like ".\{-1,}" the file name is
+/// the shortest one that is followed by the numbers and a message.
+static bool efm_fast_scan(char *line, char *name, int nnum, regmatch_T *rmp)
+{
+  if (*name == NUL) {
+    return false;
+  }
+  for (char *p = strchr(name + 1, ':'); p != NULL; p = strchr(p + 1, ':')) {
+    char *s = p + 1;
+    int i;
+    for (i = 0; i < nnum; i++) {
+      char *d = skipdigits(s);
+      if (d == s || *d != ':') {
+        break;
+      }
+      rmp->startp[2 + i] = s;
+      rmp->endp[2 + i] = d;
+      s = d + 1;
+    }
+    if (i == nnum && *s != NUL) {
+      rmp->startp[0] = line;
+      rmp->endp[0] = s + strlen(s);
+      rmp->startp[1] = line;
+      rmp->endp[1] = p;
+      rmp->startp[2 + nnum] = s;
+      rmp->endp[2 + nnum] = rmp->endp[0];
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Match "linebuf" against a format with an EFM_FAST_ value without using the
+/// regexp engine.  Sets the same submatches in "rmp" as the pattern made by
+/// efm_to_regpat() would.
+static bool efm_fast_match(const efm_T *fmt_ptr, char *linebuf, regmatch_T *rmp)
+{
+  const int nnum = fmt_ptr->fast == EFM_FAST_FLCM ? 2 : 1;
+#ifdef BACKSLASH_IN_FILENAME
+  // "\%(\a:\)\=" first tries to include a drive letter in the file name
+  if (ASCII_ISALPHA(linebuf[0]) && linebuf[1] == ':'
+      && efm_fast_scan(linebuf, linebuf + 2, nnum, rmp)) {
+    return true;
+  }
+#endif
+  return efm_fast_scan(linebuf, linebuf, nnum, rmp);
+}
+
 /// Parse an error line in 'linebuf' using a single error format string in
 /// 'fmt_ptr->prog' and return the matching values in 'fields'.
 /// Returns QF_OK if the efm format matches completely and the fields are
@@ -1602,9 +1681,14 @@ static int qf_parse_get_fields(char *linebuf, size_t linelen, efm_T *fmt_ptr, qf
   regmatch_T regmatch;
   // Always ignore case when looking for a matching error.
   regmatch.rm_ic = true;
-  regmatch.regprog = fmt_ptr->prog;
-  int r = vim_regexec(&regmatch, linebuf, 0);
-  fmt_ptr->prog = regmatch.regprog;
+  int r;
+  if (fmt_ptr->fast != EFM_FAST_NONE) {
+    r = efm_fast_match(fmt_ptr, linebuf, &regmatch);
+  } else {
+    regmatch.regprog = fmt_ptr->prog;
+    r = vim_regexec(&regmatch, linebuf, 0);
+    fmt_ptr->prog = regmatch.regprog;
+  }
   int status = QF_FAIL;
   if (r) {
     status = qf_parse_match(linebuf, linelen, fmt_ptr, &regmatch, fields,
@@ -1677,11 +1761,17 @@ static int qf_parse_multiline_pfx(int idx, qf_list_T *qfl, qffields_T *fields)
       return QF_FAIL;
     }
     if (*fields->errmsg) {
-      size_t textlen = strlen(qfprev->qf_text);
-      size_t errlen = strlen(fields->errmsg);
-      qfprev->qf_text = xrealloc(qfprev->qf_text, textlen + errlen + 2);
-      qfprev->qf_text[textlen] = '\n';
-      STRCPY(qfprev->qf_text + textlen + 1, fields->errmsg);
+      // Grow the text in one buffer, qf_multitext_done() moves it to the
+      // arena when the message is complete.
+      StringBuilder *text = &qfl->qf_multitext;
+      if (kv_size(*text) == 0) {
+        kv_concat(*text, qfprev->qf_text);
+      }
+      kv_push(*text, '\n');
+      kv_concat(*text, fields->errmsg);
+      kv_push(*text, NUL);
+      kv_drop(*text, 1);
+      qfprev->qf_text = text->items;
     }
     if (qfprev->qf_nr == -1) {
       qfprev->qf_nr = fields->enr;
@@ -1720,6 +1810,18 @@ static int qf_parse_multiline_pfx(int idx, qf_list_T *qfl, qffields_T *fields)
   return QF_IGNORE_LINE;
 }
 
+/// Move the text of the last error that qf_parse_multiline_pfx() added
+/// continuation lines to into the arena of the list.
+static void qf_multitext_done(qf_list_T *qfl)
+{
+  if (kv_size(qfl->qf_multitext) == 0) {
+    return;
+  }
+  qfl->qf_last->qf_text = arena_memdupz(&qfl->qf_arena, qfl->qf_multitext.items,
+                                        kv_size(qfl->qf_multitext));
+  kv_destroy(qfl->qf_multitext);
+}
+
 /// Queue location list stack delete request.
 static void locstack_queue_delreq(qf_info_T *qi)
 {
@@ -1867,7 +1969,8 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
                         char vis_col, char *pattern, int nr, char type, typval_T *user_data,
                         char valid)
 {
-  qfline_T *qfp = xmalloc(sizeof(qfline_T));
+  qf_multitext_done(qfl);
+  qfline_T *qfp = arena_alloc(&qfl->qf_arena, sizeof(qfline_T), true);
 
   if (bufnum != 0) {
     buf_T *buf = buflist_findnr(bufnum);
@@ -1880,7 +1983,7 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
   } else {
     qfp->qf_fnum = qf_get_fnum(qfl, dir, fname);
   }
-  qfp->qf_text = xstrdup(mesg);
+  qfp->qf_text = arena_memdupz(&qfl->qf_arena, mesg, strlen(mesg));
   qfp->qf_lnum = lnum;
   qfp->qf_end_lnum = end_lnum;
   qfp->qf_col = col;
@@ -1895,12 +1998,12 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
   if (pattern == NULL || *pattern == NUL) {
     qfp->qf_pattern = NULL;
   } else {
-    qfp->qf_pattern = xstrdup(pattern);
+    qfp->qf_pattern = arena_memdupz(&qfl->qf_arena, pattern, strlen(pattern));
   }
   if (module == NULL || *module == NUL) {
     qfp->qf_module = NULL;
   } else {
-    qfp->qf_module = xstrdup(module);
+    qfp->qf_module = arena_memdupz(&qfl->qf_arena, module, strlen(module));
   }
   qfp->qf_nr = nr;
   if (type != 1 && !vim_isprintc(type)) {  // only printable chars allowed
@@ -1924,6 +2027,7 @@ static int qf_add_entry(qf_list_T *qfl, char *dir, char *fname, char *module, in
   qfp->qf_next = NULL;
   qfp->qf_cleared = false;
   *lastp = qfp;
+  kv_push(qfl->qf_entries, qfp);
   qfl->qf_count++;
   if (qfl->qf_index == 0 && qfp->qf_valid) {
     // first valid entry
@@ -2059,6 +2163,9 @@ static int copy_loclist(qf_list_T *from_qfl, qf_list_T *to_qfl)
   to_qfl->qf_start = NULL;
   to_qfl->qf_last = NULL;
   to_qfl->qf_ptr = NULL;
+  kv_init(to_qfl->qf_entries);
+  kv_init(to_qfl->qf_multitext);
+  to_qfl->qf_arena = (Arena)ARENA_EMPTY;
   if (from_qfl->qf_title != NULL) {
     to_qfl->qf_title = xstrdup(from_qfl->qf_title);
   } else {
@@ -2450,25 +2557,13 @@ static qfline_T *get_nth_valid_entry(qf_list_T *qfl, int errornr, int dir, int *
 /// list 'qfl'. Returns a pointer to the new entry and the index in 'new_qfidx'
 static qfline_T *get_nth_entry(qf_list_T *qfl, int errornr, int *new_qfidx)
 {
-  qfline_T *qf_ptr = qfl->qf_ptr;
-  int qf_idx = qfl->qf_index;
-
-  // New error number is less than the current error number
-  while (errornr < qf_idx && qf_idx > 1 && qf_ptr->qf_prev != NULL) {
-    qf_idx--;
-    qf_ptr = qf_ptr->qf_prev;
+  if (qfl->qf_count == 0) {
+    *new_qfidx = qfl->qf_index;
+    return qfl->qf_ptr;
   }
-
-  // New error number is greater than the current error number
-  while (errornr > qf_idx
-         && qf_idx < qfl->qf_count
-         && qf_ptr->qf_next != NULL) {
-    qf_idx++;
-    qf_ptr = qf_ptr->qf_next;
-  }
-
+  int qf_idx = MAX(MIN(errornr, qfl->qf_count), 1);
   *new_qfidx = qf_idx;
-  return qf_ptr;
+  return kv_A(qfl->qf_entries, qf_idx - 1);
 }
 
 /// Get a entry specified by 'errornr' and 'dir' from the current
@@ -3397,29 +3492,14 @@ void qf_history(exarg_T *eap)
 /// associated with the list like context and title are not freed.
 static void qf_free_items(qf_list_T *qfl)
 {
-  bool stop = false;
-
-  while (qfl->qf_count && qfl->qf_start != NULL) {
-    qfline_T *qfp = qfl->qf_start;
-    qfline_T *qfpnext = qfp->qf_next;
-    if (!stop) {
-      xfree(qfp->qf_module);
-      xfree(qfp->qf_text);
-      xfree(qfp->qf_pattern);
-      tv_clear(&qfp->qf_user_data);
-      stop = (qfp == qfpnext);
-      xfree(qfp);
-      if (stop) {
-        // Somehow qf_count may have an incorrect value, set it to 1
-        // to avoid crashing when it's wrong.
-        // TODO(vim): Avoid qf_count being incorrect.
-        qfl->qf_count = 1;
-      } else {
-        qfl->qf_start = qfpnext;
-      }
-    }
-    qfl->qf_count--;
+  for (size_t i = 0; i < kv_size(qfl->qf_entries); i++) {
+    tv_clear(&kv_A(qfl->qf_entries, i)->qf_user_data);
   }
+  kv_destroy(qfl->qf_entries);
+  kv_init(qfl->qf_entries);
+  kv_destroy(qfl->qf_multitext);
+  arena_mem_free(arena_finish(&qfl->qf_arena));
+  qfl->qf_count = 0;
 
   qfl->qf_start = NULL;
   qfl->qf_ptr = NULL;
@@ -5222,6 +5302,281 @@ static buf_T *vgr_load_dummy_buf(char *fname, char *dirname_start, char *dirname
   return buf;
 }
 
+/// Files that are not loaded in a buffer are read by these threads, so that
+/// files that can't match can be skipped without loading a dummy buffer.
+#define VGR_READ_THREADS 4
+/// Number of files read ahead of the one being searched.
+#define VGR_READ_AHEAD 64
+/// Larger files are not read ahead, they are loaded into a buffer.
+#define VGR_READ_MAX (8 * 1024 * 1024)
+
+/// A file read by a vimgrep reader thread.
+typedef struct {
+  char *data;  ///< NUL terminated file contents or NULL, allocated with malloc()
+  size_t len;  ///< length of "data"
+  bool done;   ///< reading has finished
+} vgr_file_T;
+
+/// Threads reading the files for vimgrep.
+typedef struct {
+  char **fnames;      ///< full file names, NULL for a file not to be read
+  vgr_file_T *files;
+  int fcount;
+  int next;           ///< index of the next file to read
+  int limit;          ///< don't read files from this index on yet
+  bool stop;          ///< threads should stop
+  uv_mutex_t mutex;
+  uv_cond_t cond;     ///< signaled when a file was read or "limit" changed
+  uv_thread_t threads[VGR_READ_THREADS];
+  int nthreads;
+} vgr_reader_T;
+
+/// Read file "fname" using "loop".  Called in a reader thread, thus must not
+/// use xmalloc() and other functions that are not thread-safe.
+///
+/// @return  the NUL terminated file contents or NULL when it can't be read
+///          or is too big.
+static char *vgr_read_file(uv_loop_t *loop, const char *fname, size_t *lenp)
+{
+  uv_fs_t req;
+  int fd = uv_fs_open(loop, &req, fname, O_RDONLY, 0, NULL);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  char *data = NULL;
+  int r = uv_fs_fstat(loop, &req, fd, NULL);
+  uint64_t size = req.statbuf.st_size;
+  bool regular = S_ISREG(req.statbuf.st_mode);
+  uv_fs_req_cleanup(&req);
+  if (r == 0 && regular && size <= VGR_READ_MAX) {
+    data = malloc((size_t)size + 1);
+  }
+  size_t len = 0;
+  while (data != NULL) {
+    uv_buf_t buf = uv_buf_init(data + len, (unsigned)(size - len));
+    r = uv_fs_read(loop, &req, fd, &buf, 1, -1, NULL);
+    uv_fs_req_cleanup(&req);
+    if (r < 0) {
+      free(data);
+      data = NULL;
+    } else if (r == 0 || (len += (size_t)r) == size) {
+      break;
+    }
+  }
+  uv_fs_close(loop, &req, fd, NULL);
+  uv_fs_req_cleanup(&req);
+
+  if (data != NULL) {
+    data[len] = NUL;
+    *lenp = len;
+  }
+  return data;
+}
+
+static void vgr_reader_thread(void *arg)
+{
+  vgr_reader_T *rd = arg;
+  uv_loop_t loop;
+  bool loop_ok = uv_loop_init(&loop) == 0;
+
+  uv_mutex_lock(&rd->mutex);
+  while (!rd->stop && rd->next < rd->fcount) {
+    if (rd->next >= rd->limit) {
+      uv_cond_wait(&rd->cond, &rd->mutex);
+      continue;
+    }
+    int fi = rd->next++;
+    uv_mutex_unlock(&rd->mutex);
+
+    size_t len = 0;
+    char *data = NULL;
+    if (loop_ok && rd->fnames[fi] != NULL) {
+      data = vgr_read_file(&loop, rd->fnames[fi], &len);
+    }
+
+    uv_mutex_lock(&rd->mutex);
+    rd->files[fi].data = data;
+    rd->files[fi].len = len;
+    rd->files[fi].done = true;
+    uv_cond_broadcast(&rd->cond);
+  }
+  uv_mutex_unlock(&rd->mutex);
+
+  if (loop_ok) {
+    uv_loop_close(&loop);
+  }
+}
+
+/// Check whether a file that isn't loaded is read the same way by vimgrep
+/// on every line, so that a file without a matching line can be skipped.
+static bool vgr_can_skip_file(char *fname)
+{
+  static const event_T events[] = {
+    EVENT_BUFNEW, EVENT_BUFADD, EVENT_BUFREADCMD, EVENT_BUFREADPRE,
+    EVENT_BUFREADPOST, EVENT_BUFENTER, EVENT_BUFWINENTER,
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(events); i++) {
+    if (has_autocmd(events[i], fname, NULL)) {
+      return false;  // an autocommand may change the text
+    }
+  }
+  return true;
+}
+
+/// Check whether the pattern of "args" can be used to search files read by
+/// the reader threads: it matches in a single line, doesn't depend on the
+/// buffer or window, and the files are read as UTF-8 with NL line breaks.
+static bool vgr_can_read_ahead(vgr_args_T *args)
+{
+  if ((args->flags & VGR_FUZZY) || args->fcount < 2 || args->regmatch.regprog == NULL
+      || re_multiline(args->regmatch.regprog)
+      || re_pat_uses_position(*args->spat == NUL ? last_search_pat() : args->spat)
+      || strcmp(curbuf->b_p_isk, p_isk) != 0) {
+    return false;
+  }
+
+  if (*p_ffs == NUL ? *p_ff == 'm' : strncmp(p_ffs, "mac", 3) == 0) {
+    return false;
+  }
+
+  // Valid UTF-8 must be detected as UTF-8.
+  char *fencs = p_fencs;
+  while (*fencs != NUL) {
+    char enc[20];
+    copy_option_part(&fencs, enc, sizeof(enc), ",");
+    if (strcmp(enc, "ucs-bom") != 0) {
+      return strcmp(enc, "utf-8") == 0 || strcmp(enc, "utf8") == 0
+             || strcmp(enc, "default") == 0;
+    }
+  }
+  return true;
+}
+
+/// Start threads reading the files of "args" that are not loaded in a
+/// buffer.
+///
+/// @return  the reader or NULL when files are not read ahead.
+static vgr_reader_T *vgr_reader_start(vgr_args_T *args)
+{
+  if (!vgr_can_read_ahead(args)) {
+    return NULL;
+  }
+
+  vgr_reader_T *rd = xcalloc(1, sizeof(vgr_reader_T));
+  rd->fcount = args->fcount;
+  rd->fnames = xcalloc((size_t)rd->fcount, sizeof(char *));
+  rd->files = xcalloc((size_t)rd->fcount, sizeof(vgr_file_T));
+  rd->limit = VGR_READ_AHEAD;
+  for (int fi = 0; fi < rd->fcount; fi++) {
+    buf_T *buf = buflist_findname_exp(args->fnames[fi]);
+    if ((buf == NULL || buf->b_ml.ml_mfp == NULL) && vgr_can_skip_file(args->fnames[fi])) {
+      // Use the full name, an autocommand may change the directory.
+      rd->fnames[fi] = FullName_save(args->fnames[fi], true);
+    }
+  }
+
+  uv_mutex_init(&rd->mutex);
+  uv_cond_init(&rd->cond);
+  for (int i = 0; i < VGR_READ_THREADS; i++) {
+    if (uv_thread_create(&rd->threads[rd->nthreads], vgr_reader_thread, rd) == 0) {
+      rd->nthreads++;
+    }
+  }
+  if (rd->nthreads == 0) {
+    vgr_reader_stop(rd);
+    return NULL;
+  }
+  return rd;
+}
+
+/// Stop the reader threads and free "rd".
+static void vgr_reader_stop(vgr_reader_T *rd)
+{
+  if (rd == NULL) {
+    return;
+  }
+  uv_mutex_lock(&rd->mutex);
+  rd->stop = true;
+  uv_cond_broadcast(&rd->cond);
+  uv_mutex_unlock(&rd->mutex);
+  for (int i = 0; i < rd->nthreads; i++) {
+    uv_thread_join(&rd->threads[i]);
+  }
+  uv_cond_destroy(&rd->cond);
+  uv_mutex_destroy(&rd->mutex);
+
+  for (int fi = 0; fi < rd->fcount; fi++) {
+    xfree(rd->fnames[fi]);
+    free(rd->files[fi].data);
+  }
+  xfree(rd->fnames);
+  xfree(rd->files);
+  xfree(rd);
+}
+
+/// Wait for file "fi" to be read.
+///
+/// @return  the contents, to be freed with free(), or NULL.
+static char *vgr_reader_get(vgr_reader_T *rd, int fi, size_t *lenp)
+{
+  if (rd->fnames[fi] == NULL) {
+    return NULL;
+  }
+  uv_mutex_lock(&rd->mutex);
+  if (rd->limit < fi + VGR_READ_AHEAD) {
+    rd->limit = fi + VGR_READ_AHEAD;
+    uv_cond_broadcast(&rd->cond);
+  }
+  while (!rd->files[fi].done) {
+    uv_cond_wait(&rd->cond, &rd->mutex);
+  }
+  char *data = rd->files[fi].data;
+  *lenp = rd->files[fi].len;
+  rd->files[fi].data = NULL;
+  uv_mutex_unlock(&rd->mutex);
+  return data;
+}
+
+/// Check whether no line in "data" of a file read by the reader threads
+/// matches "regmatch".  Changes the line breaks in "data" into NULs.
+///
+/// @return  true when the file can be skipped, false when it must be loaded
+///          into a buffer to find out.
+static bool vgr_file_has_no_match(char *data, size_t len, regmmatch_T *regmatch)
+{
+  // A BOM is removed, a CR may be removed and a NUL is a NL in the buffer.
+  if ((len >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0)
+      || memchr(data, CAR, len) != NULL || memchr(data, NUL, len) != NULL
+      || !utf_valid_string(data, data + len)) {
+    return false;
+  }
+
+  regmatch_T rm = {
+    .regprog = regmatch->regprog,
+    .rm_ic = regmatch->rmm_ic,
+  };
+  bool no_match = true;
+  char *const end = data + len;
+  for (char *line = data; no_match && rm.regprog != NULL;) {
+    char *nl = memchr(line, NL, (size_t)(end - line));
+    if (nl != NULL) {
+      *nl = NUL;
+    }
+    if (vim_regexec(&rm, line, 0)) {
+      no_match = false;
+    }
+    if (nl == NULL || nl + 1 == end) {
+      break;
+    }
+    line = nl + 1;
+  }
+  // The program may have been recompiled.
+  regmatch->regprog = rm.regprog;
+  return no_match && rm.regprog != NULL;
+}
+
 /// Check whether a quickfix/location list is valid. Autocmds may remove or
 /// change a quickfix list when vimgrep is running. If the list is not found,
 /// create a new list.
@@ -5447,6 +5802,8 @@ static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, boo
   // ":lcd %:p:h" changes the meaning of short path names.
   os_dirname(dirname_start, MAXPATHL);
 
+  vgr_reader_T *reader = vgr_reader_start(cmd_args);
+
   time_t seconds = 0;
   for (int fi = 0; fi < cmd_args->fcount && !got_int && cmd_args->tomatch > 0; fi++) {
     char *fname = path_try_shorten_fname(cmd_args->fnames[fi]);
@@ -5459,6 +5816,17 @@ static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, boo
 
     buf_T *buf = buflist_findname_exp(cmd_args->fnames[fi]);
     bool using_dummy;
+    if (reader != NULL && (buf == NULL || buf->b_ml.ml_mfp == NULL)
+        && vgr_can_skip_file(cmd_args->fnames[fi])) {
+      size_t len;
+      char *data = vgr_reader_get(reader, fi, &len);
+      bool skip = data != NULL && vgr_file_has_no_match(data, len, &cmd_args->regmatch);
+      free(data);
+      if (skip) {
+        continue;
+      }
+      line_breakcheck();
+    }
     if (buf == NULL || buf->b_ml.ml_mfp == NULL) {
       // Remember that a buffer with this name already exists.
       duplicate_name = (buf != NULL);
@@ -5555,6 +5923,7 @@ static int vgr_process_files(win_T *wp, qf_info_T *qi, vgr_args_T *cmd_args, boo
   status = OK;
 
 theend:
+  vgr_reader_stop(reader);
   xfree(dirname_now);
   xfree(dirname_start);
   return status;
@@ -35,6 +35,35 @@ void rbuffer_free(RBuffer *buf) FUNC_ATTR_NONNULL_ALL
   xfree(buf);
 }
 
+/// Moves the contents of `buf` to a new `RBuffer` with `capacity` bytes, which
+/// must be enough to hold them, and frees `buf`. The callbacks are kept, but
+/// not invoked.
+RBuffer *rbuffer_resize(RBuffer *buf, size_t capacity)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_NONNULL_RET
+{
+  assert(capacity >= buf->size);
+  RBuffer *rv = rbuffer_new(capacity);
+  rv->full_cb = buf->full_cb;
+  rv->nonfull_cb = buf->nonfull_cb;
+  rv->data = buf->data;
+
+  size_t count;
+  char *ptr = rbuffer_read_ptr(buf, &count);
+  memcpy(rv->start_ptr, ptr, count);
+  if (count < buf->size) {
+    // the data wraps around
+    memcpy(rv->start_ptr + count, buf->start_ptr, buf->size - count);
+  }
+  rv->size = buf->size;
+  rv->write_ptr = rv->start_ptr + rv->size;
+  if (rv->write_ptr >= rv->end_ptr) {
+    rv->write_ptr -= rbuffer_capacity(rv);
+  }
+
+  rbuffer_free(buf);
+  return rv;
+}
+
 /// Return a pointer to a raw buffer containing the first empty slot available
 /// for writing. The second argument is a pointer to the maximum number of
 /// bytes that could be written.
@@ -57,20 +86,36 @@ char *rbuffer_write_ptr(RBuffer *buf, size_t *write_count) FUNC_ATTR_NONNULL_ALL
   return buf->write_ptr;
 }
 
-// Reset an RBuffer so read_ptr is at the beginning of the memory. If
-// necessary, this moves existing data by allocating temporary memory.
+// Reset an RBuffer so read_ptr is at the beginning of the memory, making the
+// unread data a single chunk for rbuffer_read_ptr(). The data is moved in
+// place; temporary memory is only used when it wraps around and the free gap
+// between the two chunks is smaller than the first one.
 void rbuffer_reset(RBuffer *buf) FUNC_ATTR_NONNULL_ALL
 {
-  size_t temp_size;
-  if ((temp_size = rbuffer_size(buf))) {
-    if (buf->temp == NULL) {
-      buf->temp = xcalloc(1, rbuffer_capacity(buf));
+  size_t size = buf->size;
+  if (size && buf->read_ptr != buf->start_ptr) {
+    if (buf->read_ptr < buf->write_ptr || buf->write_ptr == buf->start_ptr) {
+      memmove(buf->start_ptr, buf->read_ptr, size);
+    } else {
+      size_t first = (size_t)(buf->end_ptr - buf->read_ptr);
+      size_t second = (size_t)(buf->write_ptr - buf->start_ptr);
+      if (first <= rbuffer_space(buf)) {
+        memmove(buf->start_ptr + first, buf->start_ptr, second);
+        memcpy(buf->start_ptr, buf->read_ptr, first);
+      } else {
+        if (buf->temp == NULL) {
+          buf->temp = xcalloc(1, rbuffer_capacity(buf));
+        }
+        memcpy(buf->temp, buf->start_ptr, second);
+        memmove(buf->start_ptr, buf->read_ptr, first);
+        memcpy(buf->start_ptr + first, buf->temp, second);
+      }
     }
-    rbuffer_read(buf, buf->temp, buf->size);
   }
-  buf->read_ptr = buf->write_ptr = buf->start_ptr;
-  if (temp_size) {
-    rbuffer_write(buf, buf->temp, temp_size);
+  buf->read_ptr = buf->start_ptr;
+  buf->write_ptr = buf->start_ptr + size;
+  if (buf->write_ptr >= buf->end_ptr) {
+    buf->write_ptr -= rbuffer_capacity(buf);
   }
 }
 
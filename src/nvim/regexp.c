@@ -25,6 +25,7 @@
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
 #include "nvim/keycodes.h"
+#include "nvim/log.h"
 #include "nvim/macros_defs.h"
 #include "nvim/mark.h"
 #include "nvim/mbyte.h"
@@ -520,6 +521,21 @@ int re_multiline(const regprog_T *prog)
   return prog->regflags & RF_HASNL;
 }
 
+// Return true if pattern "pat" may contain an item that depends on the line
+// number, a column, a mark, the cursor, the Visual area or the start or end
+// of the file, thus a match in a line can change when other lines or the
+// window change.  Also true for a literal "%5", there is no need to be exact.
+bool re_pat_uses_position(const char *pat)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  for (const char *p = strchr(pat, '%'); p != NULL; p = strchr(p + 1, '%')) {
+    if (ascii_isdigit(p[1]) || (p[1] != NUL && vim_strchr("<>'#V.^$", (uint8_t)p[1]) != NULL)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // Check for an equivalence class name "[=a=]".  "pp" points to the '['.
 // Returns a character representing the class. Zero means that no item was
 // recognized.  Otherwise "pp" is advanced to after the item.
@@ -1068,12 +1084,17 @@ static int read_limits(int *minval, int *maxval)
 // vim_regexec and friends
 
 // Global work variables for vim_regexec().
+// These are thread-local, so that a compiled program can be executed in
+// another thread than the main thread.  Compiling still has to be done in
+// the main thread, with RE_NOBREAK to avoid checking for CTRL-C, and a
+// program must not be executed by two threads at the same time, it contains
+// state.
 
 // Sometimes need to save a copy of a line.  Since alloc()/free() is very
 // slow, we keep one allocated piece of memory and only re-allocate it when
 // it's too small.  It's freed in bt_regexec_both() when finished.
-static uint8_t *reg_tofree = NULL;
-static unsigned reg_tofreelen;
+static THREAD_LOCAL uint8_t *reg_tofree = NULL;
+static THREAD_LOCAL unsigned reg_tofreelen;
 
 // Structure used to store the execution state of the regex engine.
 // Which ones are set depends on whether a single-line or multi-line match is
@@ -1144,8 +1165,8 @@ typedef struct {
   int nfa_has_zsubexpr;  ///< NFA regexp has \z( ), set zsubexpr.
 } regexec_T;
 
-static regexec_T rex;
-static bool rex_in_use = false;
+static THREAD_LOCAL regexec_T rex;
+static THREAD_LOCAL bool rex_in_use = false;
 
 static void reg_breakcheck(void)
 {
@@ -1612,6 +1633,29 @@ static inline char *cstrchr(const char *const s, const int c)
   return strpbrk(s, tofind);
 }
 
+/// Check if "must", which is "mlen" bytes and must be part of any match,
+/// appears in "s".  Used very often, esp. for ":global", to skip lines that
+/// can't match.
+static bool find_regmust(const uint8_t *s, const uint8_t *must, int mlen)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (!rex.reg_ic && !rex.reg_icombine) {
+    // strstr() is much faster than checking every occurrence of the first
+    // character.
+    return strstr((char *)s, (char *)must) != NULL;
+  }
+
+  int c = utf_ptr2char((char *)must);
+  while ((s = (uint8_t *)cstrchr((char *)s, c)) != NULL) {
+    int len = mlen;
+    if (cstrncmp((char *)s, (char *)must, &len) == 0) {
+      return true;
+    }
+    MB_PTR_ADV(s);
+  }
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////
 //                    regsub stuff                            //
 ////////////////////////////////////////////////////////////////
@@ -1845,7 +1889,7 @@ static int vim_regsub_both(char *source, typval_T *expr, char *dest, int destlen
   fptr_T func_one = (fptr_T)NULL;
   linenr_T clnum = 0;           // init for GCC
   int len = 0;                  // init for GCC
-  static int nesting = 0;
+  static THREAD_LOCAL int nesting = 0;
   bool copy = flags & REGSUB_COPY;
 
   // Be paranoid...
@@ -2674,10 +2718,10 @@ typedef struct backpos_S {
 // "regstack" is a stack with regitem_T items, sometimes preceded by regstar_T
 // or regbehind_T.
 // "backpos_T" is a table with backpos_T for BACK
-static garray_T regstack = GA_EMPTY_INIT_VALUE;
-static garray_T backpos = GA_EMPTY_INIT_VALUE;
+static THREAD_LOCAL garray_T regstack = GA_EMPTY_INIT_VALUE;
+static THREAD_LOCAL garray_T backpos = GA_EMPTY_INIT_VALUE;
 
-static regsave_T behind_pos;
+static THREAD_LOCAL regsave_T behind_pos;
 
 // Both for regstack and backpos tables we use the following strategy of
 // allocation (to reduce malloc/free calls):
@@ -5311,8 +5355,8 @@ static void bt_regfree(regprog_T *prog)
 // The arguments from BRACE_LIMITS are stored here.  They are actually local
 // to regmatch(), but they are here to reduce the amount of stack space used
 // (it can be called recursively many times).
-static int64_t bl_minval;
-static int64_t bl_maxval;
+static THREAD_LOCAL int64_t bl_minval;
+static THREAD_LOCAL int64_t bl_maxval;
 
 // Save the input line and position in a regsave_T.
 static void reg_save(regsave_T *save, garray_T *gap)
@@ -7325,30 +7369,8 @@ static int bt_regexec_both(uint8_t *line, colnr_T startcol, proftime_T *tm, int
   }
 
   // If there is a "must appear" string, look for it.
-  if (prog->regmust != NULL) {
-    int c = utf_ptr2char((char *)prog->regmust);
-    s = line + col;
-
-    // This is used very often, esp. for ":global".  Use two versions of
-    // the loop to avoid overhead of conditions.
-    if (!rex.reg_ic) {
-      while ((s = (uint8_t *)vim_strchr((char *)s, c)) != NULL) {
-        if (cstrncmp((char *)s, (char *)prog->regmust, &prog->regmlen) == 0) {
-          break;  // Found it.
-        }
-        MB_PTR_ADV(s);
-      }
-    } else {
-      while ((s = (uint8_t *)cstrchr((char *)s, c)) != NULL) {
-        if (cstrncmp((char *)s, (char *)prog->regmust, &prog->regmlen) == 0) {
-          break;  // Found it.
-        }
-        MB_PTR_ADV(s);
-      }
-    }
-    if (s == NULL) {  // Not present.
-      goto theend;
-    }
+  if (prog->regmust != NULL && !find_regmust(line + col, prog->regmust, prog->regmlen)) {
+    goto theend;
   }
 
   rex.line = line;
@@ -8011,6 +8033,14 @@ static uint8_t *regprop(uint8_t *op)
 // Added to NFA_ANY - NFA_NUPPER_IC to include a NL.
 #define NFA_ADD_NL              31
 
+// Only look for a required text in patterns with up to this many states.
+#define NFA_REGMUST_MAX_STATES  500
+
+// Maximum number of states of the lazy DFA, see nfa_dfa_can_match().
+#define NFA_DFA_MAX_STATES      512
+// The DFA remembers transitions for characters below this.
+#define NFA_DFA_ASCII           128
+
 enum {
   NFA_SPLIT = -1024,
   NFA_MATCH,
@@ -8237,10 +8267,10 @@ static int nstate;  ///< Number of states in the NFA. Also used when executing.
 static int istate;  ///< Index in the state vector, used in alloc_state()
 
 // If not NULL match must end at this position
-static save_se_T *nfa_endp = NULL;
+static THREAD_LOCAL save_se_T *nfa_endp = NULL;
 
 // 0 for first call to nfa_regmatch(), 1 for recursive call.
-static int nfa_ll_index = 0;
+static THREAD_LOCAL int nfa_ll_index = 0;
 
 // Helper functions used when doing re2post() ... regatom() parsing
 #define EMIT(c) \
@@ -8450,6 +8480,119 @@ static uint8_t *nfa_get_match_text(nfa_state_T *start)
   return ret;
 }
 
+/// Check if NFA_MATCH can be reached from "start" without going through
+/// state "avoid".  The text matched by look-around and collections is not
+/// followed, only what comes after it.
+///
+/// @param seen   per state id, set to "stamp" when visited
+/// @param stack  space for "nstate" pointers
+static bool nfa_match_reachable(nfa_state_T *start, const nfa_state_T *avoid, int *seen, int stamp,
+                                nfa_state_T **stack)
+{
+  int depth = 0;
+  stack[depth++] = start;
+  seen[start->id] = stamp;
+  while (depth > 0) {
+    nfa_state_T *p = stack[--depth];
+    nfa_state_T *next[2] = { p->out, p->out1 };
+    switch (p->c) {
+    case NFA_MATCH:
+      return true;
+    case NFA_START_COLL:
+    case NFA_START_NEG_COLL:
+    case NFA_COMPOSING:
+    case NFA_START_INVISIBLE:
+    case NFA_START_INVISIBLE_FIRST:
+    case NFA_START_INVISIBLE_NEG:
+    case NFA_START_INVISIBLE_NEG_FIRST:
+    case NFA_START_INVISIBLE_BEFORE:
+    case NFA_START_INVISIBLE_BEFORE_FIRST:
+    case NFA_START_INVISIBLE_BEFORE_NEG:
+    case NFA_START_INVISIBLE_BEFORE_NEG_FIRST:
+    case NFA_START_PATTERN:
+      // "out" is the text inside, "out1" the end state.
+      next[0] = NULL;
+      break;
+    }
+    for (int i = 0; i < 2; i++) {
+      if (next[i] != NULL && next[i] != avoid && seen[next[i]->id] != stamp) {
+        seen[next[i]->id] = stamp;
+        stack[depth++] = next[i];
+      }
+    }
+  }
+  return false;
+}
+
+/// Figure out the longest literal text that every match of "prog" must
+/// contain, to quickly skip lines that don't match.  A character state is
+/// required when NFA_MATCH can't be reached without it.
+///
+/// @return  the text in allocated memory or NULL.
+static uint8_t *nfa_get_regmust(nfa_regprog_T *prog, int *lenp)
+{
+  // A match can't span lines, this is quadratic in the number of states.
+  if ((prog->regflags & RF_HASNL) || prog->match_text != NULL
+      || prog->nstate > NFA_REGMUST_MAX_STATES) {
+    return NULL;
+  }
+
+  int n = prog->nstate;
+  int *seen = xcalloc((size_t)n, sizeof(int));
+  nfa_state_T **stack = xmalloc((size_t)n * sizeof(nfa_state_T *));
+  bool *must = xcalloc((size_t)n, sizeof(bool));
+  bool *follows = xcalloc((size_t)n, sizeof(bool));
+  int stamp = 0;
+
+  for (int i = 0; i < n; i++) {
+    nfa_state_T *p = &prog->state[i];
+    if (p->c > 0 && !nfa_match_reachable(prog->start, p, seen, ++stamp, stack)) {
+      must[i] = true;
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    nfa_state_T *out = prog->state[i].out;
+    if (must[i] && out != NULL && out->c > 0 && must[out->id]) {
+      follows[out->id] = true;
+    }
+  }
+
+  // Find the longest run of required characters that directly follow each
+  // other.
+  nfa_state_T *longest = NULL;
+  int longest_len = 0;
+  for (int i = 0; i < n; i++) {
+    if (!must[i] || follows[i]) {
+      continue;
+    }
+    int len = 0;
+    for (nfa_state_T *p = &prog->state[i]; p != NULL && p->c > 0 && must[p->id]; p = p->out) {
+      len += utf_char2len(p->c);
+    }
+    if (len > longest_len) {
+      longest = &prog->state[i];
+      longest_len = len;
+    }
+  }
+
+  uint8_t *ret = NULL;
+  if (longest != NULL) {
+    ret = xmalloc((size_t)longest_len + 1);
+    char *s = (char *)ret;
+    for (nfa_state_T *p = longest; p != NULL && p->c > 0 && must[p->id]; p = p->out) {
+      s += utf_char2bytes(p->c, s);
+    }
+    *s = NUL;
+    *lenp = longest_len;
+  }
+
+  xfree(seen);
+  xfree(stack);
+  xfree(must);
+  xfree(follows);
+  return ret;
+}
+
 // Allocate more space for post_start.  Called when
 // running above the estimated number of states.
 static void realloc_post_list(void)
@@ -11298,6 +11441,9 @@ static void nfa_dump(nfa_regprog_T *prog)
   if (prog->match_text != NULL) {
     fprintf(debugf, "match_text: \"%s\"\n", prog->match_text);
   }
+  if (prog->regmust != NULL) {
+    fprintf(debugf, "regmust: \"%s\"\n", prog->regmust);
+  }
 
   fclose(debugf);
 }
@@ -12298,10 +12444,10 @@ static char *pim_info(const nfa_pim_T *pim)
 #endif
 
 // Used during execution: whether a match has been found.
-static int nfa_match;
-static proftime_T *nfa_time_limit;
-static int *nfa_timed_out;
-static int nfa_time_count;
+static THREAD_LOCAL int nfa_match;
+static THREAD_LOCAL proftime_T *nfa_time_limit;
+static THREAD_LOCAL int *nfa_timed_out;
+static THREAD_LOCAL int nfa_time_count;
 
 // Copy postponed invisible match info from "from" to "to".
 static void copy_pim(nfa_pim_T *to, nfa_pim_T *from)
@@ -12692,11 +12838,11 @@ static regsubs_T *addstate(nfa_list_T *l, nfa_state_T *state, regsubs_T *subs_ar
   int i;
   regsub_T *sub;
   regsubs_T *subs = subs_arg;
-  static regsubs_T temp_subs;
+  static THREAD_LOCAL regsubs_T temp_subs;
 #ifdef REGEXP_DEBUG
   int did_print = false;
 #endif
-  static int depth = 0;
+  static THREAD_LOCAL int depth = 0;
 
   // This function is called recursively.  When the depth is too much we run
   // out of stack and crash, limit recursiveness here.
@@ -15101,6 +15247,414 @@ theend:
   return nfa_match;
 }
 
+// A lazy DFA is used to quickly find out that a line can't match.  Each DFA
+// state is a set of NFA states that consume a character or wait for the end
+// of the line.  The transitions for ASCII characters are remembered, others
+// are computed every time.  Since the DFA only finds out whether there is a
+// match, not where, the NFA still has to run for a line that matches.
+
+/// State of the lazy DFA.
+typedef struct {
+  int *ids;                        ///< sorted ids of the NFA states
+  int nids;                        ///< number of items in "ids"
+  bool match;                      ///< NFA_MATCH was reached
+  int8_t eol_match;                ///< -1 unknown, else whether a match ends at the EOL
+  int16_t next[NFA_DFA_ASCII];     ///< next state for an ASCII char, -1 unknown
+} nfa_dfa_state_T;
+
+struct nfa_dfa_S {
+  bool reg_ic;                     ///< rex.reg_ic the states were made for
+  nfa_dfa_state_T *states;
+  int nstates;
+  int start;                       ///< state not at the start of the line or -1
+  int start_bol;                   ///< state at the start of the line or -1
+  int16_t table[2 * NFA_DFA_MAX_STATES];  ///< hash table of "states", -1 unused
+
+  // Scratch space for building a set.
+  int *ids;
+  int nids;
+  int *seen;
+  int stamp;
+  nfa_state_T **stack;
+};
+
+/// Check whether the DFA can be used for "prog": a match can't span lines
+/// and there are no states that depend on more than the current character
+/// or on option values.
+static bool nfa_dfa_eligible(nfa_regprog_T *prog)
+{
+  if ((prog->regflags & RF_HASNL) || prog->has_backref || prog->reghasz == REX_SET) {
+    return false;
+  }
+  for (int i = 0; i < prog->nstate; i++) {
+    int c = prog->state[i].c;
+    if (c > 0
+        || (c >= NFA_MOPEN && c <= NFA_MOPEN9)
+        || (c >= NFA_MCLOSE && c <= NFA_MCLOSE9)
+        || (c >= NFA_ANY && c <= NFA_NUPPER_IC
+            && c != NFA_IDENT && c != NFA_SIDENT && c != NFA_KWORD && c != NFA_SKWORD
+            && c != NFA_FNAME && c != NFA_SFNAME && c != NFA_PRINT && c != NFA_SPRINT)
+        || (c >= NFA_CLASS_ALNUM && c <= NFA_CLASS_ESCAPE && c != NFA_CLASS_PRINT)) {
+      continue;
+    }
+    switch (c) {
+    case NFA_SPLIT:
+    case NFA_MATCH:
+    case NFA_EMPTY:
+    case NFA_START_COLL:
+    case NFA_END_COLL:
+    case NFA_START_NEG_COLL:
+    case NFA_RANGE_MIN:
+    case NFA_RANGE_MAX:
+    case NFA_BOL:
+    case NFA_EOL:
+    case NFA_ZSTART:
+    case NFA_ZEND:
+    case NFA_NOPEN:
+    case NFA_NCLOSE:
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+static nfa_dfa_T *nfa_dfa_new(nfa_regprog_T *prog)
+{
+  nfa_dfa_T *dfa = xcalloc(1, sizeof(nfa_dfa_T));
+  dfa->reg_ic = rex.reg_ic;
+  dfa->states = xmalloc(NFA_DFA_MAX_STATES * sizeof(nfa_dfa_state_T));
+  dfa->ids = xmalloc((size_t)prog->nstate * sizeof(int));
+  dfa->seen = xcalloc((size_t)prog->nstate, sizeof(int));
+  dfa->stack = xmalloc((size_t)prog->nstate * sizeof(nfa_state_T *));
+  nfa_dfa_clear(dfa);
+  return dfa;
+}
+
+/// Forget all DFA states.
+static void nfa_dfa_clear(nfa_dfa_T *dfa)
+{
+  for (int i = 0; i < dfa->nstates; i++) {
+    xfree(dfa->states[i].ids);
+  }
+  dfa->nstates = 0;
+  dfa->start = -1;
+  dfa->start_bol = -1;
+  memset(dfa->table, -1, sizeof(dfa->table));
+}
+
+static void nfa_dfa_free(nfa_dfa_T *dfa)
+{
+  if (dfa == NULL) {
+    return;
+  }
+  nfa_dfa_clear(dfa);
+  xfree(dfa->states);
+  xfree(dfa->ids);
+  xfree(dfa->seen);
+  xfree(dfa->stack);
+  xfree(dfa);
+}
+
+/// Add "state" and the states reachable from it without consuming a
+/// character to the set being built in "dfa".
+///
+/// @param bol  at the start of the line
+/// @param eol  at the end of the line
+/// @param[out] matchp  set to true when NFA_MATCH is reached
+static void nfa_dfa_closure(nfa_dfa_T *dfa, nfa_state_T *state, bool bol, bool eol, bool *matchp)
+{
+  if (dfa->seen[state->id] == dfa->stamp) {
+    return;
+  }
+  int depth = 0;
+  dfa->seen[state->id] = dfa->stamp;
+  dfa->stack[depth++] = state;
+  while (depth > 0) {
+    nfa_state_T *p = dfa->stack[--depth];
+    nfa_state_T *next[2] = { NULL, NULL };
+    switch (p->c) {
+    case NFA_MATCH:
+      *matchp = true;
+      break;
+    case NFA_SPLIT:
+      next[0] = p->out;
+      next[1] = p->out1;
+      break;
+    case NFA_BOL:
+      if (bol) {
+        next[0] = p->out;
+      }
+      break;
+    case NFA_EOL:
+      if (eol) {
+        next[0] = p->out;
+      } else {
+        dfa->ids[dfa->nids++] = p->id;
+      }
+      break;
+    case NFA_EMPTY:
+    case NFA_END_COLL:
+    case NFA_ZSTART:
+    case NFA_ZEND:
+    case NFA_NOPEN:
+    case NFA_NCLOSE:
+      next[0] = p->out;
+      break;
+    default:
+      if ((p->c >= NFA_MOPEN && p->c <= NFA_MOPEN9)
+          || (p->c >= NFA_MCLOSE && p->c <= NFA_MCLOSE9)) {
+        next[0] = p->out;
+      } else {
+        dfa->ids[dfa->nids++] = p->id;  // consumes a character
+      }
+      break;
+    }
+    for (int i = 0; i < 2; i++) {
+      if (next[i] != NULL && dfa->seen[next[i]->id] != dfa->stamp) {
+        dfa->seen[next[i]->id] = dfa->stamp;
+        dfa->stack[depth++] = next[i];
+      }
+    }
+  }
+}
+
+static int nfa_dfa_cmp_id(const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+/// Find or add the DFA state for the set built in "dfa".
+///
+/// @return  index of the state, -1 when there are too many states.
+static int nfa_dfa_add_state(nfa_dfa_T *dfa, bool match)
+{
+  qsort(dfa->ids, (size_t)dfa->nids, sizeof(int), nfa_dfa_cmp_id);
+  uint32_t hash = 2166136261U;
+  for (int i = 0; i < dfa->nids; i++) {
+    hash = (hash ^ (uint32_t)dfa->ids[i]) * 16777619U;
+  }
+
+  size_t mask = ARRAY_SIZE(dfa->table) - 1;
+  size_t h = hash & mask;
+  for (; dfa->table[h] >= 0; h = (h + 1) & mask) {
+    nfa_dfa_state_T *st = &dfa->states[dfa->table[h]];
+    if (st->nids == dfa->nids && st->match == match
+        && memcmp(st->ids, dfa->ids, (size_t)dfa->nids * sizeof(int)) == 0) {
+      return dfa->table[h];
+    }
+  }
+
+  if (dfa->nstates == NFA_DFA_MAX_STATES) {
+    return -1;
+  }
+  nfa_dfa_state_T *st = &dfa->states[dfa->nstates];
+  st->ids = xmemdup(dfa->ids, (size_t)dfa->nids * sizeof(int));
+  st->nids = dfa->nids;
+  st->match = match;
+  st->eol_match = -1;
+  memset(st->next, -1, sizeof(st->next));
+  dfa->table[h] = (int16_t)dfa->nstates;
+  return dfa->nstates++;
+}
+
+/// @return  the DFA state for starting to match, -1 when there are too many states.
+static int nfa_dfa_start(nfa_regprog_T *prog, nfa_dfa_T *dfa, bool bol)
+{
+  int *startp = bol ? &dfa->start_bol : &dfa->start;
+  if (*startp < 0) {
+    bool match = false;
+    dfa->nids = 0;
+    dfa->stamp++;
+    nfa_dfa_closure(dfa, prog->start, bol, false, &match);
+    *startp = nfa_dfa_add_state(dfa, match);
+  }
+  return *startp;
+}
+
+/// Check if NFA "state", which consumes a character, matches character "c".
+/// Must do the same as nfa_regmatch().
+static bool nfa_dfa_accepts(nfa_state_T *state, int c)
+{
+  switch (state->c) {
+  case NFA_EOL:
+    return false;
+  case NFA_START_COLL:
+  case NFA_START_NEG_COLL: {
+    bool result_if_matched = state->c == NFA_START_COLL;
+    for (nfa_state_T *p = state->out;; p = p->out) {
+      if (p->c == NFA_END_COLL) {
+        return !result_if_matched;
+      }
+      if (p->c == NFA_RANGE_MIN) {
+        int c1 = p->val;
+        p = p->out;  // advance to NFA_RANGE_MAX
+        int c2 = p->val;
+        if (c >= c1 && c <= c2) {
+          return result_if_matched;
+        }
+        if (rex.reg_ic) {
+          int c_low = utf_fold(c);
+          for (; c1 <= c2; c1++) {
+            if (utf_fold(c1) == c_low) {
+              return result_if_matched;
+            }
+          }
+        }
+      } else if (p->c < 0 ? check_char_class(p->c, c)
+                          : (c == p->c || (rex.reg_ic && utf_fold(c) == utf_fold(p->c)))) {
+        return result_if_matched;
+      }
+    }
+  }
+  case NFA_ANY:
+    return c > 0;
+  case NFA_WHITE:
+    return ascii_iswhite(c);
+  case NFA_NWHITE:
+    return c != NUL && !ascii_iswhite(c);
+  case NFA_DIGIT:
+    return ri_digit(c);
+  case NFA_NDIGIT:
+    return c != NUL && !ri_digit(c);
+  case NFA_HEX:
+    return ri_hex(c);
+  case NFA_NHEX:
+    return c != NUL && !ri_hex(c);
+  case NFA_OCTAL:
+    return ri_octal(c);
+  case NFA_NOCTAL:
+    return c != NUL && !ri_octal(c);
+  case NFA_WORD:
+    return ri_word(c);
+  case NFA_NWORD:
+    return c != NUL && !ri_word(c);
+  case NFA_HEAD:
+    return ri_head(c);
+  case NFA_NHEAD:
+    return c != NUL && !ri_head(c);
+  case NFA_ALPHA:
+    return ri_alpha(c);
+  case NFA_NALPHA:
+    return c != NUL && !ri_alpha(c);
+  case NFA_LOWER:
+    return ri_lower(c);
+  case NFA_NLOWER:
+    return c != NUL && !ri_lower(c);
+  case NFA_UPPER:
+    return ri_upper(c);
+  case NFA_NUPPER:
+    return c != NUL && !ri_upper(c);
+  case NFA_LOWER_IC:
+    return ri_lower(c) || (rex.reg_ic && ri_upper(c));
+  case NFA_NLOWER_IC:
+    return c != NUL && !(ri_lower(c) || (rex.reg_ic && ri_upper(c)));
+  case NFA_UPPER_IC:
+    return ri_upper(c) || (rex.reg_ic && ri_lower(c));
+  case NFA_NUPPER_IC:
+    return c != NUL && !(ri_upper(c) || (rex.reg_ic && ri_lower(c)));
+  default:  // regular character
+    return state->c == c || (rex.reg_ic && utf_fold(state->c) == utf_fold(c));
+  }
+}
+
+/// @return  the DFA state after state "si" when reading character "c", -1
+///          when there are too many states.
+static int nfa_dfa_step(nfa_regprog_T *prog, nfa_dfa_T *dfa, int si, int c)
+{
+  if (c < NFA_DFA_ASCII && dfa->states[si].next[c] >= 0) {
+    return dfa->states[si].next[c];
+  }
+
+  bool match = false;
+  dfa->nids = 0;
+  dfa->stamp++;
+  const int *ids = dfa->states[si].ids;
+  for (int i = 0; i < dfa->states[si].nids; i++) {
+    nfa_state_T *state = &prog->state[ids[i]];
+    if (nfa_dfa_accepts(state, c)) {
+      // For a collection the next state is after the NFA_END_COLL.
+      nfa_state_T *next = (state->c == NFA_START_COLL || state->c == NFA_START_NEG_COLL)
+                          ? state->out1->out : state->out;
+      nfa_dfa_closure(dfa, next, false, false, &match);
+    }
+  }
+  // A match may also start at the next character.
+  nfa_dfa_closure(dfa, prog->start, false, false, &match);
+
+  int next = nfa_dfa_add_state(dfa, match);
+  if (next >= 0 && c < NFA_DFA_ASCII) {
+    dfa->states[si].next[c] = (int16_t)next;
+  }
+  return next;
+}
+
+/// @return  whether a match ends at the end of the line in DFA state "si".
+static bool nfa_dfa_eol_match(nfa_regprog_T *prog, nfa_dfa_T *dfa, int si)
+{
+  nfa_dfa_state_T *st = &dfa->states[si];
+  if (st->eol_match < 0) {
+    bool match = false;
+    dfa->nids = 0;
+    dfa->stamp++;
+    for (int i = 0; i < st->nids; i++) {
+      if (prog->state[st->ids[i]].c == NFA_EOL) {
+        nfa_dfa_closure(dfa, &prog->state[st->ids[i]], false, true, &match);
+      }
+    }
+    st->eol_match = match;
+  }
+  return st->eol_match;
+}
+
+/// Use the DFA of "prog" to find out whether it can match in "line" at or
+/// after "col".  The DFA is dropped when it needs too many states, it is
+/// unlikely to help then.
+///
+/// @return  false when there is no match, true when there may be one.
+static bool nfa_dfa_can_match(nfa_regprog_T *prog, const uint8_t *line, colnr_T col)
+{
+  if (!prog->dfa_ok || rex.reg_icombine) {
+    return true;
+  }
+  if (prog->dfa == NULL) {
+    prog->dfa = nfa_dfa_new(prog);
+  } else if (prog->dfa->reg_ic != rex.reg_ic) {
+    nfa_dfa_clear(prog->dfa);
+    prog->dfa->reg_ic = rex.reg_ic;
+  }
+  nfa_dfa_T *dfa = prog->dfa;
+
+  const uint8_t *p = line + col;
+  for (int si = nfa_dfa_start(prog, dfa, col == 0); si >= 0;) {
+    if (dfa->states[si].match) {
+      return true;
+    }
+    if (*p == NUL) {
+      return nfa_dfa_eol_match(prog, dfa, si);
+    }
+    int c = *p;
+    int len = 1;
+    if (c >= 0x80) {
+      c = utf_ptr2char((char *)p);
+      len = utf_ptr2len((char *)p);
+    }
+    if (p[len] >= 0x80 && utfc_ptr2len((char *)p) != len) {
+      // A composing character: a character state in nfa_regmatch() only
+      // consumes the base character, other states also the composing ones.
+      return true;
+    }
+    si = nfa_dfa_step(prog, dfa, si, c);
+    p += len;
+  }
+
+  prog->dfa_ok = false;
+  nfa_dfa_free(prog->dfa);
+  prog->dfa = NULL;
+  return true;
+}
+
 /// Try match of "prog" with at rex.line["col"].
 ///
 /// @param tm         timeout limit or NULL
@@ -15285,6 +15839,16 @@ static int nfa_regexec_both(uint8_t *line, colnr_T startcol, proftime_T *tm, int
     return 0L;
   }
 
+  // If there is a "must appear" string, look for it.
+  if (prog->regmust != NULL && !find_regmust(line + col, prog->regmust, prog->regmlen)) {
+    return 0L;
+  }
+
+  // Quickly check if the line can match at all.
+  if (!nfa_dfa_can_match(prog, line, col)) {
+    return 0L;
+  }
+
   rex.need_clear_subexpr = true;
   // Clear the external match subpointers if necessary.
   if (prog->reghasz == REX_SET) {
@@ -15433,6 +15997,9 @@ static regprog_T *nfa_regcomp(uint8_t *expr, int re_flags)
   prog->reganch = nfa_get_reganch(prog->start, 0);
   prog->regstart = nfa_get_regstart(prog->start, 0);
   prog->match_text = nfa_get_match_text(prog->start);
+  prog->regmlen = 0;
+  prog->regmust = nfa_get_regmust(prog, &prog->regmlen);
+  prog->dfa = NULL;
 
 #ifdef REGEXP_DEBUG
   nfa_postfix_dump(expr, OK);
@@ -15440,6 +16007,7 @@ static regprog_T *nfa_regcomp(uint8_t *expr, int re_flags)
 #endif
   // Remember whether this pattern has any \z specials in it.
   prog->reghasz = re_has_z;
+  prog->dfa_ok = nfa_dfa_eligible(prog);
   prog->pattern = xstrdup((char *)expr);
 #ifdef REGEXP_DEBUG
   nfa_regengine.expr = NULL;
@@ -15468,6 +16036,8 @@ static void nfa_regfree(regprog_T *prog)
   }
 
   xfree(((nfa_regprog_T *)prog)->match_text);
+  xfree(((nfa_regprog_T *)prog)->regmust);
+  nfa_dfa_free(((nfa_regprog_T *)prog)->dfa);
   xfree(((nfa_regprog_T *)prog)->pattern);
   xfree(prog);
 }
@@ -15565,11 +16135,102 @@ static uint8_t regname[][30] = {
 };
 #endif
 
+/// Number of compiled programs kept by vim_regcomp().
+#define REGCACHE_SIZE 32
+
+/// A compiled program kept by vim_regcomp() to be returned again for the
+/// same pattern.  A program is used by one caller at a time, since it
+/// contains state while executing.
+typedef struct {
+  char *pat;          ///< pattern as given to vim_regcomp(), NULL for an unused entry
+  int re_flags;       ///< flags given to vim_regcomp()
+  int engine;         ///< value of 'regexpengine' when compiled
+  bool cpo_lit;       ///< 'cpoptions' contained 'l' when compiled
+  bool in_use;        ///< returned by vim_regcomp(), not freed yet
+  uint64_t last_used; ///< value of regcache_tick when last returned
+  regprog_T *prog;
+} regcache_T;
+
+static regcache_T regcache[REGCACHE_SIZE];
+static uint64_t regcache_tick = 0;
+
+/// Find a cached program for "pat" that is not in use.
+///
+/// @return  the program, marked in use, or NULL.
+static regprog_T *regcache_find(const char *pat, int re_flags, bool cpo_lit)
+{
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    regcache_T *rc = &regcache[i];
+    if (rc->pat != NULL && !rc->in_use && rc->re_flags == re_flags
+        && rc->engine == (int)p_re && rc->cpo_lit == cpo_lit && strcmp(rc->pat, pat) == 0) {
+      rc->in_use = true;
+      rc->last_used = ++regcache_tick;
+      return rc->prog;
+    }
+  }
+  return NULL;
+}
+
+/// Add "prog", compiled from "pat", to the cache.  It replaces the least
+/// recently used program that is not in use.  When all programs are in use
+/// "prog" is not cached.
+static void regcache_add(const char *pat, int re_flags, bool cpo_lit, regprog_T *prog)
+{
+  regcache_T *rc = NULL;
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    if (regcache[i].pat == NULL) {
+      rc = &regcache[i];
+      break;
+    }
+    if (!regcache[i].in_use && (rc == NULL || regcache[i].last_used < rc->last_used)) {
+      rc = &regcache[i];
+    }
+  }
+  if (rc == NULL) {
+    return;
+  }
+  if (rc->pat != NULL) {
+    xfree(rc->pat);
+    rc->prog->engine->regfree(rc->prog);
+  }
+  rc->pat = xstrdup(pat);
+  rc->re_flags = re_flags;
+  rc->engine = (int)p_re;
+  rc->cpo_lit = cpo_lit;
+  rc->in_use = true;
+  rc->last_used = ++regcache_tick;
+  rc->prog = prog;
+}
+
 // Compile a regular expression into internal code.
 // Returns the program in allocated memory.
 // Use vim_regfree() to free the memory.
 // Returns NULL for an error.
 regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
+{
+  // The result of compiling depends on the previous substitute string for
+  // "~" and on the \z() state for syntax patterns, don't cache those.
+  const bool cacheable = reg_do_extmatch == 0 && vim_strchr(expr_arg, '~') == NULL;
+  const bool cpo_lit = vim_strchr(p_cpo, CPO_LITERAL) != NULL;
+  if (cacheable) {
+    regprog_T *prog = regcache_find(expr_arg, re_flags, cpo_lit);
+    if (prog != NULL) {
+      g_stats.regexp_cache_hit++;
+      return prog;
+    }
+    g_stats.regexp_cache_miss++;
+  }
+
+  const int called_emsg_before = called_emsg;
+  regprog_T *prog = regcomp_nocache(expr_arg, re_flags);
+  if (prog != NULL && cacheable && called_emsg == called_emsg_before) {
+    regcache_add(expr_arg, re_flags, cpo_lit, prog);
+  }
+  return prog;
+}
+
+/// Compile a regular expression, without using the cache.
+static regprog_T *regcomp_nocache(const char *expr_arg, int re_flags)
 {
   regprog_T *prog = NULL;
   const char *expr = expr_arg;
@@ -15650,16 +16311,69 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
 }
 
 // Free a compiled regexp program, returned by vim_regcomp().
+// A cached program is kept for the next vim_regcomp() call.
 void vim_regfree(regprog_T *prog)
 {
-  if (prog != NULL) {
-    prog->engine->regfree(prog);
+  if (prog == NULL) {
+    return;
   }
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    if (regcache[i].prog == prog && regcache[i].pat != NULL) {
+      regcache[i].in_use = false;
+      return;
+    }
+  }
+  prog->engine->regfree(prog);
+}
+
+/// Get what every match of "prog" is known to have, the same the matcher
+/// checks first to quickly reject a line.  This lets a caller check many
+/// programs against a line at once.  Both engines give conditions that are
+/// true for any match, not only for the one "prog" runs with.
+///
+/// @param ic  whether matching would ignore case, as "rmm_ic"
+/// @param[out] anchored  a match can only start in column zero
+/// @param[out] start  character a match starts with, or NUL
+/// @param[out] must  text a match contains, or NULL; points into "prog"
+///
+/// @return  false when nothing is known, because case or combining
+///          characters are ignored.
+bool vim_regprog_hints(const regprog_T *prog, bool ic, bool *anchored, int *start,
+                       const char **must)
+  FUNC_ATTR_NONNULL_ALL
+{
+  unsigned flags = prog->regflags;
+  if ((flags & (RF_ICASE | RF_ICOMBINE)) || (ic && !(flags & RF_NOICASE))) {
+    return false;
+  }
+  if (prog->engine == &nfa_regengine) {
+    const nfa_regprog_T *nprog = (const nfa_regprog_T *)prog;
+    *anchored = nprog->reganch != 0;
+    *start = nprog->regstart;
+    *must = (const char *)(nprog->regmust != NULL ? nprog->regmust : nprog->match_text);
+  } else {
+    const bt_regprog_T *bprog = (const bt_regprog_T *)prog;
+    *anchored = bprog->reganch != 0;
+    *start = bprog->regstart;
+    *must = (const char *)bprog->regmust;
+  }
+  return true;
 }
 
 #if defined(EXITFREE)
 void free_regexp_stuff(void)
 {
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    regcache_T *rc = &regcache[i];
+    if (rc->pat != NULL) {
+      // A program in use is freed by vim_regfree() later.
+      if (!rc->in_use) {
+        rc->prog->engine->regfree(rc->prog);
+      }
+      XFREE_CLEAR(rc->pat);
+      rc->prog = NULL;
+    }
+  }
   ga_clear(&regstack);
   ga_clear(&backpos);
   xfree(reg_tofree);
@@ -15713,6 +16427,7 @@ static bool vim_regexec_string(regmatch_T *rmp, const char *line, colnr_T col, b
   rex.reg_startpos = NULL;
   rex.reg_endpos = NULL;
 
+  NVIM_PROBE(regexec_start, 2, rmp->regprog->re_engine, 0);
   int result = rmp->regprog->engine->regexec_nl(rmp, (uint8_t *)line, col, nl);
   rmp->regprog->re_in_use = false;
 
@@ -15742,6 +16457,7 @@ static bool vim_regexec_string(regmatch_T *rmp, const char *line, colnr_T col, b
     rex = rex_save;
   }
 
+  NVIM_PROBE(regexec_end, 2, 0, result);
   return result > 0;
 }
 
@@ -15804,6 +16520,7 @@ int vim_regexec_multi(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_T lnum, c
   }
   rex_in_use = true;
 
+  NVIM_PROBE(regexec_start, 2, rmp->regprog->re_engine, 1);
   int result = rmp->regprog->engine->regexec_multi(rmp, win, buf, lnum, col, tm, timed_out);
   rmp->regprog->re_in_use = false;
 
@@ -15845,5 +16562,6 @@ int vim_regexec_multi(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_T lnum, c
     rex = rex_save;
   }
 
+  NVIM_PROBE(regexec_end, 2, 1, result);
   return result <= 0 ? 0 : result;
 }
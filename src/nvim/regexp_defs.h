@@ -109,6 +109,9 @@ typedef struct {
   uint8_t program[];
 } bt_regprog_T;
 
+/// Lazy DFA for a NFA program, see nfa_dfa_can_match().
+typedef struct nfa_dfa_S nfa_dfa_T;
+
 /// Structure representing a NFA state.
 /// An NFA state may have no outgoing edge, when it is a NFA_MATCH state.
 typedef struct nfa_state nfa_state_T;
@@ -135,6 +138,10 @@ typedef struct {
   int reganch;          ///< pattern starts with ^
   int regstart;         ///< char at start of pattern
   uint8_t *match_text;  ///< plain text to match with
+  uint8_t *regmust;     ///< text every match contains or NULL
+  int regmlen;          ///< length of regmust
+  bool dfa_ok;          ///< can use a DFA to check for a match
+  nfa_dfa_T *dfa;       ///< DFA states built so far or NULL
 
   int has_zend;         ///< pattern contains \ze
   int has_backref;      ///< pattern contains \1 .. \9
@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <uv.h>
 
@@ -46,6 +47,7 @@
 #include "nvim/os/input.h"
 #include "nvim/os/os.h"
 #include "nvim/os/stdpaths_defs.h"
+#include "nvim/os/time.h"
 #include "nvim/path.h"
 #include "nvim/pos_defs.h"
 #include "nvim/profile.h"
@@ -79,10 +81,21 @@ struct source_cookie {
   vimconv_T conv;               ///< type of conversion
 };
 
+/// Names of the entries of a runtime directory, valid while its mtime is the
+/// same. Kept in rtp_index and written to the file of runtime_index_write().
+typedef struct {
+  int64_t mtime;      ///< modification time of the directory
+  int64_t mtime_ns;   ///< nanoseconds part of the modification time
+  char *names;        ///< "/name1/name2/", names containing NL are left out
+  bool racy;          ///< modified in the second of the scan, scan again
+  bool used;          ///< directory is in a search path of this session
+} RuntimeDirIndex;
+
 typedef struct {
   char *path;
   bool after;
   TriState has_lua;
+  RuntimeDirIndex *index;  ///< NULL if the entries are not known
 } SearchPathItem;
 
 typedef kvec_t(SearchPathItem) RuntimeSearchPath;
@@ -234,6 +247,256 @@ void runtime_init(void)
   uv_mutex_init(&runtime_search_path_mutex);
 }
 
+/// Index of runtime directories, by path. Lets lookups in the search path skip
+/// directories without the first component of the pattern, without asking the
+/// file system. The entries are never freed, search paths point to them.
+static PMap(cstr_t) rtp_index = MAP_INIT;
+/// File rtp_index was read from, and is written to when changed.
+static char *rtp_index_fname = NULL;
+static bool rtp_index_changed = false;
+
+#define RTP_INDEX_HEADER "nvim rtpindex 1\n"
+
+/// Read the index of runtime directories from the cache directory, to be
+/// validated with the mtime of each directory when the search path is built.
+/// Also enables writing it with runtime_index_write().
+void runtime_index_read(void)
+{
+  xfree(rtp_index_fname);
+  rtp_index_fname = stdpaths_user_cache_subpath("rtpindex");
+
+  FileInfo file_info;
+  FILE *fd;
+  if (!os_fileinfo(rtp_index_fname, &file_info)
+      || (fd = os_fopen(rtp_index_fname, READBIN)) == NULL) {
+    return;
+  }
+  size_t size = (size_t)os_fileinfo_size(&file_info);
+  char *data = xmallocz(size);
+  size = fread(data, 1, size, fd);
+  fclose(fd);
+  data[size] = NUL;
+
+  if (strncmp(data, RTP_INDEX_HEADER, sizeof(RTP_INDEX_HEADER) - 1) != 0) {
+    // Unknown version, rewritten at exit.
+    rtp_index_changed = true;
+    xfree(data);
+    return;
+  }
+
+  // Each directory is a line "{mtime} {mtime_ns} {path}" and a line with the
+  // names of its entries.
+  char *p = data + sizeof(RTP_INDEX_HEADER) - 1;
+  while (*p != NUL) {
+    char *path_line = p;
+    char *names_line = strchr(path_line, NL);
+    char *end = names_line ? strchr(names_line + 1, NL) : NULL;
+    if (end == NULL) {
+      break;
+    }
+    *names_line++ = NUL;
+    *end = NUL;
+    p = end + 1;
+
+    char *path;
+    int64_t mtime = strtoll(path_line, &path, 10);
+    int64_t mtime_ns = strtoll(path, &path, 10);
+    if (*path != ' ' || path[1] == NUL || *names_line != '/') {
+      continue;
+    }
+    path++;
+    const char **key_alloc;
+    ptr_t *ref = pmap_put_ref(cstr_t)(&rtp_index, path, &key_alloc, NULL);
+    if (*ref != NULL) {
+      continue;
+    }
+    *key_alloc = xstrdup(path);
+    RuntimeDirIndex *index = xmalloc(sizeof(*index));
+    *index = (RuntimeDirIndex){ .mtime = mtime, .mtime_ns = mtime_ns,
+                                .names = xstrdup(names_line), .used = false };
+    *ref = index;
+  }
+  xfree(data);
+}
+
+/// Write the index of runtime directories if it was read at startup and any
+/// directory was (re)scanned since. Directories that were not in a search
+/// path of this session are dropped.
+void runtime_index_write(void)
+{
+  if (rtp_index_fname == NULL) {
+    return;
+  }
+  RuntimeDirIndex *index;
+  map_foreach_value(&rtp_index, index, {
+    if (!index->used) {
+      rtp_index_changed = true;
+    }
+  });
+  if (!rtp_index_changed) {
+    return;
+  }
+
+  char *dir = xstrdup(rtp_index_fname);
+  *path_tail(dir) = NUL;
+  char *failed_dir;
+  if (os_mkdir_recurse(dir, 0700, &failed_dir, NULL) != 0) {
+    xfree(failed_dir);
+    xfree(dir);
+    return;
+  }
+  xfree(dir);
+
+  // Write to a temp file and rename, another instance may be reading it.
+  size_t tmp_len = strlen(rtp_index_fname) + 5;
+  char *tmp_fname = xmalloc(tmp_len);
+  snprintf(tmp_fname, tmp_len, "%s.tmp", rtp_index_fname);
+  FILE *fd = os_fopen(tmp_fname, WRITEBIN);
+  if (fd == NULL) {
+    xfree(tmp_fname);
+    return;
+  }
+  fputs(RTP_INDEX_HEADER, fd);
+  const char *path;
+  map_foreach(&rtp_index, path, index, {
+    if (index->used && !index->racy && strchr(path, NL) == NULL) {
+      fprintf(fd, "%" PRId64 " %" PRId64 " %s\n%s\n",
+              index->mtime, index->mtime_ns, path, index->names);
+    }
+  });
+  bool ok = !ferror(fd);
+  if (fclose(fd) == 0 && ok) {
+    ok = os_rename(tmp_fname, rtp_index_fname) == OK;
+  }
+  if (!ok) {
+    os_remove(tmp_fname);
+  }
+  xfree(tmp_fname);
+  rtp_index_changed = false;
+}
+
+/// Scan the entries of directory "path" into "index" if it was modified since
+/// the last scan.
+///
+/// @return false if "path" is not a directory.
+static bool runtime_dir_index_update(RuntimeDirIndex *index, const char *path)
+{
+  FileInfo file_info;
+  if (!os_fileinfo(path, &file_info) || !S_ISDIR(file_info.stat.st_mode)) {
+    return false;
+  }
+  int64_t mtime = file_info.stat.st_mtim.tv_sec;
+  int64_t mtime_ns = file_info.stat.st_mtim.tv_nsec;
+  if (index->names != NULL && !index->racy
+      && index->mtime == mtime && index->mtime_ns == mtime_ns) {
+    return true;
+  }
+
+  garray_T ga;
+  ga_init(&ga, 1, 256);
+  ga_append(&ga, '/');
+  Directory dir;
+  if (os_scandir(&dir, path)) {
+    const char *name;
+    while ((name = os_scandir_next(&dir)) != NULL) {
+      if (strchr(name, NL) != NULL) {
+        continue;
+      }
+#ifdef CASE_INSENSITIVE_FILENAME
+      int start = ga.ga_len;
+#endif
+      ga_concat(&ga, name);
+#ifdef CASE_INSENSITIVE_FILENAME
+      for (int i = start; i < ga.ga_len; i++) {
+        ((char *)ga.ga_data)[i] = (char)TOLOWER_ASC(((char *)ga.ga_data)[i]);
+      }
+#endif
+      ga_append(&ga, '/');
+    }
+    os_closedir(&dir);
+  }
+  ga_append(&ga, NUL);
+
+  xfree(index->names);
+  index->names = ga.ga_data;
+  index->mtime = mtime;
+  index->mtime_ns = mtime_ns;
+  // An entry added later in the same tick of the file system clock would not
+  // change the mtime.
+  index->racy = mtime >= (int64_t)os_time() - 1;
+  rtp_index_changed = true;
+  return true;
+}
+
+/// Get the index of the entries of directory "path" for a search path.
+///
+/// @return NULL if "path" is not a directory.
+static RuntimeDirIndex *runtime_dir_index(const char *path)
+{
+  if (*path == NUL) {
+    return NULL;
+  }
+  const char **key_alloc;
+  ptr_t *ref = pmap_put_ref(cstr_t)(&rtp_index, path, &key_alloc, NULL);
+  RuntimeDirIndex *index = *ref;
+  if (index == NULL) {
+    *key_alloc = xstrdup(path);
+    index = xcalloc(1, sizeof(*index));
+    *ref = index;
+  }
+  if (!runtime_dir_index_update(index, path)) {
+    return NULL;
+  }
+  index->used = true;
+  return index;
+}
+
+/// Check if search path "item" can have a match for "pat", which is relative
+/// to it.
+///
+/// @param[in,out] checked  whether the index of "item" was validated already
+///
+/// @return false only if the first component of "pat" is a plain name that
+///         is not in the directory.
+static bool runtime_dir_may_match(SearchPathItem *item, const char *pat, bool *checked)
+{
+  if (item->index == NULL) {
+    return true;
+  }
+  char name[MAXPATHL];
+  size_t len = 0;
+  name[len++] = '/';
+  for (; *pat != NUL && !vim_ispathsep(*pat); pat++) {
+    // Only letters, digits and a few others, anything else may be a
+    // wildcard or an escape.
+    if (!(ASCII_ISALNUM(*pat) || *pat == '_' || *pat == '-' || *pat == '.')
+        || len + 2 >= sizeof(name)) {
+      return true;
+    }
+#ifdef CASE_INSENSITIVE_FILENAME
+    name[len++] = (char)TOLOWER_ASC(*pat);
+#else
+    name[len++] = *pat;
+#endif
+  }
+  name[len] = NUL;
+  if (len == 1 || strcmp(name, "/.") == 0 || strcmp(name, "/..") == 0) {
+    return true;
+  }
+  name[len++] = '/';
+  name[len] = NUL;
+
+  // A single stat() tells whether the entries changed, instead of one
+  // lookup for each pattern.
+  if (!*checked) {
+    *checked = true;
+    if (!runtime_dir_index_update(item->index, item->path)) {
+      return true;
+    }
+  }
+  return strstr(item->index->names, name) != NULL;
+}
+
 /// Get DIP_ flags from the [where] argument of a :runtime command.
 /// "*argp" is advanced to after the [where] argument.
 static int get_runtime_cmd_flags(char **argp, size_t where_len)
@@ -464,7 +727,9 @@ static RuntimeSearchPath copy_runtime_search_path(const RuntimeSearchPath src)
   RuntimeSearchPath dst = KV_INITIAL_VALUE;
   for (size_t j = 0; j < kv_size(src); j++) {
     SearchPathItem src_item = kv_A(src, j);
-    kv_push(dst, ((SearchPathItem){ xstrdup(src_item.path), src_item.after, src_item.has_lua }));
+    // The index is updated by the main thread, not shared with the worker threads.
+    kv_push(dst, ((SearchPathItem){ xstrdup(src_item.path), src_item.after, src_item.has_lua,
+                                    NULL }));
   }
 
   return dst;
@@ -530,11 +795,15 @@ static int do_in_cached_path(char *name, int flags, DoInRuntimepathCB callback,
 
       // Loop over all patterns in "name"
       char *np = name;
+      bool index_checked = false;
 
       while (*np != NUL && (do_all || !did_one)) {
         // Append the pattern from "name" to buf[].
         assert(MAXPATHL >= (tail - buf));
         copy_option_part(&np, tail, (size_t)(MAXPATHL - (tail - buf)), "\t ");
+        if (!runtime_dir_may_match(&item, tail, &index_checked)) {
+          continue;
+        }
 
         if (p_verbose > 10) {
           verbose_enter();
@@ -625,9 +894,12 @@ static ArrayOf(String) runtime_get_named_common(bool lua, Array pat, bool all,
       }
     }
 
+    bool index_checked = false;
     for (size_t j = 0; j < pat.size; j++) {
       Object pat_item = pat.items[j];
-      if (pat_item.type == kObjectTypeString) {
+      // Lua modules are below "lua/", which has_lua already checked.
+      if (pat_item.type == kObjectTypeString
+          && (lua || runtime_dir_may_match(item, pat_item.data.string.data, &index_checked))) {
         size_t size = (size_t)snprintf(buf, buf_len, "%s/%s",
                                        item->path, pat_item.data.string.data);
         if (size < buf_len) {
@@ -690,7 +962,8 @@ static void push_path(RuntimeSearchPath *search_path, Set(String) *rtp_used, cha
   String *key_alloc;
   if (set_put_ref(String, rtp_used, cstr_as_string(entry), &key_alloc)) {
     *key_alloc = cstr_to_string(entry);
-    kv_push(*search_path, ((SearchPathItem){ key_alloc->data, after, kNone }));
+    kv_push(*search_path, ((SearchPathItem){ key_alloc->data, after, kNone,
+                                             runtime_dir_index(entry) }));
   }
 }
 
@@ -1092,7 +1365,7 @@ static int load_pack_plugin(bool opt, char *fname)
 
   // If runtime/filetype.lua wasn't loaded yet, the scripts will be
   // found when it loads.
-  if (opt && eval_to_number(cmd) > 0) {
+  if (opt && eval_to_number(cmd, false) > 0) {
     do_cmdline_cmd("augroup filetypedetect");
     vim_snprintf(pat, len, ftpat, ffname);
     gen_expand_wildcards_and_cb(1, &pat, EW_FILE, true, source_callback_vim_lua, NULL);
@@ -1168,55 +1441,252 @@ static bool add_opt_pack_plugins(int num_fnames, char **fnames, bool all, void *
   return num_fnames > 0;
 }
 
-/// Add all packages in the "start" directory to 'runtimepath'.
-void add_pack_start_dirs(void)
+/// Directory read in the threadpool by pack_scan_dirs().
+typedef struct {
+  uv_work_t req;
+  char *path;       ///< directory to read
+  CharVec subdirs;  ///< "{path}/{name}" for subdirectories, not hidden ones
+} PackScanJob;
+
+/// Start packages of one entry of 'packpath'.
+typedef struct {
+  CharVec pack;   ///< matches of "{entry}/pack/*/start/*"
+  CharVec start;  ///< matches of "{entry}/start/*"
+} PackStartDirs;
+
+typedef kvec_t(PackStartDirs) PackStartDirsVec;
+
+static void pack_scan_work(uv_work_t *req)
 {
-  do_in_path(p_pp, "", NULL, DIP_ALL + DIP_DIR, add_pack_start_dir, NULL);
+  PackScanJob *job = req->data;
+  uv_fs_t scan_req;
+  if (uv_fs_scandir(NULL, &scan_req, job->path, 0, NULL) >= 0) {
+    uv_dirent_t ent;
+    while (uv_fs_scandir_next(&scan_req, &ent) != UV_EOF) {
+      // Like "*" in gen_expand_wildcards(), which doesn't match hidden names.
+      if (ent.name[0] == '.') {
+        continue;
+      }
+      size_t len = strlen(job->path) + strlen(ent.name) + 2;
+      char *path = xmalloc(len);
+      snprintf(path, len, "%s/%s", job->path, ent.name);
+      bool is_dir = ent.type == UV_DIRENT_DIR;
+      if (ent.type == UV_DIRENT_LINK || ent.type == UV_DIRENT_UNKNOWN) {
+        uv_fs_t stat_req;
+        is_dir = uv_fs_stat(NULL, &stat_req, path, NULL) == 0
+                 && S_ISDIR(stat_req.statbuf.st_mode);
+        uv_fs_req_cleanup(&stat_req);
+      }
+      if (is_dir) {
+        kv_push(job->subdirs, path);
+      } else {
+        xfree(path);
+      }
+    }
+  }
+  uv_fs_req_cleanup(&scan_req);
 }
 
-static bool pack_has_entries(char *buf)
+static void pack_scan_done(uv_work_t *req, int status)
 {
-  int num_files;
-  char **files;
-  char *(pat[]) = { buf };
-  if (gen_expand_wildcards(1, pat, &num_files, &files, EW_DIR) == OK) {
-    FreeWild(num_files, files);
+}
+
+static int pack_scan_cmp(const void *a, const void *b)
+{
+  return pathcmp(*(char **)a, *(char **)b, -1);
+}
+
+/// Read the directories of "jobs" in the libuv threadpool, and wait for them.
+/// On network file systems the latency of each read is more than the time
+/// spent in it, so reading them one after the other is slow.
+static void pack_scan_dirs(PackScanJob *jobs, size_t njobs)
+{
+  uv_loop_t loop;
+  bool use_pool = njobs > 1 && uv_loop_init(&loop) == 0;
+  for (size_t i = 0; i < njobs; i++) {
+    jobs[i].req.data = &jobs[i];
+    if (!use_pool || uv_queue_work(&loop, &jobs[i].req, pack_scan_work, pack_scan_done) != 0) {
+      pack_scan_work(&jobs[i].req);
+    }
+  }
+  if (use_pool) {
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
   }
-  return num_files > 0;
 }
 
-static bool add_pack_start_dir(int num_fnames, char **fnames, bool all, void *cookie)
+/// Find the "start" packages of all entries of 'packpath', like expanding
+/// "pack/*/start/*" and "start/*" in each entry, but reading the directories
+/// of all entries together. The matches of each entry are sorted like
+/// gen_expand_wildcards() does.
+static PackStartDirsVec pack_start_dirs_find(void)
 {
-  static char buf[MAXPATHL];
-  for (int i = 0; i < num_fnames; i++) {
-    char *(start_pat[]) = { "/start/*", "/pack/*/start/*" };  // NOLINT
-    for (int j = 0; j < 2; j++) {
-      if (strlen(fnames[i]) + strlen(start_pat[j]) + 1 > MAXPATHL) {
-        continue;
+  PackStartDirsVec rv = KV_INITIAL_VALUE;
+  kvec_t(PackScanJob) jobs = KV_INITIAL_VALUE;
+  // index of the "{entry}/pack" and "{entry}/start" jobs of each entry
+  kvec_t(size_t) entry_job = KV_INITIAL_VALUE;
+  char *buf = xmalloc(MAXPATHL);
+
+  for (char *entry = p_pp; *entry != NUL;) {
+    copy_option_part(&entry, buf, MAXPATHL, ",");
+    PackStartDirs *dirs = kv_pushp(rv);
+    *dirs = (PackStartDirs){ .pack = KV_INITIAL_VALUE, .start = KV_INITIAL_VALUE };
+    if (path_has_wildcard(buf) || strchr(buf, '`') != NULL
+#ifdef UNIX
+        || strchr(buf, '\\') != NULL
+#endif
+        || strlen(buf) + sizeof("pack/*/start/*") + 1 >= MAXPATHL) {
+      // Let gen_expand_wildcards() handle "~", "$VAR", escapes and wildcards.
+      add_pathsep(buf);
+      char *tail = buf + strlen(buf);
+      char *(pats[]) = { "pack/*/start/*", "start/*" };  // NOLINT
+      CharVec *found[] = { &dirs->pack, &dirs->start };
+      for (int i = 0; i < 2; i++) {
+        int num_files;
+        char **files;
+        xstrlcpy(tail, pats[i], (size_t)(MAXPATHL - (tail - buf)));
+        if (gen_expand_wildcards(1, &buf, &num_files, &files, EW_DIR) == OK) {
+          for (int j = 0; j < num_files; j++) {
+            kv_push(*found[i], xstrdup(files[j]));
+          }
+          FreeWild(num_files, files);
+        }
       }
-      xstrlcpy(buf, fnames[i], MAXPATHL);
-      xstrlcat(buf, start_pat[j], sizeof buf);
-      if (pack_has_entries(buf)) {
-        add_pack_dir_to_rtp(buf, true);
+      kv_push(entry_job, SIZE_MAX);
+      continue;
+    }
+    kv_push(entry_job, kv_size(jobs));
+    add_pathsep(buf);
+    size_t len = strlen(buf);
+    xstrlcpy(buf + len, "pack", MAXPATHL - len);
+    kv_push(jobs, ((PackScanJob){ .path = xstrdup(buf) }));
+    xstrlcpy(buf + len, "start", MAXPATHL - len);
+    kv_push(jobs, ((PackScanJob){ .path = xstrdup(buf) }));
+  }
+  pack_scan_dirs(jobs.items, kv_size(jobs));
+
+  // Then the "start" directory of each "{entry}/pack/*".
+  kvec_t(PackScanJob) start_jobs = KV_INITIAL_VALUE;
+  for (size_t i = 0; i < kv_size(rv); i++) {
+    if (kv_A(entry_job, i) == SIZE_MAX) {
+      continue;
+    }
+    PackScanJob *pack_job = &kv_A(jobs, kv_A(entry_job, i));
+    for (size_t j = 0; j < kv_size(pack_job->subdirs); j++) {
+      size_t len = strlen(kv_A(pack_job->subdirs, j)) + sizeof("/start");
+      char *path = xmalloc(len);
+      snprintf(path, len, "%s/start", kv_A(pack_job->subdirs, j));
+      kv_push(start_jobs, ((PackScanJob){ .path = path }));
+    }
+  }
+  pack_scan_dirs(start_jobs.items, kv_size(start_jobs));
+
+  size_t start_job = 0;
+  for (size_t i = 0; i < kv_size(rv); i++) {
+    if (kv_A(entry_job, i) == SIZE_MAX) {
+      continue;
+    }
+    PackStartDirs *dirs = &kv_A(rv, i);
+    PackScanJob *pack_job = &kv_A(jobs, kv_A(entry_job, i));
+    for (size_t j = 0; j < kv_size(pack_job->subdirs); j++, start_job++) {
+      PackScanJob *job = &kv_A(start_jobs, start_job);
+      if (kv_size(job->subdirs) > 0) {
+        kv_concat_len(dirs->pack, job->subdirs.items, kv_size(job->subdirs));
       }
     }
+    // The matches of "start/*" are moved, not copied.
+    dirs->start = kv_A(jobs, kv_A(entry_job, i) + 1).subdirs;
+    kv_A(jobs, kv_A(entry_job, i) + 1).subdirs = (CharVec)KV_INITIAL_VALUE;
+    qsort(dirs->pack.items, kv_size(dirs->pack), sizeof(char *), pack_scan_cmp);
+    qsort(dirs->start.items, kv_size(dirs->start), sizeof(char *), pack_scan_cmp);
+  }
 
-    if (!all) {
-      break;
+  for (size_t i = 0; i < kv_size(jobs); i++) {
+    PackScanJob *job = &kv_A(jobs, i);
+    xfree(job->path);
+    for (size_t j = 0; j < kv_size(job->subdirs); j++) {
+      xfree(kv_A(job->subdirs, j));
     }
+    kv_destroy(job->subdirs);
   }
+  for (size_t i = 0; i < kv_size(start_jobs); i++) {
+    // The matches were moved to "rv".
+    xfree(kv_A(start_jobs, i).path);
+    kv_destroy(kv_A(start_jobs, i).subdirs);
+  }
+  kv_destroy(jobs);
+  kv_destroy(start_jobs);
+  kv_destroy(entry_job);
+  xfree(buf);
+  return rv;
+}
 
-  return num_fnames > 1;
+static void pack_start_dirs_free(PackStartDirsVec dirs)
+{
+  for (size_t i = 0; i < kv_size(dirs); i++) {
+    CharVec *found[] = { &kv_A(dirs, i).pack, &kv_A(dirs, i).start };
+    for (int j = 0; j < 2; j++) {
+      for (size_t k = 0; k < kv_size(*found[j]); k++) {
+        xfree(kv_A(*found[j], k));
+      }
+      kv_destroy(*found[j]);
+    }
+  }
+  kv_destroy(dirs);
+}
+
+/// Add all packages in the "start" directory to 'runtimepath'.
+void add_pack_start_dirs(void)
+{
+  PackStartDirsVec dirs = pack_start_dirs_find();
+  char *buf = xmalloc(MAXPATHL);
+  size_t i = 0;
+  for (char *entry = p_pp; *entry != NUL && i < kv_size(dirs); i++) {
+    copy_option_part(&entry, buf, MAXPATHL, ",");
+    size_t len = strlen(buf);
+    if (len + sizeof("/pack/*/start/*") > MAXPATHL) {
+      continue;
+    }
+    // The entry is added with the pattern, 'runtimepath' can contain wildcards.
+    if (kv_size(kv_A(dirs, i).start) > 0) {
+      xstrlcpy(buf + len, "/start/*", MAXPATHL - len);  // NOLINT
+      add_pack_dir_to_rtp(buf, true);
+    }
+    if (kv_size(kv_A(dirs, i).pack) > 0) {
+      xstrlcpy(buf + len, "/pack/*/start/*", MAXPATHL - len);  // NOLINT
+      add_pack_dir_to_rtp(buf, true);
+    }
+  }
+  xfree(buf);
+  pack_start_dirs_free(dirs);
+}
+
+static bool pack_has_entries(char *buf)
+{
+  int num_files;
+  char **files;
+  char *(pat[]) = { buf };
+  if (gen_expand_wildcards(1, pat, &num_files, &files, EW_DIR) == OK) {
+    FreeWild(num_files, files);
+  }
+  return num_files > 0;
 }
 
 /// Load plugins from all packages in the "start" directory.
+/// The packages are found before any is loaded.
 void load_start_packages(void)
 {
   did_source_packages = true;
-  do_in_path(p_pp, "", "pack/*/start/*", DIP_ALL + DIP_DIR,  // NOLINT
-             add_start_pack_plugins, &APP_LOAD);
-  do_in_path(p_pp, "", "start/*", DIP_ALL + DIP_DIR,  // NOLINT
-             add_start_pack_plugins, &APP_LOAD);
+  PackStartDirsVec dirs = pack_start_dirs_find();
+  for (size_t i = 0; i < kv_size(dirs); i++) {
+    CharVec found = kv_A(dirs, i).pack;
+    add_start_pack_plugins((int)kv_size(found), found.items, true, &APP_LOAD);
+  }
+  for (size_t i = 0; i < kv_size(dirs); i++) {
+    CharVec found = kv_A(dirs, i).start;
+    add_start_pack_plugins((int)kv_size(found), found.items, true, &APP_LOAD);
+  }
+  pack_start_dirs_free(dirs);
 }
 
 // ":packloadall"
@@ -570,11 +570,17 @@ int searchit(win_T *win, buf_T *buf, pos_T *pos, pos_T *end_pos, Direction dir,
   linenr_T stop_lnum = 0;  // stop after this line number when != 0
   proftime_T *tm = NULL;   // timeout limit or NULL
   int *timed_out = NULL;   // set when timed out or NULL
+  linenr_T resume_lnum = 0;  // continue in this line when != 0
+  int resume_loop = 0;
+  bool stopped = false;    // stopped for the time limit
 
   if (extra_arg != NULL) {
     stop_lnum = extra_arg->sa_stop_lnum;
     tm = extra_arg->sa_tm;
     timed_out = &extra_arg->sa_timed_out;
+    resume_lnum = extra_arg->sa_resume_lnum;
+    resume_loop = extra_arg->sa_resume_loop;
+    extra_arg->sa_stopped_lnum = 0;
   }
 
   if (search_regcomp(pat, NULL, RE_SEARCH, pat_use,
@@ -633,7 +639,16 @@ int searchit(win_T *win, buf_T *buf, pos_T *pos, pos_T *end_pos, Direction dir,
       lnum = pos->lnum;
     }
 
-    for (loop = 0; loop <= 1; loop++) {     // loop twice if 'wrapscan' set
+    // When continuing a search that stopped for the time limit, "pos" is
+    // still where the search started, to know where to stop.
+    int first_loop = 0;
+    if (resume_lnum != 0 && count == 1) {
+      at_first_line = at_first_line && resume_loop == 0 && resume_lnum == lnum;
+      lnum = resume_lnum;
+      first_loop = resume_loop;
+    }
+
+    for (loop = first_loop; loop <= 1; loop++) {     // loop twice if 'wrapscan' set
       for (; lnum > 0 && lnum <= buf->b_ml.ml_line_count;
            lnum += dir, at_first_line = false) {
         // Stop after checking "stop_lnum", if it's set.
@@ -641,8 +656,14 @@ int searchit(win_T *win, buf_T *buf, pos_T *pos, pos_T *end_pos, Direction dir,
                                ? lnum > stop_lnum : lnum < stop_lnum)) {
           break;
         }
-        // Stop after passing the "tm" time limit.
+        // Stop after passing the "tm" time limit.  Remember where, so that
+        // the search can be continued.
         if (tm != NULL && profile_passed_limit(*tm)) {
+          if (extra_arg != NULL && count == 1) {
+            extra_arg->sa_stopped_lnum = lnum;
+            extra_arg->sa_stopped_loop = loop;
+          }
+          stopped = true;
           break;
         }
 
@@ -909,7 +930,7 @@ int searchit(win_T *win, buf_T *buf, pos_T *pos, pos_T *end_pos, Direction dir,
       if (!p_ws || stop_lnum != 0 || got_int
           || called_emsg > called_emsg_before
           || (timed_out != NULL && *timed_out)
-          || break_loop
+          || break_loop || stopped
           || found || loop) {
         break;
       }
@@ -1932,6 +1953,19 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
     lispcomm = true;        // find match inside this comment
   }
 
+  // Without comments and Lisp to take care of, only a brace, a quote or the
+  // end of the line can change the state, the other characters are skipped
+  // without looking at them one by one.  Only for ASCII braces, then all the
+  // characters stopped at are at the start of a character.
+  char stopchars[5] = { 0 };
+  const bool skip_quickly = !comment_dir && !lisp && initc < 0x80 && findc < 0x80;
+  if (skip_quickly) {
+    stopchars[0] = (char)initc;
+    stopchars[1] = (char)findc;
+    stopchars[2] = '"';
+    stopchars[3] = '\'';
+  }
+
   while (!got_int) {
     // Go to the next position, forward or backward. We could use
     // inc() and dec() here, but that is much slower
@@ -1966,6 +2000,11 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
       } else {
         pos.col--;
         pos.col -= utf_head_off(linep, linep + pos.col);
+        if (skip_quickly) {
+          while (pos.col > 0 && strchr(stopchars, (uint8_t)linep[pos.col]) == NULL) {
+            pos.col--;
+          }
+        }
       }
     } else {                          // forward search
       if (linep[pos.col] == NUL
@@ -1994,6 +2033,9 @@ pos_T *findmatchlimit(oparg_T *oap, int initc, int flags, int64_t maxtravel)
         }
       } else {
         pos.col += utfc_ptr2len(linep + pos.col);
+        if (skip_quickly) {
+          pos.col += (colnr_T)strcspn(linep + pos.col, stopchars);
+        }
       }
     }
 
@@ -2649,6 +2691,250 @@ static void cmdline_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, bool sh
   msg_hist_off = false;
 }
 
+/// @return  the options that "spats[last_idx]" is used with, to find out
+///          whether the search index is still valid.
+static int search_index_flags(void)
+{
+  return (p_ic ? 1 : 0) | (p_scs ? 2 : 0) | (magic_isset() ? 4 : 0)
+         | (spats[last_idx].no_scs ? 8 : 0);
+}
+
+/// Forget the matches in the search index of "buf".
+void search_index_clear(buf_T *buf)
+{
+  XFREE_CLEAR(buf->b_search_index.pat);
+  kv_destroy(buf->b_search_index.matches);
+  kv_init(buf->b_search_index.matches);
+  buf->b_search_index.dirty_top = 0;
+}
+
+/// Update the search index of "buf" for a change: lines "lnum" to "lnume"
+/// (exclusive) are now "lnum" to "lnume" + "xtra" (exclusive).  Matches in
+/// the changed lines are removed and the lines are searched again when the
+/// index is used.
+void search_index_changed(buf_T *buf, linenr_T lnum, linenr_T lnume, linenr_T xtra)
+{
+  if (buf->b_search_index.pat == NULL) {
+    return;
+  }
+  // While ":global" runs many lines change one at a time. Updating the index
+  // for each of them costs more than searching the buffer again once.
+  if (!buf->b_search_index.incremental || global_busy) {
+    search_index_clear(buf);
+    return;
+  }
+
+  size_t j = 0;
+  for (size_t i = 0; i < kv_size(buf->b_search_index.matches); i++) {
+    search_index_match_T m = kv_A(buf->b_search_index.matches, i);
+    if (m.start.lnum >= lnum && m.start.lnum < lnume) {
+      continue;
+    }
+    if (m.start.lnum >= lnume) {
+      m.start.lnum += xtra;
+      m.end.lnum += xtra;
+    }
+    kv_A(buf->b_search_index.matches, j++) = m;
+  }
+  kv_size(buf->b_search_index.matches) = j;
+
+  // Move the lines to search again and include the changed lines.
+  linenr_T top = lnum;
+  linenr_T bot = MAX(lnume + xtra - 1, lnum);
+  if (buf->b_search_index.dirty_top > 0) {
+    linenr_T dtop = buf->b_search_index.dirty_top;
+    linenr_T dbot = buf->b_search_index.dirty_bot;
+    top = MIN(top, dtop >= lnume ? dtop + xtra : dtop);
+    bot = MAX(bot, dbot >= lnume ? dbot + xtra : dbot);
+  }
+  buf->b_search_index.dirty_top = top;
+  buf->b_search_index.dirty_bot = bot;
+  buf->b_search_index.line_count += xtra;
+  // changed() has already incremented b:changedtick.
+  buf->b_search_index.changedtick = buf_get_changedtick(buf);
+}
+
+/// Add the matches of the last used search pattern in lines "top" to "bot"
+/// of the current buffer to its search index, at index "idx".
+/// When interrupted or timed out the matches found so far are still added and
+/// "*resumep" is set to the first line that still needs to be searched.
+///
+/// @return  false when interrupted or timed out.
+static bool search_index_scan(linenr_T top, linenr_T bot, size_t idx, proftime_T *tm,
+                              linenr_T *resumep)
+{
+  kvec_t(search_index_match_T) found = KV_INITIAL_VALUE;
+  pos_T pos = { top, 0, 0 };
+  pos_T endpos = { 0, 0, 0 };
+  searchit_arg_T sia = { .sa_stop_lnum = bot, .sa_tm = tm };
+  int options = SEARCH_KEEP | SEARCH_START;
+  const int save_ws = p_ws;
+
+  p_ws = false;
+  while (searchit(curwin, curbuf, &pos, &endpos, FORWARD, NULL, 1, options, RE_LAST,
+                  &sia) != FAIL) {
+    if (pos.lnum > bot) {
+      break;
+    }
+    kv_push(found, ((search_index_match_T){ .start = { pos.lnum, pos.col },
+                                            .end = { endpos.lnum, endpos.col } }));
+    options = SEARCH_KEEP;
+    fast_breakcheck();
+    if (got_int) {
+      break;
+    }
+  }
+  p_ws = save_ws;
+  // searchit() doesn't tell whether it stopped for the time limit.
+  bool ok = !got_int && !sia.sa_timed_out && (tm == NULL || !profile_passed_limit(*tm));
+
+  if (!ok) {
+    // Search the line where it stopped again, it may have more matches.
+    linenr_T resume = top;
+    if (sia.sa_stopped_lnum != 0) {
+      resume = sia.sa_stopped_lnum;
+    } else if (kv_size(found) > 0) {
+      resume = kv_last(found).start.lnum;
+    }
+    while (kv_size(found) > 0 && kv_last(found).start.lnum >= resume) {
+      (void)kv_pop(found);
+    }
+    *resumep = resume;
+  }
+  if (kv_size(found) > 0) {
+    search_index_match_T *items;
+    size_t n = kv_size(curbuf->b_search_index.matches);
+    kv_resize(curbuf->b_search_index.matches, n + kv_size(found));
+    items = curbuf->b_search_index.matches.items;
+    memmove(items + idx + kv_size(found), items + idx, (n - idx) * sizeof(*items));
+    memcpy(items + idx, found.items, kv_size(found) * sizeof(*items));
+    kv_size(curbuf->b_search_index.matches) = n + kv_size(found);
+  }
+  kv_destroy(found);
+  return ok;
+}
+
+/// Get the search index with the matches of the last used search pattern in
+/// the current buffer.  It is made when needed, lines that were changed are
+/// searched again.  When searching takes longer than "timeout" msec the
+/// matches found so far are kept, the next call continues from there.
+///
+/// @return  FAIL when an index can't be used for the pattern or when
+///          interrupted, NOTDONE when it took longer than "timeout" msec and
+///          the index is incomplete, OK otherwise.
+static int search_index_get(int timeout)
+{
+  char *pat = spats[last_idx].pat;
+  if (pat == NULL || re_pat_uses_position(pat)) {
+    return FAIL;
+  }
+
+  proftime_T tm;
+  if (timeout > 0) {
+    tm = profile_setlimit(timeout);
+  }
+  // A change that wasn't reported, e.g. reloading the buffer, also changes
+  // b:changedtick.
+  const int flags = search_index_flags();
+  if (curbuf->b_search_index.pat != NULL
+      && (curbuf->b_search_index.flags != flags
+          || curbuf->b_search_index.line_count != curbuf->b_ml.ml_line_count
+          || curbuf->b_search_index.changedtick != buf_get_changedtick(curbuf)
+          || strcmp(curbuf->b_search_index.pat, pat) != 0)) {
+    search_index_clear(curbuf);
+  }
+
+  if (curbuf->b_search_index.pat == NULL) {
+    // Only a pattern that matches inside a line can be updated for changes.
+    regprog_T *prog = vim_regcomp(pat, magic_isset() ? RE_MAGIC : 0);
+    curbuf->b_search_index.incremental = prog != NULL && !re_multiline(prog);
+    vim_regfree(prog);
+    curbuf->b_search_index.pat = xstrdup(pat);
+    curbuf->b_search_index.flags = flags;
+    curbuf->b_search_index.line_count = curbuf->b_ml.ml_line_count;
+    curbuf->b_search_index.changedtick = buf_get_changedtick(curbuf);
+    // Search all lines, as if they were all changed.
+    curbuf->b_search_index.dirty_top = 1;
+    curbuf->b_search_index.dirty_bot = curbuf->b_ml.ml_line_count;
+  }
+
+  if (curbuf->b_search_index.dirty_top > 0) {
+    linenr_T top = curbuf->b_search_index.dirty_top;
+    linenr_T bot = MIN(curbuf->b_search_index.dirty_bot, curbuf->b_ml.ml_line_count);
+    // Remove matches in lines between changes and find the index of the
+    // first match after "top".
+    size_t idx = SIZE_MAX;
+    size_t j = 0;
+    for (size_t i = 0; i < kv_size(curbuf->b_search_index.matches); i++) {
+      search_index_match_T m = kv_A(curbuf->b_search_index.matches, i);
+      if (m.start.lnum >= top && idx == SIZE_MAX) {
+        idx = j;
+      }
+      if (m.start.lnum < top || m.start.lnum > bot) {
+        kv_A(curbuf->b_search_index.matches, j++) = m;
+      }
+    }
+    kv_size(curbuf->b_search_index.matches) = j;
+    curbuf->b_search_index.dirty_top = 0;
+    linenr_T resume;
+    if (!search_index_scan(top, bot, idx == SIZE_MAX ? j : idx, timeout > 0 ? &tm : NULL,
+                           &resume)) {
+      // Keep what was found, the remaining lines are searched next time.
+      curbuf->b_search_index.dirty_top = resume;
+      curbuf->b_search_index.dirty_bot = bot;
+      return got_int ? FAIL : NOTDONE;
+    }
+  }
+  return OK;
+}
+
+/// Compute the search count from the search index of the current buffer.
+///
+/// @return  false when the index can't be used.
+static bool search_index_stat(pos_T *pos, int maxcount, int timeout, int *curp, int *cntp,
+                              bool *exact_matchp, int *incompletep)
+{
+  const int ret = search_index_get(timeout);
+  if (ret == FAIL) {
+    return false;
+  }
+
+  // Find the number of matches starting at or before "pos".
+  const search_index_match_T *matches = curbuf->b_search_index.matches.items;
+  size_t lo = 0;
+  size_t hi = kv_size(curbuf->b_search_index.matches);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (matches[mid].start.lnum < pos->lnum
+        || (matches[mid].start.lnum == pos->lnum && matches[mid].start.col <= pos->col)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  int cnt = (int)MIN(kv_size(curbuf->b_search_index.matches), INT_MAX);
+  int cur = (int)MIN(lo, INT_MAX);
+  *exact_matchp = false;
+  // Matches after the lines that were searched are not counted yet.
+  *incompletep = ret == NOTDONE ? 1 : 0;
+  if (maxcount > 0 && cnt > maxcount) {
+    // Counting stops after "maxcount" matches.
+    cnt = maxcount + 1;
+    *incompletep = 2;
+  }
+  if (cur > cnt) {
+    cur = cnt;
+  } else if (cur > 0) {
+    const search_index_match_T *m = &matches[cur - 1];
+    *exact_matchp = pos->lnum < m->end.lnum
+                    || (pos->lnum == m->end.lnum && pos->col < m->end.col);
+  }
+  *curp = cur;
+  *cntp = cnt;
+  return true;
+}
+
 // Add the search count information to "stat".
 // "stat" must not be NULL.
 // When "recompute" is true always recompute the numbers.
@@ -2710,6 +2996,12 @@ static void update_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, searchst
   if (equalpos(lastpos, *cursor_pos) && !wraparound
       && (dirc == 0 || dirc == '/' ? cur < cnt : cur > 1)) {
     cur += dirc == 0 ? 0 : dirc == '/' ? 1 : -1;
+  } else if (search_index_stat(&p, maxcount, timeout, &cur, &cnt, &exact_match, &incomplete)) {
+    xfree(lastpat);
+    lastpat = xstrdup(spats[last_idx].pat);
+    chgtick = (int)buf_get_changedtick(curbuf);
+    lbuf = curbuf;
+    lastpos = p;
   } else {
     proftime_T start;
     bool done_search = false;
@@ -3107,6 +3399,39 @@ static int fuzzy_match_recursive(const char *fuzpat, const char *str, uint32_t s
   return 0;  // no match
 }
 
+/// Get a bitmask of the ASCII characters in "s", ignoring case.  Each
+/// character sets bit (c & 63), which may be shared with other characters.
+/// Whitespace is skipped when "skipwhite" is true.  A non-ASCII byte may
+/// fold to an ASCII character, thus for "allow_mb" false it returns all bits
+/// set, and for "allow_mb" true non-ASCII bytes are ignored.
+static uint64_t fuzzy_char_mask(const char *s, bool skipwhite, bool allow_mb)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_PURE
+{
+  uint64_t mask = 0;
+
+  for (; *s != NUL; s++) {
+    const uint8_t c = (uint8_t)(*s);
+    if (c >= 0x80) {
+      if (!allow_mb) {
+        return UINT64_MAX;
+      }
+    } else if (!skipwhite || !ascii_iswhite(c)) {
+      mask |= (uint64_t)1 << (TOLOWER_ASC(c) & 63);
+    }
+  }
+  return mask;
+}
+
+/// Quick check if "str" may fuzzy match "pat": every ASCII character of the
+/// pattern must appear in "str".  This avoids the recursive matching for
+/// most of the strings that don't match.
+static bool fuzzy_match_possible(const char *str, const char *pat, bool matchseq)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT FUNC_ATTR_PURE
+{
+  const uint64_t pat_mask = fuzzy_char_mask(pat, !matchseq, true);
+  return (pat_mask & ~fuzzy_char_mask(str, false, false)) == 0;
+}
+
 /// fuzzy_match()
 ///
 /// Performs exhaustive search via recursion to find all possible matches and
@@ -3123,12 +3448,15 @@ bool fuzzy_match(char *const str, const char *const pat_arg, const bool matchseq
                  int *const outScore, uint32_t *const matches, const int maxMatches)
   FUNC_ATTR_NONNULL_ALL
 {
+  *outScore = 0;
+  if (!fuzzy_match_possible(str, pat_arg, matchseq)) {
+    return false;
+  }
+
   const int len = mb_charlen(str);
   bool complete = false;
   int numMatches = 0;
 
-  *outScore = 0;
-
   char *const save_pat = xstrdup(pat_arg);
   char *pat = save_pat;
   char *p = pat;
@@ -97,6 +97,10 @@ typedef struct {
   proftime_T *sa_tm;        ///< timeout limit or NULL
   int sa_timed_out;  ///< set when timed out
   int sa_wrapped;    ///< search wrapped around
+  linenr_T sa_resume_lnum;   ///< when != 0: continue a search that stopped in this line
+  int sa_resume_loop;        ///< "sa_stopped_loop" of the search to continue
+  linenr_T sa_stopped_lnum;  ///< set to the line where "sa_tm" stopped the search
+  int sa_stopped_loop;       ///< set when the search stopped after wrapping around
 } searchit_arg_T;
 
 typedef struct searchstat {
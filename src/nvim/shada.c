@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <msgpack/object.h>
 #include <msgpack/pack.h>
@@ -29,6 +30,7 @@
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
 #include "nvim/hashtab.h"
+#include "nvim/log.h"
 #include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
 #include "nvim/mark.h"
@@ -773,6 +775,43 @@ static bool shada_disabled(void)
   return strequal(p_shadafile, "NONE");
 }
 
+/// Time when the state of this instance was last read from or written to the
+/// ShaDa file: entries with an older timestamp are in the file already.
+static Timestamp shada_synced_at = 0;
+
+/// The ShaDa file as it was after this instance last read or wrote it, to
+/// tell whether another instance wrote it since.
+static char *synced_fname = NULL;
+static FileInfo synced_info;
+
+/// History and registers not read from the ShaDa file yet, see |shada-l|.
+static bool lazy_history = false;
+static bool lazy_registers = false;
+
+/// Remember the state of ShaDa file "fname" after reading or writing it.
+static void shada_remember_file(const char *const fname)
+  FUNC_ATTR_NONNULL_ALL
+{
+  XFREE_CLEAR(synced_fname);
+  if (os_fileinfo(fname, &synced_info)) {
+    synced_fname = xstrdup(fname);
+  }
+}
+
+/// @return true if ShaDa file "fname" was not changed since this instance
+///         last read or wrote it.
+static bool shada_file_unchanged(const char *const fname)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  FileInfo info;
+  return synced_fname != NULL && strcmp(synced_fname, fname) == 0
+         && os_fileinfo(fname, &info)
+         && os_fileinfo_id_equal(&info, &synced_info)
+         && info.stat.st_size == synced_info.stat.st_size
+         && info.stat.st_mtim.tv_sec == synced_info.stat.st_mtim.tv_sec
+         && info.stat.st_mtim.tv_nsec == synced_info.stat.st_mtim.tv_nsec;
+}
+
 /// Read ShaDa file
 ///
 /// @param[in]  file   File to read or NULL to use default name.
@@ -810,10 +849,16 @@ static int shada_read_file(const char *const file, const int flags)
     xfree(fname);
     return FAIL;
   }
-  xfree(fname);
 
+  if ((flags & kShaDaWantInfo) && shada_synced_at == 0) {
+    shada_synced_at = os_time();
+  }
   shada_read(&sd_reader, flags);
   sd_reader.close(&sd_reader);
+  if ((flags & kShaDaWantInfo) && !(flags & (kShaDaOnlyHistory | kShaDaOnlyRegisters))) {
+    shada_remember_file(fname);
+  }
+  xfree(fname);
 
   return OK;
 }
@@ -1091,7 +1136,7 @@ static void shada_read(ShaDaReadDef *const sd_reader, const int flags)
   const bool get_old_files = (flags & (kShaDaGetOldfiles | kShaDaForceit)
                               && (force || tv_list_len(oldfiles_list) == 0));
   const bool want_marks = flags & kShaDaWantMarks;
-  const unsigned srni_flags =
+  unsigned srni_flags =
     (unsigned)(
                (flags & kShaDaWantInfo
                 ? (kSDReadUndisableableData
@@ -1112,6 +1157,12 @@ static void shada_read(ShaDaReadDef *const sd_reader, const int flags)
                | (get_old_files
                   ? kSDReadLocalMarks
                   : 0));
+  if (flags & kShaDaLazy) {
+    srni_flags &= ~(unsigned)(kSDReadHistory | kSDReadRegisters);
+  } else if (flags & (kShaDaOnlyHistory | kShaDaOnlyRegisters)) {
+    srni_flags &= (unsigned)((flags & kShaDaOnlyHistory ? kSDReadHistory : 0)
+                             | (flags & kShaDaOnlyRegisters ? kSDReadRegisters : 0));
+  }
   if (srni_flags == 0) {
     // Nothing to do.
     return;
@@ -1258,11 +1309,8 @@ static void shada_read(ShaDaReadDef *const sd_reader, const int flags)
     case kSDItemJump:
     case kSDItemGlobalMark: {
       buf_T *buf = find_buffer(&fname_bufs, cur_entry.data.filemark.fname);
-      if (buf != NULL) {
-        XFREE_CLEAR(cur_entry.data.filemark.fname);
-      }
       xfmark_T fm = (xfmark_T) {
-        .fname = buf == NULL ? cur_entry.data.filemark.fname : NULL,
+        .fname = buf == NULL ? str_intern(cur_entry.data.filemark.fname) : NULL,
         .fmark = {
           .mark = cur_entry.data.filemark.mark,
           .fnum = (buf == NULL ? 0 : buf->b_fnum),
@@ -1271,8 +1319,10 @@ static void shada_read(ShaDaReadDef *const sd_reader, const int flags)
           .additional_data = cur_entry.data.filemark.additional_data,
         },
       };
+      XFREE_CLEAR(cur_entry.data.filemark.fname);
       if (cur_entry.type == kSDItemGlobalMark) {
         if (!mark_set_global(cur_entry.data.filemark.name, fm, !force)) {
+          str_unintern(fm.fname);
           shada_free_shada_entry(&cur_entry);
           break;
         }
@@ -1283,19 +1333,20 @@ static void shada_read(ShaDaReadDef *const sd_reader, const int flags)
       && curwin->w_jumplistidx + 1 <= curwin->w_jumplistlen) { \
     curwin->w_jumplistidx++; \
   }
-#define DUMMY_AFTERFREE(entry)
+#define UNINTERN_FNAME(entry) str_unintern(fm.fname)
+        // Both file names are interned, comparing pointers is enough.
         MERGE_JUMPS(curwin->w_jumplistlen, curwin->w_jumplist, xfmark_T,
                     fmark.timestamp, fmark.mark, cur_entry,
                     (buf == NULL
-                     ? (jl_entry.fname != NULL
-                        && strcmp(fm.fname, jl_entry.fname) == 0)
+                     ? jl_entry.fname == fm.fname
                      : fm.fmark.fnum == jl_entry.fmark.fnum),
-                    free_xfmark, SDE_TO_XFMARK, ADJUST_IDX, DUMMY_AFTERFREE);
+                    free_xfmark, SDE_TO_XFMARK, ADJUST_IDX, UNINTERN_FNAME);
 #undef SDE_TO_XFMARK
 #undef ADJUST_IDX
-#undef DUMMY_AFTERFREE
+#undef UNINTERN_FNAME
       }
-      // Do not free shada entry: its allocated memory was saved above.
+      // Do not free shada entry: its allocated memory was saved above, the
+      // file name was interned.
       break;
     }
     case kSDItemBufferList:
@@ -1812,6 +1863,23 @@ static inline ShaDaWriteResult shada_pack_pfreed_entry(msgpack_packer *const pac
   return ret;
 }
 
+/// Like shada_pack_pfreed_entry(), but skip the entry if it is older than
+/// "since": when appending to the file it is there already.
+static inline ShaDaWriteResult shada_pack_new_entry(msgpack_packer *const packer,
+                                                    PossiblyFreedShadaEntry entry,
+                                                    const size_t max_kbyte,
+                                                    const Timestamp since)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_ALWAYS_INLINE
+{
+  if (entry.data.timestamp < since) {
+    if (entry.can_free_entry) {
+      shada_free_shada_entry(&entry.data);
+    }
+    return kSDWriteSuccessful;
+  }
+  return shada_pack_pfreed_entry(packer, entry, max_kbyte);
+}
+
 /// Compare two FileMarks structure to order them by greatest_timestamp
 ///
 /// Order is reversed: structure with greatest greatest_timestamp comes first.
@@ -2473,7 +2541,12 @@ static int hist_type2char(const int type)
 /// @param[in]  sd_reader  Structure containing file reader definition. If it is
 ///                        not NULL then contents of this file will be merged
 ///                        with current Neovim runtime.
-static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef *const sd_reader)
+/// @param[in]  since      Skip entries with an older timestamp, zero to write
+///                        all of them.
+/// @param[in]  skip_known  Skip history and registers of the file without
+///                         decoding them: they are all known already.
+static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef *const sd_reader,
+                                    const Timestamp since, const bool skip_known)
   FUNC_ATTR_NONNULL_ARG(1)
 {
   ShaDaWriteResult ret = kSDWriteSuccessful;
@@ -2517,8 +2590,8 @@ static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef
   const unsigned srni_flags = (unsigned)(
                                          kSDReadUndisableableData
                                          | kSDReadUnknown
-                                         | (dump_history ? kSDReadHistory : 0)
-                                         | (dump_registers ? kSDReadRegisters : 0)
+                                         | (dump_history && !skip_known ? kSDReadHistory : 0)
+                                         | (dump_registers && !skip_known ? kSDReadRegisters : 0)
                                          | (dump_global_vars ? kSDReadVariables : 0)
                                          | (dump_global_marks ? kSDReadGlobalMarks : 0)
                                          | (num_marked_files ? kSDReadLocalMarks |
@@ -2826,7 +2899,7 @@ static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef
   do { \
     for (size_t i_ = 0; i_ < ARRAY_SIZE(wms_array); i_++) { \
       if ((wms_array)[i_].data.type != kSDItemMissing) { \
-        if (shada_pack_pfreed_entry(packer, (wms_array)[i_], max_kbyte) \
+        if (shada_pack_new_entry(packer, (wms_array)[i_], max_kbyte, since) \
             == kSDWriteFailed) { \
           ret = kSDWriteFailed; \
           goto shada_write_exit; \
@@ -2838,7 +2911,7 @@ static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef
   PACK_WMS_ARRAY(wms->numbered_marks);
   PACK_WMS_ARRAY(wms->registers);
   for (size_t i = 0; i < wms->jumps_size; i++) {
-    if (shada_pack_pfreed_entry(packer, wms->jumps[i], max_kbyte)
+    if (shada_pack_new_entry(packer, wms->jumps[i], max_kbyte, since)
         == kSDWriteFailed) {
       ret = kSDWriteFailed;
       goto shada_write_exit;
@@ -2847,7 +2920,7 @@ static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef
 #define PACK_WMS_ENTRY(wms_entry) \
   do { \
     if ((wms_entry).data.type != kSDItemMissing) { \
-      if (shada_pack_pfreed_entry(packer, wms_entry, max_kbyte) \
+      if (shada_pack_new_entry(packer, wms_entry, max_kbyte, since) \
           == kSDWriteFailed) { \
         ret = kSDWriteFailed; \
         goto shada_write_exit; \
@@ -2873,8 +2946,8 @@ static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef
   for (size_t i = 0; i < file_markss_to_dump; i++) {
     PACK_WMS_ARRAY(all_file_markss[i]->marks);
     for (size_t j = 0; j < all_file_markss[i]->changes_size; j++) {
-      if (shada_pack_pfreed_entry(packer, all_file_markss[i]->changes[j],
-                                  max_kbyte) == kSDWriteFailed) {
+      if (shada_pack_new_entry(packer, all_file_markss[i]->changes[j],
+                               max_kbyte, since) == kSDWriteFailed) {
         ret = kSDWriteFailed;
         goto shada_write_exit;
       }
@@ -2898,10 +2971,10 @@ static ShaDaWriteResult shada_write(ShaDaWriteDef *const sd_writer, ShaDaReadDef
       if (dump_one_history[i]) {
         hms_insert_whole_neovim_history(&wms->hms[i]);
         HMS_ITER(&wms->hms[i], cur_entry, {
-          if (shada_pack_pfreed_entry(packer, (PossiblyFreedShadaEntry) {
+          if (shada_pack_new_entry(packer, (PossiblyFreedShadaEntry) {
             .data = cur_entry->data,
             .can_free_entry = cur_entry->can_free_entry,
-          }, max_kbyte) == kSDWriteFailed) {
+          }, max_kbyte, since) == kSDWriteFailed) {
             ret = kSDWriteFailed;
             break;
           }
@@ -2932,6 +3005,111 @@ shada_write_exit:
 
 #undef PACK_STATIC_STR
 
+/// Check whether merging with ShaDa file "fname" can skip its history and
+/// registers: this instance read them and no other instance wrote the file
+/// since, so that they are all in this instance already, or were replaced.
+/// Not when the file may keep more history than this instance does.
+/// Unlike a full merge this does not bring back history entries that were
+/// removed from this instance, e.g. with histdel().
+static bool shada_can_skip_known(const char *const fname)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  if (lazy_history || lazy_registers || !shada_file_unchanged(fname)) {
+    return false;
+  }
+  for (int i = 0; i < HIST_COUNT; i++) {
+    if (get_shada_parameter(hist_type2char(i)) > p_hi) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Writer for ShaDaWriteDef which appends to a msgpack_sbuffer
+static ptrdiff_t write_sbuf(ShaDaWriteDef *const sd_writer, const void *const src,
+                            const size_t size)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  msgpack_sbuffer_write(sd_writer->cookie, src, size);
+  return (ptrdiff_t)size;
+}
+
+/// Append the entries changed since the last read or write to ShaDa file
+/// "fname", instead of merging them with it and writing it again, see
+/// |shada-a|.
+///
+/// All entries are serialized into one buffer and written with one write() on
+/// a file opened with O_APPEND, so that concurrent appends from other instances
+/// are not mixed with it.
+///
+/// @return OK or FAIL, NOTDONE if the file should be written as usual: when
+///         appending is disabled, the file is too large or does not look like
+///         a ShaDa file.
+static int shada_append_file(const char *const fname)
+{
+  const int max_kbyte = get_shada_parameter('a');
+  FileInfo info;
+  if (max_kbyte < 0 || !os_fileinfo(fname, &info) || !S_ISREG(info.stat.st_mode)
+      || info.stat.st_size == 0 || (uint64_t)info.stat.st_size > (uint64_t)max_kbyte * 1024) {
+    return NOTDONE;
+  }
+  ShaDaReadDef sd_reader;
+  if (open_shada_file_for_reading(fname, &sd_reader) != 0) {
+    return NOTDONE;
+  }
+  const int first_char = read_char(&sd_reader);
+  sd_reader.close(&sd_reader);
+  if (first_char != kSDItemHeader) {
+    return NOTDONE;
+  }
+
+  if (p_verbose > 1) {
+    verbose_enter();
+    smsg(0, _("Appending to ShaDa file \"%s\""), fname);
+    verbose_leave();
+  }
+
+  msgpack_sbuffer sbuf;
+  msgpack_sbuffer_init(&sbuf);
+  ShaDaWriteDef sd_writer = {
+    .write = &write_sbuf,
+    .close = NULL,
+    .cookie = &sbuf,
+    .error = NULL,
+  };
+  const Timestamp write_time = os_time();
+  int ret = FAIL;
+  if (shada_write(&sd_writer, NULL, shada_synced_at, false) == kSDWriteSuccessful) {
+    // Not through a FileDescriptor, its buffer would split a large write.
+    const int fd = os_open(fname, O_WRONLY | O_APPEND, 0);
+    if (fd < 0) {
+      semsg(_(SERR "System error while opening ShaDa file %s for appending: %s"),
+            fname, os_strerror(fd));
+    } else {
+      const bool was_unchanged = shada_file_unchanged(fname);
+      const ptrdiff_t written = os_write(fd, sbuf.data, sbuf.size, false);
+      if (written < 0) {
+        semsg(_(SERR "System error while writing ShaDa file: %s"),
+              os_strerror((int)written));
+      } else {
+        shada_synced_at = write_time;
+        ret = OK;
+      }
+      os_close(fd);
+      // Only if no other instance wrote to it in the meantime.
+      FileInfo new_info;
+      if (ret == OK && was_unchanged && os_fileinfo(fname, &new_info)
+          && (uint64_t)new_info.stat.st_size == (uint64_t)info.stat.st_size + sbuf.size) {
+        shada_remember_file(fname);
+      } else {
+        XFREE_CLEAR(synced_fname);
+      }
+    }
+  }
+  msgpack_sbuffer_destroy(&sbuf);
+  return ret;
+}
+
 /// Write ShaDa file to a given location
 ///
 /// @param[in]  fname    File to write to. If it is NULL or empty then default
@@ -2945,7 +3123,22 @@ int shada_write_file(const char *const file, bool nomerge)
     return FAIL;
   }
 
+  if (nomerge) {
+    // Not merged with the file: what was left in it would be lost.
+    shada_load_history();
+    shada_load_registers();
+  }
+
   char *const fname = shada_filename(file);
+  NVIM_PROBE(shada_write_begin, 2, fname, nomerge);
+  if (!nomerge) {
+    const int append_ret = shada_append_file(fname);
+    if (append_ret != NOTDONE) {
+      NVIM_PROBE(shada_write_end, 2, fname, append_ret);
+      xfree(fname);
+      return append_ret;
+    }
+  }
   char *tempname = NULL;
   ShaDaWriteDef sd_writer = {
     .write = &write_file,
@@ -2992,6 +3185,7 @@ shada_write_file_open: {}
           // wrong then.
           semsg(_("E138: All %s.tmp.X files exist, cannot write ShaDa file!"),
                 fname);
+          NVIM_PROBE(shada_write_end, 2, fname, FAIL);
           xfree(fname);
           xfree(tempname);
           assert(sd_reader.close != NULL);
@@ -3019,6 +3213,7 @@ shada_write_file_nomerge: {}
           semsg(_(SERR "Failed to create directory %s "
                   "for writing ShaDa file: %s"),
                 failed_dir, os_strerror(ret));
+          NVIM_PROBE(shada_write_end, 2, fname, FAIL);
           xfree(fname);
           xfree(failed_dir);
           return FAIL;
@@ -3036,6 +3231,7 @@ shada_write_file_nomerge: {}
   }
 
   if (sd_writer.cookie == NULL) {
+    NVIM_PROBE(shada_write_end, 2, fname, FAIL);
     xfree(fname);
     xfree(tempname);
     if (sd_reader.cookie != NULL) {
@@ -3050,13 +3246,18 @@ shada_write_file_nomerge: {}
     verbose_leave();
   }
 
+  const Timestamp write_time = os_time();
   const ShaDaWriteResult sw_ret = shada_write(&sd_writer, (nomerge
                                                            ? NULL
-                                                           : &sd_reader));
+                                                           : &sd_reader), 0,
+                                              !nomerge && shada_can_skip_known(fname));
+  if (sw_ret == kSDWriteSuccessful) {
+    shada_synced_at = write_time;
+  }
   assert(sw_ret != kSDWriteIgnError);
+  bool did_remove = false;
   if (!nomerge) {
     sd_reader.close(&sd_reader);
-    bool did_remove = false;
     if (sw_ret == kSDWriteSuccessful) {
       FileInfo old_info;
       if (!os_fileinfo(fname, &old_info)
@@ -3116,7 +3317,12 @@ shada_write_file_did_not_remove:
     xfree(tempname);
   }
   sd_writer.close(&sd_writer);
+  // Only after closing it: what is still buffered changes the size.
+  if (sw_ret == kSDWriteSuccessful && (nomerge || did_remove)) {
+    shada_remember_file(fname);
+  }
 
+  NVIM_PROBE(shada_write_end, 2, fname, OK);
   xfree(fname);
   return OK;
 }
@@ -3145,6 +3351,40 @@ int shada_read_everything(const char *const fname, const bool forceit, const boo
                          |(missing_ok ? 0 : kShaDaMissingError));
 }
 
+/// Read the ShaDa file at startup
+///
+/// With |shada-l| history and registers are only read when they are first
+/// used, see shada_load_history() and shada_load_registers().
+void shada_read_startup(void)
+{
+  const bool lazy = find_shada_parameter('l') != NULL;
+  if (shada_read_file(NULL, (kShaDaWantInfo|kShaDaWantMarks|kShaDaGetOldfiles
+                             |(lazy ? kShaDaLazy : 0))) == OK && lazy) {
+    lazy_history = true;
+    lazy_registers = true;
+  }
+}
+
+/// Read history from the ShaDa file if it was left there at startup
+void shada_load_history(void)
+{
+  if (!lazy_history) {
+    return;
+  }
+  lazy_history = false;
+  (void)shada_read_file(NULL, kShaDaWantInfo|kShaDaOnlyHistory);
+}
+
+/// Read registers from the ShaDa file if they were left there at startup
+void shada_load_registers(void)
+{
+  if (!lazy_registers) {
+    return;
+  }
+  lazy_registers = false;
+  (void)shada_read_file(NULL, kShaDaWantInfo|kShaDaOnlyRegisters);
+}
+
 static void shada_free_shada_entry(ShadaEntry *const entry)
 {
   if (entry == NULL) {
@@ -4060,6 +4300,7 @@ static inline size_t shada_init_jumps(PossiblyFreedShadaEntry *jumps,
 void shada_encode_regs(msgpack_sbuffer *const sbuf)
   FUNC_ATTR_NONNULL_ALL
 {
+  shada_load_registers();
   WriteMergerState *const wms = xcalloc(1, sizeof(*wms));
   shada_initialize_registers(wms, -1);
   msgpack_packer packer;
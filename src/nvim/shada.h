@@ -9,6 +9,9 @@ typedef enum {
   kShaDaForceit = 4,        ///< Overwrite info already read
   kShaDaGetOldfiles = 8,    ///< Load v:oldfiles.
   kShaDaMissingError = 16,  ///< Error out when os_open returns -ENOENT.
+  kShaDaLazy = 32,          ///< Leave history and registers for later.
+  kShaDaOnlyHistory = 64,   ///< Load only history (with kShaDaWantInfo).
+  kShaDaOnlyRegisters = 128,  ///< Load only registers (with kShaDaWantInfo).
 } ShaDaReadFileFlags;
 
 #ifdef INCLUDE_GENERATED_DECLARATIONS
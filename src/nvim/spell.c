@@ -58,9 +58,11 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "klib/kvec.h"
 #include "nvim/ascii_defs.h"
 #include "nvim/autocmd.h"
 #include "nvim/buffer.h"
@@ -178,6 +180,10 @@ typedef struct syl_item_S {
 spelltab_T spelltab;
 int did_set_spelltab;
 
+// Incremented when something that spell_check() depends on changes, the
+// results in b_spell_cache made before that are not used then.
+static int spell_cache_gen = 0;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "spell.c.generated.h"
 #endif
@@ -191,6 +197,10 @@ enum {
   FIND_KEEPCOMPOUND = 4,  ///< find keep-case compound word
 };
 
+/// Number of lines in b_spell_cache, a line is stored at the index given by
+/// the hash of its text.
+enum { SPELL_CACHE_SIZE = 512, };
+
 /// type values for get_char_type
 enum {
   CHAR_OTHER = 0,
@@ -421,6 +431,99 @@ size_t spell_check(win_T *wp, char *ptr, hlf_T *attrp, int *capcol, bool docount
   return (size_t)(mi.mi_end - ptr);
 }
 
+/// Hash of the text of a line and of "next", the start of the next line as
+/// used for spell checking, or NULL.
+uint64_t spell_line_hash(const char *line, const char *next)
+  FUNC_ATTR_NONNULL_ARG(1) FUNC_ATTR_PURE
+{
+  uint64_t h = 14695981039346656037ULL;  // FNV-1a
+  for (const char *p = line; *p != NUL; p++) {
+    h = (h ^ (uint8_t)(*p)) * 1099511628211ULL;
+  }
+  if (next != NULL) {
+    h = (h ^ NL) * 1099511628211ULL;
+    for (const char *p = next; *p != NUL; p++) {
+      h = (h ^ (uint8_t)(*p)) * 1099511628211ULL;
+    }
+  }
+  return h;
+}
+
+/// Like spell_check() for "ptr", the text at column "col" of a line whose
+/// text has hash "hash", see spell_line_hash().
+///
+/// The results are kept per line text in the window's synblock, so that a
+/// line which is redrawn without being changed, also when it moved, does not
+/// have its words looked up again. Words are only counted for suggestions
+/// when "docount" is true and they were not checked before.
+size_t spell_check_cached(win_T *wp, uint64_t hash, colnr_T col, char *ptr, hlf_T *attrp,
+                          int *capcol, bool docount)
+  FUNC_ATTR_NONNULL_ARG(1, 4, 5, 6)
+{
+  synblock_T *synblock = wp->w_s;
+  if (synblock->b_spell_cache == NULL) {
+    synblock->b_spell_cache = xcalloc(SPELL_CACHE_SIZE, sizeof(spellline_T));
+  }
+  spellline_T *sl = &synblock->b_spell_cache[hash % SPELL_CACHE_SIZE];
+  if (sl->sl_hash != hash || sl->sl_gen != spell_cache_gen) {
+    sl->sl_hash = hash;
+    sl->sl_gen = spell_cache_gen;
+    sl->sl_next = 0;
+    kv_size(sl->sl_words) = 0;
+  }
+
+  // Words are checked from the start of the line, look after the previous
+  // word first.
+  size_t n = kv_size(sl->sl_words);
+  for (size_t i = 0; i < n; i++) {
+    spellword_T *sw = &kv_A(sl->sl_words, (sl->sl_next + i) % n);
+    if (sw->sw_col == col && sw->sw_capcol == *capcol) {
+      g_stats.spell_cache_hit++;
+      sl->sl_next = (sl->sl_next + i + 1) % n;
+      if (sw->sw_hlf != HLF_COUNT) {
+        *attrp = sw->sw_hlf;
+      }
+      *capcol = sw->sw_capcol_out;
+      return (size_t)sw->sw_len;
+    }
+  }
+
+  hlf_T hlf = HLF_COUNT;
+  int capcol_in = *capcol;
+  size_t len = spell_check(wp, ptr, &hlf, capcol, docount);
+  kv_push(sl->sl_words, ((spellword_T){
+    .sw_col = col,
+    .sw_capcol = capcol_in,
+    .sw_capcol_out = *capcol,
+    .sw_len = (int)len,
+    .sw_hlf = hlf,
+  }));
+  sl->sl_next = 0;
+  if (hlf != HLF_COUNT) {
+    *attrp = hlf;
+  }
+  return len;
+}
+
+/// Free the spell_check() results of "synblock".
+void spell_cache_free(synblock_T *synblock)
+{
+  if (synblock->b_spell_cache == NULL) {
+    return;
+  }
+  for (int i = 0; i < SPELL_CACHE_SIZE; i++) {
+    kv_destroy(synblock->b_spell_cache[i].sl_words);
+  }
+  XFREE_CLEAR(synblock->b_spell_cache);
+}
+
+/// Drop all spell_check() results, after the languages or options used for
+/// spell checking changed.
+void spell_cache_invalidate(void)
+{
+  spell_cache_gen++;
+}
+
 /// Determine the type of character "c".
 static int get_char_type(int c)
 {
@@ -1692,6 +1795,17 @@ void slang_clear(slang_T *lp)
 {
   garray_T *gap;
 
+  if (lp->sl_map != NULL) {
+    // The trees were read at once from the spell file.
+    XFREE_CLEAR(lp->sl_map);
+    lp->sl_fbyts = NULL;
+    lp->sl_kbyts = NULL;
+    lp->sl_pbyts = NULL;
+    lp->sl_fidxs = NULL;
+    lp->sl_kidxs = NULL;
+    lp->sl_pidxs = NULL;
+  }
+
   XFREE_CLEAR(lp->sl_fbyts);
   XFREE_CLEAR(lp->sl_kbyts);
   XFREE_CLEAR(lp->sl_pbyts);
@@ -2167,6 +2281,7 @@ char *parse_spelllang(win_T *wp)
   // Everything is fine, store the new b_langp value.
   ga_clear(&wp->w_s->b_langp);
   wp->w_s->b_langp = ga;
+  spell_cache_invalidate();
 
   // For each language figure out what language to use for sound folding and
   // REP items.  If the language doesn't support it itself use another one
@@ -2353,6 +2468,7 @@ void spell_free_all(void)
   }
 
   spell_delete_wordlist();
+  spell_cache_invalidate();
 
   XFREE_CLEAR(repl_to);
   XFREE_CLEAR(repl_from);
@@ -3728,5 +3844,6 @@ const char *compile_cap_prog(synblock_T *synblock)
   }
 
   vim_regfree(rp);
+  spell_cache_invalidate();
   return NULL;
 }
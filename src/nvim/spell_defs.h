@@ -135,6 +135,7 @@ struct slang_S {
   idx_T *sl_kidxs;    ///< keep-case word indexes
   uint8_t *sl_pbyts;  ///< prefix tree word bytes
   idx_T *sl_pidxs;    ///< prefix tree word indexes
+  char *sl_map;  ///< when not NULL the trees point into it, see spell_map_trees()
 
   char *sl_info;      ///< infotext string or NULL
 
@@ -7,6 +7,7 @@
 //                        <LWORDTREE>
 //                        <KWORDTREE>
 //                        <PREFIXTREE>
+//                        <TREEMAP>     (only with SN_TREEMAP)
 //
 // <HEADER>: <fileID> <versionnr>
 //
@@ -101,6 +102,8 @@
 //
 // sectionID == SN_NOCOMPOUNDSUGS: nothing
 //
+// sectionID == SN_TREEMAP: nothing, <TREEMAP> follows the trees
+//
 // sectionID == SN_WORDS: <word> ...
 // <word>        N bytes    NUL terminated common word
 //
@@ -198,6 +201,27 @@
 //                          from HEADER.
 //
 // All text characters are in 'encoding', but stored as single bytes.
+//
+//
+// <TREEMAP>: <mappad> <mapheader> <maptree> <maptree> <maptree>
+//              <mapstart> <mapmagic>
+//
+// The three trees as they are in memory after reading them, so that they can
+// be read at once and used in place, see spell_map_trees().  Numbers
+// other than <mapstart> are in the byte order of the machine that wrote the
+// file, when it doesn't match the trees are read as usual.
+//
+// <mappad>     N bytes     Zero bytes, <mapheader> starts at a multiple of 8.
+// <mapheader>  4 bytes     0x01020304, to check the byte order.
+//              4 bytes     sizeof(idx_T).
+// <maptree>: <maplen> <mapidxs> <mapbyts>
+// <maplen>     4 bytes     Number of nodes in the tree, followed by 4 zero
+//                          bytes.
+// <mapidxs>    N * 4 bytes The index array of the tree.
+// <mapbyts>    N bytes     The byte array of the tree, followed by zero bytes
+//                          so that <maptree> ends at a multiple of 8.
+// <mapstart>   8 bytes     Offset of <mapheader> in the file, MSB first.
+// <mapmagic>   8 bytes     VIMSPELLMAPMAGIC
 
 // Vim .sug file format:  <SUGHEADER>
 //                        <SUGWORDTREE>
@@ -229,6 +253,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -291,6 +316,9 @@ enum {
 #define VIMSPELLMAGIC "VIMspell"  // string at start of Vim spell file
 #define VIMSPELLMAGICL (sizeof(VIMSPELLMAGIC) - 1)
 #define VIMSPELLVERSION 50
+#define VIMSPELLMAPMAGIC "VIMspmap"  // string at the end of <TREEMAP>
+#define VIMSPELLMAPMAGICL (sizeof(VIMSPELLMAPMAGIC) - 1)
+#define TREEMAP_FOOTER_LEN 16        // <mapstart> and <mapmagic>
 
 // Section IDs.  Only renumber them when VIMSPELLVERSION changes!
 enum {
@@ -311,6 +339,7 @@ enum {
   SN_NOSPLITSUGS = 14,     // don't split word for suggestions
   SN_INFO = 15,            // info section
   SN_NOCOMPOUNDSUGS = 16,  // don't compound for suggestions
+  SN_TREEMAP = 17,         // <TREEMAP> follows the trees
   SN_END = 255,            // end of sections
 };
 
@@ -600,6 +629,7 @@ slang_T *spell_load_file(char *fname, char *lang, slang_T *old_lp, bool silent)
   slang_T *lp = NULL;
   int res;
   bool did_estack_push = false;
+  bool has_treemap = false;
 
   FILE *fd = os_fopen(fname, "r");
   if (fd == NULL) {
@@ -739,6 +769,10 @@ slang_T *spell_load_file(char *fname, char *lang, slang_T *old_lp, bool silent)
       lp->sl_nocompoundsugs = true;
       break;
 
+    case SN_TREEMAP:
+      has_treemap = true;
+      break;
+
     case SN_COMPOUND:
       res = read_compound(fd, lp, len);
       break;
@@ -786,24 +820,27 @@ truncerr:
     }
   }
 
-  // <LWORDTREE>
-  res = spell_read_tree(fd, &lp->sl_fbyts, &lp->sl_fbyts_len,
-                        &lp->sl_fidxs, false, 0);
-  if (res != 0) {
-    goto someerror;
-  }
+  // <TREEMAP>, when it can't be used read the trees.
+  if (!has_treemap || spell_map_trees(lp, fd) == FAIL) {
+    // <LWORDTREE>
+    res = spell_read_tree(fd, &lp->sl_fbyts, &lp->sl_fbyts_len,
+                          &lp->sl_fidxs, false, 0);
+    if (res != 0) {
+      goto someerror;
+    }
 
-  // <KWORDTREE>
-  res = spell_read_tree(fd, &lp->sl_kbyts, NULL, &lp->sl_kidxs, false, 0);
-  if (res != 0) {
-    goto someerror;
-  }
+    // <KWORDTREE>
+    res = spell_read_tree(fd, &lp->sl_kbyts, NULL, &lp->sl_kidxs, false, 0);
+    if (res != 0) {
+      goto someerror;
+    }
 
-  // <PREFIXTREE>
-  res = spell_read_tree(fd, &lp->sl_pbyts, NULL, &lp->sl_pidxs, true,
-                        lp->sl_prefixcnt);
-  if (res != 0) {
-    goto someerror;
+    // <PREFIXTREE>
+    res = spell_read_tree(fd, &lp->sl_pbyts, NULL, &lp->sl_pidxs, true,
+                          lp->sl_prefixcnt);
+    if (res != 0) {
+      goto someerror;
+    }
   }
 
   // For a new file link it in the list of spell files.
@@ -1638,6 +1675,130 @@ static int *mb_str2wide(const char *s)
   return res;
 }
 
+/// Get the offset of <mapheader> from "footer", the last
+/// TREEMAP_FOOTER_LEN bytes of a spell file of "size" bytes.
+static int tree_map_start(const char *footer, size_t size, size_t *start)
+{
+  if (memcmp(footer + 8, VIMSPELLMAPMAGIC, VIMSPELLMAPMAGICL) != 0) {
+    return FAIL;
+  }
+  uint64_t n = 0;
+  for (int i = 0; i < 8; i++) {
+    n = (n << 8) + (uint8_t)footer[i];
+  }
+  if (n % 8 != 0 || n + TREEMAP_FOOTER_LEN + 8 > size) {
+    return FAIL;
+  }
+  *start = (size_t)n;
+  return OK;
+}
+
+/// Check that the rows of siblings of a tree from <TREEMAP> and the children
+/// they point to are inside the arrays, as read_tree_node() does when reading
+/// a tree.
+static bool tree_map_valid(const uint8_t *byts, const idx_T *idxs, int len)
+{
+  int i = 0;
+  while (i < len) {
+    int n = byts[i];
+    if (n == 0 || i + n >= len) {
+      return false;
+    }
+    for (int j = i + 1; j <= i + n; j++) {
+      if (byts[j] != 0 && (idxs[j] <= 0 || idxs[j] >= len)) {
+        return false;
+      }
+    }
+    i += n + 1;
+  }
+  return true;
+}
+
+/// Use the trees from <TREEMAP> of the spell file "fd" for "lp".
+///
+/// <TREEMAP> is read at once and the trees are used in place, they don't need
+/// to be built node by node.  The file is not mapped in memory: when it is
+/// truncated while mapped, e.g. by copying another file over it, accessing
+/// the trees would be a bus error.
+///
+/// @param fd  spell file opened for reading, positioned at <LWORDTREE>
+///
+/// @return  OK when the trees were set.  FAIL when the trees have to be read,
+///          "fd" is then still positioned at <LWORDTREE>.
+static int spell_map_trees(slang_T *lp, FILE *fd)
+{
+  const long pos = ftell(fd);
+  size_t size = 0;
+  char *data = NULL;  // <mapheader> and what follows
+  size_t start = 0;
+
+  if (pos >= 0 && fseek(fd, 0, SEEK_END) == 0) {
+    char footer[TREEMAP_FOOTER_LEN];
+    long end = ftell(fd);
+    if (end >= TREEMAP_FOOTER_LEN
+        && fseek(fd, end - TREEMAP_FOOTER_LEN, SEEK_SET) == 0
+        && fread(footer, sizeof(footer), 1, fd) == 1
+        && tree_map_start(footer, (size_t)end, &start) == OK
+        && fseek(fd, (long)start, SEEK_SET) == 0) {
+      size = (size_t)end;
+      data = xmalloc(size - start);
+      if (fread(data, size - start, 1, fd) != 1) {
+        XFREE_CLEAR(data);
+      }
+    }
+  }
+
+  bool ok = data != NULL;
+  uint8_t *byts[3] = { NULL, NULL, NULL };
+  idx_T *idxs[3] = { NULL, NULL, NULL };
+  int lens[3] = { 0, 0, 0 };
+  if (ok) {
+    char *p = data;
+    const char *const end = data + (size - start - TREEMAP_FOOTER_LEN);
+    uint32_t header[2];
+    memcpy(header, p, sizeof(header));
+    p += sizeof(header);
+    ok = header[0] == 0x01020304 && header[1] == sizeof(idx_T);
+    for (int i = 0; ok && i < 3; i++) {
+      uint32_t len;
+      if (end - p < 8) {
+        ok = false;
+        break;
+      }
+      memcpy(&len, p, sizeof(len));
+      p += 8;
+      size_t n = ((size_t)len * (sizeof(idx_T) + 1) + 7) & ~(size_t)7;
+      if (len >= INT_MAX / (sizeof(idx_T) + 1) || (size_t)(end - p) < n) {
+        ok = false;
+        break;
+      }
+      if (len > 0) {
+        lens[i] = (int)len;
+        idxs[i] = (idx_T *)p;
+        byts[i] = (uint8_t *)p + (size_t)len * sizeof(idx_T);
+        ok = tree_map_valid(byts[i], idxs[i], lens[i]);
+      }
+      p += n;
+    }
+  }
+
+  if (!ok) {
+    xfree(data);
+    (void)fseek(fd, pos, SEEK_SET);
+    return FAIL;
+  }
+
+  lp->sl_fbyts = byts[0];
+  lp->sl_fbyts_len = lens[0];
+  lp->sl_fidxs = idxs[0];
+  lp->sl_kbyts = byts[1];
+  lp->sl_kidxs = idxs[1];
+  lp->sl_pbyts = byts[2];
+  lp->sl_pidxs = idxs[2];
+  lp->sl_map = data;
+  return OK;
+}
+
 /// Reads a tree from the .spl or .sug file.
 /// Allocates the memory and stores pointers in "bytsp" and "idxsp".
 /// This is skipped when the tree has zero length.
@@ -4564,10 +4725,16 @@ static int write_vim_spell(spellinfo_T *spin, char *fname)
     fwv &= fwrite(spin->si_syllable, l, 1, fd);         // <syllable>
   }
 
+  // SN_TREEMAP: <TREEMAP> follows the trees
+  putc(SN_TREEMAP, fd);                                 // <sectionID>
+  putc(0, fd);                                          // <sectionflags>
+  put_bytes(fd, 0, 4);                                  // <sectionlen>
+
   // end of <SECTIONS>
   putc(SN_END, fd);                                     // <sectionend>
 
   // <LWORDTREE>  <KWORDTREE>  <PREFIXTREE>
+  const long trees_start = ftell(fd);
   spin->si_memtot = 0;
   for (unsigned round = 1; round <= 3; round++) {
     wordnode_T *tree;
@@ -4600,6 +4767,12 @@ static int write_vim_spell(spellinfo_T *spin, char *fname)
   if (putc(0, fd) == EOF) {
     retval = FAIL;
   }
+
+  // <TREEMAP>
+  if (retval == OK && fwv == 1
+      && write_tree_map(fd, fname, trees_start, spin->si_prefcond.ga_len) == FAIL) {
+    retval = FAIL;
+  }
 theend:
   if (fclose(fd) == EOF) {
     retval = FAIL;
@@ -4615,6 +4788,70 @@ theend:
   return retval;
 }
 
+/// Write <TREEMAP> for the trees written to "fd" from offset "start".
+/// The trees are read back from "fname", so that the arrays are exactly what
+/// spell_read_tree() makes of them.
+///
+/// @param prefixcnt  number of prefix conditions
+static int write_tree_map(FILE *fd, const char *fname, long start, int prefixcnt)
+{
+  uint8_t *byts[3] = { NULL, NULL, NULL };
+  idx_T *idxs[3] = { NULL, NULL, NULL };
+  int lens[3] = { 0, 0, 0 };
+  int retval = FAIL;
+
+  FILE *rfd = NULL;
+  if (start >= 0 && fflush(fd) == 0 && (rfd = os_fopen(fname, "r")) != NULL
+      && fseek(rfd, start, SEEK_SET) == 0) {
+    retval = OK;
+    for (int i = 0; i < 3 && retval == OK; i++) {
+      if (spell_read_tree(rfd, &byts[i], &lens[i], &idxs[i], i == 2, prefixcnt) != 0) {
+        retval = FAIL;
+      }
+    }
+  }
+  if (rfd != NULL) {
+    fclose(rfd);
+  }
+
+  long pos = ftell(fd);
+  if (pos < 0) {
+    retval = FAIL;
+  }
+  if (retval == OK) {
+    // <mappad>
+    for (; pos % 8 != 0; pos++) {
+      putc(0, fd);
+    }
+    // <mapheader>
+    uint32_t header[2] = { 0x01020304, (uint32_t)sizeof(idx_T) };
+    size_t fwv = fwrite(header, sizeof(header), 1, fd);
+    for (int i = 0; i < 3; i++) {
+      // <maptree>: <maplen> <mapidxs> <mapbyts>
+      uint32_t len[2] = { (uint32_t)lens[i], 0 };
+      fwv &= fwrite(len, sizeof(len), 1, fd);
+      if (lens[i] > 0) {
+        fwv &= fwrite(idxs[i], sizeof(idx_T) * (size_t)lens[i], 1, fd);
+        fwv &= fwrite(byts[i], (size_t)lens[i], 1, fd);
+        for (size_t n = (size_t)lens[i] * (sizeof(idx_T) + 1); n % 8 != 0; n++) {
+          putc(0, fd);
+        }
+      }
+    }
+    put_bytes(fd, (uintmax_t)pos, 8);                   // <mapstart>
+    fwv &= fwrite(VIMSPELLMAPMAGIC, VIMSPELLMAPMAGICL, 1, fd);  // <mapmagic>
+    if (fwv != 1) {
+      retval = FAIL;
+    }
+  }
+
+  for (int i = 0; i < 3; i++) {
+    xfree(byts[i]);
+    xfree(idxs[i]);
+  }
+  return retval;
+}
+
 // Clear the index and wnode fields of "node", it siblings and its
 // children.  This is needed because they are a union with other items to save
 // space.
@@ -77,6 +77,7 @@ typedef struct suginfo_S {
   char su_sal_badword[MAXWLEN];    ///< su_badword soundfolded
   hashtab_T su_banned;             ///< table with banned words
   slang_T *su_sallang;             ///< default language for sound folding
+  proftime_T su_time_limit;        ///< end of the search, zero for no limit
 } suginfo_T;
 
 /// One word suggestion.  Used in "si_ga".
@@ -901,6 +902,10 @@ static void spell_suggest_intern(suginfo_T *su, bool interactive)
   // Load the .sug file(s) that are available and not done yet.
   suggest_load_files();
 
+  // The time limit is for the whole search, when it's reached the
+  // suggestions found so far are used.
+  su->su_time_limit = profile_setlimit(spell_suggest_timeout);
+
   // 1. Try special cases, such as repeating a word: "the the" -> "the".
   //
   // Set a maximum score to limit the combination of operations that is
@@ -1085,7 +1090,8 @@ static void suggest_try_change(suginfo_T *su)
 #ifdef SUGGEST_PROFILE
     prof_init();
 #endif
-    suggest_trie_walk(su, lp, fword, false);
+    suggest_trie_walk(su, lp, fword, false,
+                      suggest_lang_time_limit(su, lpi, curwin->w_s->b_langp.ga_len));
 #ifdef SUGGEST_PROFILE
     prof_report("try_change");
 #endif
@@ -1096,6 +1102,20 @@ static void suggest_try_change(suginfo_T *su)
 #define TRY_DEEPER(su, stack, depth, add) \
   ((depth) < MAXWLEN - 1 && (stack)[depth].ts_score + (add) < (su)->su_maxscore)
 
+/// Time limit for searching language "lpi" of "lpcount" languages: an equal
+/// share of what is left until "su_time_limit", so that the other languages
+/// are still searched when one takes long.  A language that is done early
+/// leaves its time to the next ones.
+static proftime_T suggest_lang_time_limit(const suginfo_T *su, int lpi, int lpcount)
+{
+  if (su->su_time_limit == 0 || profile_passed_limit(su->su_time_limit)) {
+    return su->su_time_limit;
+  }
+  proftime_T now = profile_start();
+  proftime_T left = profile_sub(su->su_time_limit, now);
+  return profile_add(now, profile_divide(left, MAX(lpcount - lpi, 1)));
+}
+
 /// Try finding suggestions by adding/removing/swapping letters.
 ///
 /// This uses a state machine.  At each node in the tree we try various
@@ -1125,7 +1145,10 @@ static void suggest_try_change(suginfo_T *su)
 ///      word splitting for now
 ///      "similar_chars()"
 ///      use "slang->sl_repsal" instead of "lp->lp_replang->sl_rep"
-static void suggest_trie_walk(suginfo_T *su, langp_T *lp, char *fword, bool soundfold)
+///
+/// @param time_limit  when to stop the search, zero for no limit
+static void suggest_trie_walk(suginfo_T *su, langp_T *lp, char *fword, bool soundfold,
+                              proftime_T time_limit)
 {
   char tword[MAXWLEN];            // good word collected so far
   trystate_T stack[MAXWLEN];
@@ -1190,18 +1213,15 @@ static void suggest_trie_walk(suginfo_T *su, langp_T *lp, char *fword, bool soun
   }
 
   // The loop may take an indefinite amount of time. Break out after some
-  // time.
-  proftime_T time_limit = 0;
-  if (spell_suggest_timeout > 0) {
-    time_limit = profile_setlimit(spell_suggest_timeout);
-  }
+  // time, keeping the suggestions found so far.
+  bool timed_out = profile_passed_limit(time_limit);
 
   // Loop to find all suggestions.  At each round we either:
   // - For the current state try one operation, advance "ts_curi",
   //   increase "depth".
   // - When a state is done go to the next, set "ts_state".
   // - When all states are tried decrease "depth".
-  while (depth >= 0 && !got_int) {
+  while (depth >= 0 && !got_int && !timed_out) {
     sp = &stack[depth];
     switch (sp->ts_state) {
     case STATE_START:
@@ -2329,9 +2349,7 @@ static void suggest_trie_walk(suginfo_T *su, langp_T *lp, char *fword, bool soun
       if (--breakcheckcount == 0) {
         os_breakcheck();
         breakcheckcount = 1000;
-        if (spell_suggest_timeout > 0 && profile_passed_limit(time_limit)) {
-          got_int = true;
-        }
+        timed_out = profile_passed_limit(time_limit);
       }
     }
   }
@@ -2702,7 +2720,8 @@ static void suggest_try_soundalike(suginfo_T *su)
 #ifdef SUGGEST_PROFILE
       prof_init();
 #endif
-      suggest_trie_walk(su, lp, salword, true);
+      suggest_trie_walk(su, lp, salword, true,
+                        suggest_lang_time_limit(su, lpi, curwin->w_s->b_langp.ga_len));
 #ifdef SUGGEST_PROFILE
       prof_report("soundalike");
 #endif
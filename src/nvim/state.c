@@ -21,11 +21,15 @@
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
 #include "nvim/os/input.h"
+#include "nvim/os/time.h"
 #include "nvim/state.h"
 #include "nvim/strings.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
 
+/// Time between polling for input while handling events, in nanoseconds.
+#define STATE_POLL_INTERVAL 1000000
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "state.c.generated.h"
 #endif
@@ -110,6 +114,7 @@ getkey:
 /// otherwise bursts of events can block break checking indefinitely.
 void state_handle_k_event(void)
 {
+  uint64_t last_poll = os_hrtime();
   while (true) {
     Event event = multiqueue_get(main_loop.events);
     if (event.handler) {
@@ -122,9 +127,17 @@ void state_handle_k_event(void)
       return;
     }
 
+    // Polling for input is a system call, which costs more than handling a
+    // cheap event like most RPC requests.  When a client sent many requests
+    // they are handled as one batch, polling only every STATE_POLL_INTERVAL.
+    // The screen is only updated when returning to the main loop.
     // TODO(bfredl): as an further micro-optimization, we could check whether
     // event.handler already checked input.
-    os_breakcheck();
+    uint64_t now = os_hrtime();
+    if (now - last_poll >= STATE_POLL_INTERVAL) {
+      os_breakcheck();
+      last_poll = now;
+    }
     if (input_available() || got_int) {
       return;
     }
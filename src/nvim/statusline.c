@@ -644,6 +644,35 @@ void redraw_custom_statusline(win_T *wp)
   entered = false;
 }
 
+/// Check whether a status line or window bar drawn from format "fmt" may
+/// change when only the cursor moved: it has a cursor position item, an
+/// expression, or is the default status line that includes the ruler.
+bool stl_uses_cursor(const char *fmt)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_PURE
+{
+  if (*fmt == NUL) {
+    return p_ru;
+  }
+  for (const char *p = fmt; (p = strchr(p, '%')) != NULL;) {
+    p++;
+    if (*p == '%') {
+      p++;
+      continue;
+    }
+    // Skip the flags and widths of "%-0N.M{item}".
+    while (*p == '-' || *p == '.' || ascii_isdigit(*p)) {
+      p++;
+    }
+    if (*p == NUL) {
+      break;
+    }
+    if (*p == '!' || vim_strchr(STL_CURSOR, (uint8_t)(*p)) != NULL) {
+      return true;
+    }
+  }
+  return false;
+}
+
 static void ui_ext_tabline_update(void)
 {
   Arena arena = ARENA_EMPTY;
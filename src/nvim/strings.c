@@ -20,6 +20,7 @@
 #include "nvim/gettext.h"
 #include "nvim/globals.h"
 #include "nvim/macros_defs.h"
+#include "nvim/map_defs.h"
 #include "nvim/math.h"
 #include "nvim/mbyte.h"
 #include "nvim/memory.h"
@@ -517,6 +518,75 @@ char *concat_str(const char *restrict str1, const char *restrict str2)
   return dest;
 }
 
+/// Header in front of an interned string, see str_intern().
+typedef struct {
+  size_t refcount;
+  char str[];
+} InternStr;
+
+/// Interned strings, keyed by InternStr.str.
+static Set(cstr_t) interned = SET_INIT;
+
+#define INTERN_HDR(s) ((InternStr *)((s) - offsetof(InternStr, str)))
+
+/// Return the interned copy of "s", adding a reference to it.
+///
+/// All interned copies of equal strings are the same pointer, so they can be
+/// compared with "==". The result must not be modified and is released with
+/// str_unintern().
+char *str_intern(const char *s)
+  FUNC_ATTR_NONNULL_ALL FUNC_ATTR_NONNULL_RET
+{
+  cstr_t *key_alloc;
+  if (set_put_ref(cstr_t, &interned, s, &key_alloc)) {
+    size_t len = strlen(s);
+    InternStr *is = xmalloc(offsetof(InternStr, str) + len + 1);
+    is->refcount = 0;
+    memcpy(is->str, s, len + 1);
+    *key_alloc = is->str;
+  }
+  char *str = (char *)(*key_alloc);
+  INTERN_HDR(str)->refcount++;
+  return str;
+}
+
+/// Add a reference to "s", which must be an interned string or NULL.
+char *str_intern_ref(char *s)
+{
+  if (s != NULL) {
+    INTERN_HDR(s)->refcount++;
+  }
+  return s;
+}
+
+/// Drop a reference to interned string "s", freeing it with the last one.
+/// Does nothing when "s" is NULL.
+void str_unintern(char *s)
+{
+  if (s == NULL) {
+    return;
+  }
+  InternStr *is = INTERN_HDR(s);
+  assert(is->refcount > 0);
+  if (--is->refcount == 0) {
+    set_del(cstr_t, &interned, s);
+    xfree(is);
+  }
+}
+
+/// Number of distinct interned strings.
+size_t str_intern_count(void)
+{
+  return set_size(&interned);
+}
+
+#ifdef EXITFREE
+void free_interned_strings(void)
+{
+  set_destroy(cstr_t, &interned);
+}
+#endif
+
 static const char *const e_printf =
   N_("E766: Insufficient arguments for printf()");
 
@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -16,6 +17,9 @@
 #include "nvim/eval.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/eval/vars.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/multiqueue.h"
+#include "nvim/event/time.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/ex_docmd.h"
 #include "nvim/fold.h"
@@ -26,6 +30,7 @@
 #include "nvim/highlight.h"
 #include "nvim/highlight_group.h"
 #include "nvim/indent_c.h"
+#include "nvim/main.h"
 #include "nvim/macros_defs.h"
 #include "nvim/mbyte.h"
 #include "nvim/memline.h"
@@ -39,6 +44,7 @@
 #include "nvim/profile.h"
 #include "nvim/regexp.h"
 #include "nvim/runtime.h"
+#include "nvim/spell.h"
 #include "nvim/strings.h"
 #include "nvim/syntax.h"
 #include "nvim/types_defs.h"
@@ -56,6 +62,8 @@ static bool did_syntax_onoff = false;
 #define SPO_LC_OFF      6       // leading context offset
 #define SPO_COUNT       7
 
+#define SP_HINT_MAX     8       // max bytes in sp_hint[]
+
 static const char e_illegal_arg[] = N_("E390: Illegal argument: %s");
 static const char e_contains_argument_not_accepted_here[]
   = N_("E395: Contains argument not accepted here");
@@ -93,6 +101,9 @@ typedef struct syn_pattern {
   char *sp_pattern;                     // regexp to match, pattern
   regprog_T *sp_prog;                   // regexp to match, program
   syn_time_T sp_time;
+  int sp_hint_len;                      // bytes in sp_hint, -1 when unknown
+  bool sp_hint_bol;                     // a match starts in column zero
+  uint8_t sp_hint[SP_HINT_MAX];         // bytes every match contains
 } synpat_T;
 
 typedef struct syn_cluster_S {
@@ -292,6 +303,23 @@ static int current_line_id = 0;            // unique number for current line
 static bool syn_time_on = false;
 #define IF_SYN_TIME(p) (p)
 
+/// Background parsing, see syntax_prefill_schedule().
+enum {
+  SYN_PREFILL_DELAY = 100,  ///< msec after a redraw before starting
+  SYN_PREFILL_SLICE = 10,   ///< msec of parsing in one go
+  SYN_PREFILL_LINES = 100,  ///< lines parsed between checking the time
+};
+
+// Last column of each byte value in line "syn_bytepos_line_id", -1 when the
+// byte is not in it.  Computed once for all the patterns tried on the line,
+// see syn_cannot_match().
+static int syn_bytepos[256];
+static int syn_bytepos_line_id = 0;
+static linenr_T syn_bytepos_lnum = 0;
+
+static TimeWatcher syn_prefill_timer;
+static bool syn_prefill_pending = false;  // syn_prefill_timer was started
+
 // Set the timeout used for syntax highlighting.
 // Use NULL to reset, no timeout.
 void syn_set_timeout(proftime_T *tm)
@@ -308,10 +336,7 @@ void syntax_start(win_T *wp, linenr_T lnum)
 {
   synstate_T *last_valid = NULL;
   synstate_T *last_min_valid = NULL;
-  synstate_T *sp;
-  synstate_T *prev = NULL;
   linenr_T first_stored;
-  int dist;
   static varnumber_T changedtick = 0;  // remember the last change ID
 
   current_sub_char = NUL;
@@ -393,7 +418,151 @@ void syntax_start(win_T *wp, linenr_T lnum)
   }
 
   // Advance from the sync point or saved state until the current line.
-  // Save some entries for syncing with later on.
+  // Closer to "lnum" states are saved more often, for scrolling back from
+  // where the view jumped to.
+  syn_parse_lines(lnum, first_stored, lnum - Rows * 2);
+
+  syn_start_line();
+}
+
+void syntax_init(void)
+{
+  time_watcher_init(&main_loop, &syn_prefill_timer, NULL);
+  // parsing uses the syntax state of the editor, not a fast event
+  syn_prefill_timer.events = multiqueue_new_child(main_loop.events);
+}
+
+void syntax_teardown(void)
+{
+  time_watcher_stop(&syn_prefill_timer);
+  multiqueue_free(syn_prefill_timer.events);
+  syn_prefill_timer.events = NULL;
+  time_watcher_close(&syn_prefill_timer, NULL);
+}
+
+/// Whether the lines of window "wp" below its top line still need to be
+/// parsed in the background.
+static bool syn_prefill_needed(win_T *wp)
+{
+  return syntax_present(wp)
+         && !wp->w_s->b_syn_error
+         && !wp->w_s->b_syn_slow
+         && !wp->w_buffer->b_mod_set  // saved states not adjusted yet
+         && MAX(wp->w_s->b_sst_prefill_lnum, wp->w_topline) < wp->w_buffer->b_ml.ml_line_count;
+}
+
+/// Start parsing the syntax of the windows in the background, from the top
+/// line of each window down to the end of the buffer.  This saves states
+/// every so many lines, so that after a jump the redraw finds one nearby
+/// instead of synchronizing far back.  Windows in other tab pages are done
+/// after the ones in the current tab page, going to such a tab page then
+/// doesn't need to synchronize.
+/// The parsing is done in short slices on the main loop, while waiting for
+/// input.  Called after the screen was updated.  The timer is stopped when no
+/// window needs parsing anymore, e.g. after ":syntax off".
+void syntax_prefill_schedule(void)
+{
+  if (syn_prefill_timer.events == NULL) {
+    return;
+  }
+  FOR_ALL_TAB_WINDOWS(tp, wp) {
+    if (syn_prefill_needed(wp)) {
+      if (!syn_prefill_pending) {
+        syn_prefill_pending = true;
+        time_watcher_start(&syn_prefill_timer, syn_prefill_cb, SYN_PREFILL_DELAY, 0);
+      }
+      return;
+    }
+  }
+  if (syn_prefill_pending) {
+    syn_prefill_pending = false;
+    time_watcher_stop(&syn_prefill_timer);
+  }
+}
+
+static void syn_prefill_cb(TimeWatcher *tw, void *data)
+{
+  syn_prefill_pending = false;
+  proftime_T tm = profile_setlimit(SYN_PREFILL_SLICE);
+  // A pattern that is too slow makes syntax highlighting stop as it would
+  // when redrawing.
+  proftime_T syntax_tm = profile_setlimit(p_rdt);
+  syn_set_timeout(&syntax_tm);
+
+  bool more = syn_prefill_tab(curtab, tm);
+  FOR_ALL_TABS(tp) {
+    if (tp != curtab) {
+      more |= syn_prefill_tab(tp, tm);
+    }
+  }
+  syn_set_timeout(NULL);
+
+  if (more) {
+    syn_prefill_pending = true;
+    time_watcher_start(&syn_prefill_timer, syn_prefill_cb, SYN_PREFILL_SLICE, 0);
+  }
+}
+
+/// Parse lines of the windows in tab page "tp" until time limit "tm" has
+/// passed or a key was typed.
+///
+/// @return  true if a window still needs to be parsed.
+static bool syn_prefill_tab(tabpage_T *tp, proftime_T tm)
+{
+  bool more = false;
+  FOR_ALL_WINDOWS_IN_TAB(wp, tp) {
+    if (!syn_prefill_needed(wp)) {
+      continue;
+    }
+    if (profile_passed_limit(tm) || input_available()) {
+      return true;
+    }
+    syn_prefill_win(wp, tm);
+    more |= syn_prefill_needed(wp);
+  }
+  return more;
+}
+
+/// Parse lines of window "wp" where the previous slice stopped, or from the
+/// top line of the window, until time limit "tm" has passed or a key was
+/// typed.
+static void syn_prefill_win(win_T *wp, proftime_T tm)
+{
+  linenr_T lnum = MAX(wp->w_s->b_sst_prefill_lnum, wp->w_topline);
+  syntax_start(wp, lnum);  // find or synchronize the state for "lnum"
+  if (syn_block->b_sst_array == NULL) {
+    // No states can be saved, don't try again until the text changes.
+    syn_block->b_sst_prefill_lnum = syn_buf->b_ml.ml_line_count;
+    return;
+  }
+
+  linenr_T line_count = syn_buf->b_ml.ml_line_count;
+  linenr_T start_lnum = current_lnum;
+  while (current_lnum < line_count && !got_int && !syn_block->b_syn_slow) {
+    lnum = MIN(current_lnum + SYN_PREFILL_LINES, line_count);
+    syn_parse_lines(lnum, current_lnum, MAXLNUM);
+    if (profile_passed_limit(tm) || input_available()) {
+      break;
+    }
+  }
+  if (!got_int) {
+    syn_block->b_sst_prefill_lnum = current_lnum;
+    g_stats.syntax_prefill += current_lnum - start_lnum;
+  }
+
+  // Leave nothing for syntax_start() to continue with.
+  invalidate_current_state();
+}
+
+/// Parse from the current state until the start of line "lnum".  Save some
+/// entries for syncing with later on: every so many lines, and every SST_DIST
+/// lines from "near_lnum".  States are only saved from "first_stored".
+static void syn_parse_lines(linenr_T lnum, linenr_T first_stored, linenr_T near_lnum)
+{
+  synstate_T *sp;
+  synstate_T *prev = NULL;
+  int dist;
+
   if (syn_block->b_sst_len <= Rows) {
     dist = 999999;
   } else {
@@ -443,7 +612,9 @@ void syntax_start(win_T *wp, linenr_T lnum)
                  // where we start parsing, or some distance from the previously
                  // saved state.  But only when parsed at least 'minlines'.
                  || current_lnum == lnum
-                 || current_lnum >= prev->sst_lnum + dist) {
+                 || current_lnum >= prev->sst_lnum + dist
+                 || (current_lnum >= near_lnum
+                     && current_lnum >= prev->sst_lnum + SST_DIST)) {
         prev = store_current_state();
       }
     }
@@ -457,7 +628,6 @@ void syntax_start(win_T *wp, linenr_T lnum)
     }
   }
 
-  syn_start_line();
 }
 
 // We cannot simply discard growarrays full of state_items or buf_states; we
@@ -871,7 +1041,11 @@ static void syn_update_ends(bool startofline)
 // entries will be used e.g., when scrolling backwards.  The distance between
 // entries depends on the number of lines in the buffer.  For small buffers
 // the distance is fixed at SST_DIST, for large buffers there is a fixed
-// number of entries SST_MAX_ENTRIES, and the distance is computed.
+// number of entries 'synmaxstates', and the distance is computed.  In the
+// lines parsed just before a displayed line entries are stored at SST_DIST,
+// so that the regions that were viewed last have more of them.  When the
+// array is full, syn_stack_cleanup() removes entries of the oldest display
+// tick first, which thins out the regions that were not viewed for a while.
 
 static void syn_stack_free_block(synblock_T *block)
 {
@@ -885,6 +1059,7 @@ static void syn_stack_free_block(synblock_T *block)
   XFREE_CLEAR(block->b_sst_array);
   block->b_sst_first = NULL;
   block->b_sst_len = 0;
+  block->b_sst_prefill_lnum = 0;
 }
 // Free b_sst_array[] for buffer "buf".
 // Used when syntax items changed to force resyncing everywhere.
@@ -906,11 +1081,12 @@ void syn_stack_free_all(synblock_T *block)
 // Also used to allocate b_sst_array[] for the first time.
 static void syn_stack_alloc(void)
 {
+  const int max_entries = (int)MIN(MAX(p_sst, SST_MIN_ENTRIES), INT_MAX / 2);
   int len = syn_buf->b_ml.ml_line_count / SST_DIST + Rows * 2;
   if (len < SST_MIN_ENTRIES) {
     len = SST_MIN_ENTRIES;
-  } else if (len > SST_MAX_ENTRIES) {
-    len = SST_MAX_ENTRIES;
+  } else if (len > max_entries) {
+    len = max_entries;
   }
   if (syn_block->b_sst_len > len * 2 || syn_block->b_sst_len < len) {
     // Allocate 50% too much, to avoid reallocating too often.
@@ -918,8 +1094,8 @@ static void syn_stack_alloc(void)
     len = (len + len / 2) / SST_DIST + Rows * 2;
     if (len < SST_MIN_ENTRIES) {
       len = SST_MIN_ENTRIES;
-    } else if (len > SST_MAX_ENTRIES) {
-      len = SST_MAX_ENTRIES;
+    } else if (len > max_entries) {
+      len = max_entries;
     }
 
     if (syn_block->b_sst_array != NULL) {
@@ -967,6 +1143,20 @@ static void syn_stack_alloc(void)
   }
 }
 
+/// @return bytes allocated for the syntax state stack of "buf".
+size_t syn_stack_bytes(buf_T *buf)
+  FUNC_ATTR_NONNULL_ALL
+{
+  synblock_T *block = &buf->b_s;
+  size_t size = (size_t)block->b_sst_len * sizeof(synstate_T);
+  for (synstate_T *p = block->b_sst_first; p != NULL; p = p->sst_next) {
+    if (p->sst_stacksize > SST_FIX_STATES) {
+      size += (size_t)p->sst_union.sst_ga.ga_maxlen * sizeof(bufstate_T);
+    }
+  }
+  return size;
+}
+
 // Check for changes in a buffer to affect stored syntax states.  Uses the
 // b_mod_* fields.
 // Called from update_screen(), before screen is being updated, once for each
@@ -985,6 +1175,9 @@ void syn_stack_apply_changes(buf_T *buf)
 static void syn_stack_apply_changes_block(synblock_T *block, buf_T *buf)
 {
   synstate_T *prev = NULL;
+  if (block->b_sst_prefill_lnum > buf->b_mod_top) {
+    block->b_sst_prefill_lnum = buf->b_mod_top;
+  }
   for (synstate_T *p = block->b_sst_first; p != NULL;) {
     if (p->sst_lnum + block->b_syn_sync_linebreaks > buf->b_mod_top) {
       linenr_T n = p->sst_lnum + buf->b_mod_xlines;
@@ -1665,6 +1858,11 @@ static int syn_current_attr(const bool syncing, const bool displaying, bool *con
                 lc_col = 0;
               }
 
+              if (syn_cannot_match(spp, lc_col)) {
+                spp->sp_startcol = MAXCOL;
+                continue;
+              }
+
               regmatch.rmm_ic = spp->sp_ic;
               regmatch.regprog = spp->sp_prog;
               int r = syn_regexec(&regmatch, current_lnum, lc_col,
@@ -2661,6 +2859,65 @@ static char *syn_getcurline(void)
   return ml_get_buf(syn_buf, current_lnum);
 }
 
+/// Remember what every match of pattern "spp" has, for syn_cannot_match().
+static void syn_pattern_hints(synpat_T *spp)
+{
+  bool bol;
+  int start;
+  const char *must;
+  spp->sp_hint_len = -1;
+  if (!vim_regprog_hints(spp->sp_prog, spp->sp_ic, &bol, &start, &must)) {
+    return;
+  }
+
+  int len = 0;
+  if (start != NUL) {
+    char buf[MB_MAXCHAR + 1];
+    utf_char2bytes(start, buf);
+    spp->sp_hint[len++] = (uint8_t)buf[0];
+  }
+  for (const char *p = must; p != NULL && *p != NUL && len < SP_HINT_MAX; p++) {
+    if (memchr(spp->sp_hint, (uint8_t)(*p), (size_t)len) == NULL) {
+      spp->sp_hint[len++] = (uint8_t)(*p);
+    }
+  }
+  spp->sp_hint_bol = bol;
+  spp->sp_hint_len = len;
+}
+
+/// Check quickly that pattern "spp" can't match in the current line from
+/// column "col", because a byte every match has is not there.  This saves
+/// running the regexp for most of the patterns of a big syntax file.
+static bool syn_cannot_match(const synpat_T *spp, colnr_T col)
+{
+  if (spp->sp_hint_len < 0) {
+    return false;
+  }
+  if (spp->sp_hint_bol && col > 0) {
+    return true;
+  }
+  if (spp->sp_hint_len == 0) {
+    return false;
+  }
+
+  if (syn_bytepos_line_id != current_line_id || syn_bytepos_lnum != current_lnum) {
+    const uint8_t *line = (const uint8_t *)syn_getcurline();
+    memset(syn_bytepos, -1, sizeof(syn_bytepos));
+    for (int i = 0; line[i] != NUL; i++) {
+      syn_bytepos[line[i]] = i;
+    }
+    syn_bytepos_line_id = current_line_id;
+    syn_bytepos_lnum = current_lnum;
+  }
+  for (int i = 0; i < spp->sp_hint_len; i++) {
+    if (syn_bytepos[spp->sp_hint[i]] < col) {
+      g_stats.syntax_skip++;
+      return true;
+    }
+  }
+  return false;
+}
+
 // Call vim_regexec() to find a match with "rmp" in "syn_buf".
 // Returns true when there is a match.
 static int syn_regexec(regmmatch_T *rmp, linenr_T lnum, colnr_T col, syn_time_T *st)
@@ -3006,6 +3263,7 @@ void reset_synblock(win_T *wp)
 {
   if (wp->w_s != &wp->w_buffer->b_s) {
     syntax_clear(wp->w_s);
+    spell_cache_free(wp->w_s);
     xfree(wp->w_s);
     wp->w_s = &wp->w_buffer->b_s;
   }
@@ -4747,6 +5005,7 @@ static char *get_syn_pattern(char *arg, synpat_T *ci)
   }
   ci->sp_ic = curwin->w_s->b_syn_ic;
   syn_clear_time(&ci->sp_time);
+  syn_pattern_hints(ci);
 
   // Check for a match, highlight or region offset.
   end++;
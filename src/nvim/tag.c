@@ -183,6 +183,25 @@ typedef struct {
   hashtab_T ht_match[MT_COUNT];  ///< stores matches by key
 } findtags_state_T;
 
+/// A tags file kept in memory, with its tag lines sorted by name.
+typedef struct {
+  char *fname;        ///< name of the tags file
+  int64_t mtime;      ///< modification time when it was read
+  int64_t mtime_ns;
+  uint64_t size;      ///< size when it was read
+  char *data;         ///< contents of the file
+  size_t len;         ///< number of bytes in "data"
+  size_t *lines;      ///< offsets of the tag lines, sorted by tag_strnicmp()
+  size_t nlines;
+  int sorted;         ///< !_TAG_FILE_SORTED value
+  bool has_encoding;  ///< has !_TAG_FILE_ENCODING, can't use "lines"
+} tagindex_T;
+
+#define TAGINDEX_MAX 4  // number of tags files kept in memory
+
+// Tags files read by tagindex_get(), most recently used first.
+static tagindex_T *tagindex_cache[TAGINDEX_MAX];
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "tag.c.generated.h"
 #endif
@@ -2163,6 +2182,275 @@ line_read_in:
   }  // forever
 }
 
+static void tagindex_free(tagindex_T *ti)
+{
+  if (ti == NULL) {
+    return;
+  }
+  xfree(ti->fname);
+  xfree(ti->data);
+  xfree(ti->lines);
+  xfree(ti);
+}
+
+static const char *tagindex_sort_data;  // data of the file tagindex_cmp() sorts
+
+/// Compare the tag names of two lines for sorting, like tag_strnicmp().
+/// Lines with the same name are kept in file order.
+static int tagindex_cmp(const void *a, const void *b)
+{
+  const size_t off1 = *(const size_t *)a;
+  const size_t off2 = *(const size_t *)b;
+  const char *s1 = tagindex_sort_data + off1;
+  const char *s2 = tagindex_sort_data + off2;
+  while (true) {
+    int c1 = (*s1 == TAB || *s1 == '\n') ? NUL : TOUPPER_ASC((uint8_t)(*s1));
+    int c2 = (*s2 == TAB || *s2 == '\n') ? NUL : TOUPPER_ASC((uint8_t)(*s2));
+    if (c1 != c2) {
+      return c1 - c2;
+    }
+    if (c1 == NUL) {
+      return off1 < off2 ? -1 : off1 > off2;
+    }
+    s1++;
+    s2++;
+  }
+}
+
+/// Read the tags file "fname" and sort its lines by tag name.
+static tagindex_T *tagindex_read(const char *fname, const FileInfo *info)
+{
+  FILE *fp = os_fopen(fname, "r");
+  if (fp == NULL) {
+    return NULL;
+  }
+  tagindex_T *ti = xcalloc(1, sizeof(tagindex_T));
+  ti->fname = xstrdup(fname);
+  ti->mtime = info->stat.st_mtim.tv_sec;
+  ti->mtime_ns = info->stat.st_mtim.tv_nsec;
+  ti->size = info->stat.st_size;
+  // the size can be smaller when reading in text mode, add a NUL at the end
+  ti->data = xmalloc((size_t)ti->size + 1);
+  ti->len = fread(ti->data, 1, (size_t)ti->size, fp);
+  ti->data[ti->len] = NUL;
+  fclose(fp);
+
+  size_t nlines = 0;
+  for (const char *p = ti->data; (p = memchr(p, '\n', (size_t)(ti->data + ti->len - p))) != NULL;
+       p++) {
+    nlines++;
+  }
+  ti->lines = xmalloc((nlines + 1) * sizeof(size_t));
+
+  // The header ends when a line sorts below "!_TAG_", like in
+  // findtags_start_state_handler().
+  bool in_header = true;
+  char *end = ti->data + ti->len;
+  for (char *p = ti->data; p < end;) {
+    char *eol = memchr(p, '\n', (size_t)(end - p));
+    if (eol == NULL) {
+      eol = end;
+    }
+    const char *q = p;
+    while (q < eol && ascii_iswhite(*q)) {
+      q++;
+    }
+    if (q == eol || (*q == '\r' && q + 1 == eol)) {
+      // skip blank lines
+    } else if (in_header
+               && (strncmp(p, "!_TAG_", 6) <= 0 || (p[0] == '!' && ASCII_ISLOWER(p[1])))) {
+      if (strncmp(p, "!_TAG_FILE_SORTED\t", 18) == 0) {
+        ti->sorted = (uint8_t)p[18];
+      } else if (strncmp(p, "!_TAG_FILE_ENCODING\t", 20) == 0) {
+        ti->has_encoding = true;
+      }
+      if (strncmp(p, "!_TAG_", 6) != 0) {
+        // not a header line, see findtags_hdr_parse()
+        ti->lines[ti->nlines++] = (size_t)(p - ti->data);
+      }
+    } else {
+      in_header = false;
+      ti->lines[ti->nlines++] = (size_t)(p - ti->data);
+    }
+    p = eol + 1;
+  }
+
+  tagindex_sort_data = ti->data;
+  qsort(ti->lines, ti->nlines, sizeof(size_t), tagindex_cmp);
+  tagindex_sort_data = NULL;
+  return ti;
+}
+
+/// Get the tags file "fname" from the cache, reading it when it was not read
+/// yet or changed since then.
+///
+/// @return  NULL when the file can't be read.
+static tagindex_T *tagindex_get(const char *fname)
+{
+  FileInfo info;
+  if (!os_fileinfo(fname, &info)) {
+    return NULL;
+  }
+  tagindex_T *ti = NULL;
+  for (int i = 0; i < TAGINDEX_MAX && tagindex_cache[i] != NULL; i++) {
+    if (strcmp(tagindex_cache[i]->fname, fname) == 0) {
+      // take it out, it is put in front below
+      ti = tagindex_cache[i];
+      memmove(tagindex_cache + i, tagindex_cache + i + 1,
+              (size_t)(TAGINDEX_MAX - 1 - i) * sizeof(*tagindex_cache));
+      tagindex_cache[TAGINDEX_MAX - 1] = NULL;
+      break;
+    }
+  }
+  if (ti != NULL
+      && (ti->mtime != info.stat.st_mtim.tv_sec || ti->mtime_ns != info.stat.st_mtim.tv_nsec
+          || ti->size != info.stat.st_size)) {
+    tagindex_free(ti);
+    ti = NULL;
+  }
+  if (ti == NULL && (ti = tagindex_read(fname, &info)) == NULL) {
+    return NULL;
+  }
+  // drop the least recently used file
+  tagindex_free(tagindex_cache[TAGINDEX_MAX - 1]);
+  memmove(tagindex_cache + 1, tagindex_cache, (TAGINDEX_MAX - 1) * sizeof(*tagindex_cache));
+  tagindex_cache[0] = ti;
+  return ti;
+}
+
+/// Compare the tag name of the line at "line" with the first "len" bytes of
+/// "head", ignoring case like tag_strnicmp().  Returns zero when the name
+/// starts with "head".
+static int tagindex_prefix_cmp(const char *line, const char *head, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    int c1 = (line[i] == TAB || line[i] == '\n' || line[i] == NUL)
+             ? NUL : TOUPPER_ASC((uint8_t)line[i]);
+    int c2 = TOUPPER_ASC((uint8_t)head[i]);
+    if (c1 != c2) {
+      return c1 - c2;
+    }
+  }
+  return 0;
+}
+
+/// Whether the search in "st" can use the tags file index: the quick check in
+/// findtags_parse_line() must only accept tags that start with the pattern
+/// head, ignoring case the ASCII way.
+static bool findtags_can_use_index(findtags_state_T *st)
+{
+  if (st->orgpat->headlen == 0 || p_tl != 0) {
+    return false;
+  }
+  for (int i = 0; i < st->orgpat->headlen; i++) {
+    if ((uint8_t)st->orgpat->head[i] >= 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Search for tags in the tags file "ti" kept in memory.  Only the lines with
+/// a tag name that starts with the pattern head are checked, in file order,
+/// the same way as a linear search does.
+static void findtags_in_index(findtags_state_T *st, tagindex_T *ti, findtags_match_args_T *margs,
+                              char *buf_ffname)
+{
+  const size_t headlen = (size_t)st->orgpat->headlen;
+  hash_T hash = 0;
+
+  // Same as findtags_start_state_handler() for a case-fold sorted file.
+  if (!st->linear && ti->sorted == '2') {
+    st->orgpat->regmatch.rm_ic = (p_ic || !(st->flags & TAG_NOIC));
+  }
+
+  // binary search for the first and the last line starting with the head
+  size_t lo = 0;
+  size_t hi = ti->nlines;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (tagindex_prefix_cmp(ti->data + ti->lines[mid], st->orgpat->head, headlen) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  size_t first = lo;
+  hi = ti->nlines;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (tagindex_prefix_cmp(ti->data + ti->lines[mid], st->orgpat->head, headlen) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (first == lo) {
+    return;
+  }
+
+  // check the lines in file order, so that matches are found in the same
+  // order as with a linear search
+  const size_t count = lo - first;
+  size_t *offsets = xmemdup(ti->lines + first, count * sizeof(size_t));
+  qsort(offsets, count, sizeof(size_t), tagindex_offset_cmp);
+
+  st->state = TS_LINEAR;
+  for (size_t i = 0; i < count; i++) {
+    fast_breakcheck();
+    if ((st->flags & TAG_INS_COMP)) {
+      ins_compl_check_keys(30, false);
+    }
+    if (got_int || ins_compl_interrupted()) {
+      st->stop_searching = true;
+      break;
+    }
+    if (st->mincount == TAG_MANY && st->match_count >= TAG_MANY) {
+      st->stop_searching = true;
+      break;
+    }
+
+    // copy the line with its line break, as vim_fgets() returns it
+    const char *line = ti->data + offsets[i];
+    const char *eol = strchr(line, '\n');
+    size_t len = eol != NULL ? (size_t)(eol - line) + 1 : strlen(line);
+    if ((int)len + 1 > st->lbuf_size) {
+      st->lbuf_size = (int)len + 1;
+      xfree(st->lbuf);
+      st->lbuf = xmalloc((size_t)st->lbuf_size);
+    }
+    memcpy(st->lbuf, line, len);
+    st->lbuf[len] = NUL;
+
+    do {
+      tagptrs_T tagp;
+      int retval = (int)findtags_parse_line(st, &tagp, margs, NULL);
+      if (retval == TAG_MATCH_NEXT) {
+        break;
+      }
+      if (retval == TAG_MATCH_FAIL) {
+        semsg(_("E431: Format error in tags file \"%s\""), st->tag_fname);
+        semsg(_("Before byte %" PRId64), (int64_t)(offsets[i] + len));
+        st->stop_searching = true;
+        xfree(offsets);
+        return;
+      }
+      if (findtags_match_tag(st, &tagp, margs)) {
+        findtags_add_match(st, &tagp, margs, buf_ffname, &hash);
+      }
+      // for 'showfulltag' the same line is used again
+    } while (st->get_searchpat);
+  }
+  xfree(offsets);
+}
+
+static int tagindex_offset_cmp(const void *a, const void *b)
+{
+  const size_t off1 = *(const size_t *)a;
+  const size_t off2 = *(const size_t *)b;
+  return off1 < off2 ? -1 : off1 > off2;
+}
+
 /// Search for tags matching "st->orgpat.pat" in the "st->tag_fname" tags file.
 /// Information needed to search for the tags is in the "st" state structure.
 /// The matching tags are returned in "st". If an error is encountered, then
@@ -2184,9 +2472,15 @@ static void findtags_in_file(findtags_state_T *st, int flags, char *buf_ffname)
     }
   }
 
-  st->fp = os_fopen(st->tag_fname, "r");
-  if (st->fp == NULL) {
-    return;
+  tagindex_T *ti = findtags_can_use_index(st) ? tagindex_get(st->tag_fname) : NULL;
+  if (ti != NULL && ti->has_encoding) {
+    ti = NULL;
+  }
+  if (ti == NULL) {
+    st->fp = os_fopen(st->tag_fname, "r");
+    if (st->fp == NULL) {
+      return;
+    }
   }
 
   if (p_verbose >= 5) {
@@ -2196,10 +2490,14 @@ static void findtags_in_file(findtags_state_T *st, int flags, char *buf_ffname)
   }
   st->did_open = true;   // remember that we found at least one file
 
-  st->state = TS_START;  // we're at the start of the file
+  if (ti != NULL) {
+    findtags_in_index(st, ti, &margs, buf_ffname);
+  } else {
+    st->state = TS_START;  // we're at the start of the file
 
-  // Read and parse the lines in the file one by one
-  findtags_get_all_tags(st, &margs, buf_ffname);
+    // Read and parse the lines in the file one by one
+    findtags_get_all_tags(st, &margs, buf_ffname);
+  }
 
   if (st->fp != NULL) {
     fclose(st->fp);
@@ -2473,6 +2771,10 @@ static bool found_tagfile_cb(int num_fnames, char **fnames, bool all, void *cook
 void free_tag_stuff(void)
 {
   ga_clear_strings(&tag_fnames);
+  for (int i = 0; i < TAGINDEX_MAX; i++) {
+    tagindex_free(tagindex_cache[i]);
+    tagindex_cache[i] = NULL;
+  }
   do_tag(NULL, DT_FREE, 0, 0, 0);
   tag_freematch();
 
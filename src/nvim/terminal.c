@@ -103,9 +103,20 @@ typedef struct terminal_state {
 // Delay for refreshing the terminal buffer after receiving updates from
 // libvterm. Improves performance when receiving large bursts of data.
 #define REFRESH_DELAY 10
+// Delay used while output floods the terminal: the last refresh scrolled at
+// least a screenful.  Fewer intermediate frames are drawn.
+#define REFRESH_DELAY_FLOOD 50
+
+// Output of a terminal job is collected for 'termcoalesce' milliseconds, or
+// until this many bytes, before it is passed to libvterm.
+#define COALESCE_MAX 0x4000
 
 static TimeWatcher refresh_timer;
 static bool refresh_pending = false;
+static bool refresh_flooding = false;
+
+static TimeWatcher coalesce_timer;
+static bool coalesce_pending = false;
 
 typedef struct {
   size_t cols;
@@ -121,7 +132,8 @@ struct terminal {
   //  - receive data from libvterm as a result of key presses.
   char textbuf[0x1fff];
 
-  ScrollbackLine **sb_buffer;       // Scrollback storage.
+  ScrollbackLine **sb_buffer;       // Scrollback storage, a ring, use sb_line().
+  size_t sb_start;                  // Index of the newest line in sb_buffer.
   size_t sb_current;                // Lines stored in sb_buffer.
   size_t sb_size;                   // Capacity of sb_buffer.
   // "virtual index" that points to the first sb_buffer row that we need to
@@ -152,6 +164,7 @@ struct terminal {
     bool visible;
   } cursor;
   bool pending_resize;              // pending width/height
+  StringBuilder pending_output;     // job output not passed to libvterm yet
 
   bool color_set[16];
 
@@ -169,23 +182,30 @@ static VTermScreenCallbacks vterm_screen_callbacks = {
 };
 
 static Set(ptr_t) invalidated_terminals = SET_INIT;
+static Set(ptr_t) coalescing_terminals = SET_INIT;
 
 void terminal_init(void)
 {
   time_watcher_init(&main_loop, &refresh_timer, NULL);
   // refresh_timer_cb will redraw the screen which can call vimscript
   refresh_timer.events = multiqueue_new_child(main_loop.events);
+  time_watcher_init(&main_loop, &coalesce_timer, NULL);
+  coalesce_timer.events = refresh_timer.events;
 }
 
 void terminal_teardown(void)
 {
   time_watcher_stop(&refresh_timer);
+  time_watcher_stop(&coalesce_timer);
   multiqueue_free(refresh_timer.events);
   time_watcher_close(&refresh_timer, NULL);
+  time_watcher_close(&coalesce_timer, NULL);
   set_destroy(ptr_t, &invalidated_terminals);
+  set_destroy(ptr_t, &coalescing_terminals);
   // terminal_destroy might be called after terminal_teardown is invoked
   // make sure it is in an empty, valid state
   invalidated_terminals = (Set(ptr_t)) SET_INIT;
+  coalescing_terminals = (Set(ptr_t)) SET_INIT;
 }
 
 static void term_output_callback(const char *s, size_t len, void *user_data)
@@ -310,6 +330,9 @@ void terminal_close(Terminal **termpp, int status)
     return;
   }
 
+  // the output comes before the exit message
+  terminal_flush_output(term);
+
 #ifdef EXITFREE
   if (entered_free_all_mem) {
     // If called from close_buffer() inside free_all_mem(), the main loop has
@@ -671,8 +694,10 @@ void terminal_destroy(Terminal **termpp)
       unblock_autocmds();
       set_del(ptr_t, &invalidated_terminals, term);
     }
+    set_del(ptr_t, &coalescing_terminals, term);
+    kv_destroy(term->pending_output);
     for (size_t i = 0; i < term->sb_current; i++) {
-      xfree(term->sb_buffer[i]);
+      xfree(*sb_line(term, i));
     }
     xfree(term->sb_buffer);
     xfree(term->title);
@@ -782,6 +807,54 @@ static void terminal_send_key(Terminal *term, int c)
   }
 }
 
+/// Receives output of the job of a terminal.  Output is collected for up to
+/// 'termcoalesce' milliseconds and then passed to libvterm at once, so that a
+/// program doing many tiny writes causes fewer updates of the screen state.
+void terminal_receive_output(Terminal *term, const char *data, size_t len)
+{
+  if (p_tco <= 0 && kv_size(term->pending_output) == 0) {
+    terminal_receive(term, data, len);
+    return;
+  }
+
+  kv_concat_len(term->pending_output, data, len);
+  if (p_tco <= 0 || kv_size(term->pending_output) >= COALESCE_MAX) {
+    terminal_flush_output(term);
+    return;
+  }
+
+  set_put(ptr_t, &coalescing_terminals, term);
+  if (!coalesce_pending) {
+    time_watcher_start(&coalesce_timer, coalesce_timer_cb, (uint64_t)p_tco, 0);
+    coalesce_pending = true;
+  }
+}
+
+/// Passes the collected output of the job of terminal "term" to libvterm.
+static void terminal_flush_output(Terminal *term)
+{
+  set_del(ptr_t, &coalescing_terminals, term);
+  if (kv_size(term->pending_output) > 0) {
+    size_t len = kv_size(term->pending_output);
+    kv_size(term->pending_output) = 0;
+    terminal_receive(term, term->pending_output.items, len);
+  }
+}
+
+static void coalesce_timer_cb(TimeWatcher *watcher, void *data)
+{
+  coalesce_pending = false;
+  Terminal *term;
+  set_foreach(&coalescing_terminals, term, {
+    if (kv_size(term->pending_output) > 0) {
+      size_t len = kv_size(term->pending_output);
+      kv_size(term->pending_output) = 0;
+      terminal_receive(term, term->pending_output.items, len);
+    }
+  });
+  set_clear(ptr_t, &coalescing_terminals);
+}
+
 void terminal_receive(Terminal *term, const char *data, size_t len)
 {
   if (!data) {
@@ -896,6 +969,17 @@ void terminal_get_line_attributes(Terminal *term, win_T *wp, int linenr, int *te
   }
 }
 
+/// @return bytes allocated for the scrollback of "term".
+size_t terminal_scrollback_bytes(Terminal *term)
+  FUNC_ATTR_NONNULL_ALL
+{
+  size_t size = term->sb_size * sizeof(ScrollbackLine *);
+  for (size_t i = 0; i < term->sb_current; i++) {
+    size += sizeof(ScrollbackLine) + (*sb_line(term, i))->cols * sizeof(VTermScreenCell);
+  }
+  return size;
+}
+
 Buffer terminal_buf(const Terminal *term)
 {
   return term->buf_handle;
@@ -1019,31 +1103,24 @@ static int term_sb_push(int cols, const VTermScreenCell *cells, void *data)
 
   // copy vterm cells into sb_buffer
   size_t c = (size_t)cols;
-  ScrollbackLine *sbrow = NULL;
+  ScrollbackLine *sbrow;
+  // The new row goes in the slot before the newest one.  When the ring is
+  // full that is the slot of the oldest row.
+  term->sb_start = (term->sb_start + term->sb_size - 1) % term->sb_size;
   if (term->sb_current == term->sb_size) {
-    if (term->sb_buffer[term->sb_current - 1]->cols == c) {
-      // Recycle old row if it's the right size
-      sbrow = term->sb_buffer[term->sb_current - 1];
-    } else {
-      xfree(term->sb_buffer[term->sb_current - 1]);
+    // Recycle the old row, it only needs to be resized after the width of
+    // the terminal changed.
+    sbrow = term->sb_buffer[term->sb_start];
+    if (sbrow->cols != c) {
+      sbrow = xrealloc(sbrow, sizeof(ScrollbackLine) + c * sizeof(sbrow->cells[0]));
+      sbrow->cols = c;
     }
-
-    // Make room at the start by shifting to the right.
-    memmove(term->sb_buffer + 1, term->sb_buffer,
-            sizeof(term->sb_buffer[0]) * (term->sb_current - 1));
-  } else if (term->sb_current > 0) {
-    // Make room at the start by shifting to the right.
-    memmove(term->sb_buffer + 1, term->sb_buffer,
-            sizeof(term->sb_buffer[0]) * term->sb_current);
-  }
-
-  if (!sbrow) {
+  } else {
     sbrow = xmalloc(sizeof(ScrollbackLine) + c * sizeof(sbrow->cells[0]));
     sbrow->cols = c;
   }
 
-  // New row is added at the start of the storage buffer.
-  term->sb_buffer[0] = sbrow;
+  term->sb_buffer[term->sb_start] = sbrow;
   if (term->sb_current < term->sb_size) {
     term->sb_current++;
   }
@@ -1075,11 +1152,10 @@ static int term_sb_pop(int cols, VTermScreenCell *cells, void *data)
     term->sb_pending--;
   }
 
-  ScrollbackLine *sbrow = term->sb_buffer[0];
+  ScrollbackLine *sbrow = term->sb_buffer[term->sb_start];
   term->sb_current--;
-  // Forget the "popped" row by shifting the rest onto it.
-  memmove(term->sb_buffer, term->sb_buffer + 1,
-          sizeof(term->sb_buffer[0]) * (term->sb_current));
+  // Forget the "popped" row, the next one becomes the newest.
+  term->sb_start = (term->sb_start + 1) % term->sb_size;
 
   size_t cols_to_copy = (size_t)cols;
   if (cols_to_copy > sbrow->cols) {
@@ -1566,7 +1642,7 @@ static void fetch_row(Terminal *term, int row, int end_col)
 static bool fetch_cell(Terminal *term, int row, int col, VTermScreenCell *cell)
 {
   if (row < 0) {
-    ScrollbackLine *sbrow = term->sb_buffer[-row - 1];
+    ScrollbackLine *sbrow = *sb_line(term, (size_t)(-row - 1));
     if ((size_t)col < sbrow->cols) {
       *cell = sbrow->cells[col];
     } else {
@@ -1584,6 +1660,12 @@ static bool fetch_cell(Terminal *term, int row, int col, VTermScreenCell *cell)
   return true;
 }
 
+/// Get the scrollback row "idx", 0 being the newest one.
+static ScrollbackLine **sb_line(Terminal *term, size_t idx)
+{
+  return &term->sb_buffer[(term->sb_start + idx) % term->sb_size];
+}
+
 // queue a terminal instance for refresh
 static void invalidate_terminal(Terminal *term, int start_row, int end_row)
 {
@@ -1594,7 +1676,8 @@ static void invalidate_terminal(Terminal *term, int start_row, int end_row)
 
   set_put(ptr_t, &invalidated_terminals, term);
   if (!refresh_pending) {
-    time_watcher_start(&refresh_timer, refresh_timer_cb, REFRESH_DELAY, 0);
+    time_watcher_start(&refresh_timer, refresh_timer_cb,
+                       refresh_flooding ? REFRESH_DELAY_FLOOD : REFRESH_DELAY, 0);
     refresh_pending = true;
   }
 }
@@ -1616,7 +1699,9 @@ static void refresh_terminal(Terminal *term)
   aco_save_T aco;
   aucmd_prepbuf(&aco, buf);
   refresh_size(term, buf);
-  refresh_scrollback(term, buf);
+  if (refresh_scrollback(term, buf)) {
+    refresh_flooding = true;
+  }
   refresh_screen(term, buf);
   aucmd_restbuf(&aco);
 
@@ -1631,6 +1716,7 @@ static void refresh_timer_cb(TimeWatcher *watcher, void *data)
   if (exiting) {  // Cannot redraw (requires event loop) during teardown/exit.
     return;
   }
+  refresh_flooding = false;
   Terminal *term;
   void *stub; (void)(stub);
   // don't process autocommands while updating terminal buffers
@@ -1682,62 +1768,87 @@ static void adjust_scrollback(Terminal *term, buf_T *buf)
     for (size_t i = 0; i < diff; i++) {
       ml_delete(1, false);
       term->sb_current--;
-      xfree(term->sb_buffer[term->sb_current]);
+      xfree(*sb_line(term, term->sb_current));
     }
     deleted_lines(1, (linenr_T)diff);
   }
 
-  // Resize the scrollback storage.
-  size_t sb_region = sizeof(ScrollbackLine *) * scbk;
+  // Resize the scrollback storage, the rows are moved to the start.
   if (scbk != term->sb_size) {
-    term->sb_buffer = xrealloc(term->sb_buffer, sb_region);
+    ScrollbackLine **sb_buffer = xmalloc(sizeof(ScrollbackLine *) * scbk);
+    for (size_t i = 0; i < term->sb_current; i++) {
+      sb_buffer[i] = *sb_line(term, i);
+    }
+    xfree(term->sb_buffer);
+    term->sb_buffer = sb_buffer;
+    term->sb_start = 0;
   }
 
   term->sb_size = scbk;
 }
 
 // Refresh the scrollback of an invalidated terminal.
-static void refresh_scrollback(Terminal *term, buf_T *buf)
+// Returns true when at least a screenful of rows was scrolled.
+static bool refresh_scrollback(Terminal *term, buf_T *buf)
 {
   int width, height;
   vterm_get_size(term->vt, &height, &width);
+  const bool flooded = term->sb_pending >= height;
 
   // May still have pending scrollback after increase in terminal height if the
   // scrollback wasn't refreshed in time; append these to the top of the buffer.
   int row_offset = term->sb_pending;
+  int added = 0;
   while (term->sb_pending > 0 && buf->b_ml.ml_line_count < height) {
     fetch_row(term, term->sb_pending - row_offset - 1, width);
     ml_append(0, term->textbuf, 0, false);
-    appended_lines(0, 1);
+    added++;
     term->sb_pending--;
   }
+  if (added > 0) {
+    appended_lines(0, added);
+  }
 
+  // This means that either the window height has decreased or the screen
+  // became full and libvterm had to push all rows up. The pending scrollback
+  // rows are appended just above the visible section of the buffer, after
+  // deleting the lines at the top that don't fit in a full scrollback.  The
+  // changes are reported once for each block of lines.
   row_offset -= term->sb_pending;
-  while (term->sb_pending > 0) {
-    // This means that either the window height has decreased or the screen
-    // became full and libvterm had to push all rows up. Convert the first
-    // pending scrollback row into a string and append it just above the visible
-    // section of the buffer
-    if (((int)buf->b_ml.ml_line_count - height) >= (int)term->sb_size) {
-      // scrollback full, delete lines at the top
+  if (term->sb_pending > 0) {
+    int excess = (int)buf->b_ml.ml_line_count - height + term->sb_pending
+                 - (int)term->sb_size;
+    int to_delete = MIN(MAX(excess, 0), term->sb_pending);
+    for (int i = 0; i < to_delete; i++) {
       ml_delete(1, false);
-      deleted_lines(1, 1);
     }
-    fetch_row(term, -term->sb_pending - row_offset, width);
+    if (to_delete > 0) {
+      deleted_lines(1, to_delete);
+    }
+
     int buf_index = (int)buf->b_ml.ml_line_count - height;
-    ml_append(buf_index, term->textbuf, 0, false);
-    appended_lines(buf_index, 1);
-    term->sb_pending--;
+    added = 0;
+    while (term->sb_pending > 0) {
+      fetch_row(term, -term->sb_pending - row_offset, width);
+      ml_append(buf_index + added, term->textbuf, 0, false);
+      added++;
+      term->sb_pending--;
+    }
+    appended_lines(buf_index, added);
   }
 
   // Remove extra lines at the bottom
   int max_line_count = (int)term->sb_current + height;
+  int line_count = buf->b_ml.ml_line_count;
   while (buf->b_ml.ml_line_count > max_line_count) {
     ml_delete(buf->b_ml.ml_line_count, false);
-    deleted_lines(buf->b_ml.ml_line_count, 1);
+  }
+  if (line_count > max_line_count) {
+    deleted_lines(max_line_count + 1, line_count - max_line_count);
   }
 
   adjust_scrollback(term, buf);
+  return flooded;
 }
 
 // Refresh the screen (visible part of the buffer when the terminal is
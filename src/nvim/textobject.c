@@ -7,6 +7,7 @@
 
 #include "nvim/ascii_defs.h"
 #include "nvim/buffer_defs.h"
+#include "nvim/charset.h"
 #include "nvim/cursor.h"
 #include "nvim/drawscreen.h"
 #include "nvim/edit.h"
@@ -310,6 +311,43 @@ static int cls(void)
   return c;
 }
 
+/// Like cls() for an ASCII character other than NUL.
+static inline int cls_ascii(uint8_t c)
+{
+  if (c == ' ' || c == '\t') {
+    return 0;
+  }
+  if (cls_bigword) {
+    return 1;
+  }
+  return vim_iswordc_tab(c, curbuf->b_chartab) ? 2 : 1;
+}
+
+/// Moves the cursor over a run of ASCII characters of class "cclass" in the
+/// cursor line, in direction "dir", and leaves it on the last one.  Every
+/// step skipped is one where inc_cursor() or dec_cursor() would return zero
+/// and cls() would return "cclass", so a caller looping on those continues
+/// from there as if it had made the steps itself, without decoding each
+/// character.
+static void cls_skip_ascii(int cclass, int dir)
+{
+  const uint8_t *line = (uint8_t *)get_cursor_line_ptr();
+  colnr_T col = curwin->w_cursor.col;
+  if (line[col] == NUL || line[col] >= 0x80) {
+    return;
+  }
+  if (dir == FORWARD) {
+    while (line[col + 1] != NUL && line[col + 1] < 0x80 && cls_ascii(line[col + 1]) == cclass) {
+      col++;
+    }
+  } else {
+    while (col > 0 && line[col - 1] < 0x80 && cls_ascii(line[col - 1]) == cclass) {
+      col--;
+    }
+  }
+  curwin->w_cursor.col = col;
+}
+
 /// fwd_word(count, type, eol) - move forward one word
 ///
 /// @return  FAIL if the cursor was already at the end of the file.
@@ -342,6 +380,7 @@ int fwd_word(int count, bool bigword, bool eol)
     // Go one char past end of current word (if any)
     if (sclass != 0) {
       while (cls() == sclass) {
+        cls_skip_ascii(sclass, FORWARD);
         i = inc_cursor();
         if (i == -1 || (i >= 1 && eol && count == 0)) {
           return OK;
@@ -356,6 +395,7 @@ int fwd_word(int count, bool bigword, bool eol)
         break;
       }
 
+      cls_skip_ascii(0, FORWARD);
       i = inc_cursor();
       if (i == -1 || (i >= 1 && eol && count == 0)) {
         return OK;
@@ -525,6 +565,7 @@ int bckend_word(int count, bool bigword, bool eol)
 static bool skip_chars(int cclass, int dir)
 {
   while (cls() == cclass) {
+    cls_skip_ascii(cclass, dir);
     if ((dir == FORWARD ? inc_cursor() : dec_cursor()) == -1) {
       return true;
     }
@@ -1,6 +1,7 @@
 // Terminal UI functions. Invoked (by ui_client.c) on the UI process.
 
 #include <assert.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -45,6 +46,8 @@
 #define OUTBUF_SIZE 0xffff
 
 #define TOO_MANY_EVENTS 1000000
+#define MOTION_COST_NONE (INT_MAX / 4)
+#define MOTION_COST_CACHE 256
 #define STARTS_WITH(str, prefix) \
   (strlen(str) >= (sizeof(prefix) - 1) \
    && 0 == memcmp((str), (prefix), sizeof(prefix) - 1))
@@ -66,13 +69,58 @@ typedef struct {
   int top, bot, left, right;
 } Rect;
 
+typedef enum {
+  kMotionNone = 0,
+  kMotionStep,     ///< repeat the single-step capability
+  kMotionParm,     ///< parametrized relative motion
+  kMotionAbs,      ///< VPA
+  kMotionReprint,  ///< print the cells which are already there
+} MotionKind;
+
+/// A cursor motion: an optional CR or absolute column first, then a vertical
+/// motion, then a horizontal motion on the target row.
+typedef struct {
+  int cost;
+  bool cr;
+  bool col_abs;
+  MotionKind vert;
+  MotionKind horiz;
+} Motion;
+
+/// Cursor motion capabilities whose costs are cached, see motion_cost().
+static const enum unibi_string motion_caps[] = {
+  unibi_carriage_return,
+  unibi_cursor_up,
+  unibi_cursor_down,
+  unibi_cursor_left,
+  unibi_cursor_right,
+  unibi_parm_up_cursor,
+  unibi_parm_down_cursor,
+  unibi_parm_left_cursor,
+  unibi_parm_right_cursor,
+  unibi_row_address,
+  unibi_column_address,
+};
+
 struct TUIData {
   Loop *loop;
   unibi_var_t params[9];
-  char buf[OUTBUF_SIZE];
+  char outbuf[2][OUTBUF_SIZE];
+  char *buf;  ///< half of outbuf[] being filled, the other one may be written
   size_t bufpos;
   TermInput input;
   uv_loop_t write_loop;
+  // The writer thread writes write_bufs[] to output_handle, so that a slow
+  // terminal doesn't block the loop while the next frame is prepared.
+  uv_thread_t write_thread;
+  uv_mutex_t write_mutex;
+  uv_cond_t write_cond;
+  bool has_write_thread;
+  bool write_busy;  ///< write_bufs[] belong to the writer thread
+  bool write_stop;
+  uv_buf_t write_bufs[3];
+  char write_pre[32];
+  char write_post[32];
   unibi_term *ut;
   char *term;  ///< value of $TERM
   union {
@@ -98,6 +146,8 @@ struct TUIData {
   bool mouse_move_enabled;
   bool title_enabled;
   bool sync_output;
+  bool in_sync_update;  ///< synchronized update was started but not ended
+  bool partial_flush;  ///< flushing in the middle of a frame
   bool busy, is_invisible, want_invisible;
   bool cork, overflow;
   bool set_cursor_color_as_str;
@@ -137,6 +187,9 @@ struct TUIData {
   int width;
   int height;
   bool rgb;
+  /// Costs of motion_caps[] for a parameter below MOTION_COST_CACHE, -1 when
+  /// not computed yet.  Cleared when terminfo is loaded.
+  int motion_costs[ARRAY_SIZE(motion_caps)][MOTION_COST_CACHE];
 };
 
 static int got_winch = 0;
@@ -260,11 +313,14 @@ static void tui_query_kitty_keyboard(TUIData *tui)
 
 static void terminfo_start(TUIData *tui)
 {
+  memset(tui->motion_costs, -1, sizeof(tui->motion_costs));
   tui->scroll_region_is_full_screen = true;
+  tui->buf = tui->outbuf[0];
   tui->bufpos = 0;
   tui->default_attr = false;
   tui->can_clear_attr = false;
   tui->is_invisible = true;
+  tui->in_sync_update = false;
   tui->want_invisible = false;
   tui->busy = false;
   tui->cork = false;
@@ -404,6 +460,13 @@ static void terminfo_start(TUIData *tui)
       ELOG("uv_pipe_open failed: %s", uv_strerror(ret));
     }
   }
+
+  uv_mutex_init(&tui->write_mutex);
+  uv_cond_init(&tui->write_cond);
+  tui->write_busy = false;
+  tui->write_stop = false;
+  tui->has_write_thread
+    = uv_thread_create(&tui->write_thread, write_thread_main, tui) == 0;
   flush_buf(tui);
 }
 
@@ -445,6 +508,7 @@ static void terminfo_stop(TUIData *tui)
   unibi_out_ext(tui, tui->unibi_ext.sync);
 
   flush_buf(tui);
+  write_thread_stop(tui);
   uv_tty_reset_mode();
   uv_close((uv_handle_t *)&tui->output_handle, NULL);
   uv_run(&tui->write_loop, UV_RUN_DEFAULT);
@@ -562,15 +626,52 @@ static bool attrs_differ(TUIData *tui, int id1, int id2, bool rgb)
   }
 }
 
+/// @return foreground color sent for `attrs`, or -1 for the default color
+static int attrs_fg(TUIData *tui, HlAttrs attrs)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  if (tui->rgb && !(attr & HL_FG_INDEXED)) {
+    return attrs.rgb_fg_color != -1 ? attrs.rgb_fg_color : tui->clear_attrs.rgb_fg_color;
+  }
+  return attrs.cterm_fg_color ? attrs.cterm_fg_color - 1 : tui->clear_attrs.cterm_fg_color - 1;
+}
+
+/// @return background color sent for `attrs`, or -1 for the default color
+static int attrs_bg(TUIData *tui, HlAttrs attrs)
+{
+  int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  if (tui->rgb && !(attr & HL_BG_INDEXED)) {
+    return attrs.rgb_bg_color != -1 ? attrs.rgb_bg_color : tui->clear_attrs.rgb_bg_color;
+  }
+  return attrs.cterm_bg_color ? attrs.cterm_bg_color - 1 : tui->clear_attrs.cterm_bg_color - 1;
+}
+
 static void update_attrs(TUIData *tui, int attr_id)
 {
   if (!attrs_differ(tui, attr_id, tui->print_attr_id, tui->rgb)) {
     tui->print_attr_id = attr_id;
     return;
   }
+  int prev_id = tui->print_attr_id;
   tui->print_attr_id = attr_id;
   HlAttrs attrs = kv_A(tui->attrs, (size_t)attr_id);
   int attr = tui->rgb ? attrs.rgb_ae_attr : attrs.cterm_ae_attr;
+  int fg = attrs_fg(tui, attrs);
+  int bg = attrs_bg(tui, attrs);
+
+  // When only the colors change, the other attributes are kept and only the
+  // changed colors are sent. Going back to a default color needs a reset.
+  int prev_fg = -1;
+  int prev_bg = -1;
+  bool colors_only = false;
+  if (prev_id >= 0) {
+    HlAttrs prev = kv_A(tui->attrs, (size_t)prev_id);
+    prev_fg = attrs_fg(tui, prev);
+    prev_bg = attrs_bg(tui, prev);
+    colors_only = attr == (tui->rgb ? prev.rgb_ae_attr : prev.cterm_ae_attr)
+                  && (!(attr & HL_UNDERLINE_MASK) || attrs.rgb_sp_color == prev.rgb_sp_color)
+                  && (fg != -1 || prev_fg == -1) && (bg != -1 || prev_bg == -1);
+  }
 
   bool bold = attr & HL_BOLD;
   bool italic = attr & HL_ITALIC;
@@ -602,6 +703,10 @@ static void update_attrs(TUIData *tui, int attr_id)
   bool has_any_underline = undercurl || underline
                            || underdouble || underdotted || underdashed;
 
+  if (colors_only) {
+    goto colors;
+  }
+
   if (unibi_get_str(tui->ut, unibi_set_attributes)) {
     if (bold || reverse || underline || standout) {
       UNIBI_SET_NUM_VAR(tui->params[0], standout);
@@ -670,38 +775,26 @@ static void update_attrs(TUIData *tui, int attr_id)
     }
   }
 
-  int fg, bg;
-  if (tui->rgb && !(attr & HL_FG_INDEXED)) {
-    fg = ((attrs.rgb_fg_color != -1)
-          ? attrs.rgb_fg_color : tui->clear_attrs.rgb_fg_color);
-    if (fg != -1) {
+colors:
+  if (fg != -1 && (!colors_only || fg != prev_fg)) {
+    if (tui->rgb && !(attr & HL_FG_INDEXED)) {
       UNIBI_SET_NUM_VAR(tui->params[0], (fg >> 16) & 0xff);  // red
       UNIBI_SET_NUM_VAR(tui->params[1], (fg >> 8) & 0xff);   // green
       UNIBI_SET_NUM_VAR(tui->params[2], fg & 0xff);          // blue
       unibi_out_ext(tui, tui->unibi_ext.set_rgb_foreground);
-    }
-  } else {
-    fg = (attrs.cterm_fg_color
-          ? attrs.cterm_fg_color - 1 : (tui->clear_attrs.cterm_fg_color - 1));
-    if (fg != -1) {
+    } else {
       UNIBI_SET_NUM_VAR(tui->params[0], fg);
       unibi_out(tui, unibi_set_a_foreground);
     }
   }
 
-  if (tui->rgb && !(attr & HL_BG_INDEXED)) {
-    bg = ((attrs.rgb_bg_color != -1)
-          ? attrs.rgb_bg_color : tui->clear_attrs.rgb_bg_color);
-    if (bg != -1) {
+  if (bg != -1 && (!colors_only || bg != prev_bg)) {
+    if (tui->rgb && !(attr & HL_BG_INDEXED)) {
       UNIBI_SET_NUM_VAR(tui->params[0], (bg >> 16) & 0xff);  // red
       UNIBI_SET_NUM_VAR(tui->params[1], (bg >> 8) & 0xff);   // green
       UNIBI_SET_NUM_VAR(tui->params[2], bg & 0xff);          // blue
       unibi_out_ext(tui, tui->unibi_ext.set_rgb_background);
-    }
-  } else {
-    bg = (attrs.cterm_bg_color
-          ? attrs.cterm_bg_color - 1 : (tui->clear_attrs.cterm_bg_color - 1));
-    if (bg != -1) {
+    } else {
       UNIBI_SET_NUM_VAR(tui->params[0], bg);
       unibi_out(tui, unibi_set_a_background);
     }
@@ -748,6 +841,8 @@ static void print_cell(TUIData *tui, char *buf, sattr_T attr)
   }
 }
 
+/// Check if the `next` cells from `col` can be reprinted to move the cursor
+/// over them: they must be ASCII and use the attributes already in effect.
 static bool cheap_to_print(TUIData *tui, int row, int col, int next)
 {
   UGrid *grid = &tui->grid;
@@ -756,9 +851,7 @@ static bool cheap_to_print(TUIData *tui, int row, int col, int next)
     next--;
     if (attrs_differ(tui, cell->attr,
                      tui->print_attr_id, tui->rgb)) {
-      if (tui->default_attr) {
-        return false;
-      }
+      return false;
     }
     if (schar_get_ascii(cell->data) == 0) {
       return false;  // not ascii
@@ -768,9 +861,132 @@ static bool cheap_to_print(TUIData *tui, int row, int col, int next)
   return true;
 }
 
-/// This optimizes several cases where it is cheaper to do something other
-/// than send a full cursor positioning control sequence.  However, there are
-/// some further optimizations that may seem obvious but that will not work.
+/// @return number of bytes sent for terminfo string `unibi_index` with
+///         parameters `p1` and `p2`, or MOTION_COST_NONE if it is missing.
+static int motion_cost(TUIData *tui, enum unibi_string unibi_index, int p1, int p2)
+{
+  int *cached = NULL;
+  if (p2 == 0 && p1 >= 0 && p1 < MOTION_COST_CACHE) {
+    for (size_t i = 0; i < ARRAY_SIZE(motion_caps); i++) {
+      if (motion_caps[i] == unibi_index) {
+        cached = &tui->motion_costs[i][p1];
+        break;
+      }
+    }
+    if (cached != NULL && *cached >= 0) {
+      return *cached;
+    }
+  }
+
+  int cost = MOTION_COST_NONE;
+  const char *str = unibi_get_str(tui->ut, unibi_index);
+  if (str != NULL) {
+    unibi_var_t params[9];  // Don't use tui->params[] as they may already be in use.
+    memset(params, 0, sizeof(params));
+    UNIBI_SET_NUM_VAR(params[0], p1);
+    UNIBI_SET_NUM_VAR(params[1], p2);
+    char buf[64];
+    cost = (int)unibi_run(str, params, buf, sizeof(buf));
+  }
+  if (cached != NULL) {
+    *cached = cost;
+  }
+  return cost;
+}
+
+/// Picks the cheapest of stepping `n` times or the parametrized capability.
+static int relative_cost(TUIData *tui, enum unibi_string step, enum unibi_string parm, int n,
+                         MotionKind *kind)
+{
+  int step_cost = motion_cost(tui, step, 0, 0);
+  step_cost = step_cost == MOTION_COST_NONE ? step_cost : n * step_cost;
+  int parm_cost = motion_cost(tui, parm, n, 0);
+  if (step_cost <= parm_cost) {
+    *kind = kMotionStep;
+    return step_cost;
+  }
+  *kind = kMotionParm;
+  return parm_cost;
+}
+
+/// Cost of moving right from `from` to `to` on `row` without CR.
+static int right_cost(TUIData *tui, int row, int from, int to, MotionKind *kind)
+{
+  if (from == to) {
+    *kind = kMotionNone;
+    return 0;
+  }
+  int cost = relative_cost(tui, unibi_cursor_right, unibi_parm_right_cursor, to - from, kind);
+  if (to - from < cost && cheap_to_print(tui, row, from, to - from)) {
+    *kind = kMotionReprint;
+    cost = to - from;
+  }
+  return cost;
+}
+
+/// Finds the cheapest way to move the cursor from its known position to
+/// (row, col) using relative motions, HPA/VPA, CR and reprinting cells.
+static Motion cheapest_motion(TUIData *tui, int row, int col)
+{
+  UGrid *grid = &tui->grid;
+  Motion best = { .cost = MOTION_COST_NONE };
+
+  // Deferred right margin wrap terminals have inconsistent ideas about where
+  // the cursor actually is during a deferred wrap. Relative motion
+  // calculations have OBOEs that cannot be compensated for, because two
+  // terminals that claim to be the same will implement different cursor
+  // positioning rules. Only CR or an absolute column is safe then.
+  bool deferred = !tui->immediate_wrap_after_last_column && grid->col >= tui->width;
+
+  MotionKind vert = kMotionNone;
+  int vert_cost = 0;
+  if (row != grid->row) {
+    int n = abs(row - grid->row);
+    vert_cost = row > grid->row
+                ? relative_cost(tui, unibi_cursor_down, unibi_parm_down_cursor, n, &vert)
+                : relative_cost(tui, unibi_cursor_up, unibi_parm_up_cursor, n, &vert);
+    int abs_cost = motion_cost(tui, unibi_row_address, row, 0);
+    if (abs_cost < vert_cost) {
+      vert = kMotionAbs;
+      vert_cost = abs_cost;
+    }
+  }
+
+  // relative horizontal motion from the current column
+  if (!deferred) {
+    MotionKind horiz;
+    int cost;
+    if (col < grid->col) {
+      cost = relative_cost(tui, unibi_cursor_left, unibi_parm_left_cursor, grid->col - col,
+                           &horiz);
+    } else {
+      cost = right_cost(tui, row, grid->col, col, &horiz);
+    }
+    if (vert_cost + cost < best.cost) {
+      best = (Motion){ .cost = vert_cost + cost, .vert = vert, .horiz = horiz };
+    }
+  }
+
+  // CR, then right from the left margin
+  MotionKind horiz;
+  int cost = motion_cost(tui, unibi_carriage_return, 0, 0) + right_cost(tui, row, 0, col, &horiz);
+  if (vert_cost + cost < best.cost) {
+    best = (Motion){ .cost = vert_cost + cost, .cr = true, .vert = vert, .horiz = horiz };
+  }
+
+  // absolute column
+  cost = motion_cost(tui, unibi_column_address, col, 0);
+  if (vert_cost + cost < best.cost) {
+    best = (Motion){ .cost = vert_cost + cost, .col_abs = true, .vert = vert };
+  }
+
+  return best;
+}
+
+/// Moves the cursor with the sequence that costs the fewest bytes among
+/// absolute positioning and the combinations found by cheapest_motion().
+/// However, there are some further optimizations that may seem obvious but
+/// that will not work.
 ///
 /// We cannot use VT (ASCII 0/11) for moving the cursor up, because VT means
 /// move the cursor down on a DEC terminal.  Similarly, on a DEC terminal FF
@@ -791,80 +1007,65 @@ static void cursor_goto(TUIData *tui, int row, int col)
   if (grid->row == -1) {
     goto safe_move;
   }
-  if (0 == col
-      ? col != grid->col
-      : (row != grid->row
-         ? false
-         : (1 == col
-            ? (2 < grid->col && cheap_to_print(tui, grid->row, 0, col))
-            : (2 == col
-               ? (5 < grid->col && cheap_to_print(tui, grid->row, 0, col))
-               : false)))) {
-    // Motion to left margin from anywhere else, or CR + printing chars is
-    // even less expensive than using BSes or CUB.
+
+  // Without the capabilities for any relative motion the cost is
+  // MOTION_COST_NONE, also when "cup" is missing too.
+  Motion m = cheapest_motion(tui, row, col);
+  if (m.cost >= MOTION_COST_NONE || m.cost > motion_cost(tui, unibi_cursor_address, row, col)) {
+    goto safe_move;
+  }
+
+  if (m.cr) {
     unibi_out(tui, unibi_carriage_return);
     ugrid_goto(grid, grid->row, 0);
+  } else if (m.col_abs) {
+    UNIBI_SET_NUM_VAR(tui->params[0], col);
+    unibi_out(tui, unibi_column_address);
+    ugrid_goto(grid, grid->row, col);
   }
-  if (row == grid->row) {
-    if (col < grid->col
-        // Deferred right margin wrap terminals have inconsistent ideas about
-        // where the cursor actually is during a deferred wrap.  Relative
-        // motion calculations have OBOEs that cannot be compensated for,
-        // because two terminals that claim to be the same will implement
-        // different cursor positioning rules.
-        && (tui->immediate_wrap_after_last_column || grid->col < tui->width)) {
-      int n = grid->col - col;
-      if (n <= 4) {  // This might be just BS, so it is considered really cheap.
-        while (n--) {
-          unibi_out(tui, unibi_cursor_left);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_left_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    } else if (col > grid->col) {
-      int n = col - grid->col;
-      if (n <= 2) {
-        while (n--) {
-          unibi_out(tui, unibi_cursor_right);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_right_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
+
+  int n = abs(row - grid->row);
+  switch (m.vert) {
+  case kMotionStep:
+    while (n--) {
+      unibi_out(tui, row > grid->row ? unibi_cursor_down : unibi_cursor_up);
     }
+    break;
+  case kMotionParm:
+    UNIBI_SET_NUM_VAR(tui->params[0], n);
+    unibi_out(tui, row > grid->row ? unibi_parm_down_cursor : unibi_parm_up_cursor);
+    break;
+  case kMotionAbs:
+    UNIBI_SET_NUM_VAR(tui->params[0], row);
+    unibi_out(tui, unibi_row_address);
+    break;
+  default:
+    break;
   }
-  if (col == grid->col) {
-    if (row > grid->row) {
-      int n = row - grid->row;
-      if (n <= 4) {  // This might be just LF, so it is considered really cheap.
-        while (n--) {
-          unibi_out(tui, unibi_cursor_down);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_down_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
-    } else if (row < grid->row) {
-      int n = grid->row - row;
-      if (n <= 2) {
-        while (n--) {
-          unibi_out(tui, unibi_cursor_up);
-        }
-      } else {
-        UNIBI_SET_NUM_VAR(tui->params[0], n);
-        unibi_out(tui, unibi_parm_up_cursor);
-      }
-      ugrid_goto(grid, row, col);
-      return;
+  ugrid_goto(grid, row, grid->col);
+
+  n = abs(col - grid->col);
+  switch (m.horiz) {
+  case kMotionStep:
+    while (n--) {
+      unibi_out(tui, col > grid->col ? unibi_cursor_right : unibi_cursor_left);
     }
+    break;
+  case kMotionParm:
+    UNIBI_SET_NUM_VAR(tui->params[0], n);
+    unibi_out(tui, col > grid->col ? unibi_parm_right_cursor : unibi_parm_left_cursor);
+    break;
+  case kMotionReprint:
+    for (int c = grid->col; c < col; c++) {
+      char buf[2] = { schar_get_ascii(grid->cells[row][c].data), NUL };
+      print_cell(tui, buf, grid->cells[row][c].attr);
+    }
+    break;
+  default:
+    break;
   }
+  ugrid_goto(grid, row, col);
+  return;
 
 safe_move:
   unibi_goto(tui, row, col);
@@ -1198,6 +1399,7 @@ void tui_mode_change(TUIData *tui, String mode, Integer mode_idx)
   // after calling uv_tty_set_mode. So, set the mode of the TTY again here.
   // #13073
   if (tui->is_starting && !stdin_isatty) {
+    flush_wait(tui);
     int ret = uv_tty_set_mode(&tui->output_handle.tty, UV_TTY_MODE_NORMAL);
     if (ret) {
       ELOG("uv_tty_set_mode failed: %s", uv_strerror(ret));
@@ -1285,6 +1487,10 @@ void tui_hl_attr_define(TUIData *tui, Integer id, HlAttrs attrs, HlAttrs cterm_a
   attrs.cterm_fg_color = cterm_attrs.cterm_fg_color;
   attrs.cterm_bg_color = cterm_attrs.cterm_bg_color;
   kv_a(tui->attrs, (size_t)id) = attrs;
+  if (id == tui->print_attr_id) {
+    // update_attrs() compares with the attributes sent for this id.
+    tui->print_attr_id = -1;
+  }
 }
 
 void tui_bell(TUIData *tui)
@@ -1627,7 +1833,7 @@ retry: \
       unibi_format(vars, vars + 26, str, params, out, tui, pad, tui); \
       if (tui->overflow) { \
         tui->bufpos = orig_pos; \
-        flush_buf(tui); \
+        flush_buf_partial(tui); \
         goto retry; \
       } \
       tui->cork = false; \
@@ -1646,7 +1852,7 @@ static void unibi_out_ext(TUIData *tui, int unibi_index)
 static void out(void *ctx, const char *str, size_t len)
 {
   TUIData *tui = ctx;
-  size_t available = sizeof(tui->buf) - tui->bufpos;
+  size_t available = OUTBUF_SIZE - tui->bufpos;
 
   if (tui->cork && tui->overflow) {
     return;
@@ -1658,7 +1864,7 @@ static void out(void *ctx, const char *str, size_t len)
       tui->overflow = true;
       return;
     }
-    flush_buf(tui);
+    flush_buf_partial(tui);
   }
 
   memcpy(tui->buf + tui->bufpos, str, len);
@@ -1685,6 +1891,7 @@ static void pad(void *ctx, size_t delay, int scale FUNC_ATTR_UNUSED, int force)
   }
 
   flush_buf(tui);
+  flush_wait(tui);
   uv_sleep((unsigned)(delay/10));
 }
 
@@ -2276,8 +2483,11 @@ static size_t flush_buf_start(TUIData *tui, char *buf, size_t len)
 
   const char *str = NULL;
   if (tui->sync_output && tui->unibi_ext.sync != -1) {
-    UNIBI_SET_NUM_VAR(params[0], 1);
-    str = unibi_get_ext_str(tui->ut, (size_t)tui->unibi_ext.sync);
+    if (!tui->in_sync_update) {
+      UNIBI_SET_NUM_VAR(params[0], 1);
+      str = unibi_get_ext_str(tui->ut, (size_t)tui->unibi_ext.sync);
+      tui->in_sync_update = true;
+    }
   } else if (!tui->is_invisible) {
     str = unibi_get_str(tui->ut, unibi_cursor_invisible);
     tui->is_invisible = true;
@@ -2301,11 +2511,17 @@ static size_t flush_buf_end(TUIData *tui, char *buf, size_t len)
 {
   unibi_var_t params[9];  // Don't use tui->params[] as they may already be in use.
 
+  if (tui->partial_flush) {
+    // The rest of the frame follows, keep the update open.
+    return 0;
+  }
+
   size_t offset = 0;
-  if (tui->sync_output && tui->unibi_ext.sync != -1) {
+  if (tui->in_sync_update) {
     UNIBI_SET_NUM_VAR(params[0], 0);
     const char *str = unibi_get_ext_str(tui->ut, (size_t)tui->unibi_ext.sync);
     offset = unibi_run(str, params, buf, len);
+    tui->in_sync_update = false;
   }
 
   const char *str = NULL;
@@ -2327,40 +2543,112 @@ static size_t flush_buf_end(TUIData *tui, char *buf, size_t len)
 
 static void flush_buf(TUIData *tui)
 {
-  uv_write_t req;
-  uv_buf_t bufs[3];
-  char pre[32];
-  char post[32];
-
   if (tui->bufpos <= 0 && tui->is_invisible == should_invisible(tui)) {
     return;
   }
 
-  bufs[0].base = pre;
-  bufs[0].len = UV_BUF_LEN(flush_buf_start(tui, pre, sizeof(pre)));
+  // The writer thread may still be writing the previous frame.
+  flush_wait(tui);
+
+  uv_buf_t *bufs = tui->write_bufs;
+  bufs[0].base = tui->write_pre;
+  bufs[0].len = UV_BUF_LEN(flush_buf_start(tui, tui->write_pre, sizeof(tui->write_pre)));
 
   bufs[1].base = tui->buf;
   bufs[1].len = UV_BUF_LEN(tui->bufpos);
 
-  bufs[2].base = post;
-  bufs[2].len = UV_BUF_LEN(flush_buf_end(tui, post, sizeof(post)));
+  bufs[2].base = tui->write_post;
+  bufs[2].len = UV_BUF_LEN(flush_buf_end(tui, tui->write_post, sizeof(tui->write_post)));
 
   if (tui->screenshot) {
-    for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+    for (size_t i = 0; i < ARRAY_SIZE(tui->write_bufs); i++) {
       fwrite(bufs[i].base, bufs[i].len, 1, tui->screenshot);
     }
+  } else if (tui->has_write_thread) {
+    uv_mutex_lock(&tui->write_mutex);
+    tui->write_busy = true;
+    uv_cond_broadcast(&tui->write_cond);
+    uv_mutex_unlock(&tui->write_mutex);
+    // Fill the other half of outbuf[] while this one is written.
+    tui->buf = tui->buf == tui->outbuf[0] ? tui->outbuf[1] : tui->outbuf[0];
   } else {
-    int ret
-      = uv_write(&req, (uv_stream_t *)&tui->output_handle, bufs, ARRAY_SIZE(bufs), NULL);
-    if (ret) {
-      ELOG("uv_write failed: %s", uv_strerror(ret));
-    }
-    uv_run(&tui->write_loop, UV_RUN_DEFAULT);
+    write_bufs(tui);
   }
   tui->bufpos = 0;
   tui->overflow = false;
 }
 
+/// Flushes the output buffer when it is full in the middle of a frame.
+///
+/// A synchronized update stays open and the cursor stays hidden until the
+/// frame is completed by the next regular flush_buf().
+static void flush_buf_partial(TUIData *tui)
+{
+  tui->partial_flush = true;
+  flush_buf(tui);
+  tui->partial_flush = false;
+}
+
+/// Writes write_bufs[] to the terminal, blocking until it is done.
+static void write_bufs(TUIData *tui)
+{
+  uv_write_t req;
+  int ret = uv_write(&req, (uv_stream_t *)&tui->output_handle, tui->write_bufs,
+                     ARRAY_SIZE(tui->write_bufs), NULL);
+  if (ret) {
+    ELOG("uv_write failed: %s", uv_strerror(ret));
+  }
+  uv_run(&tui->write_loop, UV_RUN_DEFAULT);
+}
+
+static void write_thread_main(void *arg)
+{
+  TUIData *tui = arg;
+  uv_mutex_lock(&tui->write_mutex);
+  while (true) {
+    while (!tui->write_busy && !tui->write_stop) {
+      uv_cond_wait(&tui->write_cond, &tui->write_mutex);
+    }
+    if (!tui->write_busy) {
+      break;
+    }
+    uv_mutex_unlock(&tui->write_mutex);
+    write_bufs(tui);
+    uv_mutex_lock(&tui->write_mutex);
+    tui->write_busy = false;
+    uv_cond_broadcast(&tui->write_cond);
+  }
+  uv_mutex_unlock(&tui->write_mutex);
+}
+
+/// Waits until the writer thread has written everything given to it.
+static void flush_wait(TUIData *tui)
+{
+  if (!tui->has_write_thread) {
+    return;
+  }
+  uv_mutex_lock(&tui->write_mutex);
+  while (tui->write_busy) {
+    uv_cond_wait(&tui->write_cond, &tui->write_mutex);
+  }
+  uv_mutex_unlock(&tui->write_mutex);
+}
+
+/// Stops the writer thread after it wrote the pending output.
+static void write_thread_stop(TUIData *tui)
+{
+  if (tui->has_write_thread) {
+    uv_mutex_lock(&tui->write_mutex);
+    tui->write_stop = true;
+    uv_cond_broadcast(&tui->write_cond);
+    uv_mutex_unlock(&tui->write_mutex);
+    uv_thread_join(&tui->write_thread);
+    tui->has_write_thread = false;
+  }
+  uv_cond_destroy(&tui->write_cond);
+  uv_mutex_destroy(&tui->write_mutex);
+}
+
 /// Try to get "kbs" code from stty because "the terminfo kbs entry is extremely
 /// unreliable." (Vim, Bash, and tmux also do this.)
 ///
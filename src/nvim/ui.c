@@ -23,11 +23,13 @@
 #include "nvim/highlight_defs.h"
 #include "nvim/log.h"
 #include "nvim/lua/executor.h"
+#include "nvim/macros_defs.h"
 #include "nvim/map_defs.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
+#include "nvim/os/input.h"
 #include "nvim/os/time.h"
 #include "nvim/state_defs.h"
 #include "nvim/strings.h"
@@ -68,6 +70,22 @@ static bool pending_default_colors = false;
 
 static Array call_buf = ARRAY_DICT_INIT;
 
+/// Number of histogram buckets in InputLatency.  Bucket i counts latencies
+/// below 2^i microseconds (and at least 2^(i-1)), the last one everything
+/// longer.
+#define INPUT_LATENCY_BUCKETS 24
+
+/// Time from receiving a key to flushing the screen that shows its effect.
+typedef struct {
+  uint64_t count;
+  uint64_t max;  ///< in nanoseconds
+  uint64_t buckets[INPUT_LATENCY_BUCKETS];
+} InputLatency;
+
+/// Input latency by the mode at the time of the flush, indexed like
+/// shape_table.
+static InputLatency input_latency[SHAPE_IDX_COUNT];
+
 #ifdef NVIM_LOG_DEBUG
 static size_t uilog_seen = 0;
 static const char *uilog_last_event = NULL;
@@ -524,6 +542,7 @@ int ui_current_col(void)
 void ui_flush(void)
 {
   assert(!ui_client_channel_id);
+  uint64_t key_time = input_take_key_time();
   if (!ui_active()) {
     return;
   }
@@ -554,12 +573,80 @@ void ui_flush(void)
     pending_has_mouse = has_mouse;
   }
   ui_call_flush();
+  if (key_time != 0) {
+    input_latency_add(os_hrtime() - key_time);
+  }
 
   if (p_wd && (rdb_flags & RDB_FLUSH)) {
     os_sleep((uint64_t)llabs(p_wd));
   }
 }
 
+static void input_latency_add(uint64_t ns)
+{
+  InputLatency *lat = &input_latency[cursor_get_mode_idx()];
+  uint64_t us = ns / 1000;
+  int i = 0;
+  while (us > 0 && i < INPUT_LATENCY_BUCKETS - 1) {
+    us >>= 1;
+    i++;
+  }
+  lat->count++;
+  lat->max = MAX(lat->max, ns);
+  lat->buckets[i]++;
+}
+
+/// @return the upper bound in microseconds of the bucket that holds the
+///         "pct" percentile of "lat", or its maximum if that is lower.
+static uint64_t input_latency_percentile(const InputLatency *lat, uint64_t pct)
+{
+  uint64_t want = (lat->count * pct + 99) / 100;
+  uint64_t seen = 0;
+  for (int i = 0; i < INPUT_LATENCY_BUCKETS - 1; i++) {
+    seen += lat->buckets[i];
+    if (seen >= want) {
+      return MIN((uint64_t)1 << i, lat->max / 1000);
+    }
+  }
+  return lat->max / 1000;
+}
+
+/// Clears the input latency stats of all modes.
+void input_latency_reset(void)
+{
+  memset(input_latency, 0, sizeof(input_latency));
+}
+
+/// Gets the input latency stats of the modes that had any input.
+///
+/// @see nvim__input_latency
+Dictionary input_latency_get(void)
+{
+  Dictionary rv = ARRAY_DICT_INIT;
+  for (int idx = 0; idx < SHAPE_IDX_COUNT; idx++) {
+    InputLatency *lat = &input_latency[idx];
+    if (lat->count == 0) {
+      continue;
+    }
+    size_t len = INPUT_LATENCY_BUCKETS;
+    while (len > 0 && lat->buckets[len - 1] == 0) {
+      len--;
+    }
+    Array hist = ARRAY_DICT_INIT;
+    for (size_t i = 0; i < len; i++) {
+      ADD(hist, INTEGER_OBJ((Integer)lat->buckets[i]));
+    }
+    Dictionary info = ARRAY_DICT_INIT;
+    PUT(info, "count", INTEGER_OBJ((Integer)lat->count));
+    PUT(info, "p50", INTEGER_OBJ((Integer)input_latency_percentile(lat, 50)));
+    PUT(info, "p99", INTEGER_OBJ((Integer)input_latency_percentile(lat, 99)));
+    PUT(info, "max", INTEGER_OBJ((Integer)(lat->max / 1000)));
+    PUT(info, "time", ARRAY_OBJ(hist));
+    PUT(rv, shape_table[idx].full_name, DICTIONARY_OBJ(info));
+  }
+  return rv;
+}
+
 /// Check if 'mouse' is active for the current mode
 ///
 /// TODO(bfredl): precompute the State -> active mapping when 'mouse' changes,
@@ -118,22 +118,23 @@ bool ui_comp_put_grid(ScreenGrid *grid, int row, int col, int height, int width,
     if (ui_comp_should_draw()) {
       // Redraw the area covered by the old position, and is not covered
       // by the new position. Disable the grid so that compose_area() will not
-      // use it.
+      // use it. Layers above the grid are unchanged and can be skipped.
+      size_t above = grid->comp_index + 1;
       grid->comp_disabled = true;
-      compose_area(grid->comp_row, row,
-                   grid->comp_col, grid->comp_col + grid->cols);
+      compose_area_below(grid->comp_row, row,
+                         grid->comp_col, grid->comp_col + grid->cols, above);
       if (grid->comp_col < col) {
-        compose_area(MAX(row, grid->comp_row),
-                     MIN(row + height, grid->comp_row + grid->rows),
-                     grid->comp_col, col);
+        compose_area_below(MAX(row, grid->comp_row),
+                           MIN(row + height, grid->comp_row + grid->rows),
+                           grid->comp_col, col, above);
       }
       if (col + width < grid->comp_col + grid->cols) {
-        compose_area(MAX(row, grid->comp_row),
-                     MIN(row + height, grid->comp_row + grid->rows),
-                     col + width, grid->comp_col + grid->cols);
+        compose_area_below(MAX(row, grid->comp_row),
+                           MIN(row + height, grid->comp_row + grid->rows),
+                           col + width, grid->comp_col + grid->cols, above);
       }
-      compose_area(row + height, grid->comp_row + grid->rows,
-                   grid->comp_col, grid->comp_col + grid->cols);
+      compose_area_below(row + height, grid->comp_row + grid->rows,
+                         grid->comp_col, grid->comp_col + grid->cols, above);
       grid->comp_disabled = false;
     }
     grid->comp_row = row;
@@ -171,8 +172,8 @@ bool ui_comp_put_grid(ScreenGrid *grid, int row, int col, int height, int width,
     grid->comp_index = insert_at;
   }
   if (moved && valid && ui_comp_should_draw()) {
-    compose_area(grid->comp_row, grid->comp_row + grid->rows,
-                 grid->comp_col, grid->comp_col + grid->cols);
+    compose_area_below(grid->comp_row, grid->comp_row + grid->rows,
+                       grid->comp_col, grid->comp_col + grid->cols, grid->comp_index + 1);
   }
   return moved;
 }
@@ -189,16 +190,20 @@ void ui_comp_remove_grid(ScreenGrid *grid)
     curgrid = &default_grid;
   }
 
-  for (size_t i = grid->comp_index; i < kv_size(layers) - 1; i++) {
+  size_t old_index = grid->comp_index;
+  for (size_t i = old_index; i < kv_size(layers) - 1; i++) {
     kv_A(layers, i) = kv_A(layers, i + 1);
     kv_A(layers, i)->comp_index = i;
   }
   (void)kv_pop(layers);
   grid->comp_index = 0;
 
-  // recompose the area under the grid
-  // inefficient when being overlapped: only draw up to grid->comp_index
-  ui_comp_compose_grid(grid);
+  // recompose the area under the grid, except where the layers which were
+  // above it still cover it
+  if (ui_comp_should_draw()) {
+    compose_area_below(grid->comp_row, grid->comp_row + grid->rows,
+                       grid->comp_col, grid->comp_col + grid->cols, old_index);
+  }
 }
 
 bool ui_comp_set_grid(handle_T handle)
@@ -234,9 +239,9 @@ void ui_comp_raise_grid(ScreenGrid *grid, size_t new_index)
     int startcol = MAX(grid->comp_col, grid2->comp_col);
     int endcol = MIN(grid->comp_col + grid->cols,
                      grid2->comp_col + grid2->cols);
-    compose_area(MAX(grid->comp_row, grid2->comp_row),
-                 MIN(grid->comp_row + grid->rows, grid2->comp_row + grid2->rows),
-                 startcol, endcol);
+    compose_area_below(MAX(grid->comp_row, grid2->comp_row),
+                       MIN(grid->comp_row + grid->rows, grid2->comp_row + grid2->rows),
+                       startcol, endcol, new_index + 1);
   }
 }
 
@@ -472,6 +477,15 @@ static void debug_delay(Integer lines)
 }
 
 static void compose_area(Integer startrow, Integer endrow, Integer startcol, Integer endcol)
+{
+  compose_area_below(startrow, endrow, startcol, endcol, kv_size(layers));
+}
+
+/// Like compose_area(), but skip the cells which are hidden by an opaque
+/// layer at index `above` or higher. The caller guarantees those layers were
+/// not affected by the change, so the UI already shows the right content there.
+static void compose_area_below(Integer startrow, Integer endrow, Integer startcol, Integer endcol,
+                               size_t above)
 {
   compose_debug(startrow, endrow, startcol, endcol, dbghl_recompose, true);
   endrow = MIN(endrow, default_grid.rows);
@@ -480,7 +494,31 @@ static void compose_area(Integer startrow, Integer endrow, Integer startcol, Int
     return;
   }
   for (int r = (int)startrow; r < endrow; r++) {
-    compose_line(r, startcol, endcol, kLineFlagInvalid);
+    int col = (int)startcol;
+    while (col < endcol) {
+      int skip_to = col;  // end of the occluder covering col, if any
+      int until = (int)endcol;  // start of the next occluder
+      for (size_t i = above; i < kv_size(layers); i++) {
+        ScreenGrid *g = kv_A(layers, i);
+        int grid_width = MIN(g->cols, g->comp_width);
+        int grid_height = MIN(g->rows, g->comp_height);
+        if (g->comp_row > r || r >= g->comp_row + grid_height
+            || g->comp_disabled || g->blending) {
+          continue;
+        }
+        if (g->comp_col <= col && col < g->comp_col + grid_width) {
+          skip_to = MAX(skip_to, g->comp_col + grid_width);
+        } else if (g->comp_col > col) {
+          until = MIN(until, g->comp_col);
+        }
+      }
+      if (skip_to > col) {
+        col = skip_to;
+        continue;
+      }
+      compose_line(r, col, until, kLineFlagInvalid);
+      col = until;
+    }
   }
 }
 
@@ -491,8 +529,8 @@ static void compose_area(Integer startrow, Integer endrow, Integer startcol, Int
 void ui_comp_compose_grid(ScreenGrid *grid)
 {
   if (ui_comp_should_draw()) {
-    compose_area(grid->comp_row, grid->comp_row + grid->rows,
-                 grid->comp_col, grid->comp_col + grid->cols);
+    compose_area_below(grid->comp_row, grid->comp_row + grid->rows,
+                       grid->comp_col, grid->comp_col + grid->cols, grid->comp_index + 1);
   }
 }
 
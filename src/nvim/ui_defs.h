@@ -38,7 +38,7 @@ typedef struct {
   /// guaranteed size available for each new event (so packing of simple events
   /// and the header of grid_line will never fail)
 #define EVENT_BUF_SIZE 256
-  char buf[UI_BUF_SIZE];  ///< buffer of packed but not yet sent msgpack data
+  char *buf;  ///< buffer of packed but not yet sent msgpack data (UI_BUF_SIZE bytes)
   char *buf_wptr;  ///< write head of buffer
   const char *cur_event;  ///< name of current event (might get multiple arglists)
   Array call_buf;  ///< buffer for constructing a single arg list (max 16 elements!)
@@ -59,6 +59,13 @@ typedef struct {
   bool flushed_events;  ///< events where sent to client without "flush" event
 
   size_t ncells_pending;  ///< total number of cells since last buffer flush
+  bool behind;  ///< the client can't keep up, don't send grid contents
+  bool resync_pending;  ///< a full redraw was scheduled to catch up
+
+  int max_fps;  ///< "max_fps" UI option, zero for no limit
+  uint64_t last_flush;  ///< os_hrtime() of the last "flush" event
+  bool flush_pending;  ///< "flush" event postponed until "pacer" fires
+  struct time_watcher *pacer;
 
   int hl_id;  // Current highlight for legacy put event.
   Integer cursor_row, cursor_col;  // Intended visible cursor position.
@@ -93,6 +93,9 @@
 #include "nvim/edit.h"
 #include "nvim/eval/funcs.h"
 #include "nvim/eval/typval.h"
+#include "nvim/event/defs.h"
+#include "nvim/event/loop.h"
+#include "nvim/event/multiqueue.h"
 #include "nvim/ex_cmds_defs.h"
 #include "nvim/ex_docmd.h"
 #include "nvim/ex_getln.h"
@@ -105,7 +108,9 @@
 #include "nvim/globals.h"
 #include "nvim/highlight.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/mark.h"
+#include "nvim/memfile.h"
 #include "nvim/memline.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
@@ -125,13 +130,29 @@
 #include "nvim/undo.h"
 #include "nvim/undo_defs.h"
 #include "nvim/vim_defs.h"
+#include "xdiff/xdiff.h"
 
 /// Structure passed around between undofile functions.
 typedef struct {
   buf_T *bi_buf;
-  FILE *bi_fp;
+  FILE *bi_fp;      ///< when reading
+  garray_T *bi_ga;  ///< when writing, the file is serialized in memory first
 } bufinfo_T;
 
+/// Undo file written in the libuv threadpool, see u_write_undo().
+typedef struct {
+  uv_work_t req;
+  int fd;           ///< the temporary file, opened on the main thread
+  char *tmp_name;
+  char *file_name;
+  garray_T data;
+  bool do_fsync;
+  bool write_ok;
+} UndoWriteJob;
+
+/// Number of undo files still being written in the background.
+static int undo_writes_pending = 0;
+
 #ifdef INCLUDE_GENERATED_DECLARATIONS
 # include "undo.c.generated.h"
 #endif
@@ -379,6 +400,12 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, int re
 
   // If curbuf->b_u_synced == true make a new header.
   if (buf->b_u_synced) {
+    // The previous change is complete and the text is what undoing it
+    // starts from.
+    if (buf->b_u_curhead == NULL && buf->b_u_newhead != NULL && get_undolevel(buf) >= 0) {
+      u_dedup_entry(buf, buf->b_u_newhead);
+    }
+
     // Need to create new entry in b_changelist.
     buf->b_new_change = true;
 
@@ -489,6 +516,7 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, int re
       buf->b_u_oldhead = uhp;
     }
     buf->b_u_numhead++;
+    u_check_mem(buf);
   } else {
     if (get_undolevel(buf) < 0) {  // no undo at all
       return OK;
@@ -559,6 +587,24 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, int re
       }
     }
 
+    // When saving the line just below the lines saved by the previous
+    // u_save() and the line count didn't change, add it to that entry.
+    // Avoids an entry for every line when ":s" changes many lines.
+    if (size == 1 && newbot == 0 && !reload && bot <= buf->b_ml.ml_line_count) {
+      uep = buf->b_u_newhead->uh_getbot_entry;
+      if (uep != NULL && uep == buf->b_u_newhead->uh_entry
+          && uep->ue_lcount == buf->b_ml.ml_line_count
+          && uep->ue_size > 0 && uep->ue_top + uep->ue_size == top) {
+        if (uep->ue_size == uep->ue_alloc) {
+          uep->ue_alloc = MAX(uep->ue_alloc * 2, 8);
+          uep->ue_array = xrealloc(uep->ue_array, sizeof(char *) * (size_t)uep->ue_alloc);
+        }
+        uep->ue_array[uep->ue_size++] = u_save_line_buf(buf, top + 1);
+        undo_undoes = false;
+        return OK;
+      }
+    }
+
     // find line number for ue_bot for previous u_save()
     u_getbot(buf);
   }
@@ -571,6 +617,7 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, int re
 #endif
 
   uep->ue_size = size;
+  uep->ue_alloc = size;
   uep->ue_top = top;
   if (newbot != 0) {
     uep->ue_bot = newbot;
@@ -635,6 +682,9 @@ int u_savecommon(buf_T *buf, linenr_T top, linenr_T bot, linenr_T newbot, int re
 // extra fields for uhp
 #define UHP_SAVE_NR            1
 
+// appended to the undo file name for writing it in the background
+#define UNDO_TMP_SUFFIX        ".tmp~"
+
 static const char e_not_open[] = N_("E828: Cannot open undo file for writing: %s");
 
 /// Compute the hash for a buffer text into hash[UNDO_HASH_SIZE].
@@ -644,6 +694,13 @@ static const char e_not_open[] = N_("E828: Cannot open undo file for writing: %s
 ///                 the hash
 void u_compute_hash(buf_T *buf, uint8_t *hash)
 {
+  // Text changes increment b:changedtick, reading a file into the buffer
+  // invalidates the cached hash.
+  if (buf->b_u_hash_valid && buf->b_u_hash_tick == buf_get_changedtick(buf)) {
+    memcpy(hash, buf->b_u_hash, UNDO_HASH_SIZE);
+    return;
+  }
+
   context_sha256_T ctx;
   sha256_start(&ctx);
   for (linenr_T lnum = 1; lnum <= buf->b_ml.ml_line_count; lnum++) {
@@ -651,6 +708,10 @@ void u_compute_hash(buf_T *buf, uint8_t *hash)
     sha256_update(&ctx, (uint8_t *)p, strlen(p) + 1);
   }
   sha256_finish(&ctx, hash);
+
+  memcpy(buf->b_u_hash, hash, UNDO_HASH_SIZE);
+  buf->b_u_hash_tick = buf_get_changedtick(buf);
+  buf->b_u_hash_valid = true;
 }
 
 /// Return an allocated string of the full path of the target undofile.
@@ -780,10 +841,9 @@ static bool serialize_header(bufinfo_T *bi, uint8_t *hash)
   FUNC_ATTR_NONNULL_ALL
 {
   buf_T *buf = bi->bi_buf;
-  FILE *fp = bi->bi_fp;
 
   // Start writing, first the magic marker and undo info version.
-  if (fwrite(UF_START_MAGIC, UF_START_MAGIC_LEN, 1, fp) != 1) {
+  if (!undo_write(bi, (uint8_t *)UF_START_MAGIC, UF_START_MAGIC_LEN)) {
     return false;
   }
 
@@ -1058,18 +1118,26 @@ static bool serialize_uep(bufinfo_T *bi, u_entry_T *uep)
   undo_write_bytes(bi, (uintmax_t)uep->ue_lcount, 4);
   undo_write_bytes(bi, (uintmax_t)uep->ue_size, 4);
 
-  for (size_t i = 0; i < (size_t)uep->ue_size; i++) {
-    size_t len = strlen(uep->ue_array[i]);
-    if (!undo_write_bytes(bi, len, 4)) {
-      return false;
-    }
-    if (len > 0 && !undo_write(bi, (uint8_t *)uep->ue_array[i], len)) {
-      return false;
-    }
-  }
-  return true;
-}
-
+  // Compressed lines are written from a copy, the entry stays compressed.
+  char *text = uep->ue_packed != NULL ? u_unpack_text(uep) : NULL;
+  size_t off = 0;
+  bool ok = true;
+  for (size_t i = 0; ok && i < (size_t)uep->ue_size; i++) {
+    char *line = text != NULL ? text + off : uep->ue_array[i];
+    size_t len = strlen(line);
+    off += len + 1;
+    ok = undo_write_bytes(bi, len, 4)
+         && (len == 0 || undo_write(bi, (uint8_t *)line, len));
+  }
+  xfree(text);
+  return ok;
+}
+
+/// Reads an undo entry.  Its lines are kept as one block of text, like
+/// u_pack_entry() does without compressing, and only get their own
+/// allocations when the entry is undone or redone.  Opening a file with a
+/// large undo file then does a few allocations for each entry instead of
+/// one for each line.
 static u_entry_T *unserialize_uep(bufinfo_T *bi, bool *error, const char *file_name)
 {
   u_entry_T *uep = xmalloc(sizeof(u_entry_T));
@@ -1081,30 +1149,38 @@ static u_entry_T *unserialize_uep(bufinfo_T *bi, bool *error, const char *file_n
   uep->ue_bot = undo_read_4c(bi);
   uep->ue_lcount = undo_read_4c(bi);
   uep->ue_size = undo_read_4c(bi);
-
-  char **array = NULL;
-  if (uep->ue_size > 0) {
-    if ((size_t)uep->ue_size < SIZE_MAX / sizeof(char *)) {
-      array = xmalloc(sizeof(char *) * (size_t)uep->ue_size);
-      memset(array, 0, sizeof(char *) * (size_t)uep->ue_size);
-    }
+  if (uep->ue_size < 0) {
+    corruption_error("entry size", file_name);
+    uep->ue_size = 0;
+    *error = true;
+    return uep;
   }
-  uep->ue_array = array;
 
-  for (size_t i = 0; i < (size_t)uep->ue_size; i++) {
+  garray_T text;
+  ga_init(&text, 1, 1024);
+  for (linenr_T i = 0; i < uep->ue_size; i++) {
     int line_len = undo_read_4c(bi);
-    char *line;
-    if (line_len >= 0) {
-      line = undo_read_string(bi, (size_t)line_len);
-    } else {
-      line = NULL;
+    bool ok = line_len >= 0;
+    if (!ok) {
       corruption_error("line length", file_name);
+    } else if (line_len > 0) {
+      ga_grow(&text, line_len);
+      ok = undo_read(bi, (uint8_t *)text.ga_data + text.ga_len, (size_t)line_len);
     }
-    if (line == NULL) {
+    if (!ok) {
+      ga_clear(&text);
+      uep->ue_size = 0;
       *error = true;
       return uep;
     }
-    array[i] = line;
+    text.ga_len += line_len;
+    ga_append(&text, NUL);
+  }
+  if (text.ga_len > 0) {
+    uep->ue_text_size = (size_t)text.ga_len;
+    uep->ue_packed_size = uep->ue_text_size;
+    uep->ue_packed = xrealloc(text.ga_data, uep->ue_text_size);
+    uep->ue_packed_raw = true;
   }
   return uep;
 }
@@ -1154,6 +1230,10 @@ static void unserialize_visualinfo(bufinfo_T *bi, visualinfo_T *info)
 
 /// Write the undo tree in an undo file.
 ///
+/// The undo tree is serialized in memory. For 'undofile' the file is then
+/// written and renamed over the old one in the libuv threadpool, so that
+/// writing the buffer does not wait for it. `:wundo` writes it right away.
+///
 /// @param[in]  name  Name of the undo file or NULL if this function needs to
 ///                   generate the undo file name based on buf->b_ffname.
 /// @param[in]  forceit  True for `:wundo!`, false otherwise.
@@ -1167,9 +1247,12 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
 #ifdef U_DEBUG
   int headers_written = 0;
 #endif
-  FILE *fp = NULL;
+  char *tmp_name = NULL;
   bool write_ok = false;
 
+  // A previous write may still be renaming its file over this one.
+  u_write_undo_wait();
+
   if (name == NULL) {
     file_name = u_get_undo_file_name(buf->b_ffname, false);
     if (file_name == NULL) {
@@ -1202,7 +1285,8 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
 
   // If the undo file already exists, verify that it actually is an undo
   // file, and delete it.
-  if (os_path_exists(file_name)) {
+  const bool exists = os_path_exists(file_name);
+  if (exists) {
     if (name == NULL || !forceit) {
       // Check we can read it and it's an undo file.
       fd = os_open(file_name, O_RDONLY, 0);
@@ -1238,24 +1322,48 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
         }
       }
     }
-    os_remove(file_name);
   }
 
   // If there is no undo information at all, quit here after deleting any
   // existing undo file.
   if (buf->b_u_numhead == 0 && buf->b_u_line_ptr == NULL) {
+    if (exists) {
+      os_remove(file_name);
+    }
     if (p_verbose > 0) {
       verb_msg(_("Skipping undo file write, nothing to undo"));
     }
     goto theend;
   }
 
-  fd = os_open(file_name, O_CREAT|O_WRONLY|O_EXCL|O_NOFOLLOW, perm);
+  // For 'undofile' write a temporary file that replaces the old one when
+  // done. If that fails, or for :wundo, write the file itself.
+  fd = -1;
+  if (name == NULL) {
+    tmp_name = concat_str(file_name, UNDO_TMP_SUFFIX);
+    fd = os_open(tmp_name, O_CREAT|O_WRONLY|O_EXCL|O_NOFOLLOW, perm);
+    if (fd == UV_EEXIST) {
+      // Left behind by a crash or a failed rename, the writes of this
+      // instance were waited for above.
+      os_remove(tmp_name);
+      fd = os_open(tmp_name, O_CREAT|O_WRONLY|O_EXCL|O_NOFOLLOW, perm);
+    }
+    if (fd < 0) {
+      XFREE_CLEAR(tmp_name);
+    }
+  }
+  if (fd < 0) {
+    if (exists) {
+      os_remove(file_name);
+    }
+    fd = os_open(file_name, O_CREAT|O_WRONLY|O_EXCL|O_NOFOLLOW, perm);
+  }
   if (fd < 0) {
     semsg(_(e_not_open), file_name);
     goto theend;
   }
-  (void)os_setperm(file_name, perm);
+  const char *const written_name = tmp_name != NULL ? tmp_name : file_name;
+  (void)os_setperm(written_name, perm);
   if (p_verbose > 0) {
     verbose_enter();
     smsg(0, _("Writing undo file: %s"), file_name);
@@ -1275,28 +1383,29 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
   FileInfo file_info_new;
   if (buf->b_ffname != NULL
       && os_fileinfo(buf->b_ffname, &file_info_old)
-      && os_fileinfo(file_name, &file_info_new)
+      && os_fileinfo(written_name, &file_info_new)
       && file_info_old.stat.st_gid != file_info_new.stat.st_gid
       && os_fchown(fd, (uv_uid_t)-1, (uv_gid_t)file_info_old.stat.st_gid)) {
-    os_setperm(file_name, (perm & 0707) | ((perm & 07) << 3));
+    os_setperm(written_name, (perm & 0707) | ((perm & 07) << 3));
   }
 #endif
 
-  fp = fdopen(fd, "w");
-  if (fp == NULL) {
-    semsg(_(e_not_open), file_name);
-    close(fd);
-    os_remove(file_name);
-    goto theend;
+  if (buf->b_ffname != NULL) {
+    // For systems that support ACL: get the ACL from the original file.
+    vim_acl_T acl = os_get_acl(buf->b_ffname);
+    os_set_acl(written_name, acl);
+    os_free_acl(acl);
   }
 
   // Undo must be synced.
   u_sync(true);
 
   // Write the header.
+  garray_T ga;
+  ga_init(&ga, 1, 4096);
   bufinfo_T bi = {
     .bi_buf = buf,
-    .bi_fp = fp,
+    .bi_ga = &ga,
   };
   if (!serialize_header(&bi, hash)) {
     goto write_error;
@@ -1343,22 +1452,42 @@ void u_write_undo(const char *const name, const bool forceit, buf_T *const buf,
   }
 #endif
 
-  if (p_fs && fflush(fp) == 0 && os_fsync(fd) != 0) {
-    write_ok = false;
+  if (write_ok && tmp_name != NULL) {
+    UndoWriteJob *job = xmalloc(sizeof(*job));
+    *job = (UndoWriteJob){
+      .fd = fd,
+      .tmp_name = tmp_name,
+      .file_name = xstrdup(file_name),
+      .data = ga,
+      .do_fsync = p_fs != 0,
+    };
+    job->req.data = job;
+    if (uv_queue_work(&main_loop.uv, &job->req, undo_write_work, undo_write_done) == 0) {
+      undo_writes_pending++;
+      goto theend;
+    }
+    xfree(job->file_name);
+    xfree(job);
+  }
+
+  if (write_ok) {
+    write_ok = os_write(fd, ga.ga_data, (size_t)ga.ga_len, false) == ga.ga_len
+               && (!p_fs || os_fsync(fd) == 0);
+  }
+  if (write_ok && tmp_name != NULL) {
+    write_ok = os_rename(tmp_name, file_name) == OK;
   }
 
 write_error:
-  fclose(fp);
+  ga_clear(&ga);
+  close(fd);
   if (!write_ok) {
+    if (tmp_name != NULL) {
+      os_remove(tmp_name);
+    }
     semsg(_(e_write_error_in_undo_file_str), file_name);
   }
-
-  if (buf->b_ffname != NULL) {
-    // For systems that support ACL: get the ACL from the original file.
-    vim_acl_T acl = os_get_acl(buf->b_ffname);
-    os_set_acl(file_name, acl);
-    os_free_acl(acl);
-  }
+  xfree(tmp_name);
 
 theend:
   if (file_name != name) {
@@ -1366,6 +1495,58 @@ theend:
   }
 }
 
+/// Writes the undo file of an UndoWriteJob, in a thread of the libuv
+/// threadpool.
+static void undo_write_work(uv_work_t *req)
+{
+  UndoWriteJob *job = req->data;
+  const size_t len = (size_t)job->data.ga_len;
+  job->write_ok = os_write(job->fd, job->data.ga_data, len, false) == (ptrdiff_t)len;
+  if (job->write_ok && job->do_fsync) {
+    uv_fs_t fs_req;
+    job->write_ok = uv_fs_fsync(NULL, &fs_req, job->fd, NULL) == 0;
+    uv_fs_req_cleanup(&fs_req);
+  }
+  job->write_ok &= close(job->fd) == 0;
+  if (job->write_ok) {
+    job->write_ok = os_rename(job->tmp_name, job->file_name) == OK;
+  }
+  if (!job->write_ok) {
+    os_remove(job->tmp_name);
+  }
+}
+
+static void undo_write_error_event(void **argv)
+{
+  char *file_name = argv[0];
+  semsg(_(e_write_error_in_undo_file_str), file_name);
+  xfree(file_name);
+}
+
+static void undo_write_done(uv_work_t *req, int status)
+{
+  UndoWriteJob *job = req->data;
+  undo_writes_pending--;
+  if (status != 0 || !job->write_ok) {
+    // This may run while waiting for the loop, give the message when it is
+    // safe to do so.
+    multiqueue_put(main_loop.events, undo_write_error_event, job->file_name);
+  } else {
+    xfree(job->file_name);
+  }
+  ga_clear(&job->data);
+  xfree(job->tmp_name);
+  xfree(job);
+}
+
+/// Wait until the undo files written in the background are done.
+void u_write_undo_wait(void)
+{
+  if (undo_writes_pending > 0) {
+    LOOP_PROCESS_EVENTS_UNTIL(&main_loop, NULL, -1, undo_writes_pending == 0);
+  }
+}
+
 /// Loads the undo tree from an undo file.
 /// If "name" is not NULL use it as the undo file name. This also means being
 /// a bit more verbose.
@@ -1406,6 +1587,9 @@ void u_read_undo(char *name, const uint8_t *hash, const char *orig_name FUNC_ATT
     file_name = name;
   }
 
+  // The file may still be written in the background.
+  u_write_undo_wait();
+
   if (p_verbose > 0) {
     verbose_enter();
     smsg(0, _("Reading undo file: %s"), file_name);
@@ -1680,7 +1864,8 @@ theend:
 static bool undo_write(bufinfo_T *bi, uint8_t *ptr, size_t len)
   FUNC_ATTR_NONNULL_ARG(1)
 {
-  return fwrite(ptr, len, 1, bi->bi_fp) == 1;
+  ga_concat_len(bi->bi_ga, (char *)ptr, len);
+  return true;
 }
 
 /// Writes a number, most significant bit first, in "len" bytes.
@@ -2282,6 +2467,7 @@ static void u_undoredo(int undo, bool do_buf_event)
   curbuf->b_op_end.col = 0;
 
   for (u_entry_T *uep = curhead->uh_entry; uep != NULL; uep = nuep) {
+    u_unpack_entry(curbuf, uep);
     linenr_T top = uep->ue_top;
     linenr_T bot = uep->ue_bot;
     if (bot == 0) {
@@ -2398,6 +2584,7 @@ static void u_undoredo(int undo, bool do_buf_event)
     u_newcount += newsize;
     u_oldcount += oldsize;
     uep->ue_size = oldsize;
+    uep->ue_alloc = oldsize;
     uep->ue_array = newarray;
     uep->ue_bot = top + newsize + 1;
 
@@ -2778,6 +2965,7 @@ void u_find_first_changed(void)
   if (uep->ue_top != 0 || uep->ue_bot != 0) {
     return;
   }
+  u_unpack_entry(curbuf, uep);
 
   linenr_T lnum;
   for (lnum = 1; lnum < curbuf->b_ml.ml_line_count
@@ -2833,6 +3021,160 @@ static u_entry_T *u_get_headentry(buf_T *buf)
   return buf->b_u_newhead->uh_entry;
 }
 
+/// Minimum number of lines in an undo entry for u_dedup_entry() to look for
+/// lines that did not change.
+enum { UNDO_DEDUP_MIN_LINES = 32, };
+
+/// Hunk found by xdl_diff() for u_dedup_entry(), "start" and "count" of the
+/// saved lines ("a") and of the current lines ("b").
+typedef struct {
+  int start_a;
+  int count_a;
+  int start_b;
+  int count_b;
+} undo_hunk_T;
+
+static int u_dedup_hunk(int start_a, int count_a, int start_b, int count_b, void *priv)
+{
+  GA_APPEND(undo_hunk_T, (garray_T *)priv, ((undo_hunk_T){
+    .start_a = start_a,
+    .count_a = count_a,
+    .start_b = start_b,
+    .count_b = count_b,
+  }));
+  return 0;
+}
+
+/// Append a line of "len" bytes at "line" to "ga" for diffing it, as a hash
+/// in hex, so that a NL in the line does not matter.
+static void u_dedup_add_line(garray_T *ga, const char *line, size_t len)
+{
+  uint64_t h = 14695981039346656037ULL;  // FNV-1a
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ (uint8_t)line[i]) * 1099511628211ULL;
+  }
+  char hex[18];
+  snprintf(hex, sizeof(hex), "%016" PRIx64 "\n", h);
+  ga_concat_len(ga, hex, 17);
+}
+
+/// Drop the lines that did not change from the first entry of the newest
+/// undo header "uhp" of buffer "buf", which must be synced and not undone,
+/// so that the buffer text is what undoing the entry starts from.
+///
+/// A command that replaces all lines of the buffer, like a formatter, saves
+/// all of them. They are compared with the current lines, and the entry is
+/// replaced by one entry for each changed range, from the bottom up so that
+/// the line numbers of the ranges above stay valid when undoing.
+static void u_dedup_entry(buf_T *buf, u_header_T *uhp)
+{
+  u_entry_T *uep = uhp->uh_entry;
+  if (uep == NULL || uep->ue_array == NULL || uep->ue_size < UNDO_DEDUP_MIN_LINES
+      || uhp->uh_getbot_entry != NULL) {
+    return;
+  }
+  const linenr_T top = uep->ue_top;
+  const linenr_T bot = uep->ue_bot == 0 ? buf->b_ml.ml_line_count + 1 : uep->ue_bot;
+  if (top < 0 || top >= bot || bot > buf->b_ml.ml_line_count + 1) {
+    return;
+  }
+  const int count_cur = (int)(bot - top - 1);
+
+  garray_T ga_a;
+  garray_T ga_b;
+  garray_T hunks;
+  ga_init(&ga_a, 1, (int)uep->ue_size * 17);
+  ga_init(&ga_b, 1, count_cur * 17 + 1);
+  ga_init(&hunks, (int)sizeof(undo_hunk_T), 16);
+  for (linenr_T i = 0; i < uep->ue_size; i++) {
+    u_dedup_add_line(&ga_a, uep->ue_array[i], strlen(uep->ue_array[i]));
+  }
+  for (linenr_T lnum = top + 1; lnum < bot; lnum++) {
+    const char *line = ml_get_buf(buf, lnum);
+    u_dedup_add_line(&ga_b, line, strlen(line));
+  }
+
+  mmfile_t ma = { .ptr = ga_a.ga_data, .size = ga_a.ga_len };
+  mmfile_t mb = { .ptr = ga_b.ga_data, .size = ga_b.ga_len };
+  xpparam_t param;
+  xdemitconf_t emit_cfg;
+  xdemitcb_t emit_cb;
+  CLEAR_FIELD(param);
+  CLEAR_FIELD(emit_cfg);
+  CLEAR_FIELD(emit_cb);
+  emit_cfg.hunk_func = u_dedup_hunk;
+  emit_cb.priv = &hunks;
+  bool ok = xdl_diff(&ma, &mb, &param, &emit_cfg, &emit_cb) >= 0;
+  ga_clear(&ga_a);
+  ga_clear(&ga_b);
+
+  // Nothing to gain when almost all lines changed.  Also check that the
+  // lines between the hunks are really the same, not only their hash.
+  undo_hunk_T *hp = hunks.ga_data;
+  int changed = 0;
+  for (int h = 0; ok && h < hunks.ga_len; h++) {
+    changed += hp[h].count_a;
+  }
+  ok = ok && changed < uep->ue_size / 2;
+  int ia = 0;
+  int ib = 0;
+  for (int h = 0; ok && h <= hunks.ga_len; h++) {
+    const int end_a = h < hunks.ga_len ? hp[h].start_a : (int)uep->ue_size;
+    const int end_b = h < hunks.ga_len ? hp[h].start_b : count_cur;
+    if (end_a - ia != end_b - ib) {
+      ok = false;
+      break;
+    }
+    for (; ia < end_a; ia++, ib++) {
+      if (strcmp(uep->ue_array[ia], ml_get_buf(buf, top + 1 + ib)) != 0) {
+        ok = false;
+        break;
+      }
+    }
+    if (ok && h < hunks.ga_len) {
+      ia += hp[h].count_a;
+      ib += hp[h].count_b;
+    }
+  }
+  if (!ok) {
+    ga_clear(&hunks);
+    return;
+  }
+
+  // One entry for each hunk, the last one first.  With no hunk at all a
+  // single entry that changes nothing.
+  u_entry_T *first = NULL;
+  u_entry_T **next = &first;
+  for (int h = hunks.ga_len - 1; h >= -1; h--) {
+    if (h < 0 && first != NULL) {
+      break;
+    }
+    undo_hunk_T hunk = h >= 0 ? hp[h] : (undo_hunk_T){ 0 };
+    u_entry_T *nuep = xmalloc(sizeof(u_entry_T));
+    CLEAR_POINTER(nuep);
+#ifdef U_DEBUG
+    nuep->ue_magic = UE_MAGIC;
+#endif
+    nuep->ue_top = top + hunk.start_b;
+    nuep->ue_bot = top + hunk.start_b + hunk.count_b + 1;
+    nuep->ue_lcount = uep->ue_lcount;
+    nuep->ue_size = hunk.count_a;
+    nuep->ue_alloc = hunk.count_a;
+    if (hunk.count_a > 0) {
+      nuep->ue_array = xmalloc(sizeof(char *) * (size_t)hunk.count_a);
+      memcpy(nuep->ue_array, uep->ue_array + hunk.start_a, sizeof(char *) * (size_t)hunk.count_a);
+      memset(uep->ue_array + hunk.start_a, 0, sizeof(char *) * (size_t)hunk.count_a);
+    }
+    *next = nuep;
+    next = &nuep->ue_next;
+  }
+  *next = uep->ue_next;
+  uhp->uh_entry = first;
+  // Lines moved to the new entries were cleared, free the others.
+  u_freeentry(uep, uep->ue_size);
+  ga_clear(&hunks);
+}
+
 /// u_getbot(): compute the line number of the previous u_save
 ///              It is called only when b_u_synced is false.
 static void u_getbot(buf_T *buf)
@@ -2961,6 +3303,10 @@ static void u_freeentries(buf_T *buf, u_header_T *uhp, u_header_T **uhpp)
 /// free entry 'uep' and 'n' lines in uep->ue_array[]
 static void u_freeentry(u_entry_T *uep, int n)
 {
+  if (uep->ue_array == NULL) {
+    xfree(uep->ue_packed);
+    n = 0;
+  }
   while (n > 0) {
     xfree(uep->ue_array[--n]);
   }
@@ -2971,6 +3317,182 @@ static void u_freeentry(u_entry_T *uep, int n)
   xfree(uep);
 }
 
+/// Size of the undo text of entry "uep" that is not compressed.
+static size_t u_entry_mem(u_entry_T *uep)
+{
+  if (uep->ue_array == NULL) {
+    return uep->ue_packed_raw ? uep->ue_text_size : 0;
+  }
+  size_t size = sizeof(char *) * (size_t)uep->ue_alloc;
+  for (linenr_T i = 0; i < uep->ue_size; i++) {
+    size += strlen(uep->ue_array[i]) + 1;
+  }
+  return size;
+}
+
+/// Compress the lines of entry "uep", if that saves a useful amount of
+/// memory.  Also when they are one block of text as read from the undo
+/// file.
+static void u_pack_entry(u_entry_T *uep)
+{
+  if (uep->ue_size == 0 || u_entry_mem(uep) == 0) {
+    return;  // no lines or already compressed
+  }
+  size_t size;
+  char *text;
+  if (uep->ue_array == NULL) {
+    size = uep->ue_text_size;
+    text = (char *)uep->ue_packed;
+  } else {
+    size = 0;
+    for (linenr_T i = 0; i < uep->ue_size; i++) {
+      size += strlen(uep->ue_array[i]) + 1;
+    }
+    text = xmalloc(size);
+    char *p = text;
+    for (linenr_T i = 0; i < uep->ue_size; i++) {
+      size_t len = strlen(uep->ue_array[i]) + 1;
+      memcpy(p, uep->ue_array[i], len);
+      p += len;
+    }
+  }
+  // Like for memfile blocks, require saving at least an eighth.
+  size_t max_size = size - size / 8;
+  uint8_t *packed = xmalloc(max_size);
+  size_t packed_size = mf_lz_compress((uint8_t *)text, size, packed, max_size);
+  if (uep->ue_array != NULL) {
+    xfree(text);
+  }
+  if (packed_size == 0) {
+    xfree(packed);
+    return;
+  }
+  if (uep->ue_array == NULL) {
+    xfree(uep->ue_packed);
+  } else {
+    for (linenr_T i = 0; i < uep->ue_size; i++) {
+      xfree(uep->ue_array[i]);
+    }
+    XFREE_CLEAR(uep->ue_array);
+  }
+  uep->ue_packed = xrealloc(packed, packed_size);
+  uep->ue_packed_size = packed_size;
+  uep->ue_packed_raw = false;
+  uep->ue_text_size = size;
+  g_stats.undo_pack++;
+}
+
+/// Decompress the lines of entry "uep" compressed by u_pack_entry(), or copy
+/// them when read by unserialize_uep().
+///
+/// @return  the lines with their NULs, "uep->ue_text_size" bytes.
+static char *u_unpack_text(u_entry_T *uep)
+{
+  char *text = xmalloc(uep->ue_text_size);
+  if (uep->ue_packed_raw) {
+    // Not compressed, see unserialize_uep().
+    memcpy(text, uep->ue_packed, uep->ue_text_size);
+  } else if (!mf_lz_decompress(uep->ue_packed, uep->ue_packed_size, (uint8_t *)text, uep->ue_text_size)) {
+    siemsg("Corrupted compressed undo entry");
+    memset(text, NUL, uep->ue_text_size);
+  }
+  return text;
+}
+
+/// Make the lines of entry "uep" of buffer "buf" available in "ue_array"
+/// again, when it was compressed by u_pack_entry() or read from the undo
+/// file.
+static void u_unpack_entry(buf_T *buf, u_entry_T *uep)
+{
+  if (uep->ue_array != NULL || uep->ue_packed == NULL) {
+    return;
+  }
+  char *text = u_unpack_text(uep);
+  uep->ue_array = xmalloc(sizeof(char *) * (size_t)uep->ue_size);
+  uep->ue_alloc = uep->ue_size;
+  char *p = text;
+  for (linenr_T i = 0; i < uep->ue_size; i++) {
+    // The text is all zero when corrupted, never go past it.
+    uep->ue_array[i] = xstrdup(p < text + uep->ue_text_size ? p : "");
+    p += strlen(uep->ue_array[i]) + 1;
+  }
+  xfree(text);
+  XFREE_CLEAR(uep->ue_packed);
+  buf->b_u_mem += uep->ue_text_size;
+}
+
+/// For 'maxmemundo': when the undo text of buffer "buf" may be over the
+/// limit, compress the text of the oldest undo headers until it is down to
+/// three quarters of the limit.  The newest header, which may still get
+/// entries, and the current one are not compressed.
+///
+/// The amount of undo text is updated when text is saved, not when it is
+/// freed, and counted again here.  Next time is when the text that was
+/// saved since has reached a quarter of the limit.
+static void u_check_mem(buf_T *buf)
+{
+  const size_t limit = (size_t)MAX(p_mmu, 0) * 1024;
+  if (limit == 0 || buf->b_u_mem <= MAX(buf->b_u_mem_limit, limit)) {
+    return;
+  }
+
+  // Collect all headers by walking the tree, see u_write_undo().
+  kvec_t(u_header_T *) headers = KV_INITIAL_VALUE;
+  int mark = ++lastmark;
+  u_header_T *uhp = buf->b_u_oldhead;
+  while (uhp != NULL) {
+    if (uhp->uh_walk != mark) {
+      uhp->uh_walk = mark;
+      kv_push(headers, uhp);
+    }
+    if (uhp->uh_prev.ptr != NULL && uhp->uh_prev.ptr->uh_walk != mark) {
+      uhp = uhp->uh_prev.ptr;
+    } else if (uhp->uh_alt_next.ptr != NULL
+               && uhp->uh_alt_next.ptr->uh_walk != mark) {
+      uhp = uhp->uh_alt_next.ptr;
+    } else if (uhp->uh_next.ptr != NULL && uhp->uh_alt_prev.ptr == NULL
+               && uhp->uh_next.ptr->uh_walk != mark) {
+      uhp = uhp->uh_next.ptr;
+    } else if (uhp->uh_alt_prev.ptr != NULL) {
+      uhp = uhp->uh_alt_prev.ptr;
+    } else {
+      uhp = uhp->uh_next.ptr;
+    }
+  }
+
+  size_t mem = 0;
+  for (size_t i = 0; i < kv_size(headers); i++) {
+    for (u_entry_T *uep = kv_A(headers, i)->uh_entry; uep != NULL; uep = uep->ue_next) {
+      mem += u_entry_mem(uep);
+    }
+  }
+  if (mem > limit) {
+    qsort(headers.items, kv_size(headers), sizeof(u_header_T *), u_header_seq_cmp);
+    for (size_t i = 0; i < kv_size(headers) && mem > limit - limit / 4; i++) {
+      uhp = kv_A(headers, i);
+      if (uhp == buf->b_u_newhead || uhp == buf->b_u_curhead) {
+        continue;
+      }
+      for (u_entry_T *uep = uhp->uh_entry; uep != NULL; uep = uep->ue_next) {
+        size_t size = u_entry_mem(uep);
+        u_pack_entry(uep);
+        mem -= size - u_entry_mem(uep);
+      }
+    }
+  }
+  kv_destroy(headers);
+
+  buf->b_u_mem = mem;
+  buf->b_u_mem_limit = mem + limit / 4;
+}
+
+static int u_header_seq_cmp(const void *a, const void *b)
+{
+  const int seq_a = (*(const u_header_T *const *)a)->uh_seq;
+  const int seq_b = (*(const u_header_T *const *)b)->uh_seq;
+  return seq_a == seq_b ? 0 : seq_a < seq_b ? -1 : 1;
+}
+
 /// invalidate the undo buffer; called when storage has already been released
 void u_clearall(buf_T *buf)
 {
@@ -2979,6 +3501,8 @@ void u_clearall(buf_T *buf)
   buf->b_u_numhead = 0;
   buf->b_u_line_ptr = NULL;
   buf->b_u_line_lnum = 0;
+  buf->b_u_mem = 0;
+  buf->b_u_mem_limit = 0;
 }
 
 /// Save the line "lnum" for the "U" command.
@@ -3059,6 +3583,8 @@ void u_blockfree(buf_T *buf)
     assert(buf->b_u_oldhead != previous_oldhead);
   }
   xfree(buf->b_u_line_ptr);
+  buf->b_u_mem = 0;
+  buf->b_u_mem_limit = 0;
 }
 
 /// Allocate memory and copy curbuf line into it.
@@ -3075,7 +3601,9 @@ static char *u_save_line(linenr_T lnum)
 /// @param buf buffer to copy from
 static char *u_save_line_buf(buf_T *buf, linenr_T lnum)
 {
-  return xstrdup(ml_get_buf(buf, lnum));
+  char *line = xstrdup(ml_get_buf(buf, lnum));
+  buf->b_u_mem += strlen(line) + 1;
+  return line;
 }
 
 /// Check if the 'modified' flag is set, or 'ff' has changed (only need to
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 #include "nvim/extmark_defs.h"
@@ -26,6 +29,12 @@ struct u_entry {
   linenr_T ue_lcount;  ///< linecount when u_save called
   char **ue_array;     ///< array of lines in undo block
   linenr_T ue_size;    ///< number of lines in ue_array
+  linenr_T ue_alloc;   ///< number of allocated lines in ue_array
+  uint8_t *ue_packed;  ///< lines when ue_array is NULL, compressed by u_pack_entry(), or
+                       ///< as read by unserialize_uep() when ue_packed_raw is set
+  size_t ue_packed_size;
+  bool ue_packed_raw;   ///< ue_packed is not compressed
+  size_t ue_text_size;  ///< size of the lines with their NULs
 #ifdef U_DEBUG
   int ue_magic;        ///< magic number to check allocation
 #endif
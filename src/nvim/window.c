@@ -2535,10 +2535,18 @@ static bool close_last_window_tabpage(win_T *win, bool free_buf, tabpage_T *prev
   // that now.
   apply_autocmds(EVENT_WINENTER, NULL, NULL, false, curbuf);
   apply_autocmds(EVENT_TABENTER, NULL, NULL, false, curbuf);
-  if (old_curbuf != curbuf) {
+  tabpage_buf_enter(old_curbuf);
+  return true;
+}
+
+/// Triggers BufEnter after entering a tab page, when its buffer is not
+/// "old_curbuf".  A buffer that was not loaded because of 'lazytabpages' is
+/// loaded now, which triggers BufEnter as well.
+static void tabpage_buf_enter(buf_T *old_curbuf)
+{
+  if (!curbuf_load_deferred() && old_curbuf != curbuf) {
     apply_autocmds(EVENT_BUFENTER, NULL, NULL, false, curbuf);
   }
-  return true;
 }
 
 /// Close the buffer of "win" and unload it if "action" is DOBUF_UNLOAD.
@@ -4282,9 +4290,7 @@ static void enter_tabpage(tabpage_T *tp, buf_T *old_curbuf, bool trigger_enter_a
   // 'columns' have been set correctly.
   if (trigger_enter_autocmds) {
     apply_autocmds(EVENT_TABENTER, NULL, NULL, false, curbuf);
-    if (old_curbuf != curbuf) {
-      apply_autocmds(EVENT_BUFENTER, NULL, NULL, false, curbuf);
-    }
+    tabpage_buf_enter(old_curbuf);
   }
 
   redraw_all_later(UPD_NOT_VALID);
@@ -4767,7 +4773,7 @@ static void win_enter_ext(win_T *const wp, const int flags)
   }
   if (flags & WEE_TRIGGER_ENTER_AUTOCMDS) {
     apply_autocmds(EVENT_WINENTER, NULL, NULL, false, curbuf);
-    if (other_buffer) {
+    if (!curbuf_load_deferred() && other_buffer) {
       apply_autocmds(EVENT_BUFENTER, NULL, NULL, false, curbuf);
     }
   }
@@ -5001,6 +5007,8 @@ void win_free(win_T *wp, tabpage_T *tp)
 
   xfree(wp->w_p_lcs_chars.multispace);
   xfree(wp->w_p_lcs_chars.leadmultispace);
+  kv_destroy(wp->w_vcol_cache.points);
+  kv_destroy(wp->w_hl_cache.attrs);
 
   vars_clear(&wp->w_vars->dv_hashtab);          // free all w: variables
   hash_init(&wp->w_vars->dv_hashtab);
@@ -5672,7 +5680,7 @@ void win_setheight_win(int height, win_T *win)
 
     win_fix_scroll(true);
 
-    redraw_all_later(UPD_NOT_VALID);
+    win_layout_redraw_later();
     redraw_cmdline = true;
   }
 }
@@ -5867,6 +5875,17 @@ void win_setwidth_win(int width, win_T *wp)
 
     // recompute the window positions
     (void)win_comp_pos();
+    win_layout_redraw_later();
+  }
+}
+
+/// Redraw after resizing windows in the current tab page. Windows that changed
+/// size or position were already marked for redraw by win_set_inner_size() and
+/// frame_comp_pos(), the others keep their contents. Only with a global
+/// statusline the separator connectors of the other windows may change.
+static void win_layout_redraw_later(void)
+{
+  if (global_stl_height() > 0) {
     redraw_all_later(UPD_NOT_VALID);
   }
 }
@@ -6557,7 +6576,14 @@ void win_set_inner_size(win_T *wp, bool valid_cursor)
 void win_new_width(win_T *wp, int width)
 {
   // Should we give an error if width < 0?
-  wp->w_width = width < 0 ? 0 : width;
+  if (width < 0) {
+    width = 0;
+  }
+  if (wp->w_width == width) {
+    return;  // nothing to do
+  }
+
+  wp->w_width = width;
   wp->w_pos_changed = true;
   win_set_inner_size(wp, true);
 }
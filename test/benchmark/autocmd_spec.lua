@@ -115,6 +115,33 @@ describe('autocmd perf', function()
     )
   end)
 
+  it('nvim_exec_autocmds (stats)', function()
+    exec_lua(
+      [[
+      local N = ...
+
+      for i = 1, N do
+        vim.api.nvim_create_autocmd('User', {
+          pattern = i % 2 == 0 and 'Benchmark' or '*.bench',
+          command = 'eval 0', -- noop
+        })
+      end
+
+      start()
+        vim.api.nvim_exec_autocmds('User', { pattern = 'Benchmark', modeline = false })
+      stop('nvim_exec_autocmds')
+
+      local calls, time = 0, 0
+      for _, au in ipairs(vim.api.nvim_get_autocmds({ event = 'User', stats = true })) do
+        calls = calls + au.calls
+        time = time + au.time
+      end
+      out[#out+1] = ('%14.6f ms - %d autocmds executed'):format(time / 1000000, calls)
+    ]],
+      N
+    )
+  end)
+
   it('nvim_del_augroup_by_id', function()
     exec_lua(
       [[
@@ -0,0 +1,161 @@
+-- Benchmark for the throughput of API calls.
+--
+-- Each call is made in two ways:
+--   "lua": from Lua in the Nvim process, through vim.api, which measures the
+--          conversion from and to Lua objects (nlua_pop_Object and friends).
+--   "rpc": by this test process, a msgpack-RPC client talking to Nvim over a
+--          pipe, which adds the unpacker, the dispatch and
+--          serialize_response.
+-- The payload is a list of 64-byte lines. Its size is swept over
+-- payload_sizes, for the calls whose cost depends on it. Rows of the results
+-- ($NVIM_BENCH_API_OUT):
+--   { call = ..., mode = ..., bytes = N, calls = N, ms = ...,
+--     calls_per_sec = ..., bytes_per_sec = ... }
+
+local helpers = require('test.functional.helpers')(after_each)
+local bench = require('test.benchmark.helpers')
+local clear, exec_lua, request = helpers.clear, helpers.exec_lua, helpers.request
+
+-- Payload sizes in bytes.
+local payload_sizes = { 64, 4096, 262144 }
+-- Bytes moved by the calls for one size; the number of calls is derived from
+-- this, within call_limits.
+local bytes_per_run = 16 * 1024 * 1024
+local call_limits = { 20, 10000 }
+
+local results = {}
+
+local function payload(size)
+  local lines = {}
+  for i = 1, math.max(math.floor(size / 64), 1) do
+    lines[i] = ('%063d'):format(i)
+  end
+  return lines
+end
+
+local function call_count(size)
+  return math.min(math.max(math.floor(bytes_per_run / math.max(size, 64)), call_limits[1]), call_limits[2])
+end
+
+-- Calls, each with its arguments for a payload. A size of 0 means that the
+-- call doesn't take a payload. "before" prepares the buffer.
+local calls = {
+  {
+    name = 'nvim_buf_set_lines',
+    sizes = payload_sizes,
+    args = function(lines)
+      return { 0, 0, -1, true, lines }
+    end,
+  },
+  {
+    name = 'nvim_buf_get_lines',
+    sizes = payload_sizes,
+    before = function(lines)
+      request('nvim_buf_set_lines', 0, 0, -1, true, lines)
+    end,
+    args = function()
+      return { 0, 0, -1, true }
+    end,
+  },
+  {
+    name = 'nvim_buf_set_extmark',
+    sizes = { 0 },
+    before = function()
+      request('nvim_buf_set_lines', 0, 0, -1, true, payload(4096))
+    end,
+    args = function()
+      return { 0, request('nvim_create_namespace', 'bench_api'), 10, 0, {} }
+    end,
+  },
+  {
+    name = 'nvim_call_function',
+    sizes = payload_sizes,
+    args = function(lines)
+      return { 'len', { lines } }
+    end,
+  },
+  {
+    name = 'nvim_exec_lua',
+    sizes = payload_sizes,
+    args = function(lines)
+      return { 'return #(...)', { lines } }
+    end,
+  },
+}
+
+local function record(call, mode, size, n, ms)
+  table.insert(results, {
+    call = call,
+    mode = mode,
+    bytes = size,
+    calls = n,
+    ms = ms,
+    calls_per_sec = ms > 0 and n / (ms / 1000) or 0,
+    bytes_per_sec = ms > 0 and size * n / (ms / 1000) or 0,
+  })
+end
+
+local function measure_lua(call, args, size, n)
+  local ms = exec_lua(
+    [[
+    local name, args, n = ...
+    local f = vim.api[name]
+    local t0 = vim.uv.hrtime()
+    for _ = 1, n do
+      f(unpack(args))
+    end
+    return (vim.uv.hrtime() - t0) / 1e6
+  ]],
+    call,
+    args,
+    n
+  )
+  record(call, 'lua', size, n, ms)
+end
+
+local function measure_rpc(call, args, size, n)
+  local t0 = vim.uv.hrtime()
+  for _ = 1, n do
+    request(call, unpack(args))
+  end
+  record(call, 'rpc', size, n, (vim.uv.hrtime() - t0) / 1e6)
+end
+
+describe('API throughput', function()
+  before_each(function()
+    clear()
+  end)
+
+  teardown(function()
+    bench.report('NVIM_BENCH_API_OUT', results, {
+      { 'call', '%-22s', 'call' },
+      { 'mode', '%4s', 'mode' },
+      { 'bytes', '%8d', 'bytes' },
+      { 'calls', '%7d', 'calls' },
+      { 'ms', '%10.3f', 'ms' },
+      { 'calls/sec', '%12.0f', 'calls_per_sec' },
+      {
+        'MB/s',
+        '%10.3f',
+        function(r)
+          return r.bytes_per_sec / 1e6
+        end,
+      },
+    })
+  end)
+
+  for _, c in ipairs(calls) do
+    it(c.name, function()
+      for _, size in ipairs(c.sizes) do
+        local lines = payload(size)
+        if c.before then
+          c.before(lines)
+        end
+        local args = c.args(lines)
+        local n = call_count(size)
+        measure_lua(c.name, args, size, n)
+        measure_rpc(c.name, args, size, n)
+      end
+    end)
+  end
+end)
@@ -0,0 +1,167 @@
+-- Benchmark for extmarks, that is marktree.c at scale.
+--
+-- Each workload runs on a buffer holding $NVIM_BENCH_MARKTREE_MARKS marks
+-- (default 100000), a third of them with an end position. The workloads go
+-- through the API so that they exercise the same paths as plugins:
+--   "put":     nvim_buf_set_extmark() for every mark (marktree_put).
+--   "splice":  one-character edits at random positions, as typing does
+--              (extmark_splice -> marktree_splice).
+--   "overlap": nvim_buf_get_extmarks() with "overlap" for a screenful of
+--              lines, as redraw queries them (marktree_itr_get_overlap).
+--   "delete":  deleting random marks and adding them again
+--              (marktree_del_itr and marktree_put).
+-- Rows of the results ($NVIM_BENCH_MARKTREE_OUT):
+--   { workload = ..., marks = N, ops = N, ms = ..., ops_per_sec = ...,
+--     bytes_per_mark = ... }
+-- "bytes_per_mark" is the "marktree" size from nvim__memory_stats() after the
+-- workload, divided by the number of marks.
+
+local helpers = require('test.functional.helpers')(after_each)
+local bench = require('test.benchmark.helpers')
+local clear, exec_lua = helpers.clear, helpers.exec_lua
+
+local marks = tonumber(os.getenv('NVIM_BENCH_MARKTREE_MARKS')) or 100000
+-- Number of buffer lines, so that there are about ten marks per line.
+local lines = math.max(math.floor(marks / 10), 1)
+-- Number of operations for the workloads after "put".
+local ops = 20000
+
+local results = {}
+
+--- Sets up the buffer and the random number generator in the child.
+local function setup_buffer()
+  exec_lua(
+    [[
+    local lines = ...
+    local text = {}
+    for i = 1, lines do
+      text[i] = ('%6d abcdefghijklmnopqrstuvwxyz abcdefghijklmnopqrstuvwxyz'):format(i)
+    end
+    vim.api.nvim_buf_set_lines(0, 0, -1, true, text)
+    vim.bo.undolevels = -1
+    _G.ns = vim.api.nvim_create_namespace('bench_marktree')
+    math.randomseed(42)
+  ]],
+    lines
+  )
+end
+
+--- Runs "code" in the child, which gets "marks", "lines" and "ops" and
+--- returns the number of operations done. Records the time it took.
+local function measure(name, code)
+  local r = exec_lua(
+    [[
+    local code, marks, lines, ops = ...
+    local f = assert(loadstring(code))
+    local t0 = vim.uv.hrtime()
+    local n = f(marks, lines, ops)
+    local ms = (vim.uv.hrtime() - t0) / 1e6
+    local mem = vim.api.nvim__memory_stats().marktree
+    return { n, ms, mem }
+  ]],
+    code,
+    marks,
+    lines,
+    ops
+  )
+  local n, ms, mem = r[1], r[2], r[3]
+  table.insert(results, {
+    workload = name,
+    marks = marks,
+    ops = n,
+    ms = ms,
+    ops_per_sec = ms > 0 and n / (ms / 1000) or 0,
+    bytes_per_mark = mem / marks,
+  })
+end
+
+local put = [[
+  local marks, lines = ...
+  for i = 1, marks do
+    local row = math.random(0, lines - 1)
+    local col = math.random(0, 60)
+    local opts = { id = i }
+    if i % 3 == 0 then
+      opts.end_row = math.min(row + math.random(0, 3), lines - 1)
+      opts.end_col = 0
+    end
+    vim.api.nvim_buf_set_extmark(0, _G.ns, row, col, opts)
+  end
+  return marks
+]]
+
+describe('extmarks', function()
+  before_each(function()
+    clear()
+    setup_buffer()
+  end)
+
+  teardown(function()
+    bench.report('NVIM_BENCH_MARKTREE_OUT', results, {
+      { 'workload', '%-10s', 'workload' },
+      { 'marks', '%9d', 'marks' },
+      { 'ops', '%8d', 'ops' },
+      { 'ms', '%10.3f', 'ms' },
+      { 'ops/sec', '%12.0f', 'ops_per_sec' },
+      { 'bytes/mark', '%10.1f', 'bytes_per_mark' },
+    })
+  end)
+
+  it('put', function()
+    measure('put', put)
+  end)
+
+  it('splice', function()
+    exec_lua(put, marks, lines)
+    measure(
+      'splice',
+      [[
+      local _, lines, ops = ...
+      for _ = 1, ops do
+        local row = math.random(0, lines - 1)
+        -- Far enough from the end of the line that deletes can't run out.
+        local col = math.random(0, 40)
+        if math.random(2) == 1 then
+          vim.api.nvim_buf_set_text(0, row, col, row, col, { 'x' })
+        else
+          vim.api.nvim_buf_set_text(0, row, col, row, col + 1, {})
+        end
+      end
+      return ops
+    ]]
+    )
+  end)
+
+  it('overlap', function()
+    exec_lua(put, marks, lines)
+    measure(
+      'overlap',
+      [[
+      local _, lines, ops = ...
+      local height = 50
+      for _ = 1, ops do
+        local row = math.random(0, math.max(lines - height, 1) - 1)
+        vim.api.nvim_buf_get_extmarks(0, _G.ns, { row, 0 }, { row + height, -1 }, { overlap = true })
+      end
+      return ops
+    ]]
+    )
+  end)
+
+  it('delete', function()
+    exec_lua(put, marks, lines)
+    measure(
+      'delete',
+      [[
+      local marks, lines, ops = ...
+      for _ = 1, ops do
+        local id = math.random(1, marks)
+        vim.api.nvim_buf_del_extmark(0, _G.ns, id)
+        local row = math.random(0, lines - 1)
+        vim.api.nvim_buf_set_extmark(0, _G.ns, row, math.random(0, 60), { id = id })
+      end
+      return ops * 2
+    ]]
+    )
+  end)
+end)
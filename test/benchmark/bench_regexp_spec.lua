@@ -1,8 +1,10 @@
 -- Test for benchmarking the RE engine.
 
 local helpers = require('test.functional.helpers')(after_each)
+local bench = require('test.benchmark.helpers')
 local insert, source = helpers.insert, helpers.source
 local clear, command = helpers.clear, helpers.command
+local eq, exec_lua, meths = helpers.eq, helpers.exec_lua, helpers.meths
 
 -- Temporary file for gathering benchmarking results for each regexp engine.
 local result_file = 'benchmark.out'
@@ -61,3 +63,160 @@ describe('regexp search', function()
     command('write')
   end)
 end)
+
+-- Per-pattern timings for the backtracking (re=1) and NFA (re=2) engines.
+-- Rows of the results ($NVIM_BENCH_REGEXP_OUT):
+--   { group = ..., pattern = ..., engine = 1 or 2, matches = N,
+--     min_ms = ..., median_ms = ..., timed_out = bool }
+describe('regexp engines', function()
+  -- Number of runs per pattern and engine.
+  local N = 5
+  -- Timeout for one search() call, in msec.
+  local timeout = 2000
+  -- Stop counting after this many matches.
+  local max_matches = 10000
+
+  local corpus = {
+    -- Code-search patterns, run over C source.
+    code = {
+      file = 'src/nvim/regexp.c',
+      patterns = {
+        [[vim_regexec]],
+        [[\<static\>]],
+        [[\<int\s\+\w\+(]],
+        [[\csTaTe]],
+        [[\<\(if\|else\|while\|for\|return\)\>]],
+        [[^\s*//.*TODO]],
+        [[\w\+_T\s*\*\w\+]],
+        [[\(reg\|nfa\)_\w*match\w*]],
+        [[\<[A-Z_]\{4,}\>]],
+        [[=\s*\d\+;]],
+      },
+    },
+    -- Patterns like the ones used by syntax files.
+    syntax = {
+      file = 'src/nvim/regexp.c',
+      patterns = {
+        [[/\*\_.\{-}\*/]],
+        [["\([^"\\]\|\\.\)*"]],
+        [[^\s*#\s*\(include\|define\|if\|ifdef\|endif\)\>]],
+        [[\<\d\+\(\.\d*\)\=\([eE][-+]\=\d\+\)\=\>]],
+        [[\<0x\x\+\>]],
+        [['\(\\.\|[^'\\]\)']],
+        [[\%(^\|[^\\]\)\zs\\[nrt]]],
+        [[\s\+$]],
+        [[\(\w\+\)\s*(\_[^)]*)\s*\n\s*{]],
+        [[\v<(struct|union|enum)\s+\w+>]],
+      },
+    },
+    -- Patterns with a lot of backtracking.
+    pathological = {
+      lines = {
+        string.rep('a', 20),
+        string.rep('ab', 20),
+        string.rep('x', 200) .. '=',
+        string.rep('aaaa bbbb ', 20),
+      },
+      patterns = {
+        [[\(a*\)*b]],
+        [[\(a\|aa\)*c]],
+        [[\(x\+x\+\)\+y]],
+        [[.*.*.*=.*z]],
+        [[\(ab\|a\)*\(ab\)*c]],
+        [[\(\w\+\s*\)\+$]],
+        [[\%(a\{1,5}\)\{1,5}z]],
+        [[\(.\{-}\)\{5}z]],
+      },
+    },
+  }
+
+  local results = {}
+
+  setup(function()
+    clear()
+  end)
+
+  teardown(function()
+    bench.report('NVIM_BENCH_REGEXP_OUT', results, {
+      { 'group', '%-12s', 'group' },
+      { 're', '%2d', 'engine' },
+      { 'min ms', '%10.3f', 'min_ms' },
+      { 'median ms', '%10.3f', 'median_ms' },
+      {
+        'matches',
+        '%-18s',
+        function(r)
+          return r.matches .. (r.timed_out and ' (timed out)' or '')
+        end,
+      },
+      { 'pattern', '%s', 'pattern' },
+    })
+  end)
+
+  local function measure(pattern, engine)
+    return exec_lua(
+      [[
+      local pattern, engine, N, timeout, max_matches = ...
+      vim.o.regexpengine = engine
+      local times = {}
+      local matches = 0
+      local timed_out = false
+      for _ = 1, N do
+        vim.api.nvim_win_set_cursor(0, { 1, 0 })
+        matches = 0
+        local start = vim.uv.hrtime()
+        local flags = 'cW'
+        while matches < max_matches do
+          local call_start = vim.uv.hrtime()
+          if vim.fn.search(pattern, flags, 0, timeout) == 0 then
+            timed_out = timed_out or (vim.uv.hrtime() - call_start) / 1e6 >= timeout
+            break
+          end
+          flags = 'W'
+          matches = matches + 1
+        end
+        times[#times + 1] = (vim.uv.hrtime() - start) / 1e6
+      end
+      table.sort(times)
+      return { matches, times[1], times[math.floor((#times + 1) / 2)], timed_out }
+    ]],
+      pattern,
+      engine,
+      N,
+      timeout,
+      max_matches
+    )
+  end
+
+  for _, group in ipairs({ 'code', 'syntax', 'pathological' }) do
+    local spec = corpus[group]
+    it(group .. ' patterns', function()
+      command('enew!')
+      if spec.file then
+        command('silent read ' .. spec.file)
+      else
+        meths.buf_set_lines(0, 0, -1, true, spec.lines)
+      end
+      for _, pattern in ipairs(spec.patterns) do
+        local counts = {}
+        for _, engine in ipairs({ 1, 2 }) do
+          local r = measure(pattern, engine)
+          table.insert(results, {
+            group = group,
+            pattern = pattern,
+            engine = engine,
+            matches = r[1],
+            min_ms = r[2],
+            median_ms = r[3],
+            timed_out = r[4],
+          })
+          counts[engine] = r[4] and -1 or r[1]
+        end
+        -- Both engines must find the same matches, unless one timed out.
+        if counts[1] >= 0 and counts[2] >= 0 then
+          eq(counts[1], counts[2], pattern)
+        end
+      end
+    end)
+  end
+end)
@@ -0,0 +1,147 @@
+-- Benchmark for reading and writing ShaDa files (shada.c) and undo files
+-- (undo.c) with large synthetic histories.
+--
+-- The ShaDa file is generated here with 100k history entries, 10k file marks
+-- and big registers. Each workload is run a few times and the time is taken
+-- inside Nvim around the command. Rows of the results
+-- ($NVIM_BENCH_SHADA_OUT):
+--   { workload = ..., runs = N, bytes = N, median_ms = ..., max_ms = ... }
+-- "bytes" is the size of the file that was read or written.
+
+local helpers = require('test.functional.helpers')(after_each)
+local bench = require('test.benchmark.helpers')
+local clear, command, exec_lua = helpers.clear, helpers.command, helpers.exec_lua
+
+local shada_file = 'Xbench_shada'
+local undo_file = 'Xbench_undo'
+local runs = 5
+
+local results = {}
+
+--- Encodes one ShaDa entry: type, timestamp, length and data.
+local function sd_entry(type, timestamp, data)
+  local enc = vim.mpack.encode(data)
+  return vim.mpack.encode(type) .. vim.mpack.encode(timestamp) .. vim.mpack.encode(#enc) .. enc
+end
+
+--- Writes a ShaDa file with "hist" history entries of each of the command and
+--- search types, "marks" file marks and 26 registers of "reg_lines" lines.
+local function gen_shada(fname, hist, marks, reg_lines, timestamp)
+  local parts = {
+    sd_entry(1, timestamp, { generator = 'bench_shada_undo_spec', version = 'bench' }),
+  }
+  for i = 1, hist do
+    parts[#parts + 1] = sd_entry(4, timestamp + i, { 0, ('echo "command %d"'):format(i) })
+    parts[#parts + 1] = sd_entry(4, timestamp + i, { 1, ('pattern%d'):format(i), 47 })
+  end
+  for i = 1, marks do
+    parts[#parts + 1] = sd_entry(10, timestamp + i, {
+      f = ('/tmp/bench/file%d.txt'):format(i % 1000),
+      l = i,
+      n = ('a'):byte() + i % 26,
+    })
+  end
+  local rc = {}
+  for i = 1, reg_lines do
+    rc[i] = ('register line %d '):format(i) .. ('x'):rep(60)
+  end
+  for r = 0, 25 do
+    parts[#parts + 1] = sd_entry(5, timestamp, { n = ('a'):byte() + r, rc = rc })
+  end
+  local fd = assert(io.open(fname, 'wb'))
+  fd:write(table.concat(parts))
+  fd:close()
+end
+
+local function file_size(fname)
+  local fd = io.open(fname, 'rb')
+  if not fd then
+    return 0
+  end
+  local size = fd:seek('end')
+  fd:close()
+  return size
+end
+
+--- Runs `step(i)` "runs" times and records the time taken in Nvim by the
+--- command it returns.
+local function measure(name, fname, step)
+  local r = { workload = name, runs = runs }
+  local times = {}
+  for i = 1, runs do
+    local cmd = step(i)
+    times[i] = exec_lua(
+      [[
+      local t0 = vim.uv.hrtime()
+      vim.cmd(...)
+      return (vim.uv.hrtime() - t0) / 1e6
+    ]],
+      cmd
+    )
+  end
+  table.sort(times)
+  r.median_ms = times[math.floor((#times + 1) / 2)]
+  r.max_ms = times[#times]
+  r.bytes = file_size(fname)
+  table.insert(results, r)
+end
+
+describe('ShaDa and undo file I/O', function()
+  before_each(function()
+    clear()
+    command('set shada=!,\'10000,<100000,s100000,:10000,/10000,h history=10000')
+  end)
+
+  after_each(function()
+    os.remove(shada_file)
+    os.remove(undo_file)
+  end)
+
+  teardown(function()
+    bench.report('NVIM_BENCH_SHADA_OUT', results, {
+      { 'workload', '%-24s', 'workload' },
+      { 'runs', '%5d', 'runs' },
+      { 'bytes', '%11d', 'bytes' },
+      { 'median ms', '%10.3f', 'median_ms' },
+      { 'max ms', '%10.3f', 'max_ms' },
+    })
+  end)
+
+  it('ShaDa read, write and merge', function()
+    gen_shada(shada_file, 100000, 10000, 1000, 1000)
+    measure('shada startup read', shada_file, function()
+      return 'rshada! ' .. shada_file
+    end)
+    measure('shada exit write', shada_file, function()
+      return 'wshada ' .. shada_file
+    end)
+    -- Another instance wrote the file since it was read: newer entries have
+    -- to be merged with the ones of this instance.
+    measure('shada concurrent merge', shada_file, function(i)
+      gen_shada(shada_file, 100000, 10000, 1000, 1000000 + i * 200000)
+      return 'wshada ' .. shada_file
+    end)
+  end)
+
+  it('undo file save and load', function()
+    command('set undolevels=100000')
+    exec_lua([[
+      local lines = {}
+      for i = 1, 2000 do
+        lines[i] = ('line %d '):format(i) .. ('x'):rep(40)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      for i = 1, 50000 do
+        vim.cmd('let &undolevels = &undolevels')
+        local lnum = (i * 7) % 2000
+        vim.api.nvim_buf_set_lines(0, lnum, lnum + 1, true, { ('change %d '):format(i) .. ('y'):rep(40) })
+      end
+    ]])
+    measure('undo file save', undo_file, function()
+      return 'wundo! ' .. undo_file
+    end)
+    measure('undo file load', undo_file, function()
+      return 'rundo ' .. undo_file
+    end)
+  end)
+end)
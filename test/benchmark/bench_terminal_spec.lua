@@ -0,0 +1,219 @@
+-- Benchmark for the :terminal buffer (terminal.c and libvterm).
+--
+-- Each workload is a generated byte stream ending in a marker line. It is
+-- fed to a terminal buffer in two ways:
+--   "send": nvim_chan_send() to a terminal from nvim_open_term(), which calls
+--           terminal_receive() directly, so it measures the parsing alone.
+--   "job":  a terminal job cat(1)s the stream from a file, which includes the
+--           pty reads and 'termcoalesce'. Not run on Windows.
+-- The time is taken inside Nvim until the marker shows up in the buffer,
+-- that is after refresh_screen() ran, plus the final :redraw of the attached
+-- UI. Rows of the results ($NVIM_BENCH_TERM_OUT):
+--   { workload = ..., mode = ..., runs = N, bytes = N, median_ms = ...,
+--     max_ms = ..., receive_ms = ..., bytes_per_sec = ... }
+-- "receive_ms" is the median time spent in nvim_chan_send() ("send" only).
+
+local helpers = require('test.functional.helpers')(after_each)
+local bench = require('test.benchmark.helpers')
+local clear, command, request = helpers.clear, helpers.command, helpers.request
+local exec_lua, is_os = helpers.exec_lua, helpers.is_os
+
+-- Size of the attached UI.
+local width, height = 120, 40
+local runs = 3
+local stream_file = 'Xbench_terminal'
+local marker = 'BENCH-TERMINAL-DONE'
+
+local results = {}
+
+local words = { 'lorem', 'ipsum', 'dolor', 'sit', 'amet', 'consectetur', 'adipiscing' }
+
+--- Returns a line of about "len" characters of words.
+local function text_line(i, len)
+  local parts, n = {}, 0
+  local j = i
+  while n < len do
+    local w = words[j % #words + 1]
+    parts[#parts + 1] = w
+    n = n + #w + 1
+    j = j + 1
+  end
+  return table.concat(parts, ' ')
+end
+
+local streams = {
+  -- Lines of plain ASCII text.
+  ['plain text flood'] = function()
+    local out = {}
+    for i = 1, 20000 do
+      out[i] = text_line(i, 100)
+    end
+    return table.concat(out, '\r\n')
+  end,
+
+  -- Every word has its own 256-color or truecolor foreground and background.
+  ['heavy SGR color'] = function()
+    local out = {}
+    for i = 1, 10000 do
+      local parts = {}
+      for j = 1, 12 do
+        local w = words[(i + j) % #words + 1]
+        if j % 2 == 0 then
+          parts[j] = ('\27[38;5;%d;48;5;%dm%s'):format((i + j) % 256, (i * j) % 256, w)
+        else
+          parts[j] = ('\27[1;38;2;%d;%d;%dm%s\27[0m'):format(i % 256, j * 20, (i + j) % 256, w)
+        end
+      end
+      out[i] = table.concat(parts, ' ') .. '\27[0m'
+    end
+    return table.concat(out, '\r\n')
+  end,
+
+  -- Full-screen redraws where every cell is addressed, like a TUI program.
+  ['full-screen redraw'] = function()
+    local out = {}
+    for frame = 1, 300 do
+      out[#out + 1] = '\27[H'
+      for row = 1, height do
+        out[#out + 1] = ('\27[%d;1H\27[3%dm%s\27[K'):format(
+          row,
+          (frame + row) % 8,
+          text_line(frame + row, width - 10)
+        )
+      end
+    end
+    out[#out + 1] = ('\27[%d;1H'):format(height)
+    return table.concat(out)
+  end,
+
+  -- Double-width CJK characters and emoji, some with combining characters.
+  ['wide and emoji text'] = function()
+    local chars = { '漢', '字', '한', '글', '😀', '🎉', '👍🏽', 'é', 'ñ' }
+    local out = {}
+    for i = 1, 10000 do
+      local parts = {}
+      for j = 1, 40 do
+        parts[j] = chars[(i + j) % #chars + 1]
+      end
+      out[i] = table.concat(parts)
+    end
+    return table.concat(out, '\r\n')
+  end,
+
+  -- Many more lines than 'scrollback', so the oldest lines are dropped.
+  ['scrollback overflow'] = function()
+    local out = {}
+    for i = 1, 60000 do
+      out[i] = ('%6d '):format(i) .. text_line(i, 60)
+    end
+    return table.concat(out, '\r\n')
+  end,
+}
+
+local order = {
+  'plain text flood',
+  'heavy SGR color',
+  'full-screen redraw',
+  'wide and emoji text',
+  'scrollback overflow',
+}
+
+--- Feeds "data" to a new terminal buffer "runs" times and records the times.
+local function measure(name, mode, data)
+  local r = { workload = name, mode = mode, runs = runs, bytes = #data }
+  local times, receive = {}, {}
+  for i = 1, runs do
+    command('enew!')
+    local t = exec_lua(
+      [[
+      local mode, data, fname, marker = ...
+      local buf = vim.api.nvim_get_current_buf()
+      local function done()
+        for _, l in ipairs(vim.api.nvim_buf_get_lines(buf, -4, -1, false)) do
+          if l:find(marker, 1, true) then
+            return true
+          end
+        end
+        return false
+      end
+      local t0 = vim.uv.hrtime()
+      local receive_ms
+      if mode == 'send' then
+        local chan = vim.api.nvim_open_term(buf, {})
+        vim.api.nvim_chan_send(chan, data)
+        receive_ms = (vim.uv.hrtime() - t0) / 1e6
+      else
+        vim.fn.termopen({ 'cat', fname })
+      end
+      assert(vim.wait(60000, done, 1), 'marker not seen')
+      vim.cmd('redraw')
+      return { (vim.uv.hrtime() - t0) / 1e6, receive_ms }
+    ]],
+      mode,
+      mode == 'send' and data or '',
+      stream_file,
+      marker
+    )
+    times[i] = t[1]
+    receive[i] = t[2]
+  end
+  table.sort(times)
+  r.median_ms = times[math.floor((#times + 1) / 2)]
+  r.max_ms = times[#times]
+  if #receive > 0 then
+    table.sort(receive)
+    r.receive_ms = receive[math.floor((#receive + 1) / 2)]
+  end
+  r.bytes_per_sec = r.median_ms > 0 and r.bytes / (r.median_ms / 1000) or 0
+  table.insert(results, r)
+end
+
+describe(':terminal throughput', function()
+  before_each(function()
+    clear()
+    request('nvim_ui_attach', width, height, { ext_linegrid = true, rgb = true })
+    command('set scrollback=10000 laststatus=0 noruler noshowmode')
+  end)
+
+  after_each(function()
+    os.remove(stream_file)
+  end)
+
+  teardown(function()
+    bench.report('NVIM_BENCH_TERM_OUT', results, {
+      { 'workload', '%-22s', 'workload' },
+      { 'mode', '%5s', 'mode' },
+      { 'runs', '%5d', 'runs' },
+      { 'bytes', '%10d', 'bytes' },
+      { 'median ms', '%10.3f', 'median_ms' },
+      { 'max ms', '%10.3f', 'max_ms' },
+      {
+        'recv ms',
+        '%10s',
+        function(r)
+          return r.receive_ms and ('%.3f'):format(r.receive_ms) or '-'
+        end,
+      },
+      {
+        'MB/s',
+        '%12.3f',
+        function(r)
+          return r.bytes_per_sec / 1e6
+        end,
+      },
+    })
+  end)
+
+  for _, name in ipairs(order) do
+    it(name, function()
+      local data = streams[name]() .. '\r\n' .. marker .. '\r\n'
+      measure(name, 'send', data)
+      if not is_os('win') then
+        local fd = assert(io.open(stream_file, 'wb'))
+        fd:write(data)
+        fd:close()
+        measure(name, 'job', data)
+      end
+    end)
+  end
+end)
@@ -0,0 +1,172 @@
+-- Benchmark for the remote UI path (api/ui.c and ui_compositor.c).
+--
+-- A UI is attached with nvim_ui_attach() directly on the test session, and
+-- each workload is replayed step by step. For every step the redraw batches
+-- are read until the UI is idle again. Rows of the results
+-- ($NVIM_BENCH_UI_OUT):
+--   { workload = ..., steps = N, frames = N, events = N, bytes = N,
+--     median_ms = ..., max_ms = ..., total_ms = ..., events_per_sec = ... }
+-- "bytes" is the size of the redraw arguments encoded again with msgpack,
+-- which is close to what the server sent.
+
+local helpers = require('test.functional.helpers')(after_each)
+local bench = require('test.benchmark.helpers')
+local clear, command, request = helpers.clear, helpers.command, helpers.request
+local exec_lua, next_msg, testprg = helpers.exec_lua, helpers.next_msg, helpers.testprg
+
+-- Size of the attached UI.
+local width, height = 160, 50
+-- The UI is considered idle when no redraw arrives for this long, in msec.
+local idle_timeout = 200
+
+local results = {}
+
+--- Reads redraw notifications until the UI is idle.
+---
+--- @param t0 number hrtime when the step was started
+--- @return table stats of the step
+local function drain(t0)
+  local stats = { frames = 0, events = 0, bytes = 0, ms = 0 }
+  while true do
+    local msg = next_msg(idle_timeout)
+    if msg == nil then
+      return stats
+    end
+    if msg[1] == 'notification' and msg[2] == 'redraw' then
+      stats.bytes = stats.bytes + #vim.mpack.encode(msg[3])
+      for _, update in ipairs(msg[3]) do
+        stats.events = stats.events + #update - 1
+        if update[1] == 'flush' then
+          stats.frames = stats.frames + 1
+          stats.ms = (vim.uv.hrtime() - t0) / 1e6
+        end
+      end
+    end
+  end
+end
+
+--- Runs `step(i)` for i = 1..n and records the redraw cost of each step.
+local function measure(name, n, step)
+  drain(vim.uv.hrtime()) -- discard the redraws before the workload
+  local r = { workload = name, steps = n, frames = 0, events = 0, bytes = 0, total_ms = 0 }
+  local times = {}
+  for i = 1, n do
+    local t0 = vim.uv.hrtime()
+    step(i)
+    local stats = drain(t0)
+    r.frames = r.frames + stats.frames
+    r.events = r.events + stats.events
+    r.bytes = r.bytes + stats.bytes
+    r.total_ms = r.total_ms + stats.ms
+    times[#times + 1] = stats.ms
+  end
+  table.sort(times)
+  r.median_ms = times[math.floor((#times + 1) / 2)]
+  r.max_ms = times[#times]
+  r.events_per_sec = r.total_ms > 0 and r.events / (r.total_ms / 1000) or 0
+  table.insert(results, r)
+end
+
+describe('remote UI redraw', function()
+  before_each(function()
+    clear()
+    request('nvim_ui_attach', width, height, { ext_linegrid = true, rgb = true })
+    exec_lua([[
+      local lines = {}
+      for i = 1, 5000 do
+        lines[i] = ('%5d '):format(i) .. string.rep('lorem ipsum dolor ', 8)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    command('set nowrap number cursorline')
+  end)
+
+  after_each(function()
+    request('nvim_ui_detach')
+  end)
+
+  teardown(function()
+    bench.report('NVIM_BENCH_UI_OUT', results, {
+      { 'workload', '%-16s', 'workload' },
+      { 'steps', '%6d', 'steps' },
+      { 'frames', '%7d', 'frames' },
+      { 'events', '%9d', 'events' },
+      { 'bytes', '%11d', 'bytes' },
+      { 'median ms', '%10.3f', 'median_ms' },
+      { 'max ms', '%10.3f', 'max_ms' },
+      { 'events/s', '%12.0f', 'events_per_sec' },
+    })
+  end)
+
+  it('full-screen scroll', function()
+    measure('scroll', 50, function()
+      command('execute "normal! \\<C-F>"')
+    end)
+    measure('scroll by line', 100, function()
+      command('execute "normal! \\<C-E>"')
+    end)
+  end)
+
+  it('split resize', function()
+    command('vsplit | split')
+    measure('split resize', 60, function(i)
+      command(i % 2 == 0 and 'vertical resize +7' or 'vertical resize -7')
+    end)
+  end)
+
+  it('many windows', function()
+    command('vsplit | vsplit | split | wincmd l | split | wincmd l | split')
+    measure('many windows', 50, function()
+      command('redraw!')
+    end)
+    command('windo diffthis')
+    measure('many windows diff', 50, function()
+      command('redraw!')
+    end)
+  end)
+
+  it('float churn', function()
+    exec_lua([[
+      _G.bench_buf = vim.api.nvim_create_buf(false, true)
+      vim.api.nvim_buf_set_lines(_G.bench_buf, 0, -1, true, { 'hover', 'documentation', 'text' })
+      _G.bench_wins = {}
+    ]])
+    measure('float churn', 100, function(i)
+      exec_lua(
+        [[
+        local i = ...
+        local wins = _G.bench_wins
+        if #wins >= 8 then
+          vim.api.nvim_win_close(table.remove(wins, 1), true)
+        end
+        table.insert(wins, vim.api.nvim_open_win(_G.bench_buf, false, {
+          relative = 'editor', row = (i * 7) % 40, col = (i * 13) % 120,
+          width = 30, height = 5, border = 'single',
+        }))
+        for _, win in ipairs(wins) do
+          local config = vim.api.nvim_win_get_config(win)
+          vim.api.nvim_win_set_config(win, {
+            relative = 'editor', row = (config.row + 1) % 40, col = (config.col + 2) % 120,
+          })
+        end
+      ]],
+        i
+      )
+    end)
+  end)
+
+  it(':terminal output', function()
+    measure('terminal output', 1, function()
+      command(('terminal "%s" REP 20000 %s'):format(testprg('shell-test'), ('x'):rep(100)))
+    end)
+  end)
+
+  it('cmdline typing', function()
+    local text = 'echo "the quick brown fox jumps over the lazy dog"'
+    request('nvim_input', ':')
+    measure('cmdline typing', #text, function(i)
+      request('nvim_input', text:sub(i, i))
+    end)
+    request('nvim_input', '<Esc>')
+  end)
+end)
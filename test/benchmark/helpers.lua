@@ -0,0 +1,47 @@
+-- Helpers shared by the benchmarks.
+
+local M = {}
+
+--- Prints the results of a benchmark as a table and, when the environment
+--- variable "env" is set, writes them to the file it names as JSON, a list
+--- with one object per row. The fields of the rows are described at the top
+--- of each benchmark.
+---
+--- Each column is { header, format, field }, where "format" is used with
+--- string.format() and "field" is the key of the value in a row, or a function
+--- that returns the value for a row.
+---
+--- @param env string
+--- @param results table[]
+--- @param columns table[]
+function M.report(env, results, columns)
+  local headers, header_fmt, row_fmt = {}, {}, {}
+  for i, col in ipairs(columns) do
+    headers[i] = col[1]
+    header_fmt[i] = col[2]:match('^%%%-?%d*') .. 's'
+    row_fmt[i] = col[2]
+  end
+  print('')
+  print(table.concat(header_fmt, ' '):format(unpack(headers)))
+  for _, r in ipairs(results) do
+    local values = {}
+    for i, col in ipairs(columns) do
+      local field = col[3]
+      if type(field) == 'function' then
+        values[i] = field(r)
+      else
+        values[i] = r[field]
+      end
+    end
+    print(table.concat(row_fmt, ' '):format(unpack(values)))
+  end
+
+  local out = os.getenv(env)
+  if out then
+    local f = assert(io.open(out, 'w'))
+    f:write(vim.json.encode(results))
+    f:close()
+  end
+end
+
+return M
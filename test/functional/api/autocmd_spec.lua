@@ -555,6 +555,30 @@ describe('autocmd api', function()
 
         eq({ command = "", cbtype = 'function' }, result)
       end)
+
+      it('returns call counts and times with stats', function()
+        local result = exec_lua([[
+          vim.api.nvim_create_autocmd('User', {
+            pattern = 'Xstats',
+            callback = function() vim.uv.sleep(20) end,
+          })
+          vim.api.nvim_create_autocmd('User', { pattern = 'Xother', command = 'eval 0' })
+          vim.cmd('autocmd User Xstats eval 0')
+          for _ = 1, 3 do
+            vim.api.nvim_exec_autocmds('User', { pattern = 'Xstats' })
+          end
+          local plain = vim.api.nvim_get_autocmds({ event = 'User' })[1]
+          local aus = vim.api.nvim_get_autocmds({ event = 'User', stats = true })
+          return {
+            plain = { plain.calls, plain.time },
+            calls = { aus[1].calls, aus[2].calls, aus[3].calls },
+            slow = aus[1].time >= 60 * 1000000,
+            fast = aus[3].time < aus[1].time,
+          }
+        ]])
+
+        eq({ plain = {}, calls = { 3, 0, 3 }, slow = true, fast = true }, result)
+      end)
     end)
 
     describe('groups', function()
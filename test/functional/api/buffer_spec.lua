@@ -556,6 +556,17 @@ describe('api/buf', function()
       eq({'ab\0cd'}, get_lines(0, -1, true))
     end)
 
+    it('can append many lines, with and without NULs', function()
+      local lines = {}
+      for i = 1, 5000 do
+        lines[i] = i % 3 == 0 and ('x\0'):rep(i % 7) or ('line'):rep(i % 11)
+      end
+      set_lines(0, -1, true, {'first'})
+      set_lines(1, 1, true, lines)
+      table.insert(lines, 1, 'first')
+      eq(lines, get_lines(0, -1, true))
+    end)
+
     it('works with multiple lines', function()
       eq({''}, get_lines(0, -1, true))
       -- Replace buffer
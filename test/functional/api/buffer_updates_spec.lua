@@ -96,6 +96,43 @@ local function reopenwithfolds(b)
   return tick
 end
 
+describe('API: buffer updates with coalesce', function()
+  it('merges adjacent changes into one event', function()
+    local b, tick = editoriginal(false)
+    ok(buffer('attach', b, false, {coalesce=true}))
+    expectn('nvim_buf_changedtick_event', {b, tick})
+    command('2,5normal! Ax')
+    command('3delete')
+    command('normal! 2GOnew')
+    tick = eval('b:changedtick')
+    expectn('nvim_buf_lines_event', {b, tick, 1, 5, {'new',
+                                                    'original line 2x',
+                                                    'original line 4x',
+                                                    'original line 5x'}, false})
+  end)
+
+  it('sends separate events for changes that are not adjacent', function()
+    local b, tick = editoriginal(false)
+    ok(buffer('attach', b, false, {coalesce=true}))
+    expectn('nvim_buf_changedtick_event', {b, tick})
+    command('exe "1normal! Ay" | exe "6normal! Az"')
+    local msg = next_msg()
+    eq({'notification', 'nvim_buf_lines_event'}, {msg[1], msg[2]})
+    eq({0, 1, {'original line 1y'}}, {msg[3][3], msg[3][4], msg[3][5]})
+    tick = eval('b:changedtick')
+    expectn('nvim_buf_lines_event', {b, tick, 5, 6, {'original line 6z'}, false})
+  end)
+
+  it('sends pending changes before detaching', function()
+    local b, tick = editoriginal(false)
+    ok(buffer('attach', b, false, {coalesce=true}))
+    expectn('nvim_buf_changedtick_event', {b, tick})
+    nvim('call_atomic', {{'nvim_command', {'2delete'}}, {'nvim_buf_detach', {b}}})
+    expectn('nvim_buf_lines_event', {b, tick + 1, 1, 2, {}, false})
+    expectn('nvim_buf_detach_event', {b})
+  end)
+end)
+
 describe('API: buffer events:', function()
   before_each(clear)
 
@@ -176,6 +176,27 @@ describe('API/extmarks', function()
     eq(false, curbufmeths.del_extmark(ns, 1000))
   end)
 
+  it('adds many marks with set_extmarks', function()
+    local ids = curbufmeths.set_extmarks(ns, {
+      { 0, 3 },
+      { 0, 0, { id = 10, end_col = 2 } },
+      { 0, 1, {} },
+    })
+    -- marks are added in buffer order, ids are returned in the given order
+    eq({ 12, 10, 11 }, ids)
+    eq({
+      { 10, 0, 0 },
+      { 11, 0, 1 },
+      { 12, 0, 3 },
+    }, get_extmarks(ns, 0, -1))
+
+    eq("Invalid 'col': expected Integer, got String",
+       pcall_err(curbufmeths.set_extmarks, ns, { { 0, 'x' } }))
+    eq("Invalid 'end_col': out of range",
+       pcall_err(curbufmeths.set_extmarks, ns, { { 0, 4 }, { 0, 0, { end_col = 10 } } }))
+    eq(3, #get_extmarks(ns, 0, -1))
+  end)
+
   it('can clear a specific namespace range', function()
     set_extmark(ns, 1, 0, 1)
     set_extmark(ns2, 1, 0, 1)
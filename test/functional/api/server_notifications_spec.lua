@@ -90,7 +90,8 @@ describe('notify', function()
   it('cancels stale events on channel close', function()
     local catchan = eval("jobstart(['cat'], {'rpc': v:true})")
     local catpath = eval('exepath("cat")')
-    eq({id=catchan, argv={catpath}, stream='job', mode='rpc', client = {}}, exec_lua ([[
+    local spawn_time = meths.get_chan_info(catchan).spawn_time
+    eq({id=catchan, argv={catpath}, spawn_time=spawn_time, stream='job', mode='rpc', client = {}}, exec_lua ([[
       vim.rpcnotify(..., "nvim_call_function", 'chanclose', {..., 'rpc'})
       vim.rpcnotify(..., "nvim_subscribe", "daily_rant")
       return vim.api.nvim_get_chan_info(...)
@@ -100,4 +101,16 @@ describe('notify', function()
       exec_lua ([[ return {pcall(vim.rpcrequest, ..., 'nvim_eval', '1+1')}]], catchan))
     retry(nil, 3000, function() eq({}, meths.get_chan_info(catchan)) end) -- cat be dead :(
   end)
+
+  it('handles a burst of notifications in order', function()
+    meths.set_var('seen', {})
+    for i = 1, 1000 do
+      helpers.nvim_async('command', 'call add(g:seen, ' .. i .. ')')
+    end
+    local expected = {}
+    for i = 1, 1000 do
+      table.insert(expected, i)
+    end
+    eq(expected, eval('g:seen'))
+  end)
 end)
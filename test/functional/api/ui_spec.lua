@@ -7,6 +7,7 @@ local eval = helpers.eval
 local exec = helpers.exec
 local feed = helpers.feed
 local meths = helpers.meths
+local ok = helpers.ok
 local request = helpers.request
 local pcall_err = helpers.pcall_err
 
@@ -42,6 +43,10 @@ describe('nvim_ui_attach()', function()
       pcall_err(meths.ui_attach, 80, 24, { stdin_tty='foo' }))
     eq("Invalid 'stdout_tty': expected Boolean, got String",
       pcall_err(meths.ui_attach, 80, 24, { stdout_tty='foo' }))
+    eq("Invalid 'max_fps': expected Integer, got String",
+      pcall_err(meths.ui_attach, 80, 24, { max_fps='foo' }))
+    eq("Invalid 'max_fps': -1",
+      pcall_err(meths.ui_attach, 80, 24, { max_fps=-1 }))
 
     eq('UI not attached to channel: 1',
       pcall_err(request, 'nvim_ui_try_resize', 40, 10))
@@ -55,6 +60,27 @@ describe('nvim_ui_attach()', function()
     eq('UI already attached to channel: 1',
       pcall_err(request, 'nvim_ui_attach', 40, 10, { rgb=false }))
   end)
+
+  it('sends at most max_fps flushes per second', function()
+    local screen = Screen.new(20, 4)
+    screen:set_default_attr_ids({
+      [1] = {bold = true, foreground = Screen.colors.Blue},
+    })
+    screen:attach({max_fps=2})
+    local flushes = 0
+    screen._handle_flush = function()
+      flushes = flushes + 1
+    end
+    for i = 1, 10 do
+      command('call setline(1, "line ' .. i .. '") | redraw')
+    end
+    screen:expect([[
+      ^line 10             |
+      {1:~                   }|*2
+                          |
+    ]])
+    ok(flushes <= 3)
+  end)
 end)
 
 it('autocmds UIEnter/UILeave', function()
@@ -2246,6 +2246,22 @@ describe('API', function()
     end)
   end)
 
+  describe('nvim_chan_send_buf', function()
+    it('sends buffer lines to a job', function()
+      meths.buf_set_lines(0, 0, -1, true, { 'abc', 'd\0e', '', 'last' })
+      source([[
+        let g:opts = {'stdout_buffered': v:true}
+        let g:job = jobstart(['cat'], g:opts)
+      ]])
+      local job = eval('g:job')
+      eq('Index out of bounds', pcall_err(meths.chan_send_buf, job, 0, 0, 10))
+      eq(0, meths.chan_send_buf(job, 0, 2, 2))
+      eq(10, meths.chan_send_buf(job, 0, 1, -1))
+      command('call chanclose(g:job, "stdin") | call jobwait([g:job])')
+      eq({ 'd\ne', '', 'last', '' }, eval('g:opts.stdout'))
+    end)
+  end)
+
   describe('nvim_list_chans, nvim_get_chan_info', function()
     before_each(function()
       command('autocmd ChanOpen * let g:opened_event = deepcopy(v:event)')
@@ -2300,10 +2316,13 @@ describe('API', function()
     it('stream=job channel', function()
       eq(3, eval("jobstart(['cat'], {'rpc': v:true})"))
       local catpath = eval('exepath("cat")')
+      local spawn_time = meths.get_chan_info(3).spawn_time
+      ok(spawn_time > 0)
       local info = {
         stream='job',
         id=3,
         argv={ catpath },
+        spawn_time=spawn_time,
         mode='rpc',
         client={},
       }
@@ -2317,6 +2336,7 @@ describe('API', function()
         stream='job',
         id=3,
         argv={ catpath },
+        spawn_time=spawn_time,
         mode='rpc',
         client = {
           name='amazing-cat',
@@ -2342,6 +2362,7 @@ describe('API', function()
         stream='job',
         id=3,
         argv={ eval('exepath(&shell)') },
+        spawn_time=meths.get_chan_info(3).spawn_time,
         mode='terminal',
         buffer = 1,
         pty='?',
@@ -2384,6 +2405,7 @@ describe('API', function()
       }
       local actual2 = eval('nvim_get_chan_info(&channel)')
       expected2.pty = actual2.pty
+      expected2.spawn_time = actual2.spawn_time
       eq(expected2, actual2)
 
       -- :terminal with args + stopped process.
@@ -2394,6 +2416,31 @@ describe('API', function()
     end)
   end)
 
+  describe('nvim__rpc_stats', function()
+    it('counts requests by method', function()
+      for _ = 1, 5 do
+        meths.get_current_line()
+      end
+      nvim_async('command', 'let g:done = 1')
+      eq(1, meths.get_var('done'))
+      local stats = request('nvim__rpc_stats')
+      local line = stats.nvim_get_current_line
+      eq(5, line.count)
+      local wait, time = 0, 0
+      for i = 1, #line.wait do
+        wait = wait + line.wait[i]
+      end
+      for i = 1, #line.time do
+        time = time + line.time[i]
+      end
+      eq(5, wait)
+      eq(5, time)
+      ok(line.time_total >= 0)
+      eq(1, stats.nvim_command.count)
+      eq(nil, stats.nvim_buf_get_lines)
+    end)
+  end)
+
   describe('nvim_call_atomic', function()
     it('works', function()
       meths.buf_set_lines(0, 0, -1, true, {'first'})
@@ -2415,6 +2462,26 @@ describe('API', function()
       eq({{NIL, NIL, true, 'string'}, NIL}, meths.call_atomic(req))
     end)
 
+    it('returns large results', function()
+      local lines = {}
+      for i = 1, 20000 do
+        lines[i] = ('line %d'):format(i)
+      end
+      meths.buf_set_lines(0, 0, -1, true, lines)
+      local req = {}
+      for i = 1, 5 do
+        req[i] = {'nvim_buf_get_lines', {0, 0, -1, true}}
+      end
+      local res = meths.call_atomic(req)
+      eq(NIL, res[2])
+      eq(5, #res[1])
+      for i = 1, 5 do
+        eq(lines, res[1][i])
+      end
+      -- a small response after a large one
+      eq({{'line 1'}, NIL}, meths.call_atomic({{'nvim_get_current_line', {}}}))
+    end)
+
     it('is aborted by errors in call', function()
       local error_types = meths.get_api_info()[2].error_types
       local req = {
@@ -2767,6 +2834,7 @@ describe('API', function()
           ext_termcolors = false,
           ext_wildmenu = false,
           height = 4,
+          max_fps = 0,
           override = true,
           rgb = true,
           stdin_tty = false,
@@ -2782,8 +2850,9 @@ describe('API', function()
 
       screen:detach()
       screen = Screen.new(44, 99)
-      screen:attach({ rgb = false })
+      screen:attach({ rgb = false, max_fps = 30 })
       expected[1].rgb = false
+      expected[1].max_fps = 30
       expected[1].override = false
       expected[1].width = 44
       expected[1].height = 99
@@ -3166,6 +3235,47 @@ describe('API', function()
     end)
   end)
 
+  describe('nvim__stats', function()
+    it('counts arena blocks that are reused', function()
+      local lines = {}
+      for i = 1, 2000 do
+        lines[i] = ('line %d of a bulk payload'):format(i)
+      end
+      request('nvim_buf_set_lines', 0, 0, -1, true, lines)
+      local before = request('nvim__stats')
+      request('nvim_buf_set_lines', 0, 0, -1, true, lines)
+      local after = request('nvim__stats')
+      ok(after.arena_reuse_count > before.arena_reuse_count)
+      ok(after.arena_peak_bytes >= 64 * 1024)
+      ok(after.arena_bytes < after.arena_peak_bytes)
+      eq(2000, meths.buf_line_count(0))
+    end)
+  end)
+
+  describe('nvim__memory_stats', function()
+    it('reports sizes per buffer and in total', function()
+      local lines = {}
+      for i = 1, 500 do
+        lines[i] = ('line %d with some text'):format(i)
+      end
+      request('nvim_buf_set_lines', 0, 0, -1, true, lines)
+      local ns = meths.create_namespace('test')
+      for i = 0, 499 do
+        meths.buf_set_extmark(0, ns, i, 0, {})
+      end
+      local stats = request('nvim__memory_stats')
+      eq(1, #stats.buffers)
+      local b = stats.buffers[1]
+      eq(meths.get_current_buf(), b.buf)
+      ok(b.memfile > 0)
+      ok(b.undo > 0)
+      ok(b.marktree > 0)
+      eq(b.undo, stats.undo)
+      eq(b.marktree, stats.marktree)
+      ok(stats.lua > 0)
+    end)
+  end)
+
   describe('nvim_echo', function()
     local screen
 
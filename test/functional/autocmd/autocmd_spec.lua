@@ -454,6 +454,31 @@ describe('autocmd', function()
     ]]}
   end)
 
+  it('matches plain name, "*.ext" and "name*" patterns in order', function()
+    source([[
+      let g:hits = []
+      autocmd User * call add(g:hits, 'any')
+      autocmd User Xfoo.lua call add(g:hits, 'exact')
+      autocmd User *.lua call add(g:hits, 'suffix')
+      autocmd User Xfoo* call add(g:hits, 'prefix')
+      autocmd User X[f]oo.lua call add(g:hits, 'regex')
+      autocmd User *oo.lu* call add(g:hits, 'both')
+      autocmd User Xfoo call add(g:hits, 'short')
+    ]])
+    command('doautocmd User Xfoo.lua')
+    eq({ 'any', 'exact', 'suffix', 'prefix', 'regex', 'both' }, eval('g:hits'))
+    command('let g:hits = []')
+    command('doautocmd User Xfoo')
+    eq({ 'any', 'prefix', 'short' }, eval('g:hits'))
+    command('let g:hits = []')
+    command('doautocmd User xFOO.LUA')
+    eq({ 'any' }, eval('g:hits'))
+    command('set fileignorecase')
+    command('let g:hits = []')
+    command('doautocmd User xFOO.LUA')
+    eq({ 'any', 'exact', 'suffix', 'prefix', 'regex', 'both' }, eval('g:hits'))
+  end)
+
   describe('v:event is readonly #18063', function()
     it('during ChanOpen event', function()
       command('autocmd ChanOpen * let v:event.info.id = 0')
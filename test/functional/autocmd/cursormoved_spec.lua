@@ -6,6 +6,7 @@ local eval = helpers.eval
 local meths = helpers.meths
 local source = helpers.source
 local command = helpers.command
+local feed = helpers.feed
 
 describe('CursorMoved', function()
   before_each(clear)
@@ -55,4 +56,28 @@ describe('CursorMoved', function()
     ]])
     eq(0, eval('g:cursormoved'))
   end)
+
+  it('only runs handlers that apply to the buffer', function()
+    source([[
+      call setline(1, ['a', 'b', 'c'])
+      let g:log = []
+      file Xcursormoved.txt
+      autocmd CursorMoved *.py let g:log += ['py']
+      new
+      autocmd CursorMoved <buffer> let g:log += ['local']
+      wincmd p
+    ]])
+    feed('j')
+    eq({}, eval('g:log'))
+    -- Renaming the buffer makes the pattern match.
+    command('file Xcursormoved.py')
+    feed('j')
+    eq({'py'}, eval('g:log'))
+    -- A new handler is seen right away.
+    command('autocmd CursorMoved Xcursormoved.* let g:log += ["name"]')
+    feed('k')
+    eq({'py', 'py', 'name'}, eval('g:log'))
+    command('wincmd p')
+    eq({'py', 'py', 'name', 'local'}, eval('g:log'))
+  end)
 end)
@@ -316,6 +316,48 @@ describe('channels', function()
     -- works correctly with no output
     eq({"notification", "exit", {id, 1, {''}}}, next_msg())
   end)
+
+  it('can send a Dictionary as JSON', function()
+    skip(funcs.executable('cat') == 0, 'missing "cat" command')
+    source([[
+      let g:job_opts = {
+      \ 'on_stdout': function('OnEvent'),
+      \ 'stdout_buffered': v:true,
+      \ }
+      let g:msg = {'id': 1, 'params': {'text': repeat(['lorem ipsum'], 20000)}}
+    ]])
+    command("let id = jobstart(['cat'], g:job_opts)")
+    local id = eval("g:id")
+
+    -- Larger than one chunk, written in several parts between the list items.
+    local len = #eval('json_encode(g:msg)')
+    ok(len > 64 * 1024)
+    eq(len, eval('chansend(id, g:msg)'))
+    command("call chanclose(id, 'stdin')")
+    local msg = next_msg()
+    eq('stdout', msg[2])
+    eq(eval('g:msg'), funcs.json_decode(msg[3][2]))
+  end)
+
+  it('can send a Dictionary with a long string as JSON', function()
+    skip(funcs.executable('cat') == 0, 'missing "cat" command')
+    source([[
+      let g:job_opts = {
+      \ 'on_stdout': function('OnEvent'),
+      \ 'stdout_buffered': v:true,
+      \ }
+      let g:msg = {'text': repeat("lorem\tipsum ", 20000)}
+    ]])
+    command("let id = jobstart(['cat'], g:job_opts)")
+    -- The string alone is larger than one chunk.
+    local len = #eval('json_encode(g:msg)')
+    ok(len > 2 * 64 * 1024)
+    eq(len, eval('chansend(id, g:msg)'))
+    command("call chanclose(id, 'stdin')")
+    local msg = next_msg()
+    eq('stdout', msg[2])
+    eq(eval('g:msg'), funcs.json_decode(msg[3][2]))
+  end)
 end)
 
 describe('loopback', function()
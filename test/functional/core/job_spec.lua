@@ -321,6 +321,42 @@ describe('jobs', function()
     eq({'notification', 'exit', {0, 143}}, next_msg())
   end)
 
+  it('passes only complete lines with stdout_lines', function()
+    command("let g:job_opts.stdout_lines = v:true")
+    command("let j = jobstart(['cat', '-'], g:job_opts)")
+    command('call jobsend(j, "abc\\nxy")')
+    eq({'notification', 'stdout', {0, {'abc'}}}, next_msg())
+    command('call jobsend(j, "z\\n\\nlast")')
+    eq({'notification', 'stdout', {0, {'xyz', ''}}}, next_msg())
+    command('call jobclose(j, "stdin")')
+    -- At EOF the unfinished line, then an empty list.
+    eq({'notification', 'stdout', {0, {'last'}}}, next_msg())
+    eq({'notification', 'stdout', {0, {}}}, next_msg())
+    eq({'notification', 'exit', {0, 0}}, next_msg())
+  end)
+
+  it('reuses a pooled rpc job after jobstop()', function()
+    local start = "jobstart(['cat'], {'rpc': v:true, 'pool': 10000})"
+    local id = eval(start)
+    local pid = eval('jobpid(' .. id .. ')')
+    eq(1, eval('jobstop(' .. id .. ')'))
+    eq(id, eval(start))
+    eq(pid, eval('jobpid(' .. id .. ')'))
+    -- A job in use is not shared, a different command starts a new job.
+    neq(id, eval(start))
+    neq(id, eval("jobstart(['cat', '-'], {'rpc': v:true, 'pool': 10000})"))
+    eq('Vim(call):E475: Invalid argument: job can only have the \'pool\' option with \'rpc\'',
+       pcall_err(command, "call jobstart(['cat'], {'pool': 10000})"))
+  end)
+
+  it('stops a pooled job after its idle timeout', function()
+    local id = eval("jobstart(['cat'], {'rpc': v:true, 'pool': 1})")
+    eq(1, eval('jobstop(' .. id .. ')'))
+    retry(nil, 3000, function()
+      eq({}, meths.get_chan_info(id))
+    end)
+  end)
+
   it('preserves newlines', function()
     nvim('command', "let j = jobstart(['cat', '-'], g:job_opts)")
     nvim('command', 'call jobsend(j, "a\\n\\nc\\n\\n\\n\\nb\\n\\n")')
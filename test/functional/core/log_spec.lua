@@ -49,4 +49,16 @@ describe('log', function()
     -- Child Nvim spawned by jobstart() appends "/c" to parent name.
     assert_log('%.%d+%.%d/c +server_init:%d+: test log message', testlog, 100)
   end)
+
+  it('messages are written with $NVIM_LOG_ASYNC', function()
+    clear({ env = {
+      NVIM_LOG_FILE = testlog,
+      NVIM_LOG_ASYNC = '1',
+      __NVIM_TEST_LOG = '1',
+    } })
+
+    local tid = _G._nvim_test_id
+    assert_log(tid .. '%.%d+%.%d +server_init:%d+: test log message', testlog, 100)
+    eq(0, request('nvim__stats').log_drop)
+  end)
 end)
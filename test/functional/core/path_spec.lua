@@ -165,4 +165,24 @@ describe('file search', function()
     test_find_func('findfile', 'directory', 'file name.txt')
     test_find_func('findfile', 'fold#er name', 'file.txt')
   end)
+
+  it('findfile() with "**" sees changes to the tree between searches', function()
+    local d = join_path(testdir, 'tree')
+    mkdir(d)
+    mkdir(join_path(d, 'a'))
+    mkdir(join_path(d, '.hidden'))
+    write_file(join_path(d, 'a', 'one.txt'), '')
+    write_file(join_path(d, '.hidden', 'two.txt'), '')
+    local path = funcs.fnamemodify(d, ':p') .. '**'
+    eq(join_path(d, 'a', 'one.txt'), funcs.findfile('one.txt', path))
+    eq('', funcs.findfile('two.txt', path))
+
+    mkdir(join_path(d, 'b'))
+    mkdir(join_path(d, 'b', 'c'))
+    write_file(join_path(d, 'b', 'c', 'two.txt'), '')
+    eq(join_path(d, 'b', 'c', 'two.txt'), funcs.findfile('two.txt', path))
+
+    rmdir(join_path(d, 'a'))
+    eq('', funcs.findfile('one.txt', path))
+  end)
 end)
@@ -63,6 +63,30 @@ describe('startup', function()
     assert_log("require%('vim%._editor'%)", testfile, 100)
   end)
 
+  it('--startuptime writes a trace to a .json file', function()
+    local testfile = 'Xtest_startuptime.json'
+    finally(function()
+      os.remove(testfile)
+    end)
+    clear()
+    funcs.system({ nvim_prog, '--clean', '--headless', '--startuptime', testfile, '+q' })
+    local events = funcs.json_decode(read_file(testfile))
+    local spans = {}
+    for _, e in ipairs(events) do
+      eq('X', e.ph)
+      ok(e.dur >= 0 and e.args.allocs >= 0)
+      spans[e.name] = e
+    end
+    local startup = spans['startup']
+    local vimrc = spans['sourcing vimrc file(s)']
+    ok(startup ~= nil and vimrc ~= nil and spans['early init'] ~= nil)
+    ok(startup.args.allocs > 0)
+    -- Spans of sourced files and required modules nest inside the phases.
+    local editor = spans["require('vim._editor')"]
+    ok(editor ~= nil)
+    ok(editor.ts >= startup.ts and editor.ts + editor.dur <= startup.ts + startup.dur)
+  end)
+
   it('-D does not hang #12647', function()
     clear()
     local screen
@@ -1032,6 +1056,23 @@ describe('runtime:', function()
     eq({'unos', 'dos'}, exec_lua "return _G.lista")
   end)
 
+  it('loads start packages of all categories in order', function()
+    local pack_path = table.concat({xconfig, 'nvim', 'pack'}, pathsep)
+    for _, p in ipairs({{'b', 'y'}, {'a', 'z'}, {'a', 'x'}, {'.hidden', 'w'}}) do
+      local dir = table.concat({pack_path, p[1], 'start', p[2], 'plugin'}, pathsep)
+      mkdir_p(dir)
+      write_file(table.concat({dir, 'order.lua'}, pathsep),
+                 ('table.insert(_G.order, %q)'):format(p[1] .. '/' .. p[2]))
+    end
+    finally(function()
+      rmdir(pack_path)
+    end)
+
+    clear{ args_rm={'-u'}, args={'--cmd', 'lua _G.order = {}'}, env=xenv }
+
+    eq({'a/x', 'a/z', 'b/y'}, exec_lua 'return _G.order')
+  end)
+
   it('no crash setting &rtp in plugins with :packloadall called before #18315', function()
     local plugin_folder_path = table.concat({xconfig, 'nvim', 'plugin'}, pathsep)
     mkdir_p(plugin_folder_path)
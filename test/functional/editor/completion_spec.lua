@@ -1103,6 +1103,47 @@ describe('completion', function()
     ]]}
   end)
 
+  it('keywords of other buffers follow changes to them', function()
+    command('inoremap <F2> <Cmd>let g:words = complete_info(["items"]).items->map("v:val.word")<CR>')
+    local other = meths.create_buf(true, false)
+    meths.buf_set_lines(other, 0, -1, true, { 'foo fob foo', 'fox foo fob' })
+    feed('ifo<C-N><F2><Esc>')
+    eq({ 'foo', 'fob', 'fox' }, eval('g:words'))
+    eq('foo', meths.get_current_line())
+    -- backward the last occurrence comes first
+    feed('ccfo<C-P><Esc>')
+    eq('fob', meths.get_current_line())
+
+    meths.buf_set_lines(other, 1, 2, true, { 'form' })
+    feed('ccfo<C-N><F2><Esc>')
+    eq({ 'foo', 'fob', 'form' }, eval('g:words'))
+    -- 'iskeyword' of the current buffer splits the words
+    meths.buf_set_lines(other, 0, -1, true, { 'fo-bar foo' })
+    feed('ccfo<C-N><F2><Esc>')
+    eq({ 'foo' }, eval('g:words'))
+    command('setlocal iskeyword+=-')
+    feed('ccfo<C-N><F2><Esc>')
+    eq({ 'fo-bar', 'foo' }, eval('g:words'))
+  end)
+
+  it('drops duplicates from a long list of matches', function()
+    source([[
+      function Complete() abort
+        let items = range(20000)->map('"item" .. (v:val % 10000)')
+        call add(items, #{word: 'item1', dup: 1})
+        call complete(col('.'), items)
+        return ''
+      endfunction
+      inoremap <F2> <Cmd>let g:words = complete_info(["items"]).items->map("v:val.word")<CR>
+      inoremap <F3> <C-R>=Complete()<CR>
+    ]])
+    feed('i<F3><F2><Esc>')
+    local words = eval('g:words')
+    eq(10001, #words)
+    eq({ 'item0', 'item1', 'item2' }, { words[1], words[2], words[3] })
+    eq({ 'item9999', 'item1' }, { words[10000], words[10001] })
+  end)
+
   it('restores extmarks if original text is restored #23653', function()
     screen:try_resize(screen._width, 4)
     command([[
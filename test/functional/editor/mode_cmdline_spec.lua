@@ -69,6 +69,30 @@ describe('cmdline', function()
     ]]}
   end)
 
+  describe('completion', function()
+    before_each(function()
+      helpers.source([[
+        function Complete(...) abort
+          " like a key typed while completing
+          call nvim_input('x')
+          return ['aaa']
+        endfunction
+        command -nargs=1 -complete=customlist,Complete Cmd :
+      ]])
+    end)
+
+    it('uses a key typed meanwhile after the matches', function()
+      feed(':Cmd <Tab>')
+      eq('Cmd aaax', funcs.getcmdline())
+    end)
+
+    it("is stopped by a typed key with 'wildoptions' interrupt", function()
+      command('set wildoptions+=interrupt')
+      feed(':Cmd <Tab>')
+      eq('Cmd x', funcs.getcmdline())
+    end)
+  end)
+
   describe('history', function()
     it('correctly clears start of the history', function()
       -- Regression test: check absence of the memory leak when clearing start of
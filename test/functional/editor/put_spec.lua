@@ -945,5 +945,45 @@ describe('put command', function()
       Line of words 2]])
     end)
   end)
-end)
 
+  describe('linewise yank of many lines', function()
+    before_each(function()
+      command('bwipe! | new')
+      helpers.exec_lua([[
+        local lines = {}
+        for i = 1, 10000 do
+          lines[i] = ('line %d'):format(i)
+        end
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      ]])
+    end)
+
+    it('puts all lines and can be undone', function()
+      feed('gg"ay200jG"ap')
+      eq(10201, funcs.line('$'))
+      eq('line 1', funcs.getline(10001))
+      eq('line 201', funcs.getline(10201))
+      eq({ 10001, 10201 }, { funcs.line("'["), funcs.line("']") })
+      feed('u')
+      eq(10000, funcs.line('$'))
+    end)
+
+    it('can be appended to', function()
+      feed('gg"ayjG"Ayy')
+      eq({ 'line 1', 'line 2', 'line 10000' }, funcs.getreg('a', 1, 1))
+      command("let @A = 'more'")
+      command("let @A = 'text'")
+      eq({ 'line 1', 'line 2', 'line 10000', 'moretext' }, funcs.getreg('a', 1, 1))
+      feed('gg3"byyG"bp')
+      eq({ 'line 1', 'line 2', 'line 3' }, funcs.getline(10001, '$'))
+    end)
+
+    it('is shifted through the numbered registers', function()
+      for _ = 1, 10 do
+        feed('gg2dd')
+      end
+      eq({ 'line 19', 'line 20' }, funcs.getreg('1', 1, 1))
+      eq({ 'line 3', 'line 4' }, funcs.getreg('9', 1, 1))
+    end)
+  end)
+end)
@@ -2,7 +2,11 @@ local helpers = require('test.functional.helpers')(after_each)
 local clear = helpers.clear
 local command = helpers.command
 local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+local feed = helpers.feed
+local meths = helpers.meths
 local pcall_err = helpers.pcall_err
+local retry = helpers.retry
 
 describe('search (/)', function()
   before_each(clear)
@@ -13,5 +17,41 @@ describe('search (/)', function()
     eq([[Vim:E951: \% value too large]],
       pcall_err(command, "/\\v%2147483648c"))
   end)
+
+  it("with 'incsearch' finds a match after the time limit of one search", function()
+    -- When the search takes longer than half a second it stops and continues
+    -- where it stopped, the match must still be found.
+    exec_lua([[
+      local lines = {}
+      for i = 1, 50000 do
+        lines[i] = ('ab'):rep(20)
+      end
+      lines[#lines + 1] = 'needle'
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    command('set incsearch')
+    feed([[/\v(a|b)*needle]])
+    retry(nil, 20000, function()
+      eq({ 50001, 0 }, meths.win_get_cursor(0))
+    end)
+    feed('<Esc>')
+    eq({ 1, 0 }, meths.win_get_cursor(0))
+  end)
 end)
 
+describe('matching brace (%)', function()
+  before_each(clear)
+
+  it('skips braces in quotes over long lines', function()
+    local filler = ('x'):rep(2000)
+    meths.buf_set_lines(0, 0, -1, true, {
+      'f(' .. filler .. ' "(" ' .. filler,
+      filler .. " ')' é(" .. filler .. ')',
+      filler .. ')',
+    })
+    feed('gg0f(%')
+    eq({ 3, 2000 }, meths.win_get_cursor(0))
+    feed('%')
+    eq({ 1, 1 }, meths.win_get_cursor(0))
+  end)
+end)
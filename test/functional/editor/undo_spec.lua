@@ -11,6 +11,7 @@ local insert = helpers.insert
 local funcs = helpers.funcs
 local exec = helpers.exec
 local exec_lua = helpers.exec_lua
+local write_file = helpers.write_file
 
 local function lastmessage()
   local messages = funcs.split(funcs.execute('messages'), '\n')
@@ -201,3 +202,135 @@ describe(':undo! command', function()
     eq('E5767: Cannot use :undo! to redo or move to a different undo branch', eval('v:errmsg'))
   end)
 end)
+
+describe(':substitute over many lines', function()
+  before_each(clear)
+
+  local function check_undo_redo(cmd)
+    exec_lua([[
+      local lines = {}
+      for i = 1, 3000 do
+        lines[i] = (i % 7 == 0 and 'bar ' or 'foo ') .. i
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    -- Start a new undo block.
+    command('let &undolevels = &undolevels')
+    local before = funcs.getline(1, '$')
+    command(cmd)
+    local after = funcs.getline(1, '$')
+    command('undo')
+    eq(before, funcs.getline(1, '$'))
+    command('redo')
+    eq(after, funcs.getline(1, '$'))
+    command('undo')
+    eq(before, funcs.getline(1, '$'))
+  end
+
+  it('can be undone and redone', function()
+    check_undo_redo('%s/foo/xyz/')
+    check_undo_redo('%s/o/0/g')
+    check_undo_redo('500,2500s/\\d$/&&/')
+    check_undo_redo('%s/ 1/\\r1/')
+    check_undo_redo('%s/3\\n/3 /')
+  end)
+end)
+
+describe('undo of replacing all lines', function()
+  before_each(clear)
+
+  it('restores the lines around unchanged ones', function()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 1000 do
+        lines[i] = 'line ' .. i
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    command('let &undolevels = &undolevels')
+    local before = funcs.getline(1, '$')
+    exec_lua([[
+      local lines = vim.api.nvim_buf_get_lines(0, 0, -1, true)
+      lines[1] = 'first'
+      lines[500] = 'middle'
+      table.insert(lines, 700, 'added')
+      table.remove(lines, 300)
+      lines[#lines] = 'last'
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    local after = funcs.getline(1, '$')
+    -- Another change makes the previous one complete.
+    command('let &undolevels = &undolevels')
+    command('normal! Gox')
+    command('undo')
+    eq(after, funcs.getline(1, '$'))
+    command('undo')
+    eq(before, funcs.getline(1, '$'))
+    command('redo')
+    eq(after, funcs.getline(1, '$'))
+    command('undo')
+    eq(before, funcs.getline(1, '$'))
+  end)
+end)
+
+describe("'undofile'", function()
+  local fname = 'Xtest_undofile_background'
+
+  before_each(function()
+    clear()
+    command('set undofile undodir=.')
+  end)
+
+  after_each(function()
+    os.remove(fname)
+    os.remove(funcs.undofile(fname))
+  end)
+
+  it('is written in the background and read back', function()
+    command('edit ' .. fname)
+    for i = 1, 5 do
+      funcs.setline(1, 'change ' .. i)
+      command('let &undolevels = &undolevels')
+      command('write')
+    end
+    command('edit!')
+    eq('change 5', funcs.getline(1))
+    command('undo')
+    eq('change 4', funcs.getline(1))
+    eq(0, funcs.filereadable(funcs.undofile(fname) .. '.tmp~'))
+  end)
+
+  it('replaces a temporary file left behind', function()
+    command('edit ' .. fname)
+    local tmpname = funcs.undofile(fname) .. '.tmp~'
+    write_file(tmpname, 'stale')
+    funcs.setline(1, 'change')
+    command('write')
+    command('edit!')
+    eq(0, funcs.filereadable(tmpname))
+    command('undo')
+    eq('', funcs.getline(1))
+  end)
+
+  it('reads entries of the undo file when they are undone', function()
+    command('edit ' .. fname)
+    for i = 1, 5 do
+      funcs.setline(i, 'line ' .. i)
+      command('let &undolevels = &undolevels')
+    end
+    command('write')
+    command('bwipe')
+    command('edit ' .. fname)
+    -- Written again from entries that were not undone yet.
+    command('wundo! Xtest_undofile_copy')
+    command('undo 2')
+    eq({ 'line 1', 'line 2' }, funcs.getline(1, '$'))
+    command('redo')
+    eq({ 'line 1', 'line 2', 'line 3' }, funcs.getline(1, '$'))
+    command('edit!')
+    command('rundo Xtest_undofile_copy')
+    os.remove('Xtest_undofile_copy')
+    command('undo 1')
+    eq({ 'line 1' }, funcs.getline(1, '$'))
+  end)
+end)
@@ -0,0 +1,48 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local eq = helpers.eq
+local feed = helpers.feed
+local clear = helpers.clear
+local command = helpers.command
+local meths = helpers.meths
+
+describe('word motions', function()
+  before_each(clear)
+
+  local function cols(keys, n)
+    local rv = {}
+    meths.win_set_cursor(0, { 1, 0 })
+    for _ = 1, n do
+      feed(keys)
+      local pos = meths.win_get_cursor(0)
+      table.insert(rv, pos[2])
+    end
+    return rv
+  end
+
+  it('stop at class changes between ASCII and other characters', function()
+    -- "e" with a combining acute accent, a CJK word and punctuation.
+    meths.buf_set_lines(0, 0, -1, true, { 'abc de\204\129f  gh,ij \230\188\162\229\173\151x..y z' })
+    eq({ 4, 11, 13, 14, 17, 23, 24, 26 }, cols('w', 8))
+    eq({ 2, 8, 12, 13, 15, 20, 23, 25 }, cols('e', 8))
+    eq({ 4, 11, 17, 28 }, cols('W', 4))
+    meths.win_set_cursor(0, { 1, 28 })
+    feed('b')
+    eq({ 1, 26 }, meths.win_get_cursor(0))
+    feed('3b')
+    eq({ 1, 17 }, meths.win_get_cursor(0))
+    feed('B')
+    eq({ 1, 11 }, meths.win_get_cursor(0))
+  end)
+
+  it('use the buffer keyword characters', function()
+    meths.buf_set_lines(0, 0, -1, true, { 'foo-bar baz', 'next' })
+    feed('w')
+    eq({ 1, 3 }, meths.win_get_cursor(0))
+    command('setlocal iskeyword+=-')
+    feed('0w')
+    eq({ 1, 8 }, meths.win_get_cursor(0))
+    feed('w')
+    eq({ 2, 0 }, meths.win_get_cursor(0))
+  end)
+end)
@@ -3,6 +3,7 @@ local helpers = require('test.functional.helpers')(after_each)
 local clear = helpers.clear
 local command = helpers.command
 local eq = helpers.eq
+local exec_lua = helpers.exec_lua
 local funcs = helpers.funcs
 local meths = helpers.meths
 local mkdir = helpers.mkdir
@@ -42,4 +43,65 @@ describe(':help', function()
     command('help …')
     eq('*…*', meths.get_current_line())
   end)
+
+  it(':helptags merges the tags of all files, ALL skips up-to-date files', function()
+    mkdir('Xhelptags')
+    finally(function()
+      rmdir('Xhelptags')
+    end)
+    mkdir('Xhelptags/doc')
+    write_file('Xhelptags/doc/b.txt', '*xb-one* *xa-three*\n')
+    write_file('Xhelptags/doc/a.txt', '*xa-two*\n\t*xa-one*\n')
+    write_file('Xhelptags/doc/c.txt', 'no tags here\n')
+    command('set rtp=' .. funcs.getcwd() .. '/Xhelptags')
+    local tags = {
+      'xa-one\ta.txt\t/*xa-one*',
+      'xa-three\tb.txt\t/*xa-three*',
+      'xa-two\ta.txt\t/*xa-two*',
+      'xb-one\tb.txt\t/*xb-one*',
+    }
+    command('helptags ALL')
+    eq(tags, funcs.readfile('Xhelptags/doc/tags'))
+
+    --- Sets the modification time of "fname" to "secs" seconds from now.
+    local function set_mtime(fname, secs)
+      exec_lua(
+        [[
+        local fname, secs = ...
+        local t = os.time() + secs
+        assert(vim.uv.fs_utime(fname, t, t))
+      ]],
+        fname,
+        secs
+      )
+    end
+
+    write_file('Xhelptags/doc/tags', 'old\n')
+    set_mtime('Xhelptags/doc/tags', 10)
+    command('helptags ALL')
+    eq({ 'old' }, funcs.readfile('Xhelptags/doc/tags'))
+
+    -- Naming the directory always writes the tags file.
+    command('helptags Xhelptags/doc')
+    eq(tags, funcs.readfile('Xhelptags/doc/tags'))
+
+    write_file('Xhelptags/doc/tags', 'old\n')
+    set_mtime('Xhelptags/doc/tags', 10)
+    set_mtime('Xhelptags/doc/a.txt', 20)
+    command('helptags ALL')
+    eq(tags, funcs.readfile('Xhelptags/doc/tags'))
+
+    -- Adding a file to a subdirectory only changes the time of that directory.
+    mkdir('Xhelptags/doc/sub')
+    write_file('Xhelptags/doc/sub/d.txt', '*xd-one*\n')
+    write_file('Xhelptags/doc/tags', 'old\n')
+    set_mtime('Xhelptags/doc/tags', 10)
+    set_mtime('Xhelptags/doc/a.txt', 0)
+    set_mtime('Xhelptags/doc/sub/d.txt', 0)
+    set_mtime('Xhelptags/doc', 0)
+    set_mtime('Xhelptags/doc/sub', 20)
+    command('helptags ALL')
+    table.insert(tags, 'xd-one\tsub/d.txt\t/*xd-one*')
+    eq(tags, funcs.readfile('Xhelptags/doc/tags'))
+  end)
 end)
@@ -34,6 +34,23 @@ describe(':mksession', function()
     rmdir(tab_dir)
   end)
 
+  it('restores many buffers that are read ahead', function()
+    local files = {}
+    for i = 1, 30 do
+      files[i] = ('%s/file%02d'):format(tab_dir, i)
+      helpers.write_file(files[i], ('text of %d\n'):format(i))
+      command('badd ' .. files[i])
+    end
+    command('edit ' .. files[30])
+    command('mksession ' .. session_file)
+    clear()
+    command('source ' .. session_file)
+    eq('text of 30', funcs.getline(1))
+    eq(31, funcs.bufnr('$'))
+    command('buffer ' .. files[7])
+    eq('text of 7', funcs.getline(1))
+  end)
+
   it('restores same :terminal buf in splits', function()
     -- If the same :terminal is displayed in multiple windows, :mksession
     -- should restore it as such.
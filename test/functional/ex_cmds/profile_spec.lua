@@ -9,6 +9,10 @@ local tempfile = helpers.tmpname()
 local source   = helpers.source
 local matches  = helpers.matches
 local read_file = helpers.read_file
+local exec_capture = helpers.exec_capture
+local ok = helpers.ok
+local request = helpers.request
+local Screen = require('test.functional.ui.screen')
 
 -- tmpname() also creates the file on POSIX systems. Remove it again.
 -- We just need the name, ignoring any race conditions.
@@ -97,4 +101,51 @@ describe(':profile', function()
       matches('Called 1 time', profile)
     end)
   end)
+
+  describe('redraw', function()
+    it('lists the time spent redrawing', function()
+      local screen = Screen.new(40, 8)
+      screen:attach()
+      command('call setline(1, range(1, 100)) | split')
+      command('redraw!')
+      local stats = request('nvim__redraw_stats', true)
+      ok(stats.screen.count > 0)
+      ok(stats.win_line.count >= 12)
+      eq(2, #stats.windows)
+      ok(stats.windows[1].lines > 0)
+      eq(0, request('nvim__redraw_stats', false).win_line.count)
+
+      command('redraw!')
+      local report = exec_capture('profile redraw')
+      matches('COUNT%s+AVERAGE%s+PHASE', report)
+      matches('win_line', report)
+      matches('COUNT%s+LINES%s+WINDOW', report)
+      command('profile redraw clear')
+      eq({}, request('nvim__redraw_stats', false).windows)
+    end)
+  end)
+
+  describe('sample', function()
+    it('writes folded stacks of Vimscript and Lua', function()
+      source([[
+        func BusyVim()
+          let start = reltime()
+          while reltimefloat(reltime(start)) < 0.1
+          endwhile
+        endfunc
+        func BusyLua()
+          lua local t = vim.uv.hrtime(); while vim.uv.hrtime() - t < 1e8 do end
+        endfunc
+      ]])
+      command('profile sample ' .. tempfile)
+      command('call BusyVim() | call BusyLua()')
+      command('profile sample stop')
+      local samples = read_file(tempfile)
+      matches('function BusyVim %d+\n', samples)
+      matches('function BusyLua;[^\n]+:%d+ %d+\n', samples)
+      -- Stopping again does nothing.
+      command('profile sample stop')
+      eq('Vim(profile):E471: Argument required', helpers.pcall_err(command, 'profile sample'))
+    end)
+  end)
 end)
@@ -124,6 +124,104 @@ describe('quickfix', function()
     command('grep foo ' .. file)
     os.remove(file)
   end)
+
+  it("parses '%f:%l:%c:%m' and '%f:%l:%m' like the regexp does", function()
+    local lines = {
+      'src/a.c:10:5:msg one',
+      'b:c.txt:3:7:msg with: colon',
+      'weird:1:2:3:4',
+      'nocol:4:msg',
+      'x:1:2:',
+      ':1:2:no name',
+      'just text',
+    }
+    local function parse(efm)
+      local res = {}
+      for _, item in ipairs(funcs.getqflist({ lines = lines, efm = efm }).items) do
+        table.insert(res, { item.valid, funcs.bufname(item.bufnr), item.lnum, item.col, item.text })
+      end
+      return res
+    end
+
+    -- "%l\:" gives the same pattern, but is not recognized as a simple format.
+    local flcm = parse('%f:%l:%c:%m')
+    eq(parse('%f:%l\\:%c:%m'), flcm)
+    eq({ 1, 'src/a.c', 10, 5, 'msg one' }, flcm[1])
+    eq({ 1, 'b:c.txt', 3, 7, 'msg with: colon' }, flcm[2])
+    eq({ 1, 'weird', 1, 2, '3:4' }, flcm[3])
+    eq(0, flcm[4][1])
+    eq(0, flcm[5][1])
+    local flm = parse('%f:%l:%m')
+    eq(parse('%f:%l\\:%m'), flm)
+    eq({ 1, 'nocol', 4, 0, 'msg' }, flm[4])
+  end)
+
+  it('jumps to any entry of a long list', function()
+    helpers.exec_lua([[
+      local items = {}
+      for i = 1, 20000 do
+        items[i] = { filename = 'Xqf' .. (i % 7), lnum = i, text = 'entry ' .. i, user_data = { i } }
+      end
+      -- more lists than the stack can hold, so the oldest ones are freed
+      for _ = 1, 12 do
+        vim.fn.setqflist({}, ' ', { items = items })
+      end
+    ]])
+    eq(10, funcs.getqflist({ nr = '$' }).nr)
+    for _, n in ipairs({ 19000, 3, 20000, 1, 12345 }) do
+      command('silent! cc ' .. n)
+      eq(n, funcs.getqflist({ idx = 0 }).idx)
+    end
+    command('silent! cc 30000')
+    eq(20000, funcs.getqflist({ idx = 0 }).idx)
+    local item = funcs.getqflist({ idx = 12345, items = 0 }).items[1]
+    eq({ 12345, 'entry 12345', { 12345 } }, { item.lnum, item.text, item.user_data })
+  end)
+
+  it('appends %C continuation lines to the message', function()
+    local items = funcs.getqflist({
+      lines = { 'E: a.c:1: first', ' more', ' and more', 'E: b.c:2: second' },
+      efm = '%EE: %f:%l: %m,%C %m',
+    }).items
+    eq({ 'first\nmore\nand more', 'second' }, { items[1].text, items[2].text })
+  end)
+
+  it(':vimgrep finds the same matches in files that are read ahead', function()
+    local files = {}
+    for i = 1, 20 do
+      files[i] = ('%s_vimgrep_%02d'):format(file_base, i)
+      write_file(files[i], i % 5 == 0 and 'one\nfoo two\n' or 'one\ntwo\n')
+    end
+    write_file(files[3], 'foo\r\nbar\r\n')
+    write_file(files[4], '\239\187\191foo\n')
+    local function vimgrep(pat)
+      command('silent! vimgrep /' .. pat .. '/j ' .. file_base .. '_vimgrep_*')
+      local res = {}
+      for _, item in ipairs(funcs.getqflist()) do
+        table.insert(res, { funcs.bufname(item.bufnr), item.lnum, item.col })
+      end
+      return res
+    end
+
+    eq({
+      { files[5], 2, 1 },
+      { files[10], 2, 1 },
+      { files[15], 2, 1 },
+      { files[20], 2, 1 },
+    }, vimgrep('foo two'))
+    -- CR line breaks and a BOM are removed when loading the file.
+    eq({ { files[3], 1, 1 }, { files[4], 1, 1 } }, vimgrep('^foo$'))
+    -- Line numbers only work in a buffer.
+    eq({
+      { files[5], 2, 1 },
+      { files[10], 2, 1 },
+      { files[15], 2, 1 },
+      { files[20], 2, 1 },
+    }, vimgrep([[\%2lfoo]]))
+    for _, f in ipairs(files) do
+      os.remove(f)
+    end
+  end)
 end)
 
 it(':vimgrep can specify Unicode pattern without delimiters', function()
@@ -0,0 +1,71 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local meths = helpers.meths
+
+before_each(clear)
+
+describe(':sort', function()
+  --- Sorts "lines" on "keys" like :sort should: stable, and with reverse
+  --- order for "!".
+  local function expected(lines, keys, reverse)
+    local idx = {}
+    for i = 1, #lines do
+      idx[i] = i
+    end
+    table.sort(idx, function(a, b)
+      if keys[a] ~= keys[b] then
+        return keys[a] < keys[b]
+      end
+      return a < b
+    end)
+    local res = {}
+    for i, j in ipairs(idx) do
+      res[reverse and #lines - i + 1 or i] = lines[j]
+    end
+    return res
+  end
+
+  local function sorted(lines, cmd)
+    meths.buf_set_lines(0, 0, -1, false, lines)
+    command(cmd)
+    return meths.buf_get_lines(0, 0, -1, false)
+  end
+
+  it('sorts many numbers stably', function()
+    local lines, keys = {}, {}
+    local seed = 7
+    for i = 1, 5000 do
+      seed = (seed * 1103515245 + 12345) % 2147483648
+      if i % 50 == 0 then
+        -- no number, sorts before all numbers
+        lines[i] = 'no number ' .. string.char(97 + i % 26)
+        keys[i] = -math.huge
+      else
+        local n = (seed % 2001) - 1000
+        if i % 97 == 0 then
+          n = n * 1000000000
+        end
+        lines[i] = ('%d %s'):format(n, string.char(97 + i % 26))
+        keys[i] = n
+      end
+    end
+    eq(expected(lines, keys), sorted(lines, 'sort n'))
+    eq(expected(lines, keys, true), sorted(lines, 'sort! n'))
+  end)
+
+  it('sorts floats and hex numbers', function()
+    eq(
+      { '', '-1.5e3', '-0.0 a', '0 b', '-0.0 c', '2.5', '1e10' },
+      sorted({ '2.5', '-0.0 a', '1e10', '', '0 b', '-1.5e3', '-0.0 c' }, 'sort f')
+    )
+    eq({ 'x', '0x1', 'a', 'ff', '0x100' }, sorted({ '0x100', 'ff', 'x', 'a', '0x1' }, 'sort x'))
+  end)
+
+  it('sorts on a pattern match', function()
+    eq({ 'b 1', 'c 2', 'a 2' }, sorted({ 'c 2', 'a 2', 'b 1' }, [[sort /\a /]]))
+    eq({ 'y02 a', 'z10 a', 'x10 b' }, sorted({ 'z10 a', 'x10 b', 'y02 a' }, [[sort /\d\+/ r]]))
+  end)
+end)
@@ -3,6 +3,10 @@ local helpers = require('test.functional.helpers')(after_each)
 local eq = helpers.eq
 local clear = helpers.clear
 local exc_exec = helpers.exc_exec
+local command = helpers.command
+local exec_lua = helpers.exec_lua
+local ok = helpers.ok
+local request = helpers.request
 
 describe(':syntax', function()
   before_each(clear)
@@ -14,4 +18,45 @@ describe(':syntax', function()
          exc_exec('syntax keyword \024 foo bar'))
     end)
   end)
+
+  describe('match', function()
+    it('skips patterns whose text is not in the line', function()
+      exec_lua([[
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, {
+          'foo = bar(1)',
+          'nothing here',
+          'x := "string"',
+          'call baz',
+          'Foo = BAR(1)',
+        })
+      ]])
+      command('syntax case match')
+      command([[syntax match Assign /\w\+ =/]])
+      command([[syntax match Call /\<call\>/]])
+      command([[syntax region Str start=/"/ end=/"/]])
+      command([[syntax match Number /^x\>/]])
+      command('syntax case ignore')
+      command([[syntax match Bar /bar(/]])
+      local before = request('nvim__stats').syntax_skip
+      local function names(lnum)
+        return exec_lua(
+          [[
+          local lnum = ...
+          local r = {}
+          for col = 1, #vim.fn.getline(lnum) do
+            r[#r + 1] = vim.fn.synIDattr(vim.fn.synID(lnum, col, 0), 'name')
+          end
+          return table.concat(r, ',')
+        ]],
+          lnum
+        )
+      end
+      eq('Assign,Assign,Assign,Assign,Assign,,Bar,Bar,Bar,Bar,,', names(1))
+      eq(',,,,,,,,,,,', names(2))
+      eq('Number,,,,,Str,Str,Str,Str,Str,Str,Str,Str', names(3))
+      eq('Call,Call,Call,Call,,,,', names(4))
+      eq('Assign,Assign,Assign,Assign,Assign,,Bar,Bar,Bar,Bar,,', names(5))
+      ok(request('nvim__stats').syntax_skip > before)
+    end)
+  end)
 end)
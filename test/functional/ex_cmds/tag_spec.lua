@@ -0,0 +1,63 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local funcs = helpers.funcs
+local write_file = helpers.write_file
+
+describe('tags file index', function()
+  local tagsfile = 'Xtags_index'
+
+  before_each(function()
+    clear()
+    command('set tags=' .. tagsfile)
+  end)
+
+  after_each(function()
+    os.remove(tagsfile)
+  end)
+
+  local function names(pat)
+    local res = {}
+    for _, t in ipairs(funcs.taglist(pat)) do
+      table.insert(res, t.name .. ':' .. t.cmd)
+    end
+    return res
+  end
+
+  it('finds tags in an unsorted file, also ignoring case', function()
+    write_file(
+      tagsfile,
+      table.concat({
+        '!_TAG_FILE_SORTED\t0\t//',
+        'zeta\tXfoo.c\t/^zeta/',
+        'Foo\tXfoo.c\t/^Foo/',
+        'foobar\tXfoo.c\t/^foobar/',
+        'alpha\tXfoo.c\t/^alpha/',
+        'foo\tXfoo.c\t/^foo/',
+        'foo\tXbar.c\t/^foo2/',
+        '',
+      }, '\n')
+    )
+    command('set noignorecase')
+    eq({ 'foo:/^foo/', 'foo:/^foo2/' }, names('^foo$'))
+    eq({ 'foobar:/^foobar/', 'foo:/^foo/', 'foo:/^foo2/' }, names('^foo'))
+    command('set ignorecase')
+    -- matches that only ignore case come last
+    eq({ 'foo:/^foo/', 'foo:/^foo2/', 'Foo:/^Foo/' }, names('^foo$'))
+    eq({ 'Foo', 'foo', 'foobar' }, funcs.sort(funcs.getcompletion('fo', 'tag')))
+    eq({}, names('^bar'))
+    -- a tag from the header is not found
+    eq({}, names('^!_TAG'))
+  end)
+
+  it('reads the file again when it changed', function()
+    write_file(tagsfile, 'one\tXfoo.c\t/^one/\n')
+    eq({ 'one:/^one/' }, names('^one$'))
+    -- make sure the size differs when the time stamp does not
+    write_file(tagsfile, 'one\tXfoo.c\t/^one again/\ntwo\tXfoo.c\t/^two/\n')
+    eq({ 'one:/^one again/' }, names('^one$'))
+    eq({ 'two:/^two/' }, names('^two$'))
+  end)
+end)
@@ -96,6 +96,24 @@ describe(':write', function()
     fifo:close()
   end)
 
+  it('writes many lines, NULs and a missing EOL', function()
+    helpers.exec_lua([[
+      local lines = {}
+      for i = 1, 10000 do
+        lines[i] = ('line %d'):format(i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      vim.fn.setline(5000, 'a\nb\n')
+    ]])
+    command('set nofixeol noeol')
+    command('write ' .. fname)
+    local expected = {}
+    for i = 1, 10000 do
+      expected[i] = i == 5000 and 'a\0b\0' or ('line %d'):format(i)
+    end
+    eq(table.concat(expected, '\n'), helpers.read_file(fname))
+  end)
+
   it("++p creates missing parent directories", function()
     eq(0, eval("filereadable('p_opt.txt')"))
     command("write ++p p_opt.txt")
@@ -397,6 +397,74 @@ describe('messages', function()
       ]])
     end)
 
+    it('shows the last screen with G after scrolling back', function()
+      screen = Screen.new(40, 6)
+      screen:set_default_attr_ids({
+        [1] = {bold = true, foreground = Screen.colors.SeaGreen},  -- MoreMsg
+        [2] = {foreground = Screen.colors.Brown},  -- LineNr
+      })
+      screen:attach()
+
+      command('call setline(1, range(1, 30))')
+      feed(':%p#\n')
+      screen:expect([[
+        {2:  1 }1                                   |
+        {2:  2 }2                                   |
+        {2:  3 }3                                   |
+        {2:  4 }4                                   |
+        {2:  5 }5                                   |
+        {1:-- More --}^                              |
+      ]])
+      feed('G')
+      screen:expect([[
+        {2: 26 }26                                  |
+        {2: 27 }27                                  |
+        {2: 28 }28                                  |
+        {2: 29 }29                                  |
+        {2: 30 }30                                  |
+        {1:Press ENTER or type command to continue}^ |
+      ]])
+
+      -- Back to the top and one line down, then all the way down again.
+      feed('gj')
+      screen:expect([[
+        {2:  1 }1                                   |
+        {2:  2 }2                                   |
+        {2:  3 }3                                   |
+        {2:  4 }4                                   |
+        {2:  5 }5                                   |
+        {1:-- More --}^                              |
+      ]])
+      feed('G')
+      screen:expect([[
+        {2: 26 }26                                  |
+        {2: 27 }27                                  |
+        {2: 28 }28                                  |
+        {2: 29 }29                                  |
+        {2: 30 }30                                  |
+        {1:Press ENTER or type command to continue}^ |
+      ]])
+      -- The lines jumped over are still there when scrolling back.
+      feed('kk')
+      screen:expect([[
+        {2: 24 }24                                  |
+        {2: 25 }25                                  |
+        {2: 26 }26                                  |
+        {2: 27 }27                                  |
+        {2: 28 }28                                  |
+        {1:-- More --}^                              |
+      ]])
+      feed('G')
+      screen:expect([[
+        {2: 26 }26                                  |
+        {2: 27 }27                                  |
+        {2: 28 }28                                  |
+        {2: 29 }29                                  |
+        {2: 30 }30                                  |
+        {1:Press ENTER or type command to continue}^ |
+      ]])
+    end)
+
     -- oldtest: Test_echo_verbose_system()
     it('verbose message before echo command', function()
       screen = Screen.new(60, 10)
@@ -70,6 +70,31 @@ describe('vim.base64', function()
     end
   end)
 
+  it('works with binary data and long input', function()
+    eq(
+      true,
+      exec_lua([[
+        local bytes = {}
+        for i = 0, 255 do
+          bytes[#bytes + 1] = string.char(i)
+        end
+        local all = table.concat(bytes)
+        assert(vim.base64.encode('\0a\0') == 'AGEA')
+        assert(vim.base64.decode('AGEA') == '\0a\0')
+        for _, n in ipairs({ 1, 2, 3, 100, 1000 }) do
+          local s = all:rep(n)
+          for _, len in ipairs({ #s, #s - 1, #s - 2 }) do
+            local v = s:sub(1, len)
+            local enc = vim.base64.encode(v)
+            assert(#enc == math.ceil(len / 3) * 4)
+            assert(vim.base64.decode(enc) == v)
+          end
+        end
+        return true
+      ]])
+    )
+  end)
+
   it('detects invalid input', function()
     local invalid = {
       'A',
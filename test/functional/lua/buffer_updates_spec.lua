@@ -262,6 +262,22 @@ describe('lua buffer event callbacks: on_lines', function()
     eq(1, meths.get_var('listener_cursor_line'))
   end)
 
+  it('sends one event for a blockwise shift', function()
+    meths.buf_set_lines(0, 0, -1, true, {'a b', 'c d', 'e f', 'g h'})
+    command('set expandtab shiftwidth=4')
+    exec_lua([[
+      linesev = {}
+      vim.api.nvim_buf_attach(0, false, {
+        on_lines = function(_, _, _, first, last, new_last)
+          table.insert(linesev, { first, last, new_last })
+        end,
+      })
+    ]])
+    feed('1G2|<C-v>2j>')
+    eq({'a     b', 'c     d', 'e     f', 'g h'}, meths.buf_get_lines(0, 0, -1, true))
+    eq({ { 0, 3, 3 } }, exec_lua('return linesev'))
+  end)
+
   it('has valid cursor position while deleting lines', function()
     meths.buf_set_lines(0, 0, -1, true, { "line_1", "line_2", "line_3", "line_4"})
     meths.win_set_cursor(0, {2, 0})
@@ -73,3 +73,57 @@ describe('ffi.cdef', function()
     ]])
   end)
 end)
+
+describe('buffer accessors for ffi', function()
+  it('read lines without copying', function()
+    if not exec_lua("return pcall(require, 'ffi')") then
+      pending('missing LuaJIT FFI')
+    end
+
+    eq({ true, 3, 'bar', { 'foo', 'bar', '' }, true, { -1, -1, true } }, exec_lua [=[
+      local ffi = require('ffi')
+
+      ffi.cdef[[
+        int64_t nlua_buf_changedtick(int bufnr);
+        int64_t nlua_buf_line_count(int bufnr);
+        const char *nlua_buf_get_line(int bufnr, int64_t lnum, size_t *len);
+        int nlua_buf_get_lines(int bufnr, int64_t lnum, int maxcount,
+                               const char **lines, int *lens);
+      ]]
+
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, { 'foo', 'bar', '' })
+      local tick = ffi.C.nlua_buf_changedtick(0)
+      local len = ffi.new('size_t[1]')
+      local line = ffi.C.nlua_buf_get_line(0, 2, len)
+      local text = ffi.string(line, len[0])
+
+      local lines = ffi.new('const char *[10]')
+      local lens = ffi.new('int[10]')
+      local all = {}
+      local lnum = 1
+      while lnum <= ffi.C.nlua_buf_line_count(0) do
+        local n = ffi.C.nlua_buf_get_lines(0, lnum, 10, lines, lens)
+        for i = 0, n - 1 do
+          all[#all + 1] = ffi.string(lines[i], lens[i])
+        end
+        lnum = lnum + n
+      end
+
+      vim.api.nvim_buf_set_lines(0, 0, 1, true, { 'baz' })
+      local nobuf = vim.api.nvim_create_buf(false, true)
+      vim.api.nvim_buf_delete(nobuf, {})
+      return {
+        tick == vim.b.changedtick,
+        tonumber(ffi.C.nlua_buf_line_count(0)),
+        text,
+        all,
+        ffi.C.nlua_buf_changedtick(0) > tick,
+        {
+          tonumber(ffi.C.nlua_buf_line_count(nobuf)),
+          tonumber(ffi.C.nlua_buf_changedtick(nobuf)),
+          ffi.C.nlua_buf_get_line(0, 4, len) == nil,
+        },
+      }
+    ]=])
+  end)
+end)
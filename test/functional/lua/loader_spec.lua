@@ -34,6 +34,27 @@ describe('vim.loader', function()
     ]], tmp))
   end)
 
+  it('caches files run with dofile() and :source', function()
+    exec_lua[[
+      vim.loader.enable()
+    ]]
+
+    local tmp = helpers.tmpname() .. '.lua'
+    helpers.write_file(tmp, '_G.TEST = (_G.TEST or 0) + 1 return _G.TEST', true)
+    finally(function()
+      os.remove(tmp)
+    end)
+
+    eq(1, exec_lua('return dofile(...)', tmp))
+    eq(2, exec_lua('return dofile(...)', tmp))
+    command('source ' .. tmp)
+    eq(3, exec_lua('return _G.TEST'))
+    eq(true, exec_lua([[
+      local name = vim.uri_encode(vim.fs.normalize(..., { expand_env = false }), 'rfc2396')
+      return vim.uv.fs_stat(vim.loader.path .. '/' .. name .. 'c') ~= nil
+    ]], tmp))
+  end)
+
   it('handles % signs in modpath (#24491)', function()
     exec_lua[[
       vim.loader.enable()
@@ -308,4 +308,18 @@ describe('runtime:', function()
     end)
   end)
 
+  describe('index', function()
+    it('finds a directory created after a lookup', function()
+      exec('let g:seq = ""')
+      exec('runtime! plugin/Xindex.vim')
+      eq('', eval('g:seq'))
+      local plugin_folder = table.concat({plug_dir, 'plugin'}, sep)
+      mkdir_p(plugin_folder)
+      write_file(table.concat({plugin_folder, 'Xindex.vim'}, sep), [[let g:seq ..= 'A']])
+      exec('runtime! plugin/Xindex.vim')
+      eq('A', eval('g:seq'))
+      eq(1, #funcs.nvim_get_runtime_file('plugin/Xindex.vim', true))
+    end)
+  end)
+
 end)
@@ -380,3 +380,35 @@ describe('threadpool', function()
     end)
   end)
 end)
+
+describe('vim.worker', function()
+  before_each(clear)
+
+  it('handles messages in order until closed', function()
+    exec_lua [[
+      local worker = vim.worker(function(msg)
+        if msg.fail then
+          error('failed', 0)
+        end
+        local sum = 0
+        for _, line in ipairs(msg.lines) do
+          sum = sum + #line
+        end
+        return { sum = sum, thread = vim.is_thread() }
+      end, function(err, result)
+        vim.rpcnotify(1, 'result', err or result, vim.in_fast_event())
+      end)
+      worker:send({ lines = { 'a', 'bb', 'ccc' } })
+      worker:send({ fail = true })
+      worker:send({ lines = vim.api.nvim_buf_get_lines(0, 0, -1, true) })
+      worker:close()
+      _G.worker = worker
+    ]]
+
+    eq({ 'notification', 'result', { { sum = 6, thread = true }, false } }, next_msg())
+    eq({ 'notification', 'result', { 'failed', false } }, next_msg())
+    eq({ 'notification', 'result', { { sum = 0, thread = true }, false } }, next_msg())
+    eq('vim.worker: worker is closed', pcall_err(exec_lua, 'worker:send({})'):match('vim.worker: .*'))
+    assert_alive()
+  end)
+end)
@@ -970,6 +970,53 @@ describe('lua stdlib', function()
     exec_lua([[timer:close()]])
   end)
 
+  it('vim.rpcrequest_async', function()
+    exec_lua([[
+      chan = vim.fn.jobstart({'cat'}, {rpc=true})
+      results = {}
+      for i = 1, 10 do
+        vim.rpcrequest_async(chan, 'nvim_eval', { tostring(i) .. ' * 2' }, function(err, res)
+          results[i] = { err, res }
+        end)
+      end
+    ]])
+    retry(nil, nil, function()
+      eq(10, exec_lua([[return vim.tbl_count(results)]]))
+    end)
+    eq({ true, 6 }, exec_lua([[return { results[3][1] == nil, results[3][2] }]]))
+    eq({ true, 20 }, exec_lua([[return { results[10][1] == nil, results[10][2] }]]))
+
+    -- resumes a coroutine
+    exec_lua([[
+      co_res = nil
+      coroutine.wrap(function()
+        local a = vim.rpcrequest_async(chan, 'nvim_eval', { '"a"' })
+        local ok, err = pcall(vim.rpcrequest_async, chan, 'nvim_eval', { 'foobar' })
+        co_res = { a, ok, err }
+      end)()
+    ]])
+    retry(nil, nil, function()
+      eq({ 'a', false, 'Vim:E121: Undefined variable: foobar' }, exec_lua([[return co_res]]))
+    end)
+
+    eq({ false, 'Invalid channel: 23' },
+       exec_lua([[return { pcall(vim.rpcrequest_async, 23, 'foo', {}, function() end) }]]))
+    matches('on_response is required outside of a coroutine',
+       pcall_err(exec_lua, [[vim.rpcrequest_async(chan, 'nvim_eval', { '1' })]]))
+
+    -- pending requests fail when the channel is closed
+    exec_lua([[
+      closed = nil
+      vim.rpcrequest_async(chan, 'nvim_command', { 'sleep 100m' }, function(err)
+        closed = err
+      end)
+      vim.fn.jobstop(chan)
+    ]])
+    retry(nil, nil, function()
+      eq('Invalid channel: ' .. exec_lua('return chan'), exec_lua([[return closed]]))
+    end)
+  end)
+
   it('vim.empty_dict()', function()
     eq({true, false, true, true}, exec_lua([[
       vim.api.nvim_set_var('listy', {})
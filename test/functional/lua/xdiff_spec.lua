@@ -153,4 +153,39 @@ describe('xdiff bindings', function()
       pcall_err(exec_lua, [[vim.diff('a', 'b', { on_hunk = true })]]))
 
   end)
+
+  describe('vim.diff_async()', function()
+    local function diff_async(a, b, opts)
+      return exec_lua([[
+        local a, b, opts = ...
+        local done
+        vim.diff_async(a, b, opts, function(err, result)
+          done = { err or vim.NIL, result }
+        end)
+        assert(vim.wait(10000, function() return done ~= nil end))
+        return done
+      ]], a, b, opts)
+    end
+
+    it('gives the same results as vim.diff()', function()
+      local a = 'Hello\nbye\nfoo\n'
+      local b = 'Helli\nbye\nbar\nbaz\n'
+      for _, opts in ipairs({
+        vim.NIL,
+        { result_type = 'indices' },
+        { result_type = 'indices', linematch = true },
+        { algorithm = 'histogram', ctxlen = 0 },
+      }) do
+        local expected = exec_lua('return vim.diff(...)', a, b, opts ~= vim.NIL and opts or nil)
+        eq({ vim.NIL, expected }, diff_async(a, b, opts))
+      end
+    end)
+
+    it('can handle bad args', function()
+      eq([[on_hunk is not supported]],
+        pcall_err(exec_lua, [[vim.diff_async('a', 'b', { on_hunk = function() end }, print)]]))
+      eq([[bad argument #4 to 'diff_async' (function expected)]],
+        pcall_err(exec_lua, [[vim.diff_async('a', 'b', nil, true)]]))
+    end)
+  end)
 end)
@@ -0,0 +1,107 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local eval = helpers.eval
+local exec_lua = helpers.exec_lua
+local funcs = helpers.funcs
+local write_file = helpers.write_file
+
+describe("'lazytabpages'", function()
+  local files = { 'Xlazytab1', 'Xlazytab2', 'Xlazytab3' }
+
+  before_each(function()
+    for i, fname in ipairs(files) do
+      write_file(fname, ('line %d\nsecond\n'):format(i))
+    end
+  end)
+
+  after_each(function()
+    for _, fname in ipairs(files) do
+      os.remove(fname)
+    end
+  end)
+
+  local function start(lazy)
+    clear({
+      args = {
+        '--cmd',
+        lazy and 'set lazytabpages' or 'set nolazytabpages',
+        '--cmd',
+        'let g:reads = [] | autocmd BufReadPost * call add(g:reads, expand("<afile>"))',
+        '--cmd',
+        'let g:enters = [] | autocmd BufEnter * call add(g:enters, expand("<afile>"))',
+        '-p',
+        files[1],
+        files[2],
+        files[3],
+      },
+    })
+  end
+
+  it('only reads the file of the first tab page', function()
+    start(true)
+    eq(3, funcs.tabpagenr('$'))
+    eq({ files[1] }, eval('g:reads'))
+    eq({ 1, 0, 0 }, { funcs.bufloaded(files[1]), funcs.bufloaded(files[2]), funcs.bufloaded(files[3]) })
+    -- The tab pages show the right buffers before they are entered.
+    eq(funcs.bufnr(files[2]), funcs.tabpagebuflist(2)[1])
+    eq(funcs.bufnr(files[3]), funcs.tabpagebuflist(3)[1])
+
+    command('let g:enters = []')
+    command('tabnext')
+    eq({ files[1], files[2] }, eval('g:reads'))
+    eq({ files[2] }, eval('g:enters'))
+    eq({ 'line 2', 'second' }, funcs.getline(1, '$'))
+    eq(0, funcs.bufloaded(files[3]))
+
+    -- Closing a tab page loads the one it goes to.
+    command('tabclose')
+    eq(files[3], funcs.bufname())
+    eq({ 'line 3', 'second' }, funcs.getline(1, '$'))
+    eq({ files[1], files[2], files[3] }, eval('g:reads'))
+
+    command('tabnext')
+    eq({ files[1], files[2], files[3] }, eval('g:reads'))
+  end)
+
+  it('reads the file when code is executed in the window', function()
+    start(true)
+    command('call win_execute(win_getid(1, 3), "let g:lines = getline(1, \'$\')")')
+    eq({ 'line 3', 'second' }, eval('g:lines'))
+    eq({ files[1], files[3] }, eval('g:reads'))
+    eq(1, funcs.tabpagenr())
+
+    eq(
+      'line 2',
+      exec_lua([[
+        local win = vim.fn.win_getid(1, 2)
+        return vim.api.nvim_win_call(win, function()
+          return vim.fn.getline(1)
+        end)
+      ]])
+    )
+    eq({ files[1], files[3], files[2] }, eval('g:reads'))
+  end)
+
+  it('sets the alternate file like loading at startup', function()
+    local function alternates()
+      local alt = {}
+      for i = 2, 3 do
+        command('tabnext ' .. i)
+        alt[i - 1] = funcs.expand('#')
+      end
+      return alt
+    end
+    start(false)
+    local expected = alternates()
+    start(true)
+    eq(expected, alternates())
+  end)
+
+  it('reads all files when off', function()
+    start(false)
+    eq({ files[1], files[2], files[3] }, eval('g:reads'))
+  end)
+end)
@@ -0,0 +1,107 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+local mkdir = helpers.mkdir
+local ok = helpers.ok
+local request = helpers.request
+local rmdir = helpers.rmdir
+
+describe("'maxmem'", function()
+  local swapdir = 'Xtest_maxmem_swapdir'
+  local fname = 'Xtest_maxmem_file'
+
+  before_each(function()
+    mkdir(swapdir)
+    clear({ args = { '--cmd', 'set swapfile directory=' .. swapdir } })
+    exec_lua([[
+      local lines = {}
+      for i = 1, 20000 do
+        lines[i] = ('%05d'):format(i) .. string.rep('x', 75)
+      end
+      vim.fn.writefile(lines, ...)
+    ]], fname)
+  end)
+
+  after_each(function()
+    command('bwipe!')
+    os.remove(fname)
+    rmdir(swapdir)
+  end)
+
+  local function check_lines()
+    return exec_lua([[
+      for i = 1, 20000 do
+        if vim.fn.getline(i) ~= ('%05d'):format(i) .. string.rep('x', 75) then
+          return i
+        end
+      end
+      return 0
+    ]])
+  end
+
+  it('releases blocks that can be read back from the swapfile', function()
+    command('set maxmem=64')
+    command('edit ' .. fname)
+    eq(0, check_lines())
+    local stats = request('nvim__stats')
+    ok(stats.memfile_evict > 0)
+    ok(stats.memfile_miss > 0)
+
+    -- Changes survive the block being released.
+    command('1,20000s/x$/y/')
+    command('set maxmem=16')
+    eq('00001' .. string.rep('x', 74) .. 'y', exec_lua('return vim.fn.getline(1)'))
+    eq('20000' .. string.rep('x', 74) .. 'y', exec_lua('return vim.fn.getline(20000)'))
+  end)
+
+  it('compresses blocks of a buffer without a swapfile', function()
+    command('set noswapfile maxmem=64')
+    command('edit ' .. fname)
+    eq(0, check_lines())
+    local stats = request('nvim__stats')
+    ok(stats.memfile_pack > 0)
+    eq(0, stats.memfile_evict)
+
+    command('1,20000s/x$/y/')
+    eq('00001' .. string.rep('x', 74) .. 'y', exec_lua('return vim.fn.getline(1)'))
+    eq('20000' .. string.rep('x', 74) .. 'y', exec_lua('return vim.fn.getline(20000)'))
+  end)
+
+  it('keeps all blocks in memory by default', function()
+    command('edit ' .. fname)
+    eq(0, check_lines())
+    local stats = request('nvim__stats')
+    eq(0, stats.memfile_evict)
+    eq(0, stats.memfile_pack)
+  end)
+end)
+
+describe("'maxmemundo'", function()
+  before_each(clear)
+
+  it('compresses old undo blocks and undoes through them', function()
+    command('set maxmemundo=64 undolevels=1000')
+    exec_lua([[
+      local lines = {}
+      for i = 1, 2000 do
+        lines[i] = ('%05d'):format(i) .. string.rep('x', 75)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    for i = 1, 10 do
+      command('let &undolevels = &undolevels')
+      command(('%%s/^\\d\\+/&%d/'):format(i))
+    end
+    ok(request('nvim__stats').undo_pack > 0)
+    eq('0000112345678910' .. string.rep('x', 75), exec_lua('return vim.fn.getline(1)'))
+    -- Back to the text set above.
+    command('undo 1')
+    eq('00001' .. string.rep('x', 75), exec_lua('return vim.fn.getline(1)'))
+    eq('02000' .. string.rep('x', 75), exec_lua('return vim.fn.getline(2000)'))
+    command('redo')
+    eq('000011' .. string.rep('x', 75), exec_lua('return vim.fn.getline(1)'))
+  end)
+end)
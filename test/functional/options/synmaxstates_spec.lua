@@ -0,0 +1,57 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+
+describe("'synmaxstates'", function()
+  before_each(function()
+    clear()
+    -- A region of 50 lines every 100 lines.
+    exec_lua([[
+      local lines = {}
+      for i = 1, 50000 do
+        local n = (i - 1) % 100
+        lines[i] = n == 0 and 'begin' or n == 49 and 'end' or ('text %d'):format(i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    command('syntax on')
+    command('syntax region Block start=/^begin/ end=/^end/')
+    command('syntax sync fromstart')
+  end)
+
+  --- Returns the first of "lnums" where the syntax item is wrong, or 0.
+  local function check_jumps(lnums)
+    return exec_lua(
+      [[
+      for _, lnum in ipairs(...) do
+        local want = (lnum - 1) % 100 < 50 and 'Block' or ''
+        if vim.fn.synIDattr(vim.fn.synID(lnum, 1, 0), 'name') ~= want then
+          return lnum
+        end
+      end
+      return 0
+    ]],
+      lnums
+    )
+  end
+
+  local jumps = { 1, 40000, 20025, 20010, 49990, 125, 30060, 29990, 40000, 20025 }
+
+  it('highlights correctly with few states', function()
+    command('set synmaxstates=0')
+    eq(0, check_jumps(jumps))
+    command('set synmaxstates=150')
+    eq(0, check_jumps(jumps))
+  end)
+
+  it('highlights correctly with many states', function()
+    command('set synmaxstates=100000')
+    eq(0, check_jumps(jumps))
+    for lnum = 30000, 29000, -37 do
+      eq(0, check_jumps({ lnum }))
+    end
+  end)
+end)
@@ -71,6 +71,74 @@ describe('ShaDa support code', function()
     eq(1, found)
   end)
 
+  it('appends to the file with `a` item until it is too large', function()
+    local function count_entries()
+      local headers, hist = 0, {}
+      for _, v in ipairs(read_shada_file(shada_fname)) do
+        if v.type == 1 then
+          headers = headers + 1
+        elseif v.type == 4 then
+          hist[v.value[2]] = (hist[v.value[2]] or 0) + 1
+        end
+      end
+      return headers, hist
+    end
+    local function read_all()
+      local fd = io.open(shada_fname, 'rb')
+      local text = fd:read('*a')
+      fd:close()
+      return text
+    end
+
+    funcs.histadd(':', 'first')
+    eq(0, exc_exec('wshada ' .. shada_fname))
+    local written = read_all()
+    nvim_command('set shada+=a100')
+    funcs.histadd(':', 'second')
+    eq(0, exc_exec('wshada ' .. shada_fname))
+    local appended = read_all()
+    eq(written, appended:sub(1, #written))
+    local headers, hist = count_entries()
+    eq(2, headers)
+    eq(1, hist.second)
+
+    -- Larger than the limit: merged and written again.
+    nvim_command('set shada-=a100 shada+=a0')
+    eq(0, exc_exec('wshada ' .. shada_fname))
+    headers, hist = count_entries()
+    eq({ 1, { first = 1, second = 1 } }, { headers, hist })
+  end)
+
+  it('merges with a file that was not changed by other instances', function()
+    funcs.histadd(':', 'first')
+    funcs.setreg('a', 'register a')
+    eq(0, exc_exec('wshada ' .. shada_fname))
+    funcs.histadd(':', 'second')
+    funcs.histdel(':', 'first')
+    eq(0, exc_exec('wshada ' .. shada_fname))
+    local hist, regs = {}, 0
+    for _, v in ipairs(read_shada_file(shada_fname)) do
+      if v.type == 4 then
+        hist[#hist + 1] = v.value[2]
+      elseif v.type == 5 then
+        regs = regs + 1
+      end
+    end
+    -- Entries deleted since the last write are not taken back from the file.
+    eq({ { 'second' }, 1 }, { hist, regs })
+  end)
+
+  it('reads history and registers on first use with `l` item', function()
+    funcs.histadd(':', 'from shada')
+    funcs.setreg('a', 'register a')
+    eq(0, exc_exec('wshada'))
+    reset('set shada+=l')
+    funcs.histadd(':', 'new')
+    eq('new', funcs.histget(':', -1))
+    eq('from shada', funcs.histget(':', -2))
+    eq('register a', funcs.getreg('a'))
+  end)
+
   it('leaves .tmp.a in-place when there is error in original ShaDa', function()
     wshada('Some text file')
     eq('Vim(wshada):E576: Error while reading ShaDa file: last entry specified that it occupies 109 bytes, but file ended earlier', exc_exec('wshada ' .. shada_fname))
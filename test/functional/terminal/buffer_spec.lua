@@ -516,6 +516,23 @@ describe('termopen()', function()
       pcall_err(funcs.termopen, "bar"))
   end)
 
+  it("with 'termcoalesce' passes on the output before the exit message", function()
+    if skip(is_os('win'), 'Not applicable for Windows') then return end
+    -- Long enough that only exiting can flush the output.
+    command('set termcoalesce=100000')
+    local screen = Screen.new(50, 4)
+    screen:attach()
+    funcs.termopen({
+      nvim_prog, '-u', 'NONE', '-i', 'NONE', '--headless',
+      '-c', 'echo "coalesced" | quit',
+    })
+    screen:expect([[
+      ^coalesced                                         |
+      [Process exited 0]                                |
+                                                        |*2
+    ]])
+  end)
+
   describe('$COLORTERM value', function()
     if skip(is_os('win'), 'Not applicable for Windows') then return end
 
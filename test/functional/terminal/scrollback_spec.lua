@@ -484,6 +484,26 @@ describe("'scrollback' option", function()
     eq(scrollback + term_height, eval('line("$")'))
   end)
 
+  it('keeps the last lines in order when output floods the scrollback', function()
+    local screen = thelpers.screen_setup(nil, nil, 30)
+    meths.set_option_value('scrollback', 100, {})
+    local lines = {}
+    for i = 1, 3000 do
+      table.insert(lines, 'line'..tostring(i))
+    end
+    table.insert(lines, '')
+    feed_data(lines)
+    screen:expect{any='line3000'}
+    retry(nil, nil, function()
+      -- 100 lines of scrollback, 5 screen rows with text and the cursor row.
+      local buflines = meths.buf_get_lines(0, 0, -1, true)
+      eq(106, #buflines)
+      for i = 1, 105 do
+        eq('line'..tostring(2895 + i), buflines[i])
+      end
+    end)
+  end)
+
   it('defaults to 10000 in :terminal buffers', function()
     set_fake_shell()
     command('terminal')
@@ -1528,6 +1528,7 @@ describe('TUI', function()
         ext_termcolors = true,
         ext_wildmenu = false,
         height = 6,
+        max_fps = 0,
         override = false,
         rgb = false,
         stdin_tty = true,
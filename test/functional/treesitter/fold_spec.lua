@@ -559,6 +559,36 @@ t3]])
 
   end)
 
+  it("only evaluates foldexpr again near the changed lines", function()
+    exec_lua([[
+      local lines = vim.split(..., '\n')
+      local all = {}
+      for _ = 1, 50 do
+        vim.list_extend(all, lines)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, all)
+      vim.treesitter.get_parser(0, 'c'):parse()
+      _G.foldexpr_calls = 0
+      function _G.CountedFoldexpr()
+        _G.foldexpr_calls = _G.foldexpr_calls + 1
+        return vim.treesitter.foldexpr()
+      end
+      vim.wo.foldmethod = 'expr'
+      vim.wo.foldexpr = 'v:lua.CountedFoldexpr()'
+    ]], test_text)
+    local line_count = exec_lua([[return vim.api.nvim_buf_line_count(0)]])
+    eq(3, exec_lua([[return vim.fn.foldlevel(vim.api.nvim_buf_line_count(0) - 3)]]))
+
+    exec_lua([[_G.foldexpr_calls = 0]])
+    command([[$-3put ='      foo();']])
+    poke_eventloop()
+
+    eq(3, exec_lua([[return vim.fn.foldlevel(vim.api.nvim_buf_line_count(0) - 3)]]))
+    eq(2, exec_lua([[return vim.fn.foldlevel(vim.api.nvim_buf_line_count(0) - 1)]]))
+    local calls = exec_lua([[return _G.foldexpr_calls]])
+    assert(calls < line_count / 4, ('%d foldexpr calls for %d lines'):format(calls, line_count))
+  end)
+
   it("doesn't open folds in diff mode", function()
     local screen = Screen.new(60, 36)
     screen:attach()
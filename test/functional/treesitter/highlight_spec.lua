@@ -813,3 +813,41 @@ vim.cmd([[
   end)
 
 end)
+
+describe('treesitter highlighting cache', function()
+  it('does not run the query again for rows already shown', function()
+    local screen = Screen.new(40, 10)
+    screen:attach()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 500 do
+        lines[i] = ('int x%d = %d;'):format(i, i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      local parser = vim.treesitter.get_parser(0, 'c')
+      local hl = vim.treesitter.highlighter.new(parser, { queries = { c = '(identifier) @variable' } })
+      local query = hl:get_query('c'):query()
+      local iter_capture_ranges = query._iter_capture_ranges
+      _G.runs = 0
+      query._iter_capture_ranges = function(...)
+        _G.runs = _G.runs + 1
+        return iter_capture_ranges(...)
+      end
+    ]])
+    local function runs_after(keys)
+      feed(keys)
+      command('redraw')
+      return exec_lua('return _G.runs')
+    end
+
+    local runs = runs_after('G')
+    eq(runs, runs_after('gg'))
+    eq(runs, runs_after('G'))
+    -- Changing a line only drops the captures around it.
+    runs = runs_after('gg$hr2')
+    eq(runs, runs_after('G'))
+    -- Adding a line drops the ones below.
+    runs = runs_after('ggyyp')
+    eq(true, runs_after('G') > runs)
+  end)
+end)
@@ -143,4 +143,48 @@ describe('treesitter node API', function()
     eq(28, lua_eval('root:byte_length()'))
     eq(3, lua_eval('child:byte_length()'))
   end)
+
+  it('walks a tree with node handles', function()
+    insert([[
+      int main() {
+        int x = 3;
+      }]])
+    eq({ true, true, true, true }, exec_lua([[
+      local tree = vim.treesitter.get_parser(0, 'c'):parse()[1]
+      local function walk_nodes(node, res)
+        table.insert(res, { node:type(), node:named(), node:range() })
+        for child in node:iter_children() do
+          walk_nodes(child, res)
+        end
+        return res
+      end
+      local function walk_handles(h, res)
+        table.insert(res, { tree:handle_type(h), tree:handle_named(h), tree:handle_range(h) })
+        local child = tree:handle_child(h, 0)
+        while child do
+          walk_handles(child, res)
+          child = tree:handle_next_sibling(child)
+        end
+        return res
+      end
+
+      local root = tree:root_handle()
+      local decl = tree:to_handle(tree:root():child(0):child(2):named_child(0))
+      return {
+        vim.deep_equal(walk_nodes(tree:root(), {}), walk_handles(root, {})),
+        tree:handle_parent(tree:handle_child(root, 0)) == root,
+        tree:from_handle(decl):type() == 'declaration',
+        decl == tree:handle_named_child(tree:handle_child(tree:handle_child(root, 0), 2), 0),
+      }
+    ]]))
+
+    -- Editing the tree invalidates the handles.
+    eq('invalid node handle', exec_lua([[
+      local tree = vim.treesitter.get_parser(0, 'c'):parse()[1]
+      local root = tree:root_handle()
+      vim.api.nvim_buf_set_text(0, 0, 0, 0, 0, { 'static ' })
+      local ok, err = pcall(tree.handle_type, tree, root)
+      return not ok and err:match('invalid node handle')
+    ]]))
+  end)
 end)
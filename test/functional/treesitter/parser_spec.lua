@@ -17,6 +17,58 @@ describe('treesitter parser API', function()
     ]]
   end)
 
+  it('parses buffer on a background thread', function()
+    insert([[
+      int main() {
+        int x = 3;
+      }]])
+
+    eq({ true, '(translation_unit (function_definition type: (primitive_type) declarator: '
+      .. '(function_declarator declarator: (identifier) parameters: (parameter_list)) '
+      .. 'body: (compound_statement (declaration type: (primitive_type) declarator: '
+      .. '(init_declarator declarator: (identifier) value: (number_literal))))))' },
+    exec_lua([[
+      local parser = vim.treesitter.get_parser(0, "c")
+      local res
+      parser:parse_async(function(err, trees)
+        res = err or trees[1]:root():sexpr()
+      end)
+      return { vim.wait(5000, function() return res ~= nil end), res }
+    ]]))
+
+    -- Edits made during the parse are applied to the new tree.
+    eq({ true, false, true }, exec_lua([[
+      local parser = vim.treesitter.get_parser(0, "c")
+      parser:invalidate()
+      local res
+      parser:parse_async(function(err, trees)
+        res = err or trees[1]
+      end)
+      vim.api.nvim_buf_set_lines(0, 1, 2, true, { '  int y = 4;', '  int z = 5;' })
+      local ok = vim.wait(5000, function() return res ~= nil end)
+      local valid = parser:is_valid(true)
+      local fresh = vim.treesitter.get_string_parser(
+        table.concat(vim.api.nvim_buf_get_lines(0, 0, -1, true), '\n'), 'c'):parse()[1]
+      return { ok, valid, parser:parse()[1]:root():sexpr() == fresh:root():sexpr() }
+    ]]))
+
+    -- The trees of a parse overtaken by invalidate() or a reload are dropped.
+    for _, reload in ipairs({ false, true }) do
+      eq({ true, 'table', false }, exec_lua([[
+        local reload = ...
+        local parser = vim.treesitter.get_parser(0, "c")
+        parser:invalidate()
+        local res
+        parser:parse_async(function(err, trees)
+          res = err or trees
+        end)
+        parser:invalidate(reload)
+        local ok = vim.wait(5000, function() return res ~= nil end)
+        return { ok, type(res), parser:is_valid(true) }
+      ]], reload))
+    end
+  end)
+
   it('parses buffer', function()
     insert([[
       int main() {
@@ -416,6 +468,56 @@ end]]
     }, res1)
   end)
 
+  it('finds the same captures at once with predicates checked in C', function()
+    insert([[
+      int main(void) {
+        int foo = 1;
+        float bar = foo;
+        char *s = "foo";
+        return foo + bar;
+      }
+    ]])
+
+    local query_text = [[
+      ((primitive_type) @type (#any-of? @type "int" "char"))
+      ((identifier) @foo (#eq? @foo "foo"))
+      ((identifier) @notfoo (#not-eq? @notfoo "foo"))
+      ((init_declarator declarator: (_) @left value: (identifier) @right) (#eq? @left @right))
+      ((string_literal) @str (#vim-match? @str "^.fo\\+"))
+      ((identifier) @short (#lua-match? @short "^...$") (#set! "priority" 90))
+      ((number_literal) @num (#offset! @num 0 0 0 0))
+    ]]
+
+    local function captures(source)
+      return exec_lua([[
+        local query = vim.treesitter.query.parse('c', ...)
+        local source = select(2, ...)
+        local parser = type(source) == 'string' and vim.treesitter.get_string_parser(source, 'c')
+          or vim.treesitter.get_parser(source, 'c')
+        local root = parser:parse()[1]:root()
+        local old, new = {}, {}
+        for id, node in query:iter_captures(root, source, 0, 10) do
+          table.insert(old, { query.captures[id], { node:range() } })
+        end
+        for id, range, metadata in query:_iter_capture_ranges(root, source, 0, 10) do
+          table.insert(new, { query.captures[id], range, metadata.priority })
+        end
+        return { old, new }
+      ]], query_text, source)
+    end
+
+    local res = captures(0)
+    local expected = {}
+    for _, c in ipairs(res[1]) do
+      table.insert(expected, { c[1], c[2], c[1] == 'short' and '90' or nil })
+    end
+    eq(expected, res[2])
+    eq(true, #expected > 10)
+
+    res = captures(table.concat(helpers.funcs.getline(1, '$'), '\n'))
+    eq(expected, res[2])
+  end)
+
   it('allow loading query with escaped quotes and capture them with `lua-match?` and `vim-match?`', function()
     insert('char* astring = "Hello World!";')
 
@@ -662,6 +764,34 @@ int x = INT_MAX;
       end)
     end)
 
+    it("parses the regions of several parsers at once", function()
+      eq({ 6, 6 }, exec_lua([[
+        local source = table.concat(vim.api.nvim_buf_get_lines(0, 0, -1, true), '\n')
+        local root = vim.treesitter.get_string_parser(source, 'c'):parse()[1]:root()
+        local jobs, expected = {}, {}
+        for _, node in ipairs(root:named_children()) do
+          local value = node:field('value')[1]
+          if value then
+            local parser = vim._create_ts_parser('c')
+            table.insert(jobs, { parser, nil, { { value:range(true) } } })
+            parser:set_included_ranges({ { value:range(true) } })
+            table.insert(expected, parser:parse(nil, source):root():sexpr())
+          end
+        end
+        -- Two jobs of the same parser are parsed in order.
+        table.insert(jobs, { jobs[1][1], nil, {} })
+        table.insert(expected, root:sexpr())
+
+        local same = 0
+        for i, result in ipairs(vim._ts_parse_many(source, jobs)) do
+          if result[1]:root():sexpr() == expected[i] then
+            same = same + 1
+          end
+        end
+        return { same, #jobs }
+      ]]))
+    end)
+
     describe("when parsing regions combined", function()
       it("should inject a language", function()
         exec_lua([[
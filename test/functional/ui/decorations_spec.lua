@@ -165,6 +165,40 @@ describe('decorations providers', function()
     ]]}
   end)
 
+  it('can set extmarks for all lines in on_range', function()
+    insert(mulholland)
+    exec_lua [[
+      local api = vim.api
+      local hl = api.nvim_get_hl_id_by_name "ErrorMsg"
+      local test_ns = api.nvim_create_namespace "mulholland"
+      _G.ranges = {}
+      api.nvim_set_decoration_provider(api.nvim_create_namespace "ns1", {
+        on_range = function(_, win, buf, toprow, botrow)
+          table.insert(_G.ranges, { win, buf, toprow, botrow })
+          for line = toprow, botrow do
+            api.nvim_buf_set_extmark(buf, test_ns, line, line,
+                               { end_line = line, end_col = line+1,
+                                 hl_group = hl,
+                                 ephemeral = true
+                                })
+          end
+        end;
+      })
+    ]]
+
+    screen:expect{grid=[[
+      {2:/}/ just to see if there was an accident |
+      /{2:/} on Mulholland Drive                  |
+      tr{2:y}_start();                            |
+      buf{2:r}ef_T save_buf;                      |
+      swit{2:c}h_buffer(&save_buf, buf);          |
+      posp {2:=} getmark(mark, false);            |
+      restor{2:e}_buffer(&save_buf);^              |
+                                              |
+    ]]}
+    eq({ 1000, 1, 0, 6 }, exec_lua [[ return _G.ranges[#_G.ranges] ]])
+  end)
+
   it('can indicate spellchecked points', function()
     exec [[
     set spell
@@ -4787,6 +4821,31 @@ l5
                           |
     ]]}
   end)
+
+  it('has the right width after signs are placed on many lines at once', function()
+    local function textoff()
+      command('redraw')
+      return funcs.getwininfo(funcs.win_getid())[1].textoff
+    end
+    exec_lua([[
+      local ns = ...
+      local lines = {}
+      for i = 1, 500 do
+        lines[i] = 'line ' .. i
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      for i = 0, 499 do
+        vim.api.nvim_buf_set_extmark(0, ns, i, 0, { sign_text = 'a' })
+      end
+      vim.api.nvim_buf_set_extmark(0, ns, 250, 0, { id = 1000, sign_text = 'b' })
+    ]], ns)
+    eq(4, textoff())
+
+    meths.buf_del_extmark(0, ns, 1000)
+    eq(2, textoff())
+    meths.buf_clear_namespace(0, ns, 0, -1)
+    eq(0, textoff())
+  end)
 end)
 
 describe('decorations: virt_text', function()
@@ -1461,3 +1461,64 @@ it("diff mode draws 'breakindent' correctly after filler lines", function()
                                                  |
   ]])
 end)
+
+it('diff mode after edits is the same as after :diffupdate', function()
+  exec([[
+    let lines = range(1, 2000)->map('"line " .. v:val')
+    call setline(1, lines)
+    diffthis
+    vnew
+    call setline(1, lines)
+    call setline(500, 'changed')
+    call append(1000, ['added 1', 'added 2'])
+    1500,1502delete
+    diffthis
+  ]])
+  local function state()
+    return helpers.exec_lua([[
+      local res = {}
+      for _, win in ipairs(vim.api.nvim_tabpage_list_wins(0)) do
+        vim.api.nvim_win_call(win, function()
+          for l = 1, vim.fn.line('$') + 1 do
+            res[#res + 1] = { vim.fn.diff_hlID(l, 1), vim.fn.diff_filler(l) }
+          end
+        end)
+      end
+      return res
+    ]])
+  end
+  -- edits near a diff block, far from one, adding and deleting lines
+  for _, keys in ipairs({ '499Gccfoo<Esc>', '300Gdd', '1001Goinserted<Esc>', 'Gonew<Esc>',
+                          '1499GJ', 'ggOtop<Esc>', 'u', '2Gd3j', '<C-R>' }) do
+    feed(keys)
+    local after_edit = state()
+    command('diffupdate')
+    eq(state(), after_edit)
+  end
+end)
+
+it('diffopt linematch aligns a hunk larger than its limit', function()
+  local left, right = {}, {}
+  for i = 1, 30 do
+    left[#left + 1] = ('line %02d of the text, version a'):format(i)
+    right[#right + 1] = ('line %02d of the text, version b'):format(i)
+    if i == 10 then
+      for j = 1, 5 do
+        right[#right + 1] = ('extra line %d inserted here'):format(j)
+      end
+    end
+  end
+  meths.buf_set_lines(0, 0, -1, false, left)
+  command('diffthis')
+  command('rightbelow vnew')
+  meths.buf_set_lines(0, 0, -1, false, right)
+  command('diffthis')
+  command('wincmd h')
+
+  -- the hunk of 65 lines is too big for linematch:20 itself
+  command('set diffopt=internal,filler')
+  eq(5, helpers.funcs.diff_filler(31))
+  command('set diffopt=internal,filler,linematch:20')
+  eq(5, helpers.funcs.diff_filler(11))
+  eq(0, helpers.funcs.diff_filler(31))
+end)
@@ -543,6 +543,39 @@ describe('float window', function()
     eq({ w0 }, meths.list_wins())
   end)
 
+  it('redraws the area a float leaves below another float', function()
+    local screen = Screen.new(20, 6)
+    screen:attach()
+    meths.buf_set_lines(0, 0, -1, true, { ('a'):rep(20), ('a'):rep(20), ('a'):rep(20),
+                                          ('a'):rep(20), ('a'):rep(20) })
+    local buf_b = meths.create_buf(false, true)
+    meths.buf_set_lines(buf_b, 0, -1, true, { 'bbbbbb', 'bbbbbb' })
+    local buf_c = meths.create_buf(false, true)
+    meths.buf_set_lines(buf_c, 0, -1, true, { 'cccccc', 'cccccc', 'cccccc' })
+    local win_b = meths.open_win(buf_b, false, {relative='editor', row=1, col=2, width=6,
+                                                height=2, zindex=50})
+    meths.open_win(buf_c, false, {relative='editor', row=1, col=4, width=6, height=3,
+                                  zindex=60})
+    screen:expect([[
+      ^aaaaaaaaaaaaaaaaaaaa|
+      aabbccccccaaaaaaaaaa|*2
+      aaaaccccccaaaaaaaaaa|
+      aaaaaaaaaaaaaaaaaaaa|
+                          |
+    ]])
+
+    -- The part of the old position covered by the upper float is not drawn
+    -- again, the rest is.
+    meths.win_set_config(win_b, {relative='editor', row=3, col=10})
+    screen:expect([[
+      ^aaaaaaaaaaaaaaaaaaaa|
+      aaaaccccccaaaaaaaaaa|*2
+      aaaaccccccbbbbbbaaaa|
+      aaaaaaaaaabbbbbbaaaa|
+                          |
+    ]])
+  end)
+
   describe('with only one tabpage,', function()
     local float_opts = {relative = 'editor', row = 1, col = 1, width = 1, height = 1}
     local old_buf, old_win
@@ -1365,6 +1365,30 @@ describe('ColorColumn highlight', function()
     ]])
   end)
 
+  it("with 'cursorlineopt' number when the cursor moves", function()
+    exec([[
+      call setline(1, ["1111111111","22222222222","3333333333"])
+      set colorcolumn=3,9
+      set number cursorline cursorlineopt=number
+    ]])
+    feed('j')
+    screen:expect([[
+      {3:  1 }11{1:1}11111{1:1}1                          |
+      {4:  2 }^22{1:2}22222{1:2}22                         |
+      {3:  3 }33{1:3}33333{1:3}3                          |
+      {5:~                                       }|*11
+                                              |
+    ]])
+    feed('j')
+    screen:expect([[
+      {3:  1 }11{1:1}11111{1:1}1                          |
+      {3:  2 }22{1:2}22222{1:2}22                         |
+      {4:  3 }^33{1:3}33333{1:3}3                          |
+      {5:~                                       }|*11
+                                              |
+    ]])
+  end)
+
   -- oldtest: Test_colorcolumn_bri()
   it("in 'breakindent' vim-patch:8.2.1689", function()
     exec([[
@@ -2289,6 +2313,7 @@ describe('highlight namespaces', function()
       [8] = {foreground = Screen.colors.Gray20};
       [9] = {foreground = Screen.colors.Blue};
       [10] = {bold = true, foreground = Screen.colors.SeaGreen};
+      [11] = {background = Screen.colors.DarkOrange4};
     }
 
     ns1 = meths.create_namespace 'grungy'
@@ -2352,6 +2377,34 @@ describe('highlight namespaces', function()
     ]]}
   end)
 
+  it('updates extmark highlights when the window namespace changes', function()
+    meths.buf_set_lines(0, 0, -1, true, {'text'})
+    meths.set_hl(ns1, 'Search', {bg='DarkMagenta'})
+    meths.buf_set_extmark(0, ns1, 0, 0, {end_col=4, hl_group='Search'})
+    meths.win_set_hl_ns(0, ns1)
+    screen:expect{grid=[[
+      {4:^text}{2:                     }|
+      {3:~                        }|*8
+                               |
+    ]]}
+
+    meths.set_hl(ns1, 'Search', {bg='DarkOrange4'})
+    command('redraw!')
+    screen:expect{grid=[[
+      {11:^text}{2:                     }|
+      {3:~                        }|*8
+                               |
+    ]]}
+
+    meths.set_hl(ns1, 'Search', {link='NonText'})
+    command('redraw!')
+    screen:expect{grid=[[
+      {3:^text}{2:                     }|
+      {3:~                        }|*8
+                               |
+    ]]}
+  end)
+
   it('redraws correctly when ns=0', function()
     screen:expect{grid=[[
       ^                         |
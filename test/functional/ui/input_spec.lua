@@ -446,3 +446,21 @@ describe('display is updated', function()
     ]])
   end)
 end)
+
+describe('input latency', function()
+  it('is recorded by mode when the screen is flushed', function()
+    local screen = Screen.new(40, 4)
+    screen:attach()
+    meths._input_latency(true)
+    feed('ix')
+    screen:expect([[
+      x^                                       |
+      {1:~                                       }|*2
+      {2:-- INSERT --}                            |
+    ]], {[1] = {bold = true, foreground = Screen.colors.Blue}, [2] = {bold = true}})
+    local stats = meths._input_latency(true)
+    helpers.ok(stats.insert.count >= 1)
+    helpers.ok(stats.insert.p50 <= stats.insert.max + 1)
+    eq({}, meths._input_latency(false))
+  end)
+end)
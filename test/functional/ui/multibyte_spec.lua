@@ -9,6 +9,8 @@ local funcs = helpers.funcs
 local meths = helpers.meths
 local split = helpers.split
 local dedent = helpers.dedent
+local eq = helpers.eq
+local ok = helpers.ok
 
 describe("multibyte rendering", function()
   local screen
@@ -104,6 +106,28 @@ describe("multibyte rendering", function()
     ]])
   end)
 
+  it('redraws a double-width char changed in the middle of a line', function()
+    local line = ('x'):rep(15) .. '馬' .. ('y'):rep(20)
+    meths.buf_set_lines(0, 0, -1, true, { line, line })
+    screen:expect([[
+      ^xxxxxxxxxxxxxxx馬yyyyyyyyyyyyyyyyyyyy                       |
+      xxxxxxxxxxxxxxx馬yyyyyyyyyyyyyyyyyyyy                       |
+      {1:~                                                           }|*3
+                                                                  |
+    ]])
+
+    -- Only the cells between the unchanged start and end are compared one by
+    -- one, the double-width char is at a boundary of their blocks.
+    meths.buf_set_text(0, 0, 15, 0, 18, { 'ab' })
+    meths.buf_set_text(0, 1, 15, 1, 18, { '馬馬' })
+    screen:expect([[
+      ^xxxxxxxxxxxxxxxabyyyyyyyyyyyyyyyyyyyy                       |
+      xxxxxxxxxxxxxxx馬馬yyyyyyyyyyyyyyyyyyyy                     |
+      {1:~                                                           }|*3
+                                                                  |
+    ]])
+  end)
+
   it('0xffff is shown as 4 hex digits', function()
     command([[call setline(1, "\uFFFF!!!")]])
     feed('$')
@@ -159,6 +183,23 @@ describe("multibyte rendering", function()
     ]], reset=true}
   end)
 
+  it('counts glyph cache lookups in nvim__stats()', function()
+    local before = meths._stats()
+    meths.buf_set_lines(0, 0, -1, true, { 'x̲̅̊ x̲̅̊' })
+    screen:expect([[
+      ^x̲̅̊ x̲̅̊                                                         |
+      {1:~                                                           }|*4
+                                                                  |
+    ]])
+    local stats = meths._stats()
+    ok(stats.glyph_cache_miss > before.glyph_cache_miss)
+    ok(stats.glyph_cache_hit > before.glyph_cache_hit)
+    ok(stats.glyph_cache_bytes > 0)
+
+    meths._invalidate_glyph_cache()
+    eq(before.glyph_cache_clear + 1, meths._stats().glyph_cache_clear)
+  end)
+
   it('works with arabic input and arabicshape', function()
     command('set arabic')
 
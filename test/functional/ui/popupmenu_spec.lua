@@ -9,6 +9,8 @@ local async_meths = helpers.async_meths
 local command = helpers.command
 local funcs = helpers.funcs
 local eq = helpers.eq
+local ok = helpers.ok
+local request = helpers.request
 local pcall_err = helpers.pcall_err
 local exec_lua = helpers.exec_lua
 local exec = helpers.exec
@@ -1045,6 +1047,25 @@ describe("builtin popupmenu 'pumblend'", function()
       {9:-- Keyword Local completion (^N^P) }{10:match 1 of 3}             |
     ]])
   end)
+
+  it('recomputes blends with the Normal colors only when these change', function()
+    local screen = Screen.new(60, 8)
+    screen:attach()
+    command('set pumblend=10')
+    insert([[
+      Lorem ipsum dolor sit amet, consectetur
+      adipisicing elit, sed do eiusmod tempor
+      laborum.]])
+    feed('ggOdo<c-x><c-n>')
+    screen:expect({ any = 'Keyword Local completion' })
+    local stats = request('nvim__stats')
+    ok(stats.hl_blend_entries > 0)
+    command('redraw!')
+    eq(stats.hl_blend_clear, request('nvim__stats').hl_blend_clear)
+    command('highlight Normal guibg=DarkBlue | redraw!')
+    ok(request('nvim__stats').hl_blend_clear > stats.hl_blend_clear)
+    ok(request('nvim__stats').hl_blend_entries > 0)
+  end)
 end)
 
 describe('builtin popupmenu', function()
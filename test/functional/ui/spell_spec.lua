@@ -9,6 +9,9 @@ local insert = helpers.insert
 local meths = helpers.meths
 local curbufmeths = helpers.curbufmeths
 local is_os = helpers.is_os
+local eq = helpers.eq
+local ok = helpers.ok
+local request = helpers.request
 
 describe("'spell'", function()
   local screen
@@ -374,4 +377,70 @@ describe("'spell'", function()
                                                  |
     ]])
   end)
+
+  it('reuses results for lines that did not change', function()
+    screen:try_resize(43, 4)
+    exec([[
+      set spell
+      call setline(1, ['This is a mistakke.', 'Another line.'])
+    ]])
+    screen:expect([[
+      ^This is a {1:mistakke}.                        |
+      Another line.                              |
+      {0:~                                          }|
+                                                 |
+    ]])
+    local hits = request('nvim__stats').spell_cache_hit
+    exec('redraw!')
+    ok(request('nvim__stats').spell_cache_hit > hits)
+    -- Lines moved down keep their results, a changed line is checked again.
+    feed('Onew wurd<Esc>')
+    screen:expect([[
+      new {1:wur^d}                                   |
+      This is a {1:mistakke}.                        |
+      Another line.                              |
+                                                 |
+    ]])
+    -- Adding a good word drops all results.
+    feed('j0fmzG')
+    screen:expect([[
+      new {1:wurd}                                   |
+      This is a ^mistakke.                        |
+      Another line.                              |
+                                                 |
+    ]])
+  end)
+
+  it('uses a spell file written by :mkspell, also after it was written again', function()
+    screen:try_resize(43, 4)
+    helpers.write_file('Xmapwords', 'apple\nbanana\ncherry\n')
+    finally(function()
+      os.remove('Xmapwords')
+      os.remove('Xmapwords.spl')
+    end)
+    exec([[
+      mkspell! Xmapwords.spl Xmapwords
+      set spell spelllang=Xmapwords.spl
+      call setline(1, 'apple banana grape')
+    ]])
+    -- The trees are stored as arrays at the end of the file.
+    eq('VIMspmap', helpers.read_file('Xmapwords.spl'):sub(-8))
+    screen:expect([[
+      ^apple banana {1:grape}                         |
+      {0:~                                          }|*2
+                                                 |
+    ]])
+    helpers.write_file('Xmapwords', 'apple\nbanana\ngrape\n')
+    exec([[
+      mkspell! Xmapwords.spl Xmapwords
+      set spelllang=Xmapwords.spl
+      call setline(2, 'cherry')
+    ]])
+    screen:expect([[
+      ^apple banana grape                         |
+      {1:cherry}                                     |
+      {0:~                                          }|
+                                                 |
+    ]])
+  end)
 end)
@@ -613,6 +613,50 @@ it('statusline is redrawn on various state changes', function()
   ]])
 end)
 
+it('statusline is redrawn on cursor moves only when it shows the cursor', function()
+  clear()
+  local screen = Screen.new(40, 4)
+  screen:attach()
+  funcs.setline(1, { 'abc', 'def' })
+  command('set ls=2 stl=%f%m\\ %l,%c')
+  screen:expect([[
+    ^abc                                     |
+    def                                     |
+    [No Name][+] 1,1                        |
+                                            |
+  ]])
+  feed('jl')
+  screen:expect([[
+    abc                                     |
+    d^ef                                     |
+    [No Name][+] 2,2                        |
+                                            |
+  ]])
+
+  -- without a cursor item the statusline still shows other changes
+  command('set nomodified stl=%f%m')
+  screen:expect([[
+    abc                                     |
+    d^ef                                     |
+    [No Name]                               |
+                                            |
+  ]])
+  feed('k')
+  screen:expect([[
+    a^bc                                     |
+    def                                     |
+    [No Name]                               |
+                                            |
+  ]])
+  feed('x')
+  screen:expect([[
+    a^c                                      |
+    def                                     |
+    [No Name][+]                            |
+                                            |
+  ]])
+end)
+
 it('ruler is redrawn in cmdline with redrawstatus #22804', function()
   clear()
   local screen = Screen.new(40, 2)
@@ -0,0 +1,74 @@
+local helpers = require('test.functional.helpers')(after_each)
+local Screen = require('test.functional.ui.screen')
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+local feed = helpers.feed
+local ok = helpers.ok
+local request = helpers.request
+local retry = helpers.retry
+
+describe('syntax parsed ahead of the display', function()
+  before_each(function()
+    clear()
+    Screen.new(40, 8):attach()
+    -- A region of 50 lines every 100 lines.
+    exec_lua([[
+      local lines = {}
+      for i = 1, 20000 do
+        local n = (i - 1) % 100
+        lines[i] = n == 0 and 'begin' or n == 49 and 'end' or ('text %d'):format(i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+  end)
+
+  local function prefilled()
+    return request('nvim__stats').syntax_prefill
+  end
+
+  local function syn_name(lnum)
+    return exec_lua([[return vim.fn.synIDattr(vim.fn.synID(..., 1, 0), 'name')]], lnum)
+  end
+
+  it('parses the whole buffer after a redraw', function()
+    local before = prefilled()
+    command('syntax on')
+    command('syntax region Block start=/^begin/ end=/^end/')
+    command('syntax sync fromstart')
+    retry(nil, 10000, function()
+      ok(prefilled() - before >= 20000 - 1)
+    end)
+    feed('G')
+    eq('', syn_name(20000))
+    eq('Block', syn_name(19950))
+
+    -- A change makes the lines below it parsed again.
+    before = prefilled()
+    feed('ggoend<Esc>')
+    retry(nil, 10000, function()
+      ok(prefilled() - before >= 20000 - 2)
+    end)
+    eq('', syn_name(10))
+  end)
+
+  it('parses windows in other tab pages', function()
+    local before = prefilled()
+    command('syntax on')
+    command('syntax region Block start=/^begin/ end=/^end/')
+    command('syntax sync fromstart')
+    command('tabnew')
+    retry(nil, 10000, function()
+      ok(prefilled() - before >= 20000 - 1)
+    end)
+  end)
+
+  it('does nothing without syntax items', function()
+    local before = prefilled()
+    command('redraw!')
+    helpers.sleep(300)
+    eq(before, prefilled())
+  end)
+end)
@@ -153,6 +153,52 @@ describe('List support code', function()
   end)
 end)
 
+describe('List indexing', function()
+  before_each(clear)
+
+  it('finds the item at each index after changes to a long list', function()
+    exec([[
+      func Check(l)
+        let bad = []
+        let i = 0
+        for item in a:l
+          " walk backwards to index far away from the cached item
+          if a:l[i] isnot item || a:l[-len(a:l) + i] isnot item
+            call add(bad, i)
+          endif
+          let i += 1
+        endfor
+        let k = len(a:l) - 1
+        while k >= 0
+          if get(a:l, k) isnot a:l[k]
+            call add(bad, k)
+          endif
+          let k -= 7
+        endwhile
+        return bad
+      endfunc
+      let g:l = range(1000)
+    ]])
+    eq({}, eval('Check(g:l)'))
+    eq(999, eval('g:l[999]'))
+    command('call insert(g:l, -1, 500) | call remove(g:l, 10, 20)')
+    eq({}, eval('Check(g:l)'))
+    eq({ 498, 499, -1, 500 }, eval('g:l[487 : 490]'))
+    command('call add(g:l, 1000) | call extend(g:l, range(1001, 1100))')
+    eq({ 1000, 1100 }, eval('[g:l[-101], g:l[-1]]'))
+    eq({}, eval('Check(g:l)'))
+    command('call reverse(g:l)')
+    eq({ 1100, 0 }, eval('[g:l[0], g:l[-1]]'))
+    eq({}, eval('Check(g:l)'))
+    command('call sort(g:l, "n")')
+    eq({ -1, 1100, 500 }, eval('[g:l[0], g:l[-1], g:l[490]]'))
+    eq({}, eval('Check(g:l)'))
+    command('call filter(g:l, "v:val % 2")')
+    eq({ -1, 1, 1099 }, eval('[g:l[0], g:l[1], g:l[-1]]'))
+    eq({}, eval('Check(g:l)'))
+  end)
+end)
+
 describe("uncaught exception", function()
   before_each(clear)
 
@@ -280,6 +326,106 @@ describe('listing functions using :function', function()
   end)
 end)
 
+describe('Dictionary key lookup', function()
+  before_each(clear)
+
+  it('finds the current item after the dictionary changes', function()
+    exec([[
+      func Get(d)
+        return [a:d.foo, g:lookup_var]
+      endfunc
+      let g:lookup_var = 1
+    ]])
+    eq({ 1, 1 }, eval('Get({"foo": 1})'))
+    -- Another dictionary, possibly at the same address.
+    eq({ 2, 1 }, eval('Get({"bar": 0, "foo": 2})'))
+    command('let d = {"foo": 3}')
+    eq({ 3, 1 }, eval('Get(d)'))
+    -- Adding enough items moves the existing ones to a new array.
+    command('for i in range(100) | let d["k" .. i] = i | endfor')
+    command('let d.foo = 4 | unlet g:lookup_var | let g:lookup_var = 5')
+    eq({ 4, 5 }, eval('Get(d)'))
+    command('unlet d.foo')
+    eq('Vim(return):E716: Key not present in Dictionary: "foo"', exc_exec('call Get(d)'))
+  end)
+end)
+
+describe('comment lines in functions', function()
+  before_each(clear)
+
+  it('are skipped without changing line numbers or heredocs', function()
+    exec([[
+      func Test()
+        " comment
+        let result = []
+        for i in range(3)
+          " comment in a loop
+          call add(result, i)
+        endfor
+        let text =<< trim END
+          " not a comment
+        END
+        call add(result, text[0])
+        " comment before an error
+        try
+          throw 'oops'
+        catch
+          call add(result, v:throwpoint)
+        endtry
+        return result
+      endfunc
+    ]])
+    eq({ 0, 1, 2, '" not a comment', 'function Test, line 13' }, eval('Test()'))
+    matches('\n4%s+" comment in a loop\n', exec_capture('function Test'))
+  end)
+
+  it('are kept in a nested function', function()
+    exec([[
+      func Outer()
+        " comment
+        func! Inner()
+          " comment in a nested function
+          try
+            throw 'oops'
+          catch
+            return v:throwpoint
+          endtry
+        endfunc
+      endfunc
+      call Outer()
+    ]])
+    eq('function Inner, line 3', eval('Inner()'))
+    matches('\n1%s+" comment in a nested function\n', exec_capture('function Inner'))
+  end)
+end)
+
+describe('expression options', function()
+  before_each(clear)
+
+  it('call a function without arguments like any other expression', function()
+    exec([[
+      func s:Fold()
+        return v:lnum % 2 ? '>1' : 1
+      endfunc
+      func Indent()
+        return v:lnum * 2
+      endfunc
+      let g:Fn = function('Indent')
+      call setline(1, ['a', 'b', 'c', 'd'])
+      setlocal foldmethod=expr foldexpr=<SID>Fold()
+    ]])
+    eq({ 1, 1, 3, 3 }, eval('map(range(1, 4), "foldclosed(v:val)")'))
+
+    command('setlocal foldmethod=manual indentkeys= indentexpr=Indent()')
+    command('normal! gg=G')
+    eq({ '  a', '    b', '      c', '        d' }, meths.buf_get_lines(0, 0, -1, true))
+    -- A Funcref variable is not a user function, it is evaluated as usual.
+    command('setlocal indentexpr=Fn()')
+    command('%left | normal! gg=G')
+    eq({ '  a', '    b', '      c', '        d' }, meths.buf_get_lines(0, 0, -1, true))
+  end)
+end)
+
 it('no double-free in garbage collection #16287', function()
   clear()
   -- Don't use exec() here as using a named script reproduces the issue better.
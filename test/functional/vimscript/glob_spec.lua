@@ -18,12 +18,34 @@ end)
 describe('glob()', function()
   it("glob('.*') returns . and .. ", function()
     eq({'.', '..'}, eval("glob('.*', 0, 1)"))
-    -- Do it again to verify scandir_next_with_dots() internal state.
+    -- Do it again to verify path_dir_next() internal state.
     eq({'.', '..'}, eval("glob('.*', 0, 1)"))
   end)
   it("glob('*') returns an empty list ", function()
     eq({}, eval("glob('*', 0, 1)"))
-    -- Do it again to verify scandir_next_with_dots() internal state.
+    -- Do it again to verify path_dir_next() internal state.
     eq({}, eval("glob('*', 0, 1)"))
   end)
+  it("glob('**') finds files in a tree read ahead", function()
+    mkdir('a')
+    mkdir('a/b')
+    mkdir('a/b/c')
+    mkdir('a/.hid')
+    mkdir('d')
+    for _, f in ipairs({ 'x.lua', 'a/y.lua', 'a/b/c/z.lua', 'a/.hid/h.lua', 'a/b/c/n.txt', 'd.lua' }) do
+      helpers.write_file(f, '')
+    end
+    finally(function()
+      helpers.rmdir('a')
+      helpers.rmdir('d')
+      os.remove('x.lua')
+      os.remove('d.lua')
+    end)
+    eq({ 'a/b/c/z.lua', 'a/y.lua', 'd.lua', 'x.lua' }, eval("glob('**/*.lua', 0, 1)"))
+    eq({ 'a/b/c/z.lua' }, eval("glob('**/c/*.lua', 0, 1)"))
+    eq({ 'a/.hid/h.lua' }, eval("glob('a/.hid/**/*.lua', 0, 1)"))
+    eq({ 'a/b/c/n.txt' }, eval("glob('**/n.txt', 0, 1)"))
+    -- A file named like a directory component doesn't match.
+    eq({}, eval("glob('**/d.lua/*', 0, 1)"))
+  end)
 end)
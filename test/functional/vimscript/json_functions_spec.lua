@@ -367,6 +367,20 @@ describe('json_decode() function', function()
     }))
   end)
 
+  it('parses long strings with escapes and non-ASCII characters anywhere', function()
+    local plain = 'Lorem ipsum dolor sit amet, consectetur'
+    eq(plain, funcs.json_decode('"' .. plain .. '"'))
+    for i = 0, 17 do
+      local prefix = plain:sub(1, i)
+      eq(prefix .. '"\n«' .. plain, funcs.json_decode('"' .. prefix .. '\\"\\n«' .. plain .. '"'))
+      eq(prefix .. 'ફ' .. plain .. '\t', funcs.json_decode('"' .. prefix .. 'ફ' .. plain .. '\\t"'))
+    end
+    eq('Vim(call):E474: ASCII control characters cannot be present inside string: \1"',
+       exc_exec('call json_decode("\\"' .. plain .. '\x01\\"")'))
+    eq('Vim(call):E474: Expected string end: "' .. plain,
+       exc_exec('call json_decode("\\"' .. plain .. '")'))
+  end)
+
   it('fails on strings with invalid bytes', function()
     eq('Vim(call):E474: Only UTF-8 strings allowed: \255"',
        exc_exec('call json_decode("\\t\\"\\xFF\\"")'))
@@ -0,0 +1,53 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+local funcs = helpers.funcs
+
+describe('line2byte() and byte2line()', function()
+  before_each(clear)
+
+  -- Enough lines to have many chunks, with edits that split and merge them.
+  it('match the buffer text after many edits', function()
+    local mismatches = exec_lua([[
+      local lines = {}
+      for i = 1, 5000 do
+        lines[i] = string.rep('x', i % 37)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      vim.api.nvim_buf_set_lines(0, 100, 1600, true, {})
+      vim.api.nvim_buf_set_lines(0, 2000, 2000, true, lines)
+      vim.api.nvim_buf_set_lines(0, 10, 11, true, { string.rep('y', 300) })
+
+      local bad = {}
+      local offset = 1
+      local text = vim.api.nvim_buf_get_lines(0, 0, -1, true)
+      for lnum, line in ipairs(text) do
+        if vim.fn.line2byte(lnum) ~= offset then
+          table.insert(bad, { 'line2byte', lnum })
+        end
+        if vim.fn.byte2line(offset) ~= lnum then
+          table.insert(bad, { 'byte2line', offset })
+        end
+        offset = offset + #line + 1
+      end
+      return bad
+    ]])
+    eq({}, mismatches)
+  end)
+
+  it('count the CR with fileformat=dos', function()
+    exec_lua([[
+      local lines = {}
+      for i = 1, 3000 do
+        lines[i] = tostring(i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    ]])
+    command('set fileformat=dos')
+    eq(1 + 9 * 3 + 90 * 4 + 900 * 5 + 1000 * 6, funcs.line2byte(2000))
+    eq(2000, funcs.byte2line(1 + 9 * 3 + 90 * 4 + 900 * 5 + 1000 * 6))
+  end)
+end)
@@ -0,0 +1,30 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+local funcs = helpers.funcs
+
+describe('matchfuzzy()', function()
+  before_each(clear)
+
+  it('finds the same matches when candidates are filtered out early', function()
+    eq({ 'FooBar', 'xfxoxo' }, funcs.matchfuzzy({ 'bar', 'FooBar', 'xfxoxo', 'of' }, 'foo'))
+    eq({ 'one two', 'two one' }, funcs.matchfuzzy({ 'one two', 'onetw', 'two one' }, 'two one'))
+    eq({ 'one two' }, funcs.matchfuzzy({ 'one two', 'two one' }, 'one two', { matchseq = 1 }))
+    -- A non-ASCII character may fold to an ASCII one (KELVIN SIGN).
+    eq({ 'a\226\132\170' }, funcs.matchfuzzy({ 'a\226\132\170', 'ab' }, 'ak'))
+    eq({ 'x\195\164y' }, funcs.matchfuzzy({ 'x\195\164y', 'xay' }, '\195\132'))
+  end)
+
+  it('matches many candidates', function()
+    local res = exec_lua([[
+      local l = {}
+      for i = 1, 10000 do
+        l[i] = ('item_%05d'):format(i)
+      end
+      return vim.fn.matchfuzzy(l, '9999')
+    ]])
+    eq({ 'item_09999' }, res)
+  end)
+end)
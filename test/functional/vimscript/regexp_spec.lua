@@ -0,0 +1,95 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local funcs = helpers.funcs
+local ok = helpers.ok
+local request = helpers.request
+
+describe('regexp text that a match must contain', function()
+  before_each(clear)
+
+  local function check(pat, str, expected)
+    for _, engine in ipairs({ 1, 2 }) do
+      eq(expected, funcs.match(str, '\\%#=' .. engine .. pat), engine .. ': ' .. pat)
+    end
+  end
+
+  it('skips strings without it', function()
+    check('\\w\\+foobar\\d', 'xxfoobaz1', -1)
+    check('\\w\\+foobar\\d', 'xxfoobar1', 0)
+    check('a*bcd', 'xbcd', 1)
+    check('[abc]\\+xyz', 'cxy', -1)
+  end)
+
+  it('ignores optional text and alternatives', function()
+    check('x\\(abc\\)\\=y', 'xy', 0)
+    check('\\w\\(abc\\|def\\)g', 'zdefg', 0)
+    check('\\w\\%[abc]z', 'qaz', 0)
+    check('\\w[xyz]zzq', 'azzq', -1)
+    check('\\w[xyz]zzq', 'azzzq', 0)
+  end)
+
+  it('ignores text in look-behind and look-ahead', function()
+    check('\\(foo\\)\\@<!bar\\d', 'bar1', 0)
+    check('\\(foo\\)\\@<=bar\\d', 'foobar1', 3)
+    check('\\dbar\\(baz\\)\\@!', '1barqux', 0)
+  end)
+
+  it('respects ignorecase', function()
+    check('\\c\\w\\+FOO\\d', 'xfoo1', 0)
+    check('\\C\\w\\+FOO\\d', 'xfoo1', -1)
+  end)
+end)
+
+describe('regexp match check with a DFA', function()
+  before_each(clear)
+
+  local function check(pat, str, expected)
+    for _, engine in ipairs({ 1, 2 }) do
+      eq(expected, funcs.match(str, '\\%#=' .. engine .. pat), engine .. ': ' .. pat)
+    end
+  end
+
+  it('finds the same matches as the NFA', function()
+    check('\\(a\\|b\\)\\{3}c', 'ababxabc', -1)
+    check('\\(a\\|b\\)\\{3}c', 'ababxabbc', 5)
+    check('^\\d\\+$', '123', 0)
+    check('^\\d\\+$', '123a', -1)
+    check('x[^a-c]\\+y', 'xaby xddy', 5)
+    check('[[:upper:]]\\l\\+', 'abc Def', 4)
+    check('\\<foo', 'afoo', -1)
+  end)
+
+  it('respects ignorecase and multibyte text', function()
+    check('\\c[äa]b\\+$', 'xÄBB', 1)
+    check('\\Cäb', 'xÄb', -1)
+    check('é\\+x', 'aééx', 1)
+  end)
+end)
+
+describe('compiled regexp cache', function()
+  before_each(clear)
+
+  it('reuses programs for the same pattern and flags', function()
+    local before = request('nvim__stats')
+    command([[for i in range(10) | call match('abbc', 'b\+c') | endfor]])
+    local after = request('nvim__stats')
+    ok(after.regexp_cache_hit - before.regexp_cache_hit >= 9)
+
+    eq(1, funcs.match('abbc', 'b\\+c'))
+    command('set regexpengine=1')
+    before = request('nvim__stats')
+    eq(1, funcs.match('abbc', 'b\\+c'))
+    ok(request('nvim__stats').regexp_cache_miss > before.regexp_cache_miss)
+  end)
+
+  it('does not cache patterns with ~', function()
+    funcs.setline(1, 'foo bar')
+    command('s/foo/baz/')
+    eq(4, funcs.match('xyz baz', '~'))
+    command('s/bar/qux/')
+    eq(4, funcs.match('xyz qux', '~'))
+  end)
+end)
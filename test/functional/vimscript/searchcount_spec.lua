@@ -0,0 +1,83 @@
+local helpers = require('test.functional.helpers')(after_each)
+
+local clear = helpers.clear
+local command = helpers.command
+local eq = helpers.eq
+local exec_lua = helpers.exec_lua
+local funcs = helpers.funcs
+local write_file = helpers.write_file
+
+describe('searchcount()', function()
+  before_each(clear)
+
+  -- The matches are kept per buffer and updated for changed lines.
+  it('counts the matches after many edits', function()
+    local mismatches = exec_lua([[
+      local lines = {}
+      for i = 1, 2000 do
+        lines[i] = string.rep(i % 3 == 0 and 'foo ' or 'bar ', i % 4)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+
+      local function count(last)
+        local n = 0
+        for _, line in ipairs(vim.api.nvim_buf_get_lines(0, 0, last or -1, true)) do
+          for _ in line:gmatch('foo') do
+            n = n + 1
+          end
+        end
+        return n
+      end
+
+      local bad = {}
+      local function check(what)
+        local lnum = math.floor(vim.api.nvim_buf_line_count(0) / 2)
+        local res = vim.fn.searchcount({ pattern = 'foo', maxcount = 0, pos = { lnum, 1000, 0 } })
+        if res.total ~= count() or res.current ~= count(lnum) then
+          table.insert(bad, { what, res.total, count(), res.current, count(lnum) })
+        end
+      end
+
+      check('initial')
+      vim.api.nvim_buf_set_lines(0, 10, 20, true, { 'foo foo foo' })
+      check('replace')
+      vim.api.nvim_buf_set_lines(0, 1500, 1600, true, {})
+      check('delete')
+      vim.api.nvim_buf_set_lines(0, 5, 5, true, { 'foo', 'xfoo', 'bar' })
+      check('insert')
+      vim.cmd('1000,1200s/bar/foo/g')
+      check('substitute')
+      vim.cmd('undo')
+      check('undo')
+      return bad
+    ]])
+    eq({}, mismatches)
+  end)
+
+  it('counts matches of a pattern with a line number', function()
+    funcs.setline(1, { 'foo', 'bar', 'foo' })
+    eq(0, funcs.searchcount({ pattern = [[\%2lfoo]], maxcount = 0 }).total)
+    command('2delete')
+    eq(1, funcs.searchcount({ pattern = [[\%2lfoo]], maxcount = 0 }).total)
+  end)
+
+  it('counts matches of a pattern with the end of the file', function()
+    funcs.setline(1, { 'foo', 'foo', 'bar' })
+    eq(0, funcs.searchcount({ pattern = [[foo\%$]], maxcount = 0 }).total)
+    command('3delete')
+    eq(1, funcs.searchcount({ pattern = [[foo\%$]], maxcount = 0 }).total)
+  end)
+
+  it('counts the matches after reloading the file', function()
+    local fname = 'Xsearchcount_reload'
+    write_file(fname, 'foo\nbar\n')
+    finally(function()
+      os.remove(fname)
+    end)
+    command('edit ' .. fname)
+    eq(1, funcs.searchcount({ pattern = 'foo', maxcount = 0 }).total)
+    write_file(fname, 'foo\nfoo\n')
+    command('edit!')
+    eq(2, funcs.searchcount({ pattern = 'foo', maxcount = 0 }).total)
+  end)
+end)
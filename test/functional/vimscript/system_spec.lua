@@ -517,6 +517,11 @@ describe('systemlist()', function()
       eq({'aa','bb'}, eval("systemlist('cat',['aa','bb'],1)"))
       eq({'aa','bb',''}, eval("systemlist('cat',['aa','bb',''],2)"))
     end)
+
+    it('applied to output that is only a newline', function()
+      eq({}, eval([[systemlist('cat', "\n")]]))
+      eq({'', ''}, eval([[systemlist('cat', "\n", 1)]]))
+    end)
   end)
 
   it("with a program that doesn't close stdout will exit properly after passing input", function()
@@ -575,6 +580,22 @@ describe('shell :!', function()
     end
   end)
 
+  it(':read !cmd reads a lot of output through a pipe', function()
+    helpers.skip(is_os('win'))
+    command('set noshelltemp')
+    local input = {}
+    for i = 1, 0xffff do
+      input[#input + 1] = ('%05d 01234567890ABCDEFabcdef'):format(i)
+    end
+    -- The last line has no newline and a NUL.
+    input[#input + 1] = 'last\nline'
+    call('writefile', input, 'Xsystem_read_pipe', 'b')
+    finally(function() os.remove('Xsystem_read_pipe') end)
+    command('read !cat Xsystem_read_pipe')
+    command('1delete')
+    eq(input, call('getline', 1, '$'))
+  end)
+
   it(':{range}! without redirecting to buffer', function()
     local screen = Screen.new(500, 10)
     screen:attach()
@@ -0,0 +1,29 @@
+local helpers = require('test.functional.helpers')(after_each)
+local clear, eq = helpers.clear, helpers.eq
+local command, funcs = helpers.command, helpers.funcs
+
+before_each(clear)
+
+describe('virtcol() function', function()
+  it('works on a long line before and after it changes', function()
+    -- each part is 7 bytes and 8 cells: 'a', 'é', a double-width char and a
+    -- Tab
+    funcs.setline(1, ('aé中\t'):rep(1000))
+    local function check(ts, shift)
+      -- going backwards and forwards through the line
+      for _, k in ipairs({ 999, 0, 500, 146, 147, 998, 1, 999 }) do
+        eq(ts * k + 4 + shift, funcs.virtcol({ 1, 7 * k + 4 + shift }))
+        eq(ts * (k + 1) + shift, funcs.virtcol({ 1, 7 * k + 7 + shift }))
+      end
+      eq(ts * 1000 + shift, funcs.virtcol({ 1, '$' }) - 1)
+    end
+    check(8, 0)
+
+    command('set tabstop=16')
+    check(16, 0)
+
+    command('set tabstop=8')
+    command('normal! 0i12345678')
+    check(8, 8)
+  end)
+end)
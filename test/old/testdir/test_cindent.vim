@@ -5448,5 +5448,51 @@ func Test_find_brace_backwards()
   bwipe!
 endfunc
 
+func Test_cindent_reindent_function()
+  " the enclosing brace is remembered from one line to the next
+  new
+  setl cindent sw=2 et
+
+  let code =<< trim [CODE]
+  int f(int x)
+  {
+  if (x) {
+  a = 1;
+  b = 2;
+  }
+  c = 3;
+  s = "{";
+  d = 4;
+  while (x) {
+  x--;
+  }
+  return x;
+  }
+  [CODE]
+
+  call setline(1, code)
+  normal gg=G
+
+  let expected =<< trim [CODE]
+  int f(int x)
+  {
+    if (x) {
+      a = 1;
+      b = 2;
+    }
+    c = 3;
+    s = "{";
+    d = 4;
+    while (x) {
+      x--;
+    }
+    return x;
+  }
+  [CODE]
+
+  call assert_equal(expected, getline(1, '$'))
+  bwipe!
+endfunc
+
 
 " vim: shiftwidth=2 sts=2 expandtab
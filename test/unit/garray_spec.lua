@@ -231,6 +231,19 @@ describe('garray', function()
     end)
   end)
 
+  describe('ga_reserve', function()
+    itp('allocates exactly the requested items', function()
+      local garr = new_garray()
+      ga_init(garr, 16, 4)
+      garray.ga_reserve(garr, 1000)
+      eq(1000, ga_maxlen(garr))
+      garray.ga_reserve(garr, 10)
+      eq(1000, ga_maxlen(garr))
+      ga_grow(garr, 1000)
+      eq(1000, ga_maxlen(garr))
+    end)
+  end)
+
   describe('ga_clear', function()
     itp('clears an already allocated array', function()
       -- allocate and scramble an array
@@ -580,4 +580,34 @@ describe('marktree', function()
       end
     end
   end)
+
+  itp('moves marks for consecutive inserts like for one insert', function()
+    local tree = ffi.new('MarkTree[1]') -- zero initialized by luajit
+    local shadow = {}
+    local iter = ffi.new('MarkTreeIter[1]')
+
+    for row = 0, 3 do
+      for col = 0, 30 do
+        local gravitate = (col % 2) > 0
+        shadow[put(tree, row, col, gravitate)] = { row, col, gravitate }
+      end
+    end
+
+    -- typing "abc" at (1, 10), then "de" at (1, 2)
+    for i = 0, 2 do
+      dosplice(tree, shadow, { 1, 10 + i }, { 0, 0 }, { 0, 1 })
+    end
+    shadoworder(tree, shadow, iter)
+    dosplice(tree, shadow, { 1, 2 }, { 0, 0 }, { 0, 1 })
+    dosplice(tree, shadow, { 1, 3 }, { 0, 0 }, { 0, 1 })
+    lib.marktree_check(tree)
+
+    -- a delete after inserts, and a new line
+    dosplice(tree, shadow, { 2, 5 }, { 0, 0 }, { 0, 4 })
+    dosplice(tree, shadow, { 2, 7 }, { 0, 3 }, { 0, 0 })
+    dosplice(tree, shadow, { 0, 1 }, { 0, 0 }, { 0, 2 })
+    dosplice(tree, shadow, { 0, 3 }, { 0, 0 }, { 1, 0 })
+    shadoworder(tree, shadow, iter)
+    lib.marktree_check(tree)
+  end)
 end)
@@ -203,4 +203,26 @@ describe('mbyte', function()
       )
     end)
   end)
+
+  itp('utf_ascii_len', function()
+    eq(0, tonumber(lib.utf_ascii_len('', 0)))
+    eq(5, tonumber(lib.utf_ascii_len('hello', 5)))
+    eq(3, tonumber(lib.utf_ascii_len('hello', 3)))
+    eq(19, tonumber(lib.utf_ascii_len('abcdefghijklmnopqrs\xc3\xa9tuvwxyz', 27)))
+    eq(8, tonumber(lib.utf_ascii_len('abcdefgh\x80', 9)))
+    eq(0, tonumber(lib.utf_ascii_len('\xffabcdefghijklmnop', 17)))
+  end)
+
+  itp('utf_ascii_cells_len', function()
+    eq(0, tonumber(lib.utf_ascii_cells_len('', 0)))
+    eq(5, tonumber(lib.utf_ascii_cells_len('hello', 5)))
+    eq(16, tonumber(lib.utf_ascii_cells_len('abcdefgh ijklmno\tpq', 19)))
+    eq(9, tonumber(lib.utf_ascii_cells_len('abcdefghi\x7fjklmnop', 17)))
+    eq(10, tonumber(lib.utf_ascii_cells_len('abcdefghij\x01klmnop', 17)))
+    -- The "e" is the base of a composing character.
+    eq(2, tonumber(lib.utf_ascii_cells_len('abe\xcc\x81cd', 7)))
+    eq(0, tonumber(lib.utf_ascii_cells_len('e\xcc\x81cd', 5)))
+    -- Any multibyte character might be a composing one.
+    eq(2, tonumber(lib.utf_ascii_cells_len('abc\xe4\xb8\x80', 6)))
+  end)
 end)
@@ -138,6 +138,38 @@ describe('multiqueue (multi-level event-queue)', function()
     eq('c2i11', get(parent))
   end)
 
+  itp('takes events of a low priority child after other events', function()
+    local low = multiqueue.multiqueue_new_child(parent)
+    multiqueue.multiqueue_set_low_priority(low, true)
+    put(low, 'l1')
+    put(low, 'l2')
+    eq('c1i1', get(parent))
+    eq('c1i2', get(parent))
+    eq('c2i1', get(parent))
+    eq('c1i3', get(parent))
+    eq('c2i2', get(parent))
+    eq('c2i3', get(parent))
+    eq('c2i4', get(parent))
+    eq('c3i1', get(parent))
+    -- After MULTIQUEUE_LOW_PRIORITY_STREAK other events one is taken anyway.
+    eq('l1', get(parent))
+    eq('c3i2', get(parent))
+    eq('l2', get(parent))
+    eq(true, multiqueue.multiqueue_empty(parent))
+  end)
+
+  itp('takes events from a low priority child in order', function()
+    local low = multiqueue.multiqueue_new_child(parent)
+    multiqueue.multiqueue_set_low_priority(low, true)
+    put(low, 'l1')
+    put(low, 'l2')
+    eq('l1', get(low))
+    eq('c1i1', get(parent))
+    eq('l2', get(low))
+    eq(true, multiqueue.multiqueue_empty(low))
+    eq('c1i2', get(parent))
+  end)
+
   itp('removes from parent queue when child is freed', function()
     free(child2)
     eq('c1i1', get(parent))
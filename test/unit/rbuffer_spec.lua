@@ -323,6 +323,77 @@ describe('rbuffer functions', function()
     end)
   end)
 
+  describe('rbuffer_resize', function()
+    local function resize(new_capacity)
+      rbuf = ffi.gc(rbuffer.rbuffer_resize(ffi.gc(rbuf, nil), new_capacity), rbuffer.rbuffer_free)
+      eq(new_capacity, tonumber(rbuf.end_ptr - rbuf.start_ptr))
+    end
+
+    itp('keeps the data when it wraps around', function()
+      write('1234567890')
+      read(6)
+      write('abcdefghij')
+      resize(32)
+      eq(14, tonumber(rbuf.size))
+      eq('7890abcdefghij', read(20))
+      write('klmnop')
+      eq('klmnop', read(20))
+    end)
+
+    itp('can shrink to the size of the data', function()
+      write('12345678')
+      resize(8)
+      eq('12345678', read(20))
+      eq(8, write('abcdefghij'))
+      eq('abcdefgh', read(20))
+    end)
+  end)
+
+  describe('rbuffer_reset', function()
+    local function reset()
+      rbuffer.rbuffer_reset(rbuf)
+      eq(0, tonumber(rbuf.read_ptr - rbuf.start_ptr))
+    end
+
+    itp('moves contiguous data to the start', function()
+      write('1234567890')
+      read(6)
+      reset()
+      eq('7890', inspect():sub(1, 4))
+      write('abc')
+      eq('7890abc', read(20))
+    end)
+
+    itp('joins wrapped data in place when the gap is large enough', function()
+      write('12345678901234')
+      read(12)
+      write('abcd')
+      reset()
+      eq('34abcd', inspect():sub(1, 6))
+      eq(true, rbuf.temp == nil)
+      eq('34abcd', read(20))
+    end)
+
+    itp('joins wrapped data that does not fit in the gap', function()
+      write('1234567890')
+      read(8)
+      write('abcdefgh')
+      reset()
+      eq('90abcdefgh', inspect():sub(1, 10))
+      eq('90abcdefgh', read(20))
+    end)
+
+    itp('handles a full buffer', function()
+      write('1234567890')
+      read(4)
+      write('abcdefghij')
+      reset()
+      eq('567890abcdefghij', inspect())
+      eq(0, tonumber(rbuf.write_ptr - rbuf.start_ptr))
+      eq('567890abcdefghij', read(20))
+    end)
+  end)
+
   describe('wrapping behavior', function()
     itp('writing/reading wraps across the end of the internal buffer', function()
       write('1234567890')
@@ -295,3 +295,31 @@ describe('reverse_text', function()
     eq('\194ba', reverse_text('ab\194'))
   end)
 end)
+
+describe('str_intern()', function()
+  itp('returns the same pointer for equal strings', function()
+    local a = strings.str_intern(to_cstr('Xfile'))
+    local b = strings.str_intern(to_cstr('Xfile'))
+    local c = strings.str_intern(to_cstr('Xother'))
+    eq(true, a == b)
+    eq(false, a == c)
+    eq('Xfile', ffi.string(a))
+    eq(2, tonumber(strings.str_intern_count()))
+    strings.str_unintern(a)
+    eq(2, tonumber(strings.str_intern_count()))
+    strings.str_unintern(b)
+    eq(1, tonumber(strings.str_intern_count()))
+    strings.str_unintern(c)
+    eq(0, tonumber(strings.str_intern_count()))
+  end)
+
+  itp('keeps a string alive while it has references', function()
+    local a = strings.str_intern(to_cstr('Xfile'))
+    eq(true, a == strings.str_intern_ref(a))
+    strings.str_unintern(a)
+    eq(true, a == strings.str_intern(to_cstr('Xfile')))
+    strings.str_unintern(a)
+    strings.str_unintern(a)
+    eq(0, tonumber(strings.str_intern_count()))
+  end)
+end)